@@ -0,0 +1,100 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTestBenchmarkWorkUnits_h
+#define itkTestBenchmarkWorkUnits_h
+
+#include "itkMultiThreaderBase.h"
+#include "itkTestingMacros.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+namespace itk
+{
+namespace Testing
+{
+/* Utilities used for testing, these are not intended to be part of the public interface */
+/* Used by the benchmarks registered in the Benchmark configuration, which time a computation on an image of size
+ * pixels along each dimension for a growing number of work units. */
+struct BenchmarkWorkUnitsArguments
+{
+  SizeValueType size{};
+  unsigned int  maximumNumberOfWorkUnits{};
+  unsigned int  numberOfRepetitions{};
+};
+
+/* Parse the arguments [size [maximumNumberOfWorkUnits [numberOfRepetitions]]] of a benchmark. The maximum number of
+ * work units defaults to the global default number of threads. Return false, after printing the usage, when there are
+ * too many arguments. */
+inline bool
+ParseBenchmarkWorkUnitsArguments(int                           argc,
+                                 char *                        argv[],
+                                 SizeValueType                 defaultSize,
+                                 unsigned int                  defaultNumberOfRepetitions,
+                                 BenchmarkWorkUnitsArguments & arguments)
+{
+  if (argc > 4)
+  {
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv)
+              << " [size [maximumNumberOfWorkUnits [numberOfRepetitions]]]" << std::endl;
+    return false;
+  }
+  arguments.size = argc > 1 ? std::stoul(argv[1]) : defaultSize;
+  arguments.maximumNumberOfWorkUnits = argc > 2 ? static_cast<unsigned int>(std::stoul(argv[2]))
+                                                : MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  arguments.numberOfRepetitions =
+    argc > 3 ? static_cast<unsigned int>(std::stoul(argv[3])) : defaultNumberOfRepetitions;
+  return true;
+}
+
+/* Run the computation numberOfRepetitions times with 1, 2, 4, ... work units, up to the maximum, and print a table of
+ * its mean time and of the speedup. The computation is called with the number of work units, and returns the seconds
+ * it took, so that it can leave its set up out of the timing. The speedup is relative to referenceSeconds, or to the
+ * time with one work unit when it is zero. */
+template <typename TComputation>
+void
+BenchmarkWorkUnits(const BenchmarkWorkUnitsArguments & arguments,
+                   const TComputation &                computation,
+                   double                              referenceSeconds = 0.0)
+{
+  std::cout << "Work units\tSeconds\tSpeedup" << std::endl;
+  for (unsigned int numberOfWorkUnits = 1;;
+       numberOfWorkUnits = std::min(2 * numberOfWorkUnits, arguments.maximumNumberOfWorkUnits))
+  {
+    double totalSeconds = 0.0;
+    for (unsigned int i = 0; i < arguments.numberOfRepetitions; ++i)
+    {
+      totalSeconds += computation(numberOfWorkUnits);
+    }
+    const double seconds = totalSeconds / std::max(arguments.numberOfRepetitions, 1u);
+    if (referenceSeconds == 0.0)
+    {
+      referenceSeconds = seconds;
+    }
+    std::cout << numberOfWorkUnits << '\t' << seconds << '\t' << referenceSeconds / seconds << std::endl;
+
+    if (numberOfWorkUnits >= arguments.maximumNumberOfWorkUnits)
+    {
+      break;
+    }
+  }
+}
+} // namespace Testing
+} // namespace itk
+
+#endif // itkTestBenchmarkWorkUnits_h
@@ -0,0 +1,54 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTestVerifyImageRegion_h
+#define itkTestVerifyImageRegion_h
+
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include <iostream>
+
+namespace itk
+{
+namespace Testing
+{
+/* A utility function used for testing, this is not intended to be part of the public interface */
+/* Used by the tests of the image IOs that read or write a region of an image, to check that the
+ * pixels of the region are those of the image written. The pixels of the expected image are cast
+ * to the pixel type of the actual one before they are compared. */
+template <typename TExpectedImage, typename TActualImage>
+bool
+VerifyImageRegion(const TExpectedImage *                    expected,
+                  const TActualImage *                      actual,
+                  const typename TActualImage::RegionType & region)
+{
+  using PixelType = typename TActualImage::PixelType;
+  for (ImageRegionConstIteratorWithIndex<TActualImage> it(actual, region); !it.IsAtEnd(); ++it)
+  {
+    const PixelType expectedPixel = static_cast<PixelType>(expected->GetPixel(it.GetIndex()));
+    if (it.Get() != expectedPixel)
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " differs: " << it.Get() << " instead of " << expectedPixel
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace Testing
+} // namespace itk
+
+#endif // itkTestVerifyImageRegion_h
@@ -78,11 +78,25 @@ namespace itk
  *  - Boundary handling: when \c EnforceBoundaryCondition=true (default), the inverse is
  *    clamped to zero at the image boundary to avoid extrapolation artifacts.
  *
+ * \par Warm start and in-place update
+ * The iteration starts from \c InverseFieldInitialEstimate instead of zero, so an
+ * estimate close to the inverse reaches the tolerances in fewer iterations.  As without
+ * an initial estimate, the tolerances are checked at the start of each iteration, so the
+ * field returned has had one more update than the one whose error norms are reported,
+ * and even an estimate that is already within tolerance gets one update.  With
+ * \c InPlace on, the filter works directly on the buffer of \c InverseFieldInitialEstimate
+ * (e.g. the inverse displacement field of a DisplacementFieldTransform) instead of copying it.
+ * The initial estimate is then consumed: its buffer is overwritten with the result and
+ * shared with the output, although it is an input of the filter and its modification
+ * time does not change.  \c ElapsedIterations reports the number of residual
+ * evaluations performed.
+ *
  * \par Complexity and performance
  * Each iteration performs one interpolation and vector update per voxel:
  * \f$O(N \times I)\f$ work for \f$N\f$ voxels and \f$I\f$ iterations. The filter
- * parallelizes across the output region and reuses an internal composed field to
- * minimize memory traffic.
+ * parallelizes across the output region.  The residual is computed by interpolating
+ * the forward field in the same pass that measures its norm, into an internal field
+ * that is allocated once and reused by every iteration.
  *
  * \par Relationship to Symmetric Normalization (SyN)
  * This filter is a core component of the Symmetric Normalization (SyN) registration
@@ -207,6 +221,16 @@ public:
   itkGetMacro(EnforceBoundaryCondition, bool);
   itkBooleanMacro(EnforceBoundaryCondition);
 
+  /* Should the result be written into the buffer of the initial estimate of the inverse field?
+   * Only used when an initial estimate is set, which is then consumed by the update: it
+   * holds the result afterwards.  Default false. */
+  itkSetMacro(InPlace, bool);
+  itkGetConstMacro(InPlace, bool);
+  itkBooleanMacro(InPlace);
+
+  /* Get the number of iterations performed by the last update */
+  itkGetConstMacro(ElapsedIterations, unsigned int);
+
 protected:
   /** Constructor */
   InvertDisplacementFieldImageFilter();
@@ -246,7 +270,10 @@ private:
   SpacingType m_DisplacementFieldSpacing{};
   bool        m_DoThreadedEstimateInverse{ false };
   bool        m_EnforceBoundaryCondition{ true };
+  bool        m_InPlace{ false };
   std::mutex  m_Mutex{};
+
+  unsigned int m_ElapsedIterations{ 0 };
 };
 
 } // end namespace itk
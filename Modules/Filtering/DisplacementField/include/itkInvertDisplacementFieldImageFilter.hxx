@@ -19,7 +19,6 @@
 #define itkInvertDisplacementFieldImageFilter_hxx
 
 
-#include "itkComposeDisplacementFieldsImageFilter.h"
 #include "itkImageDuplicator.h"
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionIteratorWithIndex.h"
@@ -71,7 +70,6 @@ void
 InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>::GenerateData()
 {
   this->UpdateProgress(0.0f);
-  this->AllocateOutputs();
 
   constexpr VectorType zeroVector{};
 
@@ -81,26 +79,43 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>::GenerateData()
 
   if (this->GetInverseFieldInitialEstimate())
   {
-    using DuplicatorType = ImageDuplicator<InverseDisplacementFieldType>;
-    auto duplicator = DuplicatorType::New();
-    duplicator->SetInputImage(this->GetInverseFieldInitialEstimate());
-    duplicator->Update();
+    if (this->m_InPlace)
+    {
+      // Iterate directly on the buffer of the initial estimate
+      this->GraftOutput(const_cast<InverseDisplacementFieldType *>(this->GetInverseFieldInitialEstimate()));
+      inverseDisplacementField = this->GetOutput();
+    }
+    else
+    {
+      using DuplicatorType = ImageDuplicator<InverseDisplacementFieldType>;
+      auto duplicator = DuplicatorType::New();
+      duplicator->SetInputImage(this->GetInverseFieldInitialEstimate());
+      duplicator->Update();
 
-    inverseDisplacementField = duplicator->GetOutput();
+      inverseDisplacementField = duplicator->GetOutput();
 
-    this->SetNthOutput(0, inverseDisplacementField);
+      this->SetNthOutput(0, inverseDisplacementField);
+    }
   }
   else
   {
+    this->AllocateOutputs();
     inverseDisplacementField = this->GetOutput();
     inverseDisplacementField->FillBuffer(zeroVector);
   }
 
+  this->m_Interpolator->SetInputImage(displacementField);
+
   for (unsigned int d = 0; d < ImageDimension; ++d)
   {
     this->m_DisplacementFieldSpacing[d] = displacementField->GetSpacing()[d];
   }
 
+  this->m_ComposedField = DisplacementFieldType::New();
+  this->m_ComposedField->CopyInformation(inverseDisplacementField);
+  this->m_ComposedField->SetRegions(inverseDisplacementField->GetRequestedRegion());
+  this->m_ComposedField->Allocate();
+
   this->m_ScaledNormImage->CopyInformation(displacementField);
   this->m_ScaledNormImage->SetRegions(displacementField->GetRequestedRegion());
   this->m_ScaledNormImage->AllocateInitialized();
@@ -108,27 +123,18 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>::GenerateData()
   const SizeValueType numberOfPixelsInRegion = (displacementField->GetRequestedRegion()).GetNumberOfPixels();
   this->m_MaxErrorNorm = NumericTraits<RealType>::max();
   this->m_MeanErrorNorm = NumericTraits<RealType>::max();
-  unsigned int iteration = 0;
+  this->m_ElapsedIterations = 0;
 
   float oldProgress = 0.0f;
 
-  while ((iteration++ < this->m_MaximumNumberOfIterations) &&
+  while ((this->m_ElapsedIterations < this->m_MaximumNumberOfIterations) &&
          (this->m_MaxErrorNorm > this->m_MaxErrorToleranceThreshold) &&
          (this->m_MeanErrorNorm > this->m_MeanErrorToleranceThreshold))
   {
-    itkDebugMacro("Iteration " << iteration << ": mean error norm = " << this->m_MeanErrorNorm
-                               << ", max error norm = " << this->m_MaxErrorNorm);
-
-    using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
-    auto composer = ComposerType::New();
-    composer->SetDisplacementField(displacementField);
-    composer->SetWarpingField(inverseDisplacementField);
-
-    this->m_ComposedField = composer->GetOutput();
-    this->m_ComposedField->Update();
-    this->m_ComposedField->DisconnectPipeline();
+    const unsigned int iteration = ++this->m_ElapsedIterations;
 
-    // Multithread processing to multiply each element of the composed field by 1 / spacing
+    // Multithread processing to compute the residual of the current estimate, i.e. the
+    // composition of the forward field with the inverse field, and its norm scaled by 1 / spacing
     this->m_MeanErrorNorm = RealType{};
     this->m_MaxErrorNorm = RealType{};
 
@@ -145,6 +151,9 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>::GenerateData()
 
     this->m_MeanErrorNorm /= static_cast<RealType>(numberOfPixelsInRegion);
 
+    itkDebugMacro("Iteration " << iteration << ": mean error norm = " << this->m_MeanErrorNorm
+                               << ", max error norm = " << this->m_MaxErrorNorm);
+
     this->m_Epsilon = 0.5;
     if (iteration == 1)
     {
@@ -165,6 +174,10 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>::GenerateData()
     oldProgress = newProgress;
   }
 
+  // Release the internal fields
+  this->m_ComposedField = DisplacementFieldType::New();
+  this->m_ScaledNormImage = RealImageType::New();
+
   this->UpdateProgress(1.0f);
 }
 
@@ -218,10 +231,29 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>::DynamicThreadedGe
     {
       inverseSpacing[d] = 1.0 / this->m_DisplacementFieldSpacing[d];
     }
-    for (ItE.GoToBegin(), ItS.GoToBegin(); !ItE.IsAtEnd(); ++ItE, ++ItS)
+    const InverseDisplacementFieldType * inverseField = this->GetOutput();
+
+    PointType                         point;
+    ImageRegionConstIteratorWithIndex ItI(inverseField, region);
+    for (ItI.GoToBegin(), ItE.GoToBegin(), ItS.GoToBegin(); !ItI.IsAtEnd(); ++ItI, ++ItE, ++ItS)
     {
-      const VectorType & displacement = ItE.Get();
-      RealType           scaledNorm = 0.0;
+      // displacement = v(y) + u(y + v(y))
+      VectorType displacement = ItI.Get();
+      inverseField->TransformIndexToPhysicalPoint(ItI.GetIndex(), point);
+      for (unsigned int d = 0; d < ImageDimension; ++d)
+      {
+        point[d] += displacement[d];
+      }
+      if (this->m_Interpolator->IsInsideBuffer(point))
+      {
+        const typename InterpolatorType::OutputType forwardDisplacement = this->m_Interpolator->Evaluate(point);
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+        {
+          displacement[d] += forwardDisplacement[d];
+        }
+      }
+
+      RealType scaledNorm = 0.0;
       for (unsigned int d = 0; d < ImageDimension; ++d)
       {
         scaledNorm += itk::Math::sqr(displacement[d] * inverseSpacing[d]);
@@ -259,6 +291,8 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>::PrintSelf(std::os
   os << indent << "Maximum number of iterations: " << this->m_MaximumNumberOfIterations << std::endl;
   os << indent << "Max error tolerance threshold: " << this->m_MaxErrorToleranceThreshold << std::endl;
   os << indent << "Mean error tolerance threshold: " << this->m_MeanErrorToleranceThreshold << std::endl;
+  os << indent << "In place: " << (this->m_InPlace ? "On" : "Off") << std::endl;
+  os << indent << "Elapsed iterations: " << this->m_ElapsedIterations << std::endl;
 }
 
 } // end namespace itk
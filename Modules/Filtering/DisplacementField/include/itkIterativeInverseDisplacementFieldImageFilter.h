@@ -41,6 +41,12 @@ namespace itk
  * provide a better return to the current pixel, in which case its value is taken for
  * updating the vector in the inverse field.
  *
+ * The first guess can be replaced by an initial estimate of the inverse field
+ * (SetInverseFieldInitialEstimate()), typically the inverse computed at the previous
+ * iteration of a registration, in which case the refinement starts from it.  The
+ * refinement of each pixel stops as soon as its error drops below \c StopValue, and
+ * the pixels are refined in parallel.
+ *
  * This method was discussed in the users-list during February 2004.
  *
  * \author  Corinne Mattmann
@@ -98,6 +104,13 @@ public:
   itkSetMacro(NumberOfIterations, unsigned int);
   itkGetConstMacro(NumberOfIterations, unsigned int);
 
+  /** Set/Get the initial estimate of the inverse field (optional).  It must have
+   * the same geometry as the input field. */
+  /** @ITKStartGrouping */
+  itkSetInputMacro(InverseFieldInitialEstimate, OutputImageType);
+  itkGetInputMacro(InverseFieldInitialEstimate, OutputImageType);
+  /** @ITKEndGrouping */
+
   // If the error (in mm) between forward and backward mapping is smaller than
   // the StopValue,
   // the algorithm stops.
@@ -111,7 +124,7 @@ public:
                   (Concept::SameDimension<TInputImage::ImageDimension, TOutputImage::ImageDimension>));
 
 protected:
-  IterativeInverseDisplacementFieldImageFilter() = default;
+  IterativeInverseDisplacementFieldImageFilter();
   ~IterativeInverseDisplacementFieldImageFilter() override = default;
 
   void
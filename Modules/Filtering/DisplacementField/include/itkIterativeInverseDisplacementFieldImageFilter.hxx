@@ -18,19 +18,26 @@
 #ifndef itkIterativeInverseDisplacementFieldImageFilter_hxx
 #define itkIterativeInverseDisplacementFieldImageFilter_hxx
 
+#include "itkImageAlgorithm.h"
 #include "itkImageRegionIteratorWithIndex.h"
-#include "itkProgressReporter.h"
 #include "itkMath.h"
 
 namespace itk
 {
+//----------------------------------------------------------------------------
+template <typename TInputImage, typename TOutputImage>
+IterativeInverseDisplacementFieldImageFilter<TInputImage, TOutputImage>::IterativeInverseDisplacementFieldImageFilter()
+{
+  this->AddOptionalInputName("InverseFieldInitialEstimate");
+}
+
 //----------------------------------------------------------------------------
 template <typename TInputImage, typename TOutputImage>
 void
 IterativeInverseDisplacementFieldImageFilter<TInputImage, TOutputImage>::GenerateData()
 {
-  const unsigned int ImageDimension = InputImageType::ImageDimension;
-  TimeType           time;
+  constexpr unsigned int ImageDimension = InputImageType::ImageDimension;
+  TimeType               time;
 
   time.Start(); // time measurement
 
@@ -43,178 +50,185 @@ IterativeInverseDisplacementFieldImageFilter<TInputImage, TOutputImage>::Generat
     itkExceptionStringMacro("\n Input is missing.");
   }
 
-  // calculate a first guess
-  // (calculate negative displacement field and apply it to itself)
-  const InputImagePointer negField = InputImageType::New();
-  negField->SetRegions(inputPtr->GetLargestPossibleRegion());
-  negField->SetOrigin(inputPtr->GetOrigin());
-  negField->SetSpacing(inputPtr->GetSpacing());
-  negField->SetDirection(inputPtr->GetDirection());
-  negField->Allocate();
-
-  InputConstIterator InputIt(inputPtr, inputPtr->GetRequestedRegion());
-
-  for (InputIterator negImageIt(negField, negField->GetRequestedRegion()); !negImageIt.IsAtEnd(); ++negImageIt)
-  {
-    negImageIt.Set(-InputIt.Get());
-    ++InputIt;
-  }
-
   outputPtr->SetRegions(inputPtr->GetRequestedRegion());
   outputPtr->SetOrigin(inputPtr->GetOrigin());
   outputPtr->SetSpacing(inputPtr->GetSpacing());
   outputPtr->SetDirection(inputPtr->GetDirection());
   outputPtr->Allocate();
 
-  auto vectorWarper = VectorWarperType::New();
-  auto VectorInterpolator = FieldInterpolatorType::New();
-  vectorWarper->SetInput(negField);
-  vectorWarper->SetInterpolator(VectorInterpolator);
-  vectorWarper->SetOutputOrigin(inputPtr->GetOrigin());
-  vectorWarper->SetOutputSpacing(inputPtr->GetSpacing());
-  vectorWarper->SetOutputDirection(inputPtr->GetDirection());
-  vectorWarper->SetDisplacementField(negField);
-  vectorWarper->GraftOutput(outputPtr);
-  vectorWarper->UpdateLargestPossibleRegion();
-
-  // If the number of iterations is zero, just output the first guess
-  // (negative deformable field applied to itself)
-  if (m_NumberOfIterations == 0)
+  const OutputImageType * inverseFieldInitialEstimate = this->GetInverseFieldInitialEstimate();
+  if (inverseFieldInitialEstimate)
   {
-    this->GraftOutput(vectorWarper->GetOutput());
+    // start from the given estimate
+    if (!inverseFieldInitialEstimate->GetLargestPossibleRegion().IsInside(outputPtr->GetRequestedRegion()))
+    {
+      itkExceptionMacro("The initial estimate of the inverse field does not cover the region of the input field.");
+    }
+    ImageAlgorithm::Copy(inverseFieldInitialEstimate,
+                         outputPtr.GetPointer(),
+                         outputPtr->GetRequestedRegion(),
+                         outputPtr->GetRequestedRegion());
   }
   else
+  {
+    // calculate a first guess
+    // (calculate negative displacement field and apply it to itself)
+    const InputImagePointer negField = InputImageType::New();
+    negField->SetRegions(inputPtr->GetLargestPossibleRegion());
+    negField->SetOrigin(inputPtr->GetOrigin());
+    negField->SetSpacing(inputPtr->GetSpacing());
+    negField->SetDirection(inputPtr->GetDirection());
+    negField->Allocate();
+
+    InputConstIterator InputIt(inputPtr, inputPtr->GetRequestedRegion());
+
+    for (InputIterator negImageIt(negField, negField->GetRequestedRegion()); !negImageIt.IsAtEnd(); ++negImageIt)
+    {
+      negImageIt.Set(-InputIt.Get());
+      ++InputIt;
+    }
+
+    auto vectorWarper = VectorWarperType::New();
+    auto VectorInterpolator = FieldInterpolatorType::New();
+    vectorWarper->SetInput(negField);
+    vectorWarper->SetInterpolator(VectorInterpolator);
+    vectorWarper->SetOutputOrigin(inputPtr->GetOrigin());
+    vectorWarper->SetOutputSpacing(inputPtr->GetSpacing());
+    vectorWarper->SetOutputDirection(inputPtr->GetDirection());
+    vectorWarper->SetDisplacementField(negField);
+    vectorWarper->GraftOutput(outputPtr);
+    vectorWarper->UpdateLargestPossibleRegion();
+
+    // If the number of iterations is zero, just output the first guess
+    // (negative deformable field applied to itself)
+    if (m_NumberOfIterations == 0)
+    {
+      this->GraftOutput(vectorWarper->GetOutput());
+    }
+  }
+
+  if (m_NumberOfIterations > 0)
   {
     // calculate the inverted field
     const double spacing = inputPtr->GetSpacing()[0];
 
-    ProgressReporter               progress(this, 0, inputPtr->GetLargestPossibleRegion().GetNumberOfPixels());
-    ImageRegionIteratorWithIndex   OutputIt(outputPtr, outputPtr->GetRequestedRegion());
     const FieldInterpolatorPointer inputFieldInterpolator = FieldInterpolatorType::New();
     inputFieldInterpolator->SetInputImage(inputPtr);
 
-    double smallestError = 0;
-    InputIt.GoToBegin();
-    OutputIt.GoToBegin();
-    while (!OutputIt.IsAtEnd())
-    {
-      // get the output image index
-      const OutputImageIndexType index = OutputIt.GetIndex();
-      OutputImagePointType       originalPoint;
-      outputPtr->TransformIndexToPhysicalPoint(index, originalPoint);
-
-      int    stillSamePoint = 0;
-      double step = spacing;
-
-      // get the required displacement
-      OutputImagePixelType displacement = OutputIt.Get();
-
-      InputImagePointType newPoint;
-      InputImagePointType mappedPoint;
-      // compute the required input image point
-      for (unsigned int j = 0; j < ImageDimension; ++j)
-      {
-        mappedPoint[j] = originalPoint[j] + displacement[j];
-        newPoint[j] = mappedPoint[j];
-      }
-
-      // calculate the error of the last iteration
-      if (inputFieldInterpolator->IsInsideBuffer(mappedPoint))
-      {
-        FieldInterpolatorOutputType forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
-
-        smallestError = 0;
-        for (unsigned int j = 0; j < ImageDimension; ++j)
+    this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+      outputPtr->GetRequestedRegion(),
+      [this, &outputPtr, &inputFieldInterpolator, spacing](const typename OutputImageType::RegionType & region) {
+        for (ImageRegionIteratorWithIndex OutputIt(outputPtr.GetPointer(), region); !OutputIt.IsAtEnd(); ++OutputIt)
         {
-          smallestError += Math::sqr(mappedPoint[j] + forwardVector[j] - originalPoint[j]);
-        }
-        smallestError = std::sqrt(smallestError);
-      }
+          // get the output image index
+          const OutputImageIndexType index = OutputIt.GetIndex();
+          OutputImagePointType       originalPoint;
+          outputPtr->TransformIndexToPhysicalPoint(index, originalPoint);
 
-      // iteration loop
-      for (unsigned int i = 0; i < m_NumberOfIterations; ++i)
-      {
+          int    stillSamePoint = 0;
+          double step = spacing;
 
+          // get the required displacement
+          OutputImagePixelType displacement = OutputIt.Get();
 
-        if (stillSamePoint)
-        {
-          step = step / 2;
-        }
+          InputImagePointType newPoint;
+          InputImagePointType mappedPoint;
+          // compute the required input image point
+          for (unsigned int j = 0; j < ImageDimension; ++j)
+          {
+            mappedPoint[j] = originalPoint[j] + displacement[j];
+            newPoint[j] = mappedPoint[j];
+          }
 
-        for (unsigned int k = 0; k < ImageDimension; ++k)
-        {
-          mappedPoint[k] += step;
+          // calculate the error of the last iteration
+          double smallestError = NumericTraits<double>::max();
           if (inputFieldInterpolator->IsInsideBuffer(mappedPoint))
           {
             FieldInterpolatorOutputType forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
-            double                      tmp = 0;
-            for (unsigned int l = 0; l < ImageDimension; ++l)
-            {
-              tmp += Math::sqr(mappedPoint[l] + forwardVector[l] - originalPoint[l]);
-            }
-            tmp = std::sqrt(tmp);
-            if (tmp < smallestError)
+
+            smallestError = 0;
+            for (unsigned int j = 0; j < ImageDimension; ++j)
             {
-              smallestError = tmp;
-              for (unsigned int l = 0; l < ImageDimension; ++l)
-              {
-                newPoint[l] = mappedPoint[l];
-              }
+              smallestError += Math::sqr(mappedPoint[j] + forwardVector[j] - originalPoint[j]);
             }
+            smallestError = std::sqrt(smallestError);
           }
 
-          mappedPoint[k] -= 2 * step;
-          if (inputFieldInterpolator->IsInsideBuffer(mappedPoint))
+          // iteration loop, skipped when the current estimate is already accurate enough
+          for (unsigned int i = 0; i < m_NumberOfIterations && smallestError >= m_StopValue; ++i)
           {
-            FieldInterpolatorOutputType forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
-            double                      tmp = 0;
-            for (unsigned int l = 0; l < ImageDimension; ++l)
+            if (stillSamePoint)
             {
-              tmp += Math::sqr(mappedPoint[l] + forwardVector[l] - originalPoint[l]);
+              step = step / 2;
             }
-            tmp = std::sqrt(tmp);
-            if (tmp < smallestError)
+
+            for (unsigned int k = 0; k < ImageDimension; ++k)
             {
-              smallestError = tmp;
-              for (unsigned int l = 0; l < ImageDimension; ++l)
+              mappedPoint[k] += step;
+              if (inputFieldInterpolator->IsInsideBuffer(mappedPoint))
               {
-                newPoint[l] = mappedPoint[l];
+                FieldInterpolatorOutputType forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
+                double                      tmp = 0;
+                for (unsigned int l = 0; l < ImageDimension; ++l)
+                {
+                  tmp += Math::sqr(mappedPoint[l] + forwardVector[l] - originalPoint[l]);
+                }
+                tmp = std::sqrt(tmp);
+                if (tmp < smallestError)
+                {
+                  smallestError = tmp;
+                  for (unsigned int l = 0; l < ImageDimension; ++l)
+                  {
+                    newPoint[l] = mappedPoint[l];
+                  }
+                }
               }
-            }
-          }
 
-          mappedPoint[k] += step;
-        } // end for loop over image dimension
+              mappedPoint[k] -= 2 * step;
+              if (inputFieldInterpolator->IsInsideBuffer(mappedPoint))
+              {
+                FieldInterpolatorOutputType forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
+                double                      tmp = 0;
+                for (unsigned int l = 0; l < ImageDimension; ++l)
+                {
+                  tmp += Math::sqr(mappedPoint[l] + forwardVector[l] - originalPoint[l]);
+                }
+                tmp = std::sqrt(tmp);
+                if (tmp < smallestError)
+                {
+                  smallestError = tmp;
+                  for (unsigned int l = 0; l < ImageDimension; ++l)
+                  {
+                    newPoint[l] = mappedPoint[l];
+                  }
+                }
+              }
 
-        stillSamePoint = 1;
-        for (unsigned int j = 0; j < ImageDimension; ++j)
-        {
-          if (Math::NotExactlyEquals(newPoint[j], mappedPoint[j]))
+              mappedPoint[k] += step;
+            } // end for loop over image dimension
+
+            stillSamePoint = 1;
+            for (unsigned int j = 0; j < ImageDimension; ++j)
+            {
+              if (Math::NotExactlyEquals(newPoint[j], mappedPoint[j]))
+              {
+                stillSamePoint = 0;
+              }
+              mappedPoint[j] = newPoint[j];
+            }
+          } // end iteration loop
+          OutputImagePixelType outputValue;
+          for (unsigned int k = 0; k < ImageDimension; ++k)
           {
-            stillSamePoint = 0;
+            outputValue[k] = static_cast<OutputImageValueType>(mappedPoint[k] - originalPoint[k]);
           }
-          mappedPoint[j] = newPoint[j];
-        }
 
-        if (smallestError < m_StopValue)
-        {
-          break;
+          OutputIt.Set(outputValue);
         }
-      } // end iteration loop
-      OutputImagePixelType outputValue;
-      for (unsigned int k = 0; k < ImageDimension; ++k)
-      {
-        outputValue[k] = static_cast<OutputImageValueType>(mappedPoint[k] - originalPoint[k]);
-      }
-
-      OutputIt.Set(outputValue);
-
-      ++InputIt;
-      ++OutputIt;
-
-      progress.CompletedPixel();
-    } // end while loop
-  } // end else
+      },
+      this);
+  }
 
   time.Stop();
   m_Time = time.GetMean();
@@ -147,5 +147,31 @@ itkInvertDisplacementFieldImageFilterTest(int argc, char * argv[])
     return EXIT_FAILURE;
   }
 
+  // Warm start from the inverse just computed, iterating in place on its buffer
+  const DisplacementFieldType::Pointer inverseField = inverter->GetOutput();
+  inverseField->DisconnectPipeline();
+
+  auto warmStartInverter = InverterType::New();
+  warmStartInverter->SetDisplacementField(field);
+  warmStartInverter->SetInverseFieldInitialEstimate(inverseField);
+  warmStartInverter->SetMaximumNumberOfIterations(numberOfIterations);
+  warmStartInverter->SetMeanErrorToleranceThreshold(meanTolerance);
+  warmStartInverter->SetMaxErrorToleranceThreshold(maxTolerance);
+  warmStartInverter->SetEnforceBoundaryCondition(enforceBoundaryCondition);
+  ITK_TEST_SET_GET_BOOLEAN(warmStartInverter, InPlace, true);
+
+  ITK_TRY_EXPECT_NO_EXCEPTION(warmStartInverter->Update());
+
+  std::cout << "Iterations: " << inverter->GetElapsedIterations() << " from zero, "
+            << warmStartInverter->GetElapsedIterations() << " from the previous inverse" << std::endl;
+  ITK_TEST_EXPECT_TRUE(warmStartInverter->GetElapsedIterations() <= inverter->GetElapsedIterations());
+  ITK_TEST_EXPECT_EQUAL(warmStartInverter->GetOutput()->GetBufferPointer(), inverseField->GetBufferPointer());
+
+  if ((warmStartInverter->GetOutput()->GetPixel(index) + ones).GetNorm() > 0.05)
+  {
+    std::cerr << "Failed to find proper inverse from the initial estimate." << std::endl;
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
@@ -113,6 +113,44 @@ itkIterativeInverseDisplacementFieldImageFilterTest(int argc, char * argv[])
     return EXIT_FAILURE;
   }
 
+  // Refining the inverse from itself does not increase its error
+  auto warmStartFilter = FilterType::New();
+  warmStartFilter->SetInput(field);
+  warmStartFilter->SetNumberOfIterations(numberOfIterations);
+  warmStartFilter->SetStopValue(stopValue);
+  warmStartFilter->SetInverseFieldInitialEstimate(filter->GetOutput());
+  ITK_TEST_SET_GET_VALUE(filter->GetOutput(), warmStartFilter->GetInverseFieldInitialEstimate());
+
+  ITK_TRY_EXPECT_NO_EXCEPTION(warmStartFilter->UpdateLargestPossibleRegion());
+
+  auto fieldInterpolator = FilterType::FieldInterpolatorType::New();
+  fieldInterpolator->SetInputImage(field);
+  const auto meanInverseError = [&fieldInterpolator](const DisplacementFieldType * inverseField) {
+    double       error = 0.0;
+    unsigned int count = 0;
+    for (itk::ImageRegionConstIteratorWithIndex<DisplacementFieldType> inverseIt(
+           inverseField, inverseField->GetLargestPossibleRegion());
+         !inverseIt.IsAtEnd();
+         ++inverseIt)
+    {
+      DisplacementFieldType::PointType point;
+      inverseField->TransformIndexToPhysicalPoint(inverseIt.GetIndex(), point);
+      const DisplacementFieldType::PointType mappedPoint = point + inverseIt.Get();
+      if (fieldInterpolator->IsInsideBuffer(mappedPoint))
+      {
+        error += (mappedPoint + fieldInterpolator->Evaluate(mappedPoint) - point).GetNorm();
+        ++count;
+      }
+    }
+    return error / count;
+  };
+
+  const double inverseError = meanInverseError(filter->GetOutput());
+  const double warmStartInverseError = meanInverseError(warmStartFilter->GetOutput());
+  std::cout << "Mean inverse error: " << inverseError << ", after refinement " << warmStartInverseError
+            << std::endl;
+  ITK_TEST_EXPECT_TRUE(warmStartInverseError <= inverseError);
+
   // Write an image for regression testing
   using WriterType = itk::ImageFileWriter<DisplacementFieldType>;
 
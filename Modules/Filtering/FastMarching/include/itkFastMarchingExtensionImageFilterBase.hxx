@@ -107,6 +107,11 @@ void
 FastMarchingExtensionImageFilterBase<TInput, TOutput, TAuxValue, VAuxDimension>::InitializeOutput(
   OutputImageType * oImage)
 {
+  if (this->GetSolver() == Superclass::SolverEnum::FastSweeping)
+  {
+    itkExceptionMacro("The auxiliary values cannot be extended when the Solver is " << this->GetSolver());
+  }
+
   this->Superclass::InitializeOutput(oImage);
 
   if (!m_AuxiliaryAliveValues)
@@ -226,7 +231,7 @@ FastMarchingExtensionImageFilterBase<TInput, TOutput, TAuxValue, VAuxDimension>:
     // node.SetValue( outputPixel );
     // node.SetIndex( index );
     // m_TrialHeap.push(node);
-    this->m_Heap.push(NodePairType(iNode, outputPixel));
+    this->InsertTrialNode(iNode, outputPixel);
 
     // update auxiliary values
     for (unsigned int k = 0; k < AuxDimension; ++k)
@@ -20,12 +20,40 @@
 #define itkFastMarchingImageFilterBase_h
 
 #include "itkFastMarchingBase.h"
+#include "itkFastMarchingIndexedHeap.h"
 #include "itkNeighborhoodIterator.h"
 #include "itkArray.h"
 #include <bitset>
 
 namespace itk
 {
+/**
+ * \class FastMarchingImageFilterBaseEnums
+ * \brief Contains all enum classes used by the FastMarchingImageFilterBase class.
+ * \ingroup ITKFastMarching
+ */
+class FastMarchingImageFilterBaseEnums
+{
+public:
+  /**
+   * \class Solver
+   * \ingroup ITKFastMarching
+   * How the arrival times are computed. PriorityQueue propagates the front
+   * with a std::priority_queue, where a node whose value decreases is pushed
+   * again; IndexedHeap propagates it with a heap that holds each node once
+   * and changes its value in place; FastSweeping sweeps blocks of the image
+   * concurrently until the arrival times converge. */
+  enum class Solver : uint8_t
+  {
+    PriorityQueue = 0,
+    IndexedHeap,
+    FastSweeping
+  };
+};
+// Define how to print enumeration
+extern ITKFastMarching_EXPORT std::ostream &
+                              operator<<(std::ostream & out, const FastMarchingImageFilterBaseEnums::Solver value);
+
 /**
  * \class FastMarchingImageFilterBase
  * \brief Apply the Fast Marching method to solve an Eikonal equation on an image.
@@ -56,6 +84,24 @@ namespace itk
  *
  * Else the output information is copied from the input speed image.
  *
+ * The Solver selects how the front propagates. The default, PriorityQueue,
+ * pushes a node again whenever its value decreases, and skips the stale
+ * entries when they come out of the queue. IndexedHeap keeps every trial
+ * node once, in a heap whose values are decreased in place; it needs one
+ * identifier per pixel, but no duplicates. Both process the nodes one at a
+ * time, on one thread.
+ *
+ * FastSweeping solves the same discrete equation by Gauss-Seidel sweeps in
+ * the 2^N directions of the axes \cite zhao2005, until no arrival time
+ * changes. A sweep visits the nodes by hyperplanes across its direction: the
+ * nodes of a hyperplane do not depend on each other, and are updated
+ * concurrently by the work units of the filter \cite detrixhe2013. The
+ * nodes are then visited in order of arrival time so that the stopping
+ * criterion applies as it does when the front propagates; the nodes beyond
+ * the one that satisfies it are left at the large value.
+ * FastSweeping does not check the topology, and it does not serve the
+ * subclasses that compute more than arrival times.
+ *
  * Implementation of this class is based on \cite sethian1999a.
  *
  * For an alternative implementation, see itk::FastMarchingImageFilter.
@@ -125,8 +171,17 @@ public:
 
   using InternalNodeStructureArray = FixedArray<InternalNodeStructure, ImageDimension>;
 
+  using SolverEnum = FastMarchingImageFilterBaseEnums::Solver;
+
   itkGetModifiableObjectMacro(LabelImage, LabelImageType);
 
+  /** Set/Get how the arrival times are computed. Defaults to
+   * SolverEnum::PriorityQueue. */
+  /** @ITKStartGrouping */
+  itkSetEnumMacro(Solver, SolverEnum);
+  itkGetConstMacro(Solver, SolverEnum);
+  /** @ITKEndGrouping */
+
   /** The output largest possible, spacing and origin is computed as follows.
    * If the speed image is nullptr or if the OverrideOutputInformation is true,
    * the output information is set from user specified parameters. These
@@ -175,6 +230,9 @@ protected:
   OutputDirectionType m_OutputDirection{};
   bool                m_OverrideOutputInformation{ false };
 
+  SolverEnum                               m_Solver{ SolverEnum::PriorityQueue };
+  FastMarchingIndexedHeap<OutputPixelType> m_IndexedHeap{};
+
   /** Generate the output image meta information. */
   void
   GenerateOutputInformation() override;
@@ -182,6 +240,15 @@ protected:
   void
   EnlargeOutputRequestedRegion(DataObject * output) override;
 
+  /** Compute the arrival times with the Solver. */
+  void
+  GenerateData() override;
+
+  /** Put a node in the heap of trial nodes of the Solver, or change its
+   * value there. */
+  void
+  InsertTrialNode(const NodeType & iNode, const OutputPixelType & iValue);
+
   LabelImagePointer              m_LabelImage{};
   ConnectedComponentImagePointer m_ConnectedComponentImage{};
 
@@ -267,6 +334,27 @@ protected:
   DoesVoxelChangeViolateStrictTopology(const NodeType &) const;
 
   const InputImageType * m_InputCache{};
+
+private:
+  /** Propagate the front with the indexed heap. */
+  void
+  PropagateWithIndexedHeap(OutputImageType * oImage);
+
+  /** Sweep the image until the arrival times converge, then order the nodes
+   * for the stopping criterion. */
+  void
+  Sweep(OutputImageType * oImage);
+
+  /** Sweep the image in one of the 2^N directions, bit j of iDirection
+   * being set when axis j is swept backward; returns whether an arrival time
+   * changed. */
+  bool
+  SweepDirection(OutputImageType * oImage, unsigned int iDirection);
+
+  /** Update the arrival time of a node from its neighbors; returns whether
+   * it changed. */
+  bool
+  SweepNode(OutputImageType * oImage, const NodeType & iNode);
 };
 } // end namespace itk
 
@@ -21,8 +21,13 @@
 
 
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkConnectedComponentImageFilter.h"
 #include "itkRelabelComponentImageFilter.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace itk
 {
@@ -81,6 +86,279 @@ FastMarchingImageFilterBase<TInput, TOutput>::GenerateOutputInformation()
   }
 }
 
+template <typename TInput, typename TOutput>
+void
+FastMarchingImageFilterBase<TInput, TOutput>::GenerateData()
+{
+  if (m_Solver == SolverEnum::PriorityQueue)
+  {
+    Superclass::GenerateData();
+    return;
+  }
+  if (m_Solver == SolverEnum::FastSweeping && this->m_TopologyCheck != Superclass::TopologyCheckEnum::Nothing)
+  {
+    itkExceptionMacro("The topology cannot be checked when the Solver is " << m_Solver);
+  }
+
+  OutputImageType * output = this->GetOutput();
+
+  this->Initialize(output);
+
+  this->m_StoppingCriterion->Reinitialize();
+
+  if (m_Solver == SolverEnum::IndexedHeap)
+  {
+    this->PropagateWithIndexedHeap(output);
+  }
+  else
+  {
+    this->Sweep(output);
+  }
+}
+
+template <typename TInput, typename TOutput>
+void
+FastMarchingImageFilterBase<TInput, TOutput>::PropagateWithIndexedHeap(OutputImageType * oImage)
+{
+  OutputPixelType current_value{};
+
+  ProgressReporter progress(this, 0, this->GetTotalNumberOfNodes());
+
+  try
+  {
+    // Each node is in the heap once, with its latest value: no entry is stale
+    while (!m_IndexedHeap.Empty())
+    {
+      const NodeType current_node = m_LabelImage->ComputeIndex(m_IndexedHeap.Top().m_Key);
+      current_value = m_IndexedHeap.Top().m_Value;
+      m_IndexedHeap.Pop();
+
+      if (this->GetLabelValueForGivenNode(current_node) != Traits::Alive)
+      {
+        const NodePairType current_node_pair(current_node, current_value);
+        this->m_StoppingCriterion->SetCurrentNodePair(current_node_pair);
+
+        if (this->m_StoppingCriterion->IsSatisfied())
+        {
+          break;
+        }
+
+        if (this->CheckTopology(oImage, current_node))
+        {
+          if (this->m_CollectPoints)
+          {
+            this->m_ProcessedPoints->push_back(current_node_pair);
+          }
+
+          this->SetLabelValueForGivenNode(current_node, Traits::Alive);
+          this->UpdateNeighbors(oImage, current_node);
+        }
+      }
+      progress.CompletedPixel();
+    }
+  }
+  catch (const ProcessAborted &)
+  {
+    m_IndexedHeap.Clear();
+    throw ProcessAborted(__FILE__, __LINE__);
+  }
+
+  this->m_TargetReachedValue = current_value;
+
+  m_IndexedHeap.Clear();
+}
+
+template <typename TInput, typename TOutput>
+void
+FastMarchingImageFilterBase<TInput, TOutput>::Sweep(OutputImageType * oImage)
+{
+  // The trial points are only needed in the label image
+  while (!this->m_Heap.empty())
+  {
+    this->m_Heap.pop();
+  }
+
+  // Sweep in the 2^N directions until no arrival time changes
+  for (bool changed = true; changed;)
+  {
+    changed = false;
+    for (unsigned int direction = 0; direction < (1u << ImageDimension); ++direction)
+    {
+      changed = this->SweepDirection(oImage, direction) || changed;
+    }
+  }
+
+  // The nodes the front reaches, in the order it reaches them
+  std::vector<NodePairType> reached;
+  for (ImageRegionConstIteratorWithIndex<LabelImageType> it(m_LabelImage, m_BufferedRegion); !it.IsAtEnd(); ++it)
+  {
+    const unsigned char label = it.Get();
+    if (label == Traits::InitialTrial || label == Traits::Far)
+    {
+      const OutputPixelType value = oImage->GetPixel(it.GetIndex());
+      if (value < this->m_LargeValue)
+      {
+        reached.emplace_back(it.GetIndex(), value);
+      }
+    }
+  }
+  std::stable_sort(reached.begin(), reached.end());
+
+  OutputPixelType current_value{};
+  ProgressReporter progress(this, 0, reached.size());
+
+  auto nodePair = reached.cbegin();
+  for (; nodePair != reached.cend(); ++nodePair)
+  {
+    current_value = nodePair->GetValue();
+    this->m_StoppingCriterion->SetCurrentNodePair(*nodePair);
+    if (this->m_StoppingCriterion->IsSatisfied())
+    {
+      break;
+    }
+    if (this->m_CollectPoints)
+    {
+      this->m_ProcessedPoints->push_back(*nodePair);
+    }
+    this->SetLabelValueForGivenNode(nodePair->GetNode(), Traits::Alive);
+    progress.CompletedPixel();
+  }
+  this->m_TargetReachedValue = current_value;
+
+  // The front does not go beyond the node that stops it
+  if (nodePair != reached.cend())
+  {
+    ++nodePair;
+  }
+  for (; nodePair != reached.cend(); ++nodePair)
+  {
+    if (this->GetLabelValueForGivenNode(nodePair->GetNode()) == Traits::Far)
+    {
+      this->SetOutputValue(oImage, nodePair->GetNode(), this->m_LargeValue);
+    }
+  }
+}
+
+template <typename TInput, typename TOutput>
+bool
+FastMarchingImageFilterBase<TInput, TOutput>::SweepNode(OutputImageType * oImage, const NodeType & iNode)
+{
+  if (this->GetLabelValueForGivenNode(iNode) != Traits::Far)
+  {
+    return false;
+  }
+
+  // The smallest arrival time of the neighbors along each axis
+  InternalNodeStructureArray neighbors;
+  bool                       reachable = false;
+  for (unsigned int j = 0; j < ImageDimension; ++j)
+  {
+    InternalNodeStructure & neighbor = neighbors[j];
+    neighbor.m_Value = this->m_LargeValue;
+    neighbor.m_Axis = j;
+    NodeType neighborNode = iNode;
+    for (int s = -1; s < 2; s += 2)
+    {
+      neighborNode[j] = iNode[j] + s;
+      if (neighborNode[j] >= m_StartIndex[j] && neighborNode[j] <= m_LastIndex[j] &&
+          this->GetLabelValueForGivenNode(neighborNode) != Traits::Forbidden)
+      {
+        const OutputPixelType value = oImage->GetPixel(neighborNode);
+        if (value < neighbor.m_Value)
+        {
+          neighbor.m_Value = value;
+          neighbor.m_Node = neighborNode;
+          reachable = true;
+        }
+      }
+    }
+  }
+  if (!reachable)
+  {
+    return false;
+  }
+
+  const OutputPixelType current = oImage->GetPixel(iNode);
+  const auto            solution = static_cast<OutputPixelType>(this->Solve(oImage, iNode, neighbors));
+  if (!(solution < current))
+  {
+    return false;
+  }
+  oImage->SetPixel(iNode, solution);
+  return current - solution > NumericTraits<OutputPixelType>::epsilon() * solution;
+}
+
+template <typename TInput, typename TOutput>
+bool
+FastMarchingImageFilterBase<TInput, TOutput>::SweepDirection(OutputImageType * oImage, unsigned int iDirection)
+{
+  // Node coordinates counted from the corner the sweep starts from: the
+  // nodes whose coordinates add up to the same level only depend on the
+  // nodes of the levels before and after theirs
+  const OutputSizeType                          size = m_BufferedRegion.GetSize();
+  const std::bitset<ImageDimension>             backward(iDirection);
+  FixedArray<SizeValueType, ImageDimension + 1> remainingExtent;
+  remainingExtent[ImageDimension] = 0;
+  for (unsigned int j = ImageDimension; j-- > 0;)
+  {
+    remainingExtent[j] = remainingExtent[j + 1] + size[j] - 1;
+  }
+  const auto setCoordinate = [this, &size, &backward](NodeType & node, unsigned int j, SizeValueType coordinate) {
+    node[j] = m_StartIndex[j] +
+              static_cast<typename NodeType::IndexValueType>(backward[j] ? size[j] - 1 - coordinate : coordinate);
+  };
+
+  // Visit the nodes of a level whose first coordinates are set
+  const auto sweepLevel = [this, oImage, &size, &remainingExtent, &setCoordinate](
+                            const auto & self, NodeType & node, unsigned int j, SizeValueType remaining) -> bool {
+    if (j == ImageDimension - 1)
+    {
+      setCoordinate(node, j, remaining);
+      return this->SweepNode(oImage, node);
+    }
+    bool                changed = false;
+    const SizeValueType first = remaining > remainingExtent[j + 1] ? remaining - remainingExtent[j + 1] : 0;
+    const SizeValueType last = std::min<SizeValueType>(size[j] - 1, remaining);
+    for (SizeValueType coordinate = first; coordinate <= last; ++coordinate)
+    {
+      setCoordinate(node, j, coordinate);
+      changed = self(self, node, j + 1, remaining - coordinate) || changed;
+    }
+    return changed;
+  };
+
+  const ThreadIdType  numberOfWorkUnits = this->GetNumberOfWorkUnits();
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(numberOfWorkUnits);
+
+  bool changed = false;
+  for (SizeValueType level = 0; level <= remainingExtent[0]; ++level)
+  {
+    if (ImageDimension == 1 || numberOfWorkUnits == 1)
+    {
+      NodeType node;
+      changed = sweepLevel(sweepLevel, node, 0, level) || changed;
+      continue;
+    }
+
+    // The nodes of a level are updated concurrently, by first coordinate
+    const SizeValueType        first = level > remainingExtent[1] ? level - remainingExtent[1] : 0;
+    const SizeValueType        last = std::min<SizeValueType>(size[0] - 1, level);
+    std::vector<unsigned char> rowChanged(last - first + 1, 0);
+    multiThreader->ParallelizeArray(
+      first,
+      last + 1,
+      [first, level, &rowChanged, &sweepLevel, &setCoordinate](SizeValueType coordinate) {
+        NodeType node;
+        setCoordinate(node, 0, coordinate);
+        rowChanged[coordinate - first] = sweepLevel(sweepLevel, node, 1, level - coordinate);
+      },
+      nullptr);
+    changed = changed || std::find(rowChanged.begin(), rowChanged.end(), 1) != rowChanged.end();
+  }
+  return changed;
+}
+
 template <typename TInput, typename TOutput>
 void
 FastMarchingImageFilterBase<TInput, TOutput>::EnlargeOutputRequestedRegion(DataObject * output)
@@ -185,7 +463,25 @@ FastMarchingImageFilterBase<TInput, TOutput>::UpdateValue(OutputImageType * oIma
     this->SetLabelValueForGivenNode(iNode, Traits::Trial);
 
     // Insert point into trial heap
-    this->m_Heap.push(NodePairType(iNode, outputPixel));
+    this->InsertTrialNode(iNode, outputPixel);
+  }
+}
+
+template <typename TInput, typename TOutput>
+void
+FastMarchingImageFilterBase<TInput, TOutput>::InsertTrialNode(const NodeType & iNode, const OutputPixelType & iValue)
+{
+  switch (m_Solver)
+  {
+    case SolverEnum::PriorityQueue:
+      this->m_Heap.push(NodePairType(iNode, iValue));
+      break;
+    case SolverEnum::IndexedHeap:
+      m_IndexedHeap.Push(m_LabelImage->ComputeOffset(iNode), iValue);
+      break;
+    case SolverEnum::FastSweeping:
+      // The trial nodes are known from their label
+      break;
   }
 }
 
@@ -411,6 +707,11 @@ FastMarchingImageFilterBase<TInput, TOutput>::InitializeOutput(OutputImageType *
   constexpr auto offset = MakeFilled<typename OutputImageType::OffsetType>(1);
   m_LastIndex -= offset;
 
+  if (m_Solver == SolverEnum::IndexedHeap)
+  {
+    m_IndexedHeap.Initialize(m_BufferedRegion.GetNumberOfPixels());
+  }
+
   // Checking for handles only requires an image to keep track of
   // connected components.
   if (this->m_TopologyCheck == Superclass::TopologyCheckEnum::NoHandles)
@@ -528,7 +829,7 @@ FastMarchingImageFilterBase<TInput, TOutput>::InitializeOutput(OutputImageType *
         this->SetOutputValue(oImage, idx, outputPixel);
 
         // this->m_Heap->Push( PriorityQueueElementType( idx, pointsIter->second ) );
-        this->m_Heap.push(pointsIter->Value());
+        this->InsertTrialNode(idx, outputPixel);
       }
       ++pointsIter;
     }
@@ -980,6 +1281,7 @@ FastMarchingImageFilterBase<TInput, TOutput>::PrintSelf(std::ostream & os, Inden
   os << indent << "OutputDirection: " << m_OutputDirection << std::endl;
 
   os << indent << "OverrideOutputInformation: " << m_OverrideOutputInformation << std::endl;
+  os << indent << "Solver: " << m_Solver << std::endl;
 
   itkPrintSelfObjectMacro(LabelImage);
 
@@ -0,0 +1,193 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFastMarchingIndexedHeap_h
+#define itkFastMarchingIndexedHeap_h
+
+#include "itkIntTypes.h"
+#include "itkNumericTraits.h"
+
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class FastMarchingIndexedHeap
+ * \brief Binary min-heap of values keyed by node identifiers, whose values
+ * can be changed in place.
+ *
+ * Each key, in [0, NumberOfKeys), is at most once in the heap: pushing a key
+ * that is already in it moves it to its new value (decrease-key) instead of
+ * adding a duplicate. The position of every key in the heap is kept in an
+ * array of NumberOfKeys identifiers.
+ *
+ * \sa FastMarchingImageFilterBase
+ *
+ * \ingroup ITKFastMarching
+ */
+template <typename TValue>
+class ITK_TEMPLATE_EXPORT FastMarchingIndexedHeap
+{
+public:
+  using ValueType = TValue;
+  using KeyType = IdentifierType;
+
+  /** An entry of the heap */
+  struct Element
+  {
+    ValueType m_Value;
+    KeyType   m_Key;
+  };
+
+  /** Empty the heap, and accept keys up to numberOfKeys - 1 */
+  void
+  Initialize(SizeValueType numberOfKeys)
+  {
+    m_Elements.clear();
+    m_Positions.assign(numberOfKeys, NotInHeap);
+  }
+
+  /** Release the memory of the heap */
+  void
+  Clear()
+  {
+    std::vector<Element>().swap(m_Elements);
+    std::vector<KeyType>().swap(m_Positions);
+  }
+
+  [[nodiscard]] bool
+  Empty() const
+  {
+    return m_Elements.empty();
+  }
+
+  [[nodiscard]] SizeValueType
+  Size() const
+  {
+    return m_Elements.size();
+  }
+
+  [[nodiscard]] bool
+  Contains(KeyType key) const
+  {
+    return m_Positions[key] != NotInHeap;
+  }
+
+  /** Insert key with value, or change the value of key when it is in the
+   * heap already */
+  void
+  Push(KeyType key, const ValueType & value)
+  {
+    KeyType position = m_Positions[key];
+    if (position == NotInHeap)
+    {
+      position = m_Elements.size();
+      m_Elements.push_back({ value, key });
+      this->SiftUp(position);
+    }
+    else if (value < m_Elements[position].m_Value)
+    {
+      m_Elements[position].m_Value = value;
+      this->SiftUp(position);
+    }
+    else
+    {
+      m_Elements[position].m_Value = value;
+      this->SiftDown(position);
+    }
+  }
+
+  /** The element of smallest value */
+  [[nodiscard]] const Element &
+  Top() const
+  {
+    return m_Elements.front();
+  }
+
+  /** Remove the element of smallest value */
+  void
+  Pop()
+  {
+    m_Positions[m_Elements.front().m_Key] = NotInHeap;
+    const Element last = m_Elements.back();
+    m_Elements.pop_back();
+    if (!m_Elements.empty())
+    {
+      this->Place(0, last);
+      this->SiftDown(0);
+    }
+  }
+
+private:
+  static constexpr KeyType NotInHeap = NumericTraits<KeyType>::max();
+
+  void
+  Place(KeyType position, const Element & element)
+  {
+    m_Elements[position] = element;
+    m_Positions[element.m_Key] = position;
+  }
+
+  void
+  SiftUp(KeyType position)
+  {
+    const Element element = m_Elements[position];
+    while (position > 0)
+    {
+      const KeyType parent = (position - 1) / 2;
+      if (!(element.m_Value < m_Elements[parent].m_Value))
+      {
+        break;
+      }
+      this->Place(position, m_Elements[parent]);
+      position = parent;
+    }
+    this->Place(position, element);
+  }
+
+  void
+  SiftDown(KeyType position)
+  {
+    const Element element = m_Elements[position];
+    const KeyType size = m_Elements.size();
+    for (;;)
+    {
+      KeyType child = 2 * position + 1;
+      if (child >= size)
+      {
+        break;
+      }
+      if (child + 1 < size && m_Elements[child + 1].m_Value < m_Elements[child].m_Value)
+      {
+        ++child;
+      }
+      if (!(m_Elements[child].m_Value < element.m_Value))
+      {
+        break;
+      }
+      this->Place(position, m_Elements[child]);
+      position = child;
+    }
+    this->Place(position, element);
+  }
+
+  std::vector<Element> m_Elements{};
+  std::vector<KeyType> m_Positions{};
+};
+} // end namespace itk
+
+#endif
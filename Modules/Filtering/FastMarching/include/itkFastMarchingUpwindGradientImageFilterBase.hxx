@@ -58,6 +58,11 @@ template <typename TInput, typename TOutput>
 void
 FastMarchingUpwindGradientImageFilterBase<TInput, TOutput>::InitializeOutput(OutputImageType * output)
 {
+  if (this->GetSolver() == Superclass::SolverEnum::FastSweeping)
+  {
+    itkExceptionMacro("The upwind gradient cannot be computed when the Solver is " << this->GetSolver());
+  }
+
   Superclass::InitializeOutput(output);
 
   // allocate memory for the GradientImage if requested
@@ -0,0 +1,40 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkFastMarchingImageFilterBase.h"
+
+namespace itk
+{
+/** Print enum values */
+std::ostream &
+operator<<(std::ostream & out, const FastMarchingImageFilterBaseEnums::Solver value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case FastMarchingImageFilterBaseEnums::Solver::PriorityQueue:
+        return "itk::FastMarchingImageFilterBaseEnums::Solver::PriorityQueue";
+      case FastMarchingImageFilterBaseEnums::Solver::IndexedHeap:
+        return "itk::FastMarchingImageFilterBaseEnums::Solver::IndexedHeap";
+      case FastMarchingImageFilterBaseEnums::Solver::FastSweeping:
+        return "itk::FastMarchingImageFilterBaseEnums::Solver::FastSweeping";
+      default:
+        return "INVALID VALUE FOR itk::FastMarchingImageFilterBaseEnums::Solver";
+    }
+  }();
+}
+} // end namespace itk
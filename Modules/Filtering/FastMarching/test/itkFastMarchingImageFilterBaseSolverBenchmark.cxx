@@ -0,0 +1,109 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFastMarchingImageFilterBase.h"
+#include "itkFastMarchingThresholdStoppingCriterion.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestBenchmarkWorkUnits.h"
+#include "itkTimeProbe.h"
+
+#include <cmath>
+
+
+// Time the priority queue and the indexed heap solvers of
+// FastMarchingImageFilterBase on a 3D speed image that varies, then the fast
+// sweeping solver for a growing number of work units, with its speedup
+// relative to the priority queue. This is not part of the tests that run by
+// default; run it with
+//   ctest -C Benchmark -R itkFastMarchingImageFilterBaseSolverBenchmark
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using FastMarchingType = itk::FastMarchingImageFilterBase<ImageType, ImageType>;
+using SolverEnum = FastMarchingType::SolverEnum;
+
+// March from the center of the cubic image until every pixel is reached, and
+// return the time taken
+double
+March(const ImageType * speed, SolverEnum solver, itk::ThreadIdType numberOfWorkUnits)
+{
+  using NodePairType = FastMarchingType::NodePairType;
+  using NodePairContainerType = FastMarchingType::NodePairContainerType;
+
+  auto trial = NodePairContainerType::New();
+  const auto center = ImageType::IndexType::Filled(
+    static_cast<itk::IndexValueType>(speed->GetBufferedRegion().GetSize(0) / 2));
+  trial->push_back(NodePairType(center, 0.0));
+
+  auto everywhere = itk::FastMarchingThresholdStoppingCriterion<ImageType, ImageType>::New();
+  everywhere->SetThreshold(1e6);
+
+  auto marcher = FastMarchingType::New();
+  marcher->SetInput(speed);
+  marcher->SetTrialPoints(trial);
+  marcher->SetStoppingCriterion(everywhere);
+  marcher->SetSolver(solver);
+  marcher->SetNumberOfWorkUnits(numberOfWorkUnits);
+
+  itk::TimeProbe timeProbe;
+  timeProbe.Start();
+  marcher->Update();
+  timeProbe.Stop();
+  return timeProbe.GetTotal();
+}
+} // namespace
+
+
+int
+itkFastMarchingImageFilterBaseSolverBenchmark(int argc, char * argv[])
+{
+  itk::Testing::BenchmarkWorkUnitsArguments arguments;
+  if (!itk::Testing::ParseBenchmarkWorkUnitsArguments(argc, argv, 96, 3, arguments))
+  {
+    return EXIT_FAILURE;
+  }
+
+  auto speed = ImageType::New();
+  speed->SetRegions(ImageType::SizeType::Filled(arguments.size));
+  speed->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(speed, speed->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<float>(1.0 + 0.5 * std::sin(index[0] / 5.0) * std::cos(index[1] / 7.0) + 0.01 * index[2]));
+  }
+
+  std::cout << "Image of " << arguments.size << "^3 pixels, mean of " << arguments.numberOfRepetitions << " runs"
+            << std::endl;
+  double priorityQueueSeconds = 0.0;
+  double indexedHeapSeconds = 0.0;
+  for (unsigned int i = 0; i < arguments.numberOfRepetitions; ++i)
+  {
+    priorityQueueSeconds += March(speed, SolverEnum::PriorityQueue, 1) / arguments.numberOfRepetitions;
+    indexedHeapSeconds += March(speed, SolverEnum::IndexedHeap, 1) / arguments.numberOfRepetitions;
+  }
+  std::cout << SolverEnum::PriorityQueue << ": " << priorityQueueSeconds << " s" << std::endl;
+  std::cout << SolverEnum::IndexedHeap << ": " << indexedHeapSeconds << " s" << std::endl;
+  std::cout << SolverEnum::FastSweeping << ':' << std::endl;
+  itk::Testing::BenchmarkWorkUnits(
+    arguments,
+    [&speed](unsigned int numberOfWorkUnits) { return March(speed, SolverEnum::FastSweeping, numberOfWorkUnits); },
+    priorityQueueSeconds);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFastMarchingImageFilterBase.h"
+#include "itkFastMarchingNumberOfElementsStoppingCriterion.h"
+#include "itkFastMarchingThresholdStoppingCriterion.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+#include <cmath>
+
+/*
+ * Compares the arrival times computed by the solvers of
+ * FastMarchingImageFilterBase, on a speed image that varies and with a wall
+ * of forbidden points. The solvers are timed by
+ * itkFastMarchingImageFilterBaseSolverBenchmark.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using FastMarchingType = itk::FastMarchingImageFilterBase<ImageType, ImageType>;
+using SolverEnum = FastMarchingType::SolverEnum;
+
+FastMarchingType::Pointer
+MakeMarcher(const ImageType * speed,
+            SolverEnum        solver,
+            itk::ThreadIdType numberOfWorkUnits,
+            FastMarchingType::StoppingCriterionType * criterion)
+{
+  using NodePairType = FastMarchingType::NodePairType;
+  using NodePairContainerType = FastMarchingType::NodePairContainerType;
+
+  auto trial = NodePairContainerType::New();
+  trial->push_back(NodePairType({ { 5, 7, 6 } }, 0.0));
+  trial->push_back(NodePairType({ { 40, 30, 36 } }, 0.0));
+
+  // A wall across the first dimension, with a hole. The border of the image
+  // is forbidden too, since the front does not propagate from the border
+  // along the axis across it.
+  auto                       forbidden = NodePairContainerType::New();
+  const ImageType::IndexType last = speed->GetBufferedRegion().GetUpperIndex();
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(speed, speed->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    bool isForbidden = index[0] == 24 && (index[1] < 20 || index[1] > 25 || index[2] < 20 || index[2] > 25);
+    for (unsigned int j = 0; j < Dimension; ++j)
+    {
+      isForbidden = isForbidden || index[j] == 0 || index[j] == last[j];
+    }
+    if (isForbidden)
+    {
+      forbidden->push_back(NodePairType(index, 0.0));
+    }
+  }
+
+  auto marcher = FastMarchingType::New();
+  marcher->SetInput(speed);
+  marcher->SetTrialPoints(trial);
+  marcher->SetForbiddenPoints(forbidden);
+  marcher->SetStoppingCriterion(criterion);
+  marcher->SetSolver(solver);
+  marcher->SetNumberOfWorkUnits(numberOfWorkUnits);
+  return marcher;
+}
+
+double
+MaximumDifference(const ImageType * expected, const ImageType * actual)
+{
+  double                                   difference = 0.0;
+  itk::ImageRegionConstIterator<ImageType> expectedIt(expected, expected->GetBufferedRegion());
+  itk::ImageRegionConstIterator<ImageType> actualIt(actual, actual->GetBufferedRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    if (expectedIt.Get() < 1e6f || actualIt.Get() < 1e6f)
+    {
+      difference = std::max(difference, std::abs(static_cast<double>(expectedIt.Get()) - actualIt.Get()));
+    }
+  }
+  return difference;
+}
+
+itk::SizeValueType
+CountAlive(const FastMarchingType * marcher)
+{
+  itk::SizeValueType count = 0;
+  using LabelImageType = FastMarchingType::LabelImageType;
+  const LabelImageType * labels = const_cast<FastMarchingType *>(marcher)->GetLabelImage();
+  for (itk::ImageRegionConstIterator<LabelImageType> it(labels, labels->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    count += it.Get() == FastMarchingType::Traits::Alive;
+  }
+  return count;
+}
+} // namespace
+
+
+int
+itkFastMarchingImageFilterBaseSolverTest(int, char *[])
+{
+  auto speed = ImageType::New();
+  speed->SetRegions(ImageType::SizeType{ { 48, 48, 44 } });
+  speed->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(speed, speed->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<float>(1.0 + 0.5 * std::sin(index[0] / 5.0) * std::cos(index[1] / 7.0) + 0.01 * index[2]));
+  }
+
+  auto everywhere = itk::FastMarchingThresholdStoppingCriterion<ImageType, ImageType>::New();
+  everywhere->SetThreshold(1e6);
+
+  auto marcher = MakeMarcher(speed, SolverEnum::PriorityQueue, 1, everywhere);
+  ITK_TEST_SET_GET_VALUE(SolverEnum::PriorityQueue, marcher->GetSolver());
+  std::cout << SolverEnum::IndexedHeap << ' ' << SolverEnum::FastSweeping << std::endl;
+
+  ITK_TRY_EXPECT_NO_EXCEPTION(marcher->Update());
+  const ImageType::Pointer reference = marcher->GetOutput();
+
+  struct Run
+  {
+    SolverEnum        solver;
+    itk::ThreadIdType numberOfWorkUnits;
+    double            tolerance;
+  };
+  for (const Run & run : { Run{ SolverEnum::IndexedHeap, 1, 1e-4 },
+                           Run{ SolverEnum::FastSweeping, 1, 1e-4 },
+                           Run{ SolverEnum::FastSweeping, 4, 1e-4 } })
+  {
+    auto solverMarcher = MakeMarcher(speed, run.solver, run.numberOfWorkUnits, everywhere);
+    ITK_TRY_EXPECT_NO_EXCEPTION(solverMarcher->Update());
+    const double difference = MaximumDifference(reference, solverMarcher->GetOutput());
+    std::cout << run.solver << " with " << run.numberOfWorkUnits << " work units: largest difference " << difference
+              << std::endl;
+    ITK_TEST_EXPECT_TRUE(difference <= run.tolerance);
+  }
+
+  // The stopping criterion applies to the nodes in order of arrival time
+  auto numberOfElements = itk::FastMarchingNumberOfElementsStoppingCriterion<ImageType, ImageType>::New();
+  constexpr itk::IdentifierType target = 5000;
+  numberOfElements->SetTargetNumberOfElements(target);
+  float targetReachedValue = 0.0f;
+  for (const SolverEnum solver : { SolverEnum::PriorityQueue, SolverEnum::IndexedHeap, SolverEnum::FastSweeping })
+  {
+    auto stoppedMarcher = MakeMarcher(speed, solver, 4, numberOfElements);
+    ITK_TRY_EXPECT_NO_EXCEPTION(stoppedMarcher->Update());
+    ITK_TEST_EXPECT_EQUAL(CountAlive(stoppedMarcher), target - 1);
+    if (solver == SolverEnum::PriorityQueue)
+    {
+      targetReachedValue = stoppedMarcher->GetTargetReachedValue();
+    }
+    ITK_TEST_EXPECT_TRUE(std::abs(stoppedMarcher->GetTargetReachedValue() - targetReachedValue) <= 1e-3f);
+  }
+
+  // The topology is only checked by the solvers that propagate the front
+  auto topologyMarcher = MakeMarcher(speed, SolverEnum::FastSweeping, 4, everywhere);
+  topologyMarcher->SetTopologyCheck(FastMarchingType::TopologyCheckEnum::Strict);
+  ITK_TRY_EXPECT_EXCEPTION(topologyMarcher->Update());
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
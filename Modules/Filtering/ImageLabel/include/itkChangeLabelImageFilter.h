@@ -21,6 +21,7 @@
 #include "itkUnaryFunctorImageFilter.h"
 #include "itkConceptChecking.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkLabelImageSpatialIndex.h"
 
 #include <map>
 
@@ -40,6 +41,11 @@ namespace itk
  *
  * The filter expect both images to have the same number of dimensions.
  *
+ * When a LabelImageSpatialIndex of the input is set, and the whole buffered
+ * region of the input is requested, the output is a copy of the input in
+ * which only the runs of the changed labels are rewritten, concurrently.
+ * When the filter runs in place, only these runs are written at all.
+ *
  * \author Tim Kelliher. GE Research, Niskayuna, NY.
  * \note This work was supported by a grant from DARPA, executed by the
  *  U.S. Army Medical Research and Materiel Command/TATRC Assistance
@@ -89,6 +95,12 @@ public:
     m_ChangeMap.clear();
   }
 
+  const ChangeMapType &
+  GetChangeMap() const
+  {
+    return m_ChangeMap;
+  }
+
   inline TOutput
   operator()(const TInput & A) const
   {
@@ -150,6 +162,17 @@ public:
   void
   ClearChangeMap();
 
+  /** Type of the index of the labels of the input. */
+  using LabelIndexType = LabelImageSpatialIndex<TInputImage>;
+
+  /** Index of the labels of the input, used to write only the pixels of
+   * the changed labels. It is updated by the filter, and is ignored when it
+   * indexes another image. */
+  /** @ITKStartGrouping */
+  itkSetObjectMacro(LabelIndex, LabelIndexType);
+  itkGetModifiableObjectMacro(LabelIndex, LabelIndexType);
+  /** @ITKEndGrouping */
+
   itkConceptMacro(InputConvertibleToOutputCheck, (Concept::Convertible<InputPixelType, OutputPixelType>));
   itkConceptMacro(PixelTypeComparable, (Concept::Comparable<InputPixelType>));
 
@@ -158,6 +181,14 @@ protected:
   ~ChangeLabelImageFilter() override = default;
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Write the changed labels from the runs of the label index, when it
+   * indexes the input, or every pixel otherwise. */
+  void
+  GenerateData() override;
+
+private:
+  typename LabelIndexType::Pointer m_LabelIndex{};
 };
 } // end namespace itk
 
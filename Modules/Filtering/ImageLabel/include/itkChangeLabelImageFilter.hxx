@@ -28,6 +28,10 @@
 #ifndef itkChangeLabelImageFilter_hxx
 #define itkChangeLabelImageFilter_hxx
 
+#include "itkImageAlgorithm.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace itk
 {
@@ -72,6 +76,74 @@ ChangeLabelImageFilter<TInputImage, TOutputImage>::ClearChangeMap()
   this->Modified();
 }
 
+/**
+ *
+ */
+template <typename TInputImage, typename TOutputImage>
+void
+ChangeLabelImageFilter<TInputImage, TOutputImage>::GenerateData()
+{
+  const TInputImage * input = this->GetInput();
+  if (m_LabelIndex == nullptr || m_LabelIndex->GetImage() != input ||
+      this->GetOutput()->GetRequestedRegion() != input->GetBufferedRegion())
+  {
+    Superclass::GenerateData();
+    return;
+  }
+
+  m_LabelIndex->Update();
+  this->AllocateOutputs();
+
+  TOutputImage *                            output = this->GetOutput();
+  const typename TOutputImage::RegionType & region = output->GetRequestedRegion();
+  MultiThreaderBase *                       multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  // The buffers of the input and of the output have the same region, so the
+  // offsets of the runs are the same in both
+  const bool runningInPlace = this->GetRunningInPlace();
+  if (!runningInPlace)
+  {
+    multiThreader->template ParallelizeImageRegion<TOutputImage::ImageDimension>(
+      region,
+      [input, output](const typename TOutputImage::RegionType & regionForThread) {
+        ImageAlgorithm::Copy(input, output, regionForThread, regionForThread);
+      },
+      this);
+  }
+
+  std::vector<std::pair<typename LabelIndexType::RunRangeType, OutputPixelType>> changes;
+  for (const auto & change : this->GetFunctor().GetChangeMap())
+  {
+    if (static_cast<OutputPixelType>(change.first) != change.second)
+    {
+      const typename LabelIndexType::RunRangeType runs = m_LabelIndex->GetRuns(change.first);
+      if (runs.size() > 0)
+      {
+        changes.emplace_back(runs, change.second);
+      }
+    }
+  }
+
+  OutputPixelType * buffer = output->GetBufferPointer();
+  multiThreader->ParallelizeArray(
+    0,
+    changes.size(),
+    [buffer, &changes](SizeValueType i) {
+      for (const typename LabelIndexType::RunType & run : changes[i].first)
+      {
+        std::fill_n(buffer + run.m_Offset, run.m_Length, changes[i].second);
+      }
+    },
+    nullptr);
+
+  if (runningInPlace)
+  {
+    // The labels of the input have been overwritten
+    m_LabelIndex->Modified();
+  }
+}
+
 /**
  *
  */
@@ -81,6 +153,8 @@ ChangeLabelImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os,
 {
   Superclass::PrintSelf(os, indent);
   // Maybe should iterate the change map and print it here
+
+  itkPrintSelfObjectMacro(LabelIndex);
 }
 } // end namespace itk
 
@@ -0,0 +1,97 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelImageRunSlab_h
+#define itkLabelImageRunSlab_h
+
+#include "itkImageRegion.h"
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class LabelImageRunSlab
+ * \brief The runs of pixels of a slab of a label image, sorted by label.
+ *
+ * Helper of the classes that gather the runs of a label image by label,
+ * concurrently: each work unit encodes the runs of a slab of the image, in
+ * raster order, and sorts them by label, keeping the raster order of the runs
+ * of each label. The runs of a label are then found in the slabs in order.
+ *
+ * A run is given by its offset in the buffer of the image and its length.
+ * The integral labels are sorted with a radix sort, the others with a stable
+ * sort.
+ *
+ * \sa LabelImageSpatialIndex, LabelImageToFlatLabelMapFilter
+ * \ingroup ITKImageLabel
+ */
+template <typename TImage, typename TLabel = typename TImage::PixelType>
+class ITK_TEMPLATE_EXPORT LabelImageRunSlab
+{
+public:
+  using ImageType = TImage;
+  using PixelType = typename ImageType::PixelType;
+  using RegionType = typename ImageType::RegionType;
+  using LabelType = TLabel;
+
+  /** A run of pixels of a label, along the first dimension of the image. */
+  struct Run
+  {
+    OffsetValueType m_Offset;
+    SizeValueType   m_Length;
+  };
+  using RunType = Run;
+
+  /** A label, and the number of its run in the slab. */
+  using LabelAndRunType = std::pair<LabelType, SizeValueType>;
+
+  /** Encode the runs of all the pixels of the region of the buffer of the
+   * image, and sort them by label. */
+  void
+  Encode(const ImageType * image, const RegionType & region);
+
+  /** Encode the runs of the pixels of the region that are not background,
+   * and sort them by label. */
+  void
+  Encode(const ImageType * image, const RegionType & region, const PixelType & background);
+
+  /** Stable sort by label. */
+  static void
+  SortByLabel(std::vector<LabelAndRunType> & labels);
+
+  /** The labels of all the slabs, in increasing order. */
+  static std::vector<LabelType>
+  MergeLabels(const std::vector<LabelImageRunSlab> & slabs);
+
+  /** The runs, in raster order. */
+  std::vector<RunType> m_Runs{};
+
+  /** The labels of the runs, with the numbers of the runs, sorted by label. */
+  std::vector<LabelAndRunType> m_Labels{};
+
+private:
+  void
+  Encode(const ImageType * image, const RegionType & region, bool skipBackground, const PixelType & background);
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkLabelImageRunSlab.hxx"
+#endif
+
+#endif
@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelImageRunSlab_hxx
+#define itkLabelImageRunSlab_hxx
+
+#include "itkImageScanlineConstIterator.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <type_traits>
+
+namespace itk
+{
+template <typename TImage, typename TLabel>
+void
+LabelImageRunSlab<TImage, TLabel>::Encode(const ImageType * image, const RegionType & region)
+{
+  this->Encode(image, region, false, PixelType{});
+}
+
+template <typename TImage, typename TLabel>
+void
+LabelImageRunSlab<TImage, TLabel>::Encode(const ImageType *  image,
+                                          const RegionType & region,
+                                          const PixelType &  background)
+{
+  this->Encode(image, region, true, background);
+}
+
+template <typename TImage, typename TLabel>
+void
+LabelImageRunSlab<TImage, TLabel>::Encode(const ImageType *  image,
+                                          const RegionType & region,
+                                          bool               skipBackground,
+                                          const PixelType &  background)
+{
+  const PixelType *   buffer = image->GetBufferPointer();
+  const SizeValueType lineLength = region.GetSize(0);
+
+  for (ImageScanlineConstIterator<ImageType> it(image, region); !it.IsAtEnd(); it.NextLine())
+  {
+    const OffsetValueType lineOffset = image->ComputeOffset(it.GetIndex());
+    const PixelType *     line = buffer + lineOffset;
+    for (SizeValueType x = 0; x < lineLength;)
+    {
+      // Find the end of the run that starts here
+      const PixelType     value = line[x];
+      const SizeValueType start = x;
+      for (++x; x < lineLength && line[x] == value; ++x)
+      {
+      }
+      if (!skipBackground || value != background)
+      {
+        m_Labels.emplace_back(static_cast<LabelType>(value), m_Runs.size());
+        m_Runs.push_back(RunType{ lineOffset + static_cast<OffsetValueType>(start), x - start });
+      }
+    }
+  }
+
+  SortByLabel(m_Labels);
+}
+
+template <typename TImage, typename TLabel>
+void
+LabelImageRunSlab<TImage, TLabel>::SortByLabel(std::vector<LabelAndRunType> & labels)
+{
+  if constexpr (std::is_integral_v<LabelType> && !std::is_same_v<LabelType, bool>)
+  {
+    // Radix sort on the bytes of the labels, from the least significant one,
+    // skipping the bytes that all the labels share. The sign bit is flipped
+    // so that negative labels come first.
+    using KeyType = std::make_unsigned_t<LabelType>;
+    constexpr unsigned int numberOfBits = 8 * sizeof(KeyType);
+    constexpr auto signBit = std::is_signed_v<LabelType> ? KeyType(KeyType{ 1 } << (numberOfBits - 1)) : KeyType{ 0 };
+    const auto     byte = [signBit](const LabelAndRunType & labelAndRun, unsigned int shift) {
+      return ((static_cast<KeyType>(labelAndRun.first) ^ signBit) >> shift) & 0xFF;
+    };
+
+    std::vector<LabelAndRunType> sorted(labels.size());
+    for (unsigned int shift = 0; shift < numberOfBits; shift += 8)
+    {
+      std::array<SizeValueType, 257> firsts{};
+      for (const LabelAndRunType & labelAndRun : labels)
+      {
+        ++firsts[byte(labelAndRun, shift) + 1];
+      }
+      if (std::find(firsts.begin(), firsts.end(), labels.size()) != firsts.end())
+      {
+        continue;
+      }
+      std::partial_sum(firsts.begin(), firsts.end(), firsts.begin());
+      for (const LabelAndRunType & labelAndRun : labels)
+      {
+        sorted[firsts[byte(labelAndRun, shift)]++] = labelAndRun;
+      }
+      labels.swap(sorted);
+    }
+  }
+  else
+  {
+    std::stable_sort(labels.begin(), labels.end(), [](const LabelAndRunType & a, const LabelAndRunType & b) {
+      return a.first < b.first;
+    });
+  }
+}
+
+template <typename TImage, typename TLabel>
+auto
+LabelImageRunSlab<TImage, TLabel>::MergeLabels(const std::vector<LabelImageRunSlab> & slabs) -> std::vector<LabelType>
+{
+  std::vector<LabelType> labels;
+  for (const LabelImageRunSlab & slab : slabs)
+  {
+    for (auto it = slab.m_Labels.begin(); it != slab.m_Labels.end(); ++it)
+    {
+      if (it == slab.m_Labels.begin() || it->first != (it - 1)->first)
+      {
+        labels.push_back(it->first);
+      }
+    }
+  }
+  std::sort(labels.begin(), labels.end());
+  labels.erase(std::unique(labels.begin(), labels.end()), labels.end());
+  return labels;
+}
+} // end namespace itk
+
+#endif
@@ -0,0 +1,211 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelImageSpatialIndex_h
+#define itkLabelImageSpatialIndex_h
+
+#include "itkObject.h"
+#include "itkImageRegion.h"
+#include "itkLabelImageRunSlab.h"
+#include "itkMultiThreaderBase.h"
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class LabelImageSpatialIndex
+ * \brief Index of where each label of a label image is.
+ *
+ * For each label of the buffered region of a label image, the index keeps
+ * the runs of pixels with that label along the lines of the image, their
+ * number of pixels and their bounding box. The runs of a label are in
+ * raster order, and are given by their offset in the buffer of the image
+ * and their length.
+ *
+ * The index is built by Update(), concurrently, by the work units of its
+ * multi-threader, and is kept until the image, or the index itself, is
+ * modified. Once built, the pixels of a label are found without going
+ * through the image. The labels are found by binary search.
+ *
+ * The image must be up to date when Update() is called. Writing to its
+ * buffer directly does not modify the image: call its Modified() method
+ * to have the index rebuilt.
+ *
+ * \sa ChangeLabelImageFilter, LabelImageToLabelMapFilter
+ * \ingroup ITKImageLabel
+ */
+template <typename TImage>
+class ITK_TEMPLATE_EXPORT LabelImageSpatialIndex : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(LabelImageSpatialIndex);
+
+  /** Standard class type aliases. */
+  using Self = LabelImageSpatialIndex;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(LabelImageSpatialIndex);
+
+  static constexpr unsigned int ImageDimension = TImage::ImageDimension;
+
+  using ImageType = TImage;
+  using LabelType = typename ImageType::PixelType;
+  using RegionType = typename ImageType::RegionType;
+  using IndexType = typename ImageType::IndexType;
+
+  /** A run of pixels of a label, along the first dimension of the image. */
+  using RunType = typename LabelImageRunSlab<ImageType>::RunType;
+
+  /** The runs of a label, for range-based for loops. */
+  class RunRange
+  {
+  public:
+    RunRange() = default;
+    RunRange(const RunType * begin, const RunType * end)
+      : m_Begin(begin)
+      , m_End(end)
+    {}
+
+    [[nodiscard]] const RunType *
+    begin() const
+    {
+      return m_Begin;
+    }
+
+    [[nodiscard]] const RunType *
+    end() const
+    {
+      return m_End;
+    }
+
+    [[nodiscard]] SizeValueType
+    size() const
+    {
+      return static_cast<SizeValueType>(m_End - m_Begin);
+    }
+
+  private:
+    const RunType * m_Begin{ nullptr };
+    const RunType * m_End{ nullptr };
+  };
+  using RunRangeType = RunRange;
+
+  /** The label image to index. */
+  /** @ITKStartGrouping */
+  itkSetConstObjectMacro(Image, ImageType);
+  itkGetConstObjectMacro(Image, ImageType);
+  /** @ITKEndGrouping */
+
+  /** Number of work units used to build the index. The default is the
+   * global default number of threads of the multi-threader. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+  /** @ITKEndGrouping */
+
+  /** Build the index, unless it is up to date with the image. */
+  void
+  Update();
+
+  /** The region indexed: the buffered region of the image when the index
+   * was built. */
+  itkGetConstReferenceMacro(Region, RegionType);
+
+  /** The labels of the image, in increasing order. */
+  [[nodiscard]] const std::vector<LabelType> &
+  GetLabels() const
+  {
+    return m_Labels;
+  }
+
+  [[nodiscard]] bool
+  HasLabel(const LabelType & label) const;
+
+  /** Number of pixels with the label, 0 when there is none. */
+  [[nodiscard]] SizeValueType
+  GetNumberOfPixels(const LabelType & label) const;
+
+  /** Smallest region that holds all the pixels with the label. It is empty
+   * when there is no pixel with that label. */
+  [[nodiscard]] RegionType
+  GetBoundingBox(const LabelType & label) const;
+
+  /** Runs of the pixels with the label, in raster order. */
+  [[nodiscard]] RunRangeType
+  GetRuns(const LabelType & label) const;
+
+  /** Index of the first pixel of a run. */
+  [[nodiscard]] IndexType
+  ComputeIndex(const RunType & run) const;
+
+protected:
+  LabelImageSpatialIndex();
+  ~LabelImageSpatialIndex() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  using SlabType = LabelImageRunSlab<ImageType>;
+  using LabelAndRunType = typename SlabType::LabelAndRunType;
+
+  /** The runs of a label in a slab of the image, and where they go in
+   * m_Runs. */
+  struct Group
+  {
+    SizeValueType position;
+    SizeValueType first;
+    SizeValueType numberOfRuns;
+    SizeValueType firstRun;
+    SizeValueType numberOfPixels;
+    IndexType     min;
+    IndexType     max;
+  };
+
+  void
+  Build();
+
+  /** Position of the label in m_Labels, the number of labels when it is
+   * not there. */
+  [[nodiscard]] SizeValueType
+  FindLabel(const LabelType & label) const;
+
+  typename ImageType::ConstPointer m_Image{};
+  ThreadIdType                     m_NumberOfWorkUnits{ 1 };
+  MultiThreaderBase::Pointer       m_MultiThreader{};
+
+  RegionType                 m_Region{};
+  TimeStamp                  m_BuildTime{};
+  std::vector<LabelType>     m_Labels{};
+  std::vector<SizeValueType> m_RunOffsets{};
+  std::vector<RunType>       m_Runs{};
+  std::vector<SizeValueType> m_NumberOfPixels{};
+  std::vector<RegionType>    m_BoundingBoxes{};
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkLabelImageSpatialIndex.hxx"
+#endif
+
+#endif
@@ -0,0 +1,268 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelImageSpatialIndex_hxx
+#define itkLabelImageSpatialIndex_hxx
+
+#include "itkImageScanlineConstIterator.h"
+#include "itkImageSourceCommon.h"
+#include "itkNumericTraits.h"
+#include <algorithm>
+#include <numeric>
+
+namespace itk
+{
+template <typename TImage>
+LabelImageSpatialIndex<TImage>::LabelImageSpatialIndex()
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
+{}
+
+template <typename TImage>
+void
+LabelImageSpatialIndex<TImage>::Update()
+{
+  if (m_Image == nullptr)
+  {
+    itkExceptionMacro("Image not set");
+  }
+
+  if (m_BuildTime.GetMTime() != 0 && !(m_Image->GetMTime() > m_BuildTime) && !(this->GetMTime() > m_BuildTime) &&
+      m_Region == m_Image->GetBufferedRegion())
+  {
+    // Early exit, the index is up to date
+    return;
+  }
+
+  this->Build();
+  m_BuildTime.Modified();
+}
+
+template <typename TImage>
+void
+LabelImageSpatialIndex<TImage>::Build()
+{
+  m_Region = m_Image->GetBufferedRegion();
+  m_Labels.clear();
+  m_RunOffsets.assign(1, 0);
+  m_Runs.clear();
+  m_NumberOfPixels.clear();
+  m_BoundingBoxes.clear();
+  if (m_Region.GetNumberOfPixels() == 0)
+  {
+    return;
+  }
+
+  const ImageRegionSplitterBase * splitter = ImageSourceCommon::GetGlobalDefaultSplitter();
+  const unsigned int              numberOfSlabs = splitter->GetNumberOfSplits(m_Region, m_NumberOfWorkUnits);
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+
+  // Find the runs of the slabs, whose lines are in raster order from one
+  // slab to the next
+  std::vector<SlabType> slabs(numberOfSlabs);
+  m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfSlabs,
+    [this, splitter, numberOfSlabs, &slabs](SizeValueType slab) {
+      RegionType slabRegion = m_Region;
+      splitter->GetSplit(slab, numberOfSlabs, slabRegion);
+      slabs[slab].Encode(m_Image, slabRegion);
+    },
+    nullptr);
+
+  // The labels are those of all the slabs
+  m_Labels = SlabType::MergeLabels(slabs);
+
+  // Each slab has a group of runs for some of the labels: find the label of
+  // each group, and the pixels and bounding box of its runs
+  std::vector<std::vector<Group>> groups(numberOfSlabs);
+  m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfSlabs,
+    [this, &slabs, &groups](SizeValueType slabNumber) {
+      const SlabType & slab = slabs[slabNumber];
+      auto             labelIt = m_Labels.cbegin();
+      for (auto it = slab.m_Labels.begin(); it != slab.m_Labels.end();)
+      {
+        const auto groupEnd = std::find_if(
+          it, slab.m_Labels.end(), [it](const LabelAndRunType & l) { return l.first != it->first; });
+        labelIt = std::lower_bound(labelIt, m_Labels.cend(), it->first);
+
+        Group group{ static_cast<SizeValueType>(labelIt - m_Labels.cbegin()),
+                     static_cast<SizeValueType>(it - slab.m_Labels.begin()),
+                     static_cast<SizeValueType>(groupEnd - it),
+                     0,
+                     0,
+                     IndexType::Filled(NumericTraits<IndexValueType>::max()),
+                     IndexType::Filled(NumericTraits<IndexValueType>::NonpositiveMin()) };
+        for (; it != groupEnd; ++it)
+        {
+          const RunType & run = slab.m_Runs[it->second];
+          const IndexType idx = this->ComputeIndex(run);
+          group.numberOfPixels += run.m_Length;
+          for (unsigned int i = 0; i < ImageDimension; ++i)
+          {
+            group.min[i] = std::min(group.min[i], idx[i]);
+            group.max[i] = std::max(group.max[i], idx[i]);
+          }
+          group.max[0] = std::max(group.max[0], idx[0] + static_cast<OffsetValueType>(run.m_Length) - 1);
+        }
+        groups[slabNumber].push_back(group);
+      }
+    },
+    nullptr);
+
+  // The runs of a label come from the slabs in order
+  const SizeValueType numberOfLabels = m_Labels.size();
+  m_RunOffsets.assign(numberOfLabels + 1, 0);
+  m_NumberOfPixels.assign(numberOfLabels, 0);
+  std::vector<IndexType> mins(numberOfLabels, IndexType::Filled(NumericTraits<IndexValueType>::max()));
+  std::vector<IndexType> maxs(numberOfLabels, IndexType::Filled(NumericTraits<IndexValueType>::NonpositiveMin()));
+  for (const std::vector<Group> & slabGroups : groups)
+  {
+    for (const Group & group : slabGroups)
+    {
+      m_RunOffsets[group.position + 1] += group.numberOfRuns;
+      m_NumberOfPixels[group.position] += group.numberOfPixels;
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        mins[group.position][i] = std::min(mins[group.position][i], group.min[i]);
+        maxs[group.position][i] = std::max(maxs[group.position][i], group.max[i]);
+      }
+    }
+  }
+  std::partial_sum(m_RunOffsets.begin(), m_RunOffsets.end(), m_RunOffsets.begin());
+  {
+    std::vector<SizeValueType> nextRuns(m_RunOffsets.begin(), m_RunOffsets.end() - 1);
+    for (std::vector<Group> & slabGroups : groups)
+    {
+      for (Group & group : slabGroups)
+      {
+        group.firstRun = nextRuns[group.position];
+        nextRuns[group.position] += group.numberOfRuns;
+      }
+    }
+  }
+
+  m_BoundingBoxes.resize(numberOfLabels);
+  for (SizeValueType position = 0; position < numberOfLabels; ++position)
+  {
+    typename RegionType::SizeType size;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      size[i] = static_cast<SizeValueType>(maxs[position][i] - mins[position][i] + 1);
+    }
+    m_BoundingBoxes[position] = RegionType(mins[position], size);
+  }
+
+  m_Runs.resize(m_RunOffsets.back());
+  m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfSlabs,
+    [this, &slabs, &groups](SizeValueType slabNumber) {
+      SlabType & slab = slabs[slabNumber];
+      for (const Group & group : groups[slabNumber])
+      {
+        for (SizeValueType run = 0; run < group.numberOfRuns; ++run)
+        {
+          m_Runs[group.firstRun + run] = slab.m_Runs[slab.m_Labels[group.first + run].second];
+        }
+      }
+      slab = SlabType();
+    },
+    nullptr);
+}
+
+template <typename TImage>
+SizeValueType
+LabelImageSpatialIndex<TImage>::FindLabel(const LabelType & label) const
+{
+  const auto it = std::lower_bound(m_Labels.cbegin(), m_Labels.cend(), label);
+  if (it == m_Labels.cend() || *it != label)
+  {
+    return m_Labels.size();
+  }
+  return static_cast<SizeValueType>(it - m_Labels.cbegin());
+}
+
+template <typename TImage>
+bool
+LabelImageSpatialIndex<TImage>::HasLabel(const LabelType & label) const
+{
+  return this->FindLabel(label) < m_Labels.size();
+}
+
+template <typename TImage>
+SizeValueType
+LabelImageSpatialIndex<TImage>::GetNumberOfPixels(const LabelType & label) const
+{
+  const SizeValueType position = this->FindLabel(label);
+  return position < m_Labels.size() ? m_NumberOfPixels[position] : 0;
+}
+
+template <typename TImage>
+auto
+LabelImageSpatialIndex<TImage>::GetBoundingBox(const LabelType & label) const -> RegionType
+{
+  const SizeValueType position = this->FindLabel(label);
+  return position < m_Labels.size() ? m_BoundingBoxes[position] : RegionType();
+}
+
+template <typename TImage>
+auto
+LabelImageSpatialIndex<TImage>::GetRuns(const LabelType & label) const -> RunRangeType
+{
+  const SizeValueType position = this->FindLabel(label);
+  if (position == m_Labels.size())
+  {
+    return RunRangeType();
+  }
+  return RunRangeType(m_Runs.data() + m_RunOffsets[position], m_Runs.data() + m_RunOffsets[position + 1]);
+}
+
+template <typename TImage>
+auto
+LabelImageSpatialIndex<TImage>::ComputeIndex(const RunType & run) const -> IndexType
+{
+  IndexType       idx;
+  OffsetValueType offset = run.m_Offset;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    const auto size = static_cast<OffsetValueType>(m_Region.GetSize(i));
+    idx[i] = m_Region.GetIndex(i) + offset % size;
+    offset /= size;
+  }
+  return idx;
+}
+
+template <typename TImage>
+void
+LabelImageSpatialIndex<TImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfObjectMacro(Image);
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+  itkPrintSelfObjectMacro(MultiThreader);
+  os << indent << "Region: " << m_Region << std::endl;
+  os << indent << "BuildTime: " << m_BuildTime.GetMTime() << std::endl;
+  os << indent << "NumberOfLabels: " << m_Labels.size() << std::endl;
+  os << indent << "NumberOfRuns: " << m_Runs.size() << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -20,10 +20,13 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkConstShapedNeighborhoodIterator.h"
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <functional>
 #include <mutex>
+#include <numeric>
+#include <utility>
 #include <vector>
 
 namespace itk
@@ -35,6 +38,13 @@ namespace itk
  * This implementation was taken from the Insight Journal paper:
  * https://doi.org/10.54294/q6auw4
  *
+ * The runs of the lines are labeled and merged by the work units
+ * concurrently: the equivalences between runs are kept in a lock-free
+ * union-find, where the root of a set is its smallest label, so that the
+ * work units link sets with atomic compare-and-swap operations and shorten
+ * the paths they follow. The final, consecutive labels are numbered
+ * concurrently as well, in the order of the runs.
+ *
  * \ingroup ITKImageLabel
  */
 template <typename TInputImage, typename TOutputImage>
@@ -130,7 +140,7 @@ protected:
 
   using LineMapType = std::vector<LineEncodingType>;
 
-  using UnionFindType = std::vector<InternalLabelType>;
+  using UnionFindType = std::vector<std::atomic<InternalLabelType>>;
   using ConsecutiveVectorType = std::vector<OutputPixelType>;
 
   SizeValueType
@@ -149,79 +159,162 @@ protected:
     return linearIndex;
   }
 
+  using BlockFunctionType = std::function<void(SizeValueType block, SizeValueType first, SizeValueType last)>;
+
+  /** Call \c blockFunction concurrently on consecutive blocks of the range
+   * [first, last), one per work unit of the enclosing filter. The blocks are
+   * numbered in the order of the range. */
+  void
+  ParallelizeBlocks(SizeValueType first, SizeValueType last, const BlockFunctionType & blockFunction)
+  {
+    const SizeValueType numberOfBlocks = this->GetNumberOfBlocks(first, last);
+    const SizeValueType size = last - first;
+    m_EnclosingFilter->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [first, size, numberOfBlocks, &blockFunction](SizeValueType block) {
+        blockFunction(block, first + block * size / numberOfBlocks, first + (block + 1) * size / numberOfBlocks);
+      },
+      nullptr);
+  }
+
+  SizeValueType
+  GetNumberOfBlocks(SizeValueType first, SizeValueType last) const
+  {
+    return std::min<SizeValueType>(last - first, m_EnclosingFilter->GetMultiThreader()->GetNumberOfWorkUnits());
+  }
+
   void
   InitUnion(InternalLabelType numberOfLabels)
   {
     m_UnionFind = UnionFindType(numberOfLabels + 1);
-
-    const auto        MapBegin = m_LineMap.begin();
-    const auto        MapEnd = m_LineMap.end();
-    InternalLabelType label = 1;
-    for (typename LineMapType::iterator LineIt = MapBegin; LineIt != MapEnd; ++LineIt)
+    m_UnionFind[0].store(0, std::memory_order_relaxed);
+
+    // The runs are labeled in the order of the lines, so the first label of
+    // a line follows the runs of the lines before it
+    const SizeValueType            numberOfLines = m_LineMap.size();
+    std::vector<InternalLabelType> firstLabels(numberOfLines);
+    InternalLabelType              label = 1;
+    for (SizeValueType line = 0; line < numberOfLines; ++line)
     {
-      for (auto cIt = LineIt->begin(); cIt != LineIt->end(); ++cIt)
-      {
-        cIt->label = label;
-        m_UnionFind[label] = label;
-        ++label;
-      }
+      firstLabels[line] = label;
+      label += m_LineMap[line].size();
     }
+
+    this->ParallelizeBlocks(
+      0, numberOfLines, [this, &firstLabels](SizeValueType, SizeValueType firstLine, SizeValueType lastLine) {
+        for (SizeValueType line = firstLine; line < lastLine; ++line)
+        {
+          InternalLabelType lineLabel = firstLabels[line];
+          for (auto & run : m_LineMap[line])
+          {
+            run.label = lineLabel;
+            m_UnionFind[lineLabel].store(lineLabel, std::memory_order_relaxed);
+            ++lineLabel;
+          }
+        }
+      });
   }
 
+  /** Return the root of the set of \c label, halving the path to it on the
+   * way. This may be called by several work units at once: a label that is
+   * not a root never becomes one again, and only ever gets closer to its
+   * root. */
   InternalLabelType
   LookupSet(const InternalLabelType label)
   {
     InternalLabelType l = label;
-    while (l != m_UnionFind[l])
+    while (true)
     {
-      l = m_UnionFind[l]; // transitively sets equivalence
+      const InternalLabelType parent = m_UnionFind[l].load(std::memory_order_relaxed);
+      if (parent == l)
+      {
+        return l;
+      }
+      const InternalLabelType grandparent = m_UnionFind[parent].load(std::memory_order_relaxed);
+      if (grandparent != parent)
+      {
+        m_UnionFind[l].store(grandparent, std::memory_order_relaxed);
+      }
+      l = grandparent; // transitively sets equivalence
     }
-    return l;
   }
 
+  /** Merge the sets of two labels, attaching the root with the larger label
+   * to the other one. The root is only changed if it still is a root, or the
+   * link is tried again from the new roots. */
   void
   LinkLabels(const InternalLabelType label1, const InternalLabelType label2)
   {
-    const std::lock_guard<std::mutex> lockGuard(m_Mutex);
-    const InternalLabelType           E1 = this->LookupSet(label1);
-    const InternalLabelType           E2 = this->LookupSet(label2);
-
-    if (E1 < E2)
-    {
-      m_UnionFind[E2] = E1;
-    }
-    else
+    InternalLabelType E1 = label1;
+    InternalLabelType E2 = label2;
+    while (true)
     {
-      m_UnionFind[E1] = E2;
+      E1 = this->LookupSet(E1);
+      E2 = this->LookupSet(E2);
+      if (E1 == E2)
+      {
+        return;
+      }
+      if (E2 < E1)
+      {
+        std::swap(E1, E2);
+      }
+      InternalLabelType expected = E2;
+      if (m_UnionFind[E2].compare_exchange_weak(expected, E1, std::memory_order_relaxed))
+      {
+        return;
+      }
     }
   }
 
   SizeValueType
   CreateConsecutive(OutputPixelType backgroundValue)
   {
-    const size_t N = m_UnionFind.size();
+    const SizeValueType N = m_UnionFind.size();
 
     m_Consecutive = ConsecutiveVectorType(N);
     m_Consecutive[0] = backgroundValue;
 
-    OutputPixelType consecutiveLabel = 0;
-    SizeValueType   count = 0;
-
-    for (size_t i = 1; i < N; ++i)
-    {
-      const auto label = static_cast<size_t>(m_UnionFind[i]);
-      if (label == i)
+    // Count the roots of each block of labels, then number the roots of each
+    // block from the count of the blocks before it
+    std::vector<SizeValueType> firstRanks(this->GetNumberOfBlocks(1, N) + 1, 0);
+    this->ParallelizeBlocks(1, N, [this, &firstRanks](SizeValueType block, SizeValueType first, SizeValueType last) {
+      SizeValueType count = 0;
+      for (SizeValueType i = first; i < last; ++i)
       {
-        if (consecutiveLabel == backgroundValue)
+        if (m_UnionFind[i].load(std::memory_order_relaxed) == i)
         {
-          ++consecutiveLabel;
+          ++count;
         }
-        m_Consecutive[label] = consecutiveLabel;
-        ++consecutiveLabel;
-        ++count;
       }
-    }
-    return count;
+      firstRanks[block + 1] = count;
+    });
+    std::partial_sum(firstRanks.begin(), firstRanks.end(), firstRanks.begin());
+
+    // The consecutive labels start at 0 and step over the background value
+    const bool skipBackground =
+      NumericTraits<OutputPixelType>::IsNonnegative(backgroundValue) &&
+      Math::ExactlyEquals(static_cast<OutputPixelType>(static_cast<SizeValueType>(backgroundValue)), backgroundValue);
+    const auto backgroundRank = static_cast<SizeValueType>(backgroundValue);
+
+    this->ParallelizeBlocks(
+      1,
+      N,
+      [this, &firstRanks, skipBackground, backgroundRank](
+        SizeValueType block, SizeValueType first, SizeValueType last) {
+        SizeValueType rank = firstRanks[block];
+        for (SizeValueType i = first; i < last; ++i)
+        {
+          if (m_UnionFind[i].load(std::memory_order_relaxed) == i)
+          {
+            const SizeValueType consecutiveLabel = (skipBackground && rank >= backgroundRank) ? rank + 1 : rank;
+            m_Consecutive[i] = static_cast<OutputPixelType>(consecutiveLabel);
+            ++rank;
+          }
+        }
+      });
+    return firstRanks.back();
   }
 
   bool
@@ -110,3 +110,83 @@ TEST(ChangeLabelImageFilter, ClearChangeMapPassesThrough)
     EXPECT_EQ(it.Get(), ot.Get());
   }
 }
+
+TEST(ChangeLabelImageFilter, LabelIndexWritesChangedLabels)
+{
+  constexpr unsigned int ImageDimension{ 3 };
+
+  using ImageType = itk::Image<unsigned short, ImageDimension>;
+  using InputPixelType = ImageType::PixelType;
+
+  using SourceType = itk::RandomImageSource<ImageType>;
+  auto source = SourceType::New();
+
+  ImageType::SizeValueType sizeArray[ImageDimension] = { 31, 17, 9 };
+
+  constexpr InputPixelType upper{ 10 };
+  source->SetMin(InputPixelType{});
+  source->SetMax(upper);
+  source->SetSize(sizeArray);
+  source->Update();
+  const ImageType::Pointer input = source->GetOutput();
+
+  using FilterType = itk::ChangeLabelImageFilter<ImageType, ImageType>;
+  FilterType::ChangeMapType changeMap;
+  changeMap[2] = 7;
+  changeMap[5] = 0;
+  changeMap[7] = 7;
+  changeMap[upper + 1] = 3;
+
+  auto reference = FilterType::New();
+  reference->SetInput(input);
+  reference->SetChangeMap(changeMap);
+  reference->Update();
+
+  auto labelIndex = FilterType::LabelIndexType::New();
+  labelIndex->SetImage(input);
+
+  auto filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetChangeMap(changeMap);
+  filter->SetLabelIndex(labelIndex);
+  EXPECT_EQ(filter->GetLabelIndex(), labelIndex);
+  EXPECT_NO_THROW(filter->Update());
+
+  itk::ImageRegionIteratorWithIndex<ImageType> rt(reference->GetOutput(), reference->GetOutput()->GetRequestedRegion());
+  itk::ImageRegionIteratorWithIndex<ImageType> ot(filter->GetOutput(), filter->GetOutput()->GetRequestedRegion());
+  for (; !rt.IsAtEnd(); ++rt, ++ot)
+  {
+    EXPECT_EQ(rt.Get(), ot.Get());
+  }
+
+  // The index of the input is still valid
+  itk::SizeValueType numberOfIndexedPixels = 0;
+  for (const InputPixelType label : labelIndex->GetLabels())
+  {
+    for (const FilterType::LabelIndexType::RunType & run : labelIndex->GetRuns(label))
+    {
+      EXPECT_EQ(input->GetBufferPointer()[run.m_Offset], label);
+      numberOfIndexedPixels += run.m_Length;
+    }
+  }
+  EXPECT_EQ(numberOfIndexedPixels, input->GetBufferedRegion().GetNumberOfPixels());
+
+  // Running in place overwrites the input, whose index is then modified
+  const InputPixelType *      inputBuffer = input->GetBufferPointer();
+  const itk::ModifiedTimeType labelIndexMTime = labelIndex->GetMTime();
+  auto                        inPlaceFilter = FilterType::New();
+  inPlaceFilter->SetInput(input);
+  inPlaceFilter->SetChangeMap(changeMap);
+  inPlaceFilter->SetLabelIndex(labelIndex);
+  inPlaceFilter->InPlaceOn();
+  EXPECT_NO_THROW(inPlaceFilter->Update());
+  EXPECT_EQ(inPlaceFilter->GetOutput()->GetBufferPointer(), inputBuffer);
+  EXPECT_GT(labelIndex->GetMTime(), labelIndexMTime);
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(inPlaceFilter->GetOutput(),
+                                                  inPlaceFilter->GetOutput()->GetRequestedRegion());
+  for (rt.GoToBegin(); !rt.IsAtEnd(); ++rt, ++it)
+  {
+    EXPECT_EQ(rt.Get(), it.Get());
+  }
+}
@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLabelImageSpatialIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkGTest.h"
+#include <map>
+#include <random>
+
+namespace
+{
+using ImageType = itk::Image<unsigned short, 3>;
+using IndexType = ImageType::IndexType;
+using RegionType = ImageType::RegionType;
+using SpatialIndexType = itk::LabelImageSpatialIndex<ImageType>;
+
+// Boxes of labels over a background, in an image that does not start at
+// the origin
+ImageType::Pointer
+MakeLabelImage()
+{
+  auto image = ImageType::New();
+  image->SetRegions(RegionType({ { -3, 2, 5 } }, { { 41, 29, 17 } }));
+  image->AllocateInitialized();
+
+  std::mt19937                          generator(42);
+  std::uniform_int_distribution<int>    label(1, 40);
+  std::uniform_int_distribution<size_t> size(1, 12);
+  for (unsigned int box = 0; box < 60; ++box)
+  {
+    IndexType corner;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      std::uniform_int_distribution<itk::IndexValueType> position(image->GetBufferedRegion().GetIndex(i),
+                                                                  image->GetBufferedRegion().GetUpperIndex()[i]);
+      corner[i] = position(generator);
+    }
+    RegionType boxRegion(corner, { { size(generator), size(generator), size(generator) } });
+    boxRegion.Crop(image->GetBufferedRegion());
+    const auto value = static_cast<ImageType::PixelType>(label(generator));
+    for (itk::ImageRegionIterator<ImageType> it(image, boxRegion); !it.IsAtEnd(); ++it)
+    {
+      it.Set(value);
+    }
+  }
+  return image;
+}
+
+struct Expected
+{
+  itk::SizeValueType numberOfPixels{ 0 };
+  IndexType          min{ IndexType::Filled(itk::NumericTraits<itk::IndexValueType>::max()) };
+  IndexType          max{ IndexType::Filled(itk::NumericTraits<itk::IndexValueType>::NonpositiveMin()) };
+};
+
+void
+CheckIndex(const ImageType * image, const SpatialIndexType * index)
+{
+  std::map<ImageType::PixelType, Expected> expected;
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    Expected & e = expected[it.Get()];
+    ++e.numberOfPixels;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      e.min[i] = std::min(e.min[i], it.GetIndex()[i]);
+      e.max[i] = std::max(e.max[i], it.GetIndex()[i]);
+    }
+  }
+
+  ASSERT_EQ(index->GetLabels().size(), expected.size());
+  EXPECT_EQ(index->GetRegion(), image->GetBufferedRegion());
+  auto labelIt = index->GetLabels().begin();
+  for (const auto & labelAndExpected : expected)
+  {
+    const ImageType::PixelType label = labelAndExpected.first;
+    EXPECT_EQ(*labelIt++, label);
+    EXPECT_TRUE(index->HasLabel(label));
+    EXPECT_EQ(index->GetNumberOfPixels(label), labelAndExpected.second.numberOfPixels);
+    const RegionType boundingBox = index->GetBoundingBox(label);
+    EXPECT_EQ(boundingBox.GetIndex(), labelAndExpected.second.min);
+    EXPECT_EQ(boundingBox.GetUpperIndex(), labelAndExpected.second.max);
+
+    // The runs are maximal, in raster order, and cover the pixels of the
+    // label
+    itk::SizeValueType  numberOfPixels = 0;
+    itk::OffsetValueType previousEnd = -1;
+    for (const SpatialIndexType::RunType & run : index->GetRuns(label))
+    {
+      EXPECT_GE(run.m_Offset, previousEnd);
+      const IndexType start = index->ComputeIndex(run);
+      EXPECT_EQ(start, image->ComputeIndex(run.m_Offset));
+      if (start[0] > image->GetBufferedRegion().GetIndex(0))
+      {
+        EXPECT_NE(image->GetBufferPointer()[run.m_Offset - 1], label);
+      }
+      for (itk::SizeValueType x = 0; x < run.m_Length; ++x)
+      {
+        EXPECT_EQ(image->GetBufferPointer()[run.m_Offset + x], label);
+      }
+      previousEnd = run.m_Offset + static_cast<itk::OffsetValueType>(run.m_Length);
+      numberOfPixels += run.m_Length;
+    }
+    EXPECT_EQ(numberOfPixels, labelAndExpected.second.numberOfPixels);
+  }
+
+  EXPECT_FALSE(index->HasLabel(1000));
+  EXPECT_EQ(index->GetNumberOfPixels(1000), 0u);
+  EXPECT_EQ(index->GetBoundingBox(1000).GetNumberOfPixels(), 0u);
+  EXPECT_EQ(index->GetRuns(1000).size(), 0u);
+}
+} // namespace
+
+
+TEST(LabelImageSpatialIndex, BasicObject)
+{
+  auto index = SpatialIndexType::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(index, LabelImageSpatialIndex, Object);
+
+  EXPECT_THROW(index->Update(), itk::ExceptionObject);
+}
+
+TEST(LabelImageSpatialIndex, MatchesImage)
+{
+  const ImageType::Pointer image = MakeLabelImage();
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 2, 3, 8 })
+  {
+    auto index = SpatialIndexType::New();
+    index->SetImage(image);
+    index->SetNumberOfWorkUnits(numberOfWorkUnits);
+    index->Update();
+    CheckIndex(image, index);
+  }
+}
+
+TEST(LabelImageSpatialIndex, RebuiltWhenModified)
+{
+  const ImageType::Pointer image = MakeLabelImage();
+  auto                     index = SpatialIndexType::New();
+  index->SetImage(image);
+  index->Update();
+  EXPECT_FALSE(index->HasLabel(77));
+
+  // Writing to the buffer does not modify the image: the index is kept
+  const IndexType corner = image->GetBufferedRegion().GetIndex();
+  image->GetBufferPointer()[0] = 77;
+  index->Update();
+  EXPECT_FALSE(index->HasLabel(77));
+
+  image->Modified();
+  index->Update();
+  EXPECT_TRUE(index->HasLabel(77));
+  EXPECT_EQ(index->GetBoundingBox(77), RegionType(corner, { { 1, 1, 1 } }));
+  CheckIndex(image, index);
+
+  // A new buffer, for another region
+  image->SetRegions(RegionType({ { 0, 0, 0 } }, { { 5, 6, 7 } }));
+  image->Allocate();
+  image->FillBuffer(3);
+  index->Update();
+  ASSERT_EQ(index->GetLabels().size(), 1u);
+  EXPECT_EQ(index->GetBoundingBox(3), image->GetBufferedRegion());
+  EXPECT_EQ(index->GetRuns(3).size(), 6u * 7u);
+}
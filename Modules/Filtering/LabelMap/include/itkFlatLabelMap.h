@@ -0,0 +1,248 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFlatLabelMap_h
+#define itkFlatLabelMap_h
+
+#include "itkImageBase.h"
+#include "itkLabelMap.h"
+#include "itkMultiThreaderBase.h"
+#include <functional>
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class FlatLabelMap
+ * \brief Label map that stores the lines of all its objects in contiguous arrays.
+ *
+ * FlatLabelMap holds the same content as a LabelMap, a background value and
+ * a set of labeled objects made of lines, but stores it differently: instead
+ * of a map of LabelObjects that each own a container of lines, the lines of
+ * all the objects are stored together, sorted by label, in an array of
+ * indexes and an array of lengths. An index table gives the position of the
+ * first line of each object. The objects are addressed by their position in
+ * the sorted list of labels.
+ *
+ * This layout needs three allocations whatever the number of objects, and
+ * reads the lines of an object from contiguous memory, which makes it
+ * efficient for images with many small objects. The lines of an object are
+ * in raster order when the map is built from a label image.
+ *
+ * A FlatLabelMap is read-only once built: it is created from a label image
+ * by LabelImageToFlatLabelMapFilter, or from a LabelMap by
+ * CopyFromLabelMap(). CopyToLabelMap() turns it back into a LabelMap for the
+ * LabelMap filters, and FlatLabelMapToLabelImageFilter into a label image.
+ * The attributes of the objects are not stored: FlatLabelMapShapeCalculator
+ * computes the basic shape attributes of all the objects concurrently, and
+ * other computations can use ParallelizeLabelObjects() likewise.
+ *
+ * \sa LabelMap, LabelImageToFlatLabelMapFilter, FlatLabelMapToLabelImageFilter
+ * \sa FlatLabelMapShapeCalculator
+ * \ingroup ImageObjects
+ * \ingroup ITKLabelMap
+ */
+template <typename TLabelObject>
+class ITK_TEMPLATE_EXPORT FlatLabelMap : public ImageBase<TLabelObject::ImageDimension>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(FlatLabelMap);
+
+  /** Standard class type aliases */
+  using Self = FlatLabelMap;
+  using Superclass = ImageBase<TLabelObject::ImageDimension>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(FlatLabelMap);
+
+  using LabelObjectType = TLabelObject;
+  using LabelMapType = LabelMap<LabelObjectType>;
+
+  using typename Superclass::SizeValueType;
+  using LengthType = SizeValueType;
+
+  /** Dimension of the image. */
+  static constexpr unsigned int ImageDimension = LabelObjectType::ImageDimension;
+
+  /** Label type alias support */
+  using LabelType = typename LabelObjectType::LabelType;
+  using PixelType = LabelType;
+
+  using typename Superclass::IndexType;
+  using typename Superclass::OffsetType;
+  using typename Superclass::SizeType;
+  using typename Superclass::DirectionType;
+  using typename Superclass::RegionType;
+  using typename Superclass::SpacingType;
+  using typename Superclass::PointType;
+  using typename Superclass::OffsetValueType;
+
+  /** The arrays of the map. */
+  using LabelVectorType = std::vector<LabelType>;
+  using LineOffsetVectorType = std::vector<SizeValueType>;
+  using IndexVectorType = std::vector<IndexType>;
+  using LengthVectorType = std::vector<LengthType>;
+
+  /** Function called for each object by ParallelizeLabelObjects(), with the
+   * position of the object. */
+  using LabelObjectFunctionType = std::function<void(SizeValueType)>;
+
+  /** Restore the data object to its initial state. This means releasing
+   * memory. */
+  void
+  Initialize() override;
+
+  /** Release the objects: a FlatLabelMap is filled by SetLines(). */
+  void
+  Allocate(bool initialize = false) override;
+
+  virtual void
+  Graft(const Self * imgData);
+
+  /**
+   * Set/Get the background label
+   */
+  /** @ITKStartGrouping */
+  itkGetConstMacro(BackgroundValue, LabelType);
+  itkSetMacro(BackgroundValue, LabelType);
+  /** @ITKEndGrouping */
+
+  /** Replace the objects of the map. \c labels must be sorted and unique,
+   * \c lineOffsets holds the position of the first line of each object
+   * followed by the total number of lines, and \c lineIndexes and
+   * \c lineLengths hold the lines of the objects, one after the other. */
+  void
+  SetLines(LabelVectorType &&      labels,
+           LineOffsetVectorType && lineOffsets,
+           IndexVectorType &&      lineIndexes,
+           LengthVectorType &&     lineLengths);
+
+  /** Return the number of label objects in the map. */
+  SizeValueType
+  GetNumberOfLabelObjects() const
+  {
+    return static_cast<SizeValueType>(m_Labels.size());
+  }
+
+  /** Return the total number of lines of the objects. */
+  SizeValueType
+  GetNumberOfLines() const
+  {
+    return static_cast<SizeValueType>(m_LineLengths.size());
+  }
+
+  /** Return the sorted labels of the objects. */
+  const LabelVectorType &
+  GetLabels() const
+  {
+    return m_Labels;
+  }
+
+  /** Return the label of the object at \c position. */
+  const LabelType &
+  GetLabel(SizeValueType position) const
+  {
+    return m_Labels[position];
+  }
+
+  /** Return true if an object has the label \c label. */
+  bool
+  HasLabel(const LabelType & label) const;
+
+  /** Return the position of the object with the label \c label. This method
+   * throws an exception if there is no such object. */
+  SizeValueType
+  GetLabelPosition(const LabelType & label) const;
+
+  /** Return the lines of the object at \c position: they are the lines from
+   * GetFirstLine(position) up to, but excluding, GetEndLine(position). */
+  /** @ITKStartGrouping */
+  SizeValueType
+  GetFirstLine(SizeValueType position) const
+  {
+    return m_LineOffsets[position];
+  }
+  SizeValueType
+  GetEndLine(SizeValueType position) const
+  {
+    return m_LineOffsets[position + 1];
+  }
+  /** @ITKEndGrouping */
+
+  /** Return the index of the first pixel, and the length, of a line. */
+  /** @ITKStartGrouping */
+  const IndexType &
+  GetLineIndex(SizeValueType line) const
+  {
+    return m_LineIndexes[line];
+  }
+  LengthType
+  GetLineLength(SizeValueType line) const
+  {
+    return m_LineLengths[line];
+  }
+  /** @ITKEndGrouping */
+
+  /** Return the number of pixels of the object at \c position. */
+  SizeValueType
+  GetNumberOfPixels(SizeValueType position) const;
+
+  /** Call \c function concurrently for every object, with its position. The
+   * objects are shared among the work units of \c multiThreader by their
+   * number of lines, so that large and small objects are balanced. */
+  void
+  ParallelizeLabelObjects(MultiThreaderBase * multiThreader, const LabelObjectFunctionType & function) const;
+
+  /** Replace the content of this map by the content of \c labelMap. The lines
+   * are copied concurrently by the work units of \c multiThreader. */
+  void
+  CopyFromLabelMap(const LabelMapType * labelMap, MultiThreaderBase * multiThreader);
+
+  /** Replace the content of \c labelMap by the content of this map. The label
+   * objects are created concurrently by the work units of \c multiThreader. */
+  void
+  CopyToLabelMap(LabelMapType * labelMap, MultiThreaderBase * multiThreader) const;
+
+protected:
+  FlatLabelMap() = default;
+  ~FlatLabelMap() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  void
+  Graft(const DataObject * data) override;
+  using Superclass::Graft;
+
+private:
+  LabelVectorType      m_Labels{};
+  LineOffsetVectorType m_LineOffsets{ 0 };
+  IndexVectorType      m_LineIndexes{};
+  LengthVectorType     m_LineLengths{};
+  LabelType            m_BackgroundValue{};
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkFlatLabelMap.hxx"
+#endif
+
+#endif
@@ -0,0 +1,264 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFlatLabelMap_hxx
+#define itkFlatLabelMap_hxx
+
+#include "itkPrintHelper.h"
+#include <algorithm>
+#include <numeric>
+
+namespace itk
+{
+
+template <typename TLabelObject>
+void
+FlatLabelMap<TLabelObject>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  print_helper::PrintNumericTrait(os, indent, "BackgroundValue", m_BackgroundValue);
+  os << indent << "NumberOfLabelObjects: " << this->GetNumberOfLabelObjects() << std::endl;
+  os << indent << "NumberOfLines: " << this->GetNumberOfLines() << std::endl;
+}
+
+
+template <typename TLabelObject>
+void
+FlatLabelMap<TLabelObject>::Initialize()
+{
+  LabelVectorType().swap(m_Labels);
+  LineOffsetVectorType{ 0 }.swap(m_LineOffsets);
+  IndexVectorType().swap(m_LineIndexes);
+  LengthVectorType().swap(m_LineLengths);
+}
+
+
+template <typename TLabelObject>
+void
+FlatLabelMap<TLabelObject>::Allocate(bool)
+{
+  this->Initialize();
+}
+
+
+template <typename TLabelObject>
+void
+FlatLabelMap<TLabelObject>::Graft(const Self * imgData)
+{
+  if (imgData == nullptr)
+  {
+    return; // nothing to do
+  }
+  // call the superclass' implementation
+  Superclass::Graft(imgData);
+
+  // Now copy anything remaining that is needed
+  if (this != imgData)
+  {
+    m_Labels = imgData->m_Labels;
+    m_LineOffsets = imgData->m_LineOffsets;
+    m_LineIndexes = imgData->m_LineIndexes;
+    m_LineLengths = imgData->m_LineLengths;
+  }
+  m_BackgroundValue = imgData->m_BackgroundValue;
+}
+
+
+template <typename TLabelObject>
+void
+FlatLabelMap<TLabelObject>::Graft(const DataObject * data)
+{
+  if (data == nullptr)
+  {
+    return; // nothing to do
+  }
+
+  // Attempt to cast data to a FlatLabelMap
+  const auto * imgData = dynamic_cast<const Self *>(data);
+
+  if (imgData == nullptr)
+  {
+    // pointer could not be cast back down
+    itkExceptionMacro("itk::FlatLabelMap::Graft() cannot cast " << typeid(data).name() << " to "
+                                                                << typeid(const Self *).name());
+  }
+  this->Graft(imgData);
+}
+
+
+template <typename TLabelObject>
+void
+FlatLabelMap<TLabelObject>::SetLines(LabelVectorType &&      labels,
+                                     LineOffsetVectorType && lineOffsets,
+                                     IndexVectorType &&      lineIndexes,
+                                     LengthVectorType &&     lineLengths)
+{
+  if (lineOffsets.size() != labels.size() + 1 || lineIndexes.size() != lineLengths.size() ||
+      lineOffsets.front() != 0 || lineOffsets.back() != lineLengths.size())
+  {
+    itkExceptionMacro("The line offsets do not match the labels and the lines.");
+  }
+  if (std::adjacent_find(labels.begin(), labels.end(), std::greater_equal<LabelType>()) != labels.end())
+  {
+    itkExceptionMacro("The labels are not sorted, or not unique.");
+  }
+
+  m_Labels = std::move(labels);
+  m_LineOffsets = std::move(lineOffsets);
+  m_LineIndexes = std::move(lineIndexes);
+  m_LineLengths = std::move(lineLengths);
+  this->Modified();
+}
+
+
+template <typename TLabelObject>
+bool
+FlatLabelMap<TLabelObject>::HasLabel(const LabelType & label) const
+{
+  return std::binary_search(m_Labels.begin(), m_Labels.end(), label);
+}
+
+
+template <typename TLabelObject>
+auto
+FlatLabelMap<TLabelObject>::GetLabelPosition(const LabelType & label) const -> SizeValueType
+{
+  const auto it = std::lower_bound(m_Labels.begin(), m_Labels.end(), label);
+  if (it == m_Labels.end() || *it != label)
+  {
+    itkExceptionMacro("No label object with label " << static_cast<typename NumericTraits<LabelType>::PrintType>(label)
+                                                    << '.');
+  }
+  return static_cast<SizeValueType>(it - m_Labels.begin());
+}
+
+
+template <typename TLabelObject>
+auto
+FlatLabelMap<TLabelObject>::GetNumberOfPixels(SizeValueType position) const -> SizeValueType
+{
+  return std::accumulate(m_LineLengths.begin() + m_LineOffsets[position],
+                         m_LineLengths.begin() + m_LineOffsets[position + 1],
+                         SizeValueType{ 0 });
+}
+
+
+template <typename TLabelObject>
+void
+FlatLabelMap<TLabelObject>::ParallelizeLabelObjects(MultiThreaderBase *             multiThreader,
+                                                    const LabelObjectFunctionType & function) const
+{
+  const SizeValueType numberOfLabelObjects = this->GetNumberOfLabelObjects();
+  const SizeValueType numberOfLines = this->GetNumberOfLines();
+  const SizeValueType numberOfBlocks =
+    std::min<SizeValueType>(numberOfLabelObjects, multiThreader->GetNumberOfWorkUnits());
+
+  // A block starts with the first object whose lines start after its share
+  // of the lines
+  const auto firstPosition = [this, numberOfLabelObjects, numberOfLines, numberOfBlocks](SizeValueType block) {
+    if (block == numberOfBlocks)
+    {
+      return numberOfLabelObjects;
+    }
+    const SizeValueType firstLine = block * numberOfLines / numberOfBlocks;
+    return static_cast<SizeValueType>(
+      std::lower_bound(m_LineOffsets.begin(), m_LineOffsets.end() - 1, firstLine) - m_LineOffsets.begin());
+  };
+
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&firstPosition, &function](SizeValueType block) {
+      const SizeValueType endPosition = firstPosition(block + 1);
+      for (SizeValueType position = firstPosition(block); position < endPosition; ++position)
+      {
+        function(position);
+      }
+    },
+    nullptr);
+}
+
+
+template <typename TLabelObject>
+void
+FlatLabelMap<TLabelObject>::CopyFromLabelMap(const LabelMapType * labelMap, MultiThreaderBase * multiThreader)
+{
+  const typename LabelMapType::LabelObjectVectorType labelObjects = labelMap->GetLabelObjects();
+  const SizeValueType                                numberOfLabelObjects = labelObjects.size();
+
+  LabelVectorType      labels(numberOfLabelObjects);
+  LineOffsetVectorType lineOffsets(numberOfLabelObjects + 1, 0);
+  for (SizeValueType position = 0; position < numberOfLabelObjects; ++position)
+  {
+    labels[position] = labelObjects[position]->GetLabel();
+    lineOffsets[position + 1] = lineOffsets[position] + labelObjects[position]->GetNumberOfLines();
+  }
+
+  IndexVectorType  lineIndexes(lineOffsets.back());
+  LengthVectorType lineLengths(lineOffsets.back());
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfLabelObjects,
+    [&labelObjects, &lineOffsets, &lineIndexes, &lineLengths](SizeValueType position) {
+      SizeValueType line = lineOffsets[position];
+      for (typename LabelObjectType::ConstLineIterator lit(labelObjects[position]); !lit.IsAtEnd(); ++lit, ++line)
+      {
+        lineIndexes[line] = lit.GetLine().GetIndex();
+        lineLengths[line] = lit.GetLine().GetLength();
+      }
+    },
+    nullptr);
+
+  this->CopyInformation(labelMap);
+  this->SetBufferedRegion(labelMap->GetBufferedRegion());
+  this->SetRequestedRegion(labelMap->GetRequestedRegion());
+  m_BackgroundValue = labelMap->GetBackgroundValue();
+  this->SetLines(std::move(labels), std::move(lineOffsets), std::move(lineIndexes), std::move(lineLengths));
+}
+
+
+template <typename TLabelObject>
+void
+FlatLabelMap<TLabelObject>::CopyToLabelMap(LabelMapType * labelMap, MultiThreaderBase * multiThreader) const
+{
+  const SizeValueType                         numberOfLabelObjects = this->GetNumberOfLabelObjects();
+  typename LabelMapType::LabelObjectVectorType labelObjects(numberOfLabelObjects);
+  this->ParallelizeLabelObjects(multiThreader, [this, &labelObjects](SizeValueType position) {
+    auto labelObject = LabelObjectType::New();
+    labelObject->SetLabel(m_Labels[position]);
+    for (SizeValueType line = m_LineOffsets[position]; line < m_LineOffsets[position + 1]; ++line)
+    {
+      labelObject->AddLine(m_LineIndexes[line], m_LineLengths[line]);
+    }
+    labelObjects[position] = labelObject;
+  });
+
+  labelMap->ClearLabels();
+  labelMap->CopyInformation(this);
+  labelMap->SetBufferedRegion(this->GetBufferedRegion());
+  labelMap->SetRequestedRegion(this->GetRequestedRegion());
+  labelMap->SetBackgroundValue(m_BackgroundValue);
+  for (const auto & labelObject : labelObjects)
+  {
+    labelMap->AddLabelObject(labelObject);
+  }
+}
+
+} // end namespace itk
+
+#endif
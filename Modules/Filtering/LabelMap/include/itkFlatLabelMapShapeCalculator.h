@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFlatLabelMapShapeCalculator_h
+#define itkFlatLabelMapShapeCalculator_h
+
+#include "itkFlatLabelMap.h"
+#include "itkPoint.h"
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class FlatLabelMapShapeCalculator
+ * \brief Computes the basic shape attributes of the objects of a FlatLabelMap.
+ *
+ * For each object of the map, the calculator computes the attributes of
+ * ShapeLabelMapFilter that only depend on the lines of the object: its
+ * number of pixels, its physical size, its centroid, its bounding box and
+ * its number of pixels on the border of the image. They are computed with
+ * the same formulas, for all the objects concurrently, by the work units of
+ * the multi-threader of the calculator.
+ *
+ * The attributes are given by the position of the object in the map, and
+ * kept in arrays instead of in label objects. The other attributes, such as
+ * the perimeter or the principal moments, need the map to be copied into a
+ * LabelMap of ShapeLabelObjects for ShapeLabelMapFilter.
+ *
+ * \sa FlatLabelMap, ShapeLabelMapFilter, ShapeLabelObject
+ * \ingroup ITKLabelMap
+ */
+template <typename TFlatLabelMap>
+class ITK_TEMPLATE_EXPORT FlatLabelMapShapeCalculator : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(FlatLabelMapShapeCalculator);
+
+  /** Standard class type aliases. */
+  using Self = FlatLabelMapShapeCalculator;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(FlatLabelMapShapeCalculator);
+
+  static constexpr unsigned int ImageDimension = TFlatLabelMap::ImageDimension;
+
+  using FlatLabelMapType = TFlatLabelMap;
+  using RegionType = typename FlatLabelMapType::RegionType;
+  using IndexType = typename FlatLabelMapType::IndexType;
+  using CentroidType = Point<double, ImageDimension>;
+
+  /** The map of the objects. */
+  /** @ITKStartGrouping */
+  itkSetConstObjectMacro(FlatLabelMap, FlatLabelMapType);
+  itkGetConstObjectMacro(FlatLabelMap, FlatLabelMapType);
+  /** @ITKEndGrouping */
+
+  /** Number of work units used to compute the attributes. The default is the
+   * global default number of threads of the multi-threader. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+  /** @ITKEndGrouping */
+
+  /** Compute the attributes of all the objects of the map. */
+  void
+  Compute();
+
+  /** The attributes of the object at \c position in the map. */
+  /** @ITKStartGrouping */
+  [[nodiscard]] SizeValueType
+  GetNumberOfPixels(SizeValueType position) const
+  {
+    return m_NumberOfPixels[position];
+  }
+  [[nodiscard]] double
+  GetPhysicalSize(SizeValueType position) const
+  {
+    return m_PhysicalSizes[position];
+  }
+  [[nodiscard]] const CentroidType &
+  GetCentroid(SizeValueType position) const
+  {
+    return m_Centroids[position];
+  }
+  [[nodiscard]] const RegionType &
+  GetBoundingBox(SizeValueType position) const
+  {
+    return m_BoundingBoxes[position];
+  }
+  [[nodiscard]] SizeValueType
+  GetNumberOfPixelsOnBorder(SizeValueType position) const
+  {
+    return m_NumberOfPixelsOnBorder[position];
+  }
+  /** @ITKEndGrouping */
+
+protected:
+  FlatLabelMapShapeCalculator();
+  ~FlatLabelMapShapeCalculator() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  typename FlatLabelMapType::ConstPointer m_FlatLabelMap{};
+  ThreadIdType                            m_NumberOfWorkUnits{ 1 };
+  MultiThreaderBase::Pointer              m_MultiThreader{};
+
+  std::vector<SizeValueType> m_NumberOfPixels{};
+  std::vector<double>        m_PhysicalSizes{};
+  std::vector<CentroidType>  m_Centroids{};
+  std::vector<RegionType>    m_BoundingBoxes{};
+  std::vector<SizeValueType> m_NumberOfPixelsOnBorder{};
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkFlatLabelMapShapeCalculator.hxx"
+#endif
+
+#endif
@@ -0,0 +1,138 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFlatLabelMapShapeCalculator_hxx
+#define itkFlatLabelMapShapeCalculator_hxx
+
+#include "itkContinuousIndex.h"
+#include "itkNumericTraits.h"
+#include <algorithm>
+
+namespace itk
+{
+template <typename TFlatLabelMap>
+FlatLabelMapShapeCalculator<TFlatLabelMap>::FlatLabelMapShapeCalculator()
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
+{}
+
+template <typename TFlatLabelMap>
+void
+FlatLabelMapShapeCalculator<TFlatLabelMap>::Compute()
+{
+  if (m_FlatLabelMap == nullptr)
+  {
+    itkExceptionMacro("FlatLabelMap not set");
+  }
+
+  const FlatLabelMapType * map = m_FlatLabelMap;
+  const SizeValueType      numberOfLabelObjects = map->GetNumberOfLabelObjects();
+  m_NumberOfPixels.assign(numberOfLabelObjects, 0);
+  m_PhysicalSizes.assign(numberOfLabelObjects, 0.0);
+  m_Centroids.assign(numberOfLabelObjects, CentroidType());
+  m_BoundingBoxes.assign(numberOfLabelObjects, RegionType());
+  m_NumberOfPixelsOnBorder.assign(numberOfLabelObjects, 0);
+
+  const RegionType & largestRegion = map->GetLargestPossibleRegion();
+  const IndexType    borderMin = largestRegion.GetIndex();
+  const IndexType    borderMax = largestRegion.GetUpperIndex();
+  double             sizePerPixel = 1.0;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    sizePerPixel *= map->GetSpacing()[i];
+  }
+
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  map->ParallelizeLabelObjects(m_MultiThreader, [&](SizeValueType position) {
+    SizeValueType                           numberOfPixels = 0;
+    ContinuousIndex<double, ImageDimension> centroid{};
+    auto                                    mins = IndexType::Filled(NumericTraits<IndexValueType>::max());
+    auto                                    maxs = IndexType::Filled(NumericTraits<IndexValueType>::NonpositiveMin());
+    SizeValueType                           numberOfPixelsOnBorder = 0;
+
+    for (SizeValueType line = map->GetFirstLine(position); line < map->GetEndLine(position); ++line)
+    {
+      const IndexType &     idx = map->GetLineIndex(line);
+      const SizeValueType   length = map->GetLineLength(line);
+      const OffsetValueType lastIndex0 = idx[0] + static_cast<OffsetValueType>(length) - 1;
+
+      numberOfPixels += length;
+
+      for (unsigned int i = 1; i < ImageDimension; ++i)
+      {
+        centroid[i] += static_cast<OffsetValueType>(length) * idx[i];
+      }
+      centroid[0] += idx[0] * static_cast<OffsetValueType>(length) + (length * (length - 1)) / 2.0;
+
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        mins[i] = std::min(mins[i], idx[i]);
+        maxs[i] = std::max(maxs[i], idx[i]);
+      }
+      maxs[0] = std::max(maxs[0], lastIndex0);
+
+      // A line on a border of a dimension other than 0 is on the border as a
+      // whole, otherwise only its ends can be
+      bool isOnBorder = false;
+      for (unsigned int i = 1; i < ImageDimension; ++i)
+      {
+        isOnBorder = isOnBorder || idx[i] == borderMin[i] || idx[i] == borderMax[i];
+      }
+      if (isOnBorder)
+      {
+        numberOfPixelsOnBorder += length;
+      }
+      else
+      {
+        const bool isFirstOnBorder = idx[0] == borderMin[0];
+        numberOfPixelsOnBorder += isFirstOnBorder;
+        if ((!isFirstOnBorder || length > 1) && lastIndex0 == borderMax[0])
+        {
+          ++numberOfPixelsOnBorder;
+        }
+      }
+    }
+
+    typename RegionType::SizeType boundingBoxSize;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      centroid[i] /= numberOfPixels;
+      boundingBoxSize[i] = static_cast<SizeValueType>(maxs[i] - mins[i] + 1);
+    }
+
+    m_NumberOfPixels[position] = numberOfPixels;
+    m_PhysicalSizes[position] = numberOfPixels * sizePerPixel;
+    map->TransformContinuousIndexToPhysicalPoint(centroid, m_Centroids[position]);
+    m_BoundingBoxes[position] = RegionType(mins, boundingBoxSize);
+    m_NumberOfPixelsOnBorder[position] = numberOfPixelsOnBorder;
+  });
+}
+
+template <typename TFlatLabelMap>
+void
+FlatLabelMapShapeCalculator<TFlatLabelMap>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  itkPrintSelfObjectMacro(FlatLabelMap);
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+  itkPrintSelfObjectMacro(MultiThreader);
+  os << indent << "NumberOfLabelObjects: " << m_NumberOfPixels.size() << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -0,0 +1,94 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFlatLabelMapToLabelImageFilter_h
+#define itkFlatLabelMapToLabelImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+namespace itk
+{
+/**
+ * \class FlatLabelMapToLabelImageFilter
+ * \brief Converts a FlatLabelMap to a labeled image.
+ *
+ * FlatLabelMapToLabelImageFilter does for a FlatLabelMap what
+ * LabelMapToLabelImageFilter does for a LabelMap. The objects are painted
+ * concurrently, the work units sharing them by their number of lines.
+ *
+ * \sa FlatLabelMap, LabelImageToFlatLabelMapFilter, LabelMapToLabelImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ * \ingroup ITKLabelMap
+ */
+template <typename TInputImage, typename TOutputImage>
+class ITK_TEMPLATE_EXPORT FlatLabelMapToLabelImageFilter : public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(FlatLabelMapToLabelImageFilter);
+
+  /** Standard class type aliases. */
+  using Self = FlatLabelMapToLabelImageFilter;
+  using Superclass = ImageToImageFilter<TInputImage, TOutputImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Some convenient type alias. */
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputImagePointer = typename InputImageType::Pointer;
+  using InputImageConstPointer = typename InputImageType::ConstPointer;
+  using InputImageRegionType = typename InputImageType::RegionType;
+  using InputImagePixelType = typename InputImageType::PixelType;
+  using OutputImagePointer = typename OutputImageType::Pointer;
+  using OutputImageConstPointer = typename OutputImageType::ConstPointer;
+  using OutputImageRegionType = typename OutputImageType::RegionType;
+  using OutputImagePixelType = typename OutputImageType::PixelType;
+
+  /** ImageDimension constants */
+  static constexpr unsigned int InputImageDimension = TInputImage::ImageDimension;
+  static constexpr unsigned int OutputImageDimension = TOutputImage::ImageDimension;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(FlatLabelMapToLabelImageFilter);
+
+  itkConceptMacro(SameDimensionCheck, (Concept::SameDimension<InputImageDimension, OutputImageDimension>));
+
+protected:
+  FlatLabelMapToLabelImageFilter() = default;
+  ~FlatLabelMapToLabelImageFilter() override = default;
+
+  /** FlatLabelMapToLabelImageFilter needs the entire input. */
+  void
+  GenerateInputRequestedRegion() override;
+
+  /** FlatLabelMapToLabelImageFilter will produce the entire output. */
+  void
+  EnlargeOutputRequestedRegion(DataObject * itkNotUsed(output)) override;
+
+  void
+  GenerateData() override;
+}; // end of class
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkFlatLabelMapToLabelImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFlatLabelMapToLabelImageFilter_hxx
+#define itkFlatLabelMapToLabelImageFilter_hxx
+
+#include <algorithm>
+
+namespace itk
+{
+
+template <typename TInputImage, typename TOutputImage>
+void
+FlatLabelMapToLabelImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+
+  // We need all the input.
+  const InputImagePointer input = const_cast<InputImageType *>(this->GetInput());
+  if (!input)
+  {
+    return;
+  }
+  input->SetRequestedRegion(input->GetLargestPossibleRegion());
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+FlatLabelMapToLabelImageFilter<TInputImage, TOutputImage>::EnlargeOutputRequestedRegion(DataObject *)
+{
+  this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+FlatLabelMapToLabelImageFilter<TInputImage, TOutputImage>::GenerateData()
+{
+  this->AllocateOutputs();
+
+  const InputImageType * input = this->GetInput();
+  OutputImageType *      output = this->GetOutput();
+  output->FillBuffer(static_cast<OutputImagePixelType>(input->GetBackgroundValue()));
+
+  // As in LabelMapToLabelImageFilter, each object is painted on its own
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  input->ParallelizeLabelObjects(multiThreader, [input, output](SizeValueType position) {
+    const auto label = static_cast<OutputImagePixelType>(input->GetLabel(position));
+    for (SizeValueType line = input->GetFirstLine(position); line < input->GetEndLine(position); ++line)
+    {
+      OutputImagePixelType * first = output->GetBufferPointer() + output->ComputeOffset(input->GetLineIndex(line));
+      std::fill_n(first, input->GetLineLength(line), label);
+    }
+  });
+}
+
+} // end namespace itk
+
+#endif
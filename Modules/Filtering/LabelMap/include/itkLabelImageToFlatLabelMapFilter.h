@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelImageToFlatLabelMapFilter_h
+#define itkLabelImageToFlatLabelMapFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkFlatLabelMap.h"
+#include "itkLabelImageRunSlab.h"
+#include "itkLabelObject.h"
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class LabelImageToFlatLabelMapFilter
+ * \brief Convert a labeled image to a FlatLabelMap.
+ *
+ * LabelImageToFlatLabelMapFilter converts a label image to a FlatLabelMap,
+ * as LabelImageToLabelMapFilter does to a LabelMap. The labels are the same
+ * in the input and the output image.
+ *
+ * The lines of the image are encoded concurrently by the work units, each on
+ * a slab of the image, and are then sorted by label into the arrays of the
+ * output, concurrently as well. The lines of each object are in raster
+ * order, whatever the number of work units.
+ *
+ * \sa FlatLabelMap, LabelImageToLabelMapFilter, FlatLabelMapToLabelImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ * \ingroup ITKLabelMap
+ */
+template <typename TInputImage,
+          typename TOutputImage =
+            FlatLabelMap<LabelObject<typename TInputImage::PixelType, TInputImage::ImageDimension>>>
+class ITK_TEMPLATE_EXPORT LabelImageToFlatLabelMapFilter : public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(LabelImageToFlatLabelMapFilter);
+
+  /** Standard class type aliases. */
+  using Self = LabelImageToFlatLabelMapFilter;
+  using Superclass = ImageToImageFilter<TInputImage, TOutputImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Some convenient type alias. */
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputImagePointer = typename InputImageType::Pointer;
+  using InputImageConstPointer = typename InputImageType::ConstPointer;
+  using InputImageRegionType = typename InputImageType::RegionType;
+  using InputImagePixelType = typename InputImageType::PixelType;
+  using IndexType = typename InputImageType::IndexType;
+  using OutputImagePointer = typename OutputImageType::Pointer;
+  using OutputImageConstPointer = typename OutputImageType::ConstPointer;
+  using OutputImageRegionType = typename OutputImageType::RegionType;
+  using OutputImagePixelType = typename OutputImageType::PixelType;
+  using LengthType = typename OutputImageType::LengthType;
+
+  /** ImageDimension constants */
+  static constexpr unsigned int InputImageDimension = TInputImage::ImageDimension;
+  static constexpr unsigned int OutputImageDimension = TOutputImage::ImageDimension;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(LabelImageToFlatLabelMapFilter);
+
+  /**
+   * Set/Get the value used as "background" in the output image.
+   * Defaults to NumericTraits<PixelType>::NonpositiveMin().
+   */
+  /** @ITKStartGrouping */
+  itkSetMacro(BackgroundValue, OutputImagePixelType);
+  itkGetConstMacro(BackgroundValue, OutputImagePixelType);
+  /** @ITKEndGrouping */
+
+  itkConceptMacro(SameDimensionCheck, (Concept::SameDimension<InputImageDimension, OutputImageDimension>));
+
+protected:
+  LabelImageToFlatLabelMapFilter();
+  ~LabelImageToFlatLabelMapFilter() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** LabelImageToFlatLabelMapFilter needs the entire input be
+   * available. Thus, it needs to provide an implementation of
+   * GenerateInputRequestedRegion(). */
+  void
+  GenerateInputRequestedRegion() override;
+
+  /** LabelImageToFlatLabelMapFilter will produce the entire output. */
+  void
+  EnlargeOutputRequestedRegion(DataObject * itkNotUsed(output)) override;
+
+  void
+  GenerateData() override;
+
+private:
+  /** The lines of a slab of the image, in raster order, and their labels,
+   * sorted by label. */
+  using SlabType = LabelImageRunSlab<InputImageType, OutputImagePixelType>;
+  using LabelAndLineType = typename SlabType::LabelAndRunType;
+
+  /** The lines of a slab that belong to one object. */
+  struct Group
+  {
+    SizeValueType position;
+    SizeValueType numberOfLines;
+    SizeValueType firstLine;
+  };
+
+  OutputImagePixelType m_BackgroundValue{};
+}; // end of class
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkLabelImageToFlatLabelMapFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,169 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelImageToFlatLabelMapFilter_hxx
+#define itkLabelImageToFlatLabelMapFilter_hxx
+
+#include "itkNumericTraits.h"
+#include "itkPrintHelper.h"
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace itk
+{
+template <typename TInputImage, typename TOutputImage>
+LabelImageToFlatLabelMapFilter<TInputImage, TOutputImage>::LabelImageToFlatLabelMapFilter()
+  : m_BackgroundValue(NumericTraits<OutputImagePixelType>::NonpositiveMin())
+{}
+
+template <typename TInputImage, typename TOutputImage>
+void
+LabelImageToFlatLabelMapFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+
+  // We need all the input.
+  const InputImagePointer input = const_cast<InputImageType *>(this->GetInput());
+  if (!input)
+  {
+    return;
+  }
+  input->SetRequestedRegion(input->GetLargestPossibleRegion());
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+LabelImageToFlatLabelMapFilter<TInputImage, TOutputImage>::EnlargeOutputRequestedRegion(DataObject *)
+{
+  this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+LabelImageToFlatLabelMapFilter<TInputImage, TOutputImage>::GenerateData()
+{
+  this->AllocateOutputs();
+
+  OutputImageType * output = this->GetOutput();
+  output->SetBackgroundValue(m_BackgroundValue);
+
+  const OutputImageRegionType    region = output->GetRequestedRegion();
+  const ImageRegionSplitterBase * splitter = this->GetImageRegionSplitter();
+  const unsigned int              numberOfSlabs = splitter->GetNumberOfSplits(region, this->GetNumberOfWorkUnits());
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  // Encode the slabs, whose lines are in raster order from one slab to the
+  // next
+  const InputImageType *    input = this->GetInput();
+  const InputImagePixelType background = static_cast<InputImagePixelType>(m_BackgroundValue);
+  std::vector<SlabType>     slabs(numberOfSlabs);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfSlabs,
+    [splitter, numberOfSlabs, input, background, &region, &slabs](SizeValueType slab) {
+      InputImageRegionType slabRegion = region;
+      splitter->GetSplit(slab, numberOfSlabs, slabRegion);
+      slabs[slab].Encode(input, slabRegion, background);
+    },
+    this);
+
+  // The labels of the objects are those of all the slabs
+  std::vector<OutputImagePixelType> labels = SlabType::MergeLabels(slabs);
+
+  // Each slab has a group of lines for some of the objects: find the object
+  // of each group
+  std::vector<std::vector<Group>> groups(numberOfSlabs);
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfSlabs,
+    [&labels, &slabs, &groups](SizeValueType slabNumber) {
+      const SlabType & slab = slabs[slabNumber];
+      auto             labelIt = labels.begin();
+      for (auto it = slab.m_Labels.begin(); it != slab.m_Labels.end();)
+      {
+        const auto groupEnd = std::find_if(it, slab.m_Labels.end(), [it](const LabelAndLineType & labelAndLine) {
+          return labelAndLine.first != it->first;
+        });
+        labelIt = std::lower_bound(labelIt, labels.end(), it->first);
+        groups[slabNumber].push_back(Group{ static_cast<SizeValueType>(labelIt - labels.begin()),
+                                            static_cast<SizeValueType>(groupEnd - it),
+                                            0 });
+        it = groupEnd;
+      }
+    },
+    nullptr);
+
+  // The lines of an object come from the slabs in order
+  typename OutputImageType::LineOffsetVectorType lineOffsets(labels.size() + 1, 0);
+  for (const std::vector<Group> & slabGroups : groups)
+  {
+    for (const Group & group : slabGroups)
+    {
+      lineOffsets[group.position + 1] += group.numberOfLines;
+    }
+  }
+  std::partial_sum(lineOffsets.begin(), lineOffsets.end(), lineOffsets.begin());
+  {
+    std::vector<SizeValueType> nextLines(lineOffsets.begin(), lineOffsets.end() - 1);
+    for (std::vector<Group> & slabGroups : groups)
+    {
+      for (Group & group : slabGroups)
+      {
+        group.firstLine = nextLines[group.position];
+        nextLines[group.position] += group.numberOfLines;
+      }
+    }
+  }
+
+  typename OutputImageType::IndexVectorType  lineIndexes(lineOffsets.back());
+  typename OutputImageType::LengthVectorType lineLengths(lineOffsets.back());
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfSlabs,
+    [input, &slabs, &groups, &lineIndexes, &lineLengths](SizeValueType slabNumber) {
+      SlabType & slab = slabs[slabNumber];
+      auto       it = slab.m_Labels.begin();
+      for (const Group & group : groups[slabNumber])
+      {
+        for (SizeValueType line = group.firstLine; line < group.firstLine + group.numberOfLines; ++line, ++it)
+        {
+          const typename SlabType::RunType & run = slab.m_Runs[it->second];
+          lineIndexes[line] = input->ComputeIndex(run.m_Offset);
+          lineLengths[line] = static_cast<LengthType>(run.m_Length);
+        }
+      }
+      slab = SlabType();
+    },
+    nullptr);
+
+  output->SetLines(std::move(labels), std::move(lineOffsets), std::move(lineIndexes), std::move(lineLengths));
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+LabelImageToFlatLabelMapFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  print_helper::PrintNumericTrait(os, indent, "BackgroundValue", m_BackgroundValue);
+}
+} // end namespace itk
+#endif
@@ -21,6 +21,7 @@
 #include "itkImageToImageFilter.h"
 #include "itkLabelMap.h"
 #include "itkLabelObject.h"
+#include "itkLabelImageSpatialIndex.h"
 
 namespace itk
 {
@@ -31,6 +32,10 @@ namespace itk
  * LabelImageToLabelMapFilter converts a label image to a label collection image.
  * The labels are the same in the input and the output image.
  *
+ * When a LabelImageSpatialIndex of the input is set, the lines of the label
+ * objects are those of the runs of the index, and the input is not scanned
+ * again as long as the index is up to date.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
  * This implementation was taken from the Insight Journal paper:
@@ -91,6 +96,17 @@ public:
   itkSetMacro(BackgroundValue, OutputImagePixelType);
   itkGetConstMacro(BackgroundValue, OutputImagePixelType);
   /** @ITKEndGrouping */
+  /** Type of the index of the labels of the input. */
+  using LabelIndexType = LabelImageSpatialIndex<TInputImage>;
+
+  /** Index of the labels of the input, from which the label objects are
+   * built. It is updated by the filter, and is ignored when it indexes
+   * another image. */
+  /** @ITKStartGrouping */
+  itkSetObjectMacro(LabelIndex, LabelIndexType);
+  itkGetModifiableObjectMacro(LabelIndex, LabelIndexType);
+  /** @ITKEndGrouping */
+
   itkConceptMacro(SameDimensionCheck, (Concept::SameDimension<InputImageDimension, OutputImageDimension>));
 
 protected:
@@ -109,6 +125,11 @@ protected:
   void
   EnlargeOutputRequestedRegion(DataObject * itkNotUsed(output)) override;
 
+  /** Build the label objects from the runs of the label index, when it
+   * indexes the input, or by scanning the input otherwise. */
+  void
+  GenerateData() override;
+
   void
   BeforeThreadedGenerateData() override;
 
@@ -127,6 +148,8 @@ protected:
 private:
   OutputImagePixelType m_BackgroundValue{};
 
+  typename LabelIndexType::Pointer m_LabelIndex{};
+
   typename std::vector<OutputImagePointer> m_TemporaryImages{};
 }; // end of class
 } // end namespace itk
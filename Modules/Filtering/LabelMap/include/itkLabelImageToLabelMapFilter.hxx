@@ -55,6 +55,55 @@ LabelImageToLabelMapFilter<TInputImage, TOutputImage>::EnlargeOutputRequestedReg
   this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
 }
 
+template <typename TInputImage, typename TOutputImage>
+void
+LabelImageToLabelMapFilter<TInputImage, TOutputImage>::GenerateData()
+{
+  const InputImageType * input = this->GetInput();
+  if (m_LabelIndex == nullptr || m_LabelIndex->GetImage() != input)
+  {
+    Superclass::GenerateData();
+    return;
+  }
+
+  this->AllocateOutputs();
+  m_LabelIndex->Update();
+
+  OutputImageType * output = this->GetOutput();
+  output->SetBackgroundValue(m_BackgroundValue);
+
+  // Build the objects concurrently, and add them to the output in order
+  const auto & labels = m_LabelIndex->GetLabels();
+  std::vector<typename LabelObjectType::Pointer> labelObjects(labels.size());
+  MultiThreaderBase *                            multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  multiThreader->ParallelizeArray(
+    0,
+    labels.size(),
+    [this, &labels, &labelObjects](SizeValueType i) {
+      if (labels[i] == static_cast<InputImagePixelType>(m_BackgroundValue))
+      {
+        return;
+      }
+      auto labelObject = LabelObjectType::New();
+      labelObject->SetLabel(static_cast<OutputImagePixelType>(labels[i]));
+      for (const typename LabelIndexType::RunType & run : m_LabelIndex->GetRuns(labels[i]))
+      {
+        labelObject->AddLine(m_LabelIndex->ComputeIndex(run), static_cast<LengthType>(run.m_Length));
+      }
+      labelObjects[i] = labelObject;
+    },
+    this);
+
+  for (LabelObjectType * labelObject : labelObjects)
+  {
+    if (labelObject != nullptr)
+    {
+      output->AddLabelObject(labelObject);
+    }
+  }
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 LabelImageToLabelMapFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
@@ -167,6 +216,7 @@ LabelImageToLabelMapFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream &
   Superclass::PrintSelf(os, indent);
 
   print_helper::PrintNumericTrait(os, indent, "BackgroundValue", m_BackgroundValue);
+  itkPrintSelfObjectMacro(LabelIndex);
 }
 } // end namespace itk
 #endif
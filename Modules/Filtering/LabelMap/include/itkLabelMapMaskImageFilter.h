@@ -191,6 +191,12 @@ protected:
   PrintSelf(std::ostream & os, Indent indent) const override;
 
 private:
+  /** Copy the feature image to the output along the lines of the label
+   * object, or fill them with the background value, a line at a time.
+   * The lines are cropped to the requested region of the output. */
+  void
+  MaskLines(const LabelObjectType * labelObject, bool copyFeature);
+
   InputImagePixelType  m_Label{};
   OutputImagePixelType m_BackgroundValue{};
   bool                 m_Negated{ false };
@@ -24,6 +24,7 @@
 #include "itkImageRegionIterator.h"
 #include "itkImageAlgorithm.h"
 #include "itkPrintHelper.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -259,39 +260,9 @@ LabelMapMaskImageFilter<TInputImage, TOutputImage>::GenerateData()
   }
   else
   {
-    const LabelObjectType * labelObject = this->GetLabelMap()->GetLabelObject(m_Label);
-    const OutputImageType * input2 = this->GetFeatureImage();
-    OutputImageType *       output = this->GetOutput();
-
-    if (!m_Negated)
-    {
-      typename LabelObjectType::ConstIndexIterator it(labelObject);
-      while (!it.IsAtEnd())
-      {
-        const IndexType & idx = it.GetIndex();
-        output->SetPixel(idx, input2->GetPixel(idx));
-        ++it;
-      }
-    }
-    else
-    {
-      // And mark the label object as background
-
-      // Should we take care to not write outside the image ?
-      const bool       testIdxIsInside = m_Crop && (inImage->GetBackgroundValue() == m_Label) ^ m_Negated;
-      const RegionType outputRegion = output->GetLargestPossibleRegion();
-
-      typename LabelObjectType::ConstIndexIterator it(labelObject);
-      while (!it.IsAtEnd())
-      {
-        const IndexType & idx = it.GetIndex();
-        if (!testIdxIsInside || outputRegion.IsInside(idx))
-        {
-          output->SetPixel(idx, m_BackgroundValue);
-        }
-        ++it;
-      }
-    }
+    // Copy the feature image where the label object is, or mark the label
+    // object as background
+    this->MaskLines(this->GetLabelMap()->GetLabelObject(m_Label), !m_Negated);
   }
 
   this->UpdateProgress(0.99f);
@@ -332,45 +303,47 @@ LabelMapMaskImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
 template <typename TInputImage, typename TOutputImage>
 void
 LabelMapMaskImageFilter<TInputImage, TOutputImage>::ThreadedProcessLabelObject(LabelObjectType * labelObject)
+{
+  // With Negated = false, the user wants the mask to be the background of the
+  // label collection image: the pixels of the label objects are set to the
+  // background value. Otherwise, the pixels from the feature image are kept
+  // where the label objects are.
+  this->MaskLines(labelObject, m_Negated);
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+LabelMapMaskImageFilter<TInputImage, TOutputImage>::MaskLines(const LabelObjectType * labelObject, bool copyFeature)
 {
   OutputImageType *       output = this->GetOutput();
-  auto *                  input = const_cast<InputImageType *>(this->GetInput());
   const OutputImageType * input2 = this->GetFeatureImage();
+  const RegionType        outputRegion = output->GetRequestedRegion();
+  const OffsetValueType   regionBegin = outputRegion.GetIndex(0);
+  const OffsetValueType   regionEnd = regionBegin + static_cast<OffsetValueType>(outputRegion.GetSize(0));
 
-  if (!m_Negated)
-  {
-    // Keep the values from the feature image if the same pixel in the label image
-    // equals the label given by the user. The other pixels are set to the background value.
-
-    // Should we take care to not write outside the image ?
-    const bool       testIdxIsInside = m_Crop && (input->GetBackgroundValue() == m_Label) ^ m_Negated;
-    const RegionType outputRegion = output->GetLargestPossibleRegion();
+  OutputImagePixelType *       outputBuffer = output->GetBufferPointer();
+  const OutputImagePixelType * featureBuffer = input2->GetBufferPointer();
 
-    // The user wants the mask to be the background of the label collection image
-    typename LabelObjectType::ConstIndexIterator it(labelObject);
-    while (!it.IsAtEnd())
+  for (typename LabelObjectType::ConstLineIterator lit(labelObject); !lit.IsAtEnd(); ++lit)
+  {
+    IndexType             idx = lit.GetLine().GetIndex();
+    const OffsetValueType lineEnd =
+      std::min(idx[0] + static_cast<OffsetValueType>(lit.GetLine().GetLength()), regionEnd);
+    idx[0] = std::max(idx[0], regionBegin);
+    if (idx[0] >= lineEnd || !outputRegion.IsInside(idx))
     {
-      const IndexType & idx = it.GetIndex();
-      if (!testIdxIsInside || outputRegion.IsInside(idx))
-      {
-        output->SetPixel(idx, m_BackgroundValue);
-      }
-      ++it;
+      continue;
     }
-  }
-  else
-  {
-    // Keep the pixels from the feature image if the same pixel from the label image
-    // is not equal to the label provided by the user. The pixels with the label provided by the
-    // user are set to the background value
 
-    // And copy the feature image where the label objects are
-    typename LabelObjectType::ConstIndexIterator it(labelObject);
-    while (!it.IsAtEnd())
+    const auto             length = static_cast<SizeValueType>(lineEnd - idx[0]);
+    OutputImagePixelType * outputLine = outputBuffer + output->ComputeOffset(idx);
+    if (copyFeature)
+    {
+      std::copy_n(featureBuffer + input2->ComputeOffset(idx), length, outputLine);
+    }
+    else
     {
-      const IndexType & idx = it.GetIndex();
-      output->SetPixel(idx, input2->GetPixel(idx));
-      ++it;
+      std::fill_n(outputLine, length, m_BackgroundValue);
     }
   }
 }
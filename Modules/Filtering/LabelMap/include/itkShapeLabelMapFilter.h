@@ -20,6 +20,7 @@
 
 #include "itkInPlaceLabelMapFilter.h"
 #include "itkLexicographicCompare.h"
+#include <vector>
 
 namespace itk
 {
@@ -30,15 +31,16 @@ namespace itk
  * ShapeLabelMapFilter can be used to set the attributes values of the
  * ShapeLabelObject in a LabelMap.
  *
- * ShapeLabelMapFilter takes an optional parameter, used only to
- * optimize the computation time and the memory usage when the
- * perimeter or the feret diameter is used: the exact copy of the
- * input LabelMap is stored in an Image.
- * It can be set with SetLabelImage(). It is cleared at the end of the
- * computation, so must be reset before running Update() again. It is
- * not part of the pipeline management design, to let the subclasses
- * of ShapeLabelMapFilter use the pipeline design to specify truly
- * required inputs.
+ * The label objects are processed concurrently by the work units of the
+ * filter. The feret diameter is computed from the vertices of the convex
+ * hull of each object, found plane by plane from the ends of its lines,
+ * so that it costs far less than comparing all the pixels of the border
+ * of the object with each other.
+ *
+ * ShapeLabelMapFilter used to take an optional label image, the exact
+ * copy of the input LabelMap, to compute the feret diameter. It is not
+ * needed anymore: SetLabelImage() is kept for backward compatibility,
+ * and the image it sets is ignored.
  *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
@@ -123,7 +125,8 @@ public:
   itkGetConstReferenceMacro(ComputeOrientedBoundingBox, bool);
   itkBooleanMacro(ComputeOrientedBoundingBox);
   /** @ITKEndGrouping */
-  /** Set the label image */
+  /** Set the label image. It is ignored: the shape attributes are all
+   * computed from the lines of the label objects. */
   void
   SetLabelImage(const TLabelImage * input)
   {
@@ -137,9 +140,6 @@ protected:
   void
   ThreadedProcessLabelObject(LabelObjectType * labelObject) override;
 
-  void
-  BeforeThreadedGenerateData() override;
-
   void
   AfterThreadedGenerateData() override;
 
@@ -159,6 +159,22 @@ private:
   void
   ComputeOrientedBoundingBox(LabelObjectType * labelObject);
 
+  /** Cross product, in dimensions \c a and \c b, of the vectors from
+   * \c origin1 to \c end1 and from \c origin2 to \c end2. */
+  static OffsetValueType
+  Cross(const IndexType & origin1,
+        const IndexType & end1,
+        const IndexType & origin2,
+        const IndexType & end2,
+        unsigned int      a,
+        unsigned int      b);
+
+  /** Keep only the points that are vertices of the convex hull, in
+   * dimensions \c a and \c b, of the points in the same plane. The vertices
+   * of a plane are counter clockwise. */
+  static void
+  KeepPlaneHullVertices(std::vector<IndexType> & points, unsigned int a, unsigned int b);
+
   using Offset2Type = itk::Offset<2>;
   using Offset3Type = itk::Offset<3>;
   using Spacing2Type = itk::Vector<double, 2>;
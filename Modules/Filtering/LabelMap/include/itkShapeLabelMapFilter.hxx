@@ -29,34 +29,12 @@
 #include "vnl/algo/vnl_symmetric_eigensystem.h"
 #include "itkMath.h"
 #include "itkLexicographicCompare.h"
+#include <algorithm>
 #include <deque>
 #include <map>
 
 namespace itk
 {
-template <typename TImage, typename TLabelImage>
-void
-ShapeLabelMapFilter<TImage, TLabelImage>::BeforeThreadedGenerateData()
-{
-  Superclass::BeforeThreadedGenerateData();
-
-  // Generate the label image, if needed
-  if (m_ComputeFeretDiameter)
-  {
-    if (!m_LabelImage)
-    {
-      // generate an image of the labelized image
-      using LCI2IType = LabelMapToLabelImageFilter<TImage, LabelImageType>;
-      auto lci2i = LCI2IType::New();
-      lci2i->SetInput(this->GetOutput());
-      // Respect the number of threads of the filter
-      lci2i->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
-      lci2i->Update();
-      m_LabelImage = lci2i->GetOutput();
-    }
-  }
-}
-
 template <typename TImage, typename TLabelImage>
 void
 ShapeLabelMapFilter<TImage, TLabelImage>::ThreadedProcessLabelObject(LabelObjectType * labelObject)
@@ -416,65 +394,72 @@ template <typename TImage, typename TLabelImage>
 void
 ShapeLabelMapFilter<TImage, TLabelImage>::ComputeFeretDiameter(LabelObjectType * labelObject)
 {
-  const LabelPixelType & label = labelObject->GetLabel();
-
-  using IndexListType = typename std::deque<IndexType>;
-  IndexListType idxList;
+  const typename ImageType::SpacingType & spacing = this->GetOutput()->GetSpacing();
 
-  using NeighborIteratorType = typename itk::ConstNeighborhoodIterator<LabelImageType>;
-  auto                                      neighborHoodRadius = SizeType::Filled(1);
-  NeighborIteratorType                      it(neighborHoodRadius, m_LabelImage, m_LabelImage->GetBufferedRegion());
-  ConstantBoundaryCondition<LabelImageType> lcbc;
-  // Use label + 1 to have a label different of the current label on the border
-  lcbc.SetConstant(label + 1);
-  it.OverrideBoundaryCondition(&lcbc);
-  it.GoToBegin();
-
-  using NeighborIndexType = typename NeighborIteratorType::NeighborIndexType;
-
-  // Iterate over all the indexes
-  typename LabelObjectType::ConstIndexIterator iit(labelObject);
-  while (!iit.IsAtEnd())
+  const auto squaredLength = [&spacing](const IndexType & index1, const IndexType & index2) {
+    double length = 0;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      const OffsetValueType indexDifference = index1[i] - index2[i];
+      length += Math::sqr(indexDifference * spacing[i]);
+    }
+    return length;
+  };
+
+  // The two farthest pixels of the object are vertices of its convex hull,
+  // and the vertices of the convex hull are ends of the lines
+  std::vector<IndexType> points;
+  points.reserve(2 * labelObject->GetNumberOfLines());
+  for (typename LabelObjectType::ConstLineIterator lit(labelObject); !lit.IsAtEnd(); ++lit)
   {
-    // Move the iterator to the new location
-    it += iit.GetIndex() - it.GetIndex();
-
-    // Push the pixel in the list if it is on the border of the object
-    for (NeighborIndexType i = 0; i < it.Size(); ++i)
+    IndexType idx = lit.GetLine().GetIndex();
+    points.push_back(idx);
+    if (lit.GetLine().GetLength() > 1)
     {
-      if (it.GetPixel(i) != label)
-      {
-        idxList.push_back(iit.GetIndex());
-        break;
-      }
+      idx[0] += lit.GetLine().GetLength() - 1;
+      points.push_back(idx);
     }
-    ++iit;
   }
 
-  ImageType * output = this->GetOutput();
-
-  const typename ImageType::SpacingType & spacing = output->GetSpacing();
+  // A vertex of the convex hull is a vertex of the convex hull of the points
+  // of any plane of two dimensions that it is in
+  for (unsigned int a = 0; a < ImageDimension; ++a)
+  {
+    for (unsigned int b = a + 1; b < ImageDimension; ++b)
+    {
+      KeepPlaneHullVertices(points, a, b);
+    }
+  }
 
-  // We can now search the feret diameter
-  double feretDiameter = 0;
-  for (auto iIt1 = idxList.begin(); iIt1 != idxList.end(); ++iIt1)
+  double              feretDiameter = 0;
+  const SizeValueType numberOfPoints = points.size();
+  if (ImageDimension == 2 && numberOfPoints > 2)
   {
-    auto iIt2 = iIt1;
-    for (iIt2++; iIt2 != idxList.end(); ++iIt2)
+    // Rotating calipers: the farthest pairs of vertices are among the pairs
+    // of vertices that the sides of the polygon reach on the opposite side
+    SizeValueType j = 1;
+    for (SizeValueType i = 0; i < numberOfPoints; ++i)
     {
-      // Compute the length between the 2 indexes
-      double length = 0;
-      for (unsigned int i = 0; i < ImageDimension; ++i)
+      const SizeValueType nextI = (i + 1) % numberOfPoints;
+      while (Cross(points[i], points[nextI], points[j], points[(j + 1) % numberOfPoints], 0, 1) > 0)
       {
-        const OffsetValueType indexDifference = (iIt1->operator[](i) - iIt2->operator[](i));
-        length += Math::sqr(indexDifference * spacing[i]);
+        j = (j + 1) % numberOfPoints;
       }
-      if (feretDiameter < length)
+      feretDiameter =
+        std::max({ feretDiameter, squaredLength(points[i], points[j]), squaredLength(points[nextI], points[j]) });
+    }
+  }
+  else
+  {
+    for (SizeValueType i = 0; i < numberOfPoints; ++i)
+    {
+      for (SizeValueType j = i + 1; j < numberOfPoints; ++j)
       {
-        feretDiameter = length;
+        feretDiameter = std::max(feretDiameter, squaredLength(points[i], points[j]));
       }
     }
   }
+
   // Final computation
   feretDiameter = std::sqrt(feretDiameter);
 
@@ -482,6 +467,91 @@ ShapeLabelMapFilter<TImage, TLabelImage>::ComputeFeretDiameter(LabelObjectType *
   labelObject->SetFeretDiameter(feretDiameter);
 }
 
+template <typename TImage, typename TLabelImage>
+OffsetValueType
+ShapeLabelMapFilter<TImage, TLabelImage>::Cross(const IndexType & origin1,
+                                                const IndexType & end1,
+                                                const IndexType & origin2,
+                                                const IndexType & end2,
+                                                unsigned int      a,
+                                                unsigned int      b)
+{
+  return (end1[a] - origin1[a]) * (end2[b] - origin2[b]) - (end1[b] - origin1[b]) * (end2[a] - origin2[a]);
+}
+
+template <typename TImage, typename TLabelImage>
+void
+ShapeLabelMapFilter<TImage, TLabelImage>::KeepPlaneHullVertices(std::vector<IndexType> & points,
+                                                                unsigned int             a,
+                                                                unsigned int             b)
+{
+  // Sort the points by plane, then along a and b
+  std::sort(points.begin(), points.end(), [a, b](const IndexType & index1, const IndexType & index2) {
+    for (unsigned int i = ImageDimension; i-- > 0;)
+    {
+      if (i != a && i != b && index1[i] != index2[i])
+      {
+        return index1[i] < index2[i];
+      }
+    }
+    return index1[a] < index2[a] || (index1[a] == index2[a] && index1[b] < index2[b]);
+  });
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+
+  const auto samePlane = [a, b](const IndexType & index1, const IndexType & index2) {
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      if (i != a && i != b && index1[i] != index2[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Monotone chain: the lower and then the upper hull of each plane, counter
+  // clockwise and without the points in the middle of the sides
+  std::vector<IndexType> vertices;
+  vertices.reserve(points.size());
+  for (auto first = points.begin(); first != points.end();)
+  {
+    const auto last = std::find_if(
+      first, points.end(), [&first, &samePlane](const IndexType & index) { return !samePlane(*first, index); });
+    if (last - first <= 2)
+    {
+      vertices.insert(vertices.end(), first, last);
+      first = last;
+      continue;
+    }
+
+    const SizeValueType planeBegin = vertices.size();
+    for (auto it = first; it != last; ++it)
+    {
+      while (vertices.size() >= planeBegin + 2 &&
+             Cross(vertices[vertices.size() - 2], vertices.back(), vertices[vertices.size() - 2], *it, a, b) <= 0)
+      {
+        vertices.pop_back();
+      }
+      vertices.push_back(*it);
+    }
+    const SizeValueType upperBegin = vertices.size() + 1;
+    for (auto it = last - 1; it != first; --it)
+    {
+      const IndexType & point = *(it - 1);
+      while (vertices.size() >= upperBegin &&
+             Cross(vertices[vertices.size() - 2], vertices.back(), vertices[vertices.size() - 2], point, a, b) <= 0)
+      {
+        vertices.pop_back();
+      }
+      vertices.push_back(point);
+    }
+    // The first point closes the upper hull
+    vertices.pop_back();
+    first = last;
+  }
+  points.swap(vertices);
+}
+
 template <typename TImage, typename TLabelImage>
 void
 ShapeLabelMapFilter<TImage, TLabelImage>::ComputePerimeter(LabelObjectType * labelObject)
@@ -772,48 +842,40 @@ ShapeLabelMapFilter<TImage, TLabelImage>::ComputeOrientedBoundingBox(LabelObject
   const typename LabelObjectType::CentroidType centroid = labelObject->GetCentroid();
   const unsigned int                           numLines = labelObject->GetNumberOfLines();
 
-  // Create a matrix where the columns are the physical points of the
-  // start and end of each RLE line from the label map, relative to
-  // the centroid
-  VNLMatrixType pixelLocations(ImageDimension, labelObject->GetNumberOfLines() * 2);
+  // Project the physical points of the start and end of each RLE line
+  // from the label map, relative to the centroid, onto the principal axes,
+  // and find the bounds in the projected domain
+  assert(numLines != 0);
+  VNLVectorType minimumPrincipalAxis(ImageDimension, NumericTraits<double>::max());
+  VNLVectorType maximumPrincipalAxis(ImageDimension, NumericTraits<double>::NonpositiveMin());
+  VNLVectorType pixelLocation(ImageDimension);
   for (unsigned int l = 0; l < numLines; ++l)
   {
-    const typename LabelObjectType::LineType line = labelObject->GetLine(l);
+    const typename LabelObjectType::LineType & line = labelObject->GetLine(l);
 
-    // add start index of line as physical point relative to centroid
-    IndexType                     idx = line.GetIndex();
-    typename ImageType::PointType pt;
-    output->TransformIndexToPhysicalPoint(idx, pt);
-    for (unsigned int j = 0; j < ImageDimension; ++j)
+    IndexType idx = line.GetIndex();
+    for (unsigned int end = 0; end < 2; ++end)
     {
-      pixelLocations(j, l * 2) = pt[j] - centroid[j];
-    }
-
-    // add end index of line as physical point relative to centroid
-    idx[0] += line.GetLength() - 1;
-    output->TransformIndexToPhysicalPoint(idx, pt);
-    for (unsigned int j = 0; j < ImageDimension; ++j)
-    {
-      pixelLocations(j, l * 2 + 1) = pt[j] - centroid[j];
-    }
-  }
-
-
-  // Project the physical points onto principal axes
-  VNLMatrixType transformedPixelLocations = principalAxesBasisMatrix * pixelLocations;
-
-  // find the bounds in the projected domain
-  assert(transformedPixelLocations.columns() != 0);
-  VNLVectorType minimumPrincipalAxis = transformedPixelLocations.get_column(0);
-  VNLVectorType maximumPrincipalAxis = transformedPixelLocations.get_column(0);
-
-  for (unsigned int column = 1; column < transformedPixelLocations.columns(); ++column)
-  {
-    for (unsigned int i = 0; i < ImageDimension; ++i)
-    {
-      const double value = transformedPixelLocations(i, column);
-      minimumPrincipalAxis[i] = std::min(minimumPrincipalAxis[i], value);
-      maximumPrincipalAxis[i] = std::max(maximumPrincipalAxis[i], value);
+      if (end == 1)
+      {
+        idx[0] += line.GetLength() - 1;
+      }
+      typename ImageType::PointType pt;
+      output->TransformIndexToPhysicalPoint(idx, pt);
+      for (unsigned int j = 0; j < ImageDimension; ++j)
+      {
+        pixelLocation[j] = pt[j] - centroid[j];
+      }
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+      {
+        double value = 0.0;
+        for (unsigned int j = 0; j < ImageDimension; ++j)
+        {
+          value += principalAxesBasisMatrix(i, j) * pixelLocation[j];
+        }
+        minimumPrincipalAxis[i] = std::min(minimumPrincipalAxis[i], value);
+        maximumPrincipalAxis[i] = std::max(maximumPrincipalAxis[i], value);
+      }
     }
   }
 
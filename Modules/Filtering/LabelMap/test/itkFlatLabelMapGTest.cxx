@@ -0,0 +1,231 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGTest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkFlatLabelMap.h"
+#include "itkFlatLabelMapShapeCalculator.h"
+#include "itkFlatLabelMapToLabelImageFilter.h"
+#include "itkLabelImageToFlatLabelMapFilter.h"
+#include "itkLabelImageToLabelMapFilter.h"
+#include "itkLabelMapToLabelImageFilter.h"
+#include "itkPlatformMultiThreader.h"
+#include "itkShapeLabelMapFilter.h"
+#include "itkShapeLabelObject.h"
+#include <algorithm>
+#include <atomic>
+
+
+namespace
+{
+using LabelImageType = itk::Image<unsigned short, 3>;
+using LabelObjectType = itk::LabelObject<unsigned short, 3>;
+using LabelMapType = itk::LabelMap<LabelObjectType>;
+using FlatLabelMapType = itk::FlatLabelMap<LabelObjectType>;
+
+// Many small objects, most of them split over several lines and slabs.
+LabelImageType::Pointer
+CreateLabelImage()
+{
+  auto image = LabelImageType::New();
+  image->SetRegions(LabelImageType::RegionType(itk::MakeSize(37u, 29u, 23u)));
+  image->SetSpacing(itk::MakeVector(0.5, 1.0, 2.0));
+  image->Allocate();
+
+  unsigned int state = 2024;
+  for (itk::ImageRegionIteratorWithIndex<LabelImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    state = state * 1103515245u + 12345u;
+    const auto & index = it.GetIndex();
+    const auto   cell = static_cast<unsigned short>(1 + index[0] / 4 + 10 * (index[1] / 5) + 60 * (index[2] / 3));
+    it.Set(((state >> 16) % 7) == 0 ? 0 : cell);
+  }
+  return image;
+}
+
+bool
+SameImages(const LabelImageType * expected, const LabelImageType * actual)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<LabelImageType> it(expected, expected->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    if (actual->GetPixel(it.GetIndex()) != it.Get())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+TEST(FlatLabelMap, MatchesLabelMap)
+{
+  const auto image = CreateLabelImage();
+
+  auto labelMapFilter = itk::LabelImageToLabelMapFilter<LabelImageType, LabelMapType>::New();
+  labelMapFilter->SetInput(image);
+  labelMapFilter->SetBackgroundValue(0);
+  labelMapFilter->Update();
+  const LabelMapType * labelMap = labelMapFilter->GetOutput();
+
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 3, 16 })
+  {
+    auto flatFilter = itk::LabelImageToFlatLabelMapFilter<LabelImageType, FlatLabelMapType>::New();
+    flatFilter->SetInput(image);
+    flatFilter->SetBackgroundValue(0);
+    flatFilter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    flatFilter->Update();
+    const FlatLabelMapType * flatLabelMap = flatFilter->GetOutput();
+
+    EXPECT_EQ(flatLabelMap->GetBackgroundValue(), 0);
+    EXPECT_EQ(flatLabelMap->GetLargestPossibleRegion(), image->GetLargestPossibleRegion());
+    EXPECT_EQ(flatLabelMap->GetSpacing(), image->GetSpacing());
+    ASSERT_EQ(flatLabelMap->GetLabels(), labelMap->GetLabels());
+
+    // The lines of each object are in raster order
+    for (itk::SizeValueType position = 0; position < flatLabelMap->GetNumberOfLabelObjects(); ++position)
+    {
+      const LabelObjectType * labelObject = labelMap->GetNthLabelObject(position);
+      EXPECT_EQ(flatLabelMap->GetEndLine(position) - flatLabelMap->GetFirstLine(position),
+                labelObject->GetNumberOfLines());
+      EXPECT_EQ(flatLabelMap->GetNumberOfPixels(position), labelObject->Size());
+      const itk::SizeValueType endLine = flatLabelMap->GetEndLine(position);
+      for (itk::SizeValueType line = flatLabelMap->GetFirstLine(position) + 1; line < endLine; ++line)
+      {
+        const auto & previous = flatLabelMap->GetLineIndex(line - 1);
+        const auto & current = flatLabelMap->GetLineIndex(line);
+        EXPECT_TRUE(std::lexicographical_compare(previous.rbegin(), previous.rend(), current.rbegin(), current.rend()));
+      }
+    }
+
+    auto imageFilter = itk::FlatLabelMapToLabelImageFilter<FlatLabelMapType, LabelImageType>::New();
+    imageFilter->SetInput(flatLabelMap);
+    imageFilter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    imageFilter->Update();
+    EXPECT_TRUE(SameImages(image, imageFilter->GetOutput()));
+  }
+}
+
+
+TEST(FlatLabelMap, ConvertsToAndFromLabelMap)
+{
+  const auto image = CreateLabelImage();
+  auto       multiThreader = itk::PlatformMultiThreader::New();
+  multiThreader->SetNumberOfWorkUnits(4);
+
+  auto flatFilter = itk::LabelImageToFlatLabelMapFilter<LabelImageType, FlatLabelMapType>::New();
+  flatFilter->SetInput(image);
+  flatFilter->SetBackgroundValue(0);
+  flatFilter->Update();
+
+  auto labelMap = LabelMapType::New();
+  flatFilter->GetOutput()->CopyToLabelMap(labelMap, multiThreader);
+  EXPECT_EQ(labelMap->GetLabels(), flatFilter->GetOutput()->GetLabels());
+  EXPECT_EQ(labelMap->GetLargestPossibleRegion(), image->GetLargestPossibleRegion());
+
+  auto imageFilter = itk::LabelMapToLabelImageFilter<LabelMapType, LabelImageType>::New();
+  imageFilter->SetInput(labelMap);
+  imageFilter->Update();
+  EXPECT_TRUE(SameImages(image, imageFilter->GetOutput()));
+
+  auto flatLabelMap = FlatLabelMapType::New();
+  flatLabelMap->CopyFromLabelMap(labelMap, multiThreader);
+  EXPECT_EQ(flatLabelMap->GetLabels(), labelMap->GetLabels());
+  EXPECT_EQ(flatLabelMap->GetNumberOfLines(), flatFilter->GetOutput()->GetNumberOfLines());
+  EXPECT_EQ(flatLabelMap->GetLabelPosition(labelMap->GetNthLabelObject(5)->GetLabel()), 5u);
+  EXPECT_TRUE(flatLabelMap->HasLabel(1));
+  EXPECT_FALSE(flatLabelMap->HasLabel(0));
+  EXPECT_THROW(flatLabelMap->GetLabelPosition(0), itk::ExceptionObject);
+
+  // The attributes of the objects are computed concurrently
+  std::vector<itk::SizeValueType> sizes(flatLabelMap->GetNumberOfLabelObjects());
+  std::atomic<itk::SizeValueType> numberOfCalls{ 0 };
+  flatLabelMap->ParallelizeLabelObjects(multiThreader, [&](itk::SizeValueType position) {
+    sizes[position] = flatLabelMap->GetNumberOfPixels(position);
+    ++numberOfCalls;
+  });
+  EXPECT_EQ(numberOfCalls.load(), flatLabelMap->GetNumberOfLabelObjects());
+  for (itk::SizeValueType position = 0; position < sizes.size(); ++position)
+  {
+    EXPECT_EQ(sizes[position], labelMap->GetNthLabelObject(position)->Size());
+  }
+
+  flatLabelMap->Initialize();
+  EXPECT_EQ(flatLabelMap->GetNumberOfLabelObjects(), 0u);
+  EXPECT_EQ(flatLabelMap->GetNumberOfLines(), 0u);
+}
+
+
+TEST(FlatLabelMap, ComputesShapeAttributes)
+{
+  const auto image = CreateLabelImage();
+  image->SetOrigin(itk::MakePoint(1.0, -2.0, 3.0));
+
+  using ShapeLabelObjectType = itk::ShapeLabelObject<unsigned short, 3>;
+  using ShapeLabelMapType = itk::LabelMap<ShapeLabelObjectType>;
+  auto labelMapFilter = itk::LabelImageToLabelMapFilter<LabelImageType, ShapeLabelMapType>::New();
+  labelMapFilter->SetInput(image);
+  labelMapFilter->SetBackgroundValue(0);
+  auto shapeFilter = itk::ShapeLabelMapFilter<ShapeLabelMapType>::New();
+  shapeFilter->SetInput(labelMapFilter->GetOutput());
+  shapeFilter->Update();
+  const ShapeLabelMapType * shapeLabelMap = shapeFilter->GetOutput();
+
+  auto flatFilter = itk::LabelImageToFlatLabelMapFilter<LabelImageType, FlatLabelMapType>::New();
+  flatFilter->SetInput(image);
+  flatFilter->SetBackgroundValue(0);
+  flatFilter->Update();
+  const FlatLabelMapType * flatLabelMap = flatFilter->GetOutput();
+
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 5 })
+  {
+    auto calculator = itk::FlatLabelMapShapeCalculator<FlatLabelMapType>::New();
+    calculator->SetFlatLabelMap(flatLabelMap);
+    calculator->SetNumberOfWorkUnits(numberOfWorkUnits);
+    calculator->Compute();
+
+    ASSERT_EQ(flatLabelMap->GetLabels(), shapeLabelMap->GetLabels());
+    for (itk::SizeValueType position = 0; position < flatLabelMap->GetNumberOfLabelObjects(); ++position)
+    {
+      const ShapeLabelObjectType * labelObject = shapeLabelMap->GetNthLabelObject(position);
+      EXPECT_EQ(calculator->GetNumberOfPixels(position), labelObject->GetNumberOfPixels());
+      EXPECT_DOUBLE_EQ(calculator->GetPhysicalSize(position), labelObject->GetPhysicalSize());
+      EXPECT_EQ(calculator->GetBoundingBox(position), labelObject->GetBoundingBox());
+      EXPECT_EQ(calculator->GetNumberOfPixelsOnBorder(position), labelObject->GetNumberOfPixelsOnBorder());
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        EXPECT_NEAR(calculator->GetCentroid(position)[i], labelObject->GetCentroid()[i], 1e-9);
+      }
+    }
+  }
+}
+
+
+TEST(FlatLabelMap, RejectsInconsistentLines)
+{
+  auto flatLabelMap = FlatLabelMapType::New();
+  EXPECT_THROW(flatLabelMap->SetLines({ 2, 1 }, { 0, 1, 2 }, { {}, {} }, { 1, 1 }), itk::ExceptionObject);
+  EXPECT_THROW(flatLabelMap->SetLines({ 1, 2 }, { 0, 1, 3 }, { {}, {} }, { 1, 1 }), itk::ExceptionObject);
+  EXPECT_NO_THROW(flatLabelMap->SetLines({ 1, 2 }, { 0, 1, 2 }, { {}, {} }, { 1, 1 }));
+  EXPECT_EQ(flatLabelMap->GetNumberOfLabelObjects(), 2u);
+}
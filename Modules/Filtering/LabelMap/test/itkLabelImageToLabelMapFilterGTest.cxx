@@ -0,0 +1,175 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGTest.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkLabelImageSpatialIndex.h"
+#include "itkLabelImageToLabelMapFilter.h"
+#include "itkLabelMapMaskImageFilter.h"
+
+
+namespace
+{
+using LabelImageType = itk::Image<unsigned short, 3>;
+using FeatureImageType = itk::Image<float, 3>;
+using LabelObjectType = itk::LabelObject<unsigned short, 3>;
+using LabelMapType = itk::LabelMap<LabelObjectType>;
+using ConverterType = itk::LabelImageToLabelMapFilter<LabelImageType, LabelMapType>;
+using SpatialIndexType = ConverterType::LabelIndexType;
+
+// Small objects, most of them split over several lines and slabs, in an
+// image that does not start at the origin.
+LabelImageType::Pointer
+CreateLabelImage()
+{
+  auto image = LabelImageType::New();
+  image->SetRegions(LabelImageType::RegionType(itk::MakeIndex(2, -4, 1), itk::MakeSize(37u, 29u, 23u)));
+  image->Allocate();
+
+  unsigned int state = 2024;
+  for (itk::ImageRegionIteratorWithIndex<LabelImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    state = state * 1103515245u + 12345u;
+    const auto & index = it.GetIndex();
+    const auto   cell = static_cast<unsigned short>(1 + (index[0] / 4 + 10 * ((index[1] + 4) / 5)) % 23 +
+                                                  60 * ((index[2] - 1) / 3));
+    it.Set(((state >> 16) % 7) == 0 ? 0 : cell);
+  }
+  return image;
+}
+
+FeatureImageType::Pointer
+CreateFeatureImage(const LabelImageType * labelImage)
+{
+  auto image = FeatureImageType::New();
+  image->SetRegions(labelImage->GetLargestPossibleRegion());
+  image->Allocate();
+  float value = 1.0f;
+  for (itk::ImageRegionIterator<FeatureImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value += 0.25f;
+  }
+  return image;
+}
+} // namespace
+
+
+TEST(LabelImageToLabelMapFilter, LabelIndexGivesSameObjects)
+{
+  const auto labelImage = CreateLabelImage();
+
+  auto converter = ConverterType::New();
+  converter->SetInput(labelImage);
+  converter->SetBackgroundValue(0);
+  converter->Update();
+  const LabelMapType * expected = converter->GetOutput();
+
+  auto labelIndex = SpatialIndexType::New();
+  labelIndex->SetImage(labelImage);
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 3, 8 })
+  {
+    auto indexConverter = ConverterType::New();
+    indexConverter->SetInput(labelImage);
+    indexConverter->SetBackgroundValue(0);
+    indexConverter->SetLabelIndex(labelIndex);
+    indexConverter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    EXPECT_EQ(indexConverter->GetLabelIndex(), labelIndex);
+    indexConverter->Update();
+    const LabelMapType * actual = indexConverter->GetOutput();
+
+    EXPECT_EQ(actual->GetBackgroundValue(), 0);
+    EXPECT_EQ(actual->GetLargestPossibleRegion(), expected->GetLargestPossibleRegion());
+    ASSERT_EQ(actual->GetNumberOfLabelObjects(), expected->GetNumberOfLabelObjects());
+    for (LabelMapType::ConstIterator it(expected); !it.IsAtEnd(); ++it)
+    {
+      const LabelObjectType * expectedObject = it.GetLabelObject();
+      ASSERT_TRUE(actual->HasLabel(it.GetLabel()));
+      const LabelObjectType * actualObject = actual->GetLabelObject(it.GetLabel());
+      ASSERT_EQ(actualObject->GetNumberOfLines(), expectedObject->GetNumberOfLines());
+      for (itk::SizeValueType line = 0; line < expectedObject->GetNumberOfLines(); ++line)
+      {
+        EXPECT_EQ(actualObject->GetLine(line).GetIndex(), expectedObject->GetLine(line).GetIndex());
+        EXPECT_EQ(actualObject->GetLine(line).GetLength(), expectedObject->GetLine(line).GetLength());
+      }
+    }
+  }
+}
+
+TEST(LabelMapMaskImageFilter, MatchesLabelImage)
+{
+  const auto labelImage = CreateLabelImage();
+  const auto featureImage = CreateFeatureImage(labelImage);
+
+  auto labelIndex = SpatialIndexType::New();
+  labelIndex->SetImage(labelImage);
+  labelIndex->Update();
+
+  auto converter = ConverterType::New();
+  converter->SetInput(labelImage);
+  converter->SetBackgroundValue(0);
+  converter->SetLabelIndex(labelIndex);
+
+  using MaskType = itk::LabelMapMaskImageFilter<LabelMapType, FeatureImageType>;
+  constexpr float backgroundValue = -1.0f;
+  for (const unsigned short label : { 0, 14, 75 })
+  {
+    for (const bool negated : { false, true })
+    {
+      for (const bool crop : { false, true })
+      {
+        // Cropping to the background is not implemented
+        if (crop && ((label == 0) ^ negated))
+        {
+          continue;
+        }
+        auto mask = MaskType::New();
+        mask->SetInput(converter->GetOutput());
+        mask->SetFeatureImage(featureImage);
+        mask->SetLabel(label);
+        mask->SetBackgroundValue(backgroundValue);
+        mask->SetNegated(negated);
+        mask->SetCrop(crop);
+        mask->SetCropBorder(MaskType::SizeType::Filled(2));
+        mask->Update();
+        const FeatureImageType * output = mask->GetOutput();
+
+        if (crop && !negated)
+        {
+          auto boundingBox = labelIndex->GetBoundingBox(label);
+          boundingBox.PadByRadius(2);
+          boundingBox.Crop(labelImage->GetLargestPossibleRegion());
+          EXPECT_EQ(output->GetLargestPossibleRegion(), boundingBox);
+        }
+
+        for (itk::ImageRegionConstIteratorWithIndex<FeatureImageType> it(output, output->GetLargestPossibleRegion());
+             !it.IsAtEnd();
+             ++it)
+        {
+          const bool  kept = (labelImage->GetPixel(it.GetIndex()) == label) ^ negated;
+          const float expected = kept ? featureImage->GetPixel(it.GetIndex()) : backgroundValue;
+          ASSERT_EQ(it.Get(), expected) << "label " << label << ", negated " << negated << ", crop " << crop
+                                        << ", index " << it.GetIndex();
+        }
+      }
+    }
+  }
+}
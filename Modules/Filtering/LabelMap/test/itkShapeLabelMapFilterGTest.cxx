@@ -19,8 +19,10 @@
 #include "itkGTest.h"
 
 #include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
 #include "itkLabelImageToShapeLabelMapFilter.h"
 #include "itkTestingMacros.h"
+#include <random>
 
 
 namespace Math = itk::Math;
@@ -534,3 +536,92 @@ TEST_F(ShapeLabelMapFixture, 2D_T2x4)
     labelObject->Print(std::cout);
   }
 }
+
+
+namespace
+{
+// Compare the feret diameter of random objects with the largest distance
+// between two of their pixels
+template <unsigned int VDimension>
+void
+CheckFeretDiameterOfRandomObjects(const itk::SizeValueType size, const unsigned int numberOfLabels)
+{
+  using ImageType = itk::Image<unsigned char, VDimension>;
+  using IndexType = typename ImageType::IndexType;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->AllocateInitialized();
+  typename ImageType::SpacingType spacing;
+  for (unsigned int i = 0; i < VDimension; ++i)
+  {
+    spacing[i] = 0.5 + 0.75 * i;
+  }
+  image->SetSpacing(spacing);
+
+  // Blobs of scattered pixels, some of them touching the border of the image
+  std::mt19937                           generator(VDimension);
+  std::uniform_int_distribution<int>     coordinate(0, static_cast<int>(size) - 1);
+  std::uniform_real_distribution<double> uniform;
+  for (unsigned int label = 1; label <= numberOfLabels; ++label)
+  {
+    IndexType center;
+    for (unsigned int i = 0; i < VDimension; ++i)
+    {
+      center[i] = coordinate(generator);
+    }
+    const double radius = 2.0 + 0.3 * size * uniform(generator);
+    for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd();
+         ++it)
+    {
+      double squaredDistance = 0;
+      for (unsigned int i = 0; i < VDimension; ++i)
+      {
+        squaredDistance += Math::sqr(static_cast<double>(it.GetIndex()[i] - center[i]));
+      }
+      if (squaredDistance <= Math::sqr(radius) && uniform(generator) < 0.7)
+      {
+        it.Set(static_cast<unsigned char>(label));
+      }
+    }
+  }
+
+  auto l2s = itk::LabelImageToShapeLabelMapFilter<ImageType>::New();
+  l2s->SetInput(image);
+  l2s->ComputeFeretDiameterOn();
+  l2s->Update();
+  const auto * labelMap = l2s->GetOutput();
+  ASSERT_GT(labelMap->GetNumberOfLabelObjects(), 0u);
+
+  for (unsigned int n = 0; n < labelMap->GetNumberOfLabelObjects(); ++n)
+  {
+    const auto *           labelObject = labelMap->GetNthLabelObject(n);
+    std::vector<IndexType> indexes;
+    for (itk::SizeValueType p = 0; p < labelObject->Size(); ++p)
+    {
+      indexes.push_back(labelObject->GetIndex(p));
+    }
+    double expected = 0;
+    for (size_t i = 0; i < indexes.size(); ++i)
+    {
+      for (size_t j = i + 1; j < indexes.size(); ++j)
+      {
+        double length = 0;
+        for (unsigned int d = 0; d < VDimension; ++d)
+        {
+          length += Math::sqr((indexes[i][d] - indexes[j][d]) * spacing[d]);
+        }
+        expected = std::max(expected, length);
+      }
+    }
+    EXPECT_EQ(labelObject->GetFeretDiameter(), std::sqrt(expected)) << "label " << labelObject->GetLabel();
+  }
+}
+} // namespace
+
+
+TEST(ShapeLabelMapFilter, FeretDiameterIsTheLargestDistanceBetweenPixels)
+{
+  CheckFeretDiameterOfRandomObjects<2>(60, 12);
+  CheckFeretDiameterOfRandomObjects<3>(18, 8);
+}
@@ -30,6 +30,8 @@
 
 #include "itkCommonEnums.h"
 #include "itkImageIOBase.h"
+#include "itkMultiThreaderBase.h"
+#include "itkTimeProbe.h"
 #include "ITKIOGDCMExport.h"
 #include <fstream>
 #include <string>
@@ -152,6 +154,36 @@ public:
   void
   Read(void * pointer) override;
 
+  /** The frames of a multi-frame image can be read on their own when they
+   * can be decoded one by one. Known once ReadImageInformation() has been
+   * called. */
+  bool
+  CanStreamRead() override
+  {
+    return m_CanReadFrames;
+  }
+
+  /** Returns the frames that overlap the requested region when
+   * UseStreamedReading is on and the frames can be read on their own. */
+  ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
+
+  /** Number of work units used to decode the frames of a multi-frame image.
+   * The default is the global default number of threads of the
+   * multi-threader. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+  /** @ITKEndGrouping */
+
+  /** Time spent decoding pixel data by the calls to Read(), and number of
+   * frames decoded by them. Their ratio is the decoding throughput, in
+   * frames per second. */
+  /** @ITKStartGrouping */
+  itkGetConstReferenceMacro(ReadTimeProbe, TimeProbe);
+  itkGetConstMacro(NumberOfFramesRead, SizeValueType);
+  /** @ITKEndGrouping */
+
   /** Set/Get the original component type of the image. This differs from
    * ComponentType which may change as a function of rescale slope and
    * intercept. */
@@ -300,6 +332,16 @@ private:
   IOComponentEnum m_InternalComponentType{};
 
   InternalHeader * m_DICOMHeader{};
+
+  /** Decode the frames of m_IORegion one by one, concurrently. */
+  void
+  ReadFrames(void * buffer);
+
+  bool                       m_CanReadFrames{ false };
+  ThreadIdType               m_NumberOfWorkUnits{ 1 };
+  MultiThreaderBase::Pointer m_MultiThreader{};
+  TimeProbe                  m_ReadTimeProbe{};
+  SizeValueType              m_NumberOfFramesRead{ 0 };
 };
 
 } // end namespace itk
@@ -50,6 +50,13 @@
 #include "gdcmImageChangePlanarConfiguration.h"
 #include "gdcmRescaler.h"
 #include "gdcmImageReader.h"
+#include "gdcmImageRegionReader.h"
+#include "gdcmBoxRegion.h"
+#include "gdcmRAWCodec.h"
+#include "gdcmRLECodec.h"
+#include "gdcmJPEGCodec.h"
+#include "gdcmJPEGLSCodec.h"
+#include "gdcmJPEG2000Codec.h"
 #include "gdcmImageWriter.h"
 #include "gdcmUIDGenerator.h"
 #include "gdcmAttribute.h"
@@ -90,6 +97,8 @@ GDCMImageIO::GDCMImageIO()
   // UIDPrefix is the ITK root id tacked with a ".1"
   // allowing to designate a subspace of the id space for ITK generated DICOM
   , m_DICOMHeader(new InternalHeader)
+  , m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
 {
   this->SetNumberOfDimensions(3);              // needed for getting the 3 coordinates of
                                                // the origin, even if it is a 2D slice.
@@ -277,6 +286,17 @@ GDCMImageIO::Read(void * pointer)
   // Secondary capture image orientation patient and image position patient support
   itkAssertInDebugAndIgnoreInReleaseMacro(gdcm::ImageHelper::GetSecondaryCaptureImagePlaneModule());
 #endif
+  m_ReadTimeProbe.Start();
+  if (m_CanReadFrames && m_IORegion.GetImageDimension() > 2)
+  {
+    this->ReadFrames(pointer);
+    m_ReadTimeProbe.Stop();
+    m_NumberOfFramesRead += m_IORegion.GetSize(2);
+    itkDebugMacro("Decoded " << m_IORegion.GetSize(2) << " frames in " << m_ReadTimeProbe.GetMean() << ' '
+                             << m_ReadTimeProbe.GetUnit() << " on average");
+    return;
+  }
+
   gdcm::ImageReader reader;
   reader.SetFileName(m_FileName.c_str());
   if (!reader.Read())
@@ -417,6 +437,9 @@ GDCMImageIO::Read(void * pointer)
     }
   }
 
+  m_ReadTimeProbe.Stop();
+  m_NumberOfFramesRead += m_Dimensions[2];
+
 #ifndef NDEBUG
   // \postcondition
   // Now that len was updated (after unpacker 12bits -> 16bits, rescale...) ,
@@ -426,6 +449,88 @@ GDCMImageIO::Read(void * pointer)
 #endif
 }
 
+void
+GDCMImageIO::ReadFrames(void * buffer)
+{
+  const auto          firstFrame = static_cast<unsigned int>(m_IORegion.GetIndex(2));
+  const auto          numberOfFrames = static_cast<unsigned int>(m_IORegion.GetSize(2));
+  const SizeValueType frameSize = m_Dimensions[0] * m_Dimensions[1] * this->GetPixelSize();
+  const bool          rescale = m_RescaleSlope != 1.0 || m_RescaleIntercept != 0.0;
+
+  const auto readFrames = [this, buffer, firstFrame, frameSize, rescale](unsigned int begin, unsigned int end) {
+    gdcm::ImageRegionReader reader;
+    reader.SetFileName(m_FileName.c_str());
+    if (!reader.ReadInformation())
+    {
+      itkExceptionStringMacro("Cannot read requested file");
+    }
+    gdcm::BoxRegion frames;
+    frames.SetDomain(0,
+                     static_cast<unsigned int>(m_Dimensions[0] - 1),
+                     0,
+                     static_cast<unsigned int>(m_Dimensions[1] - 1),
+                     begin,
+                     end - 1);
+    reader.SetRegion(frames);
+
+    char *       out = static_cast<char *>(buffer) + (begin - firstFrame) * frameSize;
+    const size_t len = reader.ComputeBufferLength();
+    if (!rescale)
+    {
+      if (len != (end - begin) * frameSize || !reader.ReadIntoBuffer(out, len))
+      {
+        itkExceptionMacro("Failed to decode frames " << begin << " to " << end - 1 << " of " << m_FileName);
+      }
+      return;
+    }
+
+    // WARNING: sizeof(Real World Value) != sizeof(Stored Pixel)
+    const auto copy = make_unique_for_overwrite<char[]>(len);
+    if (!reader.ReadIntoBuffer(copy.get(), len))
+    {
+      itkExceptionMacro("Failed to decode frames " << begin << " to " << end - 1 << " of " << m_FileName);
+    }
+    gdcm::Rescaler r;
+    r.SetIntercept(m_RescaleIntercept);
+    r.SetSlope(m_RescaleSlope);
+    r.SetPixelFormat(reader.GetImage().GetPixelFormat());
+    r.Rescale(out, copy.get(), len);
+  };
+
+  const auto numberOfWorkUnits = std::min(m_NumberOfWorkUnits, static_cast<ThreadIdType>(numberOfFrames));
+  if (numberOfWorkUnits <= 1)
+  {
+    readFrames(firstFrame, firstFrame + numberOfFrames);
+    return;
+  }
+
+  // A reader decodes the frames it is given one after the other: each work
+  // unit opens the file for itself, and decodes a run of consecutive frames
+  m_MultiThreader->SetNumberOfWorkUnits(numberOfWorkUnits);
+  m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfWorkUnits,
+    [&readFrames, firstFrame, numberOfFrames, numberOfWorkUnits](SizeValueType workUnit) {
+      readFrames(static_cast<unsigned int>(firstFrame + numberOfFrames * workUnit / numberOfWorkUnits),
+                 static_cast<unsigned int>(firstFrame + numberOfFrames * (workUnit + 1) / numberOfWorkUnits));
+    },
+    nullptr);
+}
+
+ImageIORegion
+GDCMImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
+{
+  ImageIORegion streamableRegion = Superclass::GenerateStreamableReadRegionFromRequestedRegion(requestedRegion);
+  if (m_UseStreamedReading && m_CanReadFrames && requestedRegion.GetImageDimension() > 2 &&
+      streamableRegion.GetImageDimension() > 2)
+  {
+    // Only whole frames are decoded
+    streamableRegion.SetIndex(2, requestedRegion.GetIndex(2));
+    streamableRegion.SetSize(2, requestedRegion.GetSize(2));
+  }
+  return streamableRegion;
+}
+
 
 void
 GDCMImageIO::InternalReadImageInformation()
@@ -434,6 +539,7 @@ GDCMImageIO::InternalReadImageInformation()
   m_RescaleIntercept = 0.0;
   m_RescaleSlope = 1.0;
   m_SingleBit = false;
+  m_CanReadFrames = false;
 
   // ensure file can be opened for reading, before doing any more work
   std::ifstream inputFileStream;
@@ -721,6 +827,17 @@ GDCMImageIO::InternalReadImageInformation()
     m_Dimensions[2] = 1;
   }
 
+  // The frames can be decoded one by one when the codecs of
+  // gdcm::ImageRegionReader decode them to the pixels ITK expects
+  const gdcm::TransferSyntax & ts = f.GetHeader().GetDataSetTransferSyntax();
+  const bool                   interleaved =
+    image.GetPlanarConfiguration() == 0 &&
+    (pi == gdcm::PhotometricInterpretation::MONOCHROME2 || pi == gdcm::PhotometricInterpretation::RGB);
+  m_CanReadFrames = m_Dimensions[2] > 1 && !m_SingleBit && pixeltype.GetBitsAllocated() % 8 == 0 && interleaved &&
+                    (gdcm::RAWCodec().CanDecode(ts) || gdcm::RLECodec().CanDecode(ts) ||
+                     gdcm::JPEGCodec().CanDecode(ts) || gdcm::JPEGLSCodec().CanDecode(ts) ||
+                     gdcm::JPEG2000Codec().CanDecode(ts));
+
   const double *     dircos = image.GetDirectionCosines();
   vnl_vector<double> rowDirection(3);
   rowDirection[0] = dircos[0];
@@ -1484,6 +1601,12 @@ GDCMImageIO::PrintSelf(std::ostream & os, Indent indent) const
   {
     os << m_DICOMHeader << std::endl;
   }
+
+  itkPrintSelfBooleanMacro(CanReadFrames);
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+  itkPrintSelfObjectMacro(MultiThreader);
+  os << indent << "ReadTimeProbe: " << m_ReadTimeProbe.GetTotal() << ' ' << m_ReadTimeProbe.GetUnit() << std::endl;
+  os << indent << "NumberOfFramesRead: " << m_NumberOfFramesRead << std::endl;
 }
 
 std::ostream &
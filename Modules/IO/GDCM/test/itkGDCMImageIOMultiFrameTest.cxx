@@ -0,0 +1,151 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGDCMImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMetaDataObject.h"
+#include "itkTestingMacros.h"
+#include "itkTestVerifyImageRegion.h"
+
+
+namespace
+{
+using ImageType = itk::Image<unsigned short, 3>;
+
+template <typename TImage>
+typename TImage::Pointer
+ReadFrames(const std::string & fileName, itk::ThreadIdType numberOfWorkUnits, const ImageType::RegionType * region)
+{
+  auto imageIO = itk::GDCMImageIO::New();
+  imageIO->SetNumberOfWorkUnits(numberOfWorkUnits);
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(imageIO);
+  if (region != nullptr)
+  {
+    reader->UseStreamingOn();
+    reader->GetOutput()->SetRequestedRegion(*region);
+  }
+  reader->Update();
+  if (!imageIO->CanStreamRead())
+  {
+    itkGenericExceptionMacro("The frames cannot be read one by one.");
+  }
+  if (imageIO->GetNumberOfFramesRead() == 0 || imageIO->GetReadTimeProbe().GetNumberOfStops() != 1)
+  {
+    itkGenericExceptionMacro("The decoding of the frames was not timed.");
+  }
+  return reader->GetOutput();
+}
+} // namespace
+
+
+int
+itkGDCMImageIOMultiFrameTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  auto imageIO = itk::GDCMImageIO::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(imageIO, GDCMImageIO, ImageIOBase);
+  constexpr itk::ThreadIdType numberOfWorkUnits = 3;
+  imageIO->SetNumberOfWorkUnits(numberOfWorkUnits);
+  ITK_TEST_SET_GET_VALUE(numberOfWorkUnits, imageIO->GetNumberOfWorkUnits());
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 64, 48, 19 } });
+  image->Allocate();
+  unsigned short value = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<unsigned short>(it.GetIndex()[2] * 100 + (value & 63)));
+    value = static_cast<unsigned short>(value * 31 + 7);
+  }
+
+  const ImageType::RegionType slices({ { 0, 0, 5 } }, { { 64, 48, 11 } });
+  for (const char * compressor : { "", "JPEG2000", "JPEG" })
+  {
+    std::cout << "Compressor: \"" << compressor << '"' << std::endl;
+    const std::string fileName = directory + "/itkGDCMImageIOMultiFrameTest" + compressor + ".dcm";
+    auto              writer = itk::ImageFileWriter<ImageType>::New();
+    auto              writerIO = itk::GDCMImageIO::New();
+    writer->SetInput(image);
+    writer->SetFileName(fileName);
+    writer->SetImageIO(writerIO);
+    if (*compressor != '\0')
+    {
+      writerIO->SetCompressor(compressor);
+      writer->UseCompressionOn();
+    }
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+    // The frames are decoded the same by a single and by several work units
+    for (const itk::ThreadIdType numberOfWorkUnits : { 1, 4, 32 })
+    {
+      ImageType::Pointer frames;
+      ITK_TRY_EXPECT_NO_EXCEPTION(frames = ReadFrames<ImageType>(fileName, numberOfWorkUnits, nullptr));
+      ITK_TEST_EXPECT_TRUE(
+        itk::Testing::VerifyImageRegion(image.GetPointer(), frames.GetPointer(), image->GetLargestPossibleRegion()));
+    }
+
+    // Only the frames of the requested region are decoded
+    ImageType::Pointer streamed;
+    ITK_TRY_EXPECT_NO_EXCEPTION(streamed = ReadFrames<ImageType>(fileName, 4, &slices));
+    ITK_TEST_EXPECT_EQUAL(streamed->GetBufferedRegion(), slices);
+    ITK_TEST_EXPECT_TRUE(itk::Testing::VerifyImageRegion(image.GetPointer(), streamed.GetPointer(), slices));
+  }
+
+  // The frames are rescaled to the real world values
+  using FloatImageType = itk::Image<float, 3>;
+  auto realWorldImage = FloatImageType::New();
+  realWorldImage->SetRegions(image->GetLargestPossibleRegion());
+  realWorldImage->Allocate();
+  for (itk::ImageRegionIterator<FloatImageType> it(realWorldImage, realWorldImage->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    it.Set(2.0f * image->GetPixel(it.GetIndex()) - 3.0f);
+  }
+  itk::MetaDataDictionary & dictionary = realWorldImage->GetMetaDataDictionary();
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0060", "CT");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0028|0100", "16");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0028|0101", "16");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0028|0102", "15");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0028|0103", "0");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0028|1052", "-3");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0028|1053", "2");
+  const std::string fileName = directory + "/itkGDCMImageIOMultiFrameTestRescaled.dcm";
+  auto              writer = itk::ImageFileWriter<FloatImageType>::New();
+  writer->SetInput(realWorldImage);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(itk::GDCMImageIO::New());
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  FloatImageType::Pointer rescaled;
+  ITK_TRY_EXPECT_NO_EXCEPTION(rescaled = ReadFrames<FloatImageType>(fileName, 4, &slices));
+  ITK_TEST_EXPECT_TRUE(itk::Testing::VerifyImageRegion(realWorldImage.GetPointer(), rescaled.GetPointer(), slices));
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -27,7 +27,9 @@
 #include "ITKIOHDF5Export.h"
 #include "itkMetaDataObjectBase.h"
 #include "itkMetaDataDictionary.h"
+#include "itkMultiThreaderBase.h"
 #include <memory> // For unique_ptr.
+#include <vector>
 
 // itk namespace first suppresses
 // kwstyle error for the H5 namespace below
@@ -80,6 +82,13 @@ namespace itk
  *                             in the MetaDataDictionary
  * re-arrangement.
  *
+ * The voxel data are stored in chunks, compressed with deflate. The
+ * ChunkSize sets their shape, and the ChunkCacheSize the size of the cache
+ * of chunks of the HDF5 library. When the voxel data are stored as this
+ * class writes them, or with no compression, their chunks are read and
+ * written directly: only the chunks that overlap the region read or
+ * written are transferred, and they are decompressed and compressed
+ * concurrently by the work units of the multi-threader.
  *
  */
 
@@ -138,6 +147,31 @@ public:
   void
   Write(const void * buffer) override;
 
+  /** Size of the chunks of the voxel data written, in pixels, along each
+   * dimension of the image. Dimensions without a size, or with a size of 0,
+   * are not cut. When empty, the default, a chunk is a slice of the image
+   * along its last dimension. */
+  /** @ITKStartGrouping */
+  itkSetMacro(ChunkSize, std::vector<SizeValueType>);
+  itkGetConstReferenceMacro(ChunkSize, std::vector<SizeValueType>);
+  /** @ITKEndGrouping */
+
+  /** Size, in bytes, of the cache of chunks of the voxel data that the HDF5
+   * library keeps when it reads and writes them itself. A chunk larger than
+   * the cache is read again for each region that overlaps it. The default,
+   * 0, keeps the default size of the library. */
+  /** @ITKStartGrouping */
+  itkSetMacro(ChunkCacheSize, SizeValueType);
+  itkGetConstMacro(ChunkCacheSize, SizeValueType);
+  /** @ITKEndGrouping */
+
+  /** Number of work units used to decompress and compress the chunks. The
+   * default is the global default number of threads of the multi-threader. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+  /** @ITKEndGrouping */
+
 protected:
   HDF5ImageIO();
   ~HDF5ImageIO() override;
@@ -204,6 +238,16 @@ private:
   void
   SetupStreaming(H5::DataSpace * imageSpace, H5::DataSpace * slabSpace);
 
+  /** Find out whether the chunks of the voxel data set can be read and
+   * written directly. */
+  void
+  InspectVoxelDataSet();
+
+  /** Read or write the chunks that overlap the IORegion directly, and
+   * decompress or compress them concurrently. */
+  void
+  TransferChunks(void * buffer, bool write);
+
   /* A convenience function to ensure that the
    * state of the HDF5ImageIO object is returned
    * to a state similar to constructing a new
@@ -217,6 +261,16 @@ private:
   std::unique_ptr<H5::H5File>  m_H5File;
   std::unique_ptr<H5::DataSet> m_VoxelDataSet;
   bool                         m_ImageInformationWritten{ false };
+
+  std::vector<SizeValueType> m_ChunkSize{};
+  SizeValueType              m_ChunkCacheSize{ 0 };
+  ThreadIdType               m_NumberOfWorkUnits{ 1 };
+  MultiThreaderBase::Pointer m_MultiThreader{};
+
+  /** Shape of the chunks of the voxel data set, in HDF5 order, when they are
+   * read and written directly; empty otherwise. */
+  std::vector<SizeValueType> m_DirectChunkSize{};
+  bool                       m_DirectChunkDeflate{ false };
 };
 } // end namespace itk
 
@@ -21,16 +21,25 @@
 #include "itkArray.h"
 #include "itksys/SystemTools.hxx"
 #include "itk_H5Cpp.h"
+#include "itk_zlib.h"
 #include "itkMakeUniqueForOverwrite.h"
 
 #include <algorithm>
+#include <cstring>
 #include <type_traits> // For is_signed_v.
 
+// The chunks of a data set can be read and written directly from HDF5
+// 1.10.3 on
+#if H5_VERSION_GE(1, 10, 3)
+#  define ITK_HDF5_DIRECT_CHUNK_IO
+#endif
+
 namespace itk
 {
 
 HDF5ImageIO::HDF5ImageIO()
-
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
 {
 
   const char * extensions[] = { ".hdf", ".h4", ".hdf4", ".h5", ".hdf5", ".he4", ".he5", ".hd5" };
@@ -53,6 +62,22 @@ HDF5ImageIO::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
   // just prints out the pointer value.
   os << indent << "H5File: " << m_H5File.get() << std::endl;
+  os << indent << "ChunkSize:";
+  for (const SizeValueType size : m_ChunkSize)
+  {
+    os << ' ' << size;
+  }
+  os << std::endl;
+  os << indent << "ChunkCacheSize: " << m_ChunkCacheSize << std::endl;
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+  itkPrintSelfObjectMacro(MultiThreader);
+  os << indent << "DirectChunkSize:";
+  for (const SizeValueType size : m_DirectChunkSize)
+  {
+    os << ' ' << size;
+  }
+  os << std::endl;
+  itkPrintSelfBooleanMacro(DirectChunkDeflate);
 }
 
 //
@@ -271,6 +296,67 @@ doesAttrExist(const H5::H5Object & object, const char * const name)
   return (H5Aexists(object.getId(), name) > 0 ? true : false);
 }
 
+// Access properties of the voxel data set, with a chunk cache of the given
+// size in bytes, or of the default size when it is 0.
+H5::DSetAccPropList
+VoxelDataAccessProperties(const SizeValueType chunkCacheSize)
+{
+  H5::DSetAccPropList dapl;
+  if (chunkCacheSize > 0)
+  {
+    dapl.setChunkCache(H5D_CHUNK_CACHE_NSLOTS_DEFAULT, chunkCacheSize, H5D_CHUNK_CACHE_W0_DEFAULT);
+  }
+  return dapl;
+}
+
+// Copy the block of count elements at srcStart of the array src, of
+// dimensions srcSize, to dstStart of the array dst, of dimensions dstSize.
+// The last dimension of the arrays is the fastest moving one.
+void
+CopyBlock(const char *                       src,
+          const std::vector<SizeValueType> & srcSize,
+          const std::vector<SizeValueType> & srcStart,
+          char *                             dst,
+          const std::vector<SizeValueType> & dstSize,
+          const std::vector<SizeValueType> & dstStart,
+          const std::vector<SizeValueType> & count,
+          const size_t                       elementSize)
+{
+  const size_t               rank = count.size();
+  std::vector<SizeValueType> position(rank, 0);
+  for (;;)
+  {
+    size_t srcOffset = 0;
+    size_t dstOffset = 0;
+    for (size_t d = 0; d < rank; ++d)
+    {
+      srcOffset = srcOffset * srcSize[d] + srcStart[d] + position[d];
+      dstOffset = dstOffset * dstSize[d] + dstStart[d] + position[d];
+    }
+    memcpy(dst + dstOffset * elementSize, src + srcOffset * elementSize, count[rank - 1] * elementSize);
+
+    // Next run along the last dimension
+    size_t d = rank - 1;
+    for (;;)
+    {
+      if (d == 0)
+      {
+        return;
+      }
+      --d;
+      if (++position[d] < count[d])
+      {
+        break;
+      }
+      position[d] = 0;
+    }
+  }
+}
+
+// The chunks transferred directly are read, decompressed, compressed and
+// written in batches of at most this size, or of one chunk per work unit
+constexpr SizeValueType MaximumChunkBatchSizeInBytes = SizeValueType{ 64 } << 20;
+
 } // namespace
 
 void
@@ -744,13 +830,14 @@ HDF5ImageIO::ReadImageInformation()
 
     std::string VoxelDataName(groupName);
     VoxelDataName += VoxelData;
-    *(m_VoxelDataSet) = m_H5File->openDataSet(VoxelDataName);
+    *(m_VoxelDataSet) = m_H5File->openDataSet(VoxelDataName, VoxelDataAccessProperties(m_ChunkCacheSize));
     H5::DataSet         imageSet = *(m_VoxelDataSet);
     const H5::DataSpace imageSpace = imageSet.getSpace();
     //
     // set the componentType
     H5::DataType imageVoxelType = imageSet.getDataType();
     this->m_ComponentType = PredTypeToComponentType(imageVoxelType);
+    this->InspectVoxelDataSet();
     //
     // if this isn't a scalar image, deduce the # of components
     // by comparing the size of the Directions matrix with the
@@ -999,9 +1086,11 @@ HDF5ImageIO::SetupStreaming(H5::DataSpace * imageSpace, H5::DataSpace * slabSpac
 void
 HDF5ImageIO::Read(void * buffer)
 {
-  const ImageIORegion            regionToRead = this->GetIORegion();
-  const ImageIORegion::SizeType  size = regionToRead.GetSize();
-  const ImageIORegion::IndexType start = regionToRead.GetIndex();
+  if (!m_DirectChunkSize.empty())
+  {
+    this->TransferChunks(buffer, false);
+    return;
+  }
 
   const H5::DataType voxelType = m_VoxelDataSet->getDataType();
   H5::DataSpace      imageSpace = m_VoxelDataSet->getSpace();
@@ -1184,21 +1273,37 @@ HDF5ImageIO::WriteImageInformation()
     const H5::PredType  dataType = ComponentToPredType(this->GetComponentType());
 
     // set up properties for chunked, compressed writes.
-    // in this case, set the chunk size to be the N-1 dimension
+    // by default, set the chunk size to be the N-1 dimension
     // region
     const H5::DSetCreatPropList plist;
 
     // we have implicit compression enabled here?
     plist.setDeflate(this->GetCompressionLevel());
 
-    dims[0] = 1;
+    if (m_ChunkSize.empty())
+    {
+      dims[0] = 1;
+    }
+    else
+    {
+      for (unsigned int i = 0; i < this->GetNumberOfDimensions(); ++i)
+      {
+        if (i < m_ChunkSize.size() && m_ChunkSize[i] > 0)
+        {
+          hsize_t & chunkSize = dims[this->GetNumberOfDimensions() - 1 - i];
+          chunkSize = std::min(chunkSize, static_cast<hsize_t>(m_ChunkSize[i]));
+        }
+      }
+    }
     plist.setChunk(numDims, dims.get());
     dims.reset();
 
     std::string VoxelDataName(ImageGroup);
     VoxelDataName += "/0";
     VoxelDataName += VoxelData;
-    *(m_VoxelDataSet) = m_H5File->createDataSet(VoxelDataName, dataType, imageSpace, plist);
+    *(m_VoxelDataSet) = m_H5File->createDataSet(
+      VoxelDataName, dataType, imageSpace, plist, VoxelDataAccessProperties(m_ChunkCacheSize));
+    this->InspectVoxelDataSet();
     std::string MetaDataGroupName(groupName);
     MetaDataGroupName += MetaDataName;
     m_H5File->createGroup(MetaDataGroupName);
@@ -1388,6 +1493,11 @@ void
 HDF5ImageIO::Write(const void * buffer)
 {
   this->WriteImageInformation();
+  if (!m_DirectChunkSize.empty())
+  {
+    this->TransferChunks(const_cast<void *>(buffer), true);
+    return;
+  }
   try
   {
     const int numComponents = this->GetNumberOfComponents();
@@ -1441,6 +1551,278 @@ HDF5ImageIO::Write(const void * buffer)
   // this->ResetToInitialState();
 }
 
+void
+HDF5ImageIO::InspectVoxelDataSet()
+{
+  m_DirectChunkSize.clear();
+  m_DirectChunkDeflate = false;
+#ifdef ITK_HDF5_DIRECT_CHUNK_IO
+  // The chunks are copied as they are stored: the voxels must have the
+  // native type, and the chunks may only be compressed with deflate
+  const H5::DSetCreatPropList plist = m_VoxelDataSet->getCreatePlist();
+  if (plist.getLayout() != H5D_CHUNKED || !(m_VoxelDataSet->getDataType() == ComponentToPredType(m_ComponentType)))
+  {
+    return;
+  }
+  const int numberOfFilters = plist.getNfilters();
+  if (numberOfFilters > 1)
+  {
+    return;
+  }
+  if (numberOfFilters == 1)
+  {
+    unsigned int flags = 0;
+    size_t       numberOfValues = 0;
+    unsigned int filterConfig = 0;
+    char         name[64];
+    if (plist.getFilter(0, flags, numberOfValues, nullptr, sizeof(name), name, filterConfig) != H5Z_FILTER_DEFLATE)
+    {
+      return;
+    }
+    m_DirectChunkDeflate = true;
+  }
+
+  // Missing chunks are filled with zeros
+  H5D_fill_value_t fillValueStatus{};
+  if (H5Pfill_value_defined(plist.getId(), &fillValueStatus) < 0)
+  {
+    return;
+  }
+  if (fillValueStatus == H5D_FILL_VALUE_USER_DEFINED)
+  {
+    const std::vector<char> zero(this->GetComponentSize(), 0);
+    std::vector<char>       fillValue(this->GetComponentSize());
+    plist.getFillValue(ComponentToPredType(m_ComponentType), fillValue.data());
+    if (fillValue != zero)
+    {
+      return;
+    }
+  }
+
+  const int            rank = m_VoxelDataSet->getSpace().getSimpleExtentNdims();
+  std::vector<hsize_t> chunkSize(rank);
+  if (plist.getChunk(rank, chunkSize.data()) != rank)
+  {
+    return;
+  }
+  m_DirectChunkSize.assign(chunkSize.begin(), chunkSize.end());
+#endif
+}
+
+void
+HDF5ImageIO::TransferChunks(void * buffer, bool write)
+{
+#ifdef ITK_HDF5_DIRECT_CHUNK_IO
+  // The extent of the voxel data set and the region, in HDF5 order: slowest
+  // moving first, and the components of the voxels last when there are
+  // several
+  const ImageIORegion & region = this->GetIORegion();
+  const unsigned int    imageDimension = this->GetNumberOfDimensions();
+  const size_t          rank = m_DirectChunkSize.size();
+  const size_t          componentSize = this->GetComponentSize();
+
+  std::vector<SizeValueType> extent(rank, this->GetNumberOfComponents());
+  std::vector<SizeValueType> start(rank, 0);
+  std::vector<SizeValueType> size(rank, this->GetNumberOfComponents());
+  for (unsigned int i = 0; i < imageDimension; ++i)
+  {
+    const size_t d = imageDimension - 1 - i;
+    extent[d] = m_Dimensions[i];
+    start[d] = i < region.GetImageDimension() ? region.GetIndex(i) : 0;
+    size[d] = i < region.GetImageDimension() ? region.GetSize(i) : 1;
+  }
+
+  // The chunks that overlap the region, the last dimension fastest
+  std::vector<SizeValueType> firstChunk(rank);
+  std::vector<SizeValueType> numberOfChunksAlong(rank);
+  SizeValueType              numberOfChunks = 1;
+  SizeValueType              chunkBytes = componentSize;
+  for (size_t d = 0; d < rank; ++d)
+  {
+    firstChunk[d] = start[d] / m_DirectChunkSize[d];
+    numberOfChunksAlong[d] = (start[d] + size[d] - 1) / m_DirectChunkSize[d] - firstChunk[d] + 1;
+    numberOfChunks *= numberOfChunksAlong[d];
+    chunkBytes *= m_DirectChunkSize[d];
+  }
+  const auto getChunkOrigin = [&](SizeValueType chunk) {
+    std::vector<hsize_t> origin(rank);
+    for (size_t d = rank; d-- > 0;)
+    {
+      origin[d] = (firstChunk[d] + chunk % numberOfChunksAlong[d]) * m_DirectChunkSize[d];
+      chunk /= numberOfChunksAlong[d];
+    }
+    return origin;
+  };
+
+  // The chunks are transferred in batches, so that the memory they take
+  // does not grow with the region. In each batch, the stored chunks that are
+  // needed are read one after the other, since the HDF5 library is used by
+  // a single thread, then decompressed, copied and compressed concurrently,
+  // and written one after the other.
+  const hid_t         dataSet = m_VoxelDataSet->getId();
+  const int           compressionLevel = this->GetCompressionLevel();
+  const SizeValueType chunksPerBatch = std::min(
+    numberOfChunks, std::max<SizeValueType>(m_NumberOfWorkUnits, MaximumChunkBatchSizeInBytes / chunkBytes));
+  std::vector<std::vector<char>> stored(chunksPerBatch);
+  std::vector<uint32_t>          filterMasks(chunksPerBatch);
+  std::vector<unsigned char>     succeeded(chunksPerBatch);
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  for (SizeValueType batchStart = 0; batchStart < numberOfChunks; batchStart += chunksPerBatch)
+  {
+    const SizeValueType batchSize = std::min(chunksPerBatch, numberOfChunks - batchStart);
+    for (SizeValueType i = 0; i < batchSize; ++i)
+    {
+      stored[i].clear();
+      filterMasks[i] = 0;
+      succeeded[i] = 0;
+
+      const std::vector<hsize_t> origin = getChunkOrigin(batchStart + i);
+      bool                       partial = false;
+      for (size_t d = 0; d < rank; ++d)
+      {
+        const SizeValueType chunkEnd = std::min<SizeValueType>(origin[d] + m_DirectChunkSize[d], extent[d]);
+        partial = partial || origin[d] < start[d] || chunkEnd > start[d] + size[d];
+      }
+      if (write && !partial)
+      {
+        continue;
+      }
+      // A chunk that was never written has no storage, which is not an
+      // error to report
+      hsize_t storageSize = 0;
+      herr_t  status = 0;
+      H5E_BEGIN_TRY
+      {
+        status = H5Dget_chunk_storage_size(dataSet, origin.data(), &storageSize);
+      }
+      H5E_END_TRY
+      if (status < 0 || storageSize == 0)
+      {
+        continue;
+      }
+      stored[i].resize(storageSize);
+      if (H5Dread_chunk(dataSet, H5P_DEFAULT, origin.data(), &filterMasks[i], stored[i].data()) < 0)
+      {
+        itkExceptionMacro("Cannot read the chunk at " << origin[0] << "... of " << m_FileName);
+      }
+    }
+
+    const auto transferChunk = [&](SizeValueType i) {
+      const std::vector<hsize_t> origin = getChunkOrigin(batchStart + i);
+      std::vector<SizeValueType> chunkStart(rank);
+      std::vector<SizeValueType> regionStart(rank);
+      std::vector<SizeValueType> count(rank);
+      for (size_t d = 0; d < rank; ++d)
+      {
+        const SizeValueType begin = std::max<SizeValueType>(origin[d], start[d]);
+        const SizeValueType end = std::min<SizeValueType>(origin[d] + m_DirectChunkSize[d], start[d] + size[d]);
+        chunkStart[d] = begin - origin[d];
+        regionStart[d] = begin - start[d];
+        count[d] = end - begin;
+      }
+
+      // The chunk as it is in memory; chunks at the border of the data set
+      // are padded
+      std::vector<char> data(chunkBytes, 0);
+      if (!stored[i].empty())
+      {
+        if (m_DirectChunkDeflate && (filterMasks[i] & 1) == 0)
+        {
+          auto dataLength = static_cast<uLongf>(chunkBytes);
+          if (uncompress(reinterpret_cast<Bytef *>(data.data()),
+                         &dataLength,
+                         reinterpret_cast<const Bytef *>(stored[i].data()),
+                         static_cast<uLong>(stored[i].size())) != Z_OK ||
+              dataLength != chunkBytes)
+          {
+            return;
+          }
+        }
+        else if (stored[i].size() == chunkBytes)
+        {
+          data.swap(stored[i]);
+        }
+        else
+        {
+          return;
+        }
+      }
+
+      if (!write)
+      {
+        CopyBlock(data.data(),
+                  m_DirectChunkSize,
+                  chunkStart,
+                  static_cast<char *>(buffer),
+                  size,
+                  regionStart,
+                  count,
+                  componentSize);
+        succeeded[i] = 1;
+        return;
+      }
+
+      CopyBlock(static_cast<const char *>(buffer),
+                size,
+                regionStart,
+                data.data(),
+                m_DirectChunkSize,
+                chunkStart,
+                count,
+                componentSize);
+      if (m_DirectChunkDeflate)
+      {
+        auto storedLength = compressBound(static_cast<uLong>(chunkBytes));
+        stored[i].resize(storedLength);
+        if (compress2(reinterpret_cast<Bytef *>(stored[i].data()),
+                      &storedLength,
+                      reinterpret_cast<const Bytef *>(data.data()),
+                      static_cast<uLong>(chunkBytes),
+                      compressionLevel) != Z_OK)
+        {
+          return;
+        }
+        stored[i].resize(storedLength);
+      }
+      else
+      {
+        stored[i].swap(data);
+      }
+      succeeded[i] = 1;
+    };
+
+    if (batchSize > 1 && m_NumberOfWorkUnits > 1)
+    {
+      m_MultiThreader->ParallelizeArray(0, batchSize, transferChunk, nullptr);
+    }
+    else
+    {
+      for (SizeValueType i = 0; i < batchSize; ++i)
+      {
+        transferChunk(i);
+      }
+    }
+    if (std::find(succeeded.begin(), succeeded.begin() + batchSize, 0) != succeeded.begin() + batchSize)
+    {
+      itkExceptionMacro("Cannot " << (write ? "compress" : "decompress") << " the voxel data of " << m_FileName);
+    }
+
+    for (SizeValueType i = 0; write && i < batchSize; ++i)
+    {
+      const std::vector<hsize_t> origin = getChunkOrigin(batchStart + i);
+      if (H5Dwrite_chunk(dataSet, H5P_DEFAULT, 0, origin.data(), stored[i].size(), stored[i].data()) < 0)
+      {
+        itkExceptionMacro("Cannot write the voxel data of " << m_FileName);
+      }
+    }
+  }
+#else
+  (void)buffer;
+  (void)write;
+  itkExceptionMacro("The chunks of " << m_FileName << " cannot be transferred directly");
+#endif
+}
+
 //
 // GetHeaderSize -- return 0
 ImageIOBase::SizeType
@@ -0,0 +1,160 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkHDF5ImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkVectorImage.h"
+#include "itkTestingMacros.h"
+#include "itkTestVerifyImageRegion.h"
+
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+
+template <typename TImage>
+typename TImage::Pointer
+ReadRegion(const std::string & fileName, const typename TImage::RegionType & region, itk::ThreadIdType workUnits)
+{
+  auto imageIO = itk::HDF5ImageIO::New();
+  imageIO->SetNumberOfWorkUnits(workUnits);
+  imageIO->SetChunkCacheSize(1 << 16);
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(imageIO);
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->Update();
+  return reader->GetOutput();
+}
+} // namespace
+
+
+int
+itkHDF5ImageIOChunkTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 45, 37, 21 } });
+  image->Allocate();
+  short value = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<short>(it.GetIndex()[2] * 100 + (value & 63)));
+    value = static_cast<short>(value * 31 + 7);
+  }
+  const ImageType::RegionType largest = image->GetLargestPossibleRegion();
+  const ImageType::RegionType inner({ { 5, 14, 3 } }, { { 20, 17, 11 } });
+
+  auto imageIO = itk::HDF5ImageIO::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(imageIO, HDF5ImageIO, StreamingImageIOBase);
+  const std::vector<itk::SizeValueType> chunkSize{ 16, 16, 8 };
+  imageIO->SetChunkSize(chunkSize);
+  ITK_TEST_EXPECT_TRUE(imageIO->GetChunkSize() == chunkSize);
+  imageIO->SetChunkCacheSize(1 << 20);
+  ITK_TEST_SET_GET_VALUE(itk::SizeValueType{ 1 << 20 }, imageIO->GetChunkCacheSize());
+  imageIO->SetNumberOfWorkUnits(4);
+  ITK_TEST_SET_GET_VALUE(itk::ThreadIdType{ 4 }, imageIO->GetNumberOfWorkUnits());
+
+  for (const bool compress : { false, true })
+  {
+    // An image IO writes a single file
+    if (compress)
+    {
+      imageIO = itk::HDF5ImageIO::New();
+      imageIO->SetChunkSize(chunkSize);
+      imageIO->SetNumberOfWorkUnits(3);
+    }
+
+    // Chunks of the size set, with partial chunks at the borders
+    const std::string fileName = directory + "/itkHDF5ImageIOChunkTest" + (compress ? "Compressed" : "") + ".hdf5";
+    auto              writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(image);
+    writer->SetFileName(fileName);
+    writer->SetImageIO(imageIO);
+    writer->SetUseCompression(compress);
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+    for (const itk::ThreadIdType workUnits : { 1, 4 })
+    {
+      for (const ImageType::RegionType & region : { largest, inner })
+      {
+        ImageType::Pointer read;
+        ITK_TRY_EXPECT_NO_EXCEPTION(read = ReadRegion<ImageType>(fileName, region, workUnits));
+        ITK_TEST_EXPECT_EQUAL(read->GetBufferedRegion(), region);
+        ITK_TEST_EXPECT_TRUE(itk::Testing::VerifyImageRegion(image.GetPointer(), read.GetPointer(), region));
+      }
+    }
+
+    // Streamed pieces that do not match the chunks: a piece fills some
+    // chunks in part, and the next one completes them
+    const std::string streamedFileName =
+      directory + "/itkHDF5ImageIOChunkTestStreamed" + (compress ? "Compressed" : "") + ".hdf5";
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(fileName);
+    reader->SetUseStreaming(true);
+    auto streamedImageIO = itk::HDF5ImageIO::New();
+    streamedImageIO->SetChunkSize({ 10, 0, 4 });
+    auto streamedWriter = itk::ImageFileWriter<ImageType>::New();
+    streamedWriter->SetInput(reader->GetOutput());
+    streamedWriter->SetFileName(streamedFileName);
+    streamedWriter->SetImageIO(streamedImageIO);
+    streamedWriter->SetUseCompression(compress);
+    streamedWriter->SetNumberOfStreamDivisions(7);
+    ITK_TRY_EXPECT_NO_EXCEPTION(streamedWriter->Update());
+
+    ImageType::Pointer read;
+    ITK_TRY_EXPECT_NO_EXCEPTION(read = ReadRegion<ImageType>(streamedFileName, largest, 3));
+    ITK_TEST_EXPECT_TRUE(itk::Testing::VerifyImageRegion(image.GetPointer(), read.GetPointer(), largest));
+  }
+
+  // Vector pixels, and the default chunks of one slice
+  using VectorImageType = itk::VectorImage<float, 3>;
+  auto vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(ImageType::SizeType{ { 13, 11, 9 } });
+  vectorImage->SetNumberOfComponentsPerPixel(3);
+  vectorImage->Allocate();
+  for (itk::ImageRegionIterator<VectorImageType> it(vectorImage, vectorImage->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    const VectorImageType::IndexType index = it.GetIndex();
+    VectorImageType::PixelType       pixel(3);
+    pixel[0] = index[0];
+    pixel[1] = index[1] * 0.5f;
+    pixel[2] = index[2] - 4.0f;
+    it.Set(pixel);
+  }
+  const std::string vectorFileName = directory + "/itkHDF5ImageIOChunkTestVector.hdf5";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(vectorImage, vectorFileName, true));
+  const VectorImageType::RegionType vectorRegion({ { 2, 3, 1 } }, { { 9, 5, 7 } });
+  VectorImageType::Pointer          vectorRead;
+  ITK_TRY_EXPECT_NO_EXCEPTION(vectorRead = ReadRegion<VectorImageType>(vectorFileName, vectorRegion, 4));
+  ITK_TEST_EXPECT_TRUE(
+    itk::Testing::VerifyImageRegion(vectorImage.GetPointer(), vectorRead.GetPointer(), vectorRegion));
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -121,6 +121,23 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
   /** @ITKEndGrouping */
+
+  /** Set/Get whether the file is mapped into memory rather than read, when
+   * its ImageIO reports that it holds the pixels exactly as the output
+   * stores them (see ImageIOBase::GetRawPixelDataLocation()), and the region
+   * to read is contiguous in the file. The output then shares the pages of
+   * the file, which are loaded when they are first touched; writing to the
+   * output does not modify the file. The file is read as usual otherwise.
+   * The file must not be truncated or rewritten by other means while the
+   * output holds its pages: touching a page that is no longer backed by the
+   * file raises SIGBUS on POSIX systems. ImageFileWriter copies the pages
+   * into memory before it rewrites a file, so reading a file and writing
+   * the result back to the same file name is safe. The default is off. */
+  /** @ITKStartGrouping */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+  /** @ITKEndGrouping */
 protected:
   ImageFileReader();
   ~ImageFileReader() override = default;
@@ -163,7 +180,15 @@ protected:
 
   bool m_UseStreaming{};
 
+  bool m_UseMemoryMapping{ false };
+
 private:
+  /** Map the file into the buffer of the output, when the pixels of the
+   * actual IO region are stored contiguously and unchanged in the file.
+   * Returns false when the file has to be read instead. */
+  bool
+  MapOutputBuffer();
+
   std::string m_ExceptionMessage{};
 
   // The region that the ImageIO class will return when we ask to
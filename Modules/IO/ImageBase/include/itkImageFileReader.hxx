@@ -24,6 +24,7 @@
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
 #include "itkMetaDataObject.h"
+#include "itkMemoryMappedImportImageContainer.h"
 
 #include "itksys/SystemTools.hxx"
 #include "itkMakeUniqueForOverwrite.h"
@@ -49,6 +50,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::PrintSelf(std::ostream & os,
 
   itkPrintSelfBooleanMacro(UserSpecifiedImageIO);
   itkPrintSelfBooleanMacro(UseStreaming);
+  itkPrintSelfBooleanMacro(UseMemoryMapping);
 
   os << indent << "ExceptionMessage: " << m_ExceptionMessage << std::endl;
   os << indent << "ActualIORegion: " << m_ActualIORegion << std::endl;
@@ -356,6 +358,21 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
 
   const typename TOutputImage::Pointer output = this->GetOutput();
 
+  if (m_UseMemoryMapping && this->MapOutputBuffer())
+  {
+    this->UpdateProgress(1.0f);
+    return;
+  }
+
+  // A buffer mapped by a previous update is not read into
+  using PixelContainerType = typename TOutputImage::PixelContainer;
+  using MappedContainerType = MemoryMappedImportImageContainer<typename PixelContainerType::ElementIdentifier,
+                                                               typename PixelContainerType::Element>;
+  if (dynamic_cast<const MappedContainerType *>(output->GetPixelContainer()) != nullptr)
+  {
+    output->SetPixelContainer(PixelContainerType::New());
+  }
+
   itkDebugMacro("ImageFileReader::GenerateData() \n"
                 << "Allocating the buffer with the EnlargedRequestedRegion \n"
                 << output->GetRequestedRegion() << '\n');
@@ -441,6 +458,77 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
   this->UpdateProgress(1.0f);
 }
 
+template <typename TOutputImage, typename ConvertPixelTraits>
+bool
+ImageFileReader<TOutputImage, ConvertPixelTraits>::MapOutputBuffer()
+{
+  using PixelContainerType = typename TOutputImage::PixelContainer;
+  using ElementType = typename PixelContainerType::Element;
+  using MappedContainerType =
+    MemoryMappedImportImageContainer<typename PixelContainerType::ElementIdentifier, ElementType>;
+
+  const typename TOutputImage::Pointer output = this->GetOutput();
+
+  // The pixels of the file must be those of the output, without conversion
+  const IOComponentEnum ioType = ImageIOBase::MapPixelType<typename ConvertPixelTraits::ComponentType>::CType;
+  std::string           fileName;
+  SizeValueType         dataOffset = 0;
+  if (m_ImageIO->GetComponentType() != ioType ||
+      m_ImageIO->GetNumberOfComponents() != output->GetNumberOfComponentsPerPixel() ||
+      m_ActualIORegion.GetNumberOfPixels() == 0 ||
+      m_ActualIORegion.GetNumberOfPixels() != output->GetRequestedRegion().GetNumberOfPixels() ||
+      !m_ImageIO->GetRawPixelDataLocation(fileName, dataOffset))
+  {
+    return false;
+  }
+
+  // The region must be a single piece of the file: whole along the fastest
+  // dimensions, and of size 1 beyond the first one it does not span
+  const SizeValueType pixelSize = m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents();
+  SizeValueType       stride = pixelSize;
+  bool                spanned = true;
+  for (unsigned int i = 0; i < m_ActualIORegion.GetImageDimension(); ++i)
+  {
+    const SizeValueType dimension = (i < m_ImageIO->GetNumberOfDimensions()) ? m_ImageIO->GetDimensions(i) : 1;
+    const SizeValueType size = m_ActualIORegion.GetSize(i);
+    if (!spanned && size != 1)
+    {
+      return false;
+    }
+    spanned = (size == dimension);
+    dataOffset += static_cast<SizeValueType>(m_ActualIORegion.GetIndex(i)) * stride;
+    stride *= dimension;
+  }
+
+  // The pages of the file must hold aligned elements, and the file all of them
+  const SizeValueType         dataSize = m_ActualIORegion.GetNumberOfPixels() * pixelSize;
+  itksys::SystemTools::Stat_t fileStatus;
+  if (dataOffset % alignof(ElementType) != 0 || dataSize % sizeof(ElementType) != 0 ||
+      itksys::SystemTools::Stat(fileName, &fileStatus) != 0 ||
+      static_cast<SizeValueType>(fileStatus.st_size) < dataOffset + dataSize)
+  {
+    return false;
+  }
+
+  std::unique_ptr<MemoryMappedFileRegion> fileRegion;
+  try
+  {
+    fileRegion = std::make_unique<MemoryMappedFileRegion>(fileName, dataOffset, dataSize);
+  }
+  catch (const ExceptionObject & e)
+  {
+    itkDebugMacro("Reading instead of mapping: " << e.GetDescription());
+    return false;
+  }
+  itkDebugMacro("Mapping " << dataSize << " bytes of " << fileName << " from " << dataOffset);
+
+  auto container = MappedContainerType::New();
+  container->SetFileRegion(std::move(fileRegion));
+  output->SetBufferedRegion(output->GetRequestedRegion());
+  output->SetPixelContainer(container);
+  return true;
+}
+
 template <typename TOutputImage, typename ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>::DoConvertBuffer(const void * inputData, size_t numberOfPixels)
@@ -67,6 +67,12 @@ public:
  * with a suitable suffix (".png", ".jpg", etc) and setting the input
  * to the writer is enough to get the writer to work properly.
  *
+ * When the image is streamed, the pieces can be written asynchronously:
+ * a background thread writes, and compresses, each piece while the
+ * upstream pipeline computes the next one, so that computing and writing
+ * overlap. Each piece waiting to be written is held in a buffer of its
+ * own, and the number of them is bounded.
+ *
  * \sa ImageSeriesReader
  * \sa ImageIOBase
  *
@@ -211,6 +217,25 @@ public:
   itkGetConstReferenceMacro(UseInputMetaDataDictionary, bool);
   itkBooleanMacro(UseInputMetaDataDictionary);
   /** @ITKEndGrouping */
+
+  /** Set/Get whether the pieces of a streamed write are written by a
+   * background thread while the upstream pipeline computes the next ones.
+   * The ImageIO must not be used by anything else during the write.
+   * Default is false. */
+  /** @ITKStartGrouping */
+  itkSetMacro(UseAsynchronousWriting, bool);
+  itkGetConstReferenceMacro(UseAsynchronousWriting, bool);
+  itkBooleanMacro(UseAsynchronousWriting);
+  /** @ITKEndGrouping */
+
+  /** Set/Get the maximum number of computed pieces that wait to be written
+   * when UseAsynchronousWriting is on. The next piece is computed once fewer
+   * pieces wait. Default is 1: one piece is written while the next one is
+   * computed. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(MaximumNumberOfPendingWrites, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstReferenceMacro(MaximumNumberOfPendingWrites, unsigned int);
+  /** @ITKEndGrouping */
 protected:
   ImageFileWriter() = default;
   ~ImageFileWriter() override = default;
@@ -235,6 +260,9 @@ private:
   bool m_UseCompression{ false };
   int  m_CompressionLevel{ -1 };
   bool m_UseInputMetaDataDictionary{ true };
+
+  bool         m_UseAsynchronousWriting{ false };
+  unsigned int m_MaximumNumberOfPendingWrites{ 1 };
 };
 
 
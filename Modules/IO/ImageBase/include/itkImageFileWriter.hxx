@@ -31,7 +31,10 @@
 #include "itkDiffusionTensor3D.h"
 #include "itkMatrix.h"
 #include "itkImageAlgorithm.h"
+#include "itkMemoryMappedFileRegion.h"
 #include <complex>
+#include <deque>
+#include <future>
 
 namespace itk
 {
@@ -256,6 +259,30 @@ ImageFileWriter<TInputImage>::Write()
   unsigned int numDivisions =
     m_ImageIO->GetActualNumberOfSplitsForWriting(m_NumberOfStreamDivisions, pasteIORegion, largestIORegion);
 
+  // When the pieces are written asynchronously, their regions are computed
+  // beforehand, so that meanwhile the ImageIO is only used by the writes
+  std::vector<ImageIORegion> asynchronousIORegions;
+  if (m_UseAsynchronousWriting && numDivisions > 1)
+  {
+    for (unsigned int piece = 0; piece < numDivisions; ++piece)
+    {
+      asynchronousIORegions.push_back(
+        m_ImageIO->GetSplitRegionForWriting(piece, numDivisions, pasteIORegion, largestIORegion));
+    }
+  }
+
+  // The writes that are pending, oldest first. Each one waits for the one
+  // before it, so that the pieces are written one at a time and in order.
+  std::deque<std::shared_future<void>> pendingWrites;
+  unsigned int                         numberOfPiecesWritten = 0;
+
+  const auto finishOldestWrite = [this, &pendingWrites, &numberOfPiecesWritten, &numDivisions] {
+    pendingWrites.front().get();
+    pendingWrites.pop_front();
+    ++numberOfPiecesWritten;
+    this->UpdateProgress(static_cast<float>(numberOfPiecesWritten) / static_cast<float>(numDivisions));
+  };
+
   /**
    * Loop over the number of pieces, execute the upstream pipeline on each
    * piece, and copy the results into the output image.
@@ -265,7 +292,9 @@ ImageFileWriter<TInputImage>::Write()
   {
     // get the actual piece to write
     ImageIORegion streamIORegion =
-      m_ImageIO->GetSplitRegionForWriting(piece, numDivisions, pasteIORegion, largestIORegion);
+      asynchronousIORegions.empty()
+        ? m_ImageIO->GetSplitRegionForWriting(piece, numDivisions, pasteIORegion, largestIORegion)
+        : asynchronousIORegions[piece];
 
     // Check whether the paste region is fully contained inside the
     // largest region or not.
@@ -287,6 +316,10 @@ ImageFileWriter<TInputImage>::Write()
 
     if (piece == 0)
     {
+      // The bytes of the file that a reader of the pipeline may have mapped
+      // into memory must not be lost when the file is rewritten
+      MemoryMappedFileRegion::DetachFile(m_FileName);
+
       // initialize the progress here to mimic the progress behavior of the non
       // streaming filters, where the progress changes only when the other filters
       // are done.
@@ -309,6 +342,36 @@ ImageFileWriter<TInputImage>::Write()
       }
     }
 
+    if (!asynchronousIORegions.empty() && numDivisions > 1)
+    {
+      // The upstream pipeline reuses the input buffer for the next piece:
+      // the piece is written from a copy of its own
+      InputImageRegionType ioRegion;
+      ImageIORegionAdaptor<TInputImage::ImageDimension>::Convert(streamIORegion, ioRegion, largestRegion.GetIndex());
+      const InputImagePointer pieceImage = InputImageType::New();
+      pieceImage->CopyInformation(input);
+      pieceImage->SetBufferedRegion(ioRegion);
+      pieceImage->Allocate();
+      ImageAlgorithm::Copy(input, pieceImage.GetPointer(), ioRegion, ioRegion);
+
+      while (pendingWrites.size() >= m_MaximumNumberOfPendingWrites)
+      {
+        finishOldestWrite();
+      }
+      const std::shared_future<void> previousWrite =
+        pendingWrites.empty() ? std::shared_future<void>() : pendingWrites.back();
+      const auto writePiece = [this, previousWrite, pieceImage, streamIORegion] {
+        if (previousWrite.valid())
+        {
+          previousWrite.get();
+        }
+        m_ImageIO->SetIORegion(streamIORegion);
+        m_ImageIO->Write(pieceImage->GetBufferPointer());
+      };
+      pendingWrites.push_back(std::async(std::launch::async, writePiece).share());
+      continue;
+    }
+
     m_ImageIO->SetIORegion(streamIORegion);
 
     // write the data
@@ -317,6 +380,11 @@ ImageFileWriter<TInputImage>::Write()
     this->UpdateProgress(static_cast<float>(piece + 1) / static_cast<float>(numDivisions));
   }
 
+  while (!pendingWrites.empty())
+  {
+    finishOldestWrite();
+  }
+
   // Notify end event observers
   this->InvokeEvent(EndEvent());
 
@@ -396,6 +464,8 @@ ImageFileWriter<TInputImage>::PrintSelf(std::ostream & os, Indent indent) const
   itkPrintSelfBooleanMacro(UseCompression);
   itkPrintSelfBooleanMacro(UseInputMetaDataDictionary);
   itkPrintSelfBooleanMacro(FactorySpecifiedImageIO);
+  itkPrintSelfBooleanMacro(UseAsynchronousWriting);
+  os << indent << "MaximumNumberOfPendingWrites: " << m_MaximumNumberOfPendingWrites << std::endl;
 }
 } // end namespace itk
 
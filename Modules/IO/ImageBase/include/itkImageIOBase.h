@@ -518,6 +518,18 @@ public:
   virtual void
   Read(void * buffer) = 0;
 
+  /** Location of the pixel data in the file, when the file holds it exactly
+   * as Read() would fill the buffer of the largest possible region:
+   * uncompressed, in one piece, in the byte order of the system and without
+   * any conversion. Returns false otherwise, which is the default. It can be
+   * queried once ReadImageInformation() has been called, and lets readers map
+   * the file into memory instead of reading it. */
+  virtual bool
+  GetRawPixelDataLocation(std::string & itkNotUsed(fileName), SizeValueType & itkNotUsed(offset)) const
+  {
+    return false;
+  }
+
   /*-------- This part of the interfaces deals with writing data ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -179,6 +179,19 @@ public:
   itkBooleanMacro(UseStreaming);
   /** @ITKEndGrouping */
 
+  /** Set/Get the number of files that are read at the same time, on the
+   * multi-threader of the reader. No more files are read at the same time
+   * than the reader has work units. The slices are placed in the output in
+   * the order of the file names whatever the order in which their files are
+   * read. When an ImageIO is set, each file read concurrently is read by a
+   * new ImageIO of its class, created with CreateAnother(), so settings
+   * that are specific to that class are not carried over. The default is
+   * 1: the files are read one after the other with the ImageIO set. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(NumberOfConcurrentReads, unsigned int, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfConcurrentReads, unsigned int);
+  /** @ITKEndGrouping */
+
   /** Set the relative threshold for issuing warnings about non-uniform sampling */
   /** @ITKStartGrouping */
   itkSetMacro(SpacingWarningRelThreshold, double);
@@ -218,6 +231,8 @@ protected:
 
   bool m_UseStreaming{ true };
 
+  unsigned int m_NumberOfConcurrentReads{ 1 };
+
   bool m_SpacingDefined{ false };
 
   double m_SpacingWarningRelThreshold{ 1e-4 };
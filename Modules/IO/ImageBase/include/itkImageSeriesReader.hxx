@@ -25,7 +25,10 @@
 #include "itkMath.h"
 #include "itkProgressReporter.h"
 #include "itkMetaDataObject.h"
+#include "itkMultiThreaderBase.h"
+#include <algorithm> // For min.
 #include <cstddef> // For ptrdiff_t.
+#include <exception> // For exception_ptr.
 #include <iomanip>
 
 namespace itk
@@ -39,6 +42,7 @@ ImageSeriesReader<TOutputImage>::PrintSelf(std::ostream & os, Indent indent) con
   os << indent << "ReverseOrder: " << m_ReverseOrder << std::endl;
   os << indent << "ForceOrthogonalDirection: " << m_ForceOrthogonalDirection << std::endl;
   os << indent << "UseStreaming: " << m_UseStreaming << std::endl;
+  os << indent << "NumberOfConcurrentReads: " << m_NumberOfConcurrentReads << std::endl;
   os << indent << "FileNames:" << std::endl;
   for (const auto & fileName : m_FileNames)
   {
@@ -283,9 +287,6 @@ ImageSeriesReader<TOutputImage>::GenerateData()
   output->SetBufferedRegion(requestedRegion);
   output->Allocate();
 
-  // progress reported on a per slice basis
-  ProgressReporter progress(this, 0, requestedRegion.GetSize(TOutputImage::ImageDimension - 1), 100);
-
   // We utilize the modified time of the output information to
   // know when the meta array needs to be updated, when the output
   // information is updated so should the meta array.
@@ -294,19 +295,26 @@ ImageSeriesReader<TOutputImage>::GenerateData()
   bool needToUpdateMetaDataDictionaryArray =
     this->m_OutputInformationMTime > this->m_MetaDataDictionaryArrayMTime && m_MetaDataDictionaryArrayUpdate;
 
-  typename TOutputImage::InternalPixelType * outputBuffer = output->GetBufferPointer();
-  IndexType                                  sliceStartIndex = requestedRegion.GetIndex();
-  const auto                                 numberOfFiles = static_cast<int>(m_FileNames.size());
-
-  typename TOutputImage::PointType   prevSliceOrigin = output->GetOrigin();
-  typename TOutputImage::SpacingType outputSpacing = output->GetSpacing();
-  double                             maxSpacingDeviation = 0.0;
-  bool                               prevSliceIsValid = false;
-
-  m_InternalMetaDataDictionaries.reserve(static_cast<size_t>(numberOfFiles));
+  const auto numberOfFiles = static_cast<int>(m_FileNames.size());
 
-  for (int i = 0; i != numberOfFiles; ++i)
+  // What is known of each slice once its file has been read. The files
+  // may be read concurrently and in any order; the slices are checked and
+  // their dictionaries gathered in order afterwards.
+  struct SliceInformation
   {
+    bool                             Visited{ false };
+    bool                             Read{ false };
+    bool                             HasDictionary{ false };
+    typename TOutputImage::PointType Origin{};
+    MetaDataDictionary               Dictionary{};
+    std::exception_ptr               Exception{};
+  };
+  std::vector<SliceInformation> slices(static_cast<size_t>(numberOfFiles));
+
+  const bool needToVisitEverySlice = needToUpdateMetaDataDictionaryArray;
+  const auto readSlice = [this, output, &requestedRegion, &sliceRegionToRequest, &validSize, numberOfFiles, &slices](
+                           const int i, ImageIOBase * imageIO, bool visitSlice) {
+    IndexType sliceStartIndex = requestedRegion.GetIndex();
     if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
     {
       sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
@@ -314,13 +322,11 @@ ImageSeriesReader<TOutputImage>::GenerateData()
 
     const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
     const int  iFileName = (m_ReverseOrder ? numberOfFiles - i - 1 : i);
-    bool       nonUniformSampling = false;
-    double     spacingDeviation = 0.0;
 
     // check if we need this slice
-    if (!insideRequestedRegion && !needToUpdateMetaDataDictionaryArray)
+    if (!insideRequestedRegion && !visitSlice)
     {
-      continue;
+      return false;
     }
 
     // configure reader
@@ -329,9 +335,9 @@ ImageSeriesReader<TOutputImage>::GenerateData()
 
     TOutputImage * readerOutput = reader->GetOutput();
 
-    if (m_ImageIO)
+    if (imageIO)
     {
-      reader->SetImageIO(m_ImageIO);
+      reader->SetImageIO(imageIO);
     }
     reader->SetUseStreaming(m_UseStreaming);
     readerOutput->SetRequestedRegion(sliceRegionToRequest);
@@ -383,7 +389,8 @@ ImageSeriesReader<TOutputImage>::GenerateData()
           numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
         const bool bufferDelete = false;
 
-        typename TOutputImage::InternalPixelType * outputSliceBuffer = outputBuffer + numberOfPixelComponentsUpToSlice;
+        typename TOutputImage::InternalPixelType * outputSliceBuffer =
+          output->GetBufferPointer() + numberOfPixelComponentsUpToSlice;
 
         if (strcmp(output->GetNameOfClass(), "VectorImage") == 0)
         {
@@ -422,12 +429,98 @@ ImageSeriesReader<TOutputImage>::GenerateData()
         ImageAlgorithm::Copy(readerOutput, output, sliceRegionToRequest, outRegion);
       }
 
+      slices[i].Read = true;
+      slices[i].Origin = readerOutput->GetOrigin();
+    }
+
+    slices[i].Visited = true;
+    if (visitSlice && reader->GetImageIO())
+    {
+      slices[i].HasDictionary = true;
+      slices[i].Dictionary = reader->GetImageIO()->GetMetaDataDictionary();
+    }
+    return insideRequestedRegion;
+  };
+
+  if (m_NumberOfConcurrentReads <= 1 || numberOfFiles <= 1)
+  {
+    // progress reported on a per slice basis
+    ProgressReporter progress(this, 0, requestedRegion.GetSize(TOutputImage::ImageDimension - 1), 100);
+
+    for (int i = 0; i != numberOfFiles; ++i)
+    {
+      if (readSlice(i, m_ImageIO, needToVisitEverySlice))
+      {
+        progress.CompletedPixel();
+      }
+    }
+  }
+  else
+  {
+    // Each work unit reads its files one after the other, so that no more
+    // than m_NumberOfConcurrentReads files are open at once. An ImageIO
+    // cannot read two files at the same time: each file gets an ImageIO of
+    // the class of the one set, when one is set.
+    MultiThreaderBase * multiThreader = this->GetMultiThreader();
+    multiThreader->SetNumberOfWorkUnits(std::min(
+      { m_NumberOfConcurrentReads, this->GetNumberOfWorkUnits(), static_cast<unsigned int>(numberOfFiles) }));
+    multiThreader->ParallelizeArray(
+      0,
+      static_cast<SizeValueType>(numberOfFiles),
+      [this, &readSlice, &slices, needToVisitEverySlice](SizeValueType i) {
+        ImageIOBase::Pointer imageIO;
+        if (m_ImageIO)
+        {
+          imageIO = dynamic_cast<ImageIOBase *>(m_ImageIO->CreateAnother().GetPointer());
+        }
+        // Not every threader passes the exceptions of its work units on:
+        // the first error, in the order of the files, is thrown afterwards
+        try
+        {
+          readSlice(static_cast<int>(i), imageIO, needToVisitEverySlice);
+        }
+        catch (...)
+        {
+          slices[i].Exception = std::current_exception();
+        }
+      },
+      this);
+
+    for (const SliceInformation & slice : slices)
+    {
+      if (slice.Exception)
+      {
+        std::rethrow_exception(slice.Exception);
+      }
+    }
+  }
+
+  typename TOutputImage::PointType   prevSliceOrigin = output->GetOrigin();
+  typename TOutputImage::SpacingType outputSpacing = output->GetSpacing();
+  double                             maxSpacingDeviation = 0.0;
+  bool                               prevSliceIsValid = false;
+
+  m_InternalMetaDataDictionaries.reserve(static_cast<size_t>(numberOfFiles));
+
+  for (int i = 0; i != numberOfFiles; ++i)
+  {
+    SliceInformation & slice = slices[i];
+    if (!slice.Visited)
+    {
+      continue;
+    }
+
+    bool   nonUniformSampling = false;
+    double spacingDeviation = 0.0;
+
+    if (slice.Read)
+    {
       // verify that slice spacing is the expected one
       // since we can be skipping some slices because they are outside of requested region
       // I am using additional variable
       if (prevSliceIsValid)
       {
-        typename TOutputImage::PointType sliceOrigin = readerOutput->GetOrigin();
+        const typename TOutputImage::PointType & sliceOrigin = slice.Origin;
         using SpacingScalarType = typename TOutputImage::SpacingValueType;
         Vector<SpacingScalarType, TOutputImage::ImageDimension> dirN;
         for (size_t j = 0; j < TOutputImage::ImageDimension; ++j)
@@ -454,24 +547,20 @@ ImageSeriesReader<TOutputImage>::GenerateData()
       }
       else
       {
-        prevSliceOrigin = readerOutput->GetOrigin();
+        prevSliceOrigin = slice.Origin;
         prevSliceIsValid = true;
       }
+    }
 
-      // report progress for read slices
-      progress.CompletedPixel();
-    } // end !insideRequestedRegion
-
-    // Deep copy the MetaDataDictionary into the array
-    if (reader->GetImageIO() && needToUpdateMetaDataDictionaryArray)
+    // Move the MetaDataDictionary into the array
+    if (slice.HasDictionary)
     {
-      MetaDataDictionary newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
       if (nonUniformSampling)
       {
         // slice-specific information
-        EncapsulateMetaData<double>(newDictionary, "ITK_non_uniform_sampling_deviation", spacingDeviation);
+        EncapsulateMetaData<double>(slice.Dictionary, "ITK_non_uniform_sampling_deviation", spacingDeviation);
       }
-      m_InternalMetaDataDictionaries.push_back(std::move(newDictionary));
+      m_InternalMetaDataDictionaries.push_back(std::move(slice.Dictionary));
     }
   } // end per slice loop
 
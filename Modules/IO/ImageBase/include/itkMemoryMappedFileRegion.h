@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedFileRegion_h
+#define itkMemoryMappedFileRegion_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkMacro.h"
+#include "itkIntTypes.h"
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFileRegion
+ * \brief Map a range of the bytes of a file into memory.
+ *
+ * The bytes are mapped copy-on-write: they are loaded from the file when
+ * they are first touched, and they can be modified in memory without
+ * modifying the file. The mapping is released by the destructor.
+ *
+ * The file must not be truncated or rewritten while it is mapped: touching
+ * a page that is no longer backed by the file raises SIGBUS on POSIX
+ * systems. DetachFile() copies the mapped bytes into memory before a file
+ * is rewritten, as ImageFileWriter does for the file it writes.
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT MemoryMappedFileRegion
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedFileRegion);
+
+  /** Map \c size bytes of the file from \c offset, which does not need to be
+   * aligned to the pages of the system. Throws an ExceptionObject when the
+   * file cannot be mapped. */
+  MemoryMappedFileRegion(const std::string & fileName, SizeValueType offset, SizeValueType size);
+
+  ~MemoryMappedFileRegion();
+
+  /** The first mapped byte, at the offset in the file. */
+  void *
+  GetPointer() const
+  {
+    return m_Pointer;
+  }
+
+  /** The number of mapped bytes. */
+  SizeValueType
+  GetSize() const
+  {
+    return m_Size;
+  }
+
+  /** Copy into memory, at the same addresses, the bytes of every region
+   * mapped from a file that writing \c fileName may rewrite: that file, or
+   * a file of the same name with another extension in the same directory,
+   * like the data file of a .mhd or .hdr header. The regions then no longer
+   * depend on their file. Throws an ExceptionObject when a region cannot be
+   * copied. */
+  static void
+  DetachFile(const std::string & fileName);
+
+private:
+  void
+  Detach();
+
+  std::string m_FileName{};
+
+  // The view starts at a page boundary, at or before the offset
+  void *        m_View{ nullptr };
+  SizeValueType m_ViewSize{ 0 };
+  void *        m_Pointer{ nullptr };
+  SizeValueType m_Size{ 0 };
+
+  // Whether the view was copied into memory by Detach()
+  bool m_Detached{ false };
+};
+} // end namespace itk
+
+#endif // itkMemoryMappedFileRegion_h
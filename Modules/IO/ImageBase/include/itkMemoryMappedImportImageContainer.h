@@ -0,0 +1,94 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImportImageContainer_h
+#define itkMemoryMappedImportImageContainer_h
+
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFileRegion.h"
+#include <memory>
+
+namespace itk
+{
+/** \class MemoryMappedImportImageContainer
+ * \brief Image container whose elements are the bytes of a file mapped into memory.
+ *
+ * The container imports the elements of a MemoryMappedFileRegion, which it
+ * owns, so that the file stays mapped for as long as an image holds the
+ * container. The pages are loaded from the file when they are first
+ * touched, and writing to the elements does not modify the file.
+ *
+ * \tparam TElementIdentifier An INTEGRAL type for use in indexing the
+ * imported buffer.
+ *
+ * \tparam TElement The element type stored in the container.
+ *
+ * \ingroup ImageObjects
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+template <typename TElementIdentifier, typename TElement>
+class ITK_TEMPLATE_EXPORT MemoryMappedImportImageContainer : public ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedImportImageContainer);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedImportImageContainer;
+  using Superclass = ImportImageContainer<TElementIdentifier, TElement>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Save the template parameters. */
+  using ElementIdentifier = TElementIdentifier;
+  using Element = TElement;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(MemoryMappedImportImageContainer);
+
+  /** Import the elements of the mapped region, which the container keeps
+   * mapped until it is destroyed. */
+  void
+  SetFileRegion(std::unique_ptr<MemoryMappedFileRegion> fileRegion)
+  {
+    this->SetImportPointer(static_cast<TElement *>(fileRegion->GetPointer()),
+                           static_cast<TElementIdentifier>(fileRegion->GetSize() / sizeof(TElement)),
+                           false);
+    m_FileRegion = std::move(fileRegion);
+  }
+
+  /** The mapped region, or null when none was set. */
+  const MemoryMappedFileRegion *
+  GetFileRegion() const
+  {
+    return m_FileRegion.get();
+  }
+
+protected:
+  MemoryMappedImportImageContainer() = default;
+  ~MemoryMappedImportImageContainer() override = default;
+
+private:
+  // Destroyed before the superclass, which does not manage the elements
+  std::unique_ptr<MemoryMappedFileRegion> m_FileRegion{};
+};
+} // end namespace itk
+
+#endif // itkMemoryMappedImportImageContainer_h
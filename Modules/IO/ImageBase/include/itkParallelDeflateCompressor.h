@@ -0,0 +1,260 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelDeflateCompressor_h
+#define itkParallelDeflateCompressor_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+#include "itkMultiThreaderBase.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class ParallelDeflateCompressorEnums
+ * \brief Contains all enum classes used by ParallelDeflateCompressor class.
+ * \ingroup ITKIOImageBase
+ */
+class ParallelDeflateCompressorEnums
+{
+public:
+  /**
+   * \ingroup ITKIOImageBase
+   * Container wrapped around the deflate data: a gzip member (RFC 1952) or
+   * a zlib stream (RFC 1950).
+   */
+  enum class StreamFormat : uint8_t
+  {
+    Gzip,
+    Zlib
+  };
+};
+// Define how to print enumeration
+extern ITKIOImageBase_EXPORT std::ostream &
+                             operator<<(std::ostream & out, const ParallelDeflateCompressorEnums::StreamFormat value);
+
+/** \class ParallelDeflateCompressor
+ * \brief Compress a byte stream with deflate, using several threads.
+ *
+ * The input is cut into blocks of BlockSize bytes that are deflated
+ * independently by the work units of the multi-threader. Each block is
+ * primed with the last 32 KiB of the input that precedes it, so the loss in
+ * compression ratio with respect to a single deflate stream is small. All
+ * blocks but the last end on a byte boundary (sync flush), which makes their
+ * concatenation a single valid deflate stream. The checksums of the blocks
+ * are computed concurrently as well and then combined.
+ *
+ * The result is a standard gzip member or zlib stream that any inflater
+ * reads, but it is not byte-for-byte identical to the output of a single
+ * threaded zlib at the same compression level.
+ *
+ * Usage:
+ * \code
+ *   auto compressor = itk::ParallelDeflateCompressor::New();
+ *   compressor->SetCompressionLevel(6);
+ *   compressor->Begin(outputStream);
+ *   compressor->Write(header, headerSize);
+ *   compressor->Write(buffer, bufferSize);
+ *   compressor->End();
+ * \endcode
+ *
+ * Write() may be called any number of times between Begin() and End(); it
+ * only returns once the complete blocks it received have been compressed
+ * and handed to the output, so at most about 4 blocks per work unit are
+ * held in memory at any time.
+ *
+ * With IndependentBlocks on, the blocks are not primed, so that each one can
+ * be inflated on its own, and GetBlockOffsets() tells where they start in
+ * the output. A gzip stream is then written as one gzip member per block,
+ * which gzip readers concatenate transparently. The header of each member
+ * has an extra field with subfield ID "IT" holding two little endian 32-bit
+ * values, the size of the member and the size of its uncompressed data, so
+ * that the blocks can be located by hopping from header to header (see
+ * ParallelInflateReader). A zlib stream stays a single stream, with a full
+ * flush point after each block.
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT ParallelDeflateCompressor : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ParallelDeflateCompressor);
+
+  /** Standard class type aliases. */
+  using Self = ParallelDeflateCompressor;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(ParallelDeflateCompressor);
+
+  using StreamFormatEnum = ParallelDeflateCompressorEnums::StreamFormat;
+
+  /** Receives the compressed bytes, in order. */
+  using OutputFunctionType = std::function<void(const char *, SizeValueType)>;
+
+  /** Container written around the deflate data. The default is Gzip. */
+  /** @ITKStartGrouping */
+  itkSetEnumMacro(StreamFormat, StreamFormatEnum);
+  itkGetConstMacro(StreamFormat, StreamFormatEnum);
+  /** @ITKEndGrouping */
+
+  /** Deflate compression level, from 0 (stored) to 9. The default is 6,
+   * the zlib default. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(CompressionLevel, int, 0, 9);
+  itkGetConstMacro(CompressionLevel, int);
+  /** @ITKEndGrouping */
+
+  /** Number of input bytes compressed by one work unit. Smaller blocks
+   * balance the load better, larger blocks compress slightly better. The
+   * default is 128 KiB, and the block size may not be smaller than the
+   * 32 KiB deflate window. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(BlockSize, SizeValueType, 32768, SizeValueType{ 1 } << 30);
+  itkGetConstMacro(BlockSize, SizeValueType);
+  /** @ITKEndGrouping */
+
+  /** Number of work units used to compress the blocks. The default is the
+   * global default number of threads of the multi-threader. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+  /** @ITKEndGrouping */
+
+  /** Compress the blocks independently of each other. The default is false. */
+  /** @ITKStartGrouping */
+  itkSetMacro(IndependentBlocks, bool);
+  itkGetConstMacro(IndependentBlocks, bool);
+  itkBooleanMacro(IndependentBlocks);
+  /** @ITKEndGrouping */
+
+  /** Start a new compressed stream, written to \c os or handed to \c output.
+   * The header of the container is written immediately. */
+  /** @ITKStartGrouping */
+  void
+  Begin(std::ostream & os);
+  void
+  Begin(const OutputFunctionType & output);
+  /** @ITKEndGrouping */
+
+  /** Append \c size bytes of \c buffer to the stream. */
+  void
+  Write(const void * buffer, SizeValueType size);
+
+  /** Compress the remaining input and write the trailer of the container. */
+  void
+  End();
+
+  /** Compress \c size bytes of \c buffer as one complete stream. */
+  void
+  Compress(const void * buffer, SizeValueType size, std::ostream & os);
+
+  /** Number of bytes given to Write() since Begin(). */
+  itkGetConstMacro(NumberOfInputBytes, SizeValueType);
+
+  /** Number of bytes written to the output since Begin(), including the
+   * header and trailer of the container. */
+  itkGetConstMacro(NumberOfOutputBytes, SizeValueType);
+
+  /** Offsets in the output of the non-empty blocks compressed since Begin(),
+   * when IndependentBlocks is on. Block \c i holds the input bytes from
+   * <tt>i * BlockSize</tt>: for a gzip stream the offset is that of its
+   * member, for a zlib stream that of its deflate data. */
+  const std::vector<SizeValueType> &
+  GetBlockOffsets() const
+  {
+    return m_BlockOffsets;
+  }
+
+protected:
+  ParallelDeflateCompressor();
+  ~ParallelDeflateCompressor() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  struct BlockType
+  {
+    const char *  input;
+    SizeValueType inputSize;
+    const char *  dictionary;
+    SizeValueType dictionarySize;
+    std::string   output;
+    unsigned long check;
+    int           status;
+  };
+
+  /** Deflate and checksum one block; safe to call from a work unit. */
+  void
+  CompressBlock(BlockType & block, bool finalBlock) const;
+
+  /** Compress the blocks concurrently and write them out in order. */
+  void
+  CompressBlocks(std::vector<BlockType> & blocks, bool finalBlock);
+
+  void
+  WriteOutput(const char * data, SizeValueType size);
+
+  void
+  WriteHeader();
+
+  void
+  WriteTrailer();
+
+  /** Write a gzip header, with the extra field of an independent member
+   * unless \c member is null. */
+  void
+  WriteGzipHeader(const BlockType * member);
+
+  void
+  WriteGzipTrailer(unsigned long check, SizeValueType inputSize);
+
+  StreamFormatEnum m_StreamFormat{ StreamFormatEnum::Gzip };
+  int              m_CompressionLevel{ 6 };
+  SizeValueType    m_BlockSize{ 131072 };
+  ThreadIdType     m_NumberOfWorkUnits{ 1 };
+  bool             m_IndependentBlocks{ false };
+
+  MultiThreaderBase::Pointer m_MultiThreader{};
+  OutputFunctionType         m_Output{};
+  bool                       m_Active{ false };
+
+  /** Input received by Write() that does not fill a block yet. */
+  std::string m_PendingInput{};
+
+  /** Last 32 KiB of the input that has been compressed. */
+  std::string m_History{};
+
+  unsigned long m_Check{ 0 };
+  SizeValueType m_NumberOfInputBytes{ 0 };
+  SizeValueType m_NumberOfOutputBytes{ 0 };
+
+  std::vector<SizeValueType> m_BlockOffsets{};
+};
+} // namespace itk
+
+#endif // itkParallelDeflateCompressor_h
@@ -0,0 +1,146 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelInflateReader_h
+#define itkParallelInflateReader_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+#include "itkMultiThreaderBase.h"
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class ParallelInflateReader
+ * \brief Read byte ranges of a compressed file made of independent blocks.
+ *
+ * A file compressed by ParallelDeflateCompressor with IndependentBlocks on
+ * is a sequence of blocks that can each be inflated on their own. Given the
+ * location of the blocks, this class reads any range of the uncompressed
+ * data by inflating only the blocks that overlap it, concurrently on the
+ * work units of the multi-threader.
+ *
+ * The blocks of a gzip file are found by ReadGzipMemberIndex(), which hops
+ * from one member header to the next. The blocks of other containers, such
+ * as the full flush points of a zlib stream, are given to SetRawDeflateBlocks().
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT ParallelInflateReader : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ParallelInflateReader);
+
+  /** Standard class type aliases. */
+  using Self = ParallelInflateReader;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(ParallelInflateReader);
+
+  /** Location of a block in the file and in the uncompressed data. */
+  struct BlockType
+  {
+    SizeValueType compressedOffset;
+    SizeValueType compressedSize;
+    SizeValueType uncompressedOffset;
+    SizeValueType uncompressedSize;
+  };
+  using BlockListType = std::vector<BlockType>;
+
+  /** Range of the uncompressed data, and where to copy it. */
+  struct RangeType
+  {
+    SizeValueType offset;
+    SizeValueType size;
+    void *        destination;
+  };
+
+  /** Name of the compressed file. */
+  /** @ITKStartGrouping */
+  itkSetStringMacro(FileName);
+  itkGetStringMacro(FileName);
+  /** @ITKEndGrouping */
+
+  /** Number of work units used to inflate the blocks. The default is the
+   * global default number of threads of the multi-threader. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+  /** @ITKEndGrouping */
+
+  /** Locate the members of a gzip file written with independent blocks.
+   * Returns false, and leaves no blocks, if any member lacks the extra
+   * field that gives its size. */
+  bool
+  ReadGzipMemberIndex();
+
+  /** Set the blocks of raw deflate data. They must be contiguous in the
+   * uncompressed data, starting from 0. */
+  void
+  SetRawDeflateBlocks(const BlockListType & blocks);
+
+  /** The blocks of the file, empty until they have been located. */
+  const BlockListType &
+  GetBlocks() const
+  {
+    return m_Blocks;
+  }
+
+  /** Size of the uncompressed data. */
+  SizeValueType
+  GetUncompressedSize() const;
+
+  /** Read \c size bytes from \c offset of the uncompressed data. */
+  void
+  Read(void * buffer, SizeValueType offset, SizeValueType size);
+
+  /** Read several ranges that do not overlap. A block that holds parts of
+   * several ranges is only inflated once. */
+  void
+  Read(std::vector<RangeType> ranges);
+
+protected:
+  ParallelInflateReader();
+  ~ParallelInflateReader() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Inflate one block; safe to call from a work unit. */
+  bool
+  InflateBlock(const BlockType & block, const std::string & compressed, std::string & output) const;
+
+  std::string   m_FileName{};
+  ThreadIdType  m_NumberOfWorkUnits{ 1 };
+  BlockListType m_Blocks{};
+  bool          m_GzipMembers{ false };
+
+  MultiThreaderBase::Pointer m_MultiThreader{};
+};
+} // namespace itk
+
+#endif // itkParallelInflateReader_h
@@ -15,10 +15,13 @@ itk_module(
   ENABLE_SHARED
   DEPENDS
     ITKCommon
+  PRIVATE_DEPENDS
+    ITKZLIB
   TEST_DEPENDS
     ITKTestKernel
     ITKIOGDCM
     ITKIOMeta
     ITKImageIntensity
+    ITKZLIB
   DESCRIPTION "${DOCUMENTATION}"
 )
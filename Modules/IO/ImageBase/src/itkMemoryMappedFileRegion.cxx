@@ -0,0 +1,192 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryMappedFileRegion.h"
+#include "itkMakeUniqueForOverwrite.h"
+#include "itksys/SystemTools.hxx"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#  include "itkWindows.h"
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+namespace
+{
+// The regions that are mapped, so that they can be detached from a file
+// before it is rewritten
+std::mutex                            mappedRegionsMutex;
+std::vector<MemoryMappedFileRegion *> mappedRegions;
+
+// The file name without its last extension, as a full path
+std::string
+GetFileStem(const std::string & fileName)
+{
+  const std::string fullPath = itksys::SystemTools::CollapseFullPath(fileName);
+  return itksys::SystemTools::GetFilenamePath(fullPath) + '/' +
+         itksys::SystemTools::GetFilenameWithoutLastExtension(fullPath);
+}
+} // namespace
+
+MemoryMappedFileRegion::MemoryMappedFileRegion(const std::string & fileName, SizeValueType offset, SizeValueType size)
+  : m_FileName(itksys::SystemTools::CollapseFullPath(fileName))
+{
+  if (size == 0)
+  {
+    itkGenericExceptionMacro("Cannot map an empty region of " << fileName << '.');
+  }
+
+#ifdef _WIN32
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const SizeValueType viewOffset = offset - offset % systemInfo.dwAllocationGranularity;
+  m_ViewSize = size + (offset - viewOffset);
+
+  const std::wstring path = itksys::SystemTools::ConvertToWindowsExtendedPath(fileName.c_str());
+  const HANDLE       file = CreateFileW(
+    path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    itkGenericExceptionMacro("Cannot open " << fileName << " for mapping.");
+  }
+  // The view keeps the mapping, and the mapping the file, open
+  const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr)
+  {
+    itkGenericExceptionMacro("Cannot map " << fileName << '.');
+  }
+  m_View = MapViewOfFile(mapping,
+                         FILE_MAP_COPY,
+                         static_cast<DWORD>(static_cast<uint64_t>(viewOffset) >> 32),
+                         static_cast<DWORD>(viewOffset & 0xFFFFFFFF),
+                         static_cast<SIZE_T>(m_ViewSize));
+  CloseHandle(mapping);
+  if (m_View == nullptr)
+  {
+    itkGenericExceptionMacro("Cannot map " << size << " bytes of " << fileName << " from " << offset << '.');
+  }
+#else
+  const auto          pageSize = static_cast<SizeValueType>(sysconf(_SC_PAGESIZE));
+  const SizeValueType viewOffset = offset - offset % pageSize;
+  m_ViewSize = size + (offset - viewOffset);
+
+  const int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    itkGenericExceptionMacro("Cannot open " << fileName << " for mapping: "
+                                            << itksys::SystemTools::GetLastSystemError());
+  }
+  // Private pages, so that writing to them does not write to the file
+  void * view = mmap(nullptr,
+                     static_cast<size_t>(m_ViewSize),
+                     PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE,
+                     file,
+                     static_cast<off_t>(viewOffset));
+  close(file);
+  if (view == MAP_FAILED)
+  {
+    itkGenericExceptionMacro("Cannot map " << size << " bytes of " << fileName << " from " << offset << ": "
+                                           << itksys::SystemTools::GetLastSystemError());
+  }
+  m_View = view;
+#endif
+
+  m_Pointer = static_cast<char *>(m_View) + (offset - viewOffset);
+  m_Size = size;
+
+  const std::lock_guard<std::mutex> lock(mappedRegionsMutex);
+  mappedRegions.push_back(this);
+}
+
+MemoryMappedFileRegion::~MemoryMappedFileRegion()
+{
+  {
+    const std::lock_guard<std::mutex> lock(mappedRegionsMutex);
+    mappedRegions.erase(std::find(mappedRegions.begin(), mappedRegions.end(), this));
+  }
+
+#ifdef _WIN32
+  if (m_Detached)
+  {
+    VirtualFree(m_View, 0, MEM_RELEASE);
+  }
+  else
+  {
+    UnmapViewOfFile(m_View);
+  }
+#else
+  munmap(m_View, static_cast<size_t>(m_ViewSize));
+#endif
+}
+
+void
+MemoryMappedFileRegion::DetachFile(const std::string & fileName)
+{
+  const std::lock_guard<std::mutex> lock(mappedRegionsMutex);
+  if (mappedRegions.empty())
+  {
+    return;
+  }
+  const std::string stem = GetFileStem(fileName);
+  for (MemoryMappedFileRegion * region : mappedRegions)
+  {
+    if (!region->m_Detached && GetFileStem(region->m_FileName) == stem)
+    {
+      region->Detach();
+    }
+  }
+}
+
+void
+MemoryMappedFileRegion::Detach()
+{
+  // The view is replaced by anonymous memory at the same address, so that
+  // the pointers to the bytes stay valid
+  const auto bytes = make_unique_for_overwrite<char[]>(m_ViewSize);
+  std::memcpy(bytes.get(), m_View, m_ViewSize);
+#ifdef _WIN32
+  UnmapViewOfFile(m_View);
+  if (VirtualAlloc(m_View, static_cast<SIZE_T>(m_ViewSize), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE) == nullptr)
+  {
+    itkGenericExceptionMacro("Cannot copy the bytes mapped from " << m_FileName << " into memory.");
+  }
+#else
+  if (mmap(m_View,
+           static_cast<size_t>(m_ViewSize),
+           PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+           -1,
+           0) == MAP_FAILED)
+  {
+    itkGenericExceptionMacro("Cannot copy the bytes mapped from " << m_FileName << " into memory: "
+                                                                  << itksys::SystemTools::GetLastSystemError());
+  }
+#endif
+  std::memcpy(m_View, bytes.get(), m_ViewSize);
+  m_Detached = true;
+}
+} // end namespace itk
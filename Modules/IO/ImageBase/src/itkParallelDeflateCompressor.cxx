@@ -0,0 +1,415 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkParallelDeflateCompressor.h"
+#include "itk_zlib.h"
+
+#include <algorithm>
+
+namespace itk
+{
+namespace
+{
+// Size of the deflate window, and of the dictionary each block is primed with.
+constexpr SizeValueType DeflateWindowSize = 32768;
+} // namespace
+
+ParallelDeflateCompressor::ParallelDeflateCompressor()
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
+{}
+
+void
+ParallelDeflateCompressor::Begin(std::ostream & os)
+{
+  this->Begin([this, &os](const char * data, SizeValueType size) {
+    os.write(data, static_cast<std::streamsize>(size));
+    if (os.fail())
+    {
+      itkExceptionMacro("Failed to write " << size << " bytes of compressed data.");
+    }
+  });
+}
+
+void
+ParallelDeflateCompressor::Begin(const OutputFunctionType & output)
+{
+  if (!output)
+  {
+    itkExceptionMacro("No output function was given.");
+  }
+
+  m_Output = output;
+  m_Active = true;
+  m_PendingInput.clear();
+  m_History.clear();
+  m_Check = (m_StreamFormat == StreamFormatEnum::Gzip) ? crc32(0L, nullptr, 0) : adler32(0L, nullptr, 0);
+  m_NumberOfInputBytes = 0;
+  m_NumberOfOutputBytes = 0;
+  m_BlockOffsets.clear();
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+
+  this->WriteHeader();
+}
+
+void
+ParallelDeflateCompressor::Write(const void * buffer, SizeValueType size)
+{
+  if (!m_Active)
+  {
+    itkExceptionMacro("Write() called before Begin().");
+  }
+
+  const auto * data = static_cast<const char *>(buffer);
+  m_NumberOfInputBytes += size;
+
+  // Complete blocks are compressed in batches, straight from the buffer of
+  // the caller; only an incomplete block is copied and kept for later.
+  const SizeValueType maximumNumberOfBlocks = 4 * SizeValueType{ m_NumberOfWorkUnits };
+  while (size > 0)
+  {
+    std::vector<BlockType> blocks;
+    if (!m_PendingInput.empty())
+    {
+      const SizeValueType count = std::min(size, m_BlockSize - m_PendingInput.size());
+      m_PendingInput.append(data, count);
+      data += count;
+      size -= count;
+      if (m_PendingInput.size() < m_BlockSize)
+      {
+        return;
+      }
+      blocks.push_back(BlockType{ m_PendingInput.data(), m_BlockSize, nullptr, 0, {}, 0, Z_OK });
+    }
+    while (blocks.size() < maximumNumberOfBlocks && size >= m_BlockSize)
+    {
+      blocks.push_back(BlockType{ data, m_BlockSize, nullptr, 0, {}, 0, Z_OK });
+      data += m_BlockSize;
+      size -= m_BlockSize;
+    }
+    if (blocks.empty())
+    {
+      break;
+    }
+    this->CompressBlocks(blocks, false);
+    m_PendingInput.clear();
+  }
+
+  m_PendingInput.append(data, size);
+}
+
+void
+ParallelDeflateCompressor::End()
+{
+  if (!m_Active)
+  {
+    itkExceptionMacro("End() called before Begin().");
+  }
+
+  // The final block may be empty, it then only holds the end of the stream.
+  std::vector<BlockType> blocks;
+  blocks.push_back(BlockType{ m_PendingInput.data(), m_PendingInput.size(), nullptr, 0, {}, 0, Z_OK });
+  this->CompressBlocks(blocks, true);
+  this->WriteTrailer();
+
+  m_Active = false;
+  m_Output = nullptr;
+  m_PendingInput.clear();
+  m_PendingInput.shrink_to_fit();
+  m_History.clear();
+  m_History.shrink_to_fit();
+}
+
+void
+ParallelDeflateCompressor::Compress(const void * buffer, SizeValueType size, std::ostream & os)
+{
+  this->Begin(os);
+  this->Write(buffer, size);
+  this->End();
+}
+
+void
+ParallelDeflateCompressor::CompressBlocks(std::vector<BlockType> & blocks, bool finalBlock)
+{
+  // Unless the blocks are independent, each block is primed with the input
+  // that precedes it. All the blocks but the final one are complete, and
+  // larger than the window.
+  if (!m_IndependentBlocks)
+  {
+    blocks.front().dictionary = m_History.data();
+    blocks.front().dictionarySize = m_History.size();
+    for (size_t i = 1; i < blocks.size(); ++i)
+    {
+      blocks[i].dictionary = blocks[i - 1].input + blocks[i - 1].inputSize - DeflateWindowSize;
+      blocks[i].dictionarySize = DeflateWindowSize;
+    }
+  }
+
+  const SizeValueType numberOfBlocks = blocks.size();
+  if (numberOfBlocks > 1 && m_NumberOfWorkUnits > 1)
+  {
+    m_MultiThreader->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [this, &blocks, numberOfBlocks, finalBlock](SizeValueType i) {
+        this->CompressBlock(blocks[i], finalBlock && i + 1 == numberOfBlocks);
+      },
+      nullptr);
+  }
+  else
+  {
+    for (SizeValueType i = 0; i < numberOfBlocks; ++i)
+    {
+      this->CompressBlock(blocks[i], finalBlock && i + 1 == numberOfBlocks);
+    }
+  }
+
+  for (const BlockType & block : blocks)
+  {
+    if (block.status != Z_OK)
+    {
+      m_Active = false;
+      itkExceptionMacro("Deflate failed with zlib error " << block.status << '.');
+    }
+  }
+
+  const bool gzipMembers = m_IndependentBlocks && m_StreamFormat == StreamFormatEnum::Gzip;
+  for (const BlockType & block : blocks)
+  {
+    // An empty member is only needed when the whole stream is empty
+    if (gzipMembers && block.inputSize == 0 && m_NumberOfOutputBytes > 0)
+    {
+      continue;
+    }
+    if (m_IndependentBlocks && block.inputSize > 0)
+    {
+      m_BlockOffsets.push_back(m_NumberOfOutputBytes);
+    }
+
+    if (gzipMembers)
+    {
+      this->WriteGzipHeader(&block);
+      this->WriteOutput(block.output.data(), block.output.size());
+      this->WriteGzipTrailer(block.check, block.inputSize);
+    }
+    else
+    {
+      this->WriteOutput(block.output.data(), block.output.size());
+      const auto length = static_cast<z_off_t>(block.inputSize);
+      m_Check = (m_StreamFormat == StreamFormatEnum::Gzip) ? crc32_combine(m_Check, block.check, length)
+                                                           : adler32_combine(m_Check, block.check, length);
+    }
+  }
+
+  if (!finalBlock && !m_IndependentBlocks)
+  {
+    const BlockType & lastBlock = blocks.back();
+    m_History.assign(lastBlock.input + lastBlock.inputSize - DeflateWindowSize, DeflateWindowSize);
+  }
+}
+
+void
+ParallelDeflateCompressor::CompressBlock(BlockType & block, bool finalBlock) const
+{
+  const auto * input = reinterpret_cast<const Bytef *>(block.input);
+  const auto   inputSize = static_cast<uInt>(block.inputSize);
+
+  block.check = (m_StreamFormat == StreamFormatEnum::Gzip) ? crc32(crc32(0L, nullptr, 0), input, inputSize)
+                                                           : adler32(adler32(0L, nullptr, 0), input, inputSize);
+
+  // Raw deflate, the container is written around the blocks.
+  z_stream stream{};
+  block.status = deflateInit2(&stream, m_CompressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+  if (block.status != Z_OK)
+  {
+    return;
+  }
+  if (block.dictionarySize > 0)
+  {
+    block.status = deflateSetDictionary(
+      &stream, reinterpret_cast<const Bytef *>(block.dictionary), static_cast<uInt>(block.dictionarySize));
+  }
+
+  if (block.status == Z_OK)
+  {
+    // The bound covers the end of the stream; the sync flush marker is smaller.
+    block.output.resize(deflateBound(&stream, inputSize) + 16);
+    stream.next_in = const_cast<Bytef *>(input);
+    stream.avail_in = inputSize;
+    stream.next_out = reinterpret_cast<Bytef *>(&block.output[0]);
+    stream.avail_out = static_cast<uInt>(block.output.size());
+
+    // Independent blocks are either complete gzip members or end on a full
+    // flush point, which resets the history of the compressor.
+    int flush = m_IndependentBlocks ? Z_FULL_FLUSH : Z_SYNC_FLUSH;
+    if (finalBlock || (m_IndependentBlocks && m_StreamFormat == StreamFormatEnum::Gzip))
+    {
+      flush = Z_FINISH;
+    }
+    for (;;)
+    {
+      block.status = deflate(&stream, flush);
+      if (flush == Z_FINISH ? block.status == Z_STREAM_END : (block.status == Z_OK && stream.avail_out > 0))
+      {
+        block.status = Z_OK;
+        break;
+      }
+      if (block.status != Z_OK && block.status != Z_BUF_ERROR)
+      {
+        break;
+      }
+      const size_t used = block.output.size() - stream.avail_out;
+      block.output.resize(2 * block.output.size());
+      stream.next_out = reinterpret_cast<Bytef *>(&block.output[used]);
+      stream.avail_out = static_cast<uInt>(block.output.size() - used);
+    }
+    block.output.resize(block.output.size() - stream.avail_out);
+  }
+  deflateEnd(&stream);
+}
+
+void
+ParallelDeflateCompressor::WriteOutput(const char * data, SizeValueType size)
+{
+  if (size > 0)
+  {
+    m_Output(data, size);
+    m_NumberOfOutputBytes += size;
+  }
+}
+
+void
+ParallelDeflateCompressor::WriteHeader()
+{
+  if (m_StreamFormat == StreamFormatEnum::Gzip)
+  {
+    // Independent blocks each have their own gzip member
+    if (!m_IndependentBlocks)
+    {
+      this->WriteGzipHeader(nullptr);
+    }
+  }
+  else
+  {
+    // 32 KiB window, no preset dictionary
+    const unsigned int compressionMethod = 0x78;
+    const unsigned int compressionLevel =
+      (m_CompressionLevel < 2) ? 0 : ((m_CompressionLevel < 6) ? 1 : ((m_CompressionLevel == 6) ? 2 : 3));
+    unsigned int flags = compressionLevel << 6;
+    flags += 31 - (compressionMethod * 256 + flags) % 31;
+    const unsigned char header[2] = { static_cast<unsigned char>(compressionMethod),
+                                      static_cast<unsigned char>(flags) };
+    this->WriteOutput(reinterpret_cast<const char *>(header), sizeof(header));
+  }
+}
+
+void
+ParallelDeflateCompressor::WriteTrailer()
+{
+  if (m_StreamFormat == StreamFormatEnum::Gzip)
+  {
+    if (!m_IndependentBlocks)
+    {
+      this->WriteGzipTrailer(m_Check, m_NumberOfInputBytes);
+    }
+  }
+  else
+  {
+    // Adler-32, big endian
+    unsigned char trailer[4];
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+      trailer[i] = static_cast<unsigned char>((m_Check >> (8 * (3 - i))) & 0xff);
+    }
+    this->WriteOutput(reinterpret_cast<const char *>(trailer), 4);
+  }
+}
+
+void
+ParallelDeflateCompressor::WriteGzipHeader(const BlockType * member)
+{
+  // No file name, no modification time, unknown operating system
+  const unsigned char extraFlags = (m_CompressionLevel == 9) ? 2 : ((m_CompressionLevel < 2) ? 4 : 0);
+  unsigned char       header[24] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, extraFlags, 255 };
+  if (member == nullptr)
+  {
+    this->WriteOutput(reinterpret_cast<const char *>(header), 10);
+    return;
+  }
+
+  // Extra field with the "IT" subfield: size of the member and of its input
+  const auto memberSize = static_cast<uint32_t>(sizeof(header) + member->output.size() + 8);
+  const auto inputSize = static_cast<uint32_t>(member->inputSize);
+  header[3] = 0x04;
+  header[10] = 12;
+  header[12] = 'I';
+  header[13] = 'T';
+  header[14] = 8;
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    header[16 + i] = static_cast<unsigned char>((memberSize >> (8 * i)) & 0xff);
+    header[20 + i] = static_cast<unsigned char>((inputSize >> (8 * i)) & 0xff);
+  }
+  this->WriteOutput(reinterpret_cast<const char *>(header), sizeof(header));
+}
+
+void
+ParallelDeflateCompressor::WriteGzipTrailer(unsigned long check, SizeValueType inputSize)
+{
+  // CRC-32 and size of the input modulo 2^32, little endian
+  unsigned char trailer[8];
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    trailer[i] = static_cast<unsigned char>((check >> (8 * i)) & 0xff);
+    trailer[4 + i] = static_cast<unsigned char>((inputSize >> (8 * i)) & 0xff);
+  }
+  this->WriteOutput(reinterpret_cast<const char *>(trailer), 8);
+}
+
+void
+ParallelDeflateCompressor::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "StreamFormat: " << m_StreamFormat << std::endl;
+  os << indent << "CompressionLevel: " << m_CompressionLevel << std::endl;
+  os << indent << "BlockSize: " << m_BlockSize << std::endl;
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+  itkPrintSelfBooleanMacro(IndependentBlocks);
+  itkPrintSelfObjectMacro(MultiThreader);
+  itkPrintSelfBooleanMacro(Active);
+  os << indent << "NumberOfInputBytes: " << m_NumberOfInputBytes << std::endl;
+  os << indent << "NumberOfOutputBytes: " << m_NumberOfOutputBytes << std::endl;
+}
+
+std::ostream &
+operator<<(std::ostream & out, const ParallelDeflateCompressorEnums::StreamFormat value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case ParallelDeflateCompressorEnums::StreamFormat::Gzip:
+        return "itk::ParallelDeflateCompressorEnums::StreamFormat::Gzip";
+      case ParallelDeflateCompressorEnums::StreamFormat::Zlib:
+        return "itk::ParallelDeflateCompressorEnums::StreamFormat::Zlib";
+      default:
+        return "INVALID VALUE FOR itk::ParallelDeflateCompressorEnums::StreamFormat";
+    }
+  }();
+}
+} // namespace itk
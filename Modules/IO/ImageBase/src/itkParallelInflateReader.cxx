@@ -0,0 +1,281 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkParallelInflateReader.h"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace itk
+{
+namespace
+{
+// Header of an independent gzip member: the 10 byte gzip header, the length
+// of the extra field, and the "IT" subfield with the sizes of the member.
+constexpr unsigned int MemberHeaderSize = 24;
+
+uint32_t
+ReadLittleEndian32(const unsigned char * bytes)
+{
+  return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+         (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+} // namespace
+
+ParallelInflateReader::ParallelInflateReader()
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
+{}
+
+bool
+ParallelInflateReader::ReadGzipMemberIndex()
+{
+  m_Blocks.clear();
+  m_GzipMembers = true;
+
+  std::ifstream file(m_FileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+  {
+    itkExceptionMacro("Cannot open " << m_FileName << " for reading.");
+  }
+  file.seekg(0, std::ios::end);
+  const auto fileSize = static_cast<SizeValueType>(file.tellg());
+
+  BlockListType blocks;
+  SizeValueType offset = 0;
+  SizeValueType uncompressedOffset = 0;
+  while (offset < fileSize)
+  {
+    unsigned char header[MemberHeaderSize];
+    file.seekg(static_cast<std::streamoff>(offset));
+    if (!file.read(reinterpret_cast<char *>(header), MemberHeaderSize))
+    {
+      return false;
+    }
+    // gzip, deflate, only an extra field of 12 bytes holding the "IT" subfield
+    if (header[0] != 0x1f || header[1] != 0x8b || header[2] != Z_DEFLATED || header[3] != 0x04 || header[10] != 12 ||
+        header[11] != 0 || header[12] != 'I' || header[13] != 'T' || header[14] != 8 || header[15] != 0)
+    {
+      return false;
+    }
+    const SizeValueType memberSize = ReadLittleEndian32(header + 16);
+    const SizeValueType uncompressedSize = ReadLittleEndian32(header + 20);
+    if (memberSize < MemberHeaderSize + 8 || offset + memberSize > fileSize)
+    {
+      return false;
+    }
+    blocks.push_back(BlockType{ offset, memberSize, uncompressedOffset, uncompressedSize });
+    offset += memberSize;
+    uncompressedOffset += uncompressedSize;
+  }
+
+  m_Blocks = std::move(blocks);
+  return !m_Blocks.empty();
+}
+
+void
+ParallelInflateReader::SetRawDeflateBlocks(const BlockListType & blocks)
+{
+  SizeValueType uncompressedOffset = 0;
+  for (const BlockType & block : blocks)
+  {
+    if (block.uncompressedOffset != uncompressedOffset)
+    {
+      itkExceptionMacro("The block at offset " << block.compressedOffset << " starts at uncompressed offset "
+                                               << block.uncompressedOffset << " instead of " << uncompressedOffset
+                                               << '.');
+    }
+    uncompressedOffset += block.uncompressedSize;
+  }
+  m_Blocks = blocks;
+  m_GzipMembers = false;
+  this->Modified();
+}
+
+SizeValueType
+ParallelInflateReader::GetUncompressedSize() const
+{
+  return m_Blocks.empty() ? 0 : m_Blocks.back().uncompressedOffset + m_Blocks.back().uncompressedSize;
+}
+
+void
+ParallelInflateReader::Read(void * buffer, SizeValueType offset, SizeValueType size)
+{
+  this->Read(std::vector<RangeType>{ RangeType{ offset, size, buffer } });
+}
+
+void
+ParallelInflateReader::Read(std::vector<RangeType> ranges)
+{
+  const SizeValueType uncompressedSize = this->GetUncompressedSize();
+  ranges.erase(std::remove_if(ranges.begin(), ranges.end(), [](const RangeType & range) { return range.size == 0; }),
+               ranges.end());
+  for (const RangeType & range : ranges)
+  {
+    if (range.offset + range.size > uncompressedSize)
+    {
+      itkExceptionMacro("Cannot read " << range.size << " bytes at offset " << range.offset << " of " << m_FileName
+                                       << ", which holds " << uncompressedSize << " bytes.");
+    }
+  }
+  std::sort(
+    ranges.begin(), ranges.end(), [](const RangeType & a, const RangeType & b) { return a.offset < b.offset; });
+
+  // The blocks that overlap any range
+  const auto findBlock = [this](SizeValueType offset) {
+    return static_cast<SizeValueType>(
+      std::upper_bound(m_Blocks.begin(),
+                       m_Blocks.end(),
+                       offset,
+                       [](SizeValueType value, const BlockType & block) { return value < block.uncompressedOffset; }) -
+      m_Blocks.begin() - 1);
+  };
+  std::vector<SizeValueType> neededBlocks;
+  for (const RangeType & range : ranges)
+  {
+    SizeValueType       first = findBlock(range.offset);
+    const SizeValueType last = findBlock(range.offset + range.size - 1);
+    if (!neededBlocks.empty())
+    {
+      first = std::max(first, neededBlocks.back() + 1);
+    }
+    for (SizeValueType b = first; b <= last; ++b)
+    {
+      neededBlocks.push_back(b);
+    }
+  }
+  if (neededBlocks.empty())
+  {
+    return;
+  }
+
+  std::ifstream file(m_FileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+  {
+    itkExceptionMacro("Cannot open " << m_FileName << " for reading.");
+  }
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+
+  // Inflate the blocks in batches, to bound the memory held at once
+  const SizeValueType      batchSize = 4 * SizeValueType{ m_NumberOfWorkUnits };
+  std::vector<std::string> compressed(batchSize);
+  std::vector<std::string> inflated(batchSize);
+  std::vector<char>        succeeded(batchSize);
+  auto                     rangeIt = ranges.cbegin();
+  for (SizeValueType batchStart = 0; batchStart < neededBlocks.size(); batchStart += batchSize)
+  {
+    const SizeValueType count = std::min(batchSize, static_cast<SizeValueType>(neededBlocks.size()) - batchStart);
+    for (SizeValueType i = 0; i < count; ++i)
+    {
+      const BlockType & block = m_Blocks[neededBlocks[batchStart + i]];
+      compressed[i].resize(block.compressedSize);
+      file.seekg(static_cast<std::streamoff>(block.compressedOffset));
+      if (!file.read(&compressed[i][0], static_cast<std::streamsize>(block.compressedSize)))
+      {
+        itkExceptionMacro("Cannot read " << block.compressedSize << " bytes at offset " << block.compressedOffset
+                                         << " of " << m_FileName << '.');
+      }
+    }
+
+    const auto inflate = [&](SizeValueType i) {
+      succeeded[i] = this->InflateBlock(m_Blocks[neededBlocks[batchStart + i]], compressed[i], inflated[i]);
+    };
+    if (count > 1 && m_NumberOfWorkUnits > 1)
+    {
+      m_MultiThreader->ParallelizeArray(0, count, inflate, nullptr);
+    }
+    else
+    {
+      for (SizeValueType i = 0; i < count; ++i)
+      {
+        inflate(i);
+      }
+    }
+
+    for (SizeValueType i = 0; i < count; ++i)
+    {
+      const BlockType & block = m_Blocks[neededBlocks[batchStart + i]];
+      if (!succeeded[i])
+      {
+        itkExceptionMacro("Cannot inflate the block at offset " << block.compressedOffset << " of " << m_FileName
+                                                                << '.');
+      }
+
+      // Copy the parts of the ranges in this block; the ranges are sorted
+      // and do not overlap, so their ends are sorted too.
+      const SizeValueType blockEnd = block.uncompressedOffset + block.uncompressedSize;
+      while (rangeIt != ranges.cend() && rangeIt->offset + rangeIt->size <= block.uncompressedOffset)
+      {
+        ++rangeIt;
+      }
+      for (auto it = rangeIt; it != ranges.cend() && it->offset < blockEnd; ++it)
+      {
+        const SizeValueType begin = std::max(it->offset, block.uncompressedOffset);
+        const SizeValueType end = std::min(it->offset + it->size, blockEnd);
+        if (begin < end)
+        {
+          memcpy(static_cast<char *>(it->destination) + (begin - it->offset),
+                 inflated[i].data() + (begin - block.uncompressedOffset),
+                 end - begin);
+        }
+      }
+    }
+  }
+}
+
+bool
+ParallelInflateReader::InflateBlock(const BlockType &   block,
+                                    const std::string & compressed,
+                                    std::string &       output) const
+{
+  output.resize(block.uncompressedSize);
+
+  z_stream stream{};
+  if (inflateInit2(&stream, m_GzipMembers ? MAX_WBITS + 16 : -MAX_WBITS) != Z_OK)
+  {
+    return false;
+  }
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(compressed.data()));
+  stream.avail_in = static_cast<uInt>(compressed.size());
+  stream.next_out = reinterpret_cast<Bytef *>(output.empty() ? nullptr : &output[0]);
+  stream.avail_out = static_cast<uInt>(output.size());
+
+  // A gzip member is complete and checked against its CRC-32, raw deflate
+  // data between flush points only has to produce the expected size.
+  const int status = ::inflate(&stream, m_GzipMembers ? Z_FINISH : Z_SYNC_FLUSH);
+  const bool ok = m_GzipMembers ? (status == Z_STREAM_END)
+                                : (status == Z_STREAM_END || status == Z_OK || status == Z_BUF_ERROR);
+  const bool complete = (stream.total_out == block.uncompressedSize);
+  inflateEnd(&stream);
+  return ok && complete;
+}
+
+void
+ParallelInflateReader::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+  os << indent << "NumberOfBlocks: " << m_Blocks.size() << std::endl;
+  itkPrintSelfBooleanMacro(GzipMembers);
+  itkPrintSelfObjectMacro(MultiThreader);
+}
+} // namespace itk
@@ -0,0 +1,154 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMemoryMappedImportImageContainer.h"
+#include "itkMetaImageIO.h"
+#include "itkTestingMacros.h"
+#include "itkTestVerifyImageRegion.h"
+
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+
+template <typename TImage>
+bool
+IsMapped(const TImage * image)
+{
+  using PixelContainerType = typename TImage::PixelContainer;
+  using MappedContainerType = itk::MemoryMappedImportImageContainer<typename PixelContainerType::ElementIdentifier,
+                                                                    typename PixelContainerType::Element>;
+  return dynamic_cast<const MappedContainerType *>(image->GetPixelContainer()) != nullptr;
+}
+
+} // namespace
+
+
+int
+itkImageFileReaderMemoryMappingTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 67, 45, 23 } });
+  image->Allocate();
+  short value = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<short>(it.GetIndex()[2] * 100 + (value & 63)));
+    value = static_cast<short>(value * 31 + 7);
+  }
+
+  // The detached data of a .mhd file start at the beginning of the .raw file
+  const std::string fileName = directory + "/itkImageFileReaderMemoryMappingTest.mhd";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, fileName));
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  ITK_TEST_SET_GET_BOOLEAN(reader, UseMemoryMapping, false);
+  reader->UseMemoryMappingOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_TRUE(IsMapped(reader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(
+    itk::Testing::VerifyImageRegion(image.GetPointer(), reader->GetOutput(), image->GetLargestPossibleRegion()));
+
+  // The mapped pages are private: writing to them leaves the file as it is
+  const ImageType::Pointer mapped = reader->GetOutput();
+  mapped->DisconnectPipeline();
+  mapped->FillBuffer(-1);
+  {
+    const auto reread = itk::ReadImage<ImageType>(fileName);
+    ITK_TEST_EXPECT_TRUE(
+      itk::Testing::VerifyImageRegion(image.GetPointer(), reread.GetPointer(), image->GetLargestPossibleRegion()));
+    ITK_TEST_EXPECT_TRUE(!IsMapped(reread.GetPointer()));
+  }
+
+  // A region made of whole slices is one piece of the file
+  const ImageType::RegionType slices({ { 0, 0, 7 } }, { { 67, 45, 9 } });
+  auto                        streamingReader = itk::ImageFileReader<ImageType>::New();
+  streamingReader->SetFileName(fileName);
+  streamingReader->UseMemoryMappingOn();
+  streamingReader->GetOutput()->SetRequestedRegion(slices);
+  ITK_TRY_EXPECT_NO_EXCEPTION(streamingReader->Update());
+  ITK_TEST_EXPECT_EQUAL(streamingReader->GetOutput()->GetBufferedRegion(), slices);
+  ITK_TEST_EXPECT_TRUE(IsMapped(streamingReader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(itk::Testing::VerifyImageRegion(image.GetPointer(), streamingReader->GetOutput(), slices));
+
+  // A region that is not is read as usual, into a buffer of its own
+  const ImageType::RegionType inner({ { 5, 6, 7 } }, { { 20, 21, 9 } });
+  auto                        innerReader = itk::ImageFileReader<ImageType>::New();
+  innerReader->SetFileName(fileName);
+  innerReader->UseMemoryMappingOn();
+  innerReader->GetOutput()->SetRequestedRegion(inner);
+  ITK_TRY_EXPECT_NO_EXCEPTION(innerReader->Update());
+  ITK_TEST_EXPECT_EQUAL(innerReader->GetOutput()->GetBufferedRegion(), inner);
+  ITK_TEST_EXPECT_TRUE(!IsMapped(innerReader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(itk::Testing::VerifyImageRegion(image.GetPointer(), innerReader->GetOutput(), inner));
+
+  // A buffer mapped by a previous update is replaced when mapping is off
+  streamingReader->UseMemoryMappingOff();
+  ITK_TRY_EXPECT_NO_EXCEPTION(streamingReader->Update());
+  ITK_TEST_EXPECT_TRUE(!IsMapped(streamingReader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(itk::Testing::VerifyImageRegion(image.GetPointer(), streamingReader->GetOutput(), slices));
+
+  // Pixels that need a conversion are read as usual
+  using FloatImageType = itk::Image<float, 3>;
+  auto floatReader = itk::ImageFileReader<FloatImageType>::New();
+  floatReader->SetFileName(fileName);
+  floatReader->UseMemoryMappingOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(floatReader->Update());
+  ITK_TEST_EXPECT_TRUE(!IsMapped(floatReader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(
+    itk::Testing::VerifyImageRegion(image.GetPointer(), floatReader->GetOutput(), image->GetLargestPossibleRegion()));
+
+  // So is compressed data
+  const std::string compressedFileName = directory + "/itkImageFileReaderMemoryMappingTest.mha";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, compressedFileName, true));
+  auto compressedReader = itk::ImageFileReader<ImageType>::New();
+  compressedReader->SetFileName(compressedFileName);
+  compressedReader->UseMemoryMappingOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(compressedReader->Update());
+  ITK_TEST_EXPECT_TRUE(!IsMapped(compressedReader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(itk::Testing::VerifyImageRegion(
+    image.GetPointer(), compressedReader->GetOutput(), image->GetLargestPossibleRegion()));
+
+  // Rewriting the file, here with a smaller image, leaves a mapped image as
+  // it was: the writer copies its pages into memory first
+  auto keptReader = itk::ImageFileReader<ImageType>::New();
+  keptReader->SetFileName(fileName);
+  keptReader->UseMemoryMappingOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(keptReader->Update());
+  ITK_TEST_EXPECT_TRUE(IsMapped(keptReader->GetOutput()));
+  auto smallImage = ImageType::New();
+  smallImage->SetRegions(ImageType::SizeType{ { 3, 2, 1 } });
+  smallImage->AllocateInitialized();
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(smallImage, fileName));
+  ITK_TEST_EXPECT_TRUE(
+    itk::Testing::VerifyImageRegion(image.GetPointer(), keptReader->GetOutput(), image->GetLargestPossibleRegion()));
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
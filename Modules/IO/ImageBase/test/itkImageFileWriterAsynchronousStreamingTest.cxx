@@ -0,0 +1,123 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkTestingMacros.h"
+
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+
+bool
+SameImages(const ImageType * expected, const ImageType * actual)
+{
+  if (actual->GetLargestPossibleRegion() != expected->GetLargestPossibleRegion())
+  {
+    std::cerr << "The regions differ." << std::endl;
+    return false;
+  }
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(actual, actual->GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    if (it.Get() != expected->GetPixel(it.GetIndex()))
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " differs." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+int
+itkImageFileWriterAsynchronousStreamingTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 61, 47, 28 } });
+  image->Allocate();
+  short value = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<short>(it.GetIndex()[2] * 100 + (value & 63)));
+    value = static_cast<short>(value * 31 + 7);
+  }
+  const std::string inputFileName = directory + "/itkImageFileWriterAsynchronousStreamingTestInput.mha";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, inputFileName));
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  ITK_TEST_SET_GET_BOOLEAN(writer, UseAsynchronousWriting, false);
+  ITK_TEST_EXPECT_EQUAL(writer->GetMaximumNumberOfPendingWrites(), 1u);
+  writer->SetMaximumNumberOfPendingWrites(0);
+  ITK_TEST_EXPECT_EQUAL(writer->GetMaximumNumberOfPendingWrites(), 1u);
+
+  constexpr unsigned int numberOfDataPieces{ 7 };
+  for (const bool compress : { false, true })
+  {
+    for (const unsigned int maximumNumberOfPendingWrites : { 1u, 3u })
+    {
+      std::cout << "Compression: " << compress << ", pending writes: " << maximumNumberOfPendingWrites << std::endl;
+
+      // The upstream pipeline streams while the pieces are written
+      auto reader = itk::ImageFileReader<ImageType>::New();
+      reader->SetFileName(inputFileName);
+      reader->UseStreamingOn();
+      auto monitor = itk::PipelineMonitorImageFilter<ImageType>::New();
+      monitor->SetInput(reader->GetOutput());
+
+      const std::string fileName = directory + "/itkImageFileWriterAsynchronousStreamingTest.mha";
+      writer->SetInput(monitor->GetOutput());
+      writer->SetFileName(fileName);
+      writer->SetNumberOfStreamDivisions(numberOfDataPieces);
+      writer->SetUseCompression(compress);
+      writer->UseAsynchronousWritingOn();
+      writer->SetMaximumNumberOfPendingWrites(maximumNumberOfPendingWrites);
+      ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+      ITK_TEST_EXPECT_TRUE(monitor->VerifyAllInputCanStream(numberOfDataPieces));
+      ITK_TEST_EXPECT_EQUAL(writer->GetProgress(), 1.0f);
+
+      ImageType::Pointer written;
+      ITK_TRY_EXPECT_NO_EXCEPTION(written = itk::ReadImage<ImageType>(fileName));
+      ITK_TEST_EXPECT_TRUE(SameImages(image, written));
+    }
+  }
+
+  // An error of a write is reported by the writer
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(inputFileName);
+  reader->UseStreamingOn();
+  writer->SetInput(reader->GetOutput());
+  writer->SetFileName(directory + "/missing/itkImageFileWriterAsynchronousStreamingTest.mha");
+  ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileWriter.h"
+#include "itkImageSeriesReader.h"
+#include "itkMetaImageIO.h"
+#include "itkTestingMacros.h"
+#include "itkTestVerifyImageRegion.h"
+
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+} // namespace
+
+
+int
+itkImageSeriesReaderConcurrentReadTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  // Write a series of slices, one above the other, with a gap above the tenth
+  constexpr unsigned int numberOfSlices = 23;
+  std::vector<std::string> fileNames;
+  for (unsigned int i = 0; i < numberOfSlices; ++i)
+  {
+    auto slice = ImageType::New();
+    slice->SetRegions(ImageType::SizeType{ { 19, 13, 1 } });
+    slice->Allocate();
+    for (itk::ImageRegionIterator<ImageType> it(slice, slice->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+    {
+      const auto & index = it.GetIndex();
+      it.Set(static_cast<short>(i * 1000 + index[1] * 19 + index[0]));
+    }
+    ImageType::PointType origin{};
+    origin[2] = (i < 10 ? i : i + 1.0);
+    slice->SetOrigin(origin);
+    fileNames.push_back(directory + "/itkImageSeriesReaderConcurrentReadTest" + std::to_string(i) + ".mha");
+    ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(slice, fileNames.back()));
+  }
+
+  using ReaderType = itk::ImageSeriesReader<ImageType>;
+  auto serialReader = ReaderType::New();
+  serialReader->SetFileNames(fileNames);
+  ITK_TEST_SET_GET_VALUE(1, serialReader->GetNumberOfConcurrentReads());
+  ITK_TRY_EXPECT_NO_EXCEPTION(serialReader->Update());
+  const ImageType * expected = serialReader->GetOutput();
+
+  // The slices are placed in order, and the dictionaries are gathered in
+  // order, whatever the number of files read at once. The work units of the
+  // reader bound the number of files read at once.
+  for (const unsigned int numberOfConcurrentReads : { 2, 4, 64 })
+  {
+    for (const bool setImageIO : { false, true })
+    {
+      auto reader = ReaderType::New();
+      reader->SetFileNames(fileNames);
+      reader->SetNumberOfWorkUnits(numberOfConcurrentReads);
+      reader->SetNumberOfConcurrentReads(numberOfConcurrentReads);
+      ITK_TEST_SET_GET_VALUE(numberOfConcurrentReads, reader->GetNumberOfConcurrentReads());
+      if (setImageIO)
+      {
+        reader->SetImageIO(itk::MetaImageIO::New());
+      }
+      ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+      ITK_TEST_EXPECT_TRUE(
+        itk::Testing::VerifyImageRegion(expected, reader->GetOutput(), expected->GetLargestPossibleRegion()));
+
+      const auto & dictionaries = *reader->GetMetaDataDictionaryArray();
+      const auto & expectedDictionaries = *serialReader->GetMetaDataDictionaryArray();
+      ITK_TEST_EXPECT_EQUAL(dictionaries.size(), expectedDictionaries.size());
+      for (size_t i = 0; i < dictionaries.size() && i < expectedDictionaries.size(); ++i)
+      {
+        ITK_TEST_EXPECT_EQUAL(dictionaries[i]->HasKey("ITK_non_uniform_sampling_deviation"),
+                              expectedDictionaries[i]->HasKey("ITK_non_uniform_sampling_deviation"));
+      }
+      ITK_TEST_EXPECT_TRUE(
+        reader->GetOutput()->GetMetaDataDictionary().HasKey("ITK_non_uniform_sampling_deviation"));
+    }
+  }
+
+  // When streaming, only the slices of the requested region are read
+  const ImageType::RegionType slab({ { 0, 0, 5 } }, { { 19, 13, 9 } });
+  auto                        streamingReader = ReaderType::New();
+  streamingReader->SetFileNames(fileNames);
+  streamingReader->SetNumberOfConcurrentReads(3);
+  streamingReader->MetaDataDictionaryArrayUpdateOff();
+  streamingReader->GetOutput()->SetRequestedRegion(slab);
+  ITK_TRY_EXPECT_NO_EXCEPTION(streamingReader->Update());
+  ITK_TEST_EXPECT_EQUAL(streamingReader->GetOutput()->GetBufferedRegion(), slab);
+  ITK_TEST_EXPECT_TRUE(itk::Testing::VerifyImageRegion(expected, streamingReader->GetOutput(), slab));
+
+  // An error while reading a file is reported
+  auto brokenFileNames = fileNames;
+  brokenFileNames[17] = directory + "/itkImageSeriesReaderConcurrentReadTestMissing.mha";
+  auto brokenReader = ReaderType::New();
+  brokenReader->SetFileNames(brokenFileNames);
+  brokenReader->SetNumberOfConcurrentReads(4);
+  ITK_TRY_EXPECT_EXCEPTION(brokenReader->Update());
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
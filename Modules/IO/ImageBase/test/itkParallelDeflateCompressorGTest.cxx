@@ -0,0 +1,169 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkParallelDeflateCompressor.h"
+#include "itk_zlib.h"
+#include "itkGTest.h"
+
+#include <sstream>
+
+namespace
+{
+using StreamFormatEnum = itk::ParallelDeflateCompressor::StreamFormatEnum;
+
+// Compressible, but not trivially so: a slowly varying signal with noise.
+std::string
+MakeInput(size_t size)
+{
+  std::string  input(size, '\0');
+  unsigned int state = 12345;
+  for (size_t i = 0; i < size; ++i)
+  {
+    state = state * 1103515245u + 12345u;
+    input[i] = static_cast<char>((i / 300) % 64 + ((state >> 16) & 7));
+  }
+  return input;
+}
+
+// Inflate a complete gzip member or zlib stream, failing on any trailing data.
+bool
+Inflate(const std::string & compressed, StreamFormatEnum format, std::string & output)
+{
+  z_stream stream{};
+  if (inflateInit2(&stream, (format == StreamFormatEnum::Gzip) ? MAX_WBITS + 16 : MAX_WBITS) != Z_OK)
+  {
+    return false;
+  }
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(compressed.data()));
+  stream.avail_in = static_cast<uInt>(compressed.size());
+
+  output.clear();
+  char buffer[16384];
+  int  status = Z_OK;
+  while (status == Z_OK)
+  {
+    stream.next_out = reinterpret_cast<Bytef *>(buffer);
+    stream.avail_out = sizeof(buffer);
+    status = inflate(&stream, Z_NO_FLUSH);
+    output.append(buffer, sizeof(buffer) - stream.avail_out);
+  }
+  inflateEnd(&stream);
+  return status == Z_STREAM_END && stream.avail_in == 0;
+}
+} // namespace
+
+TEST(ParallelDeflateCompressor, Basic)
+{
+  auto compressor = itk::ParallelDeflateCompressor::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(compressor, ParallelDeflateCompressor, Object);
+
+  EXPECT_EQ(compressor->GetStreamFormat(), StreamFormatEnum::Gzip);
+  EXPECT_EQ(compressor->GetCompressionLevel(), 6);
+  EXPECT_EQ(compressor->GetBlockSize(), 131072u);
+
+  compressor->SetCompressionLevel(12);
+  EXPECT_EQ(compressor->GetCompressionLevel(), 9);
+  compressor->SetBlockSize(1000);
+  EXPECT_EQ(compressor->GetBlockSize(), 32768u);
+
+  EXPECT_THROW(compressor->Write("abc", 3), itk::ExceptionObject);
+  EXPECT_THROW(compressor->End(), itk::ExceptionObject);
+
+  std::ostringstream os;
+  os << StreamFormatEnum::Zlib;
+  EXPECT_EQ(os.str(), "itk::ParallelDeflateCompressorEnums::StreamFormat::Zlib");
+}
+
+TEST(ParallelDeflateCompressor, RoundTrip)
+{
+  for (const auto format : { StreamFormatEnum::Gzip, StreamFormatEnum::Zlib })
+  {
+    for (const size_t size : { size_t{ 0 }, size_t{ 1 }, size_t{ 50000 }, size_t{ 1000000 } })
+    {
+      for (const int level : { 0, 1, 6, 9 })
+      {
+        const std::string input = MakeInput(size);
+
+        auto compressor = itk::ParallelDeflateCompressor::New();
+        compressor->SetStreamFormat(format);
+        compressor->SetCompressionLevel(level);
+        compressor->SetBlockSize(32768);
+        compressor->SetNumberOfWorkUnits(4);
+
+        std::ostringstream compressed;
+        compressor->Compress(input.data(), input.size(), compressed);
+        EXPECT_EQ(compressor->GetNumberOfInputBytes(), size);
+        EXPECT_EQ(compressor->GetNumberOfOutputBytes(), compressed.str().size());
+
+        std::string output;
+        EXPECT_TRUE(Inflate(compressed.str(), format, output)) << format << ", size " << size << ", level " << level;
+        EXPECT_EQ(output, input) << format << ", size " << size << ", level " << level;
+
+        // Priming the blocks keeps the output close to a single deflate stream
+        uLongf      referenceSize = compressBound(static_cast<uLong>(size));
+        std::string reference(referenceSize, '\0');
+        compress2(reinterpret_cast<Bytef *>(&reference[0]),
+                  &referenceSize,
+                  reinterpret_cast<const Bytef *>(input.data()),
+                  static_cast<uLong>(size),
+                  level);
+        EXPECT_LE(compressed.str().size(), referenceSize + referenceSize / 50 + 64);
+      }
+    }
+  }
+}
+
+TEST(ParallelDeflateCompressor, SeveralWrites)
+{
+  const std::string input = MakeInput(700001);
+
+  for (const auto format : { StreamFormatEnum::Gzip, StreamFormatEnum::Zlib })
+  {
+    for (const itk::ThreadIdType numberOfWorkUnits : { 1u, 3u })
+    {
+      auto compressor = itk::ParallelDeflateCompressor::New();
+      compressor->SetStreamFormat(format);
+      compressor->SetNumberOfWorkUnits(numberOfWorkUnits);
+      compressor->SetBlockSize(40000);
+
+      // Pieces smaller and larger than a block, to an output function
+      std::string compressed;
+      compressor->Begin([&compressed](const char * data, itk::SizeValueType size) { compressed.append(data, size); });
+      size_t offset = 0;
+      size_t step = 1;
+      while (offset < input.size())
+      {
+        const size_t count = std::min(step, input.size() - offset);
+        compressor->Write(input.data() + offset, count);
+        offset += count;
+        step = 3 * step + 7;
+      }
+      compressor->End();
+
+      std::string output;
+      EXPECT_TRUE(Inflate(compressed, format, output));
+      EXPECT_EQ(output, input);
+
+      // The compressor can be reused for another stream
+      std::ostringstream single;
+      compressor->Compress(input.data(), input.size(), single);
+      EXPECT_TRUE(Inflate(single.str(), format, output));
+      EXPECT_EQ(output, input);
+    }
+  }
+}
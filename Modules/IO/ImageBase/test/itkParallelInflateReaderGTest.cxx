@@ -0,0 +1,177 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkParallelInflateReader.h"
+#include "itkParallelDeflateCompressor.h"
+#include "itk_zlib.h"
+#include "itkGTest.h"
+
+#include <fstream>
+
+#define _STRING(s) #s
+#define TOSTRING(s) _STRING(s)
+
+namespace
+{
+using StreamFormatEnum = itk::ParallelDeflateCompressor::StreamFormatEnum;
+
+std::string
+MakeInput(size_t size)
+{
+  std::string  input(size, '\0');
+  unsigned int state = 54321;
+  for (size_t i = 0; i < size; ++i)
+  {
+    state = state * 1103515245u + 12345u;
+    input[i] = static_cast<char>((i / 500) % 32 + ((state >> 16) & 3));
+  }
+  return input;
+}
+
+// Compress input to a file with independent blocks, and return the offsets of the blocks.
+std::vector<itk::SizeValueType>
+CompressToFile(const std::string & input, StreamFormatEnum format, const std::string & fileName)
+{
+  auto compressor = itk::ParallelDeflateCompressor::New();
+  compressor->SetStreamFormat(format);
+  compressor->SetIndependentBlocks(true);
+  compressor->SetBlockSize(32768);
+  compressor->SetNumberOfWorkUnits(3);
+
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  compressor->Compress(input.data(), input.size(), file);
+  return compressor->GetBlockOffsets();
+}
+} // namespace
+
+TEST(ParallelInflateReader, Basic)
+{
+  auto reader = itk::ParallelInflateReader::New();
+  ITK_GTEST_EXERCISE_BASIC_OBJECT_METHODS(reader, ParallelInflateReader, Object);
+
+  EXPECT_TRUE(reader->GetBlocks().empty());
+  EXPECT_EQ(reader->GetUncompressedSize(), 0u);
+
+  reader->SetFileName(TOSTRING(ITK_TEST_OUTPUT_DIR) "/ParallelInflateReaderDoesNotExist.gz");
+  EXPECT_THROW(reader->ReadGzipMemberIndex(), itk::ExceptionObject);
+
+  // Blocks must cover the uncompressed data without gaps
+  EXPECT_THROW(reader->SetRawDeflateBlocks({ { 0, 10, 0, 100 }, { 10, 10, 101, 100 } }), itk::ExceptionObject);
+}
+
+TEST(ParallelInflateReader, GzipMembers)
+{
+  const std::string fileName = TOSTRING(ITK_TEST_OUTPUT_DIR) "/ParallelInflateReaderGzipMembers.gz";
+  const std::string input = MakeInput(300000);
+  const auto        offsets = CompressToFile(input, StreamFormatEnum::Gzip, fileName);
+  ASSERT_EQ(offsets.size(), 10u);
+
+  // The file is an ordinary multi-member gzip file
+  gzFile gz = gzopen(fileName.c_str(), "rb");
+  ASSERT_NE(gz, nullptr);
+  std::string whole(input.size() + 1, '\0');
+  EXPECT_EQ(gzread(gz, &whole[0], static_cast<unsigned int>(whole.size())), static_cast<int>(input.size()));
+  gzclose(gz);
+  whole.resize(input.size());
+  EXPECT_EQ(whole, input);
+
+  auto reader = itk::ParallelInflateReader::New();
+  reader->SetFileName(fileName);
+  reader->SetNumberOfWorkUnits(2);
+  ASSERT_TRUE(reader->ReadGzipMemberIndex());
+  ASSERT_EQ(reader->GetBlocks().size(), offsets.size());
+  for (size_t i = 0; i < offsets.size(); ++i)
+  {
+    EXPECT_EQ(reader->GetBlocks()[i].compressedOffset, offsets[i]);
+    EXPECT_EQ(reader->GetBlocks()[i].uncompressedOffset, i * 32768);
+  }
+  EXPECT_EQ(reader->GetUncompressedSize(), input.size());
+
+  // A range inside a block, across blocks, and several ranges at once
+  std::string output(70000, '\0');
+  reader->Read(&output[0], 100, 1000);
+  EXPECT_EQ(output.substr(0, 1000), input.substr(100, 1000));
+  reader->Read(&output[0], 30000, 70000);
+  EXPECT_EQ(output, input.substr(30000, 70000));
+
+  std::string first(5000, '\0');
+  std::string second(40000, '\0');
+  std::string third(10, '\0');
+  reader->Read({ { 299990, 10, &third[0] }, { 1000, 5000, &first[0] }, { 32000, 40000, &second[0] } });
+  EXPECT_EQ(first, input.substr(1000, 5000));
+  EXPECT_EQ(second, input.substr(32000, 40000));
+  EXPECT_EQ(third, input.substr(299990, 10));
+
+  whole.assign(input.size(), '\0');
+  reader->Read(&whole[0], 0, input.size());
+  EXPECT_EQ(whole, input);
+
+  EXPECT_THROW(reader->Read(&output[0], 299990, 11), itk::ExceptionObject);
+
+  // An ordinary gzip file has no index
+  std::ofstream plain(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  itk::ParallelDeflateCompressor::New()->Compress(input.data(), input.size(), plain);
+  plain.close();
+  EXPECT_FALSE(reader->ReadGzipMemberIndex());
+  EXPECT_TRUE(reader->GetBlocks().empty());
+}
+
+TEST(ParallelInflateReader, RawDeflateBlocks)
+{
+  const std::string fileName = TOSTRING(ITK_TEST_OUTPUT_DIR) "/ParallelInflateReaderRawDeflateBlocks.z";
+  const std::string input = MakeInput(200000);
+  const auto        offsets = CompressToFile(input, StreamFormatEnum::Zlib, fileName);
+  ASSERT_EQ(offsets.size(), 7u);
+
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  file.seekg(0, std::ios::end);
+  const auto fileSize = static_cast<itk::SizeValueType>(file.tellg());
+
+  // The file is an ordinary zlib stream
+  std::string compressed(fileSize, '\0');
+  file.seekg(0);
+  file.read(&compressed[0], static_cast<std::streamsize>(fileSize));
+  uLongf      wholeSize = static_cast<uLongf>(input.size());
+  std::string whole(input.size(), '\0');
+  EXPECT_EQ(uncompress(reinterpret_cast<Bytef *>(&whole[0]),
+                       &wholeSize,
+                       reinterpret_cast<const Bytef *>(compressed.data()),
+                       static_cast<uLong>(compressed.size())),
+            Z_OK);
+  EXPECT_EQ(whole, input);
+
+  // The last block ends before the Adler-32 trailer of the zlib stream
+  itk::ParallelInflateReader::BlockListType blocks;
+  for (size_t i = 0; i < offsets.size(); ++i)
+  {
+    const itk::SizeValueType end = (i + 1 < offsets.size()) ? offsets[i + 1] : fileSize - 4;
+    const itk::SizeValueType uncompressedSize = std::min<itk::SizeValueType>(32768, input.size() - i * 32768);
+    blocks.push_back({ offsets[i], end - offsets[i], i * 32768, uncompressedSize });
+  }
+
+  auto reader = itk::ParallelInflateReader::New();
+  reader->SetFileName(fileName);
+  reader->SetRawDeflateBlocks(blocks);
+  EXPECT_EQ(reader->GetUncompressedSize(), input.size());
+
+  std::string output(100000, '\0');
+  reader->Read(&output[0], 99999, 100000);
+  EXPECT_EQ(output, input.substr(99999, 100000));
+  reader->Read(&output[0], 0, 100000);
+  EXPECT_EQ(output, input.substr(0, 100000));
+}
@@ -25,6 +25,8 @@
 #include "itkNumberToString.h"
 #include "itkSingletonMacro.h"
 #include "itkMetaDataObject.h"
+#include "itkParallelDeflateCompressor.h"
+#include "itkParallelInflateReader.h"
 #include "metaObject.h"
 #include "metaImage.h"
 
@@ -86,6 +88,11 @@ public:
   MetaImage *
   GetMetaImagePointer();
 
+  /** Uncompressed binary element data, in a single file and in the byte
+   * order of the system, is held as Read() would read it. */
+  bool
+  GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset) const override;
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can write the
@@ -135,20 +142,23 @@ public:
                            const ImageIORegion & largestPossibleRegion) override;
 
   /** Determine if the ImageIO can stream reading from this
-   *  file. Only time cannot stream read/write is if compression is used.
+   *  file. Only time cannot stream read/write is if compression is used,
+   *  unless the file was written with SeekableCompression.
    *  CanRead must be called prior to this function. */
   bool
   CanStreamRead() override
   {
     if (m_MetaImage.CompressedData())
     {
-      return false;
+      return m_IndexedReader.IsNotNull();
     }
     return true;
   }
 
   /** Determine if the ImageIO can stream writing to this
-   *  file. Only time cannot stream read/write is if compression is used.
+   *  file. A compressed file can be streamed, but not pasted, when its
+   *  binary element data goes to a single file: the pieces are then
+   *  compressed as independent blocks, indexed as with SeekableCompression.
    *  Assumes file passes a CanRead call and its pixels are of the same
    *  type as the template of the writer. Can verify by first calling
    *  CanRead and then CanStreamRead prior to calling CanStreamWrite. */
@@ -157,7 +167,7 @@ public:
   {
     if (this->GetUseCompression())
     {
-      return false;
+      return this->CanStreamCompressedWrite();
     }
     return true;
   }
@@ -170,6 +180,17 @@ public:
   itkGetConstMacro(SubSamplingFactor, unsigned int);
   /** @ITKEndGrouping */
 
+  /** Compress the element data as independent blocks, and write their
+   * offsets in the CompressedDataBlockSize and CompressedDataBlockOffsets
+   * header fields, so that a region can later be read by inflating only the
+   * blocks that hold it. The data stays a valid zlib stream for other
+   * readers. The default is false. */
+  /** @ITKStartGrouping */
+  itkSetMacro(SeekableCompression, bool);
+  itkGetConstMacro(SeekableCompression, bool);
+  itkBooleanMacro(SeekableCompression);
+  /** @ITKEndGrouping */
+
   /**
    * Set the default precision when writing out the MetaImage header.
    * MetaImage header contains values stored in memory as double,
@@ -201,10 +222,77 @@ private:
   /** Only used to synchronize the global variable across static libraries.*/
   itkGetGlobalDeclarationMacro(unsigned int, DefaultDoublePrecision);
 
-  MetaImage m_MetaImage{};
+  /** Locate the compressed blocks from the header fields written with
+   * SeekableCompression, if any. */
+  void
+  SetUpIndexedReader(const std::string & blockSizeValue, const std::string & blockOffsetsValue);
+
+  /** Read \c region of a file written with SeekableCompression. */
+  void
+  ReadIndexedRegion(const ImageIORegion & region, void * buffer);
+
+  /** Whether compressed element data can be written piece by piece. */
+  bool
+  CanStreamCompressedWrite() const;
+
+  /** Compress the piece of the image in m_IORegion, which must follow the
+   * piece written before it in the file, or the whole image. The header is
+   * written with the last piece. */
+  void
+  WriteCompressedPiece(const void * buffer);
+
+  /** Drop the state of a compressed write that failed or was not finished,
+   * and remove its temporary file, if any. */
+  void
+  DiscardCompressedPieces();
+
+  /** Add the header fields that locate the blocks written by \c compressor. */
+  void
+  AddBlockOffsetFields(const ParallelDeflateCompressor * compressor, SizeValueType compressedDataSize);
+
+  /** \class HeaderMetaImage
+   * A MetaImage that can write the header of element data compressed by
+   * MetaImageIO, which writes the data itself.
+   * \ingroup ITKIOMeta
+   */
+  class HeaderMetaImage : public MetaImage
+  {
+  public:
+    /** Write the header only, announcing compressed element data of the
+     * given size in the given data file. */
+    bool
+    WriteCompressedDataHeader(const char * headName, const char * dataName, std::streamoff compressedDataSize);
+
+  protected:
+    void
+    M_SetupWriteFields() override;
+
+  private:
+    std::streamoff m_HeaderCompressedDataSize{ -1 };
+  };
+
+  HeaderMetaImage m_MetaImage{};
 
   unsigned int m_SubSamplingFactor{};
 
+  bool m_SeekableCompression{ false };
+
+  /** Whether the last write added the header fields of the block offsets. */
+  bool m_BlockOffsetFieldsAdded{ false };
+
+  /** Inflates the blocks of a file written with SeekableCompression. */
+  ParallelInflateReader::Pointer m_IndexedReader{};
+
+  /** State of a compressed write, which may be streamed in pieces. For a
+   * LOCAL file, the compressed data goes to memory, or to a temporary file
+   * when streamed, until the header can be written. */
+  ParallelDeflateCompressor::Pointer m_StreamingCompressor{};
+  std::ofstream                      m_StreamingDataFile{};
+  std::string                        m_StreamingDataFileName{};
+  std::string                        m_StreamingLocalBuffer{};
+  std::string                        m_StreamingElementDataFileName{};
+  bool                               m_StreamingLocalData{ false };
+
   static unsigned int * m_DefaultDoublePrecision;
 };
 
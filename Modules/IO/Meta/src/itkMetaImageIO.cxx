@@ -24,9 +24,12 @@
 #include "itkNumberToString.h"
 #include "itkSingleton.h"
 #include "itkMakeUniqueForOverwrite.h"
+#include "itkParallelDeflateCompressor.h"
 #include "metaImageUtils.h"
 
+#include <algorithm>
 #include <set>
+#include <sstream>
 
 
 namespace itk
@@ -37,6 +40,18 @@ itkGetGlobalValueMacro(MetaImageIO, unsigned int, DefaultDoublePrecision, 17);
 
 unsigned int * MetaImageIO::m_DefaultDoublePrecision;
 
+namespace
+{
+// Header fields that locate the independent blocks of the element data of a
+// file written with SeekableCompression.
+constexpr char CompressedDataBlockSizeField[] = "CompressedDataBlockSize";
+constexpr char CompressedDataBlockOffsetsField[] = "CompressedDataBlockOffsets";
+
+// The offsets of the blocks must fit in one header field, which the MetaIO
+// library reads into a buffer of 32 KiB.
+constexpr SizeValueType MaximumNumberOfCompressedDataBlocks = 1024;
+} // namespace
+
 MetaImageIO::MetaImageIO()
   : m_SubSamplingFactor(1)
 {
@@ -64,7 +79,11 @@ MetaImageIO::MetaImageIO()
   this->Self::SetCompressionLevel(2);
 }
 
-MetaImageIO::~MetaImageIO() = default;
+MetaImageIO::~MetaImageIO()
+{
+  // A streamed write that did not get its last piece
+  this->DiscardCompressedPieces();
+}
 
 void
 MetaImageIO::PrintSelf(std::ostream & os, Indent indent) const
@@ -72,6 +91,9 @@ MetaImageIO::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
   m_MetaImage.PrintInfo();
   os << indent << "SubSamplingFactor: " << m_SubSamplingFactor << '\n';
+  itkPrintSelfBooleanMacro(SeekableCompression);
+  itkPrintSelfObjectMacro(IndexedReader);
+  itkPrintSelfObjectMacro(StreamingCompressor);
 }
 
 void
@@ -278,13 +300,29 @@ MetaImageIO::ReadImageInformation()
   //
   // save the metadatadictionary in the MetaImage header.
   // NOTE: The MetaIO library only supports typeless strings as metadata
-  const int dictFields = m_MetaImage.GetNumberOfAdditionalReadFields();
+  // The offsets of the blocks of a file written with SeekableCompression
+  // are not metadata of the image.
+  std::string blockSizeValue;
+  std::string blockOffsetsValue;
+  const int   dictFields = m_MetaImage.GetNumberOfAdditionalReadFields();
   for (int f = 0; f < dictFields; ++f)
   {
     const std::string key(m_MetaImage.GetAdditionalReadFieldName(f));
     const std::string value(m_MetaImage.GetAdditionalReadFieldValue(f));
-    EncapsulateMetaData<std::string>(thisMetaDict, key, value);
+    if (key == CompressedDataBlockSizeField)
+    {
+      blockSizeValue = value;
+    }
+    else if (key == CompressedDataBlockOffsetsField)
+    {
+      blockOffsetsValue = value;
+    }
+    else
+    {
+      EncapsulateMetaData<std::string>(thisMetaDict, key, value);
+    }
   }
+  this->SetUpIndexedReader(blockSizeValue, blockOffsetsValue);
 
   //
   // Read some metadata
@@ -303,6 +341,137 @@ MetaImageIO::ReadImageInformation()
   }
 }
 
+void
+MetaImageIO::SetUpIndexedReader(const std::string & blockSizeValue, const std::string & blockOffsetsValue)
+{
+  m_IndexedReader = nullptr;
+
+  const std::string dataFileName = m_MetaImage.ElementDataFileName();
+  if (!m_MetaImage.CompressedData() || !m_MetaImage.BinaryData() || blockSizeValue.empty() ||
+      dataFileName.find('%') != std::string::npos || dataFileName.find("LIST") != std::string::npos)
+  {
+    return;
+  }
+
+  SizeValueType      blockSize = 0;
+  std::istringstream blockSizeStream(blockSizeValue);
+  blockSizeStream >> blockSize;
+  std::vector<SizeValueType> offsets;
+  std::istringstream         offsetsStream(blockOffsetsValue);
+  for (SizeValueType offset = 0; offsetsStream >> offset;)
+  {
+    offsets.push_back(offset);
+  }
+
+  // One offset per block, then the size of the zlib stream
+  int elementSize = 0;
+  MET_SizeOfType(m_MetaImage.ElementType(), &elementSize);
+  SizeValueType dataSize = static_cast<SizeValueType>(elementSize * m_MetaImage.ElementNumberOfChannels());
+  for (int i = 0; i < m_MetaImage.NDims(); ++i)
+  {
+    dataSize *= static_cast<SizeValueType>(m_MetaImage.DimSize(i));
+  }
+  if (blockSize == 0 || offsets.size() < 2 || offsets.size() - 1 != (dataSize + blockSize - 1) / blockSize ||
+      !std::is_sorted(offsets.begin(), offsets.end()) || offsets.back() < offsets[offsets.size() - 2] + 4)
+  {
+    return;
+  }
+
+  // The compressed data ends a file with the header, and fills a separate file
+  std::string   fileName;
+  SizeValueType dataOffset = 0;
+  if (dataFileName == "LOCAL")
+  {
+    fileName = m_FileName;
+    const auto fileSize = static_cast<SizeValueType>(itksys::SystemTools::FileLength(fileName));
+    if (fileSize < offsets.back())
+    {
+      return;
+    }
+    dataOffset = fileSize - offsets.back();
+  }
+  else
+  {
+    fileName = dataFileName;
+    const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+    if (!itksys::SystemTools::FileIsFullPath(fileName) && !path.empty())
+    {
+      fileName = path + '/' + fileName;
+    }
+  }
+
+  // The last block ends before the Adler-32 checksum of the stream
+  ParallelInflateReader::BlockListType blocks;
+  for (size_t i = 0; i + 1 < offsets.size(); ++i)
+  {
+    const SizeValueType end = (i + 2 < offsets.size()) ? offsets[i + 1] : offsets[i + 1] - 4;
+    const SizeValueType uncompressedOffset = i * blockSize;
+    blocks.push_back({ dataOffset + offsets[i],
+                       end - offsets[i],
+                       uncompressedOffset,
+                       std::min(blockSize, dataSize - uncompressedOffset) });
+  }
+  m_IndexedReader = ParallelInflateReader::New();
+  m_IndexedReader->SetFileName(fileName);
+  m_IndexedReader->SetRawDeflateBlocks(blocks);
+}
+
+void
+MetaImageIO::ReadIndexedRegion(const ImageIORegion & region, void * buffer)
+{
+  const unsigned int nDims = this->GetNumberOfDimensions();
+  int                elementSize = 0;
+  MET_SizeOfType(m_MetaImage.ElementType(), &elementSize);
+  const auto pixelSize = static_cast<SizeValueType>(elementSize * m_MetaImage.ElementNumberOfChannels());
+
+  // The region in the file; dimensions beyond those of the region are read at index 0
+  std::vector<SizeValueType> start(nDims, 0);
+  std::vector<SizeValueType> size(nDims, 1);
+  std::vector<SizeValueType> stride(nDims);
+  SizeValueType              byteStride = pixelSize;
+  for (unsigned int i = 0; i < nDims; ++i)
+  {
+    if (i < region.GetImageDimension())
+    {
+      start[i] = static_cast<SizeValueType>(region.GetIndex(i));
+      size[i] = static_cast<SizeValueType>(region.GetSize(i));
+    }
+    stride[i] = byteStride;
+    byteStride *= static_cast<SizeValueType>(m_MetaImage.DimSize(i));
+  }
+
+  // One range per row of the region, merged with the previous one when they
+  // follow each other in the file
+  const SizeValueType                           rowSize = size[0] * pixelSize;
+  const SizeValueType                           numberOfPixels = region.GetNumberOfPixels();
+  std::vector<ParallelInflateReader::RangeType> ranges;
+  std::vector<SizeValueType>                    index(nDims, 0);
+  for (SizeValueType rowOffset = 0; rowOffset < numberOfPixels * pixelSize; rowOffset += rowSize)
+  {
+    SizeValueType offset = 0;
+    for (unsigned int i = 0; i < nDims; ++i)
+    {
+      offset += (start[i] + index[i]) * stride[i];
+    }
+    if (!ranges.empty() && ranges.back().offset + ranges.back().size == offset)
+    {
+      ranges.back().size += rowSize;
+    }
+    else
+    {
+      ranges.push_back({ offset, rowSize, static_cast<char *>(buffer) + rowOffset });
+    }
+    for (unsigned int i = 1; i < nDims && ++index[i] == size[i]; ++i)
+    {
+      index[i] = 0;
+    }
+  }
+  m_IndexedReader->Read(ranges);
+
+  m_MetaImage.ElementData(buffer, false);
+  m_MetaImage.ElementByteOrderFix(numberOfPixels);
+}
+
 void
 MetaImageIO::Read(void * buffer)
 {
@@ -320,7 +489,12 @@ MetaImageIO::Read(void * buffer)
     largestRegion.SetSize(i, this->GetDimensions(i));
   }
 
-  if (largestRegion != m_IORegion)
+  if (m_IndexedReader && m_SubSamplingFactor == 1)
+  {
+    // Only the blocks that hold the region are inflated, concurrently
+    this->ReadIndexedRegion(largestRegion != m_IORegion ? m_IORegion : largestRegion, buffer);
+  }
+  else if (largestRegion != m_IORegion)
   {
     const auto indexMin = make_unique_for_overwrite<int[]>(nDims);
     const auto indexMax = make_unique_for_overwrite<int[]>(nDims);
@@ -366,6 +540,76 @@ MetaImageIO::GetMetaImagePointer()
   return &m_MetaImage;
 }
 
+bool
+MetaImageIO::GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset) const
+{
+  const std::string dataFileName = m_MetaImage.ElementDataFileName();
+  int               elementSize = 0;
+  MET_SizeOfType(m_MetaImage.ElementType(), &elementSize);
+  if (!m_MetaImage.BinaryData() || m_MetaImage.CompressedData() || m_SubSamplingFactor != 1 || elementSize <= 0 ||
+      (elementSize > 1 && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB()) ||
+      dataFileName.find('%') != std::string::npos || dataFileName.find("LIST") != std::string::npos)
+  {
+    return false;
+  }
+
+  SizeValueType dataSize = static_cast<SizeValueType>(elementSize * m_MetaImage.ElementNumberOfChannels());
+  for (int i = 0; i < m_MetaImage.NDims(); ++i)
+  {
+    dataSize *= static_cast<SizeValueType>(m_MetaImage.DimSize(i));
+  }
+
+  if (dataFileName == "LOCAL")
+  {
+    fileName = m_FileName;
+  }
+  else
+  {
+    fileName = dataFileName;
+    const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+    if (!itksys::SystemTools::FileIsFullPath(fileName) && !path.empty())
+    {
+      fileName = path + '/' + fileName;
+    }
+  }
+
+  // A header size of -1 puts the data at the end of the file, and so does a
+  // local header that ends right before it
+  itksys::SystemTools::Stat_t fileStatus;
+  if (itksys::SystemTools::Stat(fileName, &fileStatus) != 0 ||
+      static_cast<SizeValueType>(fileStatus.st_size) < dataSize)
+  {
+    return false;
+  }
+  const auto fileSize = static_cast<SizeValueType>(fileStatus.st_size);
+  if (m_MetaImage.HeaderSize() > 0)
+  {
+    offset = static_cast<SizeValueType>(m_MetaImage.HeaderSize());
+  }
+  else if (m_MetaImage.HeaderSize() == -1)
+  {
+    offset = fileSize - dataSize;
+  }
+  else if (dataFileName == "LOCAL")
+  {
+    offset = fileSize - dataSize;
+    constexpr char lastField[] = "LOCAL\n";
+    const size_t   lastFieldSize = sizeof(lastField) - 1;
+    char           header[lastFieldSize];
+    std::ifstream  file(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (offset < lastFieldSize || !file.seekg(static_cast<std::streamoff>(offset - lastFieldSize)) ||
+        !file.read(header, lastFieldSize) || std::string(header, lastFieldSize) != lastField)
+    {
+      return false;
+    }
+  }
+  else
+  {
+    offset = 0;
+  }
+  return true;
+}
+
 bool
 MetaImageIO::CanWriteFile(const char * name)
 {
@@ -418,7 +662,8 @@ MetaImageIO::WriteImageInformation()
   const std::vector<std::string> keys = metaDict.GetKeys();
   for (auto & key : keys)
   {
-    if (key == ITK_ExperimentDate || key == ITK_VoxelUnits)
+    if (key == ITK_ExperimentDate || key == ITK_VoxelUnits || key == CompressedDataBlockSizeField ||
+        key == CompressedDataBlockOffsetsField)
     {
       continue;
     }
@@ -662,6 +907,14 @@ MetaImageIO::Write(const void * buffer)
     eOrigin[ii] = this->GetOrigin(ii);
   }
 
+  if (m_BlockOffsetFieldsAdded)
+  {
+    // Drop the offsets of the blocks of the previous file. The fields of the
+    // metadata dictionary go too, and are added again by WriteImageInformation.
+    m_MetaImage.ClearUserFields();
+    m_BlockOffsetFieldsAdded = false;
+  }
+
   m_MetaImage.InitializeEssential(
     numberOfDimensions, dSize.get(), eSpacing.get(), eType, nChannels, const_cast<void *>(buffer));
   m_MetaImage.Position(eOrigin.get());
@@ -726,9 +979,23 @@ MetaImageIO::Write(const void * buffer)
     largestRegion.SetSize(ii, this->GetDimensions(ii));
   }
 
-  if (m_UseCompression && (largestRegion != m_IORegion))
+  // Compressed element data in a single file is compressed here, on all
+  // the threads, rather than by MetaImage::Write, which deflates on one.
+  if (m_UseCompression && (largestRegion != m_IORegion || this->CanStreamCompressedWrite()))
   {
-    std::cout << "Compression in use: cannot stream the file writing" << std::endl;
+    if (!this->CanStreamCompressedWrite())
+    {
+      itkExceptionMacro("Compression in use: cannot stream the file writing: " << this->GetFileName());
+    }
+    try
+    {
+      this->WriteCompressedPiece(buffer);
+    }
+    catch (...)
+    {
+      this->DiscardCompressedPieces();
+      throw;
+    }
   }
   else if (largestRegion != m_IORegion)
   {
@@ -759,6 +1026,252 @@ MetaImageIO::Write(const void * buffer)
   }
 }
 
+bool
+MetaImageIO::CanStreamCompressedWrite() const
+{
+  return this->GetFileType() != IOFileEnum::ASCII &&
+         std::string(m_MetaImage.ElementDataFileName()).find('%') == std::string::npos;
+}
+
+void
+MetaImageIO::AddBlockOffsetFields(const ParallelDeflateCompressor * compressor, SizeValueType compressedDataSize)
+{
+  // The size of the compressed data ends the list of offsets
+  const std::string  blockSize = std::to_string(compressor->GetBlockSize());
+  std::ostringstream offsets;
+  for (const SizeValueType offset : compressor->GetBlockOffsets())
+  {
+    offsets << offset << ' ';
+  }
+  offsets << compressedDataSize;
+  const std::string offsetsValue = offsets.str();
+  m_MetaImage.AddUserField(
+    CompressedDataBlockSizeField, MET_STRING, static_cast<int>(blockSize.size()), blockSize.c_str(), true, -1);
+  m_MetaImage.AddUserField(
+    CompressedDataBlockOffsetsField, MET_STRING, static_cast<int>(offsetsValue.size()), offsetsValue.c_str(), true, -1);
+  m_BlockOffsetFieldsAdded = true;
+}
+
+void
+MetaImageIO::WriteCompressedPiece(const void * buffer)
+{
+  const unsigned int numberOfDimensions = this->GetNumberOfDimensions();
+
+  // The piece must be contiguous in the file: every dimension after the
+  // first one it does not span has a size of 1.
+  const auto    pieceSize = static_cast<SizeValueType>(m_IORegion.GetNumberOfPixels() * this->GetPixelSize());
+  SizeValueType pieceOffset = 0;
+  SizeValueType stride = this->GetPixelSize();
+  bool          contiguous = true;
+  bool          partial = false;
+  for (unsigned int ii = 0; ii < numberOfDimensions; ++ii)
+  {
+    contiguous = contiguous && (!partial || m_IORegion.GetSize(ii) == 1);
+    partial = partial || m_IORegion.GetSize(ii) != this->GetDimensions(ii);
+    pieceOffset += static_cast<SizeValueType>(m_IORegion.GetIndex(ii)) * stride;
+    stride *= this->GetDimensions(ii);
+  }
+  if (!contiguous)
+  {
+    itkExceptionMacro("Cannot compress the region " << m_IORegion << " as a piece of " << this->GetFileName()
+                                                    << ": it is not contiguous in the file.");
+  }
+
+  const auto imageSize = static_cast<SizeValueType>(this->GetImageSizeInBytes());
+  if (pieceOffset == 0)
+  {
+    // The first piece: choose where the compressed data goes, the same way
+    // as MetaImage::Write does.
+    this->DiscardCompressedPieces();
+    std::string dataFileName = m_MetaImage.ElementDataFileName();
+    m_StreamingElementDataFileName = dataFileName;
+    if (dataFileName.empty())
+    {
+      if (itksys::SystemTools::GetFilenameLastExtension(m_FileName) == ".mha")
+      {
+        dataFileName = "LOCAL";
+      }
+      else
+      {
+        dataFileName = m_FileName;
+        MET_SetFileSuffix(dataFileName, "zraw");
+      }
+    }
+    if (m_StreamingElementDataFileName.empty())
+    {
+      m_StreamingElementDataFileName = dataFileName;
+    }
+    m_StreamingLocalData = (dataFileName == "LOCAL");
+    if (m_StreamingLocalData && pieceSize == imageSize)
+    {
+      // The whole image at once: the compressed data is kept in memory
+      // until the header is written.
+      m_StreamingDataFileName.clear();
+    }
+    else if (m_StreamingLocalData)
+    {
+      m_StreamingDataFileName = m_FileName + ".part";
+    }
+    else
+    {
+      std::string path;
+      if (MET_GetFilePath(m_FileName, path) && !itksys::SystemTools::FileIsFullPath(dataFileName) &&
+          dataFileName.compare(0, path.size(), path) != 0)
+      {
+        dataFileName = path + dataFileName;
+      }
+      m_StreamingDataFileName = dataFileName;
+    }
+
+    m_StreamingCompressor = ParallelDeflateCompressor::New();
+    m_StreamingCompressor->SetStreamFormat(ParallelDeflateCompressor::StreamFormatEnum::Zlib);
+    const int compressionLevel = this->GetCompressionLevel();
+    // A negative level asks for the zlib default
+    m_StreamingCompressor->SetCompressionLevel(compressionLevel < 0 ? 6 : compressionLevel);
+    if (m_SeekableCompression || pieceSize != imageSize)
+    {
+      // The blocks are independent, so that the file can be read by region
+      // as well; their size depends on the whole image, not on the pieces.
+      m_StreamingCompressor->SetIndependentBlocks(true);
+      m_StreamingCompressor->SetBlockSize(std::max(m_StreamingCompressor->GetBlockSize(),
+                                                   (imageSize + MaximumNumberOfCompressedDataBlocks - 1) /
+                                                     MaximumNumberOfCompressedDataBlocks));
+    }
+
+    m_StreamingLocalBuffer.clear();
+    m_StreamingDataFile.close();
+    m_StreamingDataFile.clear();
+    if (m_StreamingDataFileName.empty())
+    {
+      m_StreamingCompressor->Begin(
+        [this](const char * data, SizeValueType size) { m_StreamingLocalBuffer.append(data, size); });
+    }
+    else
+    {
+      m_StreamingDataFile.open(m_StreamingDataFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!m_StreamingDataFile.is_open())
+      {
+        itkExceptionMacro("File cannot be written: " << m_StreamingDataFileName << std::endl
+                                                     << "Reason: " << itksys::SystemTools::GetLastSystemError());
+      }
+      m_StreamingCompressor->Begin(m_StreamingDataFile);
+    }
+  }
+  else if (m_StreamingCompressor.IsNull() || pieceOffset != m_StreamingCompressor->GetNumberOfInputBytes())
+  {
+    itkExceptionMacro("Cannot compress the region " << m_IORegion << " as a piece of " << this->GetFileName()
+                                                    << ": the pieces must be written in the order of the file.");
+  }
+
+  m_StreamingCompressor->Write(buffer, pieceSize);
+  if (m_StreamingCompressor->GetNumberOfInputBytes() < imageSize)
+  {
+    if (!m_StreamingDataFile)
+    {
+      itkExceptionMacro("File cannot be written: " << m_StreamingDataFileName);
+    }
+    return;
+  }
+
+  // The last piece: the size of the compressed data is now known, and the
+  // header can be written.
+  const ParallelDeflateCompressor::Pointer compressor = m_StreamingCompressor;
+  m_StreamingCompressor = nullptr;
+  compressor->End();
+  if (!m_StreamingDataFileName.empty())
+  {
+    m_StreamingDataFile.close();
+    if (!m_StreamingDataFile)
+    {
+      itkExceptionMacro("File cannot be written: " << m_StreamingDataFileName);
+    }
+  }
+
+  const SizeValueType compressedDataSize = compressor->GetNumberOfOutputBytes();
+  if (compressor->GetIndependentBlocks())
+  {
+    this->AddBlockOffsetFields(compressor, compressedDataSize);
+  }
+  if (!m_MetaImage.WriteCompressedDataHeader(m_FileName.c_str(),
+                                             m_StreamingElementDataFileName.c_str(),
+                                             static_cast<std::streamoff>(compressedDataSize)))
+  {
+    itkExceptionMacro("File cannot be written: " << this->GetFileName() << std::endl
+                                                 << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+
+  if (m_StreamingLocalData)
+  {
+    // Move the compressed data after the header
+    std::ofstream headerFile(m_FileName.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+    if (m_StreamingDataFileName.empty())
+    {
+      headerFile.write(m_StreamingLocalBuffer.data(), static_cast<std::streamsize>(m_StreamingLocalBuffer.size()));
+      std::string().swap(m_StreamingLocalBuffer);
+    }
+    else
+    {
+      std::ifstream dataFile(m_StreamingDataFileName.c_str(), std::ios::in | std::ios::binary);
+      headerFile << dataFile.rdbuf();
+      dataFile.close();
+      itksys::SystemTools::RemoveFile(m_StreamingDataFileName);
+      m_StreamingDataFileName.clear();
+    }
+    headerFile.close();
+    if (!headerFile)
+    {
+      itkExceptionMacro("File cannot be written: " << this->GetFileName() << std::endl
+                                                   << "Reason: " << itksys::SystemTools::GetLastSystemError());
+    }
+  }
+}
+
+void
+MetaImageIO::DiscardCompressedPieces()
+{
+  m_StreamingCompressor = nullptr;
+  m_StreamingDataFile.close();
+  m_StreamingDataFile.clear();
+  std::string().swap(m_StreamingLocalBuffer);
+  if (m_StreamingLocalData && !m_StreamingDataFileName.empty())
+  {
+    // The temporary file of a LOCAL file
+    itksys::SystemTools::RemoveFile(m_StreamingDataFileName);
+  }
+  m_StreamingDataFileName.clear();
+  m_StreamingLocalData = false;
+}
+
+bool
+MetaImageIO::HeaderMetaImage::WriteCompressedDataHeader(const char *   headName,
+                                                        const char *   dataName,
+                                                        std::streamoff compressedDataSize)
+{
+  // MetaImage::Write compresses the element data itself when it is said to
+  // be compressed, so it is only said to be while the fields are set up.
+  // Write forgets a data file name it is given: the one set before is kept.
+  const std::string elementDataFileName = this->ElementDataFileName();
+  this->CompressedData(false);
+  m_HeaderCompressedDataSize = compressedDataSize;
+  const bool written = this->Write(headName, dataName, false);
+  m_HeaderCompressedDataSize = -1;
+  m_CompressedDataSize = 0;
+  this->CompressedData(true);
+  this->ElementDataFileName(elementDataFileName.c_str());
+  return written;
+}
+
+void
+MetaImageIO::HeaderMetaImage::M_SetupWriteFields()
+{
+  if (m_HeaderCompressedDataSize >= 0)
+  {
+    m_CompressedData = true;
+    m_CompressedDataSize = m_HeaderCompressedDataSize;
+  }
+  MetaImage::M_SetupWriteFields();
+}
+
 /** Given a requested region, determine what could be the region that we can
  * read from the file. This is called the streamable region, which will be
  * smaller than the LargestPossibleRegion and greater or equal to the
@@ -795,17 +1308,19 @@ MetaImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfReq
 {
   if (this->GetUseCompression())
   {
-    // we can not stream or paste with compression
+    // we can not paste with compression, and only stream when the
+    // compressed data is written to a single file
     if (pasteRegion != largestPossibleRegion)
     {
       itkExceptionMacro("Pasting and compression is not supported! Can't write:" << this->GetFileName());
     }
-    else if (numberOfRequestedSplits != 1)
+    else if (numberOfRequestedSplits != 1 && !this->CanStreamCompressedWrite())
     {
       itkDebugMacro("Requested streaming and compression");
       itkDebugMacro("Meta IO is not streaming now!");
+      return 1;
     }
-    return 1;
+    return GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits, pasteRegion);
   }
 
   if (!itksys::SystemTools::FileExists(m_FileName.c_str()))
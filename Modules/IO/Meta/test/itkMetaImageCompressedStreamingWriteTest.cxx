@@ -0,0 +1,137 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMetaImageIO.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkTestingMacros.h"
+#include "itkTestVerifyImageRegion.h"
+#include "itksys/SystemTools.hxx"
+
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+} // namespace
+
+
+int
+itkMetaImageCompressedStreamingWriteTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 211, 157, 37 } });
+  image->Allocate();
+  short value = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<short>(it.GetIndex()[2] * 100 + (value & 15)));
+    value = static_cast<short>(value * 31 + 7);
+  }
+
+  // An uncompressed file, which the reader streams to the writer
+  const std::string inputFileName = directory + "/itkMetaImageCompressedStreamingWriteTestInput.mha";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, inputFileName));
+
+  const std::string localFileName = directory + "/itkMetaImageCompressedStreamingWriteTest.mha";
+  const std::string detachedFileName = directory + "/itkMetaImageCompressedStreamingWriteTest.mhd";
+  constexpr unsigned int numberOfStreamDivisions = 7;
+  for (const auto & fileName : { localFileName, detachedFileName })
+  {
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(inputFileName);
+    reader->UseStreamingOn();
+
+    auto monitor = itk::PipelineMonitorImageFilter<ImageType>::New();
+    monitor->SetInput(reader->GetOutput());
+
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(monitor->GetOutput());
+    writer->SetImageIO(itk::MetaImageIO::New());
+    writer->SetFileName(fileName);
+    writer->UseCompressionOn();
+    writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+    // The image was never held in memory as a whole
+    ITK_TEST_EXPECT_TRUE(monitor->VerifyAllInputCanStream(numberOfStreamDivisions));
+
+    auto readIO = itk::MetaImageIO::New();
+    readIO->SetFileName(fileName);
+    readIO->ReadImageInformation();
+    ITK_TEST_EXPECT_TRUE(readIO->CanStreamRead());
+  }
+
+  // Pieces that do not follow each other in the file cannot be compressed
+  auto io = itk::MetaImageIO::New();
+  io->SetFileName(directory + "/itkMetaImageCompressedStreamingWriteTestOutOfOrder.mha");
+  io->SetUseCompression(true);
+  io->SetNumberOfDimensions(3);
+  io->SetComponentType(itk::IOComponentEnum::SHORT);
+  for (unsigned int ii = 0; ii < 3; ++ii)
+  {
+    io->SetDimensions(ii, image->GetLargestPossibleRegion().GetSize(ii));
+  }
+  itk::ImageIORegion ioRegion(3);
+  ioRegion.SetIndex(2, 5);
+  ioRegion.SetSize(0, 211);
+  ioRegion.SetSize(1, 157);
+  ioRegion.SetSize(2, 1);
+  io->SetIORegion(ioRegion);
+  ITK_TRY_EXPECT_EXCEPTION(io->Write(image->GetBufferPointer()));
+
+  // A failed write does not leave the temporary file of a LOCAL file behind
+  ioRegion.SetIndex(2, 0);
+  io->SetIORegion(ioRegion);
+  ITK_TRY_EXPECT_NO_EXCEPTION(io->Write(image->GetBufferPointer()));
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(io->GetFileName() + std::string(".part")));
+  ioRegion.SetIndex(2, 5);
+  io->SetIORegion(ioRegion);
+  ITK_TRY_EXPECT_EXCEPTION(io->Write(image->GetBufferPointer()));
+  ITK_TEST_EXPECT_TRUE(!itksys::SystemTools::FileExists(io->GetFileName() + std::string(".part")));
+
+  // The whole image, and a region inside the image
+  const ImageType::RegionType inner({ { 30, 20, 11 } }, { { 50, 41, 20 } });
+  for (const auto & region : { image->GetLargestPossibleRegion(), inner })
+  {
+    for (const auto & fileName : { localFileName, detachedFileName })
+    {
+      auto reader = itk::ImageFileReader<ImageType>::New();
+      reader->SetFileName(fileName);
+      reader->GetOutput()->SetRequestedRegion(region);
+      ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+      ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+      if (!itk::Testing::VerifyImageRegion(image.GetPointer(), reader->GetOutput(), region))
+      {
+        std::cerr << "Test failed reading " << region << " of " << fileName << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMetaImageIO.h"
+#include "itkTestingMacros.h"
+#include "itkTestVerifyImageRegion.h"
+
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+} // namespace
+
+
+int
+itkMetaImageSeekableCompressionTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 97, 83, 61 } });
+  image->Allocate();
+  unsigned int state = 1;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    state = state * 1103515245u + 12345u;
+    it.Set(static_cast<float>(it.GetIndex()[2] * 10 + ((state >> 16) & 3)));
+  }
+
+  auto io = itk::MetaImageIO::New();
+  ITK_TEST_SET_GET_BOOLEAN(io, SeekableCompression, true);
+
+  // Data after the header, and in a file of its own
+  const std::string localFileName = directory + "/itkMetaImageSeekableCompressionTest.mha";
+  const std::string detachedFileName = directory + "/itkMetaImageSeekableCompressionTest.mhd";
+  const std::string plainFileName = directory + "/itkMetaImageSeekableCompressionTestPlain.mha";
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetImageIO(io);
+  writer->UseCompressionOn();
+  for (const auto & fileName : { localFileName, detachedFileName })
+  {
+    writer->SetFileName(fileName);
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  }
+
+  // The same IO writes an ordinary compressed file afterwards
+  io->SeekableCompressionOff();
+  writer->SetFileName(plainFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  for (const auto & fileName : { localFileName, detachedFileName, plainFileName })
+  {
+    auto readIO = itk::MetaImageIO::New();
+    readIO->SetFileName(fileName);
+    readIO->ReadImageInformation();
+    ITK_TEST_EXPECT_EQUAL(readIO->CanStreamRead(), fileName != plainFileName);
+
+    // The offsets of the blocks are not metadata of the image
+    std::string value;
+    ITK_TEST_EXPECT_TRUE(
+      !itk::ExposeMetaData<std::string>(readIO->GetMetaDataDictionary(), "CompressedDataBlockOffsets", value));
+  }
+
+  // The whole image, a region inside the image, and whole slices
+  const ImageType::RegionType inner({ { 3, 20, 11 } }, { { 50, 41, 30 } });
+  const ImageType::RegionType slices({ { 0, 0, 40 } }, { { 97, 83, 21 } });
+  for (const auto & region : { image->GetLargestPossibleRegion(), inner, slices })
+  {
+    for (const auto & fileName : { localFileName, detachedFileName, plainFileName })
+    {
+      auto reader = itk::ImageFileReader<ImageType>::New();
+      reader->SetImageIO(itk::MetaImageIO::New());
+      reader->SetFileName(fileName);
+      reader->GetOutput()->SetRequestedRegion(region);
+      ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+      ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+      if (!itk::Testing::VerifyImageRegion(image.GetPointer(), reader->GetOutput(), region))
+      {
+        std::cerr << "Test failed reading " << region << " of " << fileName << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
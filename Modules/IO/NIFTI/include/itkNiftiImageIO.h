@@ -24,6 +24,7 @@
 #include <fstream>
 #include <memory>
 #include "itkImageIOBase.h"
+#include "itkParallelInflateReader.h"
 
 
 namespace itk
@@ -159,6 +160,17 @@ public:
   void
   Read(void * buffer) override;
 
+  /** A region of an uncompressed file, or of a .nii.gz file written with
+   * SeekableCompression, is read without reading the rest of the file. */
+  bool
+  CanStreamRead() override;
+
+  /** An uncompressed file in the byte order of the system holds its pixels
+   * as Read() would read them, unless they are rescaled, converted from RAS,
+   * or vectors, whose components NIfTI stores in separate volumes. */
+  bool
+  GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset) const override;
+
   //-------- This part of the interfaces deals with writing data. -----
 
   /** Determine if the file can be written with this ImageIO implementation.
@@ -239,6 +251,16 @@ public:
   itkGetConstMacro(SFORM_Permissive, bool);
   itkBooleanMacro(SFORM_Permissive);
   /** @ITKEndGrouping */
+
+  /** Write a single .nii.gz file as a sequence of independently compressed
+   * gzip members, each giving its size in its header, so that a region can
+   * later be read by inflating only the members that hold it. The file stays
+   * readable by any gzip reader and is slightly larger. The default is false. */
+  /** @ITKStartGrouping */
+  itkSetMacro(SeekableCompression, bool);
+  itkGetConstMacro(SeekableCompression, bool);
+  itkBooleanMacro(SeekableCompression);
+  /** @ITKEndGrouping */
 protected:
   NiftiImageIO();
   ~NiftiImageIO() override;
@@ -281,6 +303,16 @@ private:
   void
   SetImageIOMetadataFromNIfTI();
 
+  /** Write the header and \c data. A single .nii.gz file is compressed with
+   * ParallelDeflateCompressor, other files are written by the nifti library. */
+  void
+  WriteNiftiImage(void * data);
+
+  /** Read a region of the file through m_IndexedReader, in the layout of
+   * nifti_read_subregion_image. The returned buffer is allocated by malloc. */
+  void *
+  ReadIndexedRegion(const int * origin, const int * size) const;
+
   double m_RescaleSlope{ 1.0 };
   double m_RescaleIntercept{ 0.0 };
 
@@ -294,6 +326,17 @@ private:
 
   bool m_SFORM_Permissive{ false };
   bool m_SFORM_Corrected{ false };
+
+  bool m_SeekableCompression{ false };
+
+  /** Locates the members of a .nii.gz file written with SeekableCompression;
+   * null for an uncompressed file. */
+  ParallelInflateReader::Pointer m_IndexedReader{};
+
+  /** The file of the pixel data and their offset in it, when it is neither
+   * compressed nor in the other byte order; empty otherwise. */
+  std::string   m_RawPixelDataFileName{};
+  SizeValueType m_RawPixelDataOffset{ 0 };
 };
 
 
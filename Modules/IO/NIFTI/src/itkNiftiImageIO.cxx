@@ -24,9 +24,11 @@
 #include <nifti1_io.h>
 #include "itkNiftiImageIOConfigurePrivate.h"
 #include "itkMakeUniqueForOverwrite.h"
+#include "itkParallelDeflateCompressor.h"
 #include "itkStringConvert.h"
 #include "itksys/SystemTools.hxx"
 #include "itksys/SystemInformation.hxx"
+#include <cmath>
 
 namespace itk
 {
@@ -176,6 +178,10 @@ NiftiImageIO::NiftiImageIO()
   this->SetNumberOfDimensions(3);
   nifti_set_debug_level(0); // suppress error messages
 
+  // .nii.gz files are compressed with deflate, at the zlib default level
+  this->Self::SetMaximumCompressionLevel(9);
+  this->Self::SetCompressionLevel(6);
+
   const char * extensions[] = { ".nia", ".nii", ".nii.gz", ".hdr", ".img", ".img.gz" };
 
   for (auto ext : extensions)
@@ -211,6 +217,8 @@ NiftiImageIO::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "OnDiskComponentType: " << m_OnDiskComponentType << std::endl;
   os << indent << "LegacyAnalyze75Mode: " << m_LegacyAnalyze75Mode << std::endl;
   os << indent << "SFORM permissive: " << (m_SFORM_Permissive ? "On" : "Off") << std::endl;
+  itkPrintSelfBooleanMacro(SeekableCompression);
+  itkPrintSelfObjectMacro(IndexedReader);
 }
 
 bool
@@ -286,8 +294,100 @@ ConvertRASToFromLPS_XYZTC(TBuffer * buffer, size_t size)
     buffer[i] *= -1;
   }
 }
+
+// nifti_read_buffer sets the floating point values that are not finite to 0
+template <typename TBuffer>
+void
+ReplaceNonFinite(TBuffer * buffer, size_t size)
+{
+  for (size_t i = 0; i < size; ++i)
+  {
+    if (!std::isfinite(buffer[i]))
+    {
+      buffer[i] = 0;
+    }
+  }
+}
 } // namespace
 
+bool
+NiftiImageIO::CanStreamRead()
+{
+  // nifti_read_subregion_image has to inflate a compressed file from its start
+  return m_IndexedReader.IsNull() || !m_IndexedReader->GetBlocks().empty();
+}
+
+void *
+NiftiImageIO::ReadIndexedRegion(const int * origin, const int * size) const
+{
+  const nifti_image * nim = m_Holder->ptr.get();
+  const auto          bytesPerPixel = static_cast<SizeValueType>(nim->nbyper);
+
+  // Distance in pixels between neighbors along each dimension of the file
+  SizeValueType stride[7];
+  SizeValueType numberOfPixels = 1;
+  SizeValueType pixelStride = 1;
+  for (unsigned int i = 0; i < 7; ++i)
+  {
+    stride[i] = pixelStride;
+    pixelStride *= static_cast<SizeValueType>(std::max(nim->dim[i + 1], 1));
+    numberOfPixels *= static_cast<SizeValueType>(size[i]);
+  }
+
+  // One range per row of the region, merged with the previous one when they
+  // follow each other in the file
+  const SizeValueType                           rowSize = static_cast<SizeValueType>(size[0]) * bytesPerPixel;
+  const SizeValueType                           numberOfBytes = numberOfPixels * bytesPerPixel;
+  auto *                                        data = static_cast<char *>(malloc(numberOfBytes));
+  std::vector<ParallelInflateReader::RangeType> ranges;
+  int                                           index[7] = { 0, 0, 0, 0, 0, 0, 0 };
+  for (SizeValueType rowOffset = 0; rowOffset < numberOfBytes; rowOffset += rowSize)
+  {
+    SizeValueType pixelOffset = 0;
+    for (unsigned int i = 0; i < 7; ++i)
+    {
+      pixelOffset += static_cast<SizeValueType>(origin[i] + index[i]) * stride[i];
+    }
+    const SizeValueType offset = static_cast<SizeValueType>(nim->iname_offset) + pixelOffset * bytesPerPixel;
+    if (!ranges.empty() && ranges.back().offset + ranges.back().size == offset)
+    {
+      ranges.back().size += rowSize;
+    }
+    else
+    {
+      ranges.push_back({ offset, rowSize, data + rowOffset });
+    }
+    for (unsigned int i = 1; i < 7 && ++index[i] == size[i]; ++i)
+    {
+      index[i] = 0;
+    }
+  }
+  try
+  {
+    m_IndexedReader->Read(ranges);
+  }
+  catch (...)
+  {
+    free(data);
+    throw;
+  }
+
+  // Same conversions as nifti_read_buffer
+  if (nim->swapsize > 1 && nim->byteorder != nifti_short_order())
+  {
+    nifti_swap_Nbytes(numberOfBytes / nim->swapsize, nim->swapsize, data);
+  }
+  if (nim->datatype == NIFTI_TYPE_FLOAT32 || nim->datatype == NIFTI_TYPE_COMPLEX64)
+  {
+    ReplaceNonFinite(reinterpret_cast<float *>(data), numberOfBytes / sizeof(float));
+  }
+  else if (nim->datatype == NIFTI_TYPE_FLOAT64 || nim->datatype == NIFTI_TYPE_COMPLEX128)
+  {
+    ReplaceNonFinite(reinterpret_cast<double *>(data), numberOfBytes / sizeof(double));
+  }
+  return data;
+}
+
 void
 NiftiImageIO::Read(void * buffer)
 {
@@ -350,9 +450,15 @@ NiftiImageIO::Read(void * buffer)
         break;
       }
     }
+    // a file written with SeekableCompression is read by parts either way
+    if (m_IndexedReader && !m_IndexedReader->GetBlocks().empty() &&
+        m_IndexedReader->GetFileName() == m_Holder->ptr->iname)
+    {
+      data = this->ReadIndexedRegion(_origin, _size);
+    }
     // if all dimensions match requested size, just read in
     // all data as a block
-    if (i == this->GetNumberOfDimensions())
+    else if (i == this->GetNumberOfDimensions())
     {
       if (nifti_image_load(m_Holder->ptr.get()) == -1)
       {
@@ -582,6 +688,21 @@ NiftiImageIO::Read(void * buffer)
   }
 }
 
+bool
+NiftiImageIO::GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset) const
+{
+  const unsigned int numComponents = this->GetNumberOfComponents();
+  if (m_RawPixelDataFileName.empty() || this->MustRescale() || this->m_ConvertRAS ||
+      (numComponents > 1 && this->GetPixelType() != IOPixelEnum::COMPLEX &&
+       this->GetPixelType() != IOPixelEnum::RGB && this->GetPixelType() != IOPixelEnum::RGBA))
+  {
+    return false;
+  }
+  fileName = m_RawPixelDataFileName;
+  offset = m_RawPixelDataOffset;
+  return true;
+}
+
 NiftiImageIOEnums::NiftiFileEnum
 NiftiImageIO::DetermineFileType(const char * FileNameToRead)
 {
@@ -779,6 +900,27 @@ NiftiImageIO::ReadImageInformation()
   {
     itkExceptionMacro(<< this->GetFileName() << " is not recognized as a NIFTI file");
   }
+  // A single .nii.gz file written with SeekableCompression can be read by
+  // parts; for any other compressed file the index is not found at the
+  // first gzip header and the reader is left without blocks.
+  m_IndexedReader = nullptr;
+  if (nifti_is_gzfile(m_Holder->ptr->iname))
+  {
+    m_IndexedReader = ParallelInflateReader::New();
+    m_IndexedReader->SetFileName(m_Holder->ptr->iname);
+    if (m_Holder->ptr->nifti_type == NIFTI_FTYPE_NIFTI1_1)
+    {
+      m_IndexedReader->ReadGzipMemberIndex();
+    }
+  }
+  m_RawPixelDataFileName.clear();
+  m_RawPixelDataOffset = 0;
+  if (!nifti_is_gzfile(m_Holder->ptr->iname) && m_Holder->ptr->iname_offset >= 0 &&
+      (m_Holder->ptr->swapsize <= 1 || m_Holder->ptr->byteorder == nifti_short_order()))
+  {
+    m_RawPixelDataFileName = m_Holder->ptr->iname;
+    m_RawPixelDataOffset = static_cast<SizeValueType>(m_Holder->ptr->iname_offset);
+  }
   // Check the intent code, it is a vector image, or matrix image, then this is
   // not true.
   //
@@ -2090,17 +2232,7 @@ NiftiImageIO::Write(const void * buffer)
   {
     // Need a const cast here so that we don't have to copy the memory
     // for writing.
-    m_Holder->ptr->data = const_cast<void *>(buffer);
-    const int nifti_write_status = nifti_image_write_status(m_Holder->ptr.get());
-    m_Holder->ptr->data = nullptr; // Must free before throwing exception.
-                                   // if left pointing to data buffer
-                                   // nifti_image_free inside Destructor of ITKNiftiIO
-                                   // will try and free this memory, and then
-                                   // so will destructor of the image that really owns it.
-    if (nifti_write_status)
-    {
-      itkExceptionMacro("ERROR: nifti library failed to write image: " << this->GetFileName());
-    }
+    this->WriteNiftiImage(const_cast<void *>(buffer));
   }
   else /// Image intent is vector image
   {
@@ -2196,15 +2328,55 @@ NiftiImageIO::Write(const void * buffer)
     }
 
     delete[] vecOrder;
-    // Need a const cast here so that we don't have to copy the memory for
-    // writing.
-    m_Holder->ptr->data = static_cast<void *>(nifti_buf.get());
-    const int nifti_write_status = nifti_image_write_status(m_Holder->ptr.get());
-    m_Holder->ptr->data = nullptr; // if left pointing to data buffer
+    this->WriteNiftiImage(static_cast<void *>(nifti_buf.get()));
+  }
+}
+
+void
+NiftiImageIO::WriteNiftiImage(void * data)
+{
+  nifti_image * nim = m_Holder->ptr.get();
+
+  // The nifti library compresses with a single gzip stream; a single file
+  // without extensions is simple enough to be laid out here instead, which
+  // lets the deflate run on all the work units.
+  if (nim->nifti_type != NIFTI_FTYPE_NIFTI1_1 || nim->num_ext > 0 || !nifti_is_gzfile(nim->fname))
+  {
+    nim->data = data;
+    const int nifti_write_status = nifti_image_write_status(nim);
+    nim->data = nullptr; // Must free before throwing exception.
+                         // if left pointing to data buffer
+                         // nifti_image_free inside Destructor of ITKNiftiIO
+                         // will try and free this memory, and then
+                         // so will destructor of the image that really owns it.
     if (nifti_write_status)
     {
       itkExceptionMacro("ERROR: nifti library failed to write image: " << this->GetFileName());
     }
+    return;
+  }
+
+  // Header, empty extender and padding up to the offset of the data
+  nifti_set_iname_offset(nim);
+  const nifti_1_header header = nifti_convert_nim2nhdr(nim);
+  std::string          prefix(static_cast<size_t>(nim->iname_offset), '\0');
+  memcpy(&prefix[0], &header, sizeof(header));
+
+  std::ofstream file;
+  this->OpenFileForWriting(file, nim->fname);
+
+  auto compressor = ParallelDeflateCompressor::New();
+  compressor->SetCompressionLevel(this->GetCompressionLevel());
+  compressor->SetIndependentBlocks(m_SeekableCompression);
+  compressor->Begin(file);
+  compressor->Write(prefix.data(), prefix.size());
+  compressor->Write(data, nifti_get_volsize(nim));
+  compressor->End();
+
+  file.close();
+  if (file.fail())
+  {
+    itkExceptionMacro("ERROR: failed to write image: " << this->GetFileName());
   }
 }
 
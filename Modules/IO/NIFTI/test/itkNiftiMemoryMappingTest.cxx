@@ -0,0 +1,133 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMemoryMappedImportImageContainer.h"
+#include "itkNiftiImageIO.h"
+#include "itkTestingMacros.h"
+#include "itkVector.h"
+
+
+namespace
+{
+template <typename TImage>
+bool
+IsMapped(const TImage * image)
+{
+  using PixelContainerType = typename TImage::PixelContainer;
+  using MappedContainerType = itk::MemoryMappedImportImageContainer<typename PixelContainerType::ElementIdentifier,
+                                                                    typename PixelContainerType::Element>;
+  return dynamic_cast<const MappedContainerType *>(image->GetPixelContainer()) != nullptr;
+}
+
+template <typename TImage>
+bool
+SameImages(const TImage * expected, const TImage * actual)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(expected, expected->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    if (it.Get() != actual->GetPixel(it.GetIndex()))
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " differs." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TImage>
+typename TImage::Pointer
+ReadMapped(const std::string & fileName)
+{
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::NiftiImageIO::New());
+  reader->UseMemoryMappingOn();
+  reader->Update();
+  return reader->GetOutput();
+}
+} // namespace
+
+
+int
+itkNiftiMemoryMappingTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  using ImageType = itk::Image<short, 3>;
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 41, 33, 17 } });
+  image->Allocate();
+  short value = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value = static_cast<short>(value * 31 + 7);
+  }
+
+  // The pixels of a .nii file follow its header, and a .img file holds only pixels
+  for (const std::string extension : { ".nii", ".hdr" })
+  {
+    const std::string fileName = directory + "/itkNiftiMemoryMappingTest" + extension;
+    ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, fileName));
+    ImageType::Pointer mapped;
+    ITK_TRY_EXPECT_NO_EXCEPTION(mapped = ReadMapped<ImageType>(fileName));
+    ITK_TEST_EXPECT_TRUE(IsMapped(mapped.GetPointer()));
+    ITK_TEST_EXPECT_TRUE(SameImages(image.GetPointer(), mapped.GetPointer()));
+  }
+
+  // Compressed pixels are read
+  const std::string compressedFileName = directory + "/itkNiftiMemoryMappingTest.nii.gz";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, compressedFileName, true));
+  ImageType::Pointer compressed;
+  ITK_TRY_EXPECT_NO_EXCEPTION(compressed = ReadMapped<ImageType>(compressedFileName));
+  ITK_TEST_EXPECT_TRUE(!IsMapped(compressed.GetPointer()));
+  ITK_TEST_EXPECT_TRUE(SameImages(image.GetPointer(), compressed.GetPointer()));
+
+  // So are vectors, whose components are stored in separate volumes
+  using VectorImageType = itk::Image<itk::Vector<float, 3>, 3>;
+  auto vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(VectorImageType::SizeType{ { 11, 7, 5 } });
+  vectorImage->Allocate();
+  for (itk::ImageRegionIterator<VectorImageType> it(vectorImage, vectorImage->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    const auto & index = it.GetIndex();
+    it.Set(itk::MakeVector(static_cast<float>(index[0]), index[1] * 0.5f, index[2] * -2.0f));
+  }
+  const std::string vectorFileName = directory + "/itkNiftiMemoryMappingTestVector.nii";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(vectorImage, vectorFileName));
+  VectorImageType::Pointer vectors;
+  ITK_TRY_EXPECT_NO_EXCEPTION(vectors = ReadMapped<VectorImageType>(vectorFileName));
+  ITK_TEST_EXPECT_TRUE(!IsMapped(vectors.GetPointer()));
+  ITK_TEST_EXPECT_TRUE(SameImages(vectorImage.GetPointer(), vectors.GetPointer()));
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
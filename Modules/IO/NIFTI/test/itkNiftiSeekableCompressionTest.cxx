@@ -0,0 +1,138 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkNiftiImageIO.h"
+#include "itkVectorImage.h"
+#include "itkTestingMacros.h"
+#include "itkTestVerifyImageRegion.h"
+
+
+int
+itkNiftiSeekableCompressionTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  using ImageType = itk::Image<short, 3>;
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 101, 93, 47 } });
+  image->Allocate();
+  short value = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value = static_cast<short>(value * 31 + 7);
+  }
+
+  const std::string seekableFileName = directory + "/itkNiftiSeekableCompressionTest.nii.gz";
+  const std::string plainFileName = directory + "/itkNiftiSeekableCompressionTestPlain.nii.gz";
+
+  auto io = itk::NiftiImageIO::New();
+  ITK_TEST_SET_GET_BOOLEAN(io, SeekableCompression, true);
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetImageIO(io);
+  writer->UseCompressionOn();
+  writer->SetFileName(seekableFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  io->SeekableCompressionOff();
+  writer->SetFileName(plainFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // Only the file written with SeekableCompression can be read by parts
+  auto readIO = itk::NiftiImageIO::New();
+  readIO->SetFileName(seekableFileName);
+  readIO->ReadImageInformation();
+  ITK_TEST_EXPECT_TRUE(readIO->CanStreamRead());
+  readIO->SetFileName(plainFileName);
+  readIO->ReadImageInformation();
+  ITK_TEST_EXPECT_TRUE(!readIO->CanStreamRead());
+
+  // The whole image, a region inside the image, and a region along the x axis
+  ImageType::RegionType inner({ { 17, 5, 30 } }, { { 40, 60, 9 } });
+  ImageType::RegionType rows({ { 0, 50, 3 } }, { { 101, 20, 40 } });
+  for (const auto & region : { image->GetLargestPossibleRegion(), inner, rows })
+  {
+    for (const auto & fileName : { seekableFileName, plainFileName })
+    {
+      auto reader = itk::ImageFileReader<ImageType>::New();
+      reader->SetImageIO(itk::NiftiImageIO::New());
+      reader->SetFileName(fileName);
+      reader->GetOutput()->SetRequestedRegion(region);
+      ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+      ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+      if (!itk::Testing::VerifyImageRegion(image.GetPointer(), reader->GetOutput(), region))
+      {
+        std::cerr << "Test failed reading " << region << " of " << fileName << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // Vector pixels, which nifti stores in a dimension of their own
+  using VectorImageType = itk::VectorImage<float, 3>;
+  auto vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(VectorImageType::SizeType{ { 31, 17, 29 } });
+  vectorImage->SetNumberOfComponentsPerPixel(3);
+  vectorImage->Allocate();
+  float vectorValue = 0.5f;
+  for (itk::ImageRegionIterator<VectorImageType> it(vectorImage, vectorImage->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    VectorImageType::PixelType pixel(3);
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      pixel[c] = vectorValue;
+      vectorValue += 0.25f;
+    }
+    it.Set(pixel);
+  }
+
+  const std::string vectorFileName = directory + "/itkNiftiSeekableCompressionTestVector.nii.gz";
+  io->SeekableCompressionOn();
+  auto vectorWriter = itk::ImageFileWriter<VectorImageType>::New();
+  vectorWriter->SetInput(vectorImage);
+  vectorWriter->SetImageIO(io);
+  vectorWriter->UseCompressionOn();
+  vectorWriter->SetFileName(vectorFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(vectorWriter->Update());
+
+  auto vectorReader = itk::ImageFileReader<VectorImageType>::New();
+  vectorReader->SetImageIO(itk::NiftiImageIO::New());
+  vectorReader->SetFileName(vectorFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(vectorReader->Update());
+  if (!itk::Testing::VerifyImageRegion(
+        vectorImage.GetPointer(), vectorReader->GetOutput(), vectorImage->GetLargestPossibleRegion()))
+  {
+    std::cerr << "Test failed reading " << vectorFileName << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
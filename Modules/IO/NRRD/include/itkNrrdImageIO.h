@@ -125,6 +125,11 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Raw data in a single file, in the byte order of the system, is held as
+   * Read() would read it when its axes need not be permuted. */
+  bool
+  GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset) const override;
+
   /** Determine the file type. Returns true if this ImageIO can write the
    * file specified. */
   bool
@@ -226,6 +231,12 @@ protected:
   const NrrdEncoding_t * m_NrrdCompressionEncoding{ nullptr };
 
   AxesReorderEnum m_AxesReorder{ AxesReorderEnum::UseAnyRangeAxisAsPixel };
+
+private:
+  /** The file of raw pixel data and their offset in it, when they can be
+   * used as they are stored; empty otherwise. */
+  std::string   m_RawPixelDataFileName{};
+  SizeValueType m_RawPixelDataOffset{ 0 };
 };
 } // end namespace itk
 
@@ -24,6 +24,8 @@
 #include "itkFloatingPointExceptions.h"
 #include "itkNumericLocale.h"
 #include "itkNumberToString.h"
+#include "itkParallelDeflateCompressor.h"
+#include "itksys/SystemTools.hxx"
 
 #include <cstdio>
 #include <cstring>
@@ -593,8 +595,10 @@ NrrdImageIO::ReadImageInformation()
     NumericLocale cLocale;
 
     // this is the mechanism by which we tell nrrdLoad to read
-    // just the header, and none of the data
+    // just the header, and none of the data; the data file is left
+    // open at the start of the data
     nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
     if (nrrdLoad(nrrd, this->GetFileName(), nio) != 0)
     {
       char * err = biffGetDone(NRRD);
@@ -616,6 +620,30 @@ NrrdImageIO::ReadImageInformation()
     }
 
 
+    // Where the data of a single data file start, which lets raw data be
+    // used as they are stored
+    m_RawPixelDataFileName.clear();
+    m_RawPixelDataOffset = 0;
+    if (nio->dataFile != nullptr)
+    {
+      const long position = ftell(nio->dataFile);
+      nio->dataFile = airFclose(nio->dataFile);
+      if (position >= 0 && nio->dataFNFormat == nullptr && nio->dataFNArr->len == 0)
+      {
+        m_RawPixelDataFileName = this->GetFileName();
+      }
+      else if (position >= 0 && nio->dataFNFormat == nullptr && nio->dataFNArr->len == 1 &&
+               std::strcmp(nio->dataFN[0], "-") != 0)
+      {
+        m_RawPixelDataFileName = nio->dataFN[0];
+        if (!itksys::SystemTools::FileIsFullPath(m_RawPixelDataFileName) && airStrlen(nio->path) > 0)
+        {
+          m_RawPixelDataFileName = std::string(nio->path) + '/' + m_RawPixelDataFileName;
+        }
+      }
+      m_RawPixelDataOffset = static_cast<SizeValueType>(position);
+    }
+
     if (nrrdTypeBlock == nrrd->type)
     {
       itkExceptionStringMacro("ReadImageInformation: Cannot currently handle nrrdTypeBlock");
@@ -1054,6 +1082,14 @@ NrrdImageIO::ReadImageInformation()
       EncapsulateMetaData<std::vector<std::vector<double>>>(thisDic, key, msrFrame);
     }
 
+    // Read() permutes the axes and unmasks tensors in memory
+    if (nio->encoding != nrrdEncodingRaw || needPermutation ||
+        this->GetPixelType() == IOPixelEnum::SYMMETRICSECONDRANKTENSOR ||
+        (nrrdElementSize(nrrd) > 1 && nio->endian != airMyEndian()))
+    {
+      m_RawPixelDataFileName.clear();
+    }
+
     nrrd = nrrdNix(nrrd);
     nio = nrrdIoStateNix(nio);
   }
@@ -1215,6 +1251,18 @@ NrrdImageIO::Read(void * buffer)
   }
 }
 
+bool
+NrrdImageIO::GetRawPixelDataLocation(std::string & fileName, SizeValueType & offset) const
+{
+  if (m_RawPixelDataFileName.empty())
+  {
+    return false;
+  }
+  fileName = m_RawPixelDataFileName;
+  offset = m_RawPixelDataOffset;
+  return true;
+}
+
 bool
 NrrdImageIO::CanWriteFile(const char * name)
 {
@@ -1444,6 +1492,14 @@ NrrdImageIO::Write(const void * buffer)
   // Using thread-safe NumericLocale from ITKCommon.
   NumericLocale cLocale;
 
+  // The gzip encoding of NrrdIO deflates on a single thread, so only the
+  // header is written by NrrdIO, and the data is compressed here.
+  const bool deflateData = (nio->encoding == nrrdEncodingGzip);
+  if (deflateData)
+  {
+    nio->skipData = AIR_TRUE;
+  }
+
   // Write the nrrd to file.
   if (nrrdSave(this->GetFileName(), nrrd, nio))
   {
@@ -1451,9 +1507,39 @@ NrrdImageIO::Write(const void * buffer)
     itkExceptionMacro("Write: Error writing " << this->GetFileName() << ":\n" << err);
   }
 
+  // An attached header is followed by the data, a detached header names the
+  // data file, relative to the header unless it is a full path.
+  std::string dataFileName = this->GetFileName();
+  if (deflateData && nio->detachedHeader)
+  {
+    dataFileName = nio->dataFN[0];
+    if (!itksys::SystemTools::FileIsFullPath(dataFileName) && airStrlen(nio->path))
+    {
+      dataFileName = std::string(nio->path) + '/' + dataFileName;
+    }
+  }
+  const bool appendData = !nio->detachedHeader;
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrdNix(nrrd);
   nrrdIoStateNix(nio);
+
+  if (deflateData)
+  {
+    std::ofstream file;
+    this->OpenFileForWriting(file, dataFileName, !appendData);
+    file.seekp(0, std::ios::end);
+
+    auto compressor = ParallelDeflateCompressor::New();
+    compressor->SetCompressionLevel(this->GetCompressionLevel());
+    compressor->Compress(buffer, this->GetImageSizeInBytes(), file);
+
+    file.close();
+    if (file.fail())
+    {
+      itkExceptionMacro("Write: Error writing " << dataFileName);
+    }
+  }
 }
 
 } // end namespace itk
@@ -0,0 +1,138 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMemoryMappedImportImageContainer.h"
+#include "itkNrrdImageIO.h"
+#include "itkSymmetricSecondRankTensor.h"
+#include "itkTestingMacros.h"
+
+
+namespace
+{
+template <typename TImage>
+bool
+IsMapped(const TImage * image)
+{
+  using PixelContainerType = typename TImage::PixelContainer;
+  using MappedContainerType = itk::MemoryMappedImportImageContainer<typename PixelContainerType::ElementIdentifier,
+                                                                    typename PixelContainerType::Element>;
+  return dynamic_cast<const MappedContainerType *>(image->GetPixelContainer()) != nullptr;
+}
+
+template <typename TImage>
+bool
+SameImages(const TImage * expected, const TImage * actual)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(expected, expected->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    if (it.Get() != actual->GetPixel(it.GetIndex()))
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " differs." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TImage>
+typename TImage::Pointer
+ReadMapped(const std::string & fileName)
+{
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::NrrdImageIO::New());
+  reader->UseMemoryMappingOn();
+  reader->Update();
+  return reader->GetOutput();
+}
+} // namespace
+
+
+int
+itkNrrdMemoryMappingTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  // Pixels of one byte are aligned whatever the length of the header
+  using ImageType = itk::Image<unsigned char, 3>;
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 41, 33, 17 } });
+  image->Allocate();
+  unsigned char value = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value = static_cast<unsigned char>(value * 31 + 7);
+  }
+
+  // The raw pixels of a .nrrd file follow its header, and a .raw file holds only pixels
+  for (const std::string extension : { ".nrrd", ".nhdr" })
+  {
+    const std::string fileName = directory + "/itkNrrdMemoryMappingTest" + extension;
+    ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, fileName));
+    ImageType::Pointer mapped;
+    ITK_TRY_EXPECT_NO_EXCEPTION(mapped = ReadMapped<ImageType>(fileName));
+    ITK_TEST_EXPECT_TRUE(IsMapped(mapped.GetPointer()));
+    ITK_TEST_EXPECT_TRUE(SameImages(image.GetPointer(), mapped.GetPointer()));
+  }
+
+  // Compressed pixels are read
+  const std::string compressedFileName = directory + "/itkNrrdMemoryMappingCompressedTest.nrrd";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, compressedFileName, true));
+  ImageType::Pointer compressed;
+  ITK_TRY_EXPECT_NO_EXCEPTION(compressed = ReadMapped<ImageType>(compressedFileName));
+  ITK_TEST_EXPECT_TRUE(!IsMapped(compressed.GetPointer()));
+  ITK_TEST_EXPECT_TRUE(SameImages(image.GetPointer(), compressed.GetPointer()));
+
+  // So are symmetric tensors, whose components are reordered
+  using TensorImageType = itk::Image<itk::SymmetricSecondRankTensor<float, 3>, 3>;
+  auto tensorImage = TensorImageType::New();
+  tensorImage->SetRegions(TensorImageType::SizeType{ { 11, 7, 5 } });
+  tensorImage->Allocate();
+  for (itk::ImageRegionIterator<TensorImageType> it(tensorImage, tensorImage->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    TensorImageType::PixelType tensor;
+    for (unsigned int i = 0; i < tensor.Size(); ++i)
+    {
+      tensor[i] = static_cast<float>(it.GetIndex()[i % 3] + i);
+    }
+    it.Set(tensor);
+  }
+  const std::string tensorFileName = directory + "/itkNrrdMemoryMappingTestTensor.nrrd";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(tensorImage, tensorFileName));
+  TensorImageType::Pointer tensors;
+  ITK_TRY_EXPECT_NO_EXCEPTION(tensors = ReadMapped<TensorImageType>(tensorFileName));
+  ITK_TEST_EXPECT_TRUE(!IsMapped(tensors.GetPointer()));
+  ITK_TEST_EXPECT_TRUE(SameImages(tensorImage.GetPointer(), tensors.GetPointer()));
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
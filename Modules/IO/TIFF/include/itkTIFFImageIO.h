@@ -20,6 +20,7 @@
 #include "ITKIOTIFFExport.h"
 
 #include "itkImageIOBase.h"
+#include "itkMultiThreaderBase.h"
 #include <fstream>
 
 namespace itk
@@ -38,6 +39,13 @@ class TIFFReaderInternal;
  * supports the compression level for JPEG quality parameter in the
  * range 0-100.
  *
+ * Grayscale and RGB pages of 8, 16 or 32 bits per sample are read tile by
+ * tile, or strip by strip, and only the tiles or strips that overlap the
+ * requested region are decoded when streaming, concurrently, by the work
+ * units of the multi-threader. A single page that is followed by
+ * reduced-resolution versions of itself, as in a pyramidal TIFF, has a
+ * resolution level for each, which the Level selects.
+ *
  * \ingroup IOFilters
  * \ingroup ITKIOTIFF
  *
@@ -83,6 +91,38 @@ public:
   virtual void
   ReadVolume(void * buffer);
 
+  /** Grayscale and RGB pages can be read a region at a time, known once
+   * ReadImageInformation() has been called. */
+  bool
+  CanStreamRead() override
+  {
+    return m_CanReadByBlocks;
+  }
+
+  /** Returns the requested region when UseStreamedReading is on and the
+   * pages can be read a region at a time. */
+  ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
+
+  /** Resolution level to read, 0 being the full resolution and 1 the first
+   * reduced-resolution version of the page. The default is 0. */
+  /** @ITKStartGrouping */
+  itkSetMacro(Level, unsigned int);
+  itkGetConstMacro(Level, unsigned int);
+  /** @ITKEndGrouping */
+
+  /** Number of resolution levels of the image, known once
+   * ReadImageInformation() has been called. A volume of several pages has
+   * a single level. */
+  itkGetConstMacro(NumberOfLevels, unsigned int);
+
+  /** Number of work units used to decode the tiles or strips. The default
+   * is the global default number of threads of the multi-threader. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+  /** @ITKEndGrouping */
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -263,6 +303,11 @@ private:
   void
   ReadCurrentPage(void * buffer, size_t pixelOffset);
 
+  /** Read m_IORegion, decoding only the tiles or strips of the pages that
+   * overlap it. */
+  void
+  ReadRegionByBlocks(void * buffer);
+
   template <typename TComponent>
   void
   ReadGenericImage(void * _out, unsigned int width, unsigned int height);
@@ -317,6 +362,12 @@ private:
   uint16_t *   m_ColorBlue{};
   uint64_t     m_TotalColors{ 0 };
   unsigned int m_ImageFormat{ TIFFImageIO::NOFORMAT };
+
+  unsigned int               m_Level{ 0 };
+  unsigned int               m_NumberOfLevels{ 1 };
+  bool                       m_CanReadByBlocks{ false };
+  ThreadIdType               m_NumberOfWorkUnits{ 1 };
+  MultiThreaderBase::Pointer m_MultiThreader{};
 };
 } // end namespace itk
 
@@ -23,10 +23,39 @@
 #include "itkMakeUniqueForOverwrite.h"
 
 #include "itk_tiff.h"
+#include <algorithm>
+#include <exception>
+#include <vector>
 
 namespace itk
 {
 
+namespace
+{
+// Spacing along x and y from the resolution of the current directory
+void
+SpacingFromResolution(const TIFFReaderInternal & internalImage, double spacing[2])
+{
+  spacing[0] = 1.0;
+  spacing[1] = 1.0;
+
+  // If we have some spacing information we use it
+  if (internalImage.m_ResolutionUnit > 0 && internalImage.m_XResolution > 0 && internalImage.m_YResolution > 0)
+  {
+    if (internalImage.m_ResolutionUnit == 2) // inches
+    {
+      spacing[0] = 25.4 / static_cast<double>(internalImage.m_XResolution);
+      spacing[1] = 25.4 / static_cast<double>(internalImage.m_YResolution);
+    }
+    else if (internalImage.m_ResolutionUnit == 3) // cm
+    {
+      spacing[0] = 10.0 / static_cast<double>(internalImage.m_XResolution);
+      spacing[1] = 10.0 / static_cast<double>(internalImage.m_YResolution);
+    }
+  }
+}
+} // namespace
+
 bool
 TIFFImageIO::CanReadFile(const char * file)
 {
@@ -189,9 +218,18 @@ TIFFImageIO::Read(void * buffer)
     m_InternalImage->Open(m_FileName.c_str());
   }
 
+  if (m_Level > 0 && !m_InternalImage->SetDirectory(m_InternalImage->m_ReducedImageDirectories.at(m_Level - 1)))
+  {
+    itkExceptionMacro("Cannot read resolution level " << m_Level << " of file " << this->m_FileName);
+  }
+
+  if (m_CanReadByBlocks)
+  {
+    this->ReadRegionByBlocks(buffer);
+  }
   // The IO region should be of dimensions 3 otherwise we read only the first
   // page
-  if (m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2)
+  else if (m_Level == 0 && m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2)
   {
     this->ReadVolume(buffer);
   }
@@ -206,8 +244,8 @@ TIFFImageIO::Read(void * buffer)
 TIFFImageIO::TIFFImageIO()
   : m_InternalImage(new TIFFReaderInternal)
   , m_ColorPalette(0)
-
-
+  , m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
 {
   this->SetNumberOfDimensions(2);
   this->Self::SetJPEGQuality(75);
@@ -244,6 +282,11 @@ TIFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
 
   os << indent << "Compression: " << m_Compression << std::endl;
   os << indent << "JPEGQuality: " << this->GetJPEGQuality() << std::endl;
+  os << indent << "Level: " << m_Level << std::endl;
+  os << indent << "NumberOfLevels: " << m_NumberOfLevels << std::endl;
+  itkPrintSelfBooleanMacro(CanReadByBlocks);
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+  itkPrintSelfObjectMacro(MultiThreader);
   if (!m_ColorPalette.empty())
   {
     os << indent << "Image RGB palette:" << '\n';
@@ -346,10 +389,40 @@ TIFFImageIO::ReadImageInformation()
     m_InternalImage->Open(m_FileName.c_str());
   }
 
+  // A single page may be followed by reduced-resolution versions of itself
+  m_NumberOfLevels = 1;
+  if (m_InternalImage->m_PageDirectories.size() == 1)
+  {
+    m_NumberOfLevels += static_cast<unsigned int>(m_InternalImage->m_ReducedImageDirectories.size());
+  }
+  if (m_Level >= m_NumberOfLevels)
+  {
+    itkExceptionMacro("Resolution level " << m_Level << " requested, but " << this->m_FileName << " has "
+                                          << m_NumberOfLevels << " resolution levels.");
+  }
+
+  double   fullResolutionSpacing[2]{ 1.0, 1.0 };
+  uint32_t fullResolutionWidth = m_InternalImage->m_Width;
+  uint32_t fullResolutionHeight = m_InternalImage->m_Height;
+  if (m_Level > 0)
+  {
+    if (!m_InternalImage->SetDirectory(m_InternalImage->m_PageDirectories.front()))
+    {
+      itkExceptionMacro("Cannot read file " << this->m_FileName);
+    }
+    SpacingFromResolution(*m_InternalImage, fullResolutionSpacing);
+    fullResolutionWidth = m_InternalImage->m_Width;
+    fullResolutionHeight = m_InternalImage->m_Height;
+  }
+  if (!m_InternalImage->SetDirectory(m_Level > 0 ? m_InternalImage->m_ReducedImageDirectories[m_Level - 1] : 0))
+  {
+    itkExceptionMacro("Cannot read resolution level " << m_Level << " of file " << this->m_FileName);
+  }
+
   ReadTIFFTags();
 
   // if the tiff file is multi-pages
-  if (m_InternalImage->m_NumberOfPages - m_InternalImage->m_IgnoredSubFiles > 1)
+  if (m_Level == 0 && m_InternalImage->m_NumberOfPages - m_InternalImage->m_IgnoredSubFiles > 1)
   {
     this->SetNumberOfDimensions(3);
     if (m_InternalImage->m_SubFiles > 0)
@@ -368,23 +441,10 @@ TIFFImageIO::ReadImageInformation()
     this->SetNumberOfDimensions(2);
   }
 
-  m_Spacing[0] = 1.0;
-  m_Spacing[1] = 1.0;
-
-  // If we have some spacing information we use it
-  if (m_InternalImage->m_ResolutionUnit > 0 && m_InternalImage->m_XResolution > 0 && m_InternalImage->m_YResolution > 0)
-  {
-    if (m_InternalImage->m_ResolutionUnit == 2) // inches
-    {
-      m_Spacing[0] = 25.4 / static_cast<double>(m_InternalImage->m_XResolution);
-      m_Spacing[1] = 25.4 / static_cast<double>(m_InternalImage->m_YResolution);
-    }
-    else if (m_InternalImage->m_ResolutionUnit == 3) // cm
-    {
-      m_Spacing[0] = 10.0 / static_cast<double>(m_InternalImage->m_XResolution);
-      m_Spacing[1] = 10.0 / static_cast<double>(m_InternalImage->m_YResolution);
-    }
-  }
+  double spacing[2];
+  SpacingFromResolution(*m_InternalImage, spacing);
+  m_Spacing[0] = spacing[0];
+  m_Spacing[1] = spacing[1];
 
   m_Origin[0] = 0.0;
   m_Origin[1] = 0.0;
@@ -392,6 +452,18 @@ TIFFImageIO::ReadImageInformation()
   m_Dimensions[0] = m_InternalImage->m_Width;
   m_Dimensions[1] = m_InternalImage->m_Height;
 
+  if (m_Level > 0)
+  {
+    // A reduced-resolution level covers the extent of the full-resolution
+    // page, with larger pixels
+    const uint32_t fullResolutionSize[2] = { fullResolutionWidth, fullResolutionHeight };
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      m_Spacing[i] = fullResolutionSpacing[i] * fullResolutionSize[i] / static_cast<double>(m_Dimensions[i]);
+      m_Origin[i] = 0.5 * (m_Spacing[i] - fullResolutionSpacing[i]);
+    }
+  }
+
   if (m_InternalImage->m_BitsPerSample <= 8)
   {
     if (m_InternalImage->m_SampleFormat == 2)
@@ -537,6 +609,22 @@ TIFFImageIO::ReadImageInformation()
     // make sure the palette is empty
     m_ColorPalette.clear();
   }
+
+  // The samples of grayscale and RGB pages are the components of the pixels
+  m_CanReadByBlocks = m_InternalImage->CanRead() && !m_IsReadAsScalarPlusPalette &&
+                      (this->GetFormat() == TIFFImageIO::GRAYSCALE || this->GetFormat() == TIFFImageIO::RGB_) &&
+                      size_t{ m_InternalImage->m_SamplesPerPixel } * (m_InternalImage->m_BitsPerSample / 8) ==
+                        this->GetNumberOfComponents() * this->GetComponentSize();
+}
+
+ImageIORegion
+TIFFImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
+{
+  if (m_UseStreamedReading && m_CanReadByBlocks)
+  {
+    return requestedRegion;
+  }
+  return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requestedRegion);
 }
 
 bool
@@ -1323,6 +1411,192 @@ TIFFImageIO::ReadCurrentPage(void * buffer, size_t pixelOffset)
   }
 }
 
+void
+TIFFImageIO::ReadRegionByBlocks(void * buffer)
+{
+  const ImageIORegion & region = this->GetIORegion();
+  const unsigned int    regionDimension = region.GetImageDimension();
+  const auto            regionX = static_cast<uint32_t>(region.GetIndex(0));
+  const auto            regionWidth = static_cast<uint32_t>(region.GetSize(0));
+  const auto            regionY = static_cast<uint32_t>(regionDimension > 1 ? region.GetIndex(1) : 0);
+  const auto            regionHeight = static_cast<uint32_t>(regionDimension > 1 ? region.GetSize(1) : 1);
+
+  // The directories of the pages of the region
+  std::vector<tdir_t> directories;
+  if (m_Level > 0)
+  {
+    directories.push_back(m_InternalImage->m_ReducedImageDirectories.at(m_Level - 1));
+  }
+  else if (m_NumberOfDimensions > 2 && regionDimension > 2)
+  {
+    const auto firstPage = static_cast<size_t>(region.GetIndex(2));
+    for (size_t page = firstPage; page < firstPage + region.GetSize(2); ++page)
+    {
+      directories.push_back(m_InternalImage->m_PageDirectories.at(page));
+    }
+  }
+  else
+  {
+    directories.push_back(m_InternalImage->m_PageDirectories.front());
+  }
+
+  // The tiles or strips that overlap the region, page after page
+  struct Block
+  {
+    size_t   Page;
+    uint32_t Number;
+    uint32_t X;
+    uint32_t Y;
+    uint32_t Width;
+    uint32_t Height;
+  };
+  std::vector<Block> blocks;
+
+  const uint32_t width = m_InternalImage->m_Width;
+  const uint32_t height = m_InternalImage->m_Height;
+  const bool     bottomUp = m_InternalImage->m_Orientation == ORIENTATION_BOTLEFT;
+  if (regionX + regionWidth > width || regionY + regionHeight > height)
+  {
+    itkExceptionMacro("The region to read is outside of the image in file " << this->m_FileName);
+  }
+
+  // The rows of the file that hold the region
+  const uint32_t firstRow = bottomUp ? height - (regionY + regionHeight) : regionY;
+  const uint32_t endRow = firstRow + regionHeight;
+
+  for (size_t page = 0; page < directories.size(); ++page)
+  {
+    if (!m_InternalImage->SetDirectory(directories[page]) || m_InternalImage->m_Width != width ||
+        m_InternalImage->m_Height != height)
+    {
+      itkExceptionMacro("Cannot read page " << page << " of file " << this->m_FileName);
+    }
+    TIFF * tif = m_InternalImage->m_Image;
+    if (m_InternalImage->m_NumberOfTiles > 0)
+    {
+      const uint32_t tileWidth = m_InternalImage->m_TileWidth;
+      const uint32_t tileHeight = m_InternalImage->m_TileHeight;
+      for (uint32_t y = firstRow / tileHeight * tileHeight; y < endRow; y += tileHeight)
+      {
+        for (uint32_t x = regionX / tileWidth * tileWidth; x < regionX + regionWidth; x += tileWidth)
+        {
+          blocks.push_back({ page, TIFFComputeTile(tif, x, y, 0, 0), x, y, tileWidth, tileHeight });
+        }
+      }
+    }
+    else
+    {
+      const uint32_t rowsPerStrip = std::min(std::max(m_InternalImage->m_RowsPerStrip, uint32_t{ 1 }), height);
+      for (uint32_t y = firstRow / rowsPerStrip * rowsPerStrip; y < endRow; y += rowsPerStrip)
+      {
+        blocks.push_back({ page, TIFFComputeStrip(tif, y, 0), 0, y, width, std::min(rowsPerStrip, height - y) });
+      }
+    }
+  }
+
+  const size_t pixelSize = this->GetNumberOfComponents() * this->GetComponentSize();
+  const size_t pageSize = size_t{ regionWidth } * regionHeight * pixelSize;
+
+  // Decode a block with the directory of its page current in internalImage,
+  // and copy the part of it that is in the region
+  const auto readBlock = [this, buffer, &blocks, regionX, regionWidth, regionY, firstRow, endRow, height, bottomUp,
+                          pixelSize, pageSize](TIFFReaderInternal & internalImage,
+                                               size_t               blockNumber,
+                                               std::vector<char> &  blockBuffer) {
+    const Block & block = blocks[blockNumber];
+    TIFF *        tif = internalImage.m_Image;
+    const bool    tiled = internalImage.m_NumberOfTiles > 0;
+    const auto    blockSize = tiled ? TIFFTileSize(tif) : TIFFStripSize(tif);
+    const auto    rowSize = static_cast<size_t>(tiled ? TIFFTileRowSize(tif) : TIFFScanlineSize(tif));
+    blockBuffer.resize(static_cast<size_t>(blockSize));
+    const tmsize_t decoded = tiled ? TIFFReadEncodedTile(tif, block.Number, blockBuffer.data(), blockSize)
+                                   : TIFFReadEncodedStrip(tif, block.Number, blockBuffer.data(), blockSize);
+    if (decoded < 0)
+    {
+      itkExceptionMacro("Cannot read " << (tiled ? "tile " : "strip ") << block.Number << " of file "
+                                       << this->m_FileName);
+    }
+
+    const uint32_t firstColumn = std::max(block.X, regionX);
+    const uint32_t endColumn = std::min(block.X + block.Width, regionX + regionWidth);
+    const uint32_t blockEndRow = std::min(block.Y + block.Height, endRow);
+    char *         page = static_cast<char *>(buffer) + block.Page * pageSize;
+    for (uint32_t row = std::max(block.Y, firstRow); row < blockEndRow; ++row)
+    {
+      const uint32_t imageRow = bottomUp ? height - 1 - row : row;
+      std::copy_n(blockBuffer.data() + (row - block.Y) * rowSize + (firstColumn - block.X) * pixelSize,
+                  (endColumn - firstColumn) * pixelSize,
+                  page + ((imageRow - regionY) * size_t{ regionWidth } + (firstColumn - regionX)) * pixelSize);
+    }
+  };
+
+  const auto numberOfWorkUnits =
+    static_cast<ThreadIdType>(std::min(static_cast<size_t>(m_NumberOfWorkUnits), blocks.size()));
+  if (numberOfWorkUnits <= 1)
+  {
+    std::vector<char> blockBuffer;
+    size_t            currentPage = directories.size() - 1;
+    for (size_t blockNumber = 0; blockNumber < blocks.size(); ++blockNumber)
+    {
+      if (blocks[blockNumber].Page != currentPage)
+      {
+        currentPage = blocks[blockNumber].Page;
+        m_InternalImage->SetDirectory(directories[currentPage]);
+      }
+      readBlock(*m_InternalImage, blockNumber, blockBuffer);
+    }
+    return;
+  }
+
+  // A TIFF handle decodes one block at a time: each work unit opens the file
+  // for itself, and decodes a run of consecutive blocks. An exception must not
+  // leave the work unit, so that of each work unit is kept, and the first one
+  // is rethrown once they are all done.
+  std::vector<std::exception_ptr> exceptions(numberOfWorkUnits);
+  m_MultiThreader->SetNumberOfWorkUnits(numberOfWorkUnits);
+  m_MultiThreader->ParallelizeArray(
+    0,
+    numberOfWorkUnits,
+    [this, &blocks, &directories, &readBlock, &exceptions, numberOfWorkUnits](SizeValueType workUnit) {
+      try
+      {
+        TIFFReaderInternal internalImage;
+        if (!internalImage.Open(m_FileName.c_str()))
+        {
+          itkExceptionMacro("Cannot open file " << this->m_FileName << '!');
+        }
+        std::vector<char> blockBuffer;
+        size_t            currentPage = directories.size();
+        const size_t      endBlock = blocks.size() * (workUnit + 1) / numberOfWorkUnits;
+        for (size_t blockNumber = blocks.size() * workUnit / numberOfWorkUnits; blockNumber < endBlock; ++blockNumber)
+        {
+          if (blocks[blockNumber].Page != currentPage)
+          {
+            currentPage = blocks[blockNumber].Page;
+            if (!internalImage.SetDirectory(directories[currentPage]))
+            {
+              itkExceptionMacro("Cannot read page " << currentPage << " of file " << this->m_FileName);
+            }
+          }
+          readBlock(internalImage, blockNumber, blockBuffer);
+        }
+      }
+      catch (...)
+      {
+        exceptions[workUnit] = std::current_exception();
+      }
+    },
+    nullptr);
+
+  for (const std::exception_ptr & exception : exceptions)
+  {
+    if (exception)
+    {
+      std::rethrow_exception(exception);
+    }
+  }
+}
+
 template <typename TComponent>
 void
 TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int height)
@@ -177,8 +177,11 @@ TIFFReaderInternal::Clean()
   this->m_SubFiles = 0;
   this->m_IgnoredSubFiles = 0;
   this->m_SampleFormat = 1;
+  this->m_RowsPerStrip = 0;
   this->m_ResolutionUnit = 1; // none
   this->m_IsOpen = false;
+  this->m_PageDirectories.clear();
+  this->m_ReducedImageDirectories.clear();
 
   this->m_WarningSilence = false;
   this->m_ErrorSilence = false;
@@ -187,22 +190,13 @@ TIFFReaderInternal::Clean()
 
 TIFFReaderInternal::TIFFReaderInternal() { this->Clean(); }
 
+TIFFReaderInternal::~TIFFReaderInternal() { this->Clean(); }
+
 int
 TIFFReaderInternal::Initialize()
 {
   if (this->m_Image)
   {
-    if (!TIFFGetField(this->m_Image, TIFFTAG_IMAGEWIDTH, &this->m_Width) ||
-        !TIFFGetField(this->m_Image, TIFFTAG_IMAGELENGTH, &this->m_Height))
-    {
-      return 0;
-    }
-
-    // Get the resolution in each direction
-    TIFFGetField(this->m_Image, TIFFTAG_XRESOLUTION, &this->m_XResolution);
-    TIFFGetField(this->m_Image, TIFFTAG_YRESOLUTION, &this->m_YResolution);
-    TIFFGetField(this->m_Image, TIFFTAG_RESOLUTIONUNIT, &this->m_ResolutionUnit);
-
     // Check the number of pages. First by looking at the number of directories
     this->m_NumberOfPages = TIFFNumberOfDirectories(this->m_Image);
 
@@ -211,21 +205,8 @@ TIFFReaderInternal::Initialize()
       itkGenericExceptionMacro("No directories found in TIFF file.");
     }
 
-    if (TIFFIsTiled(this->m_Image))
-    {
-      this->m_NumberOfTiles = TIFFNumberOfTiles(this->m_Image);
-
-      if (!TIFFGetField(this->m_Image, TIFFTAG_TILEWIDTH, &this->m_TileWidth) ||
-          !TIFFGetField(this->m_Image, TIFFTAG_TILELENGTH, &this->m_TileHeight))
-      {
-        itkGenericExceptionMacro("Cannot read tile width and tile length from file");
-      }
-      else
-      {
-        this->m_TileRows = this->m_Height / this->m_TileHeight;
-        this->m_TileColumns = this->m_Width / this->m_TileWidth;
-      }
-    }
+    this->m_PageDirectories.clear();
+    this->m_ReducedImageDirectories.clear();
 
     // Checking if the TIFF contains subfiles
     if (this->m_NumberOfPages > 1)
@@ -236,6 +217,7 @@ TIFFReaderInternal::Initialize()
       for (unsigned int page = 0; page < this->m_NumberOfPages; ++page)
       {
         int32_t subfiletype = 6;
+        bool    ignored = false;
         if (TIFFGetField(this->m_Image, TIFFTAG_SUBFILETYPE, &subfiletype))
         {
           if (subfiletype == 0)
@@ -246,30 +228,97 @@ TIFFReaderInternal::Initialize()
           else if (subfiletype & FILETYPE_REDUCEDIMAGE || subfiletype & FILETYPE_MASK)
           {
             ++this->m_IgnoredSubFiles;
+            ignored = true;
+            if (!(subfiletype & FILETYPE_MASK))
+            {
+              this->m_ReducedImageDirectories.push_back(static_cast<tdir_t>(page));
+            }
           }
         }
+        if (!ignored)
+        {
+          this->m_PageDirectories.push_back(static_cast<tdir_t>(page));
+        }
         TIFFReadDirectory(this->m_Image);
       }
 
       // Set the directory to the first image, and reads it
       TIFFSetDirectory(this->m_Image, 0);
     }
+    else
+    {
+      this->m_PageDirectories.push_back(0);
+    }
+
+    return this->ReadDirectoryFields();
+  }
+
+  return 1;
+}
+
+int
+TIFFReaderInternal::SetDirectory(tdir_t directory)
+{
+  if (!this->m_Image || !TIFFSetDirectory(this->m_Image, directory))
+  {
+    return 0;
+  }
+  return this->ReadDirectoryFields();
+}
+
+int
+TIFFReaderInternal::ReadDirectoryFields()
+{
+  if (!TIFFGetField(this->m_Image, TIFFTAG_IMAGEWIDTH, &this->m_Width) ||
+      !TIFFGetField(this->m_Image, TIFFTAG_IMAGELENGTH, &this->m_Height))
+  {
+    return 0;
+  }
+
+  // Get the resolution in each direction
+  this->m_XResolution = 1;
+  this->m_YResolution = 1;
+  this->m_ResolutionUnit = 1; // none
+  TIFFGetField(this->m_Image, TIFFTAG_XRESOLUTION, &this->m_XResolution);
+  TIFFGetField(this->m_Image, TIFFTAG_YRESOLUTION, &this->m_YResolution);
+  TIFFGetField(this->m_Image, TIFFTAG_RESOLUTIONUNIT, &this->m_ResolutionUnit);
 
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_ORIENTATION, &this->m_Orientation);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLESPERPIXEL, &this->m_SamplesPerPixel);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_COMPRESSION, &this->m_Compression);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_BITSPERSAMPLE, &this->m_BitsPerSample);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_PLANARCONFIG, &this->m_PlanarConfig);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLEFORMAT, &this->m_SampleFormat);
-
-    // If TIFFGetField returns zero, there's no Photometric Interpretation
-    // set for this image, but that's a required field so we set a warning flag.
-    // (Because the "Photometrics" field is an enum, we can't rely on setting
-    // this->m_Photometrics to some signal value.)
-    this->m_HasValidPhotometricInterpretation =
-      TIFFGetField(this->m_Image, TIFFTAG_PHOTOMETRIC, &this->m_Photometrics) != 0;
+  this->m_NumberOfTiles = 0;
+  this->m_TileRows = 0;
+  this->m_TileColumns = 0;
+  this->m_TileWidth = 0;
+  this->m_TileHeight = 0;
+  if (TIFFIsTiled(this->m_Image))
+  {
+    this->m_NumberOfTiles = TIFFNumberOfTiles(this->m_Image);
+
+    if (!TIFFGetField(this->m_Image, TIFFTAG_TILEWIDTH, &this->m_TileWidth) ||
+        !TIFFGetField(this->m_Image, TIFFTAG_TILELENGTH, &this->m_TileHeight))
+    {
+      itkGenericExceptionMacro("Cannot read tile width and tile length from file");
+    }
+    else
+    {
+      this->m_TileRows = this->m_Height / this->m_TileHeight;
+      this->m_TileColumns = this->m_Width / this->m_TileWidth;
+    }
   }
 
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_ORIENTATION, &this->m_Orientation);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLESPERPIXEL, &this->m_SamplesPerPixel);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_COMPRESSION, &this->m_Compression);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_BITSPERSAMPLE, &this->m_BitsPerSample);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_PLANARCONFIG, &this->m_PlanarConfig);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLEFORMAT, &this->m_SampleFormat);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_ROWSPERSTRIP, &this->m_RowsPerStrip);
+
+  // If TIFFGetField returns zero, there's no Photometric Interpretation
+  // set for this image, but that's a required field so we set a warning flag.
+  // (Because the "Photometrics" field is an enum, we can't rely on setting
+  // this->m_Photometrics to some signal value.)
+  this->m_HasValidPhotometricInterpretation =
+    TIFFGetField(this->m_Image, TIFFTAG_PHOTOMETRIC, &this->m_Photometrics) != 0;
+
   return 1;
 }
 
@@ -278,9 +327,10 @@ TIFFReaderInternal::CanRead()
 {
   const bool compressionSupported = (TIFFIsCODECConfigured(this->m_Compression) == 1);
   return (this->m_Image && (this->m_Width > 0) && (this->m_Height > 0) && (this->m_SamplesPerPixel > 0) &&
-          compressionSupported && (m_NumberOfTiles == 0) // just use TIFFReadRGBAImage, an
-                                                         // native optimized version would be nice
-          && (this->m_HasValidPhotometricInterpretation) &&
+          compressionSupported &&
+          // tiled palette images are read with TIFFReadRGBAImage
+          (m_NumberOfTiles == 0 || this->m_Photometrics != PHOTOMETRIC_PALETTE) &&
+          (this->m_HasValidPhotometricInterpretation) &&
           (this->m_Photometrics == PHOTOMETRIC_RGB || this->m_Photometrics == PHOTOMETRIC_MINISWHITE ||
            this->m_Photometrics == PHOTOMETRIC_MINISBLACK ||
            (this->m_Photometrics == PHOTOMETRIC_PALETTE && this->m_BitsPerSample != 32)) &&
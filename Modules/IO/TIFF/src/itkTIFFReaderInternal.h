@@ -20,7 +20,9 @@
 
 #include "ITKIOTIFFExport.h"
 #include "itkIntTypes.h"
+#include "itkMacro.h"
 #include "itk_tiff.h"
+#include <vector>
 
 
 namespace itk
@@ -29,7 +31,11 @@ namespace itk
 class ITKIOTIFF_HIDDEN TIFFReaderInternal
 {
 public:
+  ITK_DISALLOW_COPY_AND_MOVE(TIFFReaderInternal);
+
   TIFFReaderInternal();
+  ~TIFFReaderInternal();
+
   int
   Initialize();
 
@@ -42,6 +48,10 @@ public:
   int
   Open(const char * filename, bool silent = false);
 
+  /** Make \c directory the current directory and read its fields. */
+  int
+  SetDirectory(tdir_t directory);
+
   TIFF *   m_Image{ nullptr };
   bool     m_IsOpen;
   uint32_t m_Width;
@@ -66,9 +76,19 @@ public:
   float    m_XResolution;
   float    m_YResolution;
   uint16_t m_SampleFormat;
+  uint32_t m_RowsPerStrip;
+
+  /** The directories of the pages, and those of the reduced-resolution
+   * versions of the pages, in file order. */
+  std::vector<tdir_t> m_PageDirectories{};
+  std::vector<tdir_t> m_ReducedImageDirectories{};
 
   bool m_WarningSilence{ false };
   bool m_ErrorSilence{ false };
+
+private:
+  int
+  ReadDirectoryFields();
 };
 
 } // namespace itk
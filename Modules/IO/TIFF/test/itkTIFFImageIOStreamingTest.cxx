@@ -0,0 +1,261 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include "itkTIFFImageIO.h"
+#include "itk_tiff.h"
+#include <fstream>
+
+
+namespace
+{
+// The value of the sample of component c of the pixel (x, y) of a page
+unsigned short
+SampleValue(unsigned int page, unsigned int x, unsigned int y, unsigned int c)
+{
+  return static_cast<unsigned short>(page * 9000 + y * 31 + x * 3 + c);
+}
+
+// Write a page of width x height pixels of the given type, in tiles when
+// tileSize is not 0, in strips of rowsPerStrip rows otherwise
+template <typename TComponent>
+void
+WritePage(TIFF *       tif,
+          unsigned int page,
+          uint32_t     width,
+          uint32_t     height,
+          uint16_t     samplesPerPixel,
+          uint32_t     tileSize,
+          uint32_t     rowsPerStrip,
+          uint16_t     orientation,
+          bool         reducedImage)
+{
+  TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, width);
+  TIFFSetField(tif, TIFFTAG_IMAGELENGTH, height);
+  TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, samplesPerPixel);
+  TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, static_cast<uint16_t>(8 * sizeof(TComponent)));
+  TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+  TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, samplesPerPixel == 3 ? PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK);
+  TIFFSetField(tif, TIFFTAG_ORIENTATION, orientation);
+  TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_ADOBE_DEFLATE);
+  if (reducedImage)
+  {
+    TIFFSetField(tif, TIFFTAG_SUBFILETYPE, FILETYPE_REDUCEDIMAGE);
+  }
+
+  // The rows of the file, top to bottom or bottom to top
+  const auto fileRow = [orientation, height](uint32_t row) {
+    return orientation == ORIENTATION_BOTLEFT ? height - 1 - row : row;
+  };
+
+  if (tileSize > 0)
+  {
+    TIFFSetField(tif, TIFFTAG_TILEWIDTH, tileSize);
+    TIFFSetField(tif, TIFFTAG_TILELENGTH, tileSize);
+    std::vector<TComponent> tile(size_t{ tileSize } * tileSize * samplesPerPixel);
+    for (uint32_t y = 0; y < height; y += tileSize)
+    {
+      for (uint32_t x = 0; x < width; x += tileSize)
+      {
+        for (uint32_t j = 0; j < tileSize; ++j)
+        {
+          for (uint32_t i = 0; i < tileSize; ++i)
+          {
+            for (uint16_t c = 0; c < samplesPerPixel; ++c)
+            {
+              tile[(j * tileSize + i) * samplesPerPixel + c] =
+                static_cast<TComponent>(SampleValue(page, x + i, fileRow(y + j), c));
+            }
+          }
+        }
+        TIFFWriteTile(tif, tile.data(), x, y, 0, 0);
+      }
+    }
+  }
+  else
+  {
+    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, rowsPerStrip);
+    std::vector<TComponent> row(size_t{ width } * samplesPerPixel);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+      for (uint32_t x = 0; x < width; ++x)
+      {
+        for (uint16_t c = 0; c < samplesPerPixel; ++c)
+        {
+          row[x * samplesPerPixel + c] = static_cast<TComponent>(SampleValue(page, x, fileRow(y), c));
+        }
+      }
+      TIFFWriteScanline(tif, row.data(), y, 0);
+    }
+  }
+  TIFFWriteDirectory(tif);
+}
+
+template <typename TImage>
+bool
+CheckRegion(const TImage * image, const typename TImage::RegionType & region, unsigned int level)
+{
+  using ComponentType = typename itk::NumericTraits<typename TImage::PixelType>::ValueType;
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    const auto &                   index = it.GetIndex();
+    const typename TImage::PixelType pixel = it.Get();
+    for (unsigned int c = 0; c < itk::NumericTraits<typename TImage::PixelType>::GetLength(pixel); ++c)
+    {
+      const auto page = TImage::ImageDimension > 2 ? static_cast<unsigned int>(index[TImage::ImageDimension - 1]) : 0;
+      const auto expected =
+        static_cast<ComponentType>(SampleValue(page + level, index[0], index[1], c));
+      if (itk::DefaultConvertPixelTraits<typename TImage::PixelType>::GetNthComponent(c, pixel) != expected)
+      {
+        std::cerr << "Pixel " << index << " differs." << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+int
+itkTIFFImageIOStreamingTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  // A tiled pyramid: a page of 300 x 200 pixels, and a reduced-resolution
+  // version of it of 150 x 100 pixels
+  const std::string pyramidFileName = directory + "/itkTIFFImageIOStreamingTestPyramid.tif";
+  {
+    TIFF * tif = TIFFOpen(pyramidFileName.c_str(), "w");
+    ITK_TEST_EXPECT_TRUE(tif != nullptr);
+    WritePage<unsigned short>(tif, 0, 300, 200, 1, 64, 0, ORIENTATION_TOPLEFT, false);
+    WritePage<unsigned short>(tif, 1, 150, 100, 1, 32, 0, ORIENTATION_TOPLEFT, true);
+    TIFFClose(tif);
+  }
+
+  using ImageType = itk::Image<unsigned short, 2>;
+  auto io = itk::TIFFImageIO::New();
+  ITK_TEST_SET_GET_VALUE(0, io->GetLevel());
+  io->SetNumberOfWorkUnits(4);
+  ITK_TEST_SET_GET_VALUE(4, io->GetNumberOfWorkUnits());
+  io->SetFileName(pyramidFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(io->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(io->GetNumberOfLevels(), 2);
+  ITK_TEST_EXPECT_EQUAL(io->GetNumberOfDimensions(), 2);
+  ITK_TEST_EXPECT_EQUAL(io->GetComponentType(), itk::IOComponentEnum::USHORT);
+  ITK_TEST_EXPECT_TRUE(io->CanStreamRead());
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(pyramidFileName);
+  reader->SetImageIO(io);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_TRUE(CheckRegion(reader->GetOutput(), reader->GetOutput()->GetLargestPossibleRegion(), 0));
+
+  // Only the tiles that overlap the requested region are read
+  const ImageType::RegionType inner({ { 70, 33 } }, { { 101, 90 } });
+  auto                        streamingReader = itk::ImageFileReader<ImageType>::New();
+  streamingReader->SetFileName(pyramidFileName);
+  streamingReader->SetImageIO(io);
+  streamingReader->GetOutput()->SetRequestedRegion(inner);
+  ITK_TRY_EXPECT_NO_EXCEPTION(streamingReader->Update());
+  ITK_TEST_EXPECT_EQUAL(streamingReader->GetOutput()->GetBufferedRegion(), inner);
+  ITK_TEST_EXPECT_TRUE(CheckRegion(streamingReader->GetOutput(), inner, 0));
+
+  // The reduced-resolution level covers the same extent with larger pixels
+  auto levelIO = itk::TIFFImageIO::New();
+  levelIO->SetLevel(1);
+  levelIO->SetNumberOfWorkUnits(3);
+  auto levelReader = itk::ImageFileReader<ImageType>::New();
+  levelReader->SetFileName(pyramidFileName);
+  levelReader->SetImageIO(levelIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(levelReader->Update());
+  const ImageType * level = levelReader->GetOutput();
+  ITK_TEST_EXPECT_EQUAL(level->GetLargestPossibleRegion().GetSize(), (ImageType::SizeType{ { 150, 100 } }));
+  ITK_TEST_EXPECT_TRUE(itk::Math::FloatAlmostEqual(level->GetSpacing()[0], 2.0));
+  ITK_TEST_EXPECT_TRUE(itk::Math::FloatAlmostEqual(level->GetOrigin()[0], 0.5));
+  ITK_TEST_EXPECT_TRUE(CheckRegion(level, level->GetLargestPossibleRegion(), 1));
+
+  auto missingLevelIO = itk::TIFFImageIO::New();
+  missingLevelIO->SetLevel(2);
+  missingLevelIO->SetFileName(pyramidFileName);
+  ITK_TRY_EXPECT_EXCEPTION(missingLevelIO->ReadImageInformation());
+
+  // A tile that cannot be decoded by a work unit fails the read. The tiles of
+  // the first page are written before its directory, whose offset follows the
+  // byte order mark and the version of the little endian header.
+  {
+    std::fstream file(pyramidFileName, std::ios::in | std::ios::out | std::ios::binary);
+    unsigned char header[8] = {};
+    file.read(reinterpret_cast<char *>(header), sizeof(header));
+    ITK_TEST_EXPECT_TRUE(file && header[0] == 'I');
+    const uint32_t directoryOffset = header[4] | (header[5] << 8) | (header[6] << 16) | (uint32_t{ header[7] } << 24);
+    file.seekp(sizeof(header));
+    file.write(std::string(directoryOffset - sizeof(header), '\xff').data(), directoryOffset - sizeof(header));
+  }
+  auto corruptReader = itk::ImageFileReader<ImageType>::New();
+  corruptReader->SetFileName(pyramidFileName);
+  corruptReader->SetImageIO(io);
+  ITK_TRY_EXPECT_EXCEPTION(corruptReader->Update());
+
+  // A volume of RGB pages stored bottom to top in strips of seven rows
+  const std::string volumeFileName = directory + "/itkTIFFImageIOStreamingTestVolume.tif";
+  {
+    TIFF * tif = TIFFOpen(volumeFileName.c_str(), "w");
+    ITK_TEST_EXPECT_TRUE(tif != nullptr);
+    for (unsigned int page = 0; page < 4; ++page)
+    {
+      WritePage<unsigned char>(tif, page, 45, 38, 3, 0, 7, ORIENTATION_BOTLEFT, false);
+    }
+    TIFFClose(tif);
+  }
+
+  using RGBImageType = itk::Image<itk::RGBPixel<unsigned char>, 3>;
+  for (const itk::ThreadIdType numberOfWorkUnits : { 1, 5 })
+  {
+    auto volumeIO = itk::TIFFImageIO::New();
+    volumeIO->SetNumberOfWorkUnits(numberOfWorkUnits);
+    auto volumeReader = itk::ImageFileReader<RGBImageType>::New();
+    volumeReader->SetFileName(volumeFileName);
+    volumeReader->SetImageIO(volumeIO);
+    ITK_TRY_EXPECT_NO_EXCEPTION(volumeReader->Update());
+    ITK_TEST_EXPECT_EQUAL(volumeReader->GetOutput()->GetLargestPossibleRegion().GetSize(),
+                          (RGBImageType::SizeType{ { 45, 38, 4 } }));
+    ITK_TEST_EXPECT_TRUE(
+      CheckRegion(volumeReader->GetOutput(), volumeReader->GetOutput()->GetLargestPossibleRegion(), 0));
+
+    const RGBImageType::RegionType slab({ { 3, 9, 1 } }, { { 30, 17, 2 } });
+    auto                           slabReader = itk::ImageFileReader<RGBImageType>::New();
+    slabReader->SetFileName(volumeFileName);
+    slabReader->SetImageIO(volumeIO);
+    slabReader->GetOutput()->SetRequestedRegion(slab);
+    ITK_TRY_EXPECT_NO_EXCEPTION(slabReader->Update());
+    ITK_TEST_EXPECT_EQUAL(slabReader->GetOutput()->GetBufferedRegion(), slab);
+    ITK_TEST_EXPECT_TRUE(CheckRegion(slabReader->GetOutput(), slab, 0));
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
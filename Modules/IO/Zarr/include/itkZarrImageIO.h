@@ -0,0 +1,242 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkZarrImageIO_h
+#define itkZarrImageIO_h
+#include "ITKIOZarrExport.h"
+
+#include "itkImageIOBase.h"
+#include "itkMultiThreaderBase.h"
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class ZarrImageIO
+ * \brief Read and write chunked arrays of a Zarr store on the local file system.
+ *
+ * A Zarr store is a directory: the array is cut into chunks of equal size
+ * that are compressed and saved each in a file of their own, and JSON
+ * documents describe the array and its group. Both version 2 (.zarray,
+ * .zgroup, .zattrs) and version 3 (zarr.json) of the format are read and
+ * written.
+ *
+ * Given the directory of an OME-Zarr multiscale image, the Level selects
+ * which of its resolution levels is read, and the spacing and origin come
+ * from the scale and translation of that level. The directory of a plain
+ * array can be read as well. An image is written as an OME-Zarr group with
+ * a single level, "0", and a dimension of the array for the components of
+ * the pixels, when there are several.
+ *
+ * The dimensions of a Zarr array are stored slowest first, so they are in
+ * the reverse order of the dimensions of the image. The direction is not
+ * part of the format and is read as identity.
+ *
+ * Only the chunks that overlap the requested region are read, and only the
+ * chunks that overlap the written region are written, so that both reading
+ * and writing stream, and regions can be pasted into an existing store.
+ * The chunks are decoded and encoded concurrently by the work units of the
+ * multi-threader. The supported codecs are gzip and zlib; stores compressed
+ * with codecs that ITK does not ship, such as blosc and zstd, are reported
+ * as unsupported.
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOZarr
+ */
+class ITKIOZarr_EXPORT ZarrImageIO : public ImageIOBase
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ZarrImageIO);
+
+  /** Standard class type aliases. */
+  using Self = ZarrImageIO;
+  using Superclass = ImageIOBase;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(ZarrImageIO);
+
+  /** Version of the format of the stores written, 2 or 3. The default is 2.
+   * ReadImageInformation() sets it to the version of the store read. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(ZarrFormat, unsigned int, 2, 3);
+  itkGetConstMacro(ZarrFormat, unsigned int);
+  /** @ITKEndGrouping */
+
+  /** Resolution level of a multiscale image to read, 0 being the full
+   * resolution. The default is 0. */
+  /** @ITKStartGrouping */
+  itkSetMacro(Level, unsigned int);
+  itkGetConstMacro(Level, unsigned int);
+  /** @ITKEndGrouping */
+
+  /** Number of resolution levels of the image, known once
+   * ReadImageInformation() has been called. */
+  itkGetConstMacro(NumberOfLevels, unsigned int);
+
+  /** Size of the chunks of the arrays written, in pixels, along each
+   * dimension of the image. Dimensions without a size get one of 128 pixels
+   * for the first three dimensions, 1 for the others. */
+  /** @ITKStartGrouping */
+  itkSetMacro(ChunkSize, std::vector<SizeValueType>);
+  itkGetConstReferenceMacro(ChunkSize, std::vector<SizeValueType>);
+  /** @ITKEndGrouping */
+
+  /** Number of work units used to decode and encode the chunks. The default
+   * is the global default number of threads of the multi-threader. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(NumberOfWorkUnits, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfWorkUnits, ThreadIdType);
+  /** @ITKEndGrouping */
+
+  /*-------- This part of the interfaces deals with reading data. ----- */
+
+  /** Determine if the file can be read with this ImageIO implementation.
+   * \param fileName The name of the directory of the store.
+   * \return Returns true if this ImageIO can read the store. */
+  bool
+  CanReadFile(const char * fileName) override;
+
+  /** Set the spacing and dimension information for the set filename. */
+  void
+  ReadImageInformation() override;
+
+  /** Reads the data from disk into the memory buffer provided. */
+  void
+  Read(void * buffer) override;
+
+  /*-------- This part of the interfaces deals with writing data. ----- */
+
+  /** Determine if the file can be written with this ImageIO implementation.
+   * \param fileName The name of the directory of the store, which must end
+   * with ".zarr".
+   * \return Returns true if this ImageIO can write the store. */
+  bool
+  CanWriteFile(const char * fileName) override;
+
+  /** Set the spacing and dimension information for the set filename. */
+  void
+  WriteImageInformation() override;
+
+  /** Writes the data to disk from the memory buffer provided. Make sure
+   * that the IORegions has been set properly. */
+  void
+  Write(const void * buffer) override;
+
+  /** Any region of a store can be read on its own. */
+  bool
+  CanStreamRead() override
+  {
+    return true;
+  }
+
+  /** Any region of a store can be written on its own. */
+  bool
+  CanStreamWrite() override
+  {
+    return true;
+  }
+
+  /** Returns the requested region when UseStreamedReading is on. */
+  ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
+
+  /** Removes a previous store when the whole image is written, and checks
+   * that the store matches the image when a region is pasted. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
+protected:
+  ZarrImageIO();
+  ~ZarrImageIO() override;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Accepts "GZIP" and "ZLIB". */
+  void
+  InternalSetCompressor(const std::string & compressor) override;
+
+private:
+  /** Read the metadata of the store at the file name, and of the array of
+   * the Level when it is a multiscale image. */
+  void
+  ReadStoreMetadata();
+
+  /** Read the metadata of the array at \c path, in the given format. */
+  void
+  ReadArrayMetadata(const std::string & path, unsigned int zarrFormat);
+
+  /** Shape of the array that holds the image, in Zarr order. */
+  std::vector<SizeValueType>
+  GetImageArrayShape() const;
+
+  /** Describe the array that holds the image, for writing. */
+  void
+  SetUpArrayForWriting();
+
+  /** Write the metadata of the group and of the array. */
+  void
+  WriteMetadata() const;
+
+  /** Remove the store at the file name, if there is one. */
+  void
+  RemoveStore() const;
+
+  /** Read or write the chunks that overlap m_IORegion, concurrently. */
+  void
+  TransferChunks(void * buffer, bool write);
+
+  /** Name of the file of the chunk at \c chunkIndex in the chunk grid. */
+  std::string
+  GetChunkFileName(const std::vector<SizeValueType> & chunkIndex) const;
+
+  unsigned int               m_ZarrFormat{ 2 };
+  unsigned int               m_Level{ 0 };
+  unsigned int               m_NumberOfLevels{ 0 };
+  std::vector<SizeValueType> m_ChunkSize{};
+  ThreadIdType               m_NumberOfWorkUnits{ 1 };
+  MultiThreaderBase::Pointer m_MultiThreader{};
+  std::string                m_WriteCodec{ "gzip" };
+
+  /** The array read or written. Its dimensions are in Zarr order, slowest
+   * first, with the components of the pixels last when there are several. */
+  std::string                m_ArrayPath{};
+  std::vector<SizeValueType> m_ArrayShape{};
+  std::vector<SizeValueType> m_ArrayChunks{};
+  IOComponentEnum            m_ArrayComponentType{ IOComponentEnum::UNKNOWNCOMPONENTTYPE };
+  bool                       m_ArrayBigEndian{ false };
+  std::string                m_ArrayCodec{};
+  int                        m_ArrayCodecLevel{ 0 };
+  double                     m_FillValue{ 0.0 };
+  std::string                m_ChunkKeyPrefix{};
+  char                       m_DimensionSeparator{ '.' };
+
+  /** Scale, translation and channel axis of the level, from the OME-Zarr
+   * metadata of the group. */
+  std::vector<double> m_ArrayScale{};
+  std::vector<double> m_ArrayTranslation{};
+  bool                m_ComponentDimension{ false };
+};
+} // end namespace itk
+
+#endif // itkZarrImageIO_h
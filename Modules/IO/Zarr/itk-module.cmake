@@ -0,0 +1,21 @@
+set(
+  DOCUMENTATION
+  "This module contains an ImageIO class to read and write the chunked
+arrays of <a href=\"https://zarr.dev\">Zarr</a> stores, version 2 and 3, and
+the multiscale images of <a href=\"https://ngff.openmicroscopy.org\">OME-Zarr</a>,
+on the local file system."
+)
+
+itk_module(
+  ITKIOZarr
+  ENABLE_SHARED
+  DEPENDS
+    ITKIOImageBase
+  PRIVATE_DEPENDS
+    ITKZLIB
+  TEST_DEPENDS
+    ITKTestKernel
+  FACTORY_NAMES
+    ImageIO::Zarr
+  DESCRIPTION "${DOCUMENTATION}"
+)
@@ -0,0 +1,1220 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkZarrImageIO.h"
+#include "itkZarrJSON.h"
+#include "itkByteSwapper.h"
+#include "itk_zlib.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+namespace itk
+{
+namespace
+{
+// Metadata documents of version 2 and version 3 of the format
+constexpr char ArrayMetadataV2[] = ".zarray";
+constexpr char GroupMetadataV2[] = ".zgroup";
+constexpr char AttributesV2[] = ".zattrs";
+constexpr char MetadataV3[] = "zarr.json";
+
+std::string
+JoinPath(const std::string & directory, const std::string & name)
+{
+  if (directory.empty() || directory.back() == '/')
+  {
+    return directory + name;
+  }
+  return directory + '/' + name;
+}
+
+bool
+IsStore(const std::string & path)
+{
+  return itksys::SystemTools::FileExists(JoinPath(path, MetadataV3), true) ||
+         itksys::SystemTools::FileExists(JoinPath(path, ArrayMetadataV2), true) ||
+         itksys::SystemTools::FileExists(JoinPath(path, GroupMetadataV2), true);
+}
+
+ZarrJSON
+ReadJSONFile(const std::string & fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+  {
+    itkGenericExceptionMacro("Cannot open " << fileName << " for reading.");
+  }
+  std::ostringstream text;
+  text << file.rdbuf();
+  try
+  {
+    return ZarrJSON::Parse(text.str());
+  }
+  catch (const ExceptionObject & e)
+  {
+    itkGenericExceptionMacro("Cannot parse " << fileName << ": " << e.GetDescription());
+  }
+}
+
+void
+WriteJSONFile(const std::string & fileName, const ZarrJSON & document)
+{
+  const std::string text = document.Serialize();
+  std::ofstream     file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open() || !file.write(text.data(), static_cast<std::streamsize>(text.size())))
+  {
+    itkGenericExceptionMacro("Cannot write " << fileName << '.');
+  }
+}
+
+std::string
+GetString(const ZarrJSON * value)
+{
+  return value != nullptr ? value->GetString() : std::string();
+}
+
+// The non-negative integers of an array, such as a shape
+std::vector<SizeValueType>
+GetSizes(const ZarrJSON * value, const char * name, const std::string & fileName)
+{
+  if (value == nullptr || value->GetKind() != ZarrJSON::Kind::Array)
+  {
+    itkGenericExceptionMacro("Missing " << name << " in " << fileName << '.');
+  }
+  std::vector<SizeValueType> sizes;
+  for (const ZarrJSON & element : value->GetArray())
+  {
+    const double size = element.GetNumber();
+    if (element.GetKind() != ZarrJSON::Kind::Number || size < 0 || size != std::floor(size))
+    {
+      itkGenericExceptionMacro("Invalid " << name << " in " << fileName << '.');
+    }
+    sizes.push_back(static_cast<SizeValueType>(size));
+  }
+  return sizes;
+}
+
+std::vector<double>
+GetNumbers(const ZarrJSON * value)
+{
+  std::vector<double> numbers;
+  if (value != nullptr)
+  {
+    for (const ZarrJSON & element : value->GetArray())
+    {
+      numbers.push_back(element.GetNumber());
+    }
+  }
+  return numbers;
+}
+
+template <typename T>
+ZarrJSON
+MakeArray(const std::vector<T> & values)
+{
+  ZarrJSON::ArrayType elements;
+  for (const T value : values)
+  {
+    elements.emplace_back(static_cast<double>(value));
+  }
+  return ZarrJSON(std::move(elements));
+}
+
+// Zarr writes the floating point values that JSON lacks as strings
+double
+GetFillValue(const ZarrJSON * value)
+{
+  if (value == nullptr)
+  {
+    return 0.0;
+  }
+  switch (value->GetKind())
+  {
+    case ZarrJSON::Kind::Number:
+      return value->GetNumber();
+    case ZarrJSON::Kind::Boolean:
+      return value->GetBoolean() ? 1.0 : 0.0;
+    case ZarrJSON::Kind::String:
+      if (value->GetString() == "NaN")
+      {
+        return std::nan("");
+      }
+      if (value->GetString() == "Infinity")
+      {
+        return std::numeric_limits<double>::infinity();
+      }
+      if (value->GetString() == "-Infinity")
+      {
+        return -std::numeric_limits<double>::infinity();
+      }
+      return 0.0;
+    default:
+      return 0.0;
+  }
+}
+
+// Kind of a component type as in the data types of Zarr: 'i' for signed
+// integers, 'u' for unsigned integers and 'f' for floating point.
+char
+GetKind(IOComponentEnum componentType)
+{
+  switch (componentType)
+  {
+    case IOComponentEnum::SCHAR:
+    case IOComponentEnum::SHORT:
+    case IOComponentEnum::INT:
+    case IOComponentEnum::LONG:
+    case IOComponentEnum::LONGLONG:
+      return 'i';
+    case IOComponentEnum::UCHAR:
+    case IOComponentEnum::USHORT:
+    case IOComponentEnum::UINT:
+    case IOComponentEnum::ULONG:
+    case IOComponentEnum::ULONGLONG:
+      return 'u';
+    case IOComponentEnum::FLOAT:
+    case IOComponentEnum::DOUBLE:
+      return 'f';
+    default:
+      return '\0';
+  }
+}
+
+IOComponentEnum
+GetArrayComponentType(char kind, unsigned int size)
+{
+  switch (kind)
+  {
+    case 'b':
+      return size == 1 ? IOComponentEnum::UCHAR : IOComponentEnum::UNKNOWNCOMPONENTTYPE;
+    case 'i':
+      return size == 1   ? IOComponentEnum::INT8
+             : size == 2 ? IOComponentEnum::INT16
+             : size == 4 ? IOComponentEnum::INT32
+             : size == 8 ? IOComponentEnum::INT64
+                         : IOComponentEnum::UNKNOWNCOMPONENTTYPE;
+    case 'u':
+      return size == 1   ? IOComponentEnum::UINT8
+             : size == 2 ? IOComponentEnum::UINT16
+             : size == 4 ? IOComponentEnum::UINT32
+             : size == 8 ? IOComponentEnum::UINT64
+                         : IOComponentEnum::UNKNOWNCOMPONENTTYPE;
+    case 'f':
+      return size == 4   ? IOComponentEnum::FLOAT32
+             : size == 8 ? IOComponentEnum::FLOAT64
+                         : IOComponentEnum::UNKNOWNCOMPONENTTYPE;
+    default:
+      return IOComponentEnum::UNKNOWNCOMPONENTTYPE;
+  }
+}
+
+template <typename T>
+std::string
+MakeFillPattern(double value)
+{
+  T element{};
+  if (std::is_floating_point_v<T> || std::isfinite(value))
+  {
+    element = static_cast<T>(value);
+  }
+  return std::string(reinterpret_cast<const char *>(&element), sizeof(T));
+}
+
+// One element of the fill value, in the byte order of the system
+std::string
+MakeFillPattern(IOComponentEnum componentType, double value)
+{
+  switch (componentType)
+  {
+    case IOComponentEnum::UCHAR:
+      return MakeFillPattern<unsigned char>(value);
+    case IOComponentEnum::SCHAR:
+      return MakeFillPattern<signed char>(value);
+    case IOComponentEnum::USHORT:
+      return MakeFillPattern<unsigned short>(value);
+    case IOComponentEnum::SHORT:
+      return MakeFillPattern<short>(value);
+    case IOComponentEnum::UINT:
+      return MakeFillPattern<unsigned int>(value);
+    case IOComponentEnum::INT:
+      return MakeFillPattern<int>(value);
+    case IOComponentEnum::ULONG:
+      return MakeFillPattern<unsigned long>(value);
+    case IOComponentEnum::LONG:
+      return MakeFillPattern<long>(value);
+    case IOComponentEnum::ULONGLONG:
+      return MakeFillPattern<unsigned long long>(value);
+    case IOComponentEnum::LONGLONG:
+      return MakeFillPattern<long long>(value);
+    case IOComponentEnum::FLOAT:
+      return MakeFillPattern<float>(value);
+    case IOComponentEnum::DOUBLE:
+      return MakeFillPattern<double>(value);
+    default:
+      return {};
+  }
+}
+
+void
+SwapElements(std::string & data, size_t elementSize)
+{
+  for (size_t offset = 0; offset + elementSize <= data.size(); offset += elementSize)
+  {
+    std::reverse(data.begin() + offset, data.begin() + offset + elementSize);
+  }
+}
+
+// Read a chunk and decode it to chunkSize bytes. A missing file is the
+// chunk that only holds the fill value.
+bool
+ReadChunk(const std::string & fileName,
+          const std::string & codec,
+          size_t              chunkSize,
+          std::string &       chunk,
+          bool &              missing)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  missing = !file.is_open();
+  if (missing)
+  {
+    return true;
+  }
+  std::string stored((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (codec.empty())
+  {
+    chunk = std::move(stored);
+    return chunk.size() == chunkSize;
+  }
+
+  // Both gzip and zlib streams are recognized from their header
+  chunk.resize(chunkSize);
+  z_stream stream{};
+  if (inflateInit2(&stream, MAX_WBITS + 32) != Z_OK)
+  {
+    return false;
+  }
+  stream.next_in = reinterpret_cast<Bytef *>(&stored[0]);
+  stream.avail_in = static_cast<uInt>(stored.size());
+  stream.next_out = reinterpret_cast<Bytef *>(&chunk[0]);
+  stream.avail_out = static_cast<uInt>(chunk.size());
+  const int  status = inflate(&stream, Z_FINISH);
+  const bool complete = (status == Z_STREAM_END && stream.total_out == chunkSize);
+  inflateEnd(&stream);
+  return complete;
+}
+
+bool
+WriteChunk(const std::string & fileName, const std::string & codec, int level, const std::string & chunk)
+{
+  std::string stored;
+  if (!codec.empty())
+  {
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, codec == "gzip" ? MAX_WBITS + 16 : MAX_WBITS, 8, Z_DEFAULT_STRATEGY) !=
+        Z_OK)
+    {
+      return false;
+    }
+    // The bound of zlib does not count the larger header of gzip
+    stored.resize(deflateBound(&stream, static_cast<uLong>(chunk.size())) + 32);
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(chunk.data()));
+    stream.avail_in = static_cast<uInt>(chunk.size());
+    stream.next_out = reinterpret_cast<Bytef *>(&stored[0]);
+    stream.avail_out = static_cast<uInt>(stored.size());
+    const int status = deflate(&stream, Z_FINISH);
+    stored.resize(stream.total_out);
+    deflateEnd(&stream);
+    if (status != Z_STREAM_END)
+    {
+      return false;
+    }
+  }
+  const std::string & data = codec.empty() ? chunk : stored;
+
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  return file.is_open() && file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+} // namespace
+
+ZarrImageIO::ZarrImageIO()
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+  , m_MultiThreader(MultiThreaderBase::New())
+{
+  this->SetNumberOfDimensions(3);
+  this->SetFileTypeToBinary();
+
+  this->AddSupportedWriteExtension(".zarr");
+  this->AddSupportedReadExtension(".zarr");
+
+  this->Self::SetCompressor("");
+  this->Self::SetMaximumCompressionLevel(9);
+  this->Self::SetCompressionLevel(5);
+}
+
+ZarrImageIO::~ZarrImageIO() = default;
+
+void
+ZarrImageIO::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "ZarrFormat: " << m_ZarrFormat << std::endl;
+  os << indent << "Level: " << m_Level << std::endl;
+  os << indent << "NumberOfLevels: " << m_NumberOfLevels << std::endl;
+  os << indent << "ChunkSize:";
+  for (const SizeValueType size : m_ChunkSize)
+  {
+    os << ' ' << size;
+  }
+  os << std::endl;
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+  itkPrintSelfObjectMacro(MultiThreader);
+  os << indent << "WriteCodec: " << m_WriteCodec << std::endl;
+  os << indent << "ArrayPath: " << m_ArrayPath << std::endl;
+  os << indent << "ArrayCodec: " << m_ArrayCodec << std::endl;
+  os << indent << "FillValue: " << m_FillValue << std::endl;
+}
+
+void
+ZarrImageIO::InternalSetCompressor(const std::string & compressor)
+{
+  if (compressor.empty() || compressor == "GZIP")
+  {
+    m_WriteCodec = "gzip";
+  }
+  else if (compressor == "ZLIB")
+  {
+    m_WriteCodec = "zlib";
+  }
+  else
+  {
+    this->Superclass::InternalSetCompressor(compressor);
+  }
+}
+
+bool
+ZarrImageIO::CanReadFile(const char * fileName)
+{
+  const std::string name = fileName;
+  return !name.empty() && itksys::SystemTools::FileIsDirectory(name) && IsStore(name);
+}
+
+bool
+ZarrImageIO::CanWriteFile(const char * fileName)
+{
+  std::string name = fileName;
+  while (name.size() > 1 && name.back() == '/')
+  {
+    name.pop_back();
+  }
+  return itksys::SystemTools::LowerCase(itksys::SystemTools::GetFilenameLastExtension(name)) == ".zarr";
+}
+
+void
+ZarrImageIO::ReadStoreMetadata()
+{
+  const std::string & root = m_FileName;
+
+  // A multiscale image is a group whose attributes list the arrays of its
+  // levels; an array can also be read on its own.
+  ZarrJSON         rootDocument;
+  const ZarrJSON * multiscales = nullptr;
+  bool             group = false;
+  if (itksys::SystemTools::FileExists(JoinPath(root, MetadataV3), true))
+  {
+    m_ZarrFormat = 3;
+    rootDocument = ReadJSONFile(JoinPath(root, MetadataV3));
+    if (GetString(rootDocument.Find("node_type")) == "group")
+    {
+      group = true;
+      // OME-Zarr 0.5 keeps its metadata in the "ome" attribute
+      if (const ZarrJSON * attributes = rootDocument.Find("attributes"))
+      {
+        const ZarrJSON * ome = attributes->Find("ome");
+        multiscales = (ome != nullptr && ome->Find("multiscales") != nullptr) ? ome->Find("multiscales")
+                                                                              : attributes->Find("multiscales");
+      }
+    }
+  }
+  else if (itksys::SystemTools::FileExists(JoinPath(root, ArrayMetadataV2), true))
+  {
+    m_ZarrFormat = 2;
+  }
+  else if (itksys::SystemTools::FileExists(JoinPath(root, GroupMetadataV2), true))
+  {
+    m_ZarrFormat = 2;
+    group = true;
+    if (itksys::SystemTools::FileExists(JoinPath(root, AttributesV2), true))
+    {
+      rootDocument = ReadJSONFile(JoinPath(root, AttributesV2));
+      multiscales = rootDocument.Find("multiscales");
+    }
+  }
+  else
+  {
+    itkExceptionMacro(<< root << " is not a Zarr store.");
+  }
+
+  m_NumberOfLevels = 1;
+  m_ArrayScale.clear();
+  m_ArrayTranslation.clear();
+  m_ComponentDimension = false;
+  std::string arrayPath = root;
+  if (group)
+  {
+    if (multiscales == nullptr || multiscales->GetArray().empty())
+    {
+      itkExceptionMacro("The Zarr group " << root << " does not hold a multiscale image.");
+    }
+    const ZarrJSON & multiscale = multiscales->GetArray().front();
+    const ZarrJSON * datasets = multiscale.Find("datasets");
+    if (datasets == nullptr || datasets->GetArray().empty())
+    {
+      itkExceptionMacro("The multiscale image of " << root << " has no levels.");
+    }
+    m_NumberOfLevels = static_cast<unsigned int>(datasets->GetArray().size());
+    if (m_Level >= m_NumberOfLevels)
+    {
+      itkExceptionMacro("Cannot read level " << m_Level << " of " << root << ", which has " << m_NumberOfLevels
+                                             << " levels.");
+    }
+
+    const ZarrJSON & dataset = datasets->GetArray()[m_Level];
+    const std::string path = GetString(dataset.Find("path"));
+    if (path.empty())
+    {
+      itkExceptionMacro("Level " << m_Level << " of " << root << " has no path.");
+    }
+    arrayPath = JoinPath(root, path);
+    if (const ZarrJSON * transformations = dataset.Find("coordinateTransformations"))
+    {
+      for (const ZarrJSON & transformation : transformations->GetArray())
+      {
+        const std::string type = GetString(transformation.Find("type"));
+        if (type == "scale")
+        {
+          m_ArrayScale = GetNumbers(transformation.Find("scale"));
+        }
+        else if (type == "translation")
+        {
+          m_ArrayTranslation = GetNumbers(transformation.Find("translation"));
+        }
+      }
+    }
+    // The components of the pixels are the last axis, when it is a channel
+    if (const ZarrJSON * axes = multiscale.Find("axes"); axes != nullptr && !axes->GetArray().empty())
+    {
+      m_ComponentDimension = (GetString(axes->GetArray().back().Find("type")) == "channel");
+    }
+  }
+
+  this->ReadArrayMetadata(arrayPath, m_ZarrFormat);
+  m_ComponentDimension = m_ComponentDimension && m_ArrayShape.size() > 1;
+}
+
+void
+ZarrImageIO::ReadArrayMetadata(const std::string & path, unsigned int zarrFormat)
+{
+  m_ArrayPath = path;
+  m_ArrayCodec.clear();
+  m_ArrayBigEndian = false;
+
+  std::string fileName;
+  char        kind = '\0';
+  unsigned int size = 0;
+  if (zarrFormat == 2)
+  {
+    fileName = JoinPath(path, ArrayMetadataV2);
+    const ZarrJSON array = ReadJSONFile(fileName);
+    m_ArrayShape = GetSizes(array.Find("shape"), "shape", fileName);
+    m_ArrayChunks = GetSizes(array.Find("chunks"), "chunks", fileName);
+
+    // Such as "<i2": byte order, kind and size
+    const std::string dtype = GetString(array.Find("dtype"));
+    if (dtype.size() >= 3 && std::strchr("<>|", dtype[0]) != nullptr)
+    {
+      m_ArrayBigEndian = (dtype[0] == '>');
+      kind = dtype[1];
+      size = static_cast<unsigned int>(std::atoi(dtype.c_str() + 2));
+    }
+    if (GetString(array.Find("order")) == "F")
+    {
+      itkExceptionMacro("The Fortran order of " << fileName << " is not supported.");
+    }
+    if (const ZarrJSON * filters = array.Find("filters"); filters != nullptr && !filters->GetArray().empty())
+    {
+      itkExceptionMacro("The filters of " << fileName << " are not supported.");
+    }
+    if (const ZarrJSON * compressor = array.Find("compressor"); compressor != nullptr && !compressor->IsNull())
+    {
+      m_ArrayCodec = GetString(compressor->Find("id"));
+      if (m_ArrayCodec != "gzip" && m_ArrayCodec != "zlib")
+      {
+        itkExceptionMacro("The " << m_ArrayCodec << " compressor of " << fileName << " is not supported.");
+      }
+    }
+    m_FillValue = GetFillValue(array.Find("fill_value"));
+    const std::string separator = GetString(array.Find("dimension_separator"));
+    m_DimensionSeparator = separator.empty() ? '.' : separator[0];
+    m_ChunkKeyPrefix.clear();
+  }
+  else
+  {
+    fileName = JoinPath(path, MetadataV3);
+    const ZarrJSON array = ReadJSONFile(fileName);
+    if (GetString(array.Find("node_type")) != "array")
+    {
+      itkExceptionMacro(<< fileName << " does not describe an array.");
+    }
+    m_ArrayShape = GetSizes(array.Find("shape"), "shape", fileName);
+
+    const ZarrJSON * chunkGrid = array.Find("chunk_grid");
+    if (chunkGrid == nullptr || GetString(chunkGrid->Find("name")) != "regular" ||
+        chunkGrid->Find("configuration") == nullptr)
+    {
+      itkExceptionMacro("The chunk grid of " << fileName << " is not supported.");
+    }
+    m_ArrayChunks = GetSizes(chunkGrid->Find("configuration")->Find("chunk_shape"), "chunk_shape", fileName);
+
+    // Such as "int16"
+    const std::string dataType = GetString(array.Find("data_type"));
+    const size_t      digits = dataType.find_first_of("0123456789");
+    const std::string kindName = dataType.substr(0, digits);
+    kind = kindName == "int" ? 'i' : kindName == "uint" ? 'u' : kindName == "float" ? 'f' : '\0';
+    size = digits != std::string::npos ? static_cast<unsigned int>(std::atoi(dataType.c_str() + digits)) / 8 : 0;
+    if (dataType == "bool")
+    {
+      kind = 'b';
+      size = 1;
+    }
+
+    // The default encoding puts the chunks in a "c" directory
+    const ZarrJSON *  keyEncoding = array.Find("chunk_key_encoding");
+    const std::string encoding = keyEncoding != nullptr ? GetString(keyEncoding->Find("name")) : "default";
+    m_ChunkKeyPrefix = (encoding == "v2") ? "" : "c";
+    m_DimensionSeparator = (encoding == "v2") ? '.' : '/';
+    if (keyEncoding != nullptr && keyEncoding->Find("configuration") != nullptr)
+    {
+      const std::string separator = GetString(keyEncoding->Find("configuration")->Find("separator"));
+      if (!separator.empty())
+      {
+        m_DimensionSeparator = separator[0];
+      }
+    }
+
+    // The bytes codec turns the array into bytes, which may then be compressed
+    if (const ZarrJSON * codecs = array.Find("codecs"))
+    {
+      for (const ZarrJSON & codec : codecs->GetArray())
+      {
+        const std::string      name = GetString(codec.Find("name"));
+        const ZarrJSON * const configuration = codec.Find("configuration");
+        if (name == "bytes")
+        {
+          m_ArrayBigEndian = configuration != nullptr && GetString(configuration->Find("endian")) == "big";
+        }
+        else if (name == "gzip" && m_ArrayCodec.empty())
+        {
+          m_ArrayCodec = name;
+        }
+        else
+        {
+          itkExceptionMacro("The " << name << " codec of " << fileName << " is not supported.");
+        }
+      }
+    }
+    m_FillValue = GetFillValue(array.Find("fill_value"));
+  }
+
+  m_ArrayComponentType = GetArrayComponentType(kind, size);
+  if (m_ArrayComponentType == IOComponentEnum::UNKNOWNCOMPONENTTYPE)
+  {
+    itkExceptionMacro("The data type of " << fileName << " is not supported.");
+  }
+  if (m_ArrayShape.empty() || m_ArrayChunks.size() != m_ArrayShape.size() ||
+      std::find(m_ArrayChunks.begin(), m_ArrayChunks.end(), 0) != m_ArrayChunks.end())
+  {
+    itkExceptionMacro("The shape and the chunks of " << fileName << " do not match.");
+  }
+}
+
+void
+ZarrImageIO::ReadImageInformation()
+{
+  this->ReadStoreMetadata();
+
+  const auto numberOfDimensions = static_cast<unsigned int>(m_ArrayShape.size() - (m_ComponentDimension ? 1 : 0));
+  this->SetNumberOfDimensions(numberOfDimensions);
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+  {
+    // The dimensions of the array are in the reverse order
+    const unsigned int arrayDimension = numberOfDimensions - 1 - i;
+    this->SetDimensions(i, m_ArrayShape[arrayDimension]);
+    this->SetSpacing(i, arrayDimension < m_ArrayScale.size() ? m_ArrayScale[arrayDimension] : 1.0);
+    this->SetOrigin(i, arrayDimension < m_ArrayTranslation.size() ? m_ArrayTranslation[arrayDimension] : 0.0);
+    std::vector<double> axis(numberOfDimensions, 0.0);
+    axis[i] = 1.0;
+    this->SetDirection(i, axis);
+  }
+
+  const auto numberOfComponents = static_cast<unsigned int>(m_ComponentDimension ? m_ArrayShape.back() : 1);
+  this->SetNumberOfComponents(numberOfComponents);
+  this->SetPixelType(numberOfComponents > 1 ? IOPixelEnum::VECTOR : IOPixelEnum::SCALAR);
+  this->SetComponentType(m_ArrayComponentType);
+}
+
+void
+ZarrImageIO::Read(void * buffer)
+{
+  this->TransferChunks(buffer, false);
+}
+
+std::vector<SizeValueType>
+ZarrImageIO::GetImageArrayShape() const
+{
+  const unsigned int         numberOfDimensions = this->GetNumberOfDimensions();
+  std::vector<SizeValueType> shape;
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+  {
+    shape.push_back(this->GetDimensions(numberOfDimensions - 1 - i));
+  }
+  if (this->GetNumberOfComponents() > 1)
+  {
+    shape.push_back(this->GetNumberOfComponents());
+  }
+  return shape;
+}
+
+void
+ZarrImageIO::SetUpArrayForWriting()
+{
+  if (GetKind(m_ComponentType) == '\0')
+  {
+    itkExceptionMacro("The component type " << m_ComponentType << " cannot be written to a Zarr store.");
+  }
+
+  const unsigned int numberOfDimensions = this->GetNumberOfDimensions();
+  m_ArrayPath = JoinPath(m_FileName, "0");
+  m_ArrayShape = this->GetImageArrayShape();
+  m_ArrayChunks.assign(m_ArrayShape.size(), 1);
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+  {
+    const SizeValueType chunkSize =
+      (i < m_ChunkSize.size() && m_ChunkSize[i] > 0) ? m_ChunkSize[i] : (i < 3 ? SizeValueType{ 128 } : 1);
+    m_ArrayChunks[numberOfDimensions - 1 - i] = std::min<SizeValueType>(chunkSize, this->GetDimensions(i));
+  }
+  if (this->GetNumberOfComponents() > 1)
+  {
+    m_ArrayChunks.back() = this->GetNumberOfComponents();
+  }
+  m_ArrayComponentType = m_ComponentType;
+  m_ArrayBigEndian = ByteSwapper<int>::SystemIsBigEndian();
+
+  // Version 3 has no zlib codec
+  m_ArrayCodec = m_UseCompression ? ((m_ZarrFormat == 3) ? std::string("gzip") : m_WriteCodec) : std::string();
+  m_ArrayCodecLevel = this->GetCompressionLevel();
+  m_FillValue = 0.0;
+
+  // Nested directories, as OME-Zarr requires
+  m_ChunkKeyPrefix = (m_ZarrFormat == 3) ? "c" : "";
+  m_DimensionSeparator = '/';
+
+  m_ArrayScale.clear();
+  m_ArrayTranslation.clear();
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+  {
+    m_ArrayScale.push_back(this->GetSpacing(numberOfDimensions - 1 - i));
+    m_ArrayTranslation.push_back(this->GetOrigin(numberOfDimensions - 1 - i));
+  }
+  m_ComponentDimension = this->GetNumberOfComponents() > 1;
+  if (m_ComponentDimension)
+  {
+    m_ArrayScale.push_back(1.0);
+    m_ArrayTranslation.push_back(0.0);
+  }
+  m_NumberOfLevels = 1;
+}
+
+void
+ZarrImageIO::WriteMetadata() const
+{
+  if (!itksys::SystemTools::MakeDirectory(m_ArrayPath))
+  {
+    itkExceptionMacro("Cannot create the directory " << m_ArrayPath << '.');
+  }
+
+  // The OME-Zarr metadata of a multiscale image with a single level
+  const unsigned int  numberOfDimensions = this->GetNumberOfDimensions();
+  ZarrJSON::ArrayType axes;
+  for (unsigned int arrayDimension = 0; arrayDimension < numberOfDimensions; ++arrayDimension)
+  {
+    const unsigned int i = numberOfDimensions - 1 - arrayDimension;
+    ZarrJSON           axis;
+    if (i < 3)
+    {
+      axis.Set("name", std::string(1, "xyz"[i]));
+      axis.Set("type", "space");
+    }
+    else if (i == 3)
+    {
+      axis.Set("name", "t");
+      axis.Set("type", "time");
+    }
+    else
+    {
+      axis.Set("name", "d" + std::to_string(i));
+    }
+    axes.push_back(std::move(axis));
+  }
+  if (m_ComponentDimension)
+  {
+    ZarrJSON axis;
+    axis.Set("name", "c");
+    axis.Set("type", "channel");
+    axes.push_back(std::move(axis));
+  }
+
+  ZarrJSON scale;
+  scale.Set("type", "scale");
+  scale.Set("scale", MakeArray(m_ArrayScale));
+  ZarrJSON translation;
+  translation.Set("type", "translation");
+  translation.Set("translation", MakeArray(m_ArrayTranslation));
+  ZarrJSON dataset;
+  dataset.Set("path", "0");
+  dataset.Set("coordinateTransformations", ZarrJSON::ArrayType{ scale, translation });
+
+  ZarrJSON multiscale;
+  if (m_ZarrFormat == 2)
+  {
+    multiscale.Set("version", "0.4");
+  }
+  multiscale.Set("axes", std::move(axes));
+  multiscale.Set("datasets", ZarrJSON::ArrayType{ dataset });
+  const ZarrJSON multiscales(ZarrJSON::ArrayType{ multiscale });
+
+  // Such as "<i2" or "int16"
+  const char         kind = GetKind(m_ArrayComponentType);
+  const unsigned int size = this->GetComponentSize();
+  ZarrJSON           array;
+  array.Set("zarr_format", static_cast<double>(m_ZarrFormat));
+  if (m_ZarrFormat == 2)
+  {
+    ZarrJSON group;
+    group.Set("zarr_format", 2.0);
+    WriteJSONFile(JoinPath(m_FileName, GroupMetadataV2), group);
+    ZarrJSON attributes;
+    attributes.Set("multiscales", multiscales);
+    WriteJSONFile(JoinPath(m_FileName, AttributesV2), attributes);
+
+    array.Set("shape", MakeArray(m_ArrayShape));
+    array.Set("chunks", MakeArray(m_ArrayChunks));
+    array.Set("dtype", std::string(1, size == 1 ? '|' : (m_ArrayBigEndian ? '>' : '<')) + kind + std::to_string(size));
+    ZarrJSON compressor;
+    if (!m_ArrayCodec.empty())
+    {
+      compressor.Set("id", m_ArrayCodec);
+      compressor.Set("level", static_cast<double>(m_ArrayCodecLevel));
+    }
+    array.Set("compressor", compressor);
+    array.Set("fill_value", m_FillValue);
+    array.Set("order", "C");
+    array.Set("filters", ZarrJSON());
+    array.Set("dimension_separator", std::string(1, m_DimensionSeparator));
+    WriteJSONFile(JoinPath(m_ArrayPath, ArrayMetadataV2), array);
+  }
+  else
+  {
+    ZarrJSON ome;
+    ome.Set("version", "0.5");
+    ome.Set("multiscales", multiscales);
+    ZarrJSON attributes;
+    attributes.Set("ome", std::move(ome));
+    ZarrJSON group;
+    group.Set("zarr_format", 3.0);
+    group.Set("node_type", "group");
+    group.Set("attributes", std::move(attributes));
+    WriteJSONFile(JoinPath(m_FileName, MetadataV3), group);
+
+    array.Set("node_type", "array");
+    array.Set("shape", MakeArray(m_ArrayShape));
+    array.Set("data_type", (kind == 'i' ? "int" : kind == 'u' ? "uint" : "float") + std::to_string(8 * size));
+    ZarrJSON chunkGrid;
+    chunkGrid.Set("name", "regular");
+    chunkGrid.Set("configuration", ZarrJSON()).Set("chunk_shape", MakeArray(m_ArrayChunks));
+    array.Set("chunk_grid", std::move(chunkGrid));
+    ZarrJSON keyEncoding;
+    keyEncoding.Set("name", "default");
+    keyEncoding.Set("configuration", ZarrJSON()).Set("separator", std::string(1, m_DimensionSeparator));
+    array.Set("chunk_key_encoding", std::move(keyEncoding));
+    array.Set("fill_value", m_FillValue);
+    ZarrJSON bytes;
+    bytes.Set("name", "bytes");
+    bytes.Set("configuration", ZarrJSON()).Set("endian", m_ArrayBigEndian ? "big" : "little");
+    ZarrJSON::ArrayType codecs{ bytes };
+    if (!m_ArrayCodec.empty())
+    {
+      ZarrJSON codec;
+      codec.Set("name", m_ArrayCodec);
+      codec.Set("configuration", ZarrJSON()).Set("level", static_cast<double>(m_ArrayCodecLevel));
+      codecs.push_back(std::move(codec));
+    }
+    array.Set("codecs", std::move(codecs));
+    ZarrJSON::ArrayType dimensionNames;
+    for (const ZarrJSON & axis : multiscale.Find("axes")->GetArray())
+    {
+      dimensionNames.push_back(*axis.Find("name"));
+    }
+    array.Set("dimension_names", std::move(dimensionNames));
+    WriteJSONFile(JoinPath(m_ArrayPath, MetadataV3), array);
+  }
+}
+
+void
+ZarrImageIO::RemoveStore() const
+{
+  if (IsStore(m_FileName) && !itksys::SystemTools::RemoveADirectory(m_FileName))
+  {
+    itkExceptionMacro("Unable to remove the Zarr store " << m_FileName << '.');
+  }
+}
+
+void
+ZarrImageIO::WriteImageInformation()
+{
+  this->SetUpArrayForWriting();
+  this->WriteMetadata();
+}
+
+void
+ZarrImageIO::Write(const void * buffer)
+{
+  const unsigned int numberOfDimensions = this->GetNumberOfDimensions();
+  ImageIORegion      largestRegion(numberOfDimensions);
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+  {
+    largestRegion.SetSize(i, this->GetDimensions(i));
+  }
+
+  if (m_IORegion == largestRegion)
+  {
+    this->RemoveStore();
+  }
+  if (IsStore(m_FileName))
+  {
+    // Paste into the array of the store as it is
+    this->ReadStoreMetadata();
+    if (m_ArrayShape != this->GetImageArrayShape() || m_ArrayComponentType != m_ComponentType)
+    {
+      itkExceptionMacro("Unable to paste because the Zarr store " << m_FileName << " does not match the image.");
+    }
+  }
+  else
+  {
+    this->SetUpArrayForWriting();
+    this->WriteMetadata();
+  }
+
+  this->TransferChunks(const_cast<void *>(buffer), true);
+}
+
+std::string
+ZarrImageIO::GetChunkFileName(const std::vector<SizeValueType> & chunkIndex) const
+{
+  std::string key = m_ChunkKeyPrefix;
+  for (const SizeValueType index : chunkIndex)
+  {
+    if (!key.empty())
+    {
+      key += m_DimensionSeparator;
+    }
+    key += std::to_string(index);
+  }
+  return JoinPath(m_ArrayPath, key);
+}
+
+void
+ZarrImageIO::TransferChunks(void * buffer, bool write)
+{
+  // The region in Zarr order, with all the components of the pixels
+  const size_t       n = m_ArrayShape.size();
+  const unsigned int numberOfDimensions = this->GetNumberOfDimensions();
+  std::vector<SizeValueType> start(n, 0);
+  std::vector<SizeValueType> size(m_ArrayShape);
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+  {
+    start[numberOfDimensions - 1 - i] = static_cast<SizeValueType>(m_IORegion.GetIndex(i));
+    size[numberOfDimensions - 1 - i] = static_cast<SizeValueType>(m_IORegion.GetSize(i));
+  }
+
+  // The chunks that overlap the region
+  std::vector<SizeValueType> firstChunk(n);
+  std::vector<SizeValueType> numberOfChunksAlong(n);
+  SizeValueType              numberOfChunks = 1;
+  for (size_t d = 0; d < n; ++d)
+  {
+    if (size[d] == 0)
+    {
+      return;
+    }
+    firstChunk[d] = start[d] / m_ArrayChunks[d];
+    numberOfChunksAlong[d] = (start[d] + size[d] - 1) / m_ArrayChunks[d] - firstChunk[d] + 1;
+    numberOfChunks *= numberOfChunksAlong[d];
+  }
+  const auto getChunkIndex = [&](SizeValueType chunk) {
+    std::vector<SizeValueType> chunkIndex(n);
+    for (size_t d = n; d-- > 0;)
+    {
+      chunkIndex[d] = firstChunk[d] + chunk % numberOfChunksAlong[d];
+      chunk /= numberOfChunksAlong[d];
+    }
+    return chunkIndex;
+  };
+
+  // Strides in bytes of the chunks and of the buffer
+  const SizeValueType        elementSize = this->GetComponentSize();
+  std::vector<SizeValueType> chunkStrides(n, elementSize);
+  std::vector<SizeValueType> bufferStrides(n, elementSize);
+  for (size_t d = n - 1; d-- > 0;)
+  {
+    chunkStrides[d] = chunkStrides[d + 1] * m_ArrayChunks[d + 1];
+    bufferStrides[d] = bufferStrides[d + 1] * size[d + 1];
+  }
+  const SizeValueType chunkSize = chunkStrides[0] * m_ArrayChunks[0];
+  const std::string   fill = MakeFillPattern(m_ArrayComponentType, m_FillValue);
+  const bool          swap = elementSize > 1 && m_ArrayBigEndian != ByteSwapper<int>::SystemIsBigEndian();
+
+  if (write)
+  {
+    // The directories of nested chunk keys, created before the work units
+    // write into them
+    std::set<std::string> directories;
+    for (SizeValueType chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+      directories.insert(itksys::SystemTools::GetFilenamePath(this->GetChunkFileName(getChunkIndex(chunk))));
+    }
+    for (const std::string & directory : directories)
+    {
+      if (!itksys::SystemTools::MakeDirectory(directory))
+      {
+        itkExceptionMacro("Cannot create the directory " << directory << '.');
+      }
+    }
+  }
+
+  auto * const      bytes = static_cast<char *>(buffer);
+  std::vector<char> succeeded(numberOfChunks, 0);
+  const auto        transferChunk = [&](SizeValueType chunk) {
+    const std::vector<SizeValueType> chunkIndex = getChunkIndex(chunk);
+    const std::string                fileName = this->GetChunkFileName(chunkIndex);
+
+    // The part of the chunk in the region
+    std::vector<SizeValueType> chunkStart(n);
+    std::vector<SizeValueType> begin(n);
+    std::vector<SizeValueType> end(n);
+    bool                       covered = true;
+    for (size_t d = 0; d < n; ++d)
+    {
+      chunkStart[d] = chunkIndex[d] * m_ArrayChunks[d];
+      const SizeValueType chunkEnd = std::min(chunkStart[d] + m_ArrayChunks[d], m_ArrayShape[d]);
+      begin[d] = std::max(start[d], chunkStart[d]);
+      end[d] = std::min(start[d] + size[d], chunkEnd);
+      covered = covered && begin[d] == chunkStart[d] && end[d] == chunkEnd;
+    }
+
+    // A chunk only partly written keeps the rest of its values
+    std::string data;
+    bool        missing = true;
+    if (!write || !covered)
+    {
+      if (!ReadChunk(fileName, m_ArrayCodec, chunkSize, data, missing))
+      {
+        return;
+      }
+    }
+    if (missing)
+    {
+      data.resize(chunkSize);
+      for (SizeValueType offset = 0; offset < chunkSize; offset += elementSize)
+      {
+        memcpy(&data[offset], fill.data(), elementSize);
+      }
+    }
+    else if (swap)
+    {
+      SwapElements(data, elementSize);
+    }
+
+    // Copy row by row along the fastest dimension
+    const SizeValueType        rowSize = (end[n - 1] - begin[n - 1]) * elementSize;
+    std::vector<SizeValueType> position(begin);
+    while (true)
+    {
+      SizeValueType chunkOffset = 0;
+      SizeValueType bufferOffset = 0;
+      for (size_t d = 0; d < n; ++d)
+      {
+        chunkOffset += (position[d] - chunkStart[d]) * chunkStrides[d];
+        bufferOffset += (position[d] - start[d]) * bufferStrides[d];
+      }
+      if (write)
+      {
+        memcpy(&data[chunkOffset], bytes + bufferOffset, rowSize);
+      }
+      else
+      {
+        memcpy(bytes + bufferOffset, &data[chunkOffset], rowSize);
+      }
+
+      size_t d = n - 1;
+      while (d-- > 0 && ++position[d] == end[d])
+      {
+        position[d] = begin[d];
+      }
+      if (d == static_cast<size_t>(-1))
+      {
+        break;
+      }
+    }
+
+    if (write)
+    {
+      // A chunk that only holds the fill value is not stored
+      bool onlyFill = true;
+      for (SizeValueType offset = 0; onlyFill && offset < chunkSize; offset += elementSize)
+      {
+        onlyFill = (memcmp(&data[offset], fill.data(), elementSize) == 0);
+      }
+      if (onlyFill)
+      {
+        itksys::SystemTools::RemoveFile(fileName);
+      }
+      else
+      {
+        if (swap)
+        {
+          SwapElements(data, elementSize);
+        }
+        if (!WriteChunk(fileName, m_ArrayCodec, m_ArrayCodecLevel, data))
+        {
+          return;
+        }
+      }
+    }
+    succeeded[chunk] = 1;
+  };
+
+  m_MultiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  if (numberOfChunks > 1 && m_NumberOfWorkUnits > 1)
+  {
+    m_MultiThreader->ParallelizeArray(0, numberOfChunks, transferChunk, nullptr);
+  }
+  else
+  {
+    for (SizeValueType chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+      transferChunk(chunk);
+    }
+  }
+
+  const auto failed = std::find(succeeded.begin(), succeeded.end(), 0);
+  if (failed != succeeded.end())
+  {
+    itkExceptionMacro("Cannot " << (write ? "write " : "read ")
+                                << this->GetChunkFileName(getChunkIndex(failed - succeeded.begin())) << '.');
+  }
+}
+
+ImageIORegion
+ZarrImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
+{
+  if (m_UseStreamedReading)
+  {
+    return requestedRegion;
+  }
+  ImageIORegion streamableRegion(this->m_NumberOfDimensions);
+  for (unsigned int i = 0; i < this->m_NumberOfDimensions; ++i)
+  {
+    streamableRegion.SetSize(i, this->m_Dimensions[i]);
+    streamableRegion.SetIndex(i, 0);
+  }
+  return streamableRegion;
+}
+
+unsigned int
+ZarrImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                               const ImageIORegion & pasteRegion,
+                                               const ImageIORegion & largestPossibleRegion)
+{
+  if (pasteRegion == largestPossibleRegion)
+  {
+    // A new store, which the pieces fill
+    this->RemoveStore();
+  }
+  else if (IsStore(m_FileName))
+  {
+    // we are going to be pasting (may be streaming too)
+    const auto headerReader = Self::New();
+    headerReader->SetFileName(m_FileName);
+    headerReader->SetLevel(m_Level);
+    std::string errorMessage;
+    try
+    {
+      headerReader->ReadImageInformation();
+    }
+    catch (const ExceptionObject & e)
+    {
+      errorMessage = e.GetDescription();
+    }
+    if (errorMessage.empty())
+    {
+      if (headerReader->GetNumberOfComponents() != this->GetNumberOfComponents() ||
+          headerReader->GetComponentType() != this->GetComponentType())
+      {
+        errorMessage = "Component type does not match in file: " + m_FileName;
+      }
+      else if (headerReader->GetNumberOfDimensions() != this->GetNumberOfDimensions())
+      {
+        errorMessage = "Dimensions does not match in file: " + m_FileName;
+      }
+      else
+      {
+        for (unsigned int i = 0; i < this->GetNumberOfDimensions(); ++i)
+        {
+          if (headerReader->GetDimensions(i) != this->GetDimensions(i))
+          {
+            errorMessage = "Size does not match in file: " + m_FileName;
+          }
+        }
+      }
+    }
+    if (!errorMessage.empty())
+    {
+      itkExceptionMacro("Unable to paste because pasting file exists and is different. " << errorMessage);
+    }
+  }
+
+  return GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits, pasteRegion);
+}
+} // end namespace itk
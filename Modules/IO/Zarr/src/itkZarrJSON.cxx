@@ -0,0 +1,535 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkZarrJSON.h"
+#include "itkMacro.h"
+#include "itkNumberToString.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+namespace itk
+{
+namespace
+{
+class Parser
+{
+public:
+  explicit Parser(const std::string & text)
+    : m_Text(text)
+  {}
+
+  ZarrJSON
+  ParseDocument()
+  {
+    ZarrJSON value = this->ParseValue(0);
+    this->SkipWhitespace();
+    if (m_Position != m_Text.size())
+    {
+      this->Fail("unexpected text after the document");
+    }
+    return value;
+  }
+
+private:
+  // Deeper documents are not metadata
+  static constexpr unsigned int MaximumDepth = 64;
+
+  [[noreturn]] void
+  Fail(const char * reason) const
+  {
+    itkGenericExceptionMacro("Invalid JSON at offset " << m_Position << ": " << reason << '.');
+  }
+
+  void
+  SkipWhitespace()
+  {
+    while (m_Position < m_Text.size() && std::strchr(" \t\r\n", m_Text[m_Position]) != nullptr)
+    {
+      ++m_Position;
+    }
+  }
+
+  bool
+  Consume(const char * literal)
+  {
+    const size_t length = std::strlen(literal);
+    if (m_Text.compare(m_Position, length, literal) == 0)
+    {
+      m_Position += length;
+      return true;
+    }
+    return false;
+  }
+
+  ZarrJSON
+  ParseValue(unsigned int depth)
+  {
+    if (depth > MaximumDepth)
+    {
+      this->Fail("too deeply nested");
+    }
+    this->SkipWhitespace();
+    if (m_Position >= m_Text.size())
+    {
+      this->Fail("unexpected end");
+    }
+    const char c = m_Text[m_Position];
+    if (c == '{')
+    {
+      return this->ParseObject(depth);
+    }
+    if (c == '[')
+    {
+      return this->ParseArray(depth);
+    }
+    if (c == '"')
+    {
+      return ZarrJSON(this->ParseString());
+    }
+    if (this->Consume("true"))
+    {
+      return ZarrJSON(true);
+    }
+    if (this->Consume("false"))
+    {
+      return ZarrJSON(false);
+    }
+    if (this->Consume("null"))
+    {
+      return {};
+    }
+    // Not JSON, but written by some Python encoders
+    if (this->Consume("NaN"))
+    {
+      return ZarrJSON(std::nan(""));
+    }
+    return ZarrJSON(this->ParseNumber());
+  }
+
+  ZarrJSON
+  ParseObject(unsigned int depth)
+  {
+    ++m_Position;
+    ZarrJSON::ObjectType members;
+    this->SkipWhitespace();
+    if (this->Consume("}"))
+    {
+      return ZarrJSON(std::move(members));
+    }
+    while (true)
+    {
+      this->SkipWhitespace();
+      if (m_Position >= m_Text.size() || m_Text[m_Position] != '"')
+      {
+        this->Fail("expected a member name");
+      }
+      std::string key = this->ParseString();
+      this->SkipWhitespace();
+      if (!this->Consume(":"))
+      {
+        this->Fail("expected ':'");
+      }
+      members.emplace_back(std::move(key), this->ParseValue(depth + 1));
+      this->SkipWhitespace();
+      if (this->Consume("}"))
+      {
+        return ZarrJSON(std::move(members));
+      }
+      if (!this->Consume(","))
+      {
+        this->Fail("expected ',' or '}'");
+      }
+    }
+  }
+
+  ZarrJSON
+  ParseArray(unsigned int depth)
+  {
+    ++m_Position;
+    ZarrJSON::ArrayType elements;
+    this->SkipWhitespace();
+    if (this->Consume("]"))
+    {
+      return ZarrJSON(std::move(elements));
+    }
+    while (true)
+    {
+      elements.push_back(this->ParseValue(depth + 1));
+      this->SkipWhitespace();
+      if (this->Consume("]"))
+      {
+        return ZarrJSON(std::move(elements));
+      }
+      if (!this->Consume(","))
+      {
+        this->Fail("expected ',' or ']'");
+      }
+    }
+  }
+
+  unsigned int
+  ParseHexadecimal()
+  {
+    if (m_Position + 4 > m_Text.size())
+    {
+      this->Fail("truncated escape sequence");
+    }
+    unsigned int code = 0;
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+      const char   c = m_Text[m_Position++];
+      unsigned int digit = 0;
+      if (c >= '0' && c <= '9')
+      {
+        digit = c - '0';
+      }
+      else if (c >= 'a' && c <= 'f')
+      {
+        digit = c - 'a' + 10;
+      }
+      else if (c >= 'A' && c <= 'F')
+      {
+        digit = c - 'A' + 10;
+      }
+      else
+      {
+        this->Fail("invalid escape sequence");
+      }
+      code = code * 16 + digit;
+    }
+    return code;
+  }
+
+  static void
+  AppendUTF8(std::string & text, unsigned int code)
+  {
+    if (code < 0x80)
+    {
+      text += static_cast<char>(code);
+    }
+    else if (code < 0x800)
+    {
+      text += static_cast<char>(0xC0 | (code >> 6));
+      text += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000)
+    {
+      text += static_cast<char>(0xE0 | (code >> 12));
+      text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      text += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else
+    {
+      text += static_cast<char>(0xF0 | (code >> 18));
+      text += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+      text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      text += static_cast<char>(0x80 | (code & 0x3F));
+    }
+  }
+
+  std::string
+  ParseString()
+  {
+    ++m_Position;
+    std::string text;
+    while (m_Position < m_Text.size())
+    {
+      const char c = m_Text[m_Position++];
+      if (c == '"')
+      {
+        return text;
+      }
+      if (c != '\\')
+      {
+        text += c;
+        continue;
+      }
+      if (m_Position >= m_Text.size())
+      {
+        break;
+      }
+      const char escaped = m_Text[m_Position++];
+      switch (escaped)
+      {
+        case '"':
+        case '\\':
+        case '/':
+          text += escaped;
+          break;
+        case 'b':
+          text += '\b';
+          break;
+        case 'f':
+          text += '\f';
+          break;
+        case 'n':
+          text += '\n';
+          break;
+        case 'r':
+          text += '\r';
+          break;
+        case 't':
+          text += '\t';
+          break;
+        case 'u':
+        {
+          unsigned int code = this->ParseHexadecimal();
+          if (code >= 0xD800 && code < 0xDC00 && this->Consume("\\u"))
+          {
+            // Surrogate pair
+            code = 0x10000 + ((code - 0xD800) << 10) + (this->ParseHexadecimal() - 0xDC00);
+          }
+          AppendUTF8(text, code);
+          break;
+        }
+        default:
+          this->Fail("invalid escape sequence");
+      }
+    }
+    this->Fail("unterminated string");
+  }
+
+  double
+  ParseNumber()
+  {
+    if (this->Consume("Infinity"))
+    {
+      return std::numeric_limits<double>::infinity();
+    }
+    if (this->Consume("-Infinity"))
+    {
+      return -std::numeric_limits<double>::infinity();
+    }
+    // The number is read in the classic locale, whose decimal separator is
+    // the one of JSON, whatever the global locale
+    const size_t end = m_Text.find_first_not_of("+-0123456789.eE", m_Position);
+    std::istringstream stream(m_Text.substr(m_Position, end == std::string::npos ? end : end - m_Position));
+    stream.imbue(std::locale::classic());
+    double value = 0.0;
+    stream >> value;
+    if (stream.fail() || stream.peek() != std::char_traits<char>::eof())
+    {
+      this->Fail("unexpected character");
+    }
+    m_Position = end == std::string::npos ? m_Text.size() : end;
+    return value;
+  }
+
+  const std::string & m_Text;
+  size_t              m_Position{ 0 };
+};
+
+void
+AppendQuoted(std::string & text, const std::string & value)
+{
+  text += '"';
+  for (const char c : value)
+  {
+    switch (c)
+    {
+      case '"':
+        text += "\\\"";
+        break;
+      case '\\':
+        text += "\\\\";
+        break;
+      case '\n':
+        text += "\\n";
+        break;
+      case '\r':
+        text += "\\r";
+        break;
+      case '\t':
+        text += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          static constexpr char digits[] = "0123456789abcdef";
+          text += "\\u00";
+          text += digits[(c >> 4) & 0xF];
+          text += digits[c & 0xF];
+        }
+        else
+        {
+          text += c;
+        }
+    }
+  }
+  text += '"';
+}
+} // namespace
+
+ZarrJSON::ZarrJSON(bool value)
+  : m_Kind(Kind::Boolean)
+  , m_Boolean(value)
+{}
+
+ZarrJSON::ZarrJSON(double value)
+  : m_Kind(Kind::Number)
+  , m_Number(value)
+{}
+
+ZarrJSON::ZarrJSON(const char * value)
+  : m_Kind(Kind::String)
+  , m_String(value)
+{}
+
+ZarrJSON::ZarrJSON(std::string value)
+  : m_Kind(Kind::String)
+  , m_String(std::move(value))
+{}
+
+ZarrJSON::ZarrJSON(ArrayType value)
+  : m_Kind(Kind::Array)
+  , m_Array(std::move(value))
+{}
+
+ZarrJSON::ZarrJSON(ObjectType value)
+  : m_Kind(Kind::Object)
+  , m_Object(std::move(value))
+{}
+
+ZarrJSON
+ZarrJSON::Parse(const std::string & text)
+{
+  return Parser(text).ParseDocument();
+}
+
+const ZarrJSON *
+ZarrJSON::Find(const std::string & key) const
+{
+  for (const auto & member : m_Object)
+  {
+    if (member.first == key)
+    {
+      return &member.second;
+    }
+  }
+  return nullptr;
+}
+
+ZarrJSON &
+ZarrJSON::Set(const std::string & key, ZarrJSON value)
+{
+  if (m_Kind == Kind::Null)
+  {
+    m_Kind = Kind::Object;
+  }
+  for (auto & member : m_Object)
+  {
+    if (member.first == key)
+    {
+      member.second = std::move(value);
+      return member.second;
+    }
+  }
+  m_Object.emplace_back(key, std::move(value));
+  return m_Object.back().second;
+}
+
+std::string
+ZarrJSON::Serialize() const
+{
+  std::string text;
+  this->Serialize(text, 0);
+  text += '\n';
+  return text;
+}
+
+void
+ZarrJSON::Serialize(std::string & text, unsigned int indent) const
+{
+  const std::string innerIndent(2 * (indent + 1), ' ');
+  switch (m_Kind)
+  {
+    case Kind::Null:
+      text += "null";
+      break;
+    case Kind::Boolean:
+      text += m_Boolean ? "true" : "false";
+      break;
+    case Kind::Number:
+      // Zarr writes the numbers that JSON cannot represent as strings
+      if (std::isnan(m_Number))
+      {
+        text += "\"NaN\"";
+      }
+      else if (std::isinf(m_Number))
+      {
+        text += m_Number > 0 ? "\"Infinity\"" : "\"-Infinity\"";
+      }
+      else if (m_Number == std::floor(m_Number) && std::fabs(m_Number) < 9007199254740992.0)
+      {
+        text += std::to_string(static_cast<long long>(m_Number));
+      }
+      else
+      {
+        text += ConvertNumberToString(m_Number);
+      }
+      break;
+    case Kind::String:
+      AppendQuoted(text, m_String);
+      break;
+    case Kind::Array:
+    {
+      // Arrays of numbers, such as shapes, stay on one line
+      bool scalars = true;
+      for (const auto & element : m_Array)
+      {
+        scalars = scalars && element.m_Kind != Kind::Array && element.m_Kind != Kind::Object;
+      }
+      text += '[';
+      for (size_t i = 0; i < m_Array.size(); ++i)
+      {
+        text += (i > 0) ? (scalars ? ", " : ",\n") : (scalars ? "" : "\n");
+        if (!scalars)
+        {
+          text += innerIndent;
+        }
+        m_Array[i].Serialize(text, indent + 1);
+      }
+      if (!scalars && !m_Array.empty())
+      {
+        text += '\n' + std::string(2 * indent, ' ');
+      }
+      text += ']';
+      break;
+    }
+    case Kind::Object:
+      text += '{';
+      for (size_t i = 0; i < m_Object.size(); ++i)
+      {
+        text += (i > 0) ? ",\n" : "\n";
+        text += innerIndent;
+        AppendQuoted(text, m_Object[i].first);
+        text += ": ";
+        m_Object[i].second.Serialize(text, indent + 1);
+      }
+      if (!m_Object.empty())
+      {
+        text += '\n' + std::string(2 * indent, ' ');
+      }
+      text += '}';
+      break;
+  }
+}
+} // end namespace itk
@@ -0,0 +1,131 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkZarrJSON_h
+#define itkZarrJSON_h
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+/** \class ZarrJSON
+ * \brief Minimal JSON document model for the metadata of Zarr stores.
+ *
+ * Holds a JSON value, parses it from text and serializes it back. Numbers
+ * are kept as double, which represents exactly the integers that describe
+ * the shape and chunks of any realistic array. Object members keep their
+ * order.
+ *
+ * This class is private to the ZarrImageIO implementation.
+ *
+ * \ingroup ITKIOZarr
+ */
+class ZarrJSON
+{
+public:
+  enum class Kind
+  {
+    Null,
+    Boolean,
+    Number,
+    String,
+    Array,
+    Object
+  };
+
+  using ArrayType = std::vector<ZarrJSON>;
+  using ObjectType = std::vector<std::pair<std::string, ZarrJSON>>;
+
+  ZarrJSON() = default;
+  ZarrJSON(bool value);
+  ZarrJSON(double value);
+  ZarrJSON(const char * value);
+  ZarrJSON(std::string value);
+  ZarrJSON(ArrayType value);
+  ZarrJSON(ObjectType value);
+
+  /** Parse a JSON document. Throws an ExceptionObject on a syntax error. */
+  static ZarrJSON
+  Parse(const std::string & text);
+
+  /** The document as indented JSON text. */
+  std::string
+  Serialize() const;
+
+  Kind
+  GetKind() const
+  {
+    return m_Kind;
+  }
+
+  bool
+  IsNull() const
+  {
+    return m_Kind == Kind::Null;
+  }
+
+  /** The value, or an empty or zero one when the kind differs. */
+  bool
+  GetBoolean() const
+  {
+    return m_Boolean;
+  }
+  double
+  GetNumber() const
+  {
+    return m_Number;
+  }
+  const std::string &
+  GetString() const
+  {
+    return m_String;
+  }
+  const ArrayType &
+  GetArray() const
+  {
+    return m_Array;
+  }
+  const ObjectType &
+  GetObject() const
+  {
+    return m_Object;
+  }
+
+  /** Member \c key of an object, or null when it is absent. */
+  const ZarrJSON *
+  Find(const std::string & key) const;
+
+  /** Set member \c key of an object, which the value becomes if it was null. */
+  ZarrJSON &
+  Set(const std::string & key, ZarrJSON value);
+
+private:
+  void
+  Serialize(std::string & text, unsigned int indent) const;
+
+  Kind        m_Kind{ Kind::Null };
+  bool        m_Boolean{ false };
+  double      m_Number{ 0.0 };
+  std::string m_String{};
+  ArrayType   m_Array{};
+  ObjectType  m_Object{};
+};
+} // end namespace itk
+
+#endif // itkZarrJSON_h
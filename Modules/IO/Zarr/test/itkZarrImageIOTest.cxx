@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkVectorImage.h"
+#include "itkZarrImageIO.h"
+#include "itkZarrImageIOFactory.h"
+#include "itkTestingMacros.h"
+#include "itkTestVerifyImageRegion.h"
+#include "itksys/SystemTools.hxx"
+
+#include <fstream>
+
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+
+void
+WriteTextFile(const std::string & fileName, const std::string & text)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  file << text;
+}
+} // namespace
+
+
+int
+itkZarrImageIOTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing arguments" << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory{ argv[1] };
+
+  auto zarrIO = itk::ZarrImageIO::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(zarrIO, ZarrImageIO, ImageIOBase);
+  ITK_TEST_EXPECT_TRUE(zarrIO->CanWriteFile((directory + "/image.ZARR/").c_str()));
+  ITK_TEST_EXPECT_TRUE(!zarrIO->CanWriteFile((directory + "/image.nrrd").c_str()));
+  ITK_TEST_EXPECT_TRUE(!zarrIO->CanReadFile(directory.c_str()));
+  ITK_TEST_EXPECT_TRUE(zarrIO->CanStreamRead());
+  ITK_TEST_EXPECT_TRUE(zarrIO->CanStreamWrite());
+
+  itk::ZarrImageIOFactory::RegisterOneFactory();
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 71, 53, 29 } });
+  image->SetSpacing(itk::MakeVector(0.5, 0.75, 2.0));
+  image->SetOrigin(itk::MakePoint(-3.0, 4.0, 10.0));
+  image->Allocate();
+  short value = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<short>(it.GetIndex()[2] * 100 + (value & 15) - 8));
+    value = static_cast<short>(value * 31 + 7);
+  }
+  const ImageType::RegionType inner({ { 13, 7, 5 } }, { { 40, 31, 17 } });
+
+  // Version 2, compressed, in chunks that do not divide the image
+  const std::string v2FileName = directory + "/itkZarrImageIOTestV2.zarr";
+  {
+    auto io = itk::ZarrImageIO::New();
+    io->SetChunkSize({ 16, 20, 8 });
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(image);
+    writer->SetImageIO(io);
+    writer->SetFileName(v2FileName);
+    writer->UseCompressionOn();
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  }
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(v2FileName + "/0/.zarray", true));
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(v2FileName + "/0/0/0/0", true));
+  for (const auto & region : { image->GetLargestPossibleRegion(), inner })
+  {
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(v2FileName);
+    reader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetSpacing(), image->GetSpacing());
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetOrigin(), image->GetOrigin());
+    ITK_TEST_EXPECT_TRUE(itk::Testing::VerifyImageRegion(image.GetPointer(), reader->GetOutput(), region));
+  }
+
+  // Version 3, streamed from a reader that streams too
+  const std::string v3FileName = directory + "/itkZarrImageIOTestV3.zarr";
+  {
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(v2FileName);
+    reader->UseStreamingOn();
+
+    auto monitor = itk::PipelineMonitorImageFilter<ImageType>::New();
+    monitor->SetInput(reader->GetOutput());
+
+    auto io = itk::ZarrImageIO::New();
+    io->SetZarrFormat(3);
+    io->SetChunkSize({ 32, 32, 4 });
+    io->SetNumberOfWorkUnits(3);
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(monitor->GetOutput());
+    writer->SetImageIO(io);
+    writer->SetFileName(v3FileName);
+    writer->UseCompressionOn();
+    constexpr unsigned int numberOfStreamDivisions = 5;
+    writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+    ITK_TEST_EXPECT_TRUE(monitor->VerifyAllInputCanStream(numberOfStreamDivisions));
+  }
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(v3FileName + "/0/c/0/0/0", true));
+  {
+    auto io = itk::ZarrImageIO::New();
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(v3FileName);
+    reader->SetImageIO(io);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+    ITK_TEST_EXPECT_EQUAL(io->GetZarrFormat(), 3);
+    ITK_TEST_EXPECT_EQUAL(io->GetNumberOfLevels(), 1);
+    ITK_TEST_EXPECT_TRUE(
+      itk::Testing::VerifyImageRegion(image.GetPointer(), reader->GetOutput(), image->GetLargestPossibleRegion()));
+  }
+
+  // Pixels with components, uncompressed
+  using VectorImageType = itk::VectorImage<float, 2>;
+  auto vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(VectorImageType::SizeType{ { 37, 19 } });
+  vectorImage->SetNumberOfComponentsPerPixel(3);
+  vectorImage->Allocate();
+  for (itk::ImageRegionIterator<VectorImageType> it(vectorImage, vectorImage->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    VectorImageType::PixelType pixel(3);
+    for (unsigned int component = 0; component < 3; ++component)
+    {
+      pixel[component] = static_cast<float>(it.GetIndex()[0] * 0.5 - it.GetIndex()[1] + component);
+    }
+    it.Set(pixel);
+  }
+  const std::string vectorFileName = directory + "/itkZarrImageIOTestVector.zarr";
+  {
+    auto io = itk::ZarrImageIO::New();
+    io->SetZarrFormat(3);
+    io->SetChunkSize({ 8, 8 });
+    auto writer = itk::ImageFileWriter<VectorImageType>::New();
+    writer->SetInput(vectorImage);
+    writer->SetImageIO(io);
+    writer->SetFileName(vectorFileName);
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  }
+  {
+    auto reader = itk::ImageFileReader<VectorImageType>::New();
+    reader->SetFileName(vectorFileName);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetNumberOfComponentsPerPixel(), 3);
+    ITK_TEST_EXPECT_TRUE(itk::Testing::VerifyImageRegion(
+      vectorImage.GetPointer(), reader->GetOutput(), vectorImage->GetLargestPossibleRegion()));
+  }
+
+  // A multiscale image of two levels, the second of half the size
+  const std::string multiscaleFileName = directory + "/itkZarrImageIOTestMultiscale.zarr";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, multiscaleFileName, true));
+  auto halfImage = ImageType::New();
+  halfImage->SetRegions(ImageType::SizeType{ { 35, 26, 14 } });
+  halfImage->Allocate();
+  halfImage->FillBuffer(7);
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(halfImage, multiscaleFileName + "/1.zarr"));
+  WriteTextFile(multiscaleFileName + "/.zattrs",
+                R"({"multiscales": [{"version": "0.4",
+  "axes": [{"name": "z", "type": "space"}, {"name": "y", "type": "space"}, {"name": "x", "type": "space"}],
+  "datasets": [
+    {"path": "0", "coordinateTransformations": [{"type": "scale", "scale": [2.0, 0.75, 0.5]}]},
+    {"path": "1.zarr/0", "coordinateTransformations": [{"type": "scale", "scale": [4.0, 1.5, 1.0]}]}]}]})");
+  {
+    auto io = itk::ZarrImageIO::New();
+    io->SetLevel(1);
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(multiscaleFileName);
+    reader->SetImageIO(io);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+    ITK_TEST_EXPECT_EQUAL(io->GetNumberOfLevels(), 2);
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetLargestPossibleRegion().GetSize(),
+                          halfImage->GetLargestPossibleRegion().GetSize());
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetSpacing(), itk::MakeVector(1.0, 1.5, 4.0));
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetPixel({ { 34, 25, 13 } }), 7);
+
+    io->SetLevel(2);
+    reader->Modified();
+    ITK_TRY_EXPECT_EXCEPTION(reader->Update());
+  }
+
+  // An array written elsewhere: big endian, flat chunk keys, a missing chunk
+  const std::string arrayFileName = directory + "/itkZarrImageIOTestArray.zarr";
+  itksys::SystemTools::MakeDirectory(arrayFileName);
+  WriteTextFile(arrayFileName + "/.zarray",
+                R"({"zarr_format": 2, "shape": [3, 4], "chunks": [2, 2], "dtype": ">i2", "compressor": null,
+  "fill_value": -5, "order": "C", "filters": null})");
+  WriteTextFile(arrayFileName + "/0.0", std::string("\x00\x01\x00\x02\x01\x00\xff\xff", 8));
+  {
+    using ArrayImageType = itk::Image<short, 2>;
+    const auto array = itk::ReadImage<ArrayImageType>(arrayFileName);
+    ITK_TEST_EXPECT_EQUAL(array->GetLargestPossibleRegion().GetSize(), ArrayImageType::SizeType({ { 4, 3 } }));
+    ITK_TEST_EXPECT_EQUAL(array->GetPixel({ { 0, 0 } }), 1);
+    ITK_TEST_EXPECT_EQUAL(array->GetPixel({ { 1, 0 } }), 2);
+    ITK_TEST_EXPECT_EQUAL(array->GetPixel({ { 0, 1 } }), 256);
+    ITK_TEST_EXPECT_EQUAL(array->GetPixel({ { 1, 1 } }), -1);
+    ITK_TEST_EXPECT_EQUAL(array->GetPixel({ { 3, 2 } }), -5);
+  }
+
+  // Codecs that are not available
+  WriteTextFile(arrayFileName + "/.zarray",
+                R"({"zarr_format": 2, "shape": [3, 4], "chunks": [2, 2], "dtype": ">i2",
+  "compressor": {"id": "blosc", "cname": "zstd"}, "fill_value": 0, "order": "C", "filters": null})");
+  auto blosc = itk::ZarrImageIO::New();
+  blosc->SetFileName(arrayFileName);
+  ITK_TRY_EXPECT_EXCEPTION(blosc->ReadImageInformation());
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -148,6 +148,40 @@ public:
   itkGetConstReferenceMacro(DoEstimateLearningRateOnce, bool);
   itkBooleanMacro(DoEstimateLearningRateOnce);
   /** @ITKEndGrouping */
+  /** Set/Get the parameters of the decaying learning rate schedule.
+   *
+   *  Intended for stochastic gradient descent, i.e. when the metric draws
+   *  a new random subset of samples at each iteration. At iteration k the
+   *  learning rate is multiplied by
+   *
+   *      ((A + 1) / (A + k + 1))^alpha
+   *
+   *  where A is the decay offset and alpha is the decay exponent. The
+   *  decay applies on top of a learning rate that is set manually or
+   *  estimated. The default exponent of 0 disables the decay.
+   *
+   *  An exponent in (0.5, 1] gives the decreasing step sizes required for
+   *  the convergence of stochastic gradient descent, and an offset of a
+   *  few percent of the number of iterations keeps the first steps from
+   *  being too large.
+   *
+   * \sa ImageToImageMetricv4::SetNumberOfStochasticSamples()
+   */
+  /** @ITKStartGrouping */
+  itkSetMacro(LearningRateDecayOffset, TInternalComputationValueType);
+  itkGetConstReferenceMacro(LearningRateDecayOffset, TInternalComputationValueType);
+  itkSetMacro(LearningRateDecayExponent, TInternalComputationValueType);
+  itkGetConstReferenceMacro(LearningRateDecayExponent, TInternalComputationValueType);
+  /** @ITKEndGrouping */
+
+  /** Get the factor by which the learning rate is decayed at the current
+   *  iteration.
+   *
+   * \sa SetLearningRateDecayExponent()
+   */
+  TInternalComputationValueType
+  GetLearningRateDecayFactor() const;
+
   /** Minimum convergence value for convergence checking.
    *  The convergence checker calculates convergence value by fitting to
    *  a window of the energy profile. When the convergence value reaches
@@ -231,6 +265,8 @@ protected:
 
 
   TInternalComputationValueType m_LearningRate{};
+  TInternalComputationValueType m_LearningRateDecayOffset{};
+  TInternalComputationValueType m_LearningRateDecayExponent{};
   TInternalComputationValueType m_MinimumConvergenceValue{};
   TInternalComputationValueType m_ConvergenceValue{};
 
@@ -20,6 +20,7 @@
 
 
 #include "itkPrintHelper.h"
+#include <cmath>
 namespace itk
 {
 
@@ -243,11 +244,27 @@ void
 GradientDescentOptimizerv4Template<TInternalComputationValueType>::ModifyGradientByLearningRateOverSubRange(
   const IndexRangeType & subrange)
 {
+  const TInternalComputationValueType learningRate = this->m_LearningRate * this->GetLearningRateDecayFactor();
+
   // Loop over the range. It is inclusive.
   for (IndexValueType j = subrange[0]; j <= subrange[1]; ++j)
   {
-    this->m_Gradient[j] = this->m_Gradient[j] * this->m_LearningRate;
+    this->m_Gradient[j] = this->m_Gradient[j] * learningRate;
+  }
+}
+
+template <typename TInternalComputationValueType>
+TInternalComputationValueType
+GradientDescentOptimizerv4Template<TInternalComputationValueType>::GetLearningRateDecayFactor() const
+{
+  if (this->m_LearningRateDecayExponent == TInternalComputationValueType{})
+  {
+    return NumericTraits<TInternalComputationValueType>::OneValue();
   }
+  const TInternalComputationValueType offset =
+    this->m_LearningRateDecayOffset + NumericTraits<TInternalComputationValueType>::OneValue();
+  return std::pow(offset / (offset + static_cast<TInternalComputationValueType>(this->m_CurrentIteration)),
+                  this->m_LearningRateDecayExponent);
 }
 
 template <typename TInternalComputationValueType>
@@ -281,6 +298,8 @@ GradientDescentOptimizerv4Template<TInternalComputationValueType>::PrintSelf(std
   Superclass::PrintSelf(os, indent);
 
   print_helper::PrintNumericTrait(os, indent, "LearningRate", this->m_LearningRate);
+  print_helper::PrintNumericTrait(os, indent, "LearningRateDecayOffset", this->m_LearningRateDecayOffset);
+  print_helper::PrintNumericTrait(os, indent, "LearningRateDecayExponent", this->m_LearningRateDecayExponent);
   os << indent << "MinimumConvergenceValue: " << this->m_MinimumConvergenceValue << std::endl;
   print_helper::PrintNumericTrait(os, indent, "ConvergenceValue", this->m_ConvergenceValue);
   print_helper::PrintNumericTrait(os, indent, "CurrentBestValue", this->m_CurrentBestValue);
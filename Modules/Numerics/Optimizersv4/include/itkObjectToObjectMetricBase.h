@@ -56,12 +56,28 @@ public:
     POINT_SET_METRIC = 3,
     MULTI_METRIC = 4
   };
+
+  /**
+   * \class StochasticSamplingStrategy
+   * \ingroup ITKOptimizersv4
+   * How a metric that evaluates a random subset of its domain at each
+   * iteration draws the subset. GRADIENT_MAGNITUDE favours the edges of the
+   * fixed image without reweighting the points, so it biases the metric
+   * toward them. */
+  enum class StochasticSamplingStrategy : uint8_t
+  {
+    UNIFORM = 0,
+    STRATIFIED = 1,
+    GRADIENT_MAGNITUDE = 2
+  };
 };
 // Define how to print enumeration
 extern ITKOptimizersv4_EXPORT std::ostream &
 operator<<(std::ostream & out, const ObjectToObjectMetricBaseTemplateEnums::GradientSource value);
 extern ITKOptimizersv4_EXPORT std::ostream &
 operator<<(std::ostream & out, const ObjectToObjectMetricBaseTemplateEnums::MetricCategory value);
+extern ITKOptimizersv4_EXPORT std::ostream &
+operator<<(std::ostream & out, const ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy value);
 
 /**
  * \class ObjectToObjectMetricBaseTemplate
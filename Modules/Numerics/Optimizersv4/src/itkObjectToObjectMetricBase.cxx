@@ -60,4 +60,23 @@ operator<<(std::ostream & out, const ObjectToObjectMetricBaseTemplateEnums::Metr
     }
   }();
 }
+
+/** Print enum values */
+std::ostream &
+operator<<(std::ostream & out, const ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy::UNIFORM:
+        return "itk::ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy::UNIFORM";
+      case ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy::STRATIFIED:
+        return "itk::ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy::STRATIFIED";
+      case ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy::GRADIENT_MAGNITUDE:
+        return "itk::ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy::GRADIENT_MAGNITUDE";
+      default:
+        return "INVALID VALUE FOR itk::ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy";
+    }
+  }();
+}
 } // namespace itk
@@ -158,5 +158,17 @@ itkObjectToObjectMetricBaseTest(int, char *[])
   {
     std::cout << "STREAMED ENUM VALUE ObjectToObjectMetricBaseTemplateEnums::MetricCategory: " << ee << std::endl;
   }
+
+  // Test streaming enumeration for ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy elements
+  const std::set<itk::ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy> allStochasticSamplingStrategy{
+    itk::ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy::UNIFORM,
+    itk::ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy::STRATIFIED,
+    itk::ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy::GRADIENT_MAGNITUDE
+  };
+  for (const auto & ee : allStochasticSamplingStrategy)
+  {
+    std::cout << "STREAMED ENUM VALUE ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy: " << ee
+              << std::endl;
+  }
   return EXIT_SUCCESS;
 }
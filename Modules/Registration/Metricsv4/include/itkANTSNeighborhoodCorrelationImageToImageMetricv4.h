@@ -21,6 +21,8 @@
 #include "itkImageToImageMetricv4.h"
 #include "itkANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader.h"
 
+#include <vector>
+
 namespace itk
 {
 
@@ -50,6 +52,13 @@ namespace itk
  * neighborhood window. This is described in the above paper and specifically
  * optimized for dense registration.
  *
+ * For dense sampling, the local sums of the fixed and moving intensities over
+ * every window can instead be computed once per evaluation with separable
+ * running sums, so that the cost no longer grows with the radius and the work
+ * units need not refill their scanning window at each line. This stores six
+ * values per virtual voxel, and sums in a different order; see
+ * SetPrecomputeNeighborhoodSums().
+ *
  *  Example of usage:
  *
  *  using MetricType = itk::ANTSNeighborhoodCorrelationImageToImageMetricv4
@@ -106,6 +115,7 @@ public:
   itkOverrideGetNameOfClassMacro(ANTSNeighborhoodCorrelationImageToImageMetricv4);
 
   /** superclass types */
+  using typename Superclass::InternalComputationValueType;
   using typename Superclass::MeasureType;
   using typename Superclass::DerivativeType;
   using typename Superclass::DerivativeValueType;
@@ -156,6 +166,17 @@ public:
   itkGetMacro(Radius, RadiusType);
   itkGetConstMacro(Radius, RadiusType);
 
+  /** Compute the window sums over the whole virtual domain before each dense
+   * evaluation with separable running sums, instead of accumulating them in
+   * the scanning window of each work unit. The cost is then independent of the
+   * radius, at the price of a buffer of six values per virtual voxel. The values
+   * are summed in a different order, so the results may differ in the last bits.
+   * The sparse sampling evaluation always uses the scanning window. Default is
+   * false. */
+  itkSetMacro(PrecomputeNeighborhoodSums, bool);
+  itkGetConstMacro(PrecomputeNeighborhoodSums, bool);
+  itkBooleanMacro(PrecomputeNeighborhoodSums);
+
   void
   Initialize() override;
 
@@ -163,6 +184,50 @@ protected:
   ANTSNeighborhoodCorrelationImageToImageMetricv4();
   ~ANTSNeighborhoodCorrelationImageToImageMetricv4() override = default;
 
+  /** The sums of the valid fixed and moving values over a correlation window. */
+  struct NeighborhoodSumsType
+  {
+    InternalComputationValueType sumFixed{};
+    InternalComputationValueType sumMoving{};
+    InternalComputationValueType sumFixed2{};
+    InternalComputationValueType sumMoving2{};
+    InternalComputationValueType sumFixedMoving{};
+    InternalComputationValueType count{};
+
+    NeighborhoodSumsType &
+    operator+=(const NeighborhoodSumsType & other)
+    {
+      sumFixed += other.sumFixed;
+      sumMoving += other.sumMoving;
+      sumFixed2 += other.sumFixed2;
+      sumMoving2 += other.sumMoving2;
+      sumFixedMoving += other.sumFixedMoving;
+      count += other.count;
+      return *this;
+    }
+
+    NeighborhoodSumsType &
+    operator-=(const NeighborhoodSumsType & other)
+    {
+      sumFixed -= other.sumFixed;
+      sumMoving -= other.sumMoving;
+      sumFixed2 -= other.sumFixed2;
+      sumMoving2 -= other.sumMoving2;
+      sumFixedMoving -= other.sumFixedMoving;
+      count -= other.count;
+      return *this;
+    }
+  };
+
+  /** Compute the window sums for the dense evaluation, if enabled. */
+  void
+  InitializeForIteration() const override;
+
+  /** Fill \c m_NeighborhoodSums with the window sums centered at each voxel of
+   * the virtual region, stored in the buffer order of the virtual image. */
+  void
+  ComputeNeighborhoodSums() const;
+
   friend class ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
     ThreadedImageRegionPartitioner<VirtualImageDimension>,
     Superclass,
@@ -188,6 +253,10 @@ protected:
 private:
   // Radius of the neighborhood window centered at each pixel
   RadiusType m_Radius{};
+
+  bool m_PrecomputeNeighborhoodSums{ false };
+
+  mutable std::vector<NeighborhoodSumsType> m_NeighborhoodSums{};
 };
 
 } // end namespace itk
@@ -19,6 +19,8 @@
 #define itkANTSNeighborhoodCorrelationImageToImageMetricv4_hxx
 
 #include "itkNumericTraits.h"
+#include "itkIndexRange.h"
+#include "itkMultiThreaderBase.h"
 
 namespace itk
 {
@@ -60,6 +62,137 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage,
   Superclass::Initialize();
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage,
+                                                TMovingImage,
+                                                TVirtualImage,
+                                                TInternalComputationValueType,
+                                                TMetricTraits>::InitializeForIteration() const
+{
+  Superclass::InitializeForIteration();
+
+  if (this->m_PrecomputeNeighborhoodSums && !this->GetUseSparseSampling())
+  {
+    this->ComputeNeighborhoodSums();
+  }
+  else
+  {
+    this->m_NeighborhoodSums.clear();
+    this->m_NeighborhoodSums.shrink_to_fit();
+  }
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage,
+                                                TMovingImage,
+                                                TVirtualImage,
+                                                TInternalComputationValueType,
+                                                TMetricTraits>::ComputeNeighborhoodSums() const
+{
+  const VirtualImageType * virtualImage = this->GetVirtualImage();
+  const ImageRegionType    virtualRegion = this->GetVirtualRegion();
+
+  this->m_NeighborhoodSums.resize(virtualRegion.GetNumberOfPixels());
+  NeighborhoodSumsType * sums = this->m_NeighborhoodSums.data();
+
+  const auto multiThreader = MultiThreaderBase::New();
+  multiThreader->SetNumberOfWorkUnits(this->GetMaximumNumberOfWorkUnits());
+
+  // Evaluate each voxel once. A voxel contributes to the windows it belongs to
+  // only if it maps inside both images (and masks).
+  multiThreader->template ParallelizeImageRegion<VirtualImageDimension>(
+    virtualRegion,
+    [this, virtualImage, sums](const ImageRegionType & subRegion) {
+      VirtualPointType     virtualPoint;
+      FixedImagePointType  mappedFixedPoint;
+      FixedImagePixelType  fixedImageValue;
+      MovingImagePointType mappedMovingPoint;
+      MovingImagePixelType movingImageValue;
+
+      for (const IndexType & index : ImageRegionIndexRange<VirtualImageDimension>(subRegion))
+      {
+        NeighborhoodSumsType & voxelSums = sums[virtualImage->ComputeOffset(index)];
+        voxelSums = NeighborhoodSumsType();
+
+        this->TransformVirtualIndexToPhysicalPoint(index, virtualPoint);
+        if (this->TransformAndEvaluateFixedPoint(virtualPoint, mappedFixedPoint, fixedImageValue) &&
+            this->TransformAndEvaluateMovingPoint(virtualPoint, mappedMovingPoint, movingImageValue))
+        {
+          voxelSums.sumFixed = fixedImageValue;
+          voxelSums.sumMoving = movingImageValue;
+          voxelSums.sumFixed2 = fixedImageValue * fixedImageValue;
+          voxelSums.sumMoving2 = movingImageValue * movingImageValue;
+          voxelSums.sumFixedMoving = fixedImageValue * movingImageValue;
+          voxelSums.count = NumericTraits<InternalComputationValueType>::OneValue();
+        }
+      }
+    },
+    nullptr);
+
+  // Box filter the sums one direction at a time with a running sum along each
+  // line, clipping the window at the border of the virtual region.
+  OffsetValueType stride = 1;
+  for (unsigned int dim = 0; dim < VirtualImageDimension; ++dim)
+  {
+    const auto            lineLength = static_cast<OffsetValueType>(virtualRegion.GetSize(dim));
+    const auto            radius = static_cast<OffsetValueType>(this->m_Radius[dim]);
+    const OffsetValueType lineStride = stride;
+    stride *= lineLength;
+
+    if (radius == 0 || lineLength < 2)
+    {
+      continue;
+    }
+
+    multiThreader->template ParallelizeImageRegionRestrictDirection<VirtualImageDimension>(
+      dim,
+      virtualRegion,
+      [virtualImage, sums, dim, lineLength, radius, lineStride](const ImageRegionType & subRegion) {
+        ImageRegionType lineStarts = subRegion;
+        lineStarts.SetSize(dim, 1);
+
+        std::vector<NeighborhoodSumsType> line(lineLength);
+        for (const IndexType & index : ImageRegionIndexRange<VirtualImageDimension>(lineStarts))
+        {
+          NeighborhoodSumsType * lineSums = sums + virtualImage->ComputeOffset(index);
+          for (OffsetValueType i = 0; i < lineLength; ++i)
+          {
+            line[i] = lineSums[i * lineStride];
+          }
+
+          NeighborhoodSumsType windowSums;
+          for (OffsetValueType i = 0; i < std::min(radius, lineLength - 1) + 1; ++i)
+          {
+            windowSums += line[i];
+          }
+          for (OffsetValueType i = 0; i < lineLength; ++i)
+          {
+            lineSums[i * lineStride] = windowSums;
+            if (i + radius + 1 < lineLength)
+            {
+              windowSums += line[i + radius + 1];
+            }
+            if (i - radius >= 0)
+            {
+              windowSums -= line[i - radius];
+            }
+          }
+        }
+      },
+      nullptr);
+  }
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -74,6 +207,7 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage,
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "Correlation window radius: " << m_Radius << std::endl;
+  itkPrintSelfBooleanMacro(PrecomputeNeighborhoodSums);
 }
 
 } // end namespace itk
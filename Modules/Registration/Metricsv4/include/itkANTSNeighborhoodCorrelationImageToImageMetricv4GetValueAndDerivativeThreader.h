@@ -46,6 +46,10 @@ struct IdentityHelper
  * its derivative incrementally inside the window. The sparse threader uses a sampled point set partitioner to
  * computer local cross correlation only at the sampled positions.
  *
+ * When the metric precomputes the window sums (see
+ * ANTSNeighborhoodCorrelationImageToImageMetricv4::SetPrecomputeNeighborhoodSums), the dense threader reads
+ * them from the metric instead of scanning, and only evaluates the center point of each window.
+ *
  * This threader class is designed to host the dense and sparse threader under the same name so most computation
  * routine functions and interior member variables can be shared. This eliminates the need to duplicate codes
  * for two threaders. This is made by using function overloading and a helper class to identify different types of
@@ -97,6 +101,7 @@ public:
   using FixedImageType = typename NeighborhoodCorrelationMetricType::FixedImageType;
   using MovingImageType = typename NeighborhoodCorrelationMetricType::MovingImageType;
   using RadiusType = typename NeighborhoodCorrelationMetricType::RadiusType;
+  using NeighborhoodSumsType = typename NeighborhoodCorrelationMetricType::NeighborhoodSumsType;
 
   // interested values here updated during scanning
   using QueueRealType = InternalComputationValueType;
@@ -287,6 +292,14 @@ protected:
                                const ScanParametersType & scanParameters,
                                const ThreadIdType         threadId) const;
 
+  /** Compute the centered statistics of the window at \c virtualIndex from
+   * its sums, and evaluate the center point. Returns false if the window or
+   * its center have no valid point. */
+  bool
+  ComputeInformationFromNeighborhoodSums(const VirtualIndexType &     virtualIndex,
+                                         const NeighborhoodSumsType & sums,
+                                         ScanMemType &                scanMem) const;
+
   void
   ComputeMovingTransformDerivative(const ScanIteratorType &   scanIt,
                                    ScanMemType &              scanMem,
@@ -18,6 +18,7 @@
 #ifndef itkANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader_hxx
 #define itkANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader_hxx
 
+#include "itkIndexRange.h"
 
 namespace itk
 {
@@ -41,7 +42,6 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader<TDo
 
   std::call_once(this->m_ANTSAssociateOnceFlag, [this, &associate]() { this->m_ANTSAssociate = associate; });
 
-  VirtualPointType   virtualPoint;
   MeasureType        metricValueResult{};
   MeasureType        metricValueSum{};
   bool               pointIsValid = false;
@@ -52,16 +52,57 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader<TDo
   DerivativeType & localDerivativeResult = this->m_GetValueAndDerivativePerThreadVariables[threadId].LocalDerivatives;
 
   /* Create an iterator over the virtual sub region */
-  // associate->InitializeScanning( virtualImageSubRegion, scanIt, scanMem, scanParameters );
   this->InitializeScanning(virtualImageSubRegion, scanIt, scanMem, scanParameters);
 
+  const auto storeResult = [this, threadId, &metricValueResult, &metricValueSum](const VirtualIndexType & index) {
+    this->m_GetValueAndDerivativePerThreadVariables[threadId].NumberOfValidPoints++;
+    metricValueSum -= metricValueResult;
+    /* Store the result. This depends on what type of
+     * transform is being used. */
+    if (this->GetComputeDerivative())
+    {
+      this->StorePointDerivativeResult(index, threadId);
+    }
+  };
+
+  if (associate->GetPrecomputeNeighborhoodSums() && !associate->m_NeighborhoodSums.empty())
+  {
+    /* The window sums were computed by the metric over the whole virtual region */
+    const VirtualImageType * virtualImage = associate->GetVirtualImage();
+    for (const VirtualIndexType & index :
+         ImageRegionIndexRange<TImageToImageMetric::VirtualImageDimension>(virtualImageSubRegion))
+    {
+      try
+      {
+        pointIsValid = this->ComputeInformationFromNeighborhoodSums(
+          index, associate->m_NeighborhoodSums[virtualImage->ComputeOffset(index)], scanMem);
+        if (pointIsValid)
+        {
+          this->ComputeMovingTransformDerivative(
+            scanIt, scanMem, scanParameters, localDerivativeResult, metricValueResult, threadId);
+        }
+      }
+      catch (const ExceptionObject & exc)
+      {
+        // NOTE: there must be a cleaner way to do this:
+        std::string msg("Caught exception: \n");
+        msg += exc.what();
+        throw ExceptionObject(__FILE__, __LINE__, msg);
+      }
+
+      if (pointIsValid)
+      {
+        storeResult(index);
+      }
+    }
+    this->m_GetValueAndDerivativePerThreadVariables[threadId].Measure = metricValueSum;
+    return;
+  }
+
   /* Iterate over the sub region */
   scanIt.GoToBegin();
   while (!scanIt.IsAtEnd())
   {
-    /* Get the virtual point */
-    associate->TransformVirtualIndexToPhysicalPoint(scanIt.GetIndex(), virtualPoint);
-
     /* Call the user method in derived classes to do the specific
      * calculations for value and derivative. */
     try
@@ -85,14 +126,7 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader<TDo
     /* Assign the results */
     if (pointIsValid)
     {
-      this->m_GetValueAndDerivativePerThreadVariables[threadId].NumberOfValidPoints++;
-      metricValueSum -= metricValueResult;
-      /* Store the result. This depends on what type of
-       * transform is being used. */
-      if (this->GetComputeDerivative())
-      {
-        this->StorePointDerivativeResult(scanIt.GetIndex(), threadId);
-      }
+      storeResult(scanIt.GetIndex());
     }
 
     // next index
@@ -381,44 +415,28 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
                                                                 const ScanParametersType &,
                                                                 const ThreadIdType) const
 {
-  using LocalRealType = InternalComputationValueType;
-
-  constexpr LocalRealType localZero{};
-
-  LocalRealType count = localZero;
+  NeighborhoodSumsType sums;
 
   auto itcount = scanMem.Qcount.begin();
   while (itcount != scanMem.Qcount.end())
   {
-    count += *itcount;
+    sums.count += *itcount;
     ++itcount;
   }
 
-  if (count <= localZero)
-  {
-    // no points available in the queue, perhaps out of image region
-    return false;
-  }
-
-  // If there are values, we need to calculate the different quantities
-  LocalRealType sumFixed2 = localZero;
-  LocalRealType sumMoving2 = localZero;
-  LocalRealType sumFixed = localZero;
-  LocalRealType sumMoving = localZero;
-  LocalRealType sumFixedMoving = localZero;
-  auto          itFixed2 = scanMem.QsumFixed2.begin();
-  auto          itMoving2 = scanMem.QsumMoving2.begin();
-  auto          itFixed = scanMem.QsumFixed.begin();
-  auto          itMoving = scanMem.QsumMoving.begin();
-  auto          itFixedMoving = scanMem.QsumFixedMoving.begin();
+  auto itFixed2 = scanMem.QsumFixed2.begin();
+  auto itMoving2 = scanMem.QsumMoving2.begin();
+  auto itFixed = scanMem.QsumFixed.begin();
+  auto itMoving = scanMem.QsumMoving.begin();
+  auto itFixedMoving = scanMem.QsumFixedMoving.begin();
 
   while (itFixed2 != scanMem.QsumFixed2.end())
   {
-    sumFixed2 += *itFixed2;
-    sumMoving2 += *itMoving2;
-    sumFixed += *itFixed;
-    sumMoving += *itMoving;
-    sumFixedMoving += *itFixedMoving;
+    sums.sumFixed2 += *itFixed2;
+    sums.sumMoving2 += *itMoving2;
+    sums.sumFixed += *itFixed;
+    sums.sumMoving += *itMoving;
+    sums.sumFixedMoving += *itFixedMoving;
 
     ++itFixed2;
     ++itMoving2;
@@ -427,6 +445,33 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
     ++itFixedMoving;
   }
 
+  return this->ComputeInformationFromNeighborhoodSums(scanIt.GetIndex(), sums, scanMem);
+}
+
+template <typename TDomainPartitioner, typename TImageToImageMetric, typename TNeighborhoodCorrelationMetric>
+bool
+ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader<TDomainPartitioner,
+                                                                             TImageToImageMetric,
+                                                                             TNeighborhoodCorrelationMetric>::
+  ComputeInformationFromNeighborhoodSums(const VirtualIndexType &     virtualIndex,
+                                         const NeighborhoodSumsType & sums,
+                                         ScanMemType &                scanMem) const
+{
+  using LocalRealType = InternalComputationValueType;
+
+  const LocalRealType count = sums.count;
+  if (count <= LocalRealType{})
+  {
+    // no points available in the window, perhaps out of image region
+    return false;
+  }
+
+  const LocalRealType sumFixed2 = sums.sumFixed2;
+  const LocalRealType sumMoving2 = sums.sumMoving2;
+  const LocalRealType sumFixed = sums.sumFixed;
+  const LocalRealType sumMoving = sums.sumMoving;
+  const LocalRealType sumFixedMoving = sums.sumFixedMoving;
+
   const LocalRealType fixedMean = sumFixed / count;
   const LocalRealType movingMean = sumMoving / count;
 
@@ -437,8 +482,6 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
   const LocalRealType sFixedMoving =
     sumFixedMoving - movingMean * sumFixed - fixedMean * sumMoving + count * movingMean * fixedMean;
 
-  const typename VirtualImageType::IndexType oindex = scanIt.GetIndex();
-
   VirtualPointType        virtualPoint;
   FixedImagePointType     mappedFixedPoint;
   FixedImagePixelType     fixedImageValue;
@@ -448,7 +491,7 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
   MovingImageGradientType movingImageGradient;
   bool                    pointIsValid = false;
 
-  this->m_ANTSAssociate->TransformVirtualIndexToPhysicalPoint(oindex, virtualPoint);
+  this->m_ANTSAssociate->TransformVirtualIndexToPhysicalPoint(virtualIndex, virtualPoint);
 
   try
   {
@@ -84,7 +84,7 @@ CorrelationImageToImageMetricv4<TFixedImage,
   // Invoke the pipeline in the helper threader
   // refer to DomainThreader::Execute()
 
-  if (this->m_UseSampledPointSet) // sparse sampling
+  if (this->GetUseSparseSampling()) // sparse sampling
   {
     const SizeValueType numberOfPoints = this->GetNumberOfDomainPoints();
     if (numberOfPoints < 1)
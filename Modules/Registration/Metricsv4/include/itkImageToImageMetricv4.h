@@ -31,6 +31,7 @@
 #include "itkPointSet.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkDefaultImageToImageMetricTraitsv4.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
 
 namespace itk
 {
@@ -108,6 +109,14 @@ namespace itk
  * use a gradient image filter for it because it will only be
  * calculated once.
  *
+ * Stochastic Sampling
+ *
+ * For stochastic gradient descent, SetNumberOfStochasticSamples makes each
+ * evaluation draw a new random subset of the domain, i.e. of the sampled
+ * point set or of the virtual region, and evaluate only that subset with
+ * the sparse threader. See SetStochasticSamplingStrategy for the ways the
+ * subset can be drawn.
+ *
  * Vector Images
  *
  * To support vector images, the class must be declared using the
@@ -475,6 +484,49 @@ public:
   itkGetConstReferenceMacro(UseVirtualSampledPointSet, bool);
   itkBooleanMacro(UseVirtualSampledPointSet);
   /** @ITKEndGrouping */
+
+  using StochasticSamplingStrategyEnum = ObjectToObjectMetricBaseTemplateEnums::StochasticSamplingStrategy;
+  using RandomGeneratorType = Statistics::MersenneTwisterRandomVariateGenerator;
+  using RandomSeedType = RandomGeneratorType::IntegerType;
+
+  /** Set/Get the number of points evaluated at each iteration, for
+   * stochastic gradient descent. When non-zero, each call to GetValue() or
+   * GetValueAndDerivative() draws a new random subset of this many points
+   * from the domain, i.e. from the virtual sampled point set when
+   * UseSampledPointSet is on, and from the virtual region otherwise, and
+   * evaluates the metric over that subset only. The domain itself is not
+   * rebuilt. The derivative becomes a noisy estimate, which is best paired
+   * with a decaying learning rate (see
+   * GradientDescentOptimizerv4Template::SetLearningRateDecayExponent()).
+   * The default, zero, evaluates the whole domain. */
+  /** @ITKStartGrouping */
+  itkSetMacro(NumberOfStochasticSamples, SizeValueType);
+  itkGetConstMacro(NumberOfStochasticSamples, SizeValueType);
+  /** @ITKEndGrouping */
+  /** Set/Get how the stochastic subset is drawn. UNIFORM, the default,
+   * draws each point independently with equal probability. STRATIFIED
+   * splits the domain, in point set or memory order, into as many
+   * consecutive strata as there are samples, and draws one point per
+   * stratum. GRADIENT_MAGNITUDE draws each point with a probability
+   * proportional to the fixed image gradient magnitude at that point; the
+   * probabilities are computed once, during Initialize(). The points drawn
+   * this way are not weighted by the inverse of their probability, so
+   * GRADIENT_MAGNITUDE is a biased, edge-emphasizing mode: the value and the
+   * derivative estimate those of the metric restricted to the edges of the
+   * fixed image, not of the metric over the whole domain, and points with a
+   * zero gradient are never drawn. UNIFORM and STRATIFIED estimate the full
+   * domain metric. */
+  /** @ITKStartGrouping */
+  itkSetEnumMacro(StochasticSamplingStrategy, StochasticSamplingStrategyEnum);
+  itkGetEnumMacro(StochasticSamplingStrategy, StochasticSamplingStrategyEnum);
+  /** @ITKEndGrouping */
+  /** Set/Get the seed of the stochastic sampling. The random generator is
+   * reseeded during Initialize(), so that the same sequence of subsets is
+   * drawn for a given metric setup. */
+  /** @ITKStartGrouping */
+  itkSetMacro(StochasticSamplingSeed, RandomSeedType);
+  itkGetConstMacro(StochasticSamplingSeed, RandomSeedType);
+  /** @ITKEndGrouping */
 #if !defined(ITK_LEGACY_REMOVE)
   /** UseFixedSampledPointSet is deprecated and has been replaced
    * with UseSampledPointsSet. */
@@ -589,11 +641,17 @@ public:
 
   /** Get the number of points in the domain used to evaluate
    * the metric. This will differ depending on whether a sampled
-   * point set or dense sampling is used, and will be greater than
-   * or equal to GetNumberOfValidPoints(). */
+   * point set, a stochastic subset or dense sampling is used, and will
+   * be greater than or equal to GetNumberOfValidPoints(). */
   SizeValueType
   GetNumberOfDomainPoints() const;
 
+  /** Get the virtual index and point of element \c i of the sparse domain
+   * evaluated by the sparse threader, i.e. of the sampled point set or of
+   * the current stochastic subset. */
+  void
+  GetSparseDomainPoint(SizeValueType i, VirtualIndexType & virtualIndex, VirtualPointType & virtualPoint) const;
+
   /** Set/Get the option for applying floating point resolution truncation
    * to derivative calculations in global support cases. False by default. It is only
    * applied in global support cases (i.e. with global-support transforms) because
@@ -756,6 +814,15 @@ protected:
   /** Get accessor for flag to calculate derivative. */
   itkGetConstMacro(ComputeDerivative, bool);
 
+  /** Return true when the metric is evaluated over a list of points, either
+   * the sampled point set or a stochastic subset, with the sparse threader,
+   * instead of over the whole virtual region with the dense threader. */
+  bool
+  GetUseSparseSampling() const
+  {
+    return this->m_UseSampledPointSet || !this->m_StochasticSampleIdentifiers.empty();
+  }
+
   FixedImageConstPointer  m_FixedImage{};
   MovingImageConstPointer m_MovingImage{};
 
@@ -815,6 +882,14 @@ protected:
   FixedSampledPointSet */
   bool m_UseVirtualSampledPointSet{};
 
+  /** Stochastic sampling. The identifiers of the current subset index
+   * either the virtual sampled point set or the virtual region, in memory
+   * order. They are redrawn in InitializeForIteration(). */
+  SizeValueType                      m_NumberOfStochasticSamples{};
+  StochasticSamplingStrategyEnum     m_StochasticSamplingStrategy{ StochasticSamplingStrategyEnum::UNIFORM };
+  RandomSeedType                     m_StochasticSamplingSeed{};
+  mutable std::vector<SizeValueType> m_StochasticSampleIdentifiers{};
+
   ImageToImageMetricv4();
   ~ImageToImageMetricv4() override = default;
 
@@ -826,6 +901,25 @@ private:
   void
   MapFixedSampledPointSetToVirtual();
 
+  /** Get the number of points of the whole domain, regardless of any
+   * stochastic subset. */
+  SizeValueType
+  GetNumberOfFullDomainPoints() const;
+
+  /** Get the virtual index and point of a domain element, i.e. of a point
+   * of the sampled point set or of a pixel of the virtual region. */
+  void
+  GetFullDomainPoint(SizeValueType identifier, VirtualIndexType & virtualIndex, VirtualPointType & virtualPoint) const;
+
+  /** Compute the cumulative sampling weights of the domain for the
+   * GRADIENT_MAGNITUDE strategy. */
+  void
+  InitializeStochasticSamplingWeights();
+
+  /** Draw a new stochastic subset of the domain. */
+  void
+  DrawStochasticSamples() const;
+
   /** Transform a point. Avoid cast if possible */
   void
   LocalTransformPoint(const typename FixedTransformType::OutputPointType & virtualPoint,
@@ -888,6 +982,9 @@ private:
   /** Flag to know if derivative should be calculated */
   mutable bool m_ComputeDerivative{};
 
+  typename RandomGeneratorType::Pointer m_StochasticSamplingRandomGenerator{};
+  std::vector<double>                   m_StochasticSamplingCumulativeWeights{};
+
   /** Only floating-point images are currently supported. To support integer images,
    * several small changes must be made */
   /** @ITKStartGrouping */
@@ -24,6 +24,8 @@
 #include "itkLinearInterpolateImageFunction.h"
 #include "itkIdentityTransform.h"
 
+#include <algorithm>
+
 namespace itk
 {
 
@@ -61,6 +63,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   this->m_DefaultFixedImageGradientCalculator->UseImageDirectionOn();
   this->m_DefaultMovingImageGradientCalculator->UseImageDirectionOn();
   this->m_Value = NumericTraits<MeasureType>::max();
+
+  this->m_StochasticSamplingRandomGenerator = RandomGeneratorType::New();
+  this->m_StochasticSamplingSeed = RandomGeneratorType::GetNextSeed();
 }
 
 template <typename TFixedImage,
@@ -170,6 +175,18 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     itkDebugMacro("Initialize: ComputeMovingImageGradientFilterImage");
     this->ComputeMovingImageGradientFilterImage();
   }
+
+  /* Setup the stochastic sampling. The subsets are drawn in
+   * InitializeForIteration. */
+  this->m_StochasticSampleIdentifiers.clear();
+  this->m_StochasticSamplingCumulativeWeights.clear();
+  this->m_StochasticSamplingRandomGenerator->SetSeed(this->m_StochasticSamplingSeed);
+  if (this->m_NumberOfStochasticSamples > 0 &&
+      this->m_StochasticSamplingStrategy == StochasticSamplingStrategyEnum::GRADIENT_MAGNITUDE)
+  {
+    itkDebugMacro("Initialize: InitializeStochasticSamplingWeights");
+    this->InitializeStochasticSamplingWeights();
+  }
 }
 
 template <typename TFixedImage,
@@ -240,7 +257,7 @@ void
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
   GetValueAndDerivativeExecute() const
 {
-  if (this->m_UseSampledPointSet) // sparse sampling
+  if (this->GetUseSparseSampling()) // sparse sampling
   {
     const SizeValueType numberOfPoints = this->GetNumberOfDomainPoints();
     if (numberOfPoints < 1)
@@ -268,6 +285,8 @@ void
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
   InitializeForIteration() const
 {
+  this->DrawStochasticSamples();
+
   if (this->m_ComputeDerivative)
   {
     /* This size always comes from the active transform */
@@ -535,7 +554,7 @@ ThreadIdType
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
   GetMaximumNumberOfWorkUnits() const
 {
-  if (this->m_UseSampledPointSet)
+  if (this->GetUseSparseSampling())
   {
     return this->m_SparseGetValueAndDerivativeThreader->GetMaximumNumberOfThreads();
   }
@@ -551,7 +570,7 @@ ThreadIdType
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
   GetNumberOfWorkUnitsUsed() const
 {
-  if (this->m_UseSampledPointSet)
+  if (this->GetUseSparseSampling())
   {
     return this->m_SparseGetValueAndDerivativeThreader->GetNumberOfWorkUnitsUsed();
   }
@@ -620,6 +639,22 @@ template <typename TFixedImage,
 SizeValueType
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
   GetNumberOfDomainPoints() const
+{
+  if (!this->m_StochasticSampleIdentifiers.empty())
+  {
+    return static_cast<SizeValueType>(this->m_StochasticSampleIdentifiers.size());
+  }
+  return this->GetNumberOfFullDomainPoints();
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+SizeValueType
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  GetNumberOfFullDomainPoints() const
 {
   if (this->m_UseSampledPointSet)
   {
@@ -632,6 +667,157 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   return region.GetNumberOfPixels();
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  GetSparseDomainPoint(SizeValueType i, VirtualIndexType & virtualIndex, VirtualPointType & virtualPoint) const
+{
+  const SizeValueType identifier =
+    this->m_StochasticSampleIdentifiers.empty() ? i : this->m_StochasticSampleIdentifiers[i];
+  this->GetFullDomainPoint(identifier, virtualIndex, virtualPoint);
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  GetFullDomainPoint(SizeValueType identifier, VirtualIndexType & virtualIndex, VirtualPointType & virtualPoint) const
+{
+  if (this->m_UseSampledPointSet)
+  {
+    virtualPoint = this->m_VirtualSampledPointSet->GetPoint(identifier);
+    virtualIndex = this->m_VirtualImage->TransformPhysicalPointToIndex(virtualPoint);
+    return;
+  }
+
+  // Identifiers of the virtual region follow the memory order of its pixels.
+  const VirtualRegionType & region = this->GetVirtualRegion();
+  for (unsigned int d = 0; d < VirtualImageDimension; ++d)
+  {
+    const SizeValueType size = region.GetSize(d);
+    virtualIndex[d] = region.GetIndex(d) + static_cast<IndexValueType>(identifier % size);
+    identifier /= size;
+  }
+  this->TransformVirtualIndexToPhysicalPoint(virtualIndex, virtualPoint);
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  InitializeStochasticSamplingWeights()
+{
+  // The weights are the magnitudes of the fixed image gradients. Use the
+  // gradient image when the metric already computes it, and the gradient
+  // calculator otherwise.
+  const bool useGradientCalculator = this->m_UseFixedImageGradientFilter && !this->GetGradientSourceIncludesFixed();
+  if (useGradientCalculator)
+  {
+    this->m_FixedImageGradientCalculator->SetInputImage(this->m_FixedImage);
+  }
+
+  const SizeValueType numberOfDomainPoints = this->GetNumberOfFullDomainPoints();
+  this->m_StochasticSamplingCumulativeWeights.resize(numberOfDomainPoints);
+
+  VirtualIndexType       virtualIndex;
+  VirtualPointType       virtualPoint;
+  FixedImagePointType    mappedFixedPoint;
+  FixedImagePixelType    mappedFixedPixelValue;
+  FixedImageGradientType fixedImageGradient;
+  double                 cumulativeWeight = 0.0;
+  for (SizeValueType identifier = 0; identifier < numberOfDomainPoints; ++identifier)
+  {
+    this->GetFullDomainPoint(identifier, virtualIndex, virtualPoint);
+    if (this->TransformAndEvaluateFixedPoint(virtualPoint, mappedFixedPoint, mappedFixedPixelValue))
+    {
+      if (useGradientCalculator)
+      {
+        fixedImageGradient = this->m_FixedImageGradientCalculator->Evaluate(mappedFixedPoint);
+      }
+      else
+      {
+        this->ComputeFixedImageGradientAtPoint(mappedFixedPoint, fixedImageGradient);
+      }
+      cumulativeWeight += fixedImageGradient.GetNorm();
+    }
+    this->m_StochasticSamplingCumulativeWeights[identifier] = cumulativeWeight;
+  }
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  DrawStochasticSamples() const
+{
+  this->m_StochasticSampleIdentifiers.clear();
+
+  const SizeValueType numberOfDomainPoints = this->GetNumberOfFullDomainPoints();
+  if (this->m_NumberOfStochasticSamples == 0 || this->m_NumberOfStochasticSamples >= numberOfDomainPoints)
+  {
+    return;
+  }
+
+  const SizeValueType numberOfSamples = this->m_NumberOfStochasticSamples;
+  const SizeValueType lastIdentifier = numberOfDomainPoints - 1;
+  const auto          domainSize = static_cast<double>(numberOfDomainPoints);
+  this->m_StochasticSampleIdentifiers.resize(numberOfSamples);
+
+  RandomGeneratorType * randomGenerator = this->m_StochasticSamplingRandomGenerator.GetPointer();
+
+  const auto & cumulativeWeights = this->m_StochasticSamplingCumulativeWeights;
+  const bool   useWeights = this->m_StochasticSamplingStrategy == StochasticSamplingStrategyEnum::GRADIENT_MAGNITUDE &&
+                          cumulativeWeights.size() == numberOfDomainPoints && cumulativeWeights.back() > 0.0;
+
+  if (this->m_StochasticSamplingStrategy == StochasticSamplingStrategyEnum::STRATIFIED)
+  {
+    // One sample per stratum, so the identifiers are already sorted.
+    const double strataSize = domainSize / static_cast<double>(numberOfSamples);
+    for (SizeValueType i = 0; i < numberOfSamples; ++i)
+    {
+      const double position = strataSize * (static_cast<double>(i) + randomGenerator->GetVariateWithOpenUpperRange());
+      this->m_StochasticSampleIdentifiers[i] = std::min(static_cast<SizeValueType>(position), lastIdentifier);
+    }
+    return;
+  }
+
+  if (useWeights)
+  {
+    const double totalWeight = cumulativeWeights.back();
+    for (auto & identifier : this->m_StochasticSampleIdentifiers)
+    {
+      const double weight = randomGenerator->GetVariateWithOpenUpperRange(totalWeight);
+      const auto   position = std::upper_bound(cumulativeWeights.cbegin(), cumulativeWeights.cend(), weight);
+      identifier = std::min(static_cast<SizeValueType>(position - cumulativeWeights.cbegin()), lastIdentifier);
+    }
+  }
+  else
+  {
+    // Uniform sampling, also used when all gradient weights are zero.
+    for (auto & identifier : this->m_StochasticSampleIdentifiers)
+    {
+      const double position = randomGenerator->GetVariateWithOpenUpperRange(domainSize);
+      identifier = std::min(static_cast<SizeValueType>(position), lastIdentifier);
+    }
+  }
+
+  // Visit the domain in order, for memory locality.
+  std::sort(this->m_StochasticSampleIdentifiers.begin(), this->m_StochasticSampleIdentifiers.end());
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -648,7 +834,10 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
      << indent << "GetUseFixedImageGradientFilter: " << this->GetUseFixedImageGradientFilter() << std::endl
      << indent << "GetUseMovingImageGradientFilter: " << this->GetUseMovingImageGradientFilter() << std::endl
      << indent << "UseFloatingPointCorrection: " << this->GetUseFloatingPointCorrection() << std::endl
-     << indent << "FloatingPointCorrectionResolution: " << this->GetFloatingPointCorrectionResolution() << std::endl;
+     << indent << "FloatingPointCorrectionResolution: " << this->GetFloatingPointCorrectionResolution() << std::endl
+     << indent << "NumberOfStochasticSamples: " << this->m_NumberOfStochasticSamples << std::endl
+     << indent << "StochasticSamplingStrategy: " << this->m_StochasticSamplingStrategy << std::endl
+     << indent << "StochasticSamplingSeed: " << this->m_StochasticSamplingSeed << std::endl;
 
   itkPrintSelfObjectMacro(FixedImage);
   itkPrintSelfObjectMacro(MovingImage);
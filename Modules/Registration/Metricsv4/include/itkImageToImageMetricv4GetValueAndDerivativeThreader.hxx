@@ -46,16 +46,15 @@ void
 ImageToImageMetricv4GetValueAndDerivativeThreader<ThreadedIndexedContainerPartitioner, TImageToImageMetricv4>::
   ThreadedExecution(const DomainType & indexSubRange, const ThreadIdType threadId)
 {
-  const typename TImageToImageMetricv4::VirtualPointSetType::ConstPointer virtualSampledPointSet =
-    this->m_Associate->GetVirtualSampledPointSet();
   using ElementIdentifierType = typename TImageToImageMetricv4::VirtualPointSetType::MeshTraits::PointIdentifier;
-  const ElementIdentifierType                   begin = indexSubRange[0];
-  const ElementIdentifierType                   end = indexSubRange[1];
-  const typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
+  const ElementIdentifierType begin = indexSubRange[0];
+  const ElementIdentifierType end = indexSubRange[1];
+  VirtualPointType            virtualPoint;
+  VirtualIndexType            virtualIndex;
   for (ElementIdentifierType i = begin; i <= end; ++i)
   {
-    const VirtualPointType & virtualPoint = virtualSampledPointSet->GetPoint(i);
-    const auto               virtualIndex = virtualImage->TransformPhysicalPointToIndex(virtualPoint);
+    // The element is a point of the sampled point set or of the stochastic subset.
+    this->m_Associate->GetSparseDomainPoint(i, virtualIndex, virtualPoint);
     this->ProcessVirtualPoint(virtualIndex, virtualPoint, threadId);
   }
   // Finalize per thread actions
@@ -51,8 +51,7 @@ JointHistogramMutualInformationComputeJointPDFThreader<ThreadedIndexedContainerP
   const ElementIdentifierType end = indexSubRange[1];
   for (ElementIdentifierType i = begin; i <= end; ++i)
   {
-    virtualPoint = this->m_Associate->m_VirtualSampledPointSet->GetPoint(i);
-    this->m_Associate->TransformPhysicalPointToVirtualIndex(virtualPoint, virtualIndex);
+    this->m_Associate->GetSparseDomainPoint(i, virtualIndex, virtualPoint);
     this->ProcessPoint(virtualIndex, virtualPoint, threadId);
   }
 }
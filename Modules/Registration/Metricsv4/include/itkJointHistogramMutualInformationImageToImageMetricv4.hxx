@@ -219,7 +219,7 @@ JointHistogramMutualInformationImageToImageMetricv4<TFixedImage,
   /**
    * First, we compute the joint histogram
    */
-  if (this->m_UseSampledPointSet)
+  if (this->GetUseSparseSampling())
   {
     const SizeValueType numberOfPoints = this->GetNumberOfDomainPoints();
     if (numberOfPoints < 1)
@@ -11,6 +11,7 @@ itk_module(
     ITKOptimizersv4
   TEST_DEPENDS
     ITKTestKernel
+    ITKImageSources
     ITKOptimizersv4
   DESCRIPTION "${DOCUMENTATION}"
 )
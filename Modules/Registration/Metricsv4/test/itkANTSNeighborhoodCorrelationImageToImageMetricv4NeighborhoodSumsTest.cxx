@@ -0,0 +1,163 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkANTSNeighborhoodCorrelationImageToImageMetricv4.h"
+#include "itkDisplacementFieldTransform.h"
+#include "itkIdentityTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+/**
+ * Compare the dense evaluation of ANTSNeighborhoodCorrelationImageToImageMetricv4
+ * using precomputed window sums against the scanning window, for several radii,
+ * on a virtual domain that does not start at the origin and with a displacement
+ * that maps part of the domain outside of the moving image.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<double, Dimension>;
+using MetricType = itk::ANTSNeighborhoodCorrelationImageToImageMetricv4<ImageType, ImageType>;
+using DisplacementTransformType = itk::DisplacementFieldTransform<double, Dimension>;
+using FieldType = DisplacementTransformType::DisplacementFieldType;
+
+ImageType::Pointer
+MakeImage(const ImageType::RegionType & region, const double frequency, const double phase)
+{
+  auto image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> It(image, region);
+  for (It.GoToBegin(); !It.IsAtEnd(); ++It)
+  {
+    const ImageType::IndexType index = It.GetIndex();
+    It.Set(50.0 + 20.0 * std::sin(frequency * index[0] + phase) * std::cos(0.7 * frequency * index[1]) +
+           0.1 * index[0] * index[1]);
+  }
+  return image;
+}
+
+DisplacementTransformType::Pointer
+MakeDisplacementTransform(const ImageType * image)
+{
+  auto field = FieldType::New();
+  field->CopyInformation(image);
+  field->SetRegions(image->GetBufferedRegion());
+  field->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<FieldType> It(field, field->GetBufferedRegion());
+  for (It.GoToBegin(); !It.IsAtEnd(); ++It)
+  {
+    const FieldType::IndexType index = It.GetIndex();
+    FieldType::PixelType       displacement;
+    displacement[0] = 2.5 * std::sin(0.2 * index[1]) + 1.5;
+    displacement[1] = 1.5 * std::cos(0.15 * index[0]);
+    It.Set(displacement);
+  }
+
+  auto transform = DisplacementTransformType::New();
+  transform->SetDisplacementField(field);
+  return transform;
+}
+
+bool
+CompareEvaluations(const ImageType *               fixedImage,
+                   const ImageType *               movingImage,
+                   DisplacementTransformType *     transform,
+                   const MetricType::RadiusType & radius)
+{
+  MetricType::MeasureType    values[2];
+  MetricType::DerivativeType derivatives[2];
+  itk::SizeValueType         numberOfValidPoints[2];
+
+  for (const bool precompute : { true, false })
+  {
+    auto metric = MetricType::New();
+    metric->SetRadius(radius);
+    metric->SetFixedImage(fixedImage);
+    metric->SetMovingImage(movingImage);
+    metric->SetFixedTransform(itk::IdentityTransform<double, Dimension>::New());
+    metric->SetMovingTransform(transform);
+    metric->SetPrecomputeNeighborhoodSums(precompute);
+    metric->Initialize();
+
+    metric->GetValueAndDerivative(values[precompute], derivatives[precompute]);
+    numberOfValidPoints[precompute] = metric->GetNumberOfValidPoints();
+
+    if (itk::Math::NotAlmostEquals(metric->GetValue(), values[precompute]))
+    {
+      std::cerr << "GetValue and GetValueAndDerivative differ for radius " << radius << std::endl;
+      return false;
+    }
+  }
+
+  std::cout << "Radius " << radius << ": value " << values[true] << " (sums), " << values[false] << " (scanning), "
+            << numberOfValidPoints[true] << " valid points" << std::endl;
+
+  if (numberOfValidPoints[true] != numberOfValidPoints[false] ||
+      numberOfValidPoints[true] == fixedImage->GetBufferedRegion().GetNumberOfPixels())
+  {
+    std::cerr << "Unexpected number of valid points: " << numberOfValidPoints[true] << " (sums), "
+              << numberOfValidPoints[false] << " (scanning)" << std::endl;
+    return false;
+  }
+  if (std::abs(values[true] - values[false]) > 1e-10 * std::abs(values[false]))
+  {
+    std::cerr << "Metric values differ: " << values[true] << " (sums), " << values[false] << " (scanning)"
+              << std::endl;
+    return false;
+  }
+  const double tolerance = 1e-8 * derivatives[false].inf_norm();
+  if (!derivatives[true].is_equal(derivatives[false], tolerance))
+  {
+    std::cerr << "Derivatives differ by " << (derivatives[true] - derivatives[false]).inf_norm() << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+int
+itkANTSNeighborhoodCorrelationImageToImageMetricv4NeighborhoodSumsTest(int, char *[])
+{
+  auto metric = MetricType::New();
+  ITK_TEST_EXPECT_TRUE(!metric->GetPrecomputeNeighborhoodSums());
+  ITK_TEST_SET_GET_BOOLEAN(metric, PrecomputeNeighborhoodSums, true);
+
+  const ImageType::RegionType region(itk::MakeIndex(3, -2), itk::MakeSize(41, 36));
+  const ImageType::Pointer    fixedImage = MakeImage(region, 0.3, 0.0);
+  const ImageType::Pointer    movingImage = MakeImage(region, 0.3, 0.4);
+
+  const DisplacementTransformType::Pointer transform = MakeDisplacementTransform(fixedImage);
+
+  bool testPassed = true;
+  for (const auto & radius : { itk::MakeSize(2, 2), itk::MakeSize(4, 1), itk::MakeSize(0, 3), itk::MakeSize(8, 8) })
+  {
+    testPassed &= CompareEvaluations(fixedImage, movingImage, transform, radius);
+  }
+
+  if (!testPassed)
+  {
+    std::cerr << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/**
+ * Test the stochastic sampling of ImageToImageMetricv4 together with the
+ * decaying learning rate of GradientDescentOptimizerv4.
+ *
+ * A translation is recovered with each sampling strategy, both over the
+ * virtual region and over a sampled point set, evaluating only a small
+ * subset of the domain at each iteration.
+ */
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkCorrelationImageToImageMetricv4.h"
+#include "itkJointHistogramMutualInformationImageToImageMetricv4.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkGaussianImageSource.h"
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTranslationTransform.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<double, Dimension>;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+using StochasticSamplingStrategyEnum = MetricType::StochasticSamplingStrategyEnum;
+
+// A Gaussian blob of standard deviation 10 and height 100 on a 64 x 64 image
+ImageType::Pointer
+MakeBlobImage(const double centerX, const double centerY)
+{
+  using BlobSourceType = itk::GaussianImageSource<ImageType>;
+  auto                            source = BlobSourceType::New();
+  const BlobSourceType::ArrayType mean{ { centerX, centerY } };
+  source->SetSize(ImageType::SizeType::Filled(64));
+  source->SetMean(mean);
+  source->SetSigma(BlobSourceType::ArrayType::Filled(10.0));
+  source->SetScale(100.0);
+  source->NormalizedOff();
+  source->Update();
+  return source->GetOutput();
+}
+
+MetricType::FixedSampledPointSetType::Pointer
+MakeRegularPointSet(const ImageType * image, const unsigned int stride)
+{
+  auto          pointSet = MetricType::FixedSampledPointSetType::New();
+  unsigned long pointId = 0;
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> It(image, image->GetLargestPossibleRegion()); !It.IsAtEnd();
+       ++It)
+  {
+    const ImageType::IndexType index = It.GetIndex();
+    if (index[0] % stride == 0 && index[1] % stride == 0)
+    {
+      ImageType::PointType point;
+      image->TransformIndexToPhysicalPoint(index, point);
+      pointSet->SetPoint(pointId++, point);
+    }
+  }
+  return pointSet;
+}
+
+template <typename TMetric>
+void
+SetMetricInputs(TMetric * metric, const ImageType * fixedImage, const ImageType * movingImage)
+{
+  metric->SetFixedImage(fixedImage);
+  metric->SetMovingImage(movingImage);
+  metric->SetFixedTransform(TransformType::New());
+  metric->SetMovingTransform(TransformType::New());
+}
+
+bool
+RecoverTranslation(const ImageType *                       fixedImage,
+                   const ImageType *                       movingImage,
+                   StochasticSamplingStrategyEnum          strategy,
+                   bool                                    useSampledPointSet,
+                   const TransformType::OutputVectorType & expectedTranslation)
+{
+  auto metric = MetricType::New();
+  SetMetricInputs(metric.GetPointer(), fixedImage, movingImage);
+  metric->SetNumberOfStochasticSamples(200);
+  metric->SetStochasticSamplingStrategy(strategy);
+  metric->SetStochasticSamplingSeed(121212);
+  if (useSampledPointSet)
+  {
+    metric->SetFixedSampledPointSet(MakeRegularPointSet(fixedImage, 2));
+    metric->UseSampledPointSetOn();
+  }
+  metric->Initialize();
+
+  using ScalesEstimatorType = itk::RegistrationParameterScalesFromPhysicalShift<MetricType>;
+  auto scalesEstimator = ScalesEstimatorType::New();
+  scalesEstimator->SetMetric(metric);
+  scalesEstimator->SetTransformForward(true);
+
+  auto optimizer = itk::GradientDescentOptimizerv4::New();
+  optimizer->SetMetric(metric);
+  optimizer->SetNumberOfIterations(100);
+  optimizer->SetScalesEstimator(scalesEstimator);
+  optimizer->SetDoEstimateLearningRateOnce(false);
+  optimizer->SetDoEstimateLearningRateAtEachIteration(true);
+  optimizer->SetLearningRateDecayOffset(5.0);
+  optimizer->SetLearningRateDecayExponent(1.0);
+  // The stochastic metric values are too noisy for the convergence monitor
+  optimizer->SetMinimumConvergenceValue(0.0);
+  optimizer->StartOptimization();
+
+  const TransformType::ParametersType parameters = metric->GetMovingTransform()->GetParameters();
+  std::cout << "Strategy " << strategy << (useSampledPointSet ? " over the sampled point set" : " over the region")
+            << ": " << parameters << ", domain points " << metric->GetNumberOfDomainPoints() << std::endl;
+
+  if (metric->GetNumberOfDomainPoints() != metric->GetNumberOfStochasticSamples())
+  {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Expected the metric to be evaluated over " << metric->GetNumberOfStochasticSamples()
+              << " points, but got " << metric->GetNumberOfDomainPoints() << std::endl;
+    return false;
+  }
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    if (std::abs(parameters[d] - expectedTranslation[d]) > 0.5)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Expected translation " << expectedTranslation << ", but got " << parameters << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkImageToImageMetricv4StochasticSamplingTest(int, char *[])
+{
+  const ImageType::Pointer fixedImage = MakeBlobImage(32.0, 32.0);
+  const ImageType::Pointer movingImage = MakeBlobImage(35.0, 30.0);
+
+  TransformType::OutputVectorType expectedTranslation;
+  expectedTranslation[0] = 3.0;
+  expectedTranslation[1] = -2.0;
+
+  auto metric = MetricType::New();
+  ITK_TEST_EXPECT_EQUAL(metric->GetNumberOfStochasticSamples(), 0);
+  ITK_TEST_EXPECT_EQUAL(metric->GetStochasticSamplingStrategy(), StochasticSamplingStrategyEnum::UNIFORM);
+  metric->SetStochasticSamplingStrategy(StochasticSamplingStrategyEnum::STRATIFIED);
+  ITK_TEST_EXPECT_EQUAL(metric->GetStochasticSamplingStrategy(), StochasticSamplingStrategyEnum::STRATIFIED);
+  metric->SetStochasticSamplingStrategy(StochasticSamplingStrategyEnum::UNIFORM);
+
+  // Without stochastic sampling the whole virtual region is evaluated
+  SetMetricInputs(metric.GetPointer(), fixedImage, movingImage);
+  metric->Initialize();
+  MetricType::DerivativeType fullDerivative;
+  MetricType::MeasureType    fullValue;
+  metric->GetValueAndDerivative(fullValue, fullDerivative);
+  ITK_TEST_EXPECT_EQUAL(metric->GetNumberOfDomainPoints(), fixedImage->GetLargestPossibleRegion().GetNumberOfPixels());
+
+  // Each evaluation draws a new subset, and the seed makes the sequence reproducible
+  metric->SetNumberOfStochasticSamples(100);
+  metric->SetStochasticSamplingSeed(1234);
+  ITK_TEST_EXPECT_EQUAL(metric->GetStochasticSamplingSeed(), 1234);
+  metric->Initialize();
+  MetricType::DerivativeType firstDerivative;
+  MetricType::DerivativeType secondDerivative;
+  MetricType::MeasureType    value;
+  metric->GetValueAndDerivative(value, firstDerivative);
+  ITK_TEST_EXPECT_EQUAL(metric->GetNumberOfDomainPoints(), 100);
+  metric->GetValueAndDerivative(value, secondDerivative);
+  ITK_TEST_EXPECT_TRUE(firstDerivative != secondDerivative);
+
+  metric->Initialize();
+  metric->GetValueAndDerivative(value, secondDerivative);
+  ITK_TEST_EXPECT_TRUE(firstDerivative == secondDerivative);
+  std::cout << "Full derivative " << fullDerivative << ", stochastic derivative " << firstDerivative << std::endl;
+
+  // A subset as large as the domain evaluates the whole domain
+  metric->SetNumberOfStochasticSamples(fixedImage->GetLargestPossibleRegion().GetNumberOfPixels());
+  metric->Initialize();
+  metric->GetValueAndDerivative(value, secondDerivative);
+  ITK_TEST_EXPECT_EQUAL(value, fullValue);
+
+  // The metrics that precompute statistics over the domain use the same subset
+  using CorrelationMetricType = itk::CorrelationImageToImageMetricv4<ImageType, ImageType>;
+  auto correlationMetric = CorrelationMetricType::New();
+  SetMetricInputs(correlationMetric.GetPointer(), fixedImage, movingImage);
+  correlationMetric->SetNumberOfStochasticSamples(500);
+  ITK_TRY_EXPECT_NO_EXCEPTION(correlationMetric->Initialize());
+  ITK_TRY_EXPECT_NO_EXCEPTION(correlationMetric->GetValueAndDerivative(value, firstDerivative));
+  ITK_TEST_EXPECT_EQUAL(correlationMetric->GetNumberOfDomainPoints(), 500);
+
+  using JointHistogramMetricType = itk::JointHistogramMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+  auto jointHistogramMetric = JointHistogramMetricType::New();
+  SetMetricInputs(jointHistogramMetric.GetPointer(), fixedImage, movingImage);
+  jointHistogramMetric->SetNumberOfStochasticSamples(500);
+  ITK_TRY_EXPECT_NO_EXCEPTION(jointHistogramMetric->Initialize());
+  ITK_TRY_EXPECT_NO_EXCEPTION(jointHistogramMetric->GetValueAndDerivative(value, firstDerivative));
+  ITK_TEST_EXPECT_EQUAL(jointHistogramMetric->GetNumberOfDomainPoints(), 500);
+
+  // The learning rate decay is off by default
+  auto optimizer = itk::GradientDescentOptimizerv4::New();
+  ITK_TEST_EXPECT_EQUAL(optimizer->GetLearningRateDecayExponent(), 0.0);
+  ITK_TEST_EXPECT_EQUAL(optimizer->GetLearningRateDecayFactor(), 1.0);
+
+  bool testPassed = true;
+  for (const auto strategy : { StochasticSamplingStrategyEnum::UNIFORM,
+                               StochasticSamplingStrategyEnum::STRATIFIED,
+                               StochasticSamplingStrategyEnum::GRADIENT_MAGNITUDE })
+  {
+    for (const bool useSampledPointSet : { false, true })
+    {
+      testPassed &= RecoverTranslation(fixedImage, movingImage, strategy, useSampledPointSet, expectedTranslation);
+    }
+  }
+
+  if (!testPassed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageRegistrationFixedImageContext_h
+#define itkImageRegistrationFixedImageContext_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkShrinkImageFilter.h"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+/** \class ImageRegistrationFixedImageContext
+ * \brief Shared, read-only cache of the smoothed fixed images and virtual domains of a registration.
+ *
+ * When many moving images are registered against the same fixed image
+ * (e.g. atlas or template construction), every instance of
+ * ImageRegistrationMethodv4 recomputes the same smoothed fixed images and
+ * the same shrunken virtual domain images at each level.  This object
+ * computes each of these at most once and hands out const pointers to the
+ * results, so that any number of registration methods, possibly running
+ * concurrently in different threads, can share them.
+ *
+ * Only these images are cached.  The metrics still compute their own fixed
+ * image gradients, samples and histograms; a gradient image can be shared
+ * through ImageToImageMetricv4::SetFixedImageGradientFilter.
+ *
+ * The cached images are computed lazily, on first request, for the exact
+ * smoothing sigma or shrink factors asked for.  The mutex only guards the
+ * fixed image and the lists of entries: each entry is computed outside of
+ * it, once, by the first registration that requests it, while requests for
+ * other entries proceed.  Changing the fixed image clears the cache.
+ *
+ * To partition the cores between concurrent registrations, limit the
+ * number of work units of the metric of each registration method (see
+ * ObjectToObjectMetricBaseTemplate::SetMaximumNumberOfWorkUnits).
+ *
+ * \sa ImageRegistrationMethodv4::SetFixedImageContext
+ *
+ * \ingroup ITKRegistrationMethodsv4
+ */
+template <typename TFixedImage, typename TVirtualImage = TFixedImage>
+class ITK_TEMPLATE_EXPORT ImageRegistrationFixedImageContext : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageRegistrationFixedImageContext);
+
+  /** Standard class type aliases. */
+  using Self = ImageRegistrationFixedImageContext;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** \see LightObject::GetNameOfClass() */
+  itkOverrideGetNameOfClassMacro(ImageRegistrationFixedImageContext);
+
+  /** ImageDimension constants */
+  static constexpr unsigned int ImageDimension = TFixedImage::ImageDimension;
+
+  using FixedImageType = TFixedImage;
+  using FixedImageConstPointer = typename FixedImageType::ConstPointer;
+  using VirtualImageType = TVirtualImage;
+  using VirtualImageConstPointer = typename VirtualImageType::ConstPointer;
+
+  using ShrinkFilterType = ShrinkImageFilter<FixedImageType, VirtualImageType>;
+  using ShrinkFactorsPerDimensionContainerType = typename ShrinkFilterType::ShrinkFactorsType;
+
+  using RealType = double;
+
+  /** Set/Get the fixed image.  Setting a different image clears the cache. */
+  /** @ITKStartGrouping */
+  void
+  SetFixedImage(const FixedImageType * image);
+  const FixedImageType *
+  GetFixedImage() const;
+  /** @ITKEndGrouping */
+
+  /** Get the fixed image smoothed with a recursive Gaussian of the given
+   * sigma.  When \c sigmaInPhysicalUnits is false, the sigma is in voxels.
+   * A non-positive sigma returns the fixed image itself. */
+  FixedImageConstPointer
+  GetFixedSmoothImage(RealType sigma, bool sigmaInPhysicalUnits) const;
+
+  /** Get the virtual domain image derived from the fixed image and
+   * shrunk by the given factors. */
+  VirtualImageConstPointer
+  GetVirtualDomainImage(const ShrinkFactorsPerDimensionContainerType & shrinkFactors) const;
+
+  /** Discard all cached images. */
+  void
+  ClearCache();
+
+  /** Get the number of cached smoothed fixed images and virtual domain images. */
+  /** @ITKStartGrouping */
+  SizeValueType
+  GetNumberOfCachedFixedSmoothImages() const;
+  SizeValueType
+  GetNumberOfCachedVirtualDomainImages() const;
+  /** @ITKEndGrouping */
+
+protected:
+  ImageRegistrationFixedImageContext() = default;
+  ~ImageRegistrationFixedImageContext() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** An entry of a cache, computed once, outside of the mutex. */
+  template <typename TKey, typename TImageConstPointer>
+  struct CacheEntry
+  {
+    TKey               m_Key{};
+    std::once_flag     m_Computed{};
+    TImageConstPointer m_Image{};
+  };
+
+  using SmoothingKeyType = std::pair<RealType, bool>;
+  using FixedSmoothImageEntryType = CacheEntry<SmoothingKeyType, FixedImageConstPointer>;
+  using VirtualDomainImageEntryType = CacheEntry<ShrinkFactorsPerDimensionContainerType, VirtualImageConstPointer>;
+  using FixedSmoothImageCacheType = std::vector<std::shared_ptr<FixedSmoothImageEntryType>>;
+  using VirtualDomainImageCacheType = std::vector<std::shared_ptr<VirtualDomainImageEntryType>>;
+
+  /** Get the entry of the given key, inserted if there is none yet.  The caller must hold the mutex. */
+  template <typename TEntry, typename TKey>
+  static std::shared_ptr<TEntry>
+  FindOrInsertEntry(std::vector<std::shared_ptr<TEntry>> & cache, const TKey & key);
+
+  FixedImageConstPointer m_FixedImage{};
+
+  mutable std::mutex                  m_Mutex{};
+  mutable FixedSmoothImageCacheType   m_FixedSmoothImages{};
+  mutable VirtualDomainImageCacheType m_VirtualDomainImages{};
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkImageRegistrationFixedImageContext.hxx"
+#endif
+
+#endif
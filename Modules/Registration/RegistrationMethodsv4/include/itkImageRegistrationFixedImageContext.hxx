@@ -0,0 +1,201 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageRegistrationFixedImageContext_hxx
+#define itkImageRegistrationFixedImageContext_hxx
+
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
+
+namespace itk
+{
+
+template <typename TFixedImage, typename TVirtualImage>
+void
+ImageRegistrationFixedImageContext<TFixedImage, TVirtualImage>::SetFixedImage(const FixedImageType * image)
+{
+  itkDebugMacro("setting FixedImage to " << image);
+  const std::lock_guard<std::mutex> lock(this->m_Mutex);
+  if (this->m_FixedImage != image)
+  {
+    this->m_FixedImage = image;
+    this->m_FixedSmoothImages.clear();
+    this->m_VirtualDomainImages.clear();
+    this->Modified();
+  }
+}
+
+template <typename TFixedImage, typename TVirtualImage>
+auto
+ImageRegistrationFixedImageContext<TFixedImage, TVirtualImage>::GetFixedImage() const -> const FixedImageType *
+{
+  const std::lock_guard<std::mutex> lock(this->m_Mutex);
+  return this->m_FixedImage.GetPointer();
+}
+
+template <typename TFixedImage, typename TVirtualImage>
+template <typename TEntry, typename TKey>
+std::shared_ptr<TEntry>
+ImageRegistrationFixedImageContext<TFixedImage, TVirtualImage>::FindOrInsertEntry(
+  std::vector<std::shared_ptr<TEntry>> & cache,
+  const TKey &                           key)
+{
+  for (const auto & entry : cache)
+  {
+    if (entry->m_Key == key)
+    {
+      return entry;
+    }
+  }
+  auto entry = std::make_shared<TEntry>();
+  entry->m_Key = key;
+  cache.push_back(entry);
+  return entry;
+}
+
+template <typename TFixedImage, typename TVirtualImage>
+auto
+ImageRegistrationFixedImageContext<TFixedImage, TVirtualImage>::GetFixedSmoothImage(RealType sigma,
+                                                                                     bool sigmaInPhysicalUnits) const
+  -> FixedImageConstPointer
+{
+  FixedImageConstPointer                     fixedImage;
+  std::shared_ptr<FixedSmoothImageEntryType> entry;
+  {
+    const std::lock_guard<std::mutex> lock(this->m_Mutex);
+    fixedImage = this->m_FixedImage;
+    if (fixedImage.IsNull())
+    {
+      itkExceptionStringMacro("The fixed image is not set.");
+    }
+    if (sigma <= 0)
+    {
+      return fixedImage;
+    }
+    entry = FindOrInsertEntry(this->m_FixedSmoothImages, SmoothingKeyType(sigma, sigmaInPhysicalUnits));
+  }
+
+  // Computed by the first request only, while requests for other entries proceed.  An entry removed from the cache
+  // in the meantime is still completed for the requests that hold it.
+  std::call_once(entry->m_Computed, [&fixedImage, &entry, sigma, sigmaInPhysicalUnits]() {
+    using SmoothingFilterType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
+    auto                                         smoothingFilter = SmoothingFilterType::New();
+    typename SmoothingFilterType::SigmaArrayType sigmaArray(sigma);
+    if (!sigmaInPhysicalUnits)
+    {
+      const auto & spacing = fixedImage->GetSpacing();
+      for (unsigned int i = 0; i < sigmaArray.Size(); ++i)
+      {
+        sigmaArray[i] *= spacing[i];
+      }
+    }
+    smoothingFilter->SetSigmaArray(sigmaArray);
+    smoothingFilter->SetInput(fixedImage);
+    smoothingFilter->Update();
+
+    typename FixedImageType::Pointer smoothImage = smoothingFilter->GetOutput();
+    smoothImage->DisconnectPipeline();
+    entry->m_Image = smoothImage.GetPointer();
+  });
+  return entry->m_Image;
+}
+
+template <typename TFixedImage, typename TVirtualImage>
+auto
+ImageRegistrationFixedImageContext<TFixedImage, TVirtualImage>::GetVirtualDomainImage(
+  const ShrinkFactorsPerDimensionContainerType & shrinkFactors) const -> VirtualImageConstPointer
+{
+  FixedImageConstPointer                       fixedImage;
+  std::shared_ptr<VirtualDomainImageEntryType> entry;
+  {
+    const std::lock_guard<std::mutex> lock(this->m_Mutex);
+    fixedImage = this->m_FixedImage;
+    if (fixedImage.IsNull())
+    {
+      itkExceptionStringMacro("The fixed image is not set.");
+    }
+    entry = FindOrInsertEntry(this->m_VirtualDomainImages, shrinkFactors);
+  }
+
+  std::call_once(entry->m_Computed, [&fixedImage, &entry, &shrinkFactors]() {
+    // The full resolution virtual domain is only a carrier of the geometry and
+    // is released once the requested level has been derived from it.
+    auto virtualDomainImage = VirtualImageType::New();
+    virtualDomainImage->CopyInformation(fixedImage);
+    virtualDomainImage->SetRegions(fixedImage->GetLargestPossibleRegion());
+    virtualDomainImage->Allocate();
+
+    using VirtualShrinkFilterType = ShrinkImageFilter<VirtualImageType, VirtualImageType>;
+    auto shrinkFilter = VirtualShrinkFilterType::New();
+    shrinkFilter->SetShrinkFactors(shrinkFactors);
+    shrinkFilter->SetInput(virtualDomainImage);
+    shrinkFilter->Update();
+
+    typename VirtualImageType::Pointer currentLevelVirtualDomainImage = shrinkFilter->GetOutput();
+    currentLevelVirtualDomainImage->DisconnectPipeline();
+    entry->m_Image = currentLevelVirtualDomainImage.GetPointer();
+  });
+  return entry->m_Image;
+}
+
+template <typename TFixedImage, typename TVirtualImage>
+void
+ImageRegistrationFixedImageContext<TFixedImage, TVirtualImage>::ClearCache()
+{
+  const std::lock_guard<std::mutex> lock(this->m_Mutex);
+  this->m_FixedSmoothImages.clear();
+  this->m_VirtualDomainImages.clear();
+}
+
+template <typename TFixedImage, typename TVirtualImage>
+SizeValueType
+ImageRegistrationFixedImageContext<TFixedImage, TVirtualImage>::GetNumberOfCachedFixedSmoothImages() const
+{
+  const std::lock_guard<std::mutex> lock(this->m_Mutex);
+  return static_cast<SizeValueType>(this->m_FixedSmoothImages.size());
+}
+
+template <typename TFixedImage, typename TVirtualImage>
+SizeValueType
+ImageRegistrationFixedImageContext<TFixedImage, TVirtualImage>::GetNumberOfCachedVirtualDomainImages() const
+{
+  const std::lock_guard<std::mutex> lock(this->m_Mutex);
+  return static_cast<SizeValueType>(this->m_VirtualDomainImages.size());
+}
+
+template <typename TFixedImage, typename TVirtualImage>
+void
+ImageRegistrationFixedImageContext<TFixedImage, TVirtualImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  const FixedImageType * fixedImage = this->GetFixedImage();
+  os << indent << "FixedImage: ";
+  if (fixedImage == nullptr)
+  {
+    os << "(null)" << std::endl;
+  }
+  else
+  {
+    os << std::endl;
+    fixedImage->Print(os, indent.GetNextIndent());
+  }
+  os << indent << "NumberOfCachedFixedSmoothImages: " << this->GetNumberOfCachedFixedSmoothImages() << std::endl;
+  os << indent << "NumberOfCachedVirtualDomainImages: " << this->GetNumberOfCachedVirtualDomainImages() << std::endl;
+}
+
+} // end namespace itk
+#endif
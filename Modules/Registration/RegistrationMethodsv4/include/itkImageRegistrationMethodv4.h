@@ -29,6 +29,7 @@
 #include "itkPointSetToPointSetMetricWithIndexv4.h"
 #include "itkShrinkImageFilter.h"
 #include "itkIdentityTransform.h"
+#include "itkImageRegistrationFixedImageContext.h"
 #include "itkTransformParametersAdaptorBase.h"
 #include "ITKRegistrationMethodsv4Export.h"
 
@@ -196,6 +197,9 @@ public:
 
   using ShrinkFactorsArrayType = Array<SizeValueType>;
 
+  using FixedImageContextType = ImageRegistrationFixedImageContext<FixedImageType, VirtualImageType>;
+  using FixedImageContextPointer = typename FixedImageContextType::Pointer;
+
   using SmoothingSigmasArrayType = Array<RealType>;
   using MetricSamplingPercentageArrayType = Array<RealType>;
 
@@ -317,6 +321,20 @@ public:
   itkGetModifiableObjectMacro(Metric, MetricType);
   /** @ITKEndGrouping */
 
+  /**
+   * Set/Get the fixed image context.  When set, the smoothed fixed images and
+   * the shrunken virtual domain images of each level are taken from (and
+   * cached in) the context instead of being recomputed by this method.  A
+   * single context may be shared by many registration methods that register
+   * different moving images to the same fixed image, including methods that
+   * run concurrently.  The context is only used for the image metrics whose
+   * fixed image is the fixed image of the context.
+   */
+  /** @ITKStartGrouping */
+  itkSetObjectMacro(FixedImageContext, FixedImageContextType);
+  itkGetModifiableObjectMacro(FixedImageContext, FixedImageContextType);
+  /** @ITKEndGrouping */
+
   /** Set/Get the metric sampling strategy. */
   /** @ITKStartGrouping */
   itkSetEnumMacro(MetricSamplingStrategy, MetricSamplingStrategyEnum);
@@ -576,6 +594,7 @@ protected:
   FixedImageMasksContainerType  m_FixedImageMasks{};
   MovingImageMasksContainerType m_MovingImageMasks{};
   VirtualImagePointer           m_VirtualDomainImage{};
+  FixedImageContextPointer      m_FixedImageContext{};
   PointSetsContainerType        m_FixedPointSets{};
   PointSetsContainerType        m_MovingPointSets{};
   SizeValueType                 m_NumberOfFixedObjects{};
@@ -611,6 +630,8 @@ protected:
 private:
   bool m_InPlace{};
 
+  bool m_UseFixedImageContextVirtualDomain{};
+
   bool m_InitializeCenterOfLinearOutputTransform{};
 
   // helper function to create the right kind of concrete transform
@@ -391,10 +391,25 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
       {
         virtualDomainBaseImage = this->GetFixedImage(this->m_FirstImageMetricIndex);
       }
-      this->m_VirtualDomainImage = VirtualImageType::New();
-      this->m_VirtualDomainImage->CopyInformation(virtualDomainBaseImage);
-      this->m_VirtualDomainImage->SetRegions(virtualDomainBaseImage->GetLargestPossibleRegion());
-      this->m_VirtualDomainImage->Allocate();
+
+      // The virtual domain images of each level are taken from the fixed image
+      // context when the virtual domain is the fixed image of the context.
+      this->m_UseFixedImageContextVirtualDomain =
+        this->m_FixedImageContext.IsNotNull() && virtualDomainBaseImage.IsNotNull() &&
+        virtualDomainBaseImage.GetPointer() ==
+          static_cast<const VirtualImageBaseType *>(this->m_FixedImageContext->GetFixedImage());
+
+      if (this->m_UseFixedImageContextVirtualDomain)
+      {
+        this->m_VirtualDomainImage = nullptr;
+      }
+      else
+      {
+        this->m_VirtualDomainImage = VirtualImageType::New();
+        this->m_VirtualDomainImage->CopyInformation(virtualDomainBaseImage);
+        this->m_VirtualDomainImage->SetRegions(virtualDomainBaseImage->GetLargestPossibleRegion());
+        this->m_VirtualDomainImage->Allocate();
+      }
     }
 
     this->m_FixedImageMasks.clear();
@@ -441,15 +456,20 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   //   1. subsample the reference domain (typically the fixed image) and/or
   //   2. smooth the fixed and moving images.
 
-  typename VirtualImageType::Pointer currentLevelVirtualDomainImage = nullptr;
-  if (this->m_VirtualDomainImage.IsNotNull())
+  typename VirtualImageType::ConstPointer currentLevelVirtualDomainImage = nullptr;
+  if (this->m_UseFixedImageContextVirtualDomain)
+  {
+    currentLevelVirtualDomainImage =
+      this->m_FixedImageContext->GetVirtualDomainImage(this->m_ShrinkFactorsPerLevel[level]);
+  }
+  else if (this->m_VirtualDomainImage.IsNotNull())
   {
     auto shrinkFilter = ShrinkFilterType::New();
     shrinkFilter->SetShrinkFactors(this->m_ShrinkFactorsPerLevel[level]);
     shrinkFilter->SetInput(this->m_VirtualDomainImage);
 
+    shrinkFilter->Update();
     currentLevelVirtualDomainImage = shrinkFilter->GetOutput();
-    currentLevelVirtualDomainImage->Update();
   }
   else
   {
@@ -588,27 +608,39 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
          multiMetric->GetMetricQueue()[n]->GetMetricCategory() ==
            ObjectToObjectMetricBaseTemplateEnums::MetricCategory::IMAGE_METRIC))
     {
-      if (this->m_SmoothingSigmasPerLevel[level] > 0)
+      const bool useFixedImageContext =
+        this->m_FixedImageContext.IsNotNull() && this->m_FixedImageContext->GetFixedImage() == this->GetFixedImage(n);
+
+      if (useFixedImageContext)
       {
-        using FixedImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
-        auto fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
-        typename FixedImageSmoothingFilterType::SigmaArrayType fixedImageSigmaArray(
-          this->m_SmoothingSigmasPerLevel[level]);
+        this->m_FixedSmoothImages[n] = this->m_FixedImageContext->GetFixedSmoothImage(
+          this->m_SmoothingSigmasPerLevel[level], this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits);
+      }
 
-        if (!this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits)
+      if (this->m_SmoothingSigmasPerLevel[level] > 0)
+      {
+        if (!useFixedImageContext)
         {
-          auto & fixedSpacing = this->GetFixedImage(n)->GetSpacing();
-          for (unsigned int i = 0; i < fixedImageSigmaArray.Size(); ++i)
+          using FixedImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
+          auto fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
+          typename FixedImageSmoothingFilterType::SigmaArrayType fixedImageSigmaArray(
+            this->m_SmoothingSigmasPerLevel[level]);
+
+          if (!this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits)
           {
-            fixedImageSigmaArray[i] *= fixedSpacing[i];
+            auto & fixedSpacing = this->GetFixedImage(n)->GetSpacing();
+            for (unsigned int i = 0; i < fixedImageSigmaArray.Size(); ++i)
+            {
+              fixedImageSigmaArray[i] *= fixedSpacing[i];
+            }
           }
-        }
-        fixedImageSmoothingFilter->SetSigmaArray(fixedImageSigmaArray);
-        fixedImageSmoothingFilter->SetInput(this->GetFixedImage(n));
+          fixedImageSmoothingFilter->SetSigmaArray(fixedImageSigmaArray);
+          fixedImageSmoothingFilter->SetInput(this->GetFixedImage(n));
 
-        this->m_FixedSmoothImages[n] = fixedImageSmoothingFilter->GetOutput();
-        fixedImageSmoothingFilter->Update();
-        fixedImageSmoothingFilter->GetOutput()->DisconnectPipeline();
+          this->m_FixedSmoothImages[n] = fixedImageSmoothingFilter->GetOutput();
+          fixedImageSmoothingFilter->Update();
+          fixedImageSmoothingFilter->GetOutput()->DisconnectPipeline();
+        }
 
         using MovingImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<MovingImageType, MovingImageType>;
         auto movingImageSmoothingFilter = MovingImageSmoothingFilterType::New();
@@ -633,7 +665,10 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
       else
       {
         this->m_MovingSmoothImages[n] = this->GetMovingImage(n);
-        this->m_FixedSmoothImages[n] = this->GetFixedImage(n);
+        if (!useFixedImageContext)
+        {
+          this->m_FixedSmoothImages[n] = this->GetFixedImage(n);
+        }
       }
 
       // Update the image metric
@@ -1128,6 +1163,8 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   os << indent << "MovingImageMasks: " << m_MovingImageMasks << std::endl;
 
   itkPrintSelfObjectMacro(VirtualDomainImage);
+  itkPrintSelfObjectMacro(FixedImageContext);
+  itkPrintSelfBooleanMacro(UseFixedImageContextVirtualDomain);
 
   os << indent << "FixedPointSets: " << m_FixedPointSets << std::endl;
   os << indent << "MovingPointSets: " << m_MovingPointSets << std::endl;
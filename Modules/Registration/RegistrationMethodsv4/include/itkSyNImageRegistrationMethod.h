@@ -22,6 +22,11 @@
 
 #include "itkImageMaskSpatialObject.h"
 #include "itkDisplacementFieldTransform.h"
+#include "itkInvertDisplacementFieldImageFilter.h"
+#include "itkMemoryUsageObserver.h"
+#include "itkRealTimeClock.h"
+
+#include <array>
 
 namespace itk
 {
@@ -46,6 +51,18 @@ namespace itk
  * The method evolved since that time with crucial contributions from Gang Song and
  * Nick Tustison. Though similar in spirit, this implementation is not identical.
  *
+ * After the metric gradients of both half transforms have been computed,
+ * the fixed-to-middle and moving-to-middle transforms are updated
+ * independently of each other: the update field is composed with the total
+ * field, the result is smoothed and its inverse is estimated.  By default
+ * these two half-transform updates run concurrently (see
+ * SetConcurrentHalfTransformUpdates()), as two work units of the
+ * multi-threader of the method.  The composition is done in a single
+ * multithreaded pass, and the composition, the smoothing and the inversion
+ * write into fields that are reused across the iterations of a level.  The
+ * wall-clock time of the last iteration and the maximum of the resident
+ * memory sampled once per iteration are available for profiling.
+ *
  * \todo Need to allow the fixed image to have a composite transform.
  *
  * \author Nick Tustison
@@ -134,6 +151,9 @@ public:
 
   using NumberOfIterationsArrayType = Array<SizeValueType>;
 
+  using TimeStampType = RealTimeClock::TimeStampType;
+  using MemoryLoadType = MemoryUsageObserver::MemoryLoadType;
+
   /** Set/Get the learning rate. */
   /** @ITKStartGrouping */
   itkSetMacro(LearningRate, RealType);
@@ -193,6 +213,25 @@ public:
   itkSetObjectMacro(FixedToMiddleTransform, OutputTransformType);
   itkSetObjectMacro(MovingToMiddleTransform, OutputTransformType);
   /** @ITKEndGrouping */
+  /** Set/Get whether the fixed-to-middle and moving-to-middle transforms are updated concurrently
+   *  once the metric gradients have been computed.  The results do not depend on this setting.
+   *  Default true.
+   */
+  /** @ITKStartGrouping */
+  itkSetMacro(ConcurrentHalfTransformUpdates, bool);
+  itkGetConstMacro(ConcurrentHalfTransformUpdates, bool);
+  itkBooleanMacro(ConcurrentHalfTransformUpdates);
+  /** @ITKEndGrouping */
+  /** Get the wall-clock time, in seconds, of the last completed iteration. */
+  itkGetConstMacro(LastIterationElapsedTime, TimeStampType);
+
+  /** Get the maximum, over the iterations of the last registration, of the resident memory
+   *  in kB sampled once per iteration, after the half transforms have been updated.  The
+   *  update fields of the iteration are still alive then, but the transient allocations
+   *  within the iteration, e.g. of the metric, are not seen.
+   */
+  itkGetConstMacro(MaximumIterationMemoryUsage, MemoryLoadType);
+
 protected:
   SyNImageRegistrationMethod();
   ~SyNImageRegistrationMethod() override = default;
@@ -239,10 +278,70 @@ protected:
 
   virtual DisplacementFieldPointer
   ScaleUpdateField(const DisplacementFieldType *);
+  /** Smooth the update field into a newly allocated field, with GaussianSmoothDisplacementFieldInto(). */
   virtual DisplacementFieldPointer
   GaussianSmoothDisplacementField(const DisplacementFieldType *, const RealType);
+
+  /** Smooth \c field into \c smoothField, which must be allocated over the region of
+   *  \c field.  The passes along the dimensions alternate between \c smoothField and
+   *  \c workField, allocated likewise, so that no field is allocated.  Both the update
+   *  field and the total field of a half transform are smoothed with this method, on the
+   *  given multi-threader.
+   */
+  virtual void
+  GaussianSmoothDisplacementFieldInto(const DisplacementFieldType * field,
+                                      const RealType                variance,
+                                      DisplacementFieldType *       smoothField,
+                                      DisplacementFieldType *       workField,
+                                      MultiThreaderBase *           multiThreader);
+
+#ifndef ITK_FUTURE_LEGACY_REMOVE
+  /** \deprecated The half transforms are inverted in place by UpdateHalfTransform(), which
+   *  does not call this method, so an override of it has no effect. */
+  ITK_FUTURE_DEPRECATED("The half transforms are inverted in place by UpdateHalfTransform().")
   virtual DisplacementFieldPointer
   InvertDisplacementField(const DisplacementFieldType *, const DisplacementFieldType * = nullptr);
+#endif
+
+  /** Compose the update field with the total field of a half transform, i.e.
+   *  output(x) = totalField(x) + updateField(x + totalField(x)), in a single
+   *  multithreaded pass on the given multi-threader.  The output must be allocated over the
+   *  region of the total field.
+   */
+  virtual void
+  ComposeUpdateField(const DisplacementFieldType * updateField,
+                     const DisplacementFieldType * totalField,
+                     DisplacementFieldType *       output,
+                     MultiThreaderBase *           multiThreader);
+
+  /** The fields a half transform is updated with, kept from one iteration to the next.  The
+   *  transform holds one of the two total fields and the inverse field once it has been
+   *  updated: the other total field receives the next one, and the inverse is updated in
+   *  place.  As the two half transforms may be updated concurrently, as two work units of
+   *  the multi-threader of the method, each of them has a multi-threader of its own, of the
+   *  same class, for the work it parallelizes.
+   */
+  struct HalfTransformFields
+  {
+    using InverterType = InvertDisplacementFieldImageFilter<DisplacementFieldType>;
+
+    DisplacementFieldPointer                m_ComposedField{};
+    DisplacementFieldPointer                m_WorkField{};
+    std::array<DisplacementFieldPointer, 2> m_TotalFields{};
+    DisplacementFieldPointer                m_InverseField{};
+    typename InverterType::Pointer          m_Inverter{};
+    MultiThreaderBase::Pointer              m_MultiThreader{};
+  };
+
+  /** Compose the update field with the total field of the given half transform, smooth the
+   *  result with GaussianSmoothDisplacementFieldInto() and estimate its inverse in place.  The
+   *  fields are reallocated only if their geometry does not match the total field; an inverse
+   *  field that the transform was given from elsewhere is copied into them first.
+   */
+  virtual void
+  UpdateHalfTransform(const DisplacementFieldType * updateField,
+                      OutputTransformType *         transform,
+                      HalfTransformFields &         fields);
 
   RealType m_LearningRate{ 0.25 };
 
@@ -259,6 +358,14 @@ protected:
 private:
   RealType m_GaussianSmoothingVarianceForTheUpdateField{ 3.0 };
   RealType m_GaussianSmoothingVarianceForTheTotalField{ 0.5 };
+
+  bool m_ConcurrentHalfTransformUpdates{ true };
+
+  HalfTransformFields m_FixedToMiddleFields{};
+  HalfTransformFields m_MovingToMiddleFields{};
+
+  TimeStampType  m_LastIterationElapsedTime{ 0.0 };
+  MemoryLoadType m_MaximumIterationMemoryUsage{ 0 };
 };
 } // end namespace itk
 
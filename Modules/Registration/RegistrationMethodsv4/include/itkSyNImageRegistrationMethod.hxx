@@ -21,15 +21,21 @@
 
 #include "itkComposeDisplacementFieldsImageFilter.h"
 #include "itkGaussianOperator.h"
+#include "itkImageAlgorithm.h"
 #include "itkImageMaskSpatialObject.h"
 #include "itkImportImageFilter.h"
 #include "itkInvertDisplacementFieldImageFilter.h"
 #include "itkIterationReporter.h"
 #include "itkMultiplyImageFilter.h"
+#include "itkVectorLinearInterpolateImageFunction.h"
 #include "itkVectorNeighborhoodOperatorImageFilter.h"
 #include "itkWindowConvergenceMonitoringFunction.h"
 #include "itkPrintHelper.h"
 
+#include <cstring>
+#include <exception>
+#include <mutex>
+
 namespace itk
 {
 
@@ -149,8 +155,13 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
 
   IterationReporter reporter(this, 0, 1);
 
+  auto                clock = RealTimeClock::New();
+  MemoryUsageObserver memoryObserver;
+
   while (this->m_CurrentIteration++ < this->m_NumberOfIterationsPerLevel[this->m_CurrentLevel] && !this->m_IsConverged)
   {
+    const TimeStampType iterationStartTime = clock->GetTimeInSeconds();
+
     auto fixedComposite = CompositeTransformType::New();
     if (fixedInitialTransform != nullptr)
     {
@@ -194,54 +205,80 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
 
     if (this->m_AverageMidPointGradients)
     {
-      for (ImageRegionIteratorWithIndex ItF(fixedToMiddleSmoothUpdateField,
-                                            fixedToMiddleSmoothUpdateField->GetLargestPossibleRegion());
-           !ItF.IsAtEnd();
-           ++ItF)
-      {
-        ItF.Set(ItF.Get() - movingToMiddleSmoothUpdateField->GetPixel(ItF.GetIndex()));
-        movingToMiddleSmoothUpdateField->SetPixel(ItF.GetIndex(), -ItF.Get());
-      }
+      this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+      this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+        fixedToMiddleSmoothUpdateField->GetLargestPossibleRegion(),
+        [&fixedToMiddleSmoothUpdateField,
+         &movingToMiddleSmoothUpdateField](const typename DisplacementFieldType::RegionType & region) {
+          ImageRegionIterator ItM(movingToMiddleSmoothUpdateField.GetPointer(), region);
+          for (ImageRegionIterator ItF(fixedToMiddleSmoothUpdateField.GetPointer(), region); !ItF.IsAtEnd();
+               ++ItF, ++ItM)
+          {
+            ItF.Set(ItF.Get() - ItM.Get());
+            ItM.Set(-ItF.Get());
+          }
+        },
+        nullptr);
     }
 
-    // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth
-
-    using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
-
-    auto fixedComposer = ComposerType::New();
-    fixedComposer->SetDisplacementField(fixedToMiddleSmoothUpdateField);
-    fixedComposer->SetWarpingField(this->m_FixedToMiddleTransform->GetDisplacementField());
-    fixedComposer->Update();
+    // Add the update field to both displacement fields (from fixed/moving to middle image), smooth
+    // and invert.  The two half transforms are independent of each other from here on.
 
-    const DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
-      fixedComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField);
-
-    auto movingComposer = ComposerType::New();
-    movingComposer->SetDisplacementField(movingToMiddleSmoothUpdateField);
-    movingComposer->SetWarpingField(this->m_MovingToMiddleTransform->GetDisplacementField());
-    movingComposer->Update();
-
-    const DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
-      movingComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField);
-
-    // Iteratively estimate the inverse fields.
-
-    const DisplacementFieldPointer fixedToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField(
-      fixedToMiddleSmoothTotalFieldTmp, this->m_FixedToMiddleTransform->GetInverseDisplacementField());
-    const DisplacementFieldPointer fixedToMiddleSmoothTotalField =
-      this->InvertDisplacementField(fixedToMiddleSmoothTotalFieldInverse, fixedToMiddleSmoothTotalFieldTmp);
-
-    const DisplacementFieldPointer movingToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField(
-      movingToMiddleSmoothTotalFieldTmp, this->m_MovingToMiddleTransform->GetInverseDisplacementField());
-    const DisplacementFieldPointer movingToMiddleSmoothTotalField =
-      this->InvertDisplacementField(movingToMiddleSmoothTotalFieldInverse, movingToMiddleSmoothTotalFieldTmp);
+    // Each half transform parallelizes its own work on a multi-threader of its own, as the
+    // multi-threader of the method runs the two updates.
+    for (HalfTransformFields * fields : { &this->m_FixedToMiddleFields, &this->m_MovingToMiddleFields })
+    {
+      if (fields->m_MultiThreader.IsNull() ||
+          std::strcmp(fields->m_MultiThreader->GetNameOfClass(), this->GetMultiThreader()->GetNameOfClass()) != 0)
+      {
+        const LightObject::Pointer multiThreader = this->GetMultiThreader()->CreateAnother();
+        fields->m_MultiThreader = dynamic_cast<MultiThreaderBase *>(multiThreader.GetPointer());
+      }
+      fields->m_MultiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    }
 
-    // Assign the displacement fields and their inverses to the proper transforms.
-    this->m_FixedToMiddleTransform->SetDisplacementField(fixedToMiddleSmoothTotalField);
-    this->m_FixedToMiddleTransform->SetInverseDisplacementField(fixedToMiddleSmoothTotalFieldInverse);
+    std::array<std::exception_ptr, 2> exceptions{};
+    const auto                        updateHalfTransform =
+      [this, &fixedToMiddleSmoothUpdateField, &movingToMiddleSmoothUpdateField, &exceptions](SizeValueType half) {
+        try
+        {
+          if (half == 0)
+          {
+            this->UpdateHalfTransform(
+              fixedToMiddleSmoothUpdateField, this->m_FixedToMiddleTransform, this->m_FixedToMiddleFields);
+          }
+          else
+          {
+            this->UpdateHalfTransform(
+              movingToMiddleSmoothUpdateField, this->m_MovingToMiddleTransform, this->m_MovingToMiddleFields);
+          }
+        }
+        catch (...)
+        {
+          exceptions[half] = std::current_exception();
+        }
+      };
+    if (this->m_ConcurrentHalfTransformUpdates)
+    {
+      MultiThreaderBase * multiThreader = this->GetMultiThreader();
+      multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+      multiThreader->ParallelizeArray(0, 2, updateHalfTransform, nullptr);
+    }
+    else
+    {
+      updateHalfTransform(0);
+      updateHalfTransform(1);
+    }
+    for (const std::exception_ptr & exception : exceptions)
+    {
+      if (exception)
+      {
+        std::rethrow_exception(exception);
+      }
+    }
 
-    this->m_MovingToMiddleTransform->SetDisplacementField(movingToMiddleSmoothTotalField);
-    this->m_MovingToMiddleTransform->SetInverseDisplacementField(movingToMiddleSmoothTotalFieldInverse);
+    this->m_MaximumIterationMemoryUsage =
+      std::max(this->m_MaximumIterationMemoryUsage, memoryObserver.GetMemoryUsage());
 
     this->m_CurrentMetricValue = 0.5 * (movingMetricValue + fixedMetricValue);
 
@@ -252,6 +289,7 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
     {
       this->m_IsConverged = true;
     }
+    this->m_LastIterationElapsedTime = clock->GetTimeInSeconds() - iterationStartTime;
     reporter.CompletedStep();
   }
 }
@@ -621,16 +659,22 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   gradientField->SetRegions(virtualDomainImage->GetRequestedRegion());
   gradientField->Allocate();
 
-  SizeValueType count = 0;
-  for (ImageRegionIterator ItG(gradientField, gradientField->GetRequestedRegion()); !ItG.IsAtEnd(); ++ItG)
-  {
-    DisplacementVectorType displacement;
-    for (SizeValueType d = 0; d < ImageDimension; ++d)
-    {
-      displacement[d] = metricDerivative[count++];
-    }
-    ItG.Set(displacement);
-  }
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    gradientField->GetBufferedRegion(),
+    [&gradientField, &metricDerivative](const typename DisplacementFieldType::RegionType & region) {
+      for (ImageRegionIteratorWithIndex ItG(gradientField.GetPointer(), region); !ItG.IsAtEnd(); ++ItG)
+      {
+        SizeValueType          count = gradientField->ComputeOffset(ItG.GetIndex()) * ImageDimension;
+        DisplacementVectorType displacement;
+        for (SizeValueType d = 0; d < ImageDimension; ++d)
+        {
+          displacement[d] = metricDerivative[count++];
+        }
+        ItG.Set(displacement);
+      }
+    },
+    nullptr);
 
   return gradientField;
 }
@@ -647,23 +691,29 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
 {
   typename DisplacementFieldType::SpacingType spacing = updateField->GetSpacing();
 
-  RealType maxNorm = NumericTraits<RealType>::NonpositiveMin();
-  for (ImageRegionConstIterator ItF(updateField, updateField->GetLargestPossibleRegion()); !ItF.IsAtEnd(); ++ItF)
-  {
-    DisplacementVectorType vector = ItF.Get();
+  RealType   maxNorm = NumericTraits<RealType>::NonpositiveMin();
+  std::mutex maxNormMutex;
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    updateField->GetLargestPossibleRegion(),
+    [updateField, &spacing, &maxNorm, &maxNormMutex](const typename DisplacementFieldType::RegionType & region) {
+      RealType localMaxNorm = NumericTraits<RealType>::NonpositiveMin();
+      for (ImageRegionConstIterator ItF(updateField, region); !ItF.IsAtEnd(); ++ItF)
+      {
+        const DisplacementVectorType vector = ItF.Get();
 
-    RealType localNorm = 0;
-    for (SizeValueType d = 0; d < ImageDimension; ++d)
-    {
-      localNorm += itk::Math::sqr(vector[d] / spacing[d]);
-    }
-    localNorm = std::sqrt(localNorm);
+        RealType localNorm = 0;
+        for (SizeValueType d = 0; d < ImageDimension; ++d)
+        {
+          localNorm += itk::Math::sqr(vector[d] / spacing[d]);
+        }
+        localMaxNorm = std::max(localMaxNorm, std::sqrt(localNorm));
+      }
 
-    if (localNorm > maxNorm)
-    {
-      maxNorm = localNorm;
-    }
-  }
+      const std::lock_guard<std::mutex> lock(maxNormMutex);
+      maxNorm = std::max(maxNorm, localMaxNorm);
+    },
+    nullptr);
 
   RealType scale = this->m_LearningRate;
   if (maxNorm > RealType{})
@@ -685,6 +735,127 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   return scaledUpdateField;
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::ComposeUpdateField(
+  const DisplacementFieldType * updateField,
+  const DisplacementFieldType * totalField,
+  DisplacementFieldType *       output,
+  MultiThreaderBase *           multiThreader)
+{
+  using InterpolatorType = VectorLinearInterpolateImageFunction<DisplacementFieldType, RealType>;
+  auto interpolator = InterpolatorType::New();
+  interpolator->SetInputImage(updateField);
+
+  multiThreader->template ParallelizeImageRegion<ImageDimension>(
+    totalField->GetBufferedRegion(),
+    [totalField, output, &interpolator](const typename DisplacementFieldType::RegionType & region) {
+      using PointType = typename DisplacementFieldType::PointType;
+
+      ImageRegionIterator ItO(output, region);
+      for (ImageRegionConstIteratorWithIndex ItT(totalField, region); !ItT.IsAtEnd(); ++ItT, ++ItO)
+      {
+        PointType point;
+        totalField->TransformIndexToPhysicalPoint(ItT.GetIndex(), point);
+
+        DisplacementVectorType displacement = ItT.Get();
+        point += displacement;
+        if (interpolator->IsInsideBuffer(point))
+        {
+          const typename InterpolatorType::OutputType update = interpolator->Evaluate(point);
+          for (unsigned int d = 0; d < ImageDimension; ++d)
+          {
+            displacement[d] += update[d];
+          }
+        }
+        ItO.Set(displacement);
+      }
+    },
+    nullptr);
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::UpdateHalfTransform(
+  const DisplacementFieldType * updateField,
+  OutputTransformType *         transform,
+  HalfTransformFields &         fields)
+{
+  const DisplacementFieldType *                   totalField = transform->GetDisplacementField();
+  const typename DisplacementFieldType::RegionType region = totalField->GetBufferedRegion();
+
+  const auto allocate = [totalField, &region](DisplacementFieldPointer & field) {
+    if (field.IsNull() || field->GetBufferedRegion() != region || field->GetOrigin() != totalField->GetOrigin() ||
+        field->GetSpacing() != totalField->GetSpacing() || field->GetDirection() != totalField->GetDirection())
+    {
+      field = DisplacementFieldType::New();
+      field->CopyInformation(totalField);
+      field->SetRegions(region);
+      field->Allocate();
+    }
+  };
+
+  allocate(fields.m_ComposedField);
+  this->ComposeUpdateField(updateField, totalField, fields.m_ComposedField, fields.m_MultiThreader);
+
+  // The smoothed total field goes into the total field that the transform does not hold
+  DisplacementFieldPointer & smoothTotalField =
+    totalField == fields.m_TotalFields[0] ? fields.m_TotalFields[1] : fields.m_TotalFields[0];
+  allocate(smoothTotalField);
+  allocate(fields.m_WorkField);
+  this->GaussianSmoothDisplacementFieldInto(fields.m_ComposedField,
+                                            this->m_GaussianSmoothingVarianceForTheTotalField,
+                                            smoothTotalField,
+                                            fields.m_WorkField,
+                                            fields.m_MultiThreader);
+
+  // Iteratively estimate the inverse field, in place, starting from the inverse of the previous
+  // iteration, then the total field, in place, starting from the smoothed total field.
+  const DisplacementFieldType * inverseField = transform->GetInverseDisplacementField();
+  if (inverseField == nullptr)
+  {
+    allocate(fields.m_InverseField);
+    fields.m_InverseField->FillBuffer(DisplacementVectorType{});
+  }
+  else if (inverseField != fields.m_InverseField)
+  {
+    allocate(fields.m_InverseField);
+    ImageAlgorithm::Copy(inverseField, fields.m_InverseField.GetPointer(), region, region);
+  }
+  if (fields.m_Inverter.IsNull())
+  {
+    fields.m_Inverter = HalfTransformFields::InverterType::New();
+    fields.m_Inverter->SetMaximumNumberOfIterations(20);
+    fields.m_Inverter->SetMeanErrorToleranceThreshold(0.001);
+    fields.m_Inverter->SetMaxErrorToleranceThreshold(0.1);
+    fields.m_Inverter->InPlaceOn();
+  }
+  fields.m_Inverter->SetMultiThreader(fields.m_MultiThreader);
+  fields.m_Inverter->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  for (const auto & [field, inverse] : { std::make_pair(smoothTotalField, fields.m_InverseField),
+                                         std::make_pair(fields.m_InverseField, smoothTotalField) })
+  {
+    fields.m_Inverter->SetInput(field);
+    fields.m_Inverter->SetInverseFieldInitialEstimate(inverse);
+    // The fields were modified in place, which does not change their modification time
+    fields.m_Inverter->Modified();
+    fields.m_Inverter->Update();
+  }
+
+  // Assign the displacement field and its inverse to the transform.
+  transform->SetDisplacementField(smoothTotalField);
+  transform->SetInverseDisplacementField(fields.m_InverseField);
+}
+
+#ifndef ITK_FUTURE_LEGACY_REMOVE
 template <typename TFixedImage,
           typename TMovingImage,
           typename TOutputTransform,
@@ -709,6 +880,7 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
 
   return inverseField;
 }
+#endif
 
 template <typename TFixedImage,
           typename TMovingImage,
@@ -720,16 +892,47 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
     GaussianSmoothDisplacementField(const DisplacementFieldType * field, const RealType variance)
 {
-  using DuplicatorType = ImageDuplicator<DisplacementFieldType>;
-  auto duplicator = DuplicatorType::New();
-  duplicator->SetInputImage(field);
-  duplicator->Update();
+  if (variance <= 0.0)
+  {
+    using DuplicatorType = ImageDuplicator<DisplacementFieldType>;
+    auto duplicator = DuplicatorType::New();
+    duplicator->SetInputImage(field);
+    duplicator->Update();
+
+    return duplicator->GetOutput();
+  }
 
-  DisplacementFieldPointer smoothField = duplicator->GetOutput();
+  const auto allocate = [field]() {
+    auto smoothField = DisplacementFieldType::New();
+    smoothField->CopyInformation(field);
+    smoothField->SetRegions(field->GetLargestPossibleRegion());
+    smoothField->Allocate();
+    return smoothField;
+  };
+  DisplacementFieldPointer smoothField = allocate();
+  this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  this->GaussianSmoothDisplacementFieldInto(field, variance, smoothField, allocate(), this->GetMultiThreader());
+
+  return smoothField;
+}
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TOutputTransform,
+          typename TVirtualImage,
+          typename TPointSet>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
+  GaussianSmoothDisplacementFieldInto(const DisplacementFieldType * field,
+                                      const RealType                variance,
+                                      DisplacementFieldType *       smoothField,
+                                      DisplacementFieldType *       workField,
+                                      MultiThreaderBase *           multiThreader)
+{
   if (variance <= 0.0)
   {
-    return smoothField;
+    ImageAlgorithm::Copy(field, smoothField, field->GetLargestPossibleRegion(), smoothField->GetBufferedRegion());
+    return;
   }
 
   using GaussianSmoothingOperatorType = GaussianOperator<RealType, ImageDimension>;
@@ -738,19 +941,27 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   using GaussianSmoothingSmootherType =
     VectorNeighborhoodOperatorImageFilter<DisplacementFieldType, DisplacementFieldType>;
   auto smoother = GaussianSmoothingSmootherType::New();
+  smoother->SetMultiThreader(multiThreader);
+  smoother->SetNumberOfWorkUnits(multiThreader->GetNumberOfWorkUnits());
 
+  // The first pass reads the input field directly, and the passes alternate between the two
+  // fields so that the last one writes into the smoothed field.
+  const DisplacementFieldType * passInput = field;
   for (SizeValueType d = 0; d < ImageDimension; ++d)
   {
     // smooth along this dimension
     gaussianSmoothingOperator.SetDirection(d);
     gaussianSmoothingOperator.SetVariance(variance);
     gaussianSmoothingOperator.SetMaximumError(0.001);
-    gaussianSmoothingOperator.SetMaximumKernelWidth(smoothField->GetRequestedRegion().GetSize()[d]);
+    gaussianSmoothingOperator.SetMaximumKernelWidth(field->GetRequestedRegion().GetSize()[d]);
     gaussianSmoothingOperator.CreateDirectional();
 
     // todo: make sure we only smooth within the buffered region
+    DisplacementFieldType * passOutput = (ImageDimension - d) % 2 == 1 ? smoothField : workField;
     smoother->SetOperator(gaussianSmoothingOperator);
-    smoother->SetInput(smoothField);
+    smoother->SetInput(passInput);
+    smoother->GraftOutput(passOutput);
+    smoother->Modified();
     try
     {
       smoother->Update();
@@ -761,10 +972,7 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
       msg += exc.what();
       itkExceptionMacro(<< msg);
     }
-
-    smoothField = smoother->GetOutput();
-    smoothField->Update();
-    smoothField->DisconnectPipeline();
+    passInput = passOutput;
   }
 
   constexpr DisplacementVectorType zeroVector{};
@@ -781,30 +989,34 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   const typename DisplacementFieldType::SizeType   size = region.GetSize();
   const typename DisplacementFieldType::IndexType  startIndex = region.GetIndex();
 
-  ImageRegionIteratorWithIndex ItS(smoothField, smoothField->GetLargestPossibleRegion());
-  for (ImageRegionConstIteratorWithIndex ItF(field, field->GetLargestPossibleRegion()); !ItF.IsAtEnd(); ++ItF, ++ItS)
-  {
-    typename DisplacementFieldType::IndexType index = ItF.GetIndex();
-    bool                                      isOnBoundary = false;
-    for (unsigned int d = 0; d < ImageDimension; ++d)
-    {
-      if (index[d] == startIndex[d] || index[d] == static_cast<IndexValueType>(size[d]) - startIndex[d] - 1)
+  multiThreader->template ParallelizeImageRegion<ImageDimension>(
+    field->GetLargestPossibleRegion(),
+    [field, smoothField, &size, &startIndex, weight1, weight2, &zeroVector](
+      const typename DisplacementFieldType::RegionType & subregion) {
+      ImageRegionIterator ItS(smoothField, subregion);
+      for (ImageRegionConstIteratorWithIndex ItF(field, subregion); !ItF.IsAtEnd(); ++ItF, ++ItS)
       {
-        isOnBoundary = true;
-        break;
+        typename DisplacementFieldType::IndexType index = ItF.GetIndex();
+        bool                                      isOnBoundary = false;
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+        {
+          if (index[d] == startIndex[d] || index[d] == static_cast<IndexValueType>(size[d]) - startIndex[d] - 1)
+          {
+            isOnBoundary = true;
+            break;
+          }
+        }
+        if (isOnBoundary)
+        {
+          ItS.Set(zeroVector);
+        }
+        else
+        {
+          ItS.Set(ItS.Get() * weight1 + ItF.Get() * weight2);
+        }
       }
-    }
-    if (isOnBoundary)
-    {
-      ItS.Set(zeroVector);
-    }
-    else
-    {
-      ItS.Set(ItS.Get() * weight1 + ItF.Get() * weight2);
-    }
-  }
-
-  return smoothField;
+    },
+    nullptr);
 }
 
 template <typename TFixedImage,
@@ -817,6 +1029,8 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
 {
   this->AllocateOutputs();
 
+  this->m_MaximumIterationMemoryUsage = 0;
+
   for (this->m_CurrentLevel = 0; this->m_CurrentLevel < this->m_NumberOfLevels; this->m_CurrentLevel++)
   {
     this->InitializeRegistrationAtEachLevel(this->m_CurrentLevel);
@@ -876,6 +1090,20 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
     os, indent, "GaussianSmoothingVarianceForTheUpdateField", this->m_GaussianSmoothingVarianceForTheUpdateField);
   print_helper::PrintNumericTrait(
     os, indent, "GaussianSmoothingVarianceForTheTotalField", this->m_GaussianSmoothingVarianceForTheTotalField);
+  itkPrintSelfBooleanMacro(ConcurrentHalfTransformUpdates);
+  for (const auto & [name, fields] : { std::make_pair("FixedToMiddle", &this->m_FixedToMiddleFields),
+                                       std::make_pair("MovingToMiddle", &this->m_MovingToMiddleFields) })
+  {
+    os << indent << name << "ComposedField: " << fields->m_ComposedField.GetPointer() << std::endl;
+    os << indent << name << "WorkField: " << fields->m_WorkField.GetPointer() << std::endl;
+    os << indent << name << "TotalFields: " << fields->m_TotalFields[0].GetPointer() << ' '
+       << fields->m_TotalFields[1].GetPointer() << std::endl;
+    os << indent << name << "InverseField: " << fields->m_InverseField.GetPointer() << std::endl;
+    os << indent << name << "Inverter: " << fields->m_Inverter.GetPointer() << std::endl;
+    os << indent << name << "MultiThreader: " << fields->m_MultiThreader.GetPointer() << std::endl;
+  }
+  os << indent << "LastIterationElapsedTime: " << this->m_LastIterationElapsedTime << std::endl;
+  os << indent << "MaximumIterationMemoryUsage: " << this->m_MaximumIterationMemoryUsage << std::endl;
 }
 
 } // end namespace itk
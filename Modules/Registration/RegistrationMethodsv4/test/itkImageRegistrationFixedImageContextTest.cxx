@@ -0,0 +1,192 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegistrationFixedImageContext.h"
+#include "itkImageRegistrationMethodv4.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkGaussianImageSource.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkTranslationTransform.h"
+#include "itkTestingMacros.h"
+
+#include <thread>
+
+/*
+ * Register several moving images to one fixed image, with and without a
+ * shared fixed image context, and check that the context produces the same
+ * transforms while computing the fixed-side images only once.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using PixelType = double;
+using ImageType = itk::Image<PixelType, Dimension>;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+using RegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+using ContextType = RegistrationType::FixedImageContextType;
+
+// A Gaussian blob of standard deviation 10 and height 100 on a 64 x 64 image
+ImageType::Pointer
+MakeBlobImage(const double centerX, const double centerY)
+{
+  using BlobSourceType = itk::GaussianImageSource<ImageType>;
+  auto                            source = BlobSourceType::New();
+  const BlobSourceType::ArrayType mean{ { centerX, centerY } };
+  source->SetSize(ImageType::SizeType::Filled(64));
+  source->SetMean(mean);
+  source->SetSigma(BlobSourceType::ArrayType::Filled(10.0));
+  source->SetScale(100.0);
+  source->NormalizedOff();
+  source->Update();
+  return source->GetOutput();
+}
+
+RegistrationType::Pointer
+MakeRegistration(const ImageType * fixedImage, const ImageType * movingImage, ContextType * context)
+{
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  auto metric = MetricType::New();
+  metric->SetMaximumNumberOfWorkUnits(1);
+
+  using ScalesEstimatorType = itk::RegistrationParameterScalesFromPhysicalShift<MetricType>;
+  auto scalesEstimator = ScalesEstimatorType::New();
+  scalesEstimator->SetMetric(metric);
+  scalesEstimator->SetTransformForward(true);
+
+  using OptimizerType = itk::GradientDescentOptimizerv4;
+  auto optimizer = OptimizerType::New();
+  optimizer->SetLearningRate(1.0);
+  optimizer->SetNumberOfIterations(50);
+  optimizer->SetScalesEstimator(scalesEstimator);
+  optimizer->SetDoEstimateLearningRateOnce(false);
+  optimizer->SetDoEstimateLearningRateAtEachIteration(true);
+  optimizer->SetMaximumStepSizeInPhysicalUnits(0.25);
+
+  auto registration = RegistrationType::New();
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(metric);
+  registration->SetOptimizer(optimizer);
+  registration->SetFixedImageContext(context);
+
+  registration->SetNumberOfLevels(2);
+  RegistrationType::ShrinkFactorsArrayType shrinkFactors(2);
+  shrinkFactors[0] = 2;
+  shrinkFactors[1] = 1;
+  registration->SetShrinkFactorsPerLevel(shrinkFactors);
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmas(2);
+  smoothingSigmas[0] = 1.0;
+  smoothingSigmas[1] = 0.0;
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmas);
+  return registration;
+}
+} // namespace
+
+int
+itkImageRegistrationFixedImageContextTest(int, char *[])
+{
+  auto context = ContextType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(context, ImageRegistrationFixedImageContext, Object);
+
+  // The context needs a fixed image
+  ITK_TRY_EXPECT_EXCEPTION(context->GetFixedSmoothImage(1.0, true));
+
+  const ImageType::Pointer fixedImage = MakeBlobImage(32.0, 32.0);
+  context->SetFixedImage(fixedImage);
+  ITK_TEST_SET_GET_VALUE(fixedImage.GetPointer(), context->GetFixedImage());
+
+  // A zero sigma returns the fixed image itself and is not cached
+  ITK_TEST_EXPECT_EQUAL(context->GetFixedSmoothImage(0.0, true).GetPointer(), fixedImage.GetPointer());
+  ITK_TEST_EXPECT_EQUAL(context->GetNumberOfCachedFixedSmoothImages(), 0);
+
+  constexpr unsigned int                 numberOfMovingImages = 3;
+  std::vector<ImageType::Pointer>        movingImages;
+  std::vector<RegistrationType::Pointer> referenceRegistrations;
+  std::vector<RegistrationType::Pointer> contextRegistrations;
+  for (unsigned int i = 0; i < numberOfMovingImages; ++i)
+  {
+    movingImages.push_back(MakeBlobImage(32.0 + 1.5 * (i + 1), 32.0 - 1.0 * i));
+    referenceRegistrations.push_back(MakeRegistration(fixedImage, movingImages.back(), nullptr));
+    contextRegistrations.push_back(MakeRegistration(fixedImage, movingImages.back(), context));
+  }
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(contextRegistrations[0], ImageRegistrationMethodv4, ProcessObject);
+  ITK_TEST_SET_GET_VALUE(context.GetPointer(), contextRegistrations[0]->GetFixedImageContext());
+
+  for (const auto & registration : referenceRegistrations)
+  {
+    ITK_TRY_EXPECT_NO_EXCEPTION(registration->Update());
+  }
+
+  // Run the registrations sharing the context concurrently
+  std::vector<std::thread> threads;
+  std::vector<int>         succeeded(numberOfMovingImages, 0);
+  for (unsigned int i = 0; i < numberOfMovingImages; ++i)
+  {
+    threads.emplace_back([&contextRegistrations, &succeeded, i]() {
+      try
+      {
+        contextRegistrations[i]->Update();
+        succeeded[i] = 1;
+      }
+      catch (const itk::ExceptionObject & exception)
+      {
+        std::cerr << exception << std::endl;
+      }
+    });
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+
+  for (unsigned int i = 0; i < numberOfMovingImages; ++i)
+  {
+    ITK_TEST_EXPECT_EQUAL(succeeded[i], 1);
+
+    const TransformType::ParametersType referenceParameters =
+      referenceRegistrations[i]->GetTransform()->GetParameters();
+    const TransformType::ParametersType contextParameters = contextRegistrations[i]->GetTransform()->GetParameters();
+    std::cout << "Moving image " << i << ": reference " << referenceParameters << ", with context "
+              << contextParameters << std::endl;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      if (!itk::Math::FloatAlmostEqual(referenceParameters[d], contextParameters[d], 4, 1e-6))
+      {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << "Registration with the fixed image context differs from the reference." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // One smoothed fixed image (sigma 1) and two virtual domains (shrink 2 and 1)
+  // are shared by all the registrations.
+  ITK_TEST_EXPECT_EQUAL(context->GetNumberOfCachedFixedSmoothImages(), 1);
+  ITK_TEST_EXPECT_EQUAL(context->GetNumberOfCachedVirtualDomainImages(), 2);
+
+  // Changing the fixed image invalidates the cache
+  context->SetFixedImage(MakeBlobImage(30.0, 30.0));
+  ITK_TEST_EXPECT_EQUAL(context->GetNumberOfCachedFixedSmoothImages(), 0);
+  ITK_TEST_EXPECT_EQUAL(context->GetNumberOfCachedVirtualDomainImages(), 0);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,253 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSyNImageRegistrationMethod.h"
+#include "itkComposeDisplacementFieldsImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkResampleImageFilter.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Run SyN with the half-transform updates done concurrently and sequentially,
+ * and check that both produce the same transform, that the fused composition
+ * matches ComposeDisplacementFieldsImageFilter and that the registration
+ * improves the match between the images.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using PixelType = double;
+using ImageType = itk::Image<PixelType, Dimension>;
+
+template <typename TFixedImage, typename TMovingImage>
+class SyNImageRegistrationMethodTestHelper : public itk::SyNImageRegistrationMethod<TFixedImage, TMovingImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SyNImageRegistrationMethodTestHelper);
+
+  using Self = SyNImageRegistrationMethodTestHelper;
+  using Superclass = itk::SyNImageRegistrationMethod<TFixedImage, TMovingImage>;
+  using Pointer = itk::SmartPointer<Self>;
+  using typename Superclass::DisplacementFieldType;
+
+  itkNewMacro(Self);
+  itkOverrideGetNameOfClassMacro(SyNImageRegistrationMethodTestHelper);
+
+  void
+  ComposeUpdateField(const DisplacementFieldType * updateField,
+                     const DisplacementFieldType * totalField,
+                     DisplacementFieldType *       output,
+                     itk::MultiThreaderBase *      multiThreader) override
+  {
+    Superclass::ComposeUpdateField(updateField, totalField, output, multiThreader);
+  }
+
+protected:
+  SyNImageRegistrationMethodTestHelper() = default;
+  ~SyNImageRegistrationMethodTestHelper() override = default;
+};
+
+using RegistrationType = SyNImageRegistrationMethodTestHelper<ImageType, ImageType>;
+using DisplacementFieldType = RegistrationType::DisplacementFieldType;
+
+ImageType::Pointer
+MakeEllipseImage(const double radiusX, const double radiusY)
+{
+  auto                        image = ImageType::New();
+  const ImageType::RegionType region(itk::MakeSize(48, 48));
+  image->SetRegions(region);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> It(image, region);
+  for (It.GoToBegin(); !It.IsAtEnd(); ++It)
+  {
+    const ImageType::IndexType index = It.GetIndex();
+    const double               dx = (index[0] - 24.0) / radiusX;
+    const double               dy = (index[1] - 24.0) / radiusY;
+    It.Set(100.0 * std::exp(-(dx * dx + dy * dy)));
+  }
+  return image;
+}
+
+DisplacementFieldType::Pointer
+MakeSmoothField(const ImageType * image, const double amplitude, const double phase)
+{
+  auto field = DisplacementFieldType::New();
+  field->CopyInformation(image);
+  field->SetRegions(image->GetLargestPossibleRegion());
+  field->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<DisplacementFieldType> It(field, field->GetLargestPossibleRegion());
+  for (It.GoToBegin(); !It.IsAtEnd(); ++It)
+  {
+    const DisplacementFieldType::IndexType index = It.GetIndex();
+    DisplacementFieldType::PixelType       displacement;
+    displacement[0] = amplitude * std::sin(0.2 * index[1] + phase);
+    displacement[1] = amplitude * std::cos(0.15 * index[0] - phase);
+    It.Set(displacement);
+  }
+  return field;
+}
+
+RegistrationType::Pointer
+MakeRegistration(const ImageType * fixedImage, const ImageType * movingImage, bool concurrent)
+{
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  auto metric = MetricType::New();
+
+  auto registration = RegistrationType::New();
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(metric);
+  registration->SetNumberOfLevels(1);
+
+  RegistrationType::ShrinkFactorsArrayType shrinkFactors(1);
+  shrinkFactors[0] = 1;
+  registration->SetShrinkFactorsPerLevel(shrinkFactors);
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmas(1);
+  smoothingSigmas[0] = 0.0;
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmas);
+
+  RegistrationType::NumberOfIterationsArrayType numberOfIterations(1);
+  numberOfIterations[0] = 15;
+  registration->SetNumberOfIterationsPerLevel(numberOfIterations);
+  registration->SetLearningRate(0.5);
+  registration->SetAverageMidPointGradients(true);
+  registration->SetConcurrentHalfTransformUpdates(concurrent);
+  return registration;
+}
+
+double
+MeanSquaredDifference(const ImageType *        fixedImage,
+                      const ImageType *        movingImage,
+                      const RegistrationType * registration)
+{
+  using ResamplerType = itk::ResampleImageFilter<ImageType, ImageType>;
+  auto resampler = ResamplerType::New();
+  resampler->SetInput(movingImage);
+  if (registration != nullptr)
+  {
+    resampler->SetTransform(registration->GetTransform());
+  }
+  resampler->SetReferenceImage(fixedImage);
+  resampler->UseReferenceImageOn();
+  resampler->Update();
+
+  double                                   sum = 0.0;
+  itk::ImageRegionConstIterator<ImageType> ItR(resampler->GetOutput(), fixedImage->GetLargestPossibleRegion());
+  for (itk::ImageRegionConstIterator<ImageType> ItF(fixedImage, fixedImage->GetLargestPossibleRegion()); !ItF.IsAtEnd();
+       ++ItF, ++ItR)
+  {
+    sum += itk::Math::sqr(ItF.Get() - ItR.Get());
+  }
+  return sum / fixedImage->GetLargestPossibleRegion().GetNumberOfPixels();
+}
+
+bool
+FieldsAreEqual(const DisplacementFieldType * field1, const DisplacementFieldType * field2, const double tolerance)
+{
+  itk::ImageRegionConstIterator<DisplacementFieldType> It2(field2, field2->GetLargestPossibleRegion());
+  for (itk::ImageRegionConstIterator<DisplacementFieldType> It1(field1, field1->GetLargestPossibleRegion());
+       !It1.IsAtEnd();
+       ++It1, ++It2)
+  {
+    if ((It1.Get() - It2.Get()).GetNorm() > tolerance)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkSyNImageRegistrationConcurrentUpdateTest(int, char *[])
+{
+  const ImageType::Pointer fixedImage = MakeEllipseImage(8.0, 6.0);
+  const ImageType::Pointer movingImage = MakeEllipseImage(6.0, 8.0);
+
+  const RegistrationType::Pointer concurrentRegistration = MakeRegistration(fixedImage, movingImage, true);
+  const RegistrationType::Pointer sequentialRegistration = MakeRegistration(fixedImage, movingImage, false);
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(
+    concurrentRegistration, SyNImageRegistrationMethodTestHelper, SyNImageRegistrationMethod);
+
+  ITK_TEST_SET_GET_BOOLEAN(concurrentRegistration, ConcurrentHalfTransformUpdates, true);
+  ITK_TEST_EXPECT_EQUAL(concurrentRegistration->GetLastIterationElapsedTime(), 0.0);
+  ITK_TEST_EXPECT_EQUAL(concurrentRegistration->GetMaximumIterationMemoryUsage(), 0);
+
+  // The fused composition matches the composition filter
+  const DisplacementFieldType::Pointer updateField = MakeSmoothField(fixedImage, 1.5, 0.3);
+  const DisplacementFieldType::Pointer totalField = MakeSmoothField(fixedImage, 2.5, 1.1);
+
+  auto composedField = DisplacementFieldType::New();
+  composedField->CopyInformation(totalField);
+  composedField->SetRegions(totalField->GetBufferedRegion());
+  composedField->Allocate();
+  concurrentRegistration->ComposeUpdateField(
+    updateField, totalField, composedField, concurrentRegistration->GetMultiThreader());
+
+  using ComposerType = itk::ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
+  auto composer = ComposerType::New();
+  composer->SetDisplacementField(updateField);
+  composer->SetWarpingField(totalField);
+  composer->Update();
+
+  if (!FieldsAreEqual(composedField, composer->GetOutput(), 1e-10))
+  {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "The fused composition differs from ComposeDisplacementFieldsImageFilter." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  ITK_TRY_EXPECT_NO_EXCEPTION(concurrentRegistration->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(sequentialRegistration->Update());
+
+  // The order in which the half transforms are updated does not change the result
+  const auto * concurrentTransform = concurrentRegistration->GetTransform();
+  const auto * sequentialTransform = sequentialRegistration->GetTransform();
+  if (!FieldsAreEqual(concurrentTransform->GetDisplacementField(), sequentialTransform->GetDisplacementField(), 0.0) ||
+      !FieldsAreEqual(
+        concurrentTransform->GetInverseDisplacementField(), sequentialTransform->GetInverseDisplacementField(), 0.0))
+  {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "Concurrent and sequential half-transform updates produce different transforms." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  ITK_TEST_EXPECT_TRUE(concurrentRegistration->GetLastIterationElapsedTime() > 0.0);
+  ITK_TEST_EXPECT_TRUE(concurrentRegistration->GetMaximumIterationMemoryUsage() > 0);
+  std::cout << "Last iteration took " << concurrentRegistration->GetLastIterationElapsedTime()
+            << " s, maximum iteration memory usage " << concurrentRegistration->GetMaximumIterationMemoryUsage()
+            << " kB" << std::endl;
+
+  const double initialDifference = MeanSquaredDifference(fixedImage, movingImage, nullptr);
+  const double finalDifference = MeanSquaredDifference(fixedImage, movingImage, concurrentRegistration);
+  std::cout << "Mean squared difference: initial " << initialDifference << ", final " << finalDifference
+            << std::endl;
+  if (finalDifference > 0.5 * initialDifference)
+  {
+    std::cerr << "Test failed!" << std::endl;
+    std::cerr << "The registration did not reduce the mean squared difference enough." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -199,7 +199,8 @@ ConnectedComponentImageFilter<TInputImage, TOutputImage, TMaskImage>::DynamicThr
         ++inLineIt;
       }
     }
-    this->m_LineMap[lineId] = thisLine;
+    // equivalent to assignment because thisLine goes of out scope afterwards
+    this->m_LineMap[lineId].swap(thisLine);
     ++lineId;
   }
 
@@ -23,8 +23,10 @@ using itk::print_helper::operator<<;
 #include "itkGTest.h"
 #include "itkImage.h"
 #include "itkConnectedComponentImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
 
 #include <bitset>
+#include <queue>
 
 namespace
 {
@@ -50,6 +52,94 @@ CreateTestImageA()
 
   return image;
 }
+
+
+// A mask of blobs and thin, winding structures, which connect across many
+// lines and work units.
+itk::Image<unsigned char, 3>::Pointer
+CreateTestImageB()
+{
+  using ImageType = itk::Image<unsigned char, 3>;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType(itk::MakeSize(61u, 47u, 39u)));
+  image->Allocate();
+
+  unsigned int state = 12345;
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    state = state * 1103515245u + 12345u;
+    const auto & index = it.GetIndex();
+    const bool   spiral = (index[0] + 2 * index[2]) % 11 == 0 || (index[1] + index[2]) % 13 == 0;
+    it.Set(spiral || ((state >> 16) % 100) < 35 ? 1 : 0);
+  }
+  return image;
+}
+
+
+// Label the components of the non-zero pixels with a flood fill, numbering
+// them in the order of their first pixel and stepping over the background.
+template <typename TImage, typename TLabelImage>
+typename TLabelImage::Pointer
+LabelByFloodFill(const TImage * image, bool fullyConnected, typename TLabelImage::PixelType background)
+{
+  using IndexType = typename TImage::IndexType;
+  using LabelType = typename TLabelImage::PixelType;
+
+  const auto region = image->GetLargestPossibleRegion();
+  auto       labels = TLabelImage::New();
+  labels->SetRegions(region);
+  labels->Allocate();
+  labels->FillBuffer(background);
+
+  auto visited = itk::Image<bool, TImage::ImageDimension>::New();
+  visited->SetRegions(region);
+  visited->AllocateInitialized();
+
+  LabelType nextLabel = 0;
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() == 0 || visited->GetPixel(it.GetIndex()))
+    {
+      continue;
+    }
+    if (nextLabel == background)
+    {
+      ++nextLabel;
+    }
+    std::queue<IndexType> front;
+    front.push(it.GetIndex());
+    visited->SetPixel(it.GetIndex(), true);
+    while (!front.empty())
+    {
+      const IndexType index = front.front();
+      front.pop();
+      labels->SetPixel(index, nextLabel);
+      IndexType neighbor;
+      for (unsigned int n = 0; n < 27; ++n)
+      {
+        unsigned int remainder = n;
+        unsigned int distance = 0;
+        for (unsigned int d = 0; d < TImage::ImageDimension; ++d)
+        {
+          const int step = static_cast<int>(remainder % 3) - 1;
+          remainder /= 3;
+          neighbor[d] = index[d] + step;
+          distance += step != 0;
+        }
+        if (distance == 0 || (!fullyConnected && distance > 1) || !region.IsInside(neighbor) ||
+            image->GetPixel(neighbor) == 0 || visited->GetPixel(neighbor))
+        {
+          continue;
+        }
+        visited->SetPixel(neighbor, true);
+        front.push(neighbor);
+      }
+    }
+    ++nextLabel;
+  }
+  return labels;
+}
 } // namespace
 
 
@@ -84,3 +174,40 @@ TEST(ConnectedComponentImageFilter, Checkerboard3D)
   ++it;
   EXPECT_TRUE(it.IsAtEnd());
 }
+
+
+TEST(ConnectedComponentImageFilter, SameLabelsForAnyNumberOfWorkUnits)
+{
+  auto image = CreateTestImageB();
+  using ImageType = decltype(image)::ObjectType;
+  using LabelImageType = itk::Image<unsigned short, 3>;
+
+  for (const bool fullyConnected : { false, true })
+  {
+    for (const unsigned short background : { 0, 5 })
+    {
+      const auto expected = LabelByFloodFill<ImageType, LabelImageType>(image, fullyConnected, background);
+
+      for (const itk::ThreadIdType numberOfWorkUnits : { 1, 2, 3, 8, 64 })
+      {
+        auto connected = itk::ConnectedComponentImageFilter<ImageType, LabelImageType>::New();
+        connected->SetInput(image);
+        connected->SetFullyConnected(fullyConnected);
+        connected->SetBackgroundValue(background);
+        connected->SetNumberOfWorkUnits(numberOfWorkUnits);
+        connected->Update();
+
+        itk::SizeValueType numberOfDifferences = 0;
+        for (itk::ImageRegionConstIteratorWithIndex<LabelImageType> it(connected->GetOutput(),
+                                                                       image->GetLargestPossibleRegion());
+             !it.IsAtEnd();
+             ++it)
+        {
+          numberOfDifferences += it.Get() != expected->GetPixel(it.GetIndex());
+        }
+        EXPECT_EQ(numberOfDifferences, 0u) << "FullyConnected: " << fullyConnected << ", BackgroundValue: "
+                                           << background << ", NumberOfWorkUnits: " << numberOfWorkUnits;
+      }
+    }
+  }
+}
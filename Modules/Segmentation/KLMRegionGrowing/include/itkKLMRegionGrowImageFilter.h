@@ -24,7 +24,10 @@
 #include "itkImageRegionIterator.h"
 #include "itkConceptChecking.h"
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <numeric>
+#include <vector>
 
 namespace itk
 {
@@ -78,6 +81,19 @@ namespace itk
  * default value, m_MaximumLambda is set to 1000 and m_MaximumNumberOfRegions
  * is set to 2.
  *
+ * By default the regions are merged one pair at a time, the pair with the
+ * least lambda first. When ParallelMerging is on, they are merged in rounds
+ * instead: each region picks its border of least lambda, ties going to the
+ * border that comes first, and the borders picked by both of their regions
+ * are removed together, as long as their lambda is among the least ones.
+ * These borders share no region, so their merges are independent and the
+ * work units of the multi-threader perform them concurrently, as they do
+ * the update of the borders and of their lambdas between rounds. The
+ * regions and the borders are then held in flat arrays, which suits large
+ * 2D and 3D images better than the region and border objects of the
+ * sequential merging. The segmentation found may differ slightly from the
+ * sequential one, but it does not depend on the number of work units.
+ *
  * Currently implementation puts equal weight to the multichannel values.
  * In future improvements we plan to allow the user to control the weights
  * associated with each individual channels.
@@ -271,6 +287,13 @@ public:
   itkSetMacro(NumberOfRegions, unsigned int);
   itkGetConstReferenceMacro(NumberOfRegions, unsigned int);
   /** @ITKEndGrouping */
+  /** Set/Get whether the regions are merged in rounds of concurrent,
+   * independent merges rather than one pair at a time. Off by default. */
+  /** @ITKStartGrouping */
+  itkSetMacro(ParallelMerging, bool);
+  itkGetConstMacro(ParallelMerging, bool);
+  itkBooleanMacro(ParallelMerging);
+  /** @ITKEndGrouping */
   /** Generate labelled image. */
   LabelImagePointer
   GetLabelledImage();
@@ -335,6 +358,11 @@ protected:
   void
   ApplyKLM();
 
+  /** Function that merges the regions in rounds of concurrent merges,
+   * see ParallelMerging. */
+  void
+  ApplyParallelKLM();
+
   /** Initialize the RegionGrowImageFilter algorithm. */
   void
   InitializeKLM();
@@ -362,8 +390,34 @@ private:
   using KLMSegmentationRegionPtr = KLMSegmentationRegion::Pointer;
   using KLMSegmentationBorderPtr = KLMSegmentationBorder::Pointer;
 
+  /** A border of the flat adjacency of the parallel merging, between the
+   * regions at positions m_Region1 < m_Region2 of the region arrays. */
+  struct FlatBorder
+  {
+    RegionLabelType m_Region1;
+    RegionLabelType m_Region2;
+    double          m_Length;
+    double          m_Lambda;
+  };
+
+  /** Check the parameters and return the number of atomic regions along
+   * each dimension of the input image. */
+  InputImageSizeType
+  ComputeNumberOfRegionsAlongDimensions() const;
+
+  /** Index of the atomic region, or border, at the given position of a
+   * grid of the given size, the first dimension varying fastest. */
+  static InputImageIndexType
+  ComputeGridIndex(SizeValueType position, const InputImageSizeType & gridExtent);
+
+  /** Copy the resolved labels and means of the sequential merging to the
+   * arrays the outputs are generated from. */
+  void
+  StoreResolvedRegions();
+
   double       m_MaximumLambda{ 1000 };
   unsigned int m_NumberOfRegions{ 0 };
+  bool         m_ParallelMerging{ false };
 
   /** Local variables. */
 
@@ -378,6 +432,11 @@ private:
 
   MeanRegionIntensityType m_InitialRegionMean{};
   double                  m_InitialRegionArea{ 0 };
+
+  /** Final label of each atomic region, and mean of each label, the
+   * components of label l starting at (l - 1) * InputImageVectorDimension. */
+  std::vector<RegionLabelType> m_AtomicRegionLabels{};
+  std::vector<double>          m_RegionMeans{};
 }; // class KLMRegionGrowImageFilter
 } // namespace itk
 
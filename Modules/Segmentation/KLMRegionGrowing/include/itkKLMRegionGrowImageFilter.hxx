@@ -41,6 +41,7 @@ KLMRegionGrowImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os
   os << indent << "Current internal value of lambda parameter: " << m_InternalLambda << std::endl;
   os << indent << "Initial number of regions: " << m_InitialNumberOfRegions << std::endl;
   os << indent << "Current number of regions: " << m_NumberOfRegions << std::endl;
+  os << indent << "ParallelMerging: " << (m_ParallelMerging ? "On" : "Off") << std::endl;
 }
 
 template <typename TInputImage, typename TOutputImage>
@@ -86,72 +87,44 @@ template <typename TInputImage, typename TOutputImage>
 void
 KLMRegionGrowImageFilter<TInputImage, TOutputImage>::GenerateOutputImage()
 {
-  const InputImageConstPointer inputImage = this->GetInput();
-  InputImageSizeType           inputImageSize = inputImage->GetBufferedRegion().GetSize();
-
-  GridSizeType gridSize = this->GetGridSize();
-
-  InputImageSizeType numRegionsAlongDim;
-
-  for (unsigned int idim = 0; idim < InputImageDimension; ++idim)
-  {
-    numRegionsAlongDim[idim] = inputImageSize[idim] / gridSize[idim];
-  }
+  const InputImageSizeType numRegionsAlongDim = this->ComputeNumberOfRegionsAlongDimensions();
+  GridSizeType             gridSize = this->GetGridSize();
 
   // Walk through each atomic block and get the approximation image.
-  // This is needed as the region labels associated each atomic
-  // block (as it was for during the initialization stage), have changed.
-  // The new region label points to the region that has the up-to-date
-  // region intensity. After the updated region intensity is found,
-  // each pixel is updated with the mean approximation value.
+  // The labels of the atomic blocks have been resolved to the regions
+  // they were merged into, whose mean approximation value is given
+  // to each pixel of the block. The blocks are disjoint, so they are
+  // filled concurrently.
 
   const OutputImagePointer outputImage = this->GetOutput();
   using OutputRegionType = typename TOutputImage::RegionType;
-  OutputRegionType region;
-  region.SetSize(gridSize); // Constant grid size
-
-  OutputImageIndexType tmpIndex{};
-
-  for (unsigned int iregion = 0; iregion < m_InitialNumberOfRegions; ++iregion)
-  {
-    region.SetIndex(tmpIndex * gridSize);
-
-    // Convert the mean region value to the correct output format
-
-    MeanRegionIntensityType tmpMeanValue;
-    OutputImageVectorType   outMeanValue;
-    using OutputValueType = typename OutputImagePixelType::ValueType;
-
-    tmpMeanValue = m_RegionsPointer[iregion]->GetMeanRegionIntensity();
-
-    for (unsigned int ivecdim = 0; ivecdim < InputImageVectorDimension; ++ivecdim)
-    {
-      outMeanValue[ivecdim] = static_cast<OutputValueType>(tmpMeanValue[ivecdim]);
-    }
-
-    // Fill the region with the mean value
-
-    OutputImageIterator outputIt(outputImage, region);
-
-    while (!outputIt.IsAtEnd())
-    {
-      outputIt.Set(outMeanValue);
-      ++outputIt;
-    }
+  using OutputValueType = typename OutputImagePixelType::ValueType;
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  multiThreader->ParallelizeArray(
+    0,
+    m_InitialNumberOfRegions,
+    [this, &outputImage, &numRegionsAlongDim, &gridSize](SizeValueType iregion) {
+      const OutputRegionType region(ComputeGridIndex(iregion, numRegionsAlongDim) * gridSize, gridSize);
+
+      // Convert the mean region value to the correct output format
+      const double * meanValue =
+        &m_RegionMeans[(m_AtomicRegionLabels[iregion] - 1) * SizeValueType{ InputImageVectorDimension }];
+
+      OutputImageVectorType outMeanValue;
+      for (unsigned int ivecdim = 0; ivecdim < InputImageVectorDimension; ++ivecdim)
+      {
+        outMeanValue[ivecdim] = static_cast<OutputValueType>(meanValue[ivecdim]);
+      }
 
-    // Calculate next grid index
-    IndexValueType tmpVal = 1;
-    for (unsigned int idim = 0; idim < InputImageDimension; ++idim)
-    {
-      tmpIndex[idim]++;
-      tmpVal *= numRegionsAlongDim[idim];
-      if ((iregion + 1) % tmpVal != 0)
+      // Fill the region with the mean value
+      for (OutputImageIterator outputIt(outputImage, region); !outputIt.IsAtEnd(); ++outputIt)
       {
-        break;
+        outputIt.Set(outMeanValue);
       }
-      tmpIndex[idim] = 0;
-    }
-  }
+    },
+    nullptr);
 }
 
 template <typename TInputImage, typename TOutputImage>
@@ -178,56 +151,28 @@ auto
 KLMRegionGrowImageFilter<TInputImage, TOutputImage>::GenerateLabelledImage(LabelImageType * labelImagePtr)
   -> LabelImagePointer
 {
-  const InputImageConstPointer inputImage = this->GetInput();
-  InputImageSizeType           inputImageSize = inputImage->GetBufferedRegion().GetSize();
-
-  GridSizeType gridSize = this->GetGridSize();
-
-  InputImageSizeType numRegionsAlongDim;
-
-  for (unsigned int idim = 0; idim < InputImageDimension; ++idim)
-  {
-    numRegionsAlongDim[idim] = inputImageSize[idim] / gridSize[idim];
-  }
-
-  // Walk through each atomic block and get the new unique labels
-  // representing the final segmentation.
-  // This is needed as the region labels associated each atomic
-  // block (as it was during the initialization stage), have changed.
-
-  InputRegionType region;
-  region.SetSize(gridSize); // Constant grid size
-
-  InputImageIndexType tmpIndex{};
-
-  for (unsigned int iregion = 0; iregion < m_InitialNumberOfRegions; ++iregion)
-  {
-    region.SetIndex(tmpIndex * gridSize);
-
-    // Fill the region with the label
-
-    const RegionLabelType newRegionLabel = m_RegionsPointer[iregion]->GetRegionLabel();
-
-    LabelImageIterator labelIt(labelImagePtr, region);
-    while (!labelIt.IsAtEnd())
-    {
-      labelIt.Set(newRegionLabel);
-      ++labelIt;
-    }
-
-    // Calculate next grid index
-    IndexValueType tmpVal = 1;
-    for (unsigned int idim = 0; idim < InputImageDimension; ++idim)
-    {
-      tmpIndex[idim]++;
-      tmpVal *= numRegionsAlongDim[idim];
-      if ((iregion + 1) % tmpVal != 0)
+  const InputImageSizeType numRegionsAlongDim = this->ComputeNumberOfRegionsAlongDimensions();
+  GridSizeType             gridSize = this->GetGridSize();
+
+  // Walk through each atomic block and fill it with the unique label
+  // representing the final segmentation, as resolved for the block
+  // at the end of the merging. The blocks are filled concurrently.
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  multiThreader->ParallelizeArray(
+    0,
+    m_InitialNumberOfRegions,
+    [this, labelImagePtr, &numRegionsAlongDim, &gridSize](SizeValueType iregion) {
+      const InputRegionType region(ComputeGridIndex(iregion, numRegionsAlongDim) * gridSize, gridSize);
+      const RegionLabelType newRegionLabel = m_AtomicRegionLabels[iregion];
+
+      for (LabelImageIterator labelIt(labelImagePtr, region); !labelIt.IsAtEnd(); ++labelIt)
       {
-        break;
+        labelIt.Set(newRegionLabel);
       }
-      tmpIndex[idim] = 0;
-    }
-  }
+    },
+    nullptr);
 
   // Return the reference to the labelled image
   return labelImagePtr;
@@ -251,6 +196,12 @@ KLMRegionGrowImageFilter<TInputImage, TOutputImage>::ApplyKLM()
   // different regions is not bigger than the desired and the
   // current minimum scale parameter is not less than the desired scale.
 
+  if (m_ParallelMerging)
+  {
+    this->ApplyParallelKLM();
+    return;
+  }
+
   this->InitializeKLM();
 
   while ((m_NumberOfRegions > this->GetMaximumNumberOfRegions()) && (m_InternalLambda < m_MaximumLambda))
@@ -259,11 +210,13 @@ KLMRegionGrowImageFilter<TInputImage, TOutputImage>::ApplyKLM()
   }
 
   this->ResolveRegions();
+  this->StoreResolvedRegions();
 }
 
 template <typename TInputImage, typename TOutputImage>
-void
-KLMRegionGrowImageFilter<TInputImage, TOutputImage>::InitializeKLM()
+auto
+KLMRegionGrowImageFilter<TInputImage, TOutputImage>::ComputeNumberOfRegionsAlongDimensions() const
+  -> InputImageSizeType
 {
   // Maximum number of regions requested must be greater than 0
   if (this->GetMaximumNumberOfRegions() <= 1)
@@ -274,10 +227,8 @@ KLMRegionGrowImageFilter<TInputImage, TOutputImage>::InitializeKLM()
   // This implementation requires the image dimensions to be
   // multiples of the user specified grid sizes.
 
-  const InputImageConstPointer      inputImage = this->GetInput();
-  InputImageSizeType                inputImageSize = inputImage->GetBufferedRegion().GetSize();
-  GridSizeType                      gridSize = this->GetGridSize();
-  typename TInputImage::SpacingType spacing = inputImage->GetSpacing();
+  const InputImageSizeType inputImageSize = this->GetInput()->GetBufferedRegion().GetSize();
+  GridSizeType             gridSize = this->GetGridSize();
 
   for (unsigned int idim = 0; idim < InputImageDimension; ++idim)
   {
@@ -287,13 +238,65 @@ KLMRegionGrowImageFilter<TInputImage, TOutputImage>::InitializeKLM()
     }
   }
 
-  // Determine the regions first and initialize them
-
   InputImageSizeType numRegionsAlongDim;
   for (unsigned int idim = 0; idim < InputImageDimension; ++idim)
   {
     numRegionsAlongDim[idim] = inputImageSize[idim] / gridSize[idim];
   }
+  return numRegionsAlongDim;
+}
+
+template <typename TInputImage, typename TOutputImage>
+auto
+KLMRegionGrowImageFilter<TInputImage, TOutputImage>::ComputeGridIndex(SizeValueType              position,
+                                                                      const InputImageSizeType & gridExtent)
+  -> InputImageIndexType
+{
+  InputImageIndexType index;
+  for (unsigned int idim = 0; idim < InputImageDimension; ++idim)
+  {
+    index[idim] = static_cast<IndexValueType>(position % gridExtent[idim]);
+    position /= gridExtent[idim];
+  }
+  return index;
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+KLMRegionGrowImageFilter<TInputImage, TOutputImage>::StoreResolvedRegions()
+{
+  // After ResolveRegions() every atomic region holds its final label and
+  // the mean of the region it belongs to.
+  m_AtomicRegionLabels.resize(m_InitialNumberOfRegions);
+  RegionLabelType numberOfLabels = 0;
+  for (unsigned int iregion = 0; iregion < m_InitialNumberOfRegions; ++iregion)
+  {
+    m_AtomicRegionLabels[iregion] = m_RegionsPointer[iregion]->GetRegionLabel();
+    numberOfLabels = std::max(numberOfLabels, m_AtomicRegionLabels[iregion]);
+  }
+
+  constexpr SizeValueType vectorDimension = InputImageVectorDimension;
+  m_RegionMeans.assign(numberOfLabels * vectorDimension, 0.0);
+  for (unsigned int iregion = 0; iregion < m_InitialNumberOfRegions; ++iregion)
+  {
+    const MeanRegionIntensityType & meanValue = m_RegionsPointer[iregion]->GetMeanRegionIntensity();
+    std::copy_n(meanValue.begin(),
+                vectorDimension,
+                m_RegionMeans.begin() + (m_AtomicRegionLabels[iregion] - 1) * vectorDimension);
+  }
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+KLMRegionGrowImageFilter<TInputImage, TOutputImage>::InitializeKLM()
+{
+  // Check the parameters, then determine the regions first and initialize them
+
+  const InputImageSizeType          numRegionsAlongDim = this->ComputeNumberOfRegionsAlongDimensions();
+  const InputImageConstPointer      inputImage = this->GetInput();
+  InputImageSizeType                inputImageSize = inputImage->GetBufferedRegion().GetSize();
+  GridSizeType                      gridSize = this->GetGridSize();
+  typename TInputImage::SpacingType spacing = inputImage->GetSpacing();
 
   // Calculate the initial number of regions
 
@@ -578,6 +581,451 @@ KLMRegionGrowImageFilter<TInputImage, TOutputImage>::InitializeRegionParameters(
   m_InitialRegionMean /= m_InitialRegionArea;
 }
 
+template <typename TInputImage, typename TOutputImage>
+void
+KLMRegionGrowImageFilter<TInputImage, TOutputImage>::ApplyParallelKLM()
+{
+  // Region merging in rounds. In each round every region picks its border
+  // of least lambda, ties going to the border that comes first in the
+  // border array, and the borders picked by both of their regions are
+  // removed. No two of these borders share a region, so their merges are
+  // made concurrently. To keep close to the order of the sequential
+  // merging, a round only removes borders whose lambda is not above the
+  // k-th least lambda, k being half the number of regions that remain to
+  // be merged, and never more borders than that number. The border of
+  // least lambda overall is always removed, so each round merges at least
+  // one pair of regions.
+
+  const InputImageSizeType          numRegionsAlongDim = this->ComputeNumberOfRegionsAlongDimensions();
+  const InputImageConstPointer      inputImage = this->GetInput();
+  GridSizeType                      gridSize = this->GetGridSize();
+  typename TInputImage::SpacingType spacing = inputImage->GetSpacing();
+
+  m_InitialNumberOfRegions = 1;
+  for (unsigned int idim = 0; idim < InputImageDimension; ++idim)
+  {
+    m_InitialNumberOfRegions *= numRegionsAlongDim[idim];
+  }
+
+  if (m_InitialNumberOfRegions < this->GetMaximumNumberOfRegions())
+  {
+    itkWarningMacro("Number of initial image regions is less than requested: reduce granularity of the grid");
+  }
+
+  m_NumberOfRegions = m_InitialNumberOfRegions;
+
+  // The borders along each dimension follow those of the previous dimensions
+  std::vector<SizeValueType> dimensionBorderOffsets(InputImageDimension + 1, 0);
+  std::vector<double>        dimensionBorderLengths(InputImageDimension, 1.0);
+  double                     regionArea = 1;
+  for (unsigned int idim = 0; idim < InputImageDimension; ++idim)
+  {
+    SizeValueType numBorderThisDim = 1;
+    for (unsigned int jdim = 0; jdim < InputImageDimension; ++jdim)
+    {
+      numBorderThisDim *= (jdim == idim ? numRegionsAlongDim[jdim] - 1 : numRegionsAlongDim[jdim]);
+      dimensionBorderLengths[idim] *= (jdim == idim ? 1 : gridSize[jdim] * spacing[jdim]);
+    }
+    dimensionBorderOffsets[idim + 1] = dimensionBorderOffsets[idim] + numBorderThisDim;
+    regionArea *= gridSize[idim] * spacing[idim];
+  }
+
+  if (dimensionBorderOffsets.back() == 0)
+  {
+    itkExceptionStringMacro("Number of initial regions must be 2 or more: reduce granularity of the grid");
+  }
+
+  // The steps of a round are split in one range per work unit, and the
+  // results of the ranges are combined in order.
+
+  const SizeValueType numberOfRegions = m_InitialNumberOfRegions;
+  const SizeValueType numberOfRanges = this->GetNumberOfWorkUnits();
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  const auto parallelForRanges = [multiThreader, numberOfRanges](SizeValueType size, const auto & rangeFunction) {
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfRanges,
+      [size, numberOfRanges, &rangeFunction](SizeValueType range) {
+        rangeFunction(size * range / numberOfRanges, size * (range + 1) / numberOfRanges, range);
+      },
+      nullptr);
+  };
+
+  // Offsets of the counts of each element in a sequence of counts
+  std::vector<SizeValueType> rangeSums(numberOfRanges + 1);
+  const auto                 exclusiveScan = [&](SizeValueType size, const auto & count, auto & offsets) {
+    offsets.resize(size + 1);
+    rangeSums[0] = 0;
+    parallelForRanges(size, [&](SizeValueType begin, SizeValueType end, SizeValueType range) {
+      SizeValueType sum = 0;
+      for (SizeValueType k = begin; k < end; ++k)
+      {
+        sum += count(k);
+      }
+      rangeSums[range + 1] = sum;
+    });
+    std::partial_sum(rangeSums.begin(), rangeSums.end(), rangeSums.begin());
+    parallelForRanges(size, [&](SizeValueType begin, SizeValueType end, SizeValueType range) {
+      SizeValueType sum = rangeSums[range];
+      for (SizeValueType k = begin; k < end; ++k)
+      {
+        offsets[k] = sum;
+        sum += count(k);
+      }
+    });
+    offsets[size] = rangeSums[numberOfRanges];
+  };
+
+  // Initialize the regions: the mean of the components of a region starts
+  // at position region * InputImageVectorDimension. A region that has been
+  // merged holds the position of the region it was merged into, which is
+  // always a smaller one; the others hold their own position.
+
+  constexpr SizeValueType      vectorDimension = InputImageVectorDimension;
+  std::vector<double>          regionAreas(numberOfRegions, regionArea);
+  std::vector<double>          regionMeans(numberOfRegions * vectorDimension, 0.0);
+  std::vector<RegionLabelType> regionLabels(numberOfRegions);
+
+  parallelForRanges(numberOfRegions, [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+    InputRegionType region;
+    region.SetSize(gridSize); // Constant grid size
+    for (SizeValueType iregion = begin; iregion < end; ++iregion)
+    {
+      region.SetIndex(ComputeGridIndex(iregion, numRegionsAlongDim) * gridSize);
+      double * meanValue = &regionMeans[iregion * vectorDimension];
+      for (InputImageConstIterator inputIt(inputImage, region); !inputIt.IsAtEnd(); ++inputIt)
+      {
+        const InputImageVectorType inputPixelVec = inputIt.Value();
+        for (unsigned int ivecdim = 0; ivecdim < InputImageVectorDimension; ++ivecdim)
+        {
+          meanValue[ivecdim] += inputPixelVec[ivecdim];
+        }
+      }
+      for (unsigned int ivecdim = 0; ivecdim < InputImageVectorDimension; ++ivecdim)
+      {
+        meanValue[ivecdim] /= regionArea;
+      }
+      regionLabels[iregion] = static_cast<RegionLabelType>(iregion);
+    }
+  });
+
+  // Initialize the borders between the neighbor atomic regions
+
+  std::vector<FlatBorder> borders(dimensionBorderOffsets.back());
+  parallelForRanges(borders.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+    for (SizeValueType iborder = begin; iborder < end; ++iborder)
+    {
+      unsigned int idim = 0;
+      while (iborder >= dimensionBorderOffsets[idim + 1])
+      {
+        ++idim;
+      }
+      InputImageSizeType numBordersAlongDim = numRegionsAlongDim;
+      numBordersAlongDim[idim]--;
+      const InputImageIndexType indexRegion1 =
+        ComputeGridIndex(iborder - dimensionBorderOffsets[idim], numBordersAlongDim);
+
+      SizeValueType region1 = 0;
+      SizeValueType stride = 1;
+      SizeValueType neighborStride = 1;
+      for (unsigned int jdim = 0; jdim < InputImageDimension; ++jdim)
+      {
+        region1 += indexRegion1[jdim] * stride;
+        if (jdim == idim)
+        {
+          neighborStride = stride;
+        }
+        stride *= numRegionsAlongDim[jdim];
+      }
+      borders[iborder] = { static_cast<RegionLabelType>(region1),
+                           static_cast<RegionLabelType>(region1 + neighborStride),
+                           dimensionBorderLengths[idim],
+                           0.0 };
+    }
+  });
+
+  // Compute the lambda of every border, and return the least of them
+  std::vector<double> rangeMinima(numberOfRanges);
+  const auto          evaluateLambdas = [&]() {
+    if (borders.empty())
+    {
+      return NumericTraits<double>::max();
+    }
+    parallelForRanges(borders.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType range) {
+      double minimumLambda = NumericTraits<double>::max();
+      for (SizeValueType iborder = begin; iborder < end; ++iborder)
+      {
+        FlatBorder &   border = borders[iborder];
+        const double * meanValue1 = &regionMeans[border.m_Region1 * vectorDimension];
+        const double * meanValue2 = &regionMeans[border.m_Region2 * vectorDimension];
+        double         cost = 0;
+        for (unsigned int ivecdim = 0; ivecdim < InputImageVectorDimension; ++ivecdim)
+        {
+          const double difference = meanValue1[ivecdim] - meanValue2[ivecdim];
+          cost += difference * difference;
+        }
+        const double region1Area = regionAreas[border.m_Region1];
+        const double region2Area = regionAreas[border.m_Region2];
+        const double scaleArea = (region1Area * region2Area) / (region1Area + region2Area);
+        border.m_Lambda = scaleArea * cost / border.m_Length;
+        minimumLambda = std::min(minimumLambda, border.m_Lambda);
+      }
+      rangeMinima[range] = minimumLambda;
+    });
+    return *std::min_element(rangeMinima.begin(), rangeMinima.end());
+  };
+
+  // Borders ordered by lambda, then by position in the border array
+  const auto precedes = [&borders](SizeValueType a, SizeValueType b) {
+    return borders[a].m_Lambda < borders[b].m_Lambda ||
+           (Math::ExactlyEquals(borders[a].m_Lambda, borders[b].m_Lambda) && a < b);
+  };
+
+  // The positions of the regions that remain, in increasing order; the
+  // rank of a region in this list indexes the groups of its borders.
+  std::vector<RegionLabelType> remainingRegions(numberOfRegions);
+  std::vector<RegionLabelType> regionRanks(numberOfRegions);
+  std::vector<RegionLabelType> keptRegions;
+  std::vector<SizeValueType>   keptRegionOffsets;
+  std::iota(remainingRegions.begin(), remainingRegions.end(), RegionLabelType{ 0 });
+  std::iota(regionRanks.begin(), regionRanks.end(), RegionLabelType{ 0 });
+
+  constexpr auto                          noBorder = NumericTraits<SizeValueType>::max();
+  std::vector<std::atomic<SizeValueType>> regionCandidates(numberOfRegions);
+  std::vector<std::atomic<SizeValueType>> regionBorderCounts(numberOfRegions);
+  std::vector<double>                     lambdas;
+  std::vector<SizeValueType>              selectedBorders;
+  std::vector<SizeValueType>              borderOffsets;
+  std::vector<SizeValueType>              sortedBorders;
+  std::vector<SizeValueType>              mergedBorderCounts(numberOfRegions);
+  std::vector<SizeValueType>              mergedBorderOffsets;
+  std::vector<FlatBorder>                 mergedBorders;
+
+  m_InternalLambda = evaluateLambdas();
+
+  while ((m_NumberOfRegions > this->GetMaximumNumberOfRegions()) && (m_InternalLambda < m_MaximumLambda))
+  {
+    // Each region picks its border of least lambda
+    parallelForRanges(remainingRegions.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+      for (SizeValueType irank = begin; irank < end; ++irank)
+      {
+        regionCandidates[remainingRegions[irank]].store(noBorder, std::memory_order_relaxed);
+      }
+    });
+    parallelForRanges(borders.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+      for (SizeValueType iborder = begin; iborder < end; ++iborder)
+      {
+        for (const RegionLabelType iregion : { borders[iborder].m_Region1, borders[iborder].m_Region2 })
+        {
+          SizeValueType candidate = regionCandidates[iregion].load(std::memory_order_relaxed);
+          while ((candidate == noBorder || precedes(iborder, candidate)) &&
+                 !regionCandidates[iregion].compare_exchange_weak(candidate, iborder, std::memory_order_relaxed))
+          {
+          }
+        }
+      }
+    });
+
+    // Find the k-th least lambda
+    const SizeValueType numberOfExcessRegions = m_NumberOfRegions - this->GetMaximumNumberOfRegions();
+    const SizeValueType lambdaRank = std::min<SizeValueType>((numberOfExcessRegions + 1) / 2, borders.size()) - 1;
+    lambdas.resize(borders.size());
+    parallelForRanges(borders.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+      for (SizeValueType iborder = begin; iborder < end; ++iborder)
+      {
+        lambdas[iborder] = borders[iborder].m_Lambda;
+      }
+    });
+    std::nth_element(lambdas.begin(), lambdas.begin() + lambdaRank, lambdas.end());
+    const double lambdaThreshold = lambdas[lambdaRank];
+
+    // Select the borders picked by both of their regions
+    const auto isSelected = [&](SizeValueType iborder) -> SizeValueType {
+      const FlatBorder & border = borders[iborder];
+      return border.m_Lambda < m_MaximumLambda && border.m_Lambda <= lambdaThreshold &&
+             regionCandidates[border.m_Region1].load(std::memory_order_relaxed) == iborder &&
+             regionCandidates[border.m_Region2].load(std::memory_order_relaxed) == iborder;
+    };
+    exclusiveScan(borders.size(), isSelected, borderOffsets);
+    selectedBorders.resize(borderOffsets.back());
+    parallelForRanges(borders.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+      for (SizeValueType iborder = begin; iborder < end; ++iborder)
+      {
+        if (borderOffsets[iborder + 1] != borderOffsets[iborder])
+        {
+          selectedBorders[borderOffsets[iborder]] = iborder;
+        }
+      }
+    });
+
+    const SizeValueType numberOfMerges = std::min<SizeValueType>(selectedBorders.size(), numberOfExcessRegions);
+    if (numberOfMerges < selectedBorders.size())
+    {
+      std::nth_element(
+        selectedBorders.begin(), selectedBorders.begin() + numberOfMerges, selectedBorders.end(), precedes);
+      selectedBorders.resize(numberOfMerges);
+    }
+
+    // Merge the second region of each selected border into the first
+    parallelForRanges(numberOfMerges, [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+      for (SizeValueType imerge = begin; imerge < end; ++imerge)
+      {
+        const FlatBorder & border = borders[selectedBorders[imerge]];
+        double *           meanValue1 = &regionMeans[border.m_Region1 * vectorDimension];
+        const double *     meanValue2 = &regionMeans[border.m_Region2 * vectorDimension];
+        const double       region1Area = regionAreas[border.m_Region1];
+        const double       region2Area = regionAreas[border.m_Region2];
+        const double       mergedRegionArea = region1Area + region2Area;
+        for (unsigned int ivecdim = 0; ivecdim < InputImageVectorDimension; ++ivecdim)
+        {
+          meanValue1[ivecdim] =
+            (meanValue1[ivecdim] * region1Area + meanValue2[ivecdim] * region2Area) / mergedRegionArea;
+        }
+        regionAreas[border.m_Region1] = mergedRegionArea;
+        regionLabels[border.m_Region2] = border.m_Region1;
+      }
+    });
+    m_NumberOfRegions -= static_cast<unsigned int>(numberOfMerges);
+
+    // Keep the regions that were not merged
+    exclusiveScan(
+      remainingRegions.size(),
+      [&](SizeValueType irank) -> SizeValueType {
+        return regionLabels[remainingRegions[irank]] == remainingRegions[irank];
+      },
+      keptRegionOffsets);
+    keptRegions.resize(keptRegionOffsets.back());
+    parallelForRanges(remainingRegions.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+      for (SizeValueType irank = begin; irank < end; ++irank)
+      {
+        if (keptRegionOffsets[irank + 1] != keptRegionOffsets[irank])
+        {
+          keptRegions[keptRegionOffsets[irank]] = remainingRegions[irank];
+        }
+      }
+    });
+    remainingRegions.swap(keptRegions);
+    parallelForRanges(remainingRegions.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+      for (SizeValueType irank = begin; irank < end; ++irank)
+      {
+        regionRanks[remainingRegions[irank]] = static_cast<RegionLabelType>(irank);
+      }
+    });
+
+    // Move the borders of the merged regions to the regions they were
+    // merged into. The borders inside a region are dropped, and the borders
+    // that now join the same two regions are combined into one, whose length
+    // is the sum of theirs. The borders are grouped by their first region,
+    // then sorted by their second region and by their previous position.
+    // The counts of borders of the regions are back to zero once the
+    // borders have been grouped.
+    parallelForRanges(borders.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+      for (SizeValueType iborder = begin; iborder < end; ++iborder)
+      {
+        FlatBorder &          border = borders[iborder];
+        const RegionLabelType region1 = regionLabels[border.m_Region1];
+        const RegionLabelType region2 = regionLabels[border.m_Region2];
+        border.m_Region1 = std::min(region1, region2);
+        border.m_Region2 = std::max(region1, region2);
+        if (region1 != region2)
+        {
+          regionBorderCounts[regionRanks[border.m_Region1]].fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+    exclusiveScan(
+      remainingRegions.size(),
+      [&regionBorderCounts](SizeValueType irank) { return regionBorderCounts[irank].load(std::memory_order_relaxed); },
+      borderOffsets);
+    sortedBorders.resize(borderOffsets.back());
+    parallelForRanges(borders.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+      for (SizeValueType iborder = begin; iborder < end; ++iborder)
+      {
+        const FlatBorder & border = borders[iborder];
+        if (border.m_Region1 != border.m_Region2)
+        {
+          const SizeValueType irank = regionRanks[border.m_Region1];
+          const SizeValueType count = regionBorderCounts[irank].fetch_sub(1, std::memory_order_relaxed);
+          sortedBorders[borderOffsets[irank] + count - 1] = iborder;
+        }
+      }
+    });
+    parallelForRanges(remainingRegions.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+      for (SizeValueType irank = begin; irank < end; ++irank)
+      {
+        const auto first = sortedBorders.begin() + borderOffsets[irank];
+        const auto last = sortedBorders.begin() + borderOffsets[irank + 1];
+        std::sort(first, last, [&borders](SizeValueType a, SizeValueType b) {
+          return borders[a].m_Region2 < borders[b].m_Region2 || (borders[a].m_Region2 == borders[b].m_Region2 && a < b);
+        });
+        SizeValueType count = 0;
+        for (auto it = first; it != last; ++it)
+        {
+          count += (it == first || borders[*it].m_Region2 != borders[*(it - 1)].m_Region2);
+        }
+        mergedBorderCounts[irank] = count;
+      }
+    });
+    exclusiveScan(
+      remainingRegions.size(),
+      [&mergedBorderCounts](SizeValueType irank) { return mergedBorderCounts[irank]; },
+      mergedBorderOffsets);
+    mergedBorders.resize(mergedBorderOffsets.back());
+    parallelForRanges(remainingRegions.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+      for (SizeValueType irank = begin; irank < end; ++irank)
+      {
+        SizeValueType merged = mergedBorderOffsets[irank];
+        for (SizeValueType k = borderOffsets[irank]; k < borderOffsets[irank + 1]; ++k)
+        {
+          const FlatBorder & border = borders[sortedBorders[k]];
+          if (k == borderOffsets[irank] || border.m_Region2 != mergedBorders[merged - 1].m_Region2)
+          {
+            mergedBorders[merged++] = border;
+          }
+          else
+          {
+            mergedBorders[merged - 1].m_Length += border.m_Length;
+          }
+        }
+      }
+    });
+    borders.swap(mergedBorders);
+
+    m_InternalLambda = evaluateLambdas();
+  }
+
+  // Resolve the chains of merged regions: a region was merged into a region
+  // of smaller position, whose final region is known by then. The remaining
+  // regions get consecutive labels, in the order of their positions.
+
+  m_AtomicRegionLabels.resize(numberOfRegions);
+  m_RegionMeans.resize(SizeValueType{ m_NumberOfRegions } * vectorDimension);
+  RegionLabelType newLabelValue = 0;
+  for (SizeValueType iregion = 0; iregion < numberOfRegions; ++iregion)
+  {
+    const RegionLabelType mergedRegion = regionLabels[iregion];
+    if (mergedRegion == iregion)
+    {
+      m_AtomicRegionLabels[iregion] = ++newLabelValue;
+      std::copy_n(regionMeans.begin() + iregion * vectorDimension,
+                  vectorDimension,
+                  m_RegionMeans.begin() + (newLabelValue - 1) * vectorDimension);
+    }
+    else
+    {
+      m_AtomicRegionLabels[iregion] = m_AtomicRegionLabels[mergedRegion];
+    }
+  }
+
+  // The region and border objects of the sequential merging are not used
+  m_RegionsPointer.clear();
+  m_BordersPointer.clear();
+  m_BordersDynamicPointer.clear();
+  m_BorderCandidate = nullptr;
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 KLMRegionGrowImageFilter<TInputImage, TOutputImage>::MergeRegions()
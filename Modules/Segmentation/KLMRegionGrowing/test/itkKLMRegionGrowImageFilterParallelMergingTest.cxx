@@ -0,0 +1,183 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkKLMRegionGrowImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+constexpr unsigned int NumberOfBands = 2;
+
+// An image made of one region per orthant around a corner that lies on the
+// grid, with an optional deterministic pattern of small values on top.
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const typename TImage::SizeType & size, unsigned int gridSize, bool addPattern)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  typename TImage::IndexType corner;
+  for (unsigned int idim = 0; idim < TImage::ImageDimension; ++idim)
+  {
+    corner[idim] = gridSize * ((size[idim] / gridSize) * 3 / 8);
+  }
+
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    const typename TImage::IndexType index = it.GetIndex();
+    unsigned int                     orthant = 0;
+    itk::IndexValueType              hash = 0;
+    for (unsigned int idim = 0; idim < TImage::ImageDimension; ++idim)
+    {
+      orthant += (index[idim] >= corner[idim]) << idim;
+      hash = hash * 13 + index[idim] * 7;
+    }
+    typename TImage::PixelType pixel;
+    pixel[0] = 10.0 * orthant + (addPattern ? 0.05 * (hash % 5) : 0.0);
+    pixel[1] = 100.0 - 7.0 * orthant;
+    it.Set(pixel);
+  }
+  return image;
+}
+
+template <typename TImage>
+bool
+SameImages(const TImage * image1, const TImage * image2)
+{
+  itk::ImageRegionConstIterator<TImage> it1(image1, image1->GetBufferedRegion());
+  itk::ImageRegionConstIterator<TImage> it2(image2, image2->GetBufferedRegion());
+  for (; !it1.IsAtEnd() && !it2.IsAtEnd(); ++it1, ++it2)
+  {
+    if (it1.Get() != it2.Get())
+    {
+      return false;
+    }
+  }
+  return it1.IsAtEnd() && it2.IsAtEnd();
+}
+
+template <typename TFilter>
+void
+Segment(TFilter *                                filter,
+        const typename TFilter::InputImageType * image,
+        unsigned int                             gridSize,
+        unsigned int                             maximumNumberOfRegions,
+        double                                   maximumLambda,
+        bool                                     parallelMerging,
+        itk::ThreadIdType                        numberOfWorkUnits)
+{
+  filter->SetInput(image);
+  filter->SetGridSize(TFilter::GridSizeType::Filled(gridSize));
+  filter->SetMaximumNumberOfRegions(maximumNumberOfRegions);
+  filter->SetMaximumLambda(maximumLambda);
+  filter->SetParallelMerging(parallelMerging);
+  filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+  filter->Update();
+}
+
+template <unsigned int VDimension>
+int
+TestParallelMerging(const itk::Size<VDimension> & size, unsigned int gridSize)
+{
+  using ImageType = itk::Image<itk::Vector<double, NumberOfBands>, VDimension>;
+  using FilterType = itk::KLMRegionGrowImageFilter<ImageType, ImageType>;
+
+  std::cout << "Testing " << VDimension << "D parallel merging" << std::endl;
+
+  constexpr unsigned int numberOfOrthants = 1u << VDimension;
+  constexpr double       noMaximumLambda = 1e10;
+
+  // On a piecewise constant image, the regions found are those of the
+  // sequential merging, down to their labels and means.
+  const auto image = MakeImage<ImageType>(size, gridSize, false);
+
+  auto sequential = FilterType::New();
+  Segment(sequential.GetPointer(), image.GetPointer(), gridSize, numberOfOrthants, noMaximumLambda, false, 1);
+  auto parallel = FilterType::New();
+  Segment(parallel.GetPointer(), image.GetPointer(), gridSize, numberOfOrthants, noMaximumLambda, true, 1);
+  ITK_TEST_EXPECT_EQUAL(sequential->GetNumberOfRegions(), numberOfOrthants);
+  ITK_TEST_EXPECT_EQUAL(parallel->GetNumberOfRegions(), numberOfOrthants);
+  ITK_TEST_EXPECT_TRUE(
+    SameImages(sequential->GetLabelledImage().GetPointer(), parallel->GetLabelledImage().GetPointer()));
+  ITK_TEST_EXPECT_TRUE(SameImages(sequential->GetOutput(), parallel->GetOutput()));
+
+  // The merging stops at the maximum lambda as well
+  Segment(sequential.GetPointer(), image.GetPointer(), gridSize, 2, 1.0, false, 1);
+  Segment(parallel.GetPointer(), image.GetPointer(), gridSize, 2, 1.0, true, 1);
+  ITK_TEST_EXPECT_EQUAL(parallel->GetNumberOfRegions(), numberOfOrthants);
+  ITK_TEST_EXPECT_TRUE(
+    SameImages(sequential->GetLabelledImage().GetPointer(), parallel->GetLabelledImage().GetPointer()));
+
+  // On a noisy image the orthants are still found, and the result does not
+  // depend on the number of work units.
+  const auto noisyImage = MakeImage<ImageType>(size, gridSize, true);
+  Segment(sequential.GetPointer(), noisyImage.GetPointer(), gridSize, numberOfOrthants, noMaximumLambda, false, 1);
+  Segment(parallel.GetPointer(), noisyImage.GetPointer(), gridSize, numberOfOrthants, noMaximumLambda, true, 1);
+  auto parallelWorkUnits = FilterType::New();
+  Segment(
+    parallelWorkUnits.GetPointer(), noisyImage.GetPointer(), gridSize, numberOfOrthants, noMaximumLambda, true, 3);
+  ITK_TEST_EXPECT_TRUE(
+    SameImages(sequential->GetLabelledImage().GetPointer(), parallel->GetLabelledImage().GetPointer()));
+  ITK_TEST_EXPECT_TRUE(
+    SameImages(parallel->GetLabelledImage().GetPointer(), parallelWorkUnits->GetLabelledImage().GetPointer()));
+  ITK_TEST_EXPECT_TRUE(SameImages(parallel->GetOutput(), parallelWorkUnits->GetOutput()));
+
+  // Down to fewer regions than orthants, the work units still agree
+  Segment(parallel.GetPointer(), noisyImage.GetPointer(), gridSize, 3, noMaximumLambda, true, 1);
+  Segment(parallelWorkUnits.GetPointer(), noisyImage.GetPointer(), gridSize, 3, noMaximumLambda, true, 4);
+  ITK_TEST_EXPECT_EQUAL(parallel->GetNumberOfRegions(), 3u);
+  ITK_TEST_EXPECT_TRUE(
+    SameImages(parallel->GetLabelledImage().GetPointer(), parallelWorkUnits->GetLabelledImage().GetPointer()));
+  ITK_TEST_EXPECT_TRUE(SameImages(parallel->GetOutput(), parallelWorkUnits->GetOutput()));
+
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+int
+itkKLMRegionGrowImageFilterParallelMergingTest(int, char *[])
+{
+  using ImageType = itk::Image<itk::Vector<double, NumberOfBands>, 2>;
+  using FilterType = itk::KLMRegionGrowImageFilter<ImageType, ImageType>;
+
+  auto filter = FilterType::New();
+  ITK_TEST_SET_GET_BOOLEAN(filter, ParallelMerging, false);
+
+  // The parameters are checked as by the sequential merging
+  const auto image = MakeImage<ImageType>({ { 12, 10 } }, 2, false);
+  filter->SetInput(image);
+  filter->ParallelMergingOn();
+  filter->SetGridSize(FilterType::GridSizeType::Filled(3));
+  ITK_TRY_EXPECT_EXCEPTION(filter->Update());
+  filter->SetGridSize(FilterType::GridSizeType::Filled(2));
+  filter->SetMaximumNumberOfRegions(1);
+  ITK_TRY_EXPECT_EXCEPTION(filter->Update());
+
+  if (TestParallelMerging<2>({ { 64, 48 } }, 2) == EXIT_FAILURE ||
+      TestParallelMerging<3>({ { 16, 12, 8 } }, 2) == EXIT_FAILURE)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -278,6 +278,11 @@ protected:
   void
   ComputeIteration() override;
 
+  /** Compute the update at the nodes of the zero level set of a level set
+   * with active tiles, the tiles being processed concurrently */
+  void
+  ComputeIterationInActiveTiles(const LevelSetType * levelSet);
+
   /** Compute the time-step for the next iteration */
   void
   ComputeTimeStepForNextIteration() override;
@@ -367,6 +372,12 @@ public:
   ~LevelSetEvolution() override = default;
 
 protected:
+  /** No update buffer is needed: bring the active tiles of the level sets up
+   * to date for the initialization of the terms. The updater modifies the
+   * layers in place, which discards them for the iterations. */
+  void
+  AllocateUpdateBuffer() override;
+
   /** Update the levelset by 1 iteration from the computed updates */
   void
   UpdateLevelSets() override;
@@ -446,6 +457,12 @@ public:
   ~LevelSetEvolution() override = default;
 
 protected:
+  /** No update buffer is needed: bring the active tiles of the level sets up
+   * to date for the initialization of the terms. The updater modifies the
+   * layers in place, which discards them for the iterations. */
+  void
+  AllocateUpdateBuffer() override;
+
   void
   UpdateLevelSets() override;
   void
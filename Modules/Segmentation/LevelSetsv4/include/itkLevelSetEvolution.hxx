@@ -20,6 +20,7 @@
 #ifndef itkLevelSetEvolution_hxx
 #define itkLevelSetEvolution_hxx
 
+#include <algorithm>
 
 namespace itk
 {
@@ -260,6 +261,7 @@ LevelSetEvolution<TEquationContainer, WhitakerSparseLevelSetImage<TOutput, VDime
         this->m_UpdateBuffer[identifier] = new LevelSetLayerType;
       }
     }
+    it->GetLevelSet()->UpdateActiveTiles();
     ++it;
   }
 }
@@ -274,16 +276,80 @@ LevelSetEvolution<TEquationContainer, WhitakerSparseLevelSetImage<TOutput, VDime
   {
     const typename LevelSetType::ConstPointer levelSet =
       this->m_LevelSetContainerIteratorToProcessWhenThreading->GetLevelSet();
-    const LevelSetLayerType                                 zeroLayer = levelSet->GetLayer(0);
-    auto                                                    layerBegin = zeroLayer.begin();
-    auto                                                    layerEnd = zeroLayer.end();
-    const typename SplitLevelSetPartitionerType::DomainType completeDomain(layerBegin, layerEnd);
-    this->m_SplitLevelSetComputeIterationThreader->Execute(this, completeDomain);
+    if (levelSet->HasActiveTiles())
+    {
+      this->ComputeIterationInActiveTiles(levelSet);
+    }
+    else
+    {
+      const LevelSetLayerType &                               zeroLayer = levelSet->GetLayer(0);
+      const typename SplitLevelSetPartitionerType::DomainType completeDomain(zeroLayer.begin(), zeroLayer.end());
+      this->m_SplitLevelSetComputeIterationThreader->Execute(this, completeDomain);
+    }
 
     ++(this->m_LevelSetContainerIteratorToProcessWhenThreading);
   }
 }
 
+template <typename TEquationContainer, typename TOutput, unsigned int VDimension>
+void
+LevelSetEvolution<TEquationContainer, WhitakerSparseLevelSetImage<TOutput, VDimension>>::ComputeIterationInActiveTiles(
+  const LevelSetType * levelSet)
+{
+  const LevelSetIdentifierType levelSetId = this->m_LevelSetContainerIteratorToProcessWhenThreading->GetIdentifier();
+  const typename LevelSetType::OffsetType offset = levelSet->GetDomainOffset();
+  const TermContainerPointer              termContainer = this->m_EquationContainer->GetEquation(levelSetId);
+  const LevelSetLayerType &               zeroLayer = levelSet->GetLayer(LevelSetType::ZeroLayer());
+
+  // Group the nodes by tile, remembering their rank in the layer
+  std::vector<typename LevelSetLayerType::const_iterator> nodes;
+  std::vector<std::pair<SizeValueType, SizeValueType>>    tileAndRank;
+  nodes.reserve(zeroLayer.size());
+  tileAndRank.reserve(zeroLayer.size());
+  for (auto nodeIt = zeroLayer.begin(); nodeIt != zeroLayer.end(); ++nodeIt)
+  {
+    tileAndRank.emplace_back(levelSet->GetActiveTileNumber(nodeIt->first + offset), nodes.size());
+    nodes.push_back(nodeIt);
+  }
+  std::sort(tileAndRank.begin(), tileAndRank.end());
+
+  std::vector<SizeValueType> tileFirstNode;
+  for (SizeValueType i = 0; i < tileAndRank.size(); ++i)
+  {
+    if (i == 0 || tileAndRank[i].first != tileAndRank[i - 1].first)
+    {
+      tileFirstNode.push_back(i);
+    }
+  }
+  tileFirstNode.push_back(tileAndRank.size());
+
+  std::vector<LevelSetOutputType> updates(nodes.size());
+  MultiThreaderBase * multiThreader = this->m_SplitLevelSetComputeIterationThreader->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->m_SplitLevelSetComputeIterationThreader->GetNumberOfWorkUnits());
+  multiThreader->ParallelizeArray(
+    0,
+    tileFirstNode.size() - 1,
+    [&](SizeValueType tile) {
+      for (SizeValueType i = tileFirstNode[tile]; i < tileFirstNode[tile + 1]; ++i)
+      {
+        const SizeValueType     rank = tileAndRank[i].second;
+        const LevelSetInputType inputIndex = nodes[rank]->first + offset;
+
+        LevelSetDataType characteristics;
+        termContainer->ComputeRequiredData(inputIndex, characteristics);
+        updates[rank] = static_cast<LevelSetOutputType>(termContainer->Evaluate(inputIndex, characteristics));
+      }
+    },
+    nullptr);
+
+  // In the order of the layer, each node goes at the end of the buffer
+  LevelSetLayerType & updateBuffer = *this->m_UpdateBuffer[levelSetId];
+  for (SizeValueType rank = 0; rank < nodes.size(); ++rank)
+  {
+    updateBuffer.emplace_hint(updateBuffer.end(), nodes[rank]->first, updates[rank]);
+  }
+}
+
 template <typename TEquationContainer, typename TOutput, unsigned int VDimension>
 void
 LevelSetEvolution<TEquationContainer,
@@ -337,6 +403,7 @@ LevelSetEvolution<TEquationContainer, WhitakerSparseLevelSetImage<TOutput, VDime
     updateLevelSet->Update();
 
     levelSet->Graft(updateLevelSet->GetOutputLevelSet());
+    levelSet->UpdateActiveTiles();
 
     this->m_RMSChangeAccumulator = updateLevelSet->GetRMSChangeAccumulator();
 
@@ -354,6 +421,18 @@ LevelSetEvolution<TEquationContainer, WhitakerSparseLevelSetImage<TOutput, VDime
 
 // Shi
 
+template <typename TEquationContainer, unsigned int VDimension>
+void
+LevelSetEvolution<TEquationContainer, ShiSparseLevelSetImage<VDimension>>::AllocateUpdateBuffer()
+{
+  typename LevelSetContainerType::Iterator it = this->m_LevelSetContainer->Begin();
+  while (it != this->m_LevelSetContainer->End())
+  {
+    it->GetLevelSet()->UpdateActiveTiles();
+    ++it;
+  }
+}
+
 template <typename TEquationContainer, unsigned int VDimension>
 void
 LevelSetEvolution<TEquationContainer, ShiSparseLevelSetImage<VDimension>>::UpdateLevelSets()
@@ -387,6 +466,18 @@ LevelSetEvolution<TEquationContainer, ShiSparseLevelSetImage<VDimension>>::Updat
 
 // Malcolm
 
+template <typename TEquationContainer, unsigned int VDimension>
+void
+LevelSetEvolution<TEquationContainer, MalcolmSparseLevelSetImage<VDimension>>::AllocateUpdateBuffer()
+{
+  typename LevelSetContainerType::Iterator it = this->m_LevelSetContainer->Begin();
+  while (it != this->m_LevelSetContainer->End())
+  {
+    it->GetLevelSet()->UpdateActiveTiles();
+    ++it;
+  }
+}
+
 template <typename TEquationContainer, unsigned int VDimension>
 void
 LevelSetEvolution<TEquationContainer, MalcolmSparseLevelSetImage<VDimension>>::UpdateLevelSets()
@@ -22,9 +22,11 @@
 #include "itkDiscreteLevelSetImage.h"
 #include "itkObjectFactory.h"
 
+#include "itkFixedArray.h"
 #include "itkLabelObject.h"
 #include "itkLabelMap.h"
 #include "itkLexicographicCompare.h"
+#include <vector>
 
 namespace itk
 {
@@ -33,6 +35,29 @@ namespace itk
  *  \class LevelSetSparseImage
  *  \brief Base class for the sparse representation of a level-set function on one Image.
  *
+ *  The layers are kept in maps and the status of the other pixels in a label
+ *  map, which remain the storage of the level set.
+ *
+ *  With UseActiveTiles on, UpdateActiveTiles() copies them into a lookup
+ *  cache of tiles of ActiveTileSize pixels along each dimension: the tiles
+ *  that hold a node of a layer are stored densely, the others only record the
+ *  status shared by all their pixels. While the cache is up to date, Status()
+ *  and Evaluate() read it in constant time instead of searching the layers and
+ *  the lines of the label map. Any change of the layers or of the label map
+ *  discards it, and it is rebuilt from scratch, in time proportional to the
+ *  number of tiles, the number of nodes and the number of lines of the label
+ *  map.
+ *
+ *  The cache serves the evolution of the Whitaker representation, which
+ *  rebuilds it after each iteration and computes the updates of the tiles of
+ *  the zero level set concurrently. The rebuild itself is serial and visits
+ *  every tile of the largest possible region, not only those the updater
+ *  touched, so each iteration keeps a cost that grows with the size of the
+ *  image rather than with the size of the front; the tiles pay off when the
+ *  computation of the updates dominates. The updaters of the Shi and Malcolm
+ *  representations modify the layers in place, so their evolutions only use
+ *  the cache while the terms are initialized.
+ *
  *  \tparam TImage Input image type of the level set function
  *  \todo Think about using image iterators instead of GetPixel()
  *
@@ -113,6 +138,45 @@ public:
   typename LabelObject<TLabel, VDimension>::Pointer
   GetAsLabelObject();
 
+  /** Set/Get whether UpdateActiveTiles() copies the level set into tiles.
+   * Off by default. */
+  /** @ITKStartGrouping */
+  itkSetMacro(UseActiveTiles, bool);
+  itkGetConstMacro(UseActiveTiles, bool);
+  itkBooleanMacro(UseActiveTiles);
+  /** @ITKEndGrouping */
+
+  /** Set/Get the number of pixels of the tiles along each dimension. The
+   * default is 8. */
+  /** @ITKStartGrouping */
+  itkSetClampMacro(ActiveTileSize, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(ActiveTileSize, SizeValueType);
+  /** @ITKEndGrouping */
+
+  /** Copy the layers and the label map into the tiles, when UseActiveTiles is
+   * on. The evolutions call it before the first iteration, and the Whitaker
+   * evolution after each one as well. Modifying the layers, setting the label
+   * map or grafting discards the tiles until the next call. Every call
+   * rebuilds all the tiles serially. */
+  void
+  UpdateActiveTiles();
+
+  /** Return whether the tiles are up to date with the layers and the label
+   * map. */
+  bool
+  HasActiveTiles() const
+  {
+    return m_UseActiveTiles && m_ActiveTilesAreUpToDate;
+  }
+
+  /** Return the number of the tile that holds a given location, when
+   * HasActiveTiles() is true. */
+  SizeValueType
+  GetActiveTileNumber(const InputType & inputIndex) const;
+
+  /** Return the number of tiles that are stored densely. */
+  itkGetConstMacro(NumberOfResidentTiles, SizeValueType);
+
 protected:
   LevelSetSparseImage() = default;
   ~LevelSetSparseImage() override = default;
@@ -138,6 +202,44 @@ protected:
   /** Copy level set information from data object */
   void
   CopyInformation(const DataObject * data) override;
+
+  /** Look a location of the label map up in the tiles. Return false when the
+   * tiles are not up to date or the location is outside of the label map. */
+  bool
+  FindInActiveTiles(const InputType & mapIndex, LayerIdType & status, OutputType & value) const;
+
+private:
+  static constexpr SizeValueType NotResident = NumericTraits<SizeValueType>::max();
+
+  /** Find the tile that holds a location of the label map, and the position
+   * of the location in the tile. Return false when it is outside of the label
+   * map. */
+  bool
+  LocateInActiveTiles(const InputType & mapIndex, SizeValueType & tile, SizeValueType & pixel) const;
+
+  /** Call function( label, tile, pixel, length ) for each piece of a line of
+   * the label map that lies in a single tile. */
+  template <typename TFunction>
+  void
+  VisitLabelMapLinesInTiles(TFunction function) const;
+
+  bool          m_UseActiveTiles{ false };
+  SizeValueType m_ActiveTileSize{ 8 };
+  bool          m_ActiveTilesAreUpToDate{ false };
+  SizeValueType m_NumberOfResidentTiles{ 0 };
+
+  /** Geometry of the tiles, in the region of the label map. */
+  RegionType                            m_TiledRegion{};
+  SizeValueType                         m_TileEdge{ 0 };
+  FixedArray<SizeValueType, VDimension> m_TileStrides{};
+  FixedArray<SizeValueType, VDimension> m_PixelStrides{};
+
+  /** Status of the tiles that are not resident, and position of the first
+   * pixel of the resident ones in the dense arrays. */
+  std::vector<LayerIdType>   m_TileStatus{};
+  std::vector<SizeValueType> m_TileFirstPixel{};
+  std::vector<LayerIdType>   m_ResidentStatus{};
+  std::vector<OutputType>    m_ResidentValues{};
 };
 
 } // namespace itk
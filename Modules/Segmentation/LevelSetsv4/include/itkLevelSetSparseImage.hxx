@@ -19,6 +19,7 @@
 #ifndef itkLevelSetSparseImage_hxx
 #define itkLevelSetSparseImage_hxx
 
+#include <algorithm>
 
 namespace itk
 {
@@ -28,6 +29,13 @@ auto
 LevelSetSparseImage<TOutput, VDimension>::Status(const InputType & inputIndex) const -> LayerIdType
 {
   const InputType mapIndex = inputIndex - this->m_DomainOffset;
+
+  LayerIdType status;
+  OutputType  value;
+  if (this->FindInActiveTiles(mapIndex, status, value))
+  {
+    return status;
+  }
   return this->m_LabelMap->GetPixel(mapIndex);
 }
 
@@ -37,6 +45,7 @@ void
 LevelSetSparseImage<TOutput, VDimension>::SetLabelMap(LabelMapType * labelMap)
 {
   this->m_LabelMap = labelMap;
+  this->m_ActiveTilesAreUpToDate = false;
 
   using SpacingType = typename LabelMapType::SpacingType;
 
@@ -84,6 +93,7 @@ LevelSetSparseImage<TOutput, VDimension>::Graft(const DataObject * data)
     LayerMapType newLayers(levelSet->m_Layers);
     std::swap(m_Layers, newLayers);
   }
+  this->m_ActiveTilesAreUpToDate = false;
 }
 
 
@@ -109,6 +119,8 @@ LevelSetSparseImage<TOutput, VDimension>::GetLayer(LayerIdType value) -> LayerTy
   {
     itkGenericExceptionMacro("This layer does not exist");
   }
+  // The layer may be modified through the reference
+  this->m_ActiveTilesAreUpToDate = false;
   return it->second;
 }
 
@@ -121,6 +133,7 @@ LevelSetSparseImage<TOutput, VDimension>::SetLayer(LayerIdType value, const Laye
   if (it != m_Layers.end())
   {
     it->second = layer;
+    this->m_ActiveTilesAreUpToDate = false;
   }
   else
   {
@@ -136,6 +149,7 @@ LevelSetSparseImage<TOutput, VDimension>::Initialize()
   Superclass::Initialize();
 
   this->m_LabelMap = nullptr;
+  this->m_ActiveTilesAreUpToDate = false;
   this->InitializeLayers();
   this->InitializeInternalLabelList();
 }
@@ -191,6 +205,239 @@ LevelSetSparseImage<TOutput, VDimension>::GetAsLabelObject()
   return object;
 }
 
+
+template <typename TOutput, unsigned int VDimension>
+void
+LevelSetSparseImage<TOutput, VDimension>::UpdateActiveTiles()
+{
+  this->m_ActiveTilesAreUpToDate = false;
+  this->m_NumberOfResidentTiles = 0;
+
+  if (!this->m_UseActiveTiles || this->m_LabelMap.IsNull())
+  {
+    return;
+  }
+
+  // Tiles larger than the region would only hold pixels outside of it
+  this->m_TiledRegion = this->m_LabelMap->GetLargestPossibleRegion();
+  this->m_TileEdge = 1;
+  for (unsigned int dim = 0; dim < Dimension; ++dim)
+  {
+    this->m_TileEdge = std::max(this->m_TileEdge, static_cast<SizeValueType>(this->m_TiledRegion.GetSize(dim)));
+  }
+  this->m_TileEdge = std::min(this->m_TileEdge, this->m_ActiveTileSize);
+
+  SizeValueType numberOfTiles = 1;
+  SizeValueType pixelsPerTile = 1;
+  for (unsigned int dim = 0; dim < Dimension; ++dim)
+  {
+    this->m_TileStrides[dim] = numberOfTiles;
+    this->m_PixelStrides[dim] = pixelsPerTile;
+    numberOfTiles *= (this->m_TiledRegion.GetSize(dim) + this->m_TileEdge - 1) / this->m_TileEdge;
+    pixelsPerTile *= this->m_TileEdge;
+  }
+
+  const LayerIdType background = this->m_LabelMap->GetBackgroundValue();
+  this->m_TileStatus.assign(numberOfTiles, background);
+  this->m_TileFirstPixel.assign(numberOfTiles, NotResident);
+
+  const auto makeResident = [this, pixelsPerTile](const SizeValueType tile) {
+    if (this->m_TileFirstPixel[tile] == NotResident)
+    {
+      this->m_TileFirstPixel[tile] = this->m_NumberOfResidentTiles * pixelsPerTile;
+      ++this->m_NumberOfResidentTiles;
+    }
+  };
+
+  // The tiles that hold a node of a layer are resident
+  for (const auto & layer : this->m_Layers)
+  {
+    for (const auto & node : layer.second)
+    {
+      SizeValueType tile;
+      SizeValueType pixel;
+      this->LocateInActiveTiles(node.first, tile, pixel);
+      makeResident(tile);
+    }
+  }
+
+  // So are the other tiles where the label map has more than one status
+  std::vector<SizeValueType> numberOfLabeledPixels(numberOfTiles, 0);
+  std::vector<bool>          mixed(numberOfTiles, false);
+  this->VisitLabelMapLinesInTiles(
+    [&](const LayerIdType label, const SizeValueType tile, SizeValueType, const SizeValueType length) {
+      if (this->m_TileFirstPixel[tile] != NotResident)
+      {
+        return;
+      }
+      if (numberOfLabeledPixels[tile] == 0)
+      {
+        this->m_TileStatus[tile] = label;
+      }
+      else if (this->m_TileStatus[tile] != label)
+      {
+        mixed[tile] = true;
+      }
+      numberOfLabeledPixels[tile] += length;
+    });
+
+  const typename RegionType::SizeType & regionSize = this->m_TiledRegion.GetSize();
+  for (SizeValueType tile = 0; tile < numberOfTiles; ++tile)
+  {
+    if (numberOfLabeledPixels[tile] == 0 || this->m_TileFirstPixel[tile] != NotResident)
+    {
+      continue;
+    }
+    // The tiles along the upper borders of the region are partly outside of it
+    SizeValueType pixelsInRegion = 1;
+    SizeValueType remainder = tile;
+    for (unsigned int dim = Dimension; dim-- > 0;)
+    {
+      const SizeValueType first = (remainder / this->m_TileStrides[dim]) * this->m_TileEdge;
+      remainder %= this->m_TileStrides[dim];
+      pixelsInRegion *= std::min(this->m_TileEdge, static_cast<SizeValueType>(regionSize[dim]) - first);
+    }
+    if (mixed[tile] || numberOfLabeledPixels[tile] != pixelsInRegion)
+    {
+      makeResident(tile);
+    }
+  }
+
+  // Fill the resident tiles with the status of the label map, and with the
+  // values of the layers or the status elsewhere
+  this->m_ResidentStatus.assign(this->m_NumberOfResidentTiles * pixelsPerTile, background);
+  this->VisitLabelMapLinesInTiles(
+    [this](const LayerIdType label, const SizeValueType tile, const SizeValueType pixel, const SizeValueType length) {
+      const SizeValueType firstPixel = this->m_TileFirstPixel[tile];
+      if (firstPixel != NotResident)
+      {
+        std::fill_n(this->m_ResidentStatus.begin() + firstPixel + pixel, length, label);
+      }
+    });
+
+  this->m_ResidentValues.resize(this->m_ResidentStatus.size());
+  std::transform(this->m_ResidentStatus.cbegin(),
+                 this->m_ResidentStatus.cend(),
+                 this->m_ResidentValues.begin(),
+                 [](const LayerIdType status) { return static_cast<OutputType>(status); });
+  for (const auto & layer : this->m_Layers)
+  {
+    for (const auto & node : layer.second)
+    {
+      SizeValueType tile;
+      SizeValueType pixel;
+      this->LocateInActiveTiles(node.first, tile, pixel);
+      this->m_ResidentValues[this->m_TileFirstPixel[tile] + pixel] = node.second;
+    }
+  }
+
+  this->m_ActiveTilesAreUpToDate = true;
+}
+
+
+template <typename TOutput, unsigned int VDimension>
+SizeValueType
+LevelSetSparseImage<TOutput, VDimension>::GetActiveTileNumber(const InputType & inputIndex) const
+{
+  SizeValueType tile = 0;
+  SizeValueType pixel = 0;
+  this->LocateInActiveTiles(inputIndex - this->m_DomainOffset, tile, pixel);
+  return tile;
+}
+
+
+template <typename TOutput, unsigned int VDimension>
+bool
+LevelSetSparseImage<TOutput, VDimension>::LocateInActiveTiles(const InputType & mapIndex,
+                                                              SizeValueType &   tile,
+                                                              SizeValueType &   pixel) const
+{
+  tile = 0;
+  pixel = 0;
+  for (unsigned int dim = 0; dim < Dimension; ++dim)
+  {
+    const OffsetValueType position = mapIndex[dim] - this->m_TiledRegion.GetIndex(dim);
+    if (position < 0 || position >= static_cast<OffsetValueType>(this->m_TiledRegion.GetSize(dim)))
+    {
+      return false;
+    }
+    const auto unsignedPosition = static_cast<SizeValueType>(position);
+    tile += (unsignedPosition / this->m_TileEdge) * this->m_TileStrides[dim];
+    pixel += (unsignedPosition % this->m_TileEdge) * this->m_PixelStrides[dim];
+  }
+  return true;
+}
+
+
+template <typename TOutput, unsigned int VDimension>
+bool
+LevelSetSparseImage<TOutput, VDimension>::FindInActiveTiles(const InputType & mapIndex,
+                                                            LayerIdType &     status,
+                                                            OutputType &      value) const
+{
+  SizeValueType tile;
+  SizeValueType pixel;
+  if (!this->HasActiveTiles() || !this->LocateInActiveTiles(mapIndex, tile, pixel))
+  {
+    return false;
+  }
+  const SizeValueType firstPixel = this->m_TileFirstPixel[tile];
+  if (firstPixel == NotResident)
+  {
+    status = this->m_TileStatus[tile];
+    value = static_cast<OutputType>(status);
+  }
+  else
+  {
+    status = this->m_ResidentStatus[firstPixel + pixel];
+    value = this->m_ResidentValues[firstPixel + pixel];
+  }
+  return true;
+}
+
+
+template <typename TOutput, unsigned int VDimension>
+template <typename TFunction>
+void
+LevelSetSparseImage<TOutput, VDimension>::VisitLabelMapLinesInTiles(TFunction function) const
+{
+  const InputType & regionIndex = this->m_TiledRegion.GetIndex();
+
+  for (typename LabelMapType::ConstIterator it(this->m_LabelMap); !it.IsAtEnd(); ++it)
+  {
+    const LabelObjectType * labelObject = it.GetLabelObject();
+    const LayerIdType       label = labelObject->GetLabel();
+    const SizeValueType     numberOfLines = labelObject->GetNumberOfLines();
+
+    for (SizeValueType i = 0; i < numberOfLines; ++i)
+    {
+      const LabelObjectLineType & line = labelObject->GetLine(i);
+      const InputType &           lineIndex = line.GetIndex();
+
+      // The lines run along the first dimension: the other ones select the
+      // row of tiles and the row of pixels in them
+      SizeValueType rowTile = 0;
+      SizeValueType rowPixel = 0;
+      for (unsigned int dim = 1; dim < Dimension; ++dim)
+      {
+        const auto position = static_cast<SizeValueType>(lineIndex[dim] - regionIndex[dim]);
+        rowTile += (position / this->m_TileEdge) * this->m_TileStrides[dim];
+        rowPixel += (position % this->m_TileEdge) * this->m_PixelStrides[dim];
+      }
+
+      auto                position = static_cast<SizeValueType>(lineIndex[0] - regionIndex[0]);
+      const SizeValueType end = position + line.GetLength();
+      while (position < end)
+      {
+        const SizeValueType column = position / this->m_TileEdge;
+        const SizeValueType pieceEnd = std::min(end, (column + 1) * this->m_TileEdge);
+        function(label, rowTile + column, rowPixel + position - column * this->m_TileEdge, pieceEnd - position);
+        position = pieceEnd;
+      }
+    }
+  }
+}
+
 } // end namespace itk
 
 #endif // itkLevelSetSparseImage_h
@@ -36,7 +36,15 @@ auto
 MalcolmSparseLevelSetImage<VDimension>::Evaluate(const InputType & inputPixel) const -> OutputType
 {
   const InputType mapIndex = inputPixel - this->m_DomainOffset;
-  auto            layerIt = this->m_Layers.begin();
+
+  LayerIdType tileStatus;
+  OutputType  tileValue;
+  if (this->FindInActiveTiles(mapIndex, tileStatus, tileValue))
+  {
+    return tileValue;
+  }
+
+  auto layerIt = this->m_Layers.begin();
 
   while (layerIt != this->m_Layers.end())
   {
@@ -0,0 +1,159 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBinaryImageToLevelSetImageAdaptor.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkLevelSetContainer.h"
+#include "itkLevelSetEquationChanAndVeseExternalTerm.h"
+#include "itkLevelSetEquationChanAndVeseInternalTerm.h"
+#include "itkLevelSetEquationContainer.h"
+#include "itkLevelSetEquationCurvatureTerm.h"
+#include "itkLevelSetEquationTermContainer.h"
+#include "itkLevelSetEvolution.h"
+#include "itkLevelSetEvolutionNumberOfIterationsStoppingCriterion.h"
+#include "itkSinRegularizedHeavisideStepFunction.h"
+#include "itkTestBenchmarkWorkUnits.h"
+#include "itkTimeProbe.h"
+
+
+// Time the evolution of a 3D Whitaker sparse level set without the active
+// tiles, then with them for a growing number of work units, up to the number
+// of threads of the machine by default. This is not part of the tests that run
+// by default; run it with
+//   ctest -C Benchmark -R itkSparseLevelSetsv4ActiveTilesBenchmark
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using InputImageType = itk::Image<unsigned short, Dimension>;
+using LevelSetType = itk::WhitakerSparseLevelSetImage<float, Dimension>;
+using LevelSetContainerType = itk::LevelSetContainer<itk::IdentifierType, LevelSetType>;
+using TermContainerType = itk::LevelSetEquationTermContainer<InputImageType, LevelSetContainerType>;
+using EquationContainerType = itk::LevelSetEquationContainer<TermContainerType>;
+using EvolutionType = itk::LevelSetEvolution<EquationContainerType, LevelSetType>;
+
+// Evolve the level set of the binary image with the Chan and Vese and the
+// curvature terms for 10 iterations, and return the time taken by the
+// evolution
+double
+Evolve(InputImageType *  input,
+       InputImageType *  binary,
+       bool              useActiveTiles,
+       itk::ThreadIdType numberOfWorkUnits)
+{
+  auto adaptor = itk::BinaryImageToLevelSetImageAdaptor<InputImageType, LevelSetType>::New();
+  adaptor->SetInputImage(binary);
+  adaptor->Initialize();
+  const LevelSetType::Pointer levelSet = adaptor->GetModifiableLevelSet();
+  levelSet->SetUseActiveTiles(useActiveTiles);
+
+  using OutputRealType = LevelSetType::OutputRealType;
+  auto heaviside = itk::SinRegularizedHeavisideStepFunction<OutputRealType, OutputRealType>::New();
+  heaviside->SetEpsilon(1.0);
+  auto levelSetContainer = LevelSetContainerType::New();
+  levelSetContainer->SetHeaviside(heaviside);
+  levelSetContainer->AddLevelSet(0, levelSet, false);
+
+  auto termContainer = TermContainerType::New();
+  termContainer->SetInput(input);
+  termContainer->SetCurrentLevelSetId(0);
+  termContainer->SetLevelSetContainer(levelSetContainer);
+  auto internalTerm = itk::LevelSetEquationChanAndVeseInternalTerm<InputImageType, LevelSetContainerType>::New();
+  internalTerm->SetInput(input);
+  internalTerm->SetCoefficient(1.0);
+  termContainer->AddTerm(0, internalTerm);
+  auto externalTerm = itk::LevelSetEquationChanAndVeseExternalTerm<InputImageType, LevelSetContainerType>::New();
+  externalTerm->SetInput(input);
+  externalTerm->SetCoefficient(1.0);
+  termContainer->AddTerm(1, externalTerm);
+  auto curvatureTerm = itk::LevelSetEquationCurvatureTerm<InputImageType, LevelSetContainerType>::New();
+  curvatureTerm->SetInput(input);
+  curvatureTerm->SetCoefficient(1.0);
+  termContainer->AddTerm(2, curvatureTerm);
+
+  auto equationContainer = EquationContainerType::New();
+  equationContainer->SetLevelSetContainer(levelSetContainer);
+  equationContainer->AddEquation(0, termContainer);
+
+  auto criterion = itk::LevelSetEvolutionNumberOfIterationsStoppingCriterion<LevelSetContainerType>::New();
+  criterion->SetNumberOfIterations(10);
+
+  auto evolution = EvolutionType::New();
+  evolution->SetEquationContainer(equationContainer);
+  evolution->SetStoppingCriterion(criterion);
+  evolution->SetLevelSetContainer(levelSetContainer);
+  evolution->SetAlpha(0.9);
+  evolution->SetNumberOfWorkUnits(numberOfWorkUnits);
+
+  itk::TimeProbe timeProbe;
+  timeProbe.Start();
+  evolution->Update();
+  timeProbe.Stop();
+  return timeProbe.GetTotal();
+}
+} // namespace
+
+
+int
+itkSparseLevelSetActiveTilesBenchmark(int argc, char * argv[])
+{
+  itk::Testing::BenchmarkWorkUnitsArguments arguments;
+  if (!itk::Testing::ParseBenchmarkWorkUnitsArguments(argc, argv, 64, 1, arguments))
+  {
+    return EXIT_FAILURE;
+  }
+  const itk::SizeValueType size = arguments.size;
+
+  // A bright ball in a dark image, and a box that overlaps it as the initial
+  // level set
+  auto input = InputImageType::New();
+  input->SetRegions(InputImageType::SizeType::Filled(size));
+  input->Allocate();
+  auto binary = InputImageType::New();
+  binary->SetRegions(InputImageType::SizeType::Filled(size));
+  binary->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<InputImageType> it(input, input->GetLargestPossibleRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    double squaredRadius = 0.0;
+    bool   insideBox = true;
+    for (unsigned int dim = 0; dim < Dimension; ++dim)
+    {
+      const itk::IndexValueType index = it.GetIndex()[dim];
+      squaredRadius += (index - 0.5 * size) * (index - 0.5 * size);
+      insideBox = insideBox && index >= static_cast<itk::IndexValueType>(size / 5) &&
+                  index < static_cast<itk::IndexValueType>(size / 2);
+    }
+    it.Set(squaredRadius < size * size / 9.0 ? 200 : 20);
+    binary->SetPixel(it.GetIndex(), insideBox ? 1 : 0);
+  }
+
+  std::cout << "Image of " << size << "^3 pixels, 10 iterations, mean of " << arguments.numberOfRepetitions << " runs"
+            << std::endl;
+  double withoutTilesSeconds = 0.0;
+  for (unsigned int i = 0; i < arguments.numberOfRepetitions; ++i)
+  {
+    withoutTilesSeconds += Evolve(input, binary, false, 1) / arguments.numberOfRepetitions;
+  }
+  std::cout << "Without tiles: " << withoutTilesSeconds << " s" << std::endl;
+  itk::Testing::BenchmarkWorkUnits(
+    arguments,
+    [&input, &binary](unsigned int numberOfWorkUnits) { return Evolve(input, binary, true, numberOfWorkUnits); },
+    withoutTilesSeconds);
+
+  return EXIT_SUCCESS;
+}
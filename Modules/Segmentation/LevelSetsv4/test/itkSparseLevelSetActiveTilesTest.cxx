@@ -0,0 +1,271 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBinaryImageToLevelSetImageAdaptor.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkIndexRange.h"
+#include "itkLevelSetContainer.h"
+#include "itkLevelSetEquationChanAndVeseExternalTerm.h"
+#include "itkLevelSetEquationChanAndVeseInternalTerm.h"
+#include "itkLevelSetEquationContainer.h"
+#include "itkLevelSetEquationCurvatureTerm.h"
+#include "itkLevelSetEquationTermContainer.h"
+#include "itkLevelSetEvolution.h"
+#include "itkLevelSetEvolutionNumberOfIterationsStoppingCriterion.h"
+#include "itkSinRegularizedHeavisideStepFunction.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// A bright ball in a dark image, and a box that overlaps it as the initial
+// level set
+template <unsigned int VDimension>
+void
+MakeImages(unsigned int                                        size,
+           typename itk::Image<unsigned short, VDimension>::Pointer & input,
+           typename itk::Image<unsigned short, VDimension>::Pointer & binary)
+{
+  using ImageType = itk::Image<unsigned short, VDimension>;
+  input = ImageType::New();
+  input->SetRegions(ImageType::SizeType::Filled(size));
+  input->Allocate();
+  binary = ImageType::New();
+  binary->SetRegions(ImageType::SizeType::Filled(size));
+  binary->Allocate();
+
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(input, input->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    double squaredRadius = 0.0;
+    bool   insideBox = true;
+    for (unsigned int dim = 0; dim < VDimension; ++dim)
+    {
+      const double position = it.GetIndex()[dim] - 0.5 * size;
+      squaredRadius += position * position;
+      insideBox = insideBox && it.GetIndex()[dim] >= static_cast<itk::IndexValueType>(size / 5) &&
+                  it.GetIndex()[dim] < static_cast<itk::IndexValueType>(size / 2);
+    }
+    it.Set(squaredRadius < size * size / 9.0 ? 200 : 20);
+    binary->SetPixel(it.GetIndex(), insideBox ? 1 : 0);
+  }
+}
+
+template <typename TLevelSet>
+typename TLevelSet::Pointer
+MakeLevelSet(itk::Image<unsigned short, TLevelSet::Dimension> * binary)
+{
+  using AdaptorType =
+    itk::BinaryImageToLevelSetImageAdaptor<itk::Image<unsigned short, TLevelSet::Dimension>, TLevelSet>;
+  auto adaptor = AdaptorType::New();
+  adaptor->SetInputImage(binary);
+  adaptor->Initialize();
+  return adaptor->GetModifiableLevelSet();
+}
+
+template <typename TLevelSet>
+using EvolutionType = itk::LevelSetEvolution<
+  itk::LevelSetEquationContainer<
+    itk::LevelSetEquationTermContainer<itk::Image<unsigned short, TLevelSet::Dimension>,
+                                       itk::LevelSetContainer<itk::IdentifierType, TLevelSet>>>,
+  TLevelSet>;
+
+// Set up the evolution of a level set with the Chan and Vese terms, and the
+// curvature term for the representation of Whitaker
+template <typename TLevelSet>
+typename EvolutionType<TLevelSet>::Pointer
+MakeEvolution(itk::Image<unsigned short, TLevelSet::Dimension> * input,
+              itk::Image<unsigned short, TLevelSet::Dimension> * binary,
+              bool                                               useActiveTiles,
+              unsigned int                                       numberOfIterations)
+{
+  constexpr unsigned int Dimension = TLevelSet::Dimension;
+  using InputImageType = itk::Image<unsigned short, Dimension>;
+  using LevelSetContainerType = itk::LevelSetContainer<itk::IdentifierType, TLevelSet>;
+  using TermContainerType = itk::LevelSetEquationTermContainer<InputImageType, LevelSetContainerType>;
+  using EquationContainerType = itk::LevelSetEquationContainer<TermContainerType>;
+  using OutputRealType = typename TLevelSet::OutputRealType;
+  constexpr bool isWhitaker =
+    std::is_same_v<TLevelSet, itk::WhitakerSparseLevelSetImage<typename TLevelSet::OutputType, Dimension>>;
+
+  const typename TLevelSet::Pointer levelSet = MakeLevelSet<TLevelSet>(binary);
+  levelSet->SetUseActiveTiles(useActiveTiles);
+  levelSet->SetActiveTileSize(Dimension == 2 ? 16 : 8);
+
+  auto heaviside = itk::SinRegularizedHeavisideStepFunction<OutputRealType, OutputRealType>::New();
+  heaviside->SetEpsilon(1.0);
+  auto levelSetContainer = LevelSetContainerType::New();
+  levelSetContainer->SetHeaviside(heaviside);
+  levelSetContainer->AddLevelSet(0, levelSet, false);
+
+  auto termContainer = TermContainerType::New();
+  termContainer->SetInput(input);
+  termContainer->SetCurrentLevelSetId(0);
+  termContainer->SetLevelSetContainer(levelSetContainer);
+
+  auto internalTerm = itk::LevelSetEquationChanAndVeseInternalTerm<InputImageType, LevelSetContainerType>::New();
+  internalTerm->SetInput(input);
+  internalTerm->SetCoefficient(1.0);
+  termContainer->AddTerm(0, internalTerm);
+  auto externalTerm = itk::LevelSetEquationChanAndVeseExternalTerm<InputImageType, LevelSetContainerType>::New();
+  externalTerm->SetInput(input);
+  externalTerm->SetCoefficient(1.0);
+  termContainer->AddTerm(1, externalTerm);
+  if constexpr (isWhitaker)
+  {
+    auto curvatureTerm = itk::LevelSetEquationCurvatureTerm<InputImageType, LevelSetContainerType>::New();
+    curvatureTerm->SetInput(input);
+    curvatureTerm->SetCoefficient(1.0);
+    termContainer->AddTerm(2, curvatureTerm);
+  }
+
+  auto equationContainer = EquationContainerType::New();
+  equationContainer->SetLevelSetContainer(levelSetContainer);
+  equationContainer->AddEquation(0, termContainer);
+
+  auto criterion = itk::LevelSetEvolutionNumberOfIterationsStoppingCriterion<LevelSetContainerType>::New();
+  criterion->SetNumberOfIterations(numberOfIterations);
+
+  auto evolution = EvolutionType<TLevelSet>::New();
+  evolution->SetEquationContainer(equationContainer);
+  evolution->SetStoppingCriterion(criterion);
+  evolution->SetLevelSetContainer(levelSetContainer);
+  evolution->SetAlpha(0.9);
+
+  return evolution;
+}
+
+template <typename TLevelSet>
+typename TLevelSet::Pointer
+GetEvolvedLevelSet(EvolutionType<TLevelSet> * evolution)
+{
+  evolution->Update();
+  return evolution->GetModifiableLevelSetContainer()->GetLevelSet(0);
+}
+
+// The status and the value of the level sets are the same at every pixel
+template <typename TLevelSet>
+bool
+SameEverywhere(const TLevelSet *                              expected,
+               const TLevelSet *                              levelSet,
+               const itk::ImageRegion<TLevelSet::Dimension> & region)
+{
+  for (const auto & index : itk::ImageRegionIndexRange<TLevelSet::Dimension>(region))
+  {
+    if (levelSet->Status(index) != expected->Status(index) || levelSet->Evaluate(index) != expected->Evaluate(index))
+    {
+      std::cerr << "At " << index << " status " << static_cast<int>(levelSet->Status(index)) << " and value "
+                << static_cast<double>(levelSet->Evaluate(index)) << " instead of "
+                << static_cast<int>(expected->Status(index)) << " and "
+                << static_cast<double>(expected->Evaluate(index)) << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TLevelSet>
+int
+TestRepresentation(unsigned int size)
+{
+  constexpr unsigned int Dimension = TLevelSet::Dimension;
+  constexpr unsigned int numberOfIterations = 5;
+  constexpr bool         isWhitaker =
+    std::is_same_v<TLevelSet, itk::WhitakerSparseLevelSetImage<typename TLevelSet::OutputType, Dimension>>;
+  using ImageType = itk::Image<unsigned short, Dimension>;
+  typename ImageType::Pointer input;
+  typename ImageType::Pointer binary;
+  MakeImages<Dimension>(size, input, binary);
+  const typename ImageType::RegionType region = input->GetLargestPossibleRegion();
+
+  // The tiles hold the initial level set, whatever their size
+  const typename TLevelSet::Pointer initial = MakeLevelSet<TLevelSet>(binary);
+  for (const itk::SizeValueType tileSize : { 1, 3, 8, 1000 })
+  {
+    const typename TLevelSet::Pointer tiled = MakeLevelSet<TLevelSet>(binary);
+    tiled->UseActiveTilesOn();
+    tiled->SetActiveTileSize(tileSize);
+    tiled->UpdateActiveTiles();
+    ITK_TEST_EXPECT_TRUE(tiled->HasActiveTiles());
+    ITK_TEST_EXPECT_TRUE(SameEverywhere<TLevelSet>(initial, tiled, region));
+  }
+  ITK_TEST_EXPECT_TRUE(!initial->HasActiveTiles());
+
+  // Setting the label map discards them
+  {
+    const typename TLevelSet::Pointer tiled = MakeLevelSet<TLevelSet>(binary);
+    tiled->UseActiveTilesOn();
+    tiled->UpdateActiveTiles();
+    tiled->SetLabelMap(tiled->GetModifiableLabelMap());
+    ITK_TEST_EXPECT_TRUE(!tiled->HasActiveTiles());
+  }
+
+  // The evolution gives the same level set with the tiles. Only the evolution
+  // of Whitaker keeps them up to date after the last iteration, and computes
+  // the updates of the tiles concurrently, whatever the number of work units;
+  // the updaters of Shi and Malcolm modify the layers in place, which
+  // discards them.
+  const typename TLevelSet::Pointer expected =
+    GetEvolvedLevelSet<TLevelSet>(MakeEvolution<TLevelSet>(input, binary, false, numberOfIterations));
+  if constexpr (isWhitaker)
+  {
+    for (const itk::ThreadIdType numberOfWorkUnits : { 1, 2, 5 })
+    {
+      const auto evolution = MakeEvolution<TLevelSet>(input, binary, true, numberOfIterations);
+      evolution->SetNumberOfWorkUnits(numberOfWorkUnits);
+      const typename TLevelSet::Pointer levelSet = GetEvolvedLevelSet<TLevelSet>(evolution);
+      ITK_TEST_EXPECT_TRUE(levelSet->HasActiveTiles());
+      ITK_TEST_EXPECT_TRUE(SameEverywhere<TLevelSet>(expected, levelSet, region));
+    }
+  }
+  else
+  {
+    const typename TLevelSet::Pointer levelSet =
+      GetEvolvedLevelSet<TLevelSet>(MakeEvolution<TLevelSet>(input, binary, true, numberOfIterations));
+    ITK_TEST_EXPECT_TRUE(!levelSet->HasActiveTiles());
+    ITK_TEST_EXPECT_TRUE(SameEverywhere<TLevelSet>(expected, levelSet, region));
+  }
+
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkSparseLevelSetActiveTilesTest(int, char *[])
+{
+  int testStatus = EXIT_SUCCESS;
+  ITK_TEST_EXPECT_TRUE_STATUS_VALUE(
+    (TestRepresentation<itk::WhitakerSparseLevelSetImage<float, 2>>(64) == EXIT_SUCCESS), testStatus);
+  ITK_TEST_EXPECT_TRUE_STATUS_VALUE(
+    (TestRepresentation<itk::WhitakerSparseLevelSetImage<float, 3>>(24) == EXIT_SUCCESS), testStatus);
+  ITK_TEST_EXPECT_TRUE_STATUS_VALUE((TestRepresentation<itk::ShiSparseLevelSetImage<2>>(64) == EXIT_SUCCESS),
+                                    testStatus);
+  ITK_TEST_EXPECT_TRUE_STATUS_VALUE((TestRepresentation<itk::ShiSparseLevelSetImage<3>>(24) == EXIT_SUCCESS),
+                                    testStatus);
+  ITK_TEST_EXPECT_TRUE_STATUS_VALUE((TestRepresentation<itk::MalcolmSparseLevelSetImage<2>>(64) == EXIT_SUCCESS),
+                                    testStatus);
+  ITK_TEST_EXPECT_TRUE_STATUS_VALUE((TestRepresentation<itk::MalcolmSparseLevelSetImage<3>>(24) == EXIT_SUCCESS),
+                                    testStatus);
+
+  if (testStatus != EXIT_SUCCESS)
+  {
+    return testStatus;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
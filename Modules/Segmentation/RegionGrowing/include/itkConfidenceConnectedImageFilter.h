@@ -53,6 +53,10 @@ namespace itk
  * NOTE: the lower and upper threshold are restricted to lie within the
  * valid numeric limits of the input data pixel type. Also, the limits
  * may be adjusted to contain the seed point's intensity.
+ *
+ * The segmentations are flooded by ScanlineFloodFill, and their statistics
+ * computed, on the work units of the filter.
+ *
  * \ingroup RegionGrowingSegmentation
  * \ingroup ITKRegionGrowing
  *
@@ -23,11 +23,10 @@
 #include "itkImageRegionIterator.h"
 #include "itkImageNeighborhoodOffsets.h"
 #include "itkShapedImageNeighborhoodRange.h"
-#include "itkBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
-#include "itkProgressReporter.h"
+#include "itkScanlineFloodFill.h"
+#include "itkTotalProgressReporter.h"
 #include "itkPrintHelper.h"
-#include <algorithm> // For min and max.
+#include <algorithm> // For min, max and sort.
 
 namespace itk
 {
@@ -118,12 +117,6 @@ template <typename TInputImage, typename TOutputImage>
 void
 ConfidenceConnectedImageFilter<TInputImage, TOutputImage>::GenerateData()
 {
-  using FunctionType = BinaryThresholdImageFunction<InputImageType, double>;
-  using SecondFunctionType = BinaryThresholdImageFunction<OutputImageType, double>;
-
-  using IteratorType = FloodFilledImageFunctionConditionalIterator<OutputImageType, FunctionType>;
-  using SecondIteratorType = FloodFilledImageFunctionConditionalConstIterator<InputImageType, SecondFunctionType>;
-
   const typename Superclass::InputImageConstPointer inputImage = this->GetInput();
   const typename Superclass::OutputImagePointer     outputImage = this->GetOutput();
 
@@ -134,9 +127,6 @@ ConfidenceConnectedImageFilter<TInputImage, TOutputImage>::GenerateData()
 
   // Compute the statistics of the seed point
 
-  // Set up the image function used for connectivity
-  auto function = FunctionType::New();
-  function->SetInputImage(inputImage);
   m_Mean = InputRealType{};
   m_Variance = InputRealType{};
 
@@ -260,54 +250,100 @@ ConfidenceConnectedImageFilter<TInputImage, TOutputImage>::GenerateData()
   lower = std::max(lower, static_cast<InputRealType>(NumericTraits<InputImagePixelType>::NonpositiveMin()));
   upper = std::min(upper, static_cast<InputRealType>(NumericTraits<InputImagePixelType>::max()));
 
-  function->ThresholdBetween(static_cast<InputImagePixelType>(lower), static_cast<InputImagePixelType>(upper));
+  InputImagePixelType lowerThreshold = static_cast<InputImagePixelType>(lower);
+  InputImagePixelType upperThreshold = static_cast<InputImagePixelType>(upper);
+  const auto          isWithinThresholds = [inputImage, &lowerThreshold, &upperThreshold](const IndexType & index) {
+    const InputImagePixelType value = inputImage->GetPixel(index);
+    return lowerThreshold <= value && value <= upperThreshold;
+  };
 
   itkDebugMacro("\nLower intensity = " << lower << ", Upper intensity = " << upper << "\nmean = " << m_Mean
                                        << " , std::sqrt(variance) = " << std::sqrt(m_Variance));
 
-  // Segment the image, the iterator walks the output image (so Set()
-  // writes into the output image), starting at the seed point.  As
-  // the iterator walks, if the corresponding pixel in the input image
-  // (accessed via the "function" assigned to the iterator) is within
-  // the [lower, upper] bounds prescribed, the pixel is added to the
-  // output segmentation and its neighbors become candidates for the
-  // iterator to walk.
-  IteratorType it(outputImage, function, m_Seeds);
-  it.GoToBegin();
-  while (!it.IsAtEnd())
-  {
-    it.Set(m_ReplaceValue);
-    ++it;
-  }
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  // Only the seeds within the thresholds start the flood
+  SeedsContainerType seeds;
+  SeedsContainerType sortedSeeds;
+  const auto         selectSeeds = [&]() {
+    seeds.clear();
+    for (const IndexType & seed : m_Seeds)
+    {
+      if (region.IsInside(seed) && isWithinThresholds(seed))
+      {
+        seeds.push_back(seed);
+      }
+    }
+    sortedSeeds = seeds;
+    std::sort(sortedSeeds.begin(), sortedSeeds.end());
+  };
+
+  // Segment the image, starting at the seed points. The pixels connected to
+  // a seed whose values in the input image are within the [lower, upper]
+  // bounds prescribed are added to the segmentation.
+  ScanlineFloodFill<InputImageType::ImageDimension> floodFill(region, false, multiThreader);
+  selectSeeds();
+  floodFill.Fill(seeds, isWithinThresholds);
+
+  // The statistics of the segmentation are accumulated over fixed blocks of
+  // runs, so that they do not depend on the number of work units
+  constexpr SizeValueType    runsPerBlock = 1024;
+  std::vector<InputRealType> blockSums;
+  std::vector<InputRealType> blockSumsOfSquares;
 
-  ProgressReporter progress(this, 0, region.GetNumberOfPixels() * m_NumberOfIterations);
+  TotalProgressReporter progress(this, region.GetNumberOfPixels() * m_NumberOfIterations);
 
   for (unsigned int loop = 0; loop < m_NumberOfIterations; ++loop)
   {
     // Now that we have an initial segmentation, let's recalculate the
-    // statistics.  Since we have already labelled the output, we visit
-    // pixels in the input image that have been set in the output image.
-    // Essentially, we flip the iterator around, so we walk the input
-    // image (so Get() will get pixel values from the input) and constrain
-    // iterator such it only visits pixels that were set in the output.
-    auto secondFunction = SecondFunctionType::New();
-    secondFunction->SetInputImage(outputImage);
-    secondFunction->ThresholdBetween(m_ReplaceValue, m_ReplaceValue);
-
-    InputRealType                        sum{};
-    InputRealType                        sumOfSquares{};
-    typename TOutputImage::SizeValueType numberOfSamples = 0;
-
-    SecondIteratorType sit(inputImage, secondFunction, m_Seeds);
-    sit.GoToBegin();
-    while (!sit.IsAtEnd())
+    // statistics over the pixels of the input image that are in it.
+    const auto &        runs = floodFill.GetRuns();
+    const SizeValueType numberOfBlocks = (runs.size() + runsPerBlock - 1) / runsPerBlock;
+    blockSums.assign(numberOfBlocks, InputRealType{});
+    blockSumsOfSquares.assign(numberOfBlocks, InputRealType{});
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [&](SizeValueType block) {
+        const SizeValueType last = std::min((block + 1) * runsPerBlock, static_cast<SizeValueType>(runs.size()));
+        for (SizeValueType i = block * runsPerBlock; i < last; ++i)
+        {
+          const InputImagePixelType * pixel =
+            inputImage->GetBufferPointer() + inputImage->ComputeOffset(runs[i].m_Index);
+          for (SizeValueType j = 0; j < runs[i].m_Length; ++j)
+          {
+            const auto value = static_cast<InputRealType>(pixel[j]);
+            blockSums[block] += value;
+            blockSumsOfSquares[block] += value * value;
+          }
+        }
+      },
+      nullptr);
+
+    InputRealType sum{};
+    InputRealType sumOfSquares{};
+    for (SizeValueType block = 0; block < numberOfBlocks; ++block)
     {
-      const auto value = static_cast<InputRealType>(sit.Get());
-      sum += value;
-      sumOfSquares += value * value;
-      ++numberOfSamples;
-      ++sit;
+      sum += blockSums[block];
+      sumOfSquares += blockSumsOfSquares[block];
     }
+    SizeValueType numberOfSamples = floodFill.GetNumberOfFilledPixels();
+
+    // The flood filled iterator that used to walk the segmentation started
+    // once at each seed in it, so a seed listed more than once was sampled
+    // as many times.
+    for (auto seed = sortedSeeds.begin(); seed != sortedSeeds.end(); ++seed)
+    {
+      if (seed != sortedSeeds.begin() && *seed == *(seed - 1))
+      {
+        const auto value = static_cast<InputRealType>(inputImage->GetPixel(*seed));
+        sum += value;
+        sumOfSquares += value * value;
+        ++numberOfSamples;
+      }
+    }
+
     m_Mean = sum / static_cast<double>(numberOfSamples);
     m_Variance = (sumOfSquares - (sum * sum / static_cast<double>(numberOfSamples))) /
                  (static_cast<double>(numberOfSamples) - 1.0);
@@ -340,31 +376,19 @@ ConfidenceConnectedImageFilter<TInputImage, TOutputImage>::GenerateData()
     lower = std::max(lower, static_cast<InputRealType>(NumericTraits<InputImagePixelType>::NonpositiveMin()));
     upper = std::min(upper, static_cast<InputRealType>(NumericTraits<InputImagePixelType>::max()));
 
-    function->ThresholdBetween(static_cast<InputImagePixelType>(lower), static_cast<InputImagePixelType>(upper));
+    lowerThreshold = static_cast<InputImagePixelType>(lower);
+    upperThreshold = static_cast<InputImagePixelType>(upper);
 
     itkDebugMacro("\nLower intensity = " << lower << ", Upper intensity = " << upper << "\nmean = " << m_Mean
                                          << ", variance = " << m_Variance
                                          << " , std::sqrt(variance) = " << std::sqrt(m_Variance));
     itkDebugMacro("\nsum = " << sum << ", sumOfSquares = " << sumOfSquares << "\nnum = " << numberOfSamples);
 
-    // Rerun the segmentation, the iterator walks the output image,
-    // starting at the seed point.  As the iterator walks, if the
-    // corresponding pixel in the input image (accessed via the
-    // "function" assigned to the iterator) is within the [lower,
-    // upper] bounds prescribed, the pixel is added to the output
-    // segmentation and its neighbors become candidates for the
-    // iterator to walk.
-    outputImage->FillBuffer(OutputImagePixelType{});
-    IteratorType thirdIt(outputImage, function, m_Seeds);
-    thirdIt.GoToBegin();
+    // Rerun the segmentation with the refined bounds
+    selectSeeds();
     try
     {
-      while (!thirdIt.IsAtEnd())
-      {
-        thirdIt.Set(m_ReplaceValue);
-        ++thirdIt;
-        progress.CompletedPixel(); // potential exception thrown here
-      }
+      floodFill.Fill(seeds, isWithinThresholds, &progress);
     }
     catch (const ProcessAborted &)
     {
@@ -379,6 +403,8 @@ ConfidenceConnectedImageFilter<TInputImage, TOutputImage>::GenerateData()
     e.SetDescription("Process aborted.");
     throw ProcessAborted(__FILE__, __LINE__);
   }
+
+  floodFill.Paint(outputImage.GetPointer(), m_ReplaceValue);
 }
 } // end namespace itk
 
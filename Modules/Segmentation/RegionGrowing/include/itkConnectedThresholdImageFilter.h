@@ -58,6 +58,9 @@ operator<<(std::ostream & out, const ConnectedThresholdImageFilterEnums::Connect
  * connected to an initial Seed AND lie within a Lower and Upper
  * threshold range.
  *
+ * The region is flooded by ScanlineFloodFill, on the work units of the
+ * filter.
+ *
  * \ingroup RegionGrowingSegmentation
  * \ingroup ITKRegionGrowing
  * \sphinx
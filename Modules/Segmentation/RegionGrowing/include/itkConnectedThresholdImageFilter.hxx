@@ -18,11 +18,8 @@
 #ifndef itkConnectedThresholdImageFilter_hxx
 #define itkConnectedThresholdImageFilter_hxx
 
-#include "itkBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
-#include "itkProgressReporter.h"
-
-#include "itkShapedFloodFilledImageFunctionConditionalIterator.h"
+#include "itkScanlineFloodFill.h"
+#include "itkTotalProgressReporter.h"
 #include "itkMath.h"
 #include "itkPrintHelper.h"
 
@@ -234,46 +231,30 @@ ConnectedThresholdImageFilter<TInputImage, TOutputImage>::GenerateData()
   outputImage->SetBufferedRegion(region);
   outputImage->AllocateInitialized();
 
-  using FunctionType = BinaryThresholdImageFunction<InputImageType, double>;
-
-  auto function = FunctionType::New();
-  function->SetInputImage(inputImage);
-  function->ThresholdBetween(lower, upper);
-
-  ProgressReporter progress(this, 0, region.GetNumberOfPixels());
+  const auto isWithinThresholds = [inputImage, lower, upper](const IndexType & index) {
+    const InputImagePixelType value = inputImage->GetPixel(index);
+    return lower <= value && value <= upper;
+  };
 
-  if (this->m_Connectivity == ConnectivityEnum::FaceConnectivity)
+  // Only the seeds within the thresholds start the flood
+  SeedContainerType seeds;
+  for (const IndexType & seed : m_Seeds)
   {
-    using IteratorType = FloodFilledImageFunctionConditionalIterator<OutputImageType, FunctionType>;
-    IteratorType it(outputImage, function, m_Seeds);
-    it.GoToBegin();
-
-    while (!it.IsAtEnd())
+    if (region.IsInside(seed) && isWithinThresholds(seed))
     {
-      it.Set(m_ReplaceValue);
-      ++it;
-      progress.CompletedPixel(); // potential exception thrown here
+      seeds.push_back(seed);
     }
   }
-  else if (this->m_Connectivity == ConnectivityEnum::FullConnectivity)
-  {
-    // Use the fully connected iterator here. The fully connected iterator
-    // below is a superset of the above. However, it is reported to be 20%
-    // slower. Hence we use this "if" block to use the old iterator when
-    // we don't need full connectivity.
 
-    using IteratorType = ShapedFloodFilledImageFunctionConditionalIterator<OutputImageType, FunctionType>;
-    IteratorType it(outputImage, function, m_Seeds);
-    it.FullyConnectedOn();
-    it.GoToBegin();
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
 
-    while (!it.IsAtEnd())
-    {
-      it.Set(m_ReplaceValue);
-      ++it;
-      progress.CompletedPixel(); // potential exception thrown here
-    }
-  }
+  TotalProgressReporter progress(this, region.GetNumberOfPixels());
+
+  ScanlineFloodFill<InputImageDimension> floodFill(
+    region, m_Connectivity == ConnectivityEnum::FullConnectivity, multiThreader);
+  floodFill.Fill(seeds, isWithinThresholds, &progress);
+  floodFill.Paint(outputImage, m_ReplaceValue);
 }
 
 template <typename TInputImage, typename TOutputImage>
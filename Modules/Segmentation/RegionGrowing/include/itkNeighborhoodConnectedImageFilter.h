@@ -30,6 +30,9 @@ namespace itk
  * are connected to an initial Seed AND whose neighbors all lie within a
  * Lower and Upper threshold range.
  *
+ * The region is flooded by ScanlineFloodFill, on the work units of the
+ * filter.
+ *
  * \ingroup RegionGrowingSegmentation
  * \ingroup ITKRegionGrowing
  */
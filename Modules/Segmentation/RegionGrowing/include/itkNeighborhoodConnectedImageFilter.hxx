@@ -19,8 +19,8 @@
 #define itkNeighborhoodConnectedImageFilter_hxx
 
 #include "itkNeighborhoodBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
-#include "itkProgressReporter.h"
+#include "itkScanlineFloodFill.h"
+#include "itkTotalProgressReporter.h"
 #include "itkPrintHelper.h"
 
 namespace itk
@@ -105,25 +105,28 @@ NeighborhoodConnectedImageFilter<TInputImage, TOutputImage>::GenerateData()
   const typename Superclass::OutputImagePointer     outputImage = this->GetOutput();
 
   // Zero the output
-  outputImage->SetBufferedRegion(outputImage->GetRequestedRegion());
+  const OutputImageRegionType region = outputImage->GetRequestedRegion();
+  outputImage->SetBufferedRegion(region);
   outputImage->AllocateInitialized();
 
   using FunctionType = NeighborhoodBinaryThresholdImageFunction<InputImageType>;
-  using IteratorType = FloodFilledImageFunctionConditionalIterator<OutputImageType, FunctionType>;
 
   auto function = FunctionType::New();
   function->SetInputImage(inputImage);
   function->ThresholdBetween(m_Lower, m_Upper);
   function->SetRadius(m_Radius);
-  IteratorType it(outputImage, function, m_Seeds);
 
-  ProgressReporter progress(this, 0, outputImage->GetRequestedRegion().GetNumberOfPixels());
-  while (!it.IsAtEnd())
-  {
-    it.Set(m_ReplaceValue);
-    ++it;
-    progress.CompletedPixel();
-  }
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+
+  TotalProgressReporter progress(this, region.GetNumberOfPixels());
+
+  // The seeds are labeled even when their neighborhood is not within the
+  // thresholds
+  ScanlineFloodFill<InputImageDimension> floodFill(region, false, multiThreader);
+  floodFill.Fill(
+    m_Seeds, [&function](const IndexType & index) { return function->EvaluateAtIndex(index); }, &progress);
+  floodFill.Paint(outputImage.GetPointer(), m_ReplaceValue);
 }
 } // end namespace itk
 
@@ -0,0 +1,182 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkScanlineFloodFill_h
+#define itkScanlineFloodFill_h
+
+#include "itkImageRegion.h"
+#include "itkMultiThreaderBase.h"
+#include "itkTotalProgressReporter.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class ScanlineFloodFill
+ * \brief Flood fill a region from seeds, one frontier of scanlines at a time
+ *
+ * The filled pixels are kept as runs: consecutive pixels of a row along the
+ * first dimension. The runs that hold the seeds form the first frontier.
+ * Each step scans the rows next to the runs of the frontier for pixels that
+ * satisfy the predicate and are not filled yet, concurrently on the work
+ * units of the multi-threader. Such a pixel is claimed in an atomic bitmap
+ * and grown into a run along its row, and the new runs form the next
+ * frontier. The flood stops when a frontier is empty.
+ *
+ * The filled pixels are those visited by
+ * FloodFilledImageFunctionConditionalIterator (face connectivity) or
+ * ShapedFloodFilledImageFunctionConditionalIterator (full connectivity)
+ * from the same seeds: the seeds inside the region, whether or not they
+ * satisfy the predicate, and the pixels that satisfy it and are connected
+ * to a seed through such pixels. Whatever the number of work units, Fill()
+ * leaves the same runs, in raster order, each as long as it can be.
+ *
+ * The predicate is called concurrently, and may be called more than once
+ * for the same pixel.
+ *
+ * \ingroup RegionGrowingSegmentation
+ * \ingroup ITKRegionGrowing
+ */
+template <unsigned int VImageDimension>
+class ITK_TEMPLATE_EXPORT ScanlineFloodFill
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ScanlineFloodFill);
+
+  static constexpr unsigned int ImageDimension = VImageDimension;
+
+  using IndexType = Index<VImageDimension>;
+  using OffsetType = Offset<VImageDimension>;
+  using RegionType = ImageRegion<VImageDimension>;
+  using SeedContainerType = std::vector<IndexType>;
+
+  /** Consecutive filled pixels along the first dimension, from m_Index. */
+  struct Run
+  {
+    IndexType     m_Index;
+    SizeValueType m_Length;
+  };
+  using RunContainerType = std::vector<Run>;
+
+  /** Prepare to fill the region with face connectivity, or with full
+   * connectivity when fullyConnected is true. The frontiers are scanned on
+   * the work units of the multi-threader, or on the calling thread when it
+   * is nullptr. */
+  ScanlineFloodFill(const RegionType & region, bool fullyConnected, MultiThreaderBase * multiThreader = nullptr);
+
+  /** Fill the pixels connected to the seeds, predicate(index) telling
+   * whether a pixel may be filled, and replace the runs of a previous fill.
+   * The filled pixels of each frontier are reported to the progress, if
+   * any, which throws ProcessAborted when the filter is aborted. */
+  template <typename TPredicate>
+  void
+  Fill(const SeedContainerType & seeds, const TPredicate & predicate, TotalProgressReporter * progress = nullptr);
+
+  /** The runs of the last fill. */
+  const RunContainerType &
+  GetRuns() const
+  {
+    return m_Runs;
+  }
+
+  /** Number of pixels filled by the last fill. */
+  SizeValueType
+  GetNumberOfFilledPixels() const;
+
+  /** Set the filled pixels of an image whose buffered region is the region
+   * to value, concurrently. */
+  template <typename TImage>
+  void
+  Paint(TImage * image, const typename TImage::PixelType & value) const;
+
+private:
+  using WordType = std::uint64_t;
+  using BitmapType = std::vector<std::atomic<WordType>>;
+
+  static constexpr unsigned int BitsPerWord = 64;
+
+  /** Position of a pixel of the region in the bitmaps. */
+  SizeValueType
+  ComputeBit(const IndexType & index) const;
+
+  static bool
+  IsSet(const BitmapType & bitmap, SizeValueType bit)
+  {
+    return (bitmap[bit / BitsPerWord].load(std::memory_order_relaxed) & (WordType{ 1 } << (bit % BitsPerWord))) != 0;
+  }
+
+  /** Set a bit, and tell whether this call is the one that set it. */
+  static bool
+  Claim(BitmapType & bitmap, SizeValueType bit)
+  {
+    const WordType mask = WordType{ 1 } << (bit % BitsPerWord);
+    return (bitmap[bit / BitsPerWord].fetch_or(mask, std::memory_order_relaxed) & mask) == 0;
+  }
+
+  /** Whether a pixel satisfies the predicate and is not filled yet. The
+   * pixels that do not satisfy it are remembered, so that the predicate is
+   * not called for them again. */
+  template <typename TPredicate>
+  bool
+  IsFillable(const IndexType & index, SizeValueType bit, const TPredicate & predicate);
+
+  /** Grow a run along its row from a pixel just claimed, append it to the
+   * runs, and return the index of its last pixel along the row. */
+  template <typename TPredicate>
+  IndexValueType
+  GrowRun(IndexType index, SizeValueType bit, const TPredicate & predicate, RunContainerType & runs);
+
+  /** Append to the runs those found in the rows next to a run. */
+  template <typename TPredicate>
+  void
+  ScanNeighborRows(const Run & run, const TPredicate & predicate, RunContainerType & runs);
+
+  /** Call f(chunk, first, last) for consecutive chunks of [0, count) on the
+   * work units, with at least minimumChunkSize elements per chunk, and
+   * return the number of chunks. */
+  template <typename TFunction>
+  SizeValueType
+  ParallelizeChunks(SizeValueType count, SizeValueType minimumChunkSize, const TFunction & f) const;
+
+  RegionType          m_Region{};
+  bool                m_FullyConnected{ false };
+  MultiThreaderBase * m_MultiThreader{ nullptr };
+
+  /** Range of the region along the rows, last included. */
+  IndexValueType m_RowFirst{ 0 };
+  IndexValueType m_RowLast{ 0 };
+
+  /** Strides of the region in the bitmaps. */
+  OffsetType m_Strides{};
+
+  /** Offsets from a row to the rows next to it, along the first dimension
+   * being zero. */
+  std::vector<OffsetType> m_NeighborRows{};
+
+  BitmapType       m_Filled;
+  BitmapType       m_Rejected;
+  RunContainerType m_Runs{};
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkScanlineFloodFill.hxx"
+#endif
+
+#endif
@@ -0,0 +1,340 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkScanlineFloodFill_hxx
+#define itkScanlineFloodFill_hxx
+
+#include <algorithm>
+
+namespace itk
+{
+template <unsigned int VImageDimension>
+ScanlineFloodFill<VImageDimension>::ScanlineFloodFill(const RegionType &  region,
+                                                      const bool          fullyConnected,
+                                                      MultiThreaderBase * multiThreader)
+  : m_Region(region)
+  , m_FullyConnected(fullyConnected)
+  , m_MultiThreader(multiThreader)
+  , m_Filled((region.GetNumberOfPixels() + BitsPerWord - 1) / BitsPerWord)
+  , m_Rejected(m_Filled.size())
+{
+  m_RowFirst = region.GetIndex(0);
+  m_RowLast = m_RowFirst + static_cast<IndexValueType>(region.GetSize(0)) - 1;
+
+  OffsetValueType stride = 1;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    m_Strides[i] = stride;
+    stride *= static_cast<OffsetValueType>(region.GetSize(i));
+  }
+
+  // With face connectivity, the rows next to a row differ from it along a
+  // single dimension; with full connectivity, along any of them
+  if (ImageDimension > 1)
+  {
+    OffsetType offset{};
+    if (m_FullyConnected)
+    {
+      for (unsigned int i = 1; i < ImageDimension; ++i)
+      {
+        offset[i] = -1;
+      }
+      for (;;)
+      {
+        if (offset != OffsetType{})
+        {
+          m_NeighborRows.push_back(offset);
+        }
+        unsigned int i = 1;
+        while (i < ImageDimension && offset[i] == 1)
+        {
+          offset[i] = -1;
+          ++i;
+        }
+        if (i == ImageDimension)
+        {
+          break;
+        }
+        ++offset[i];
+      }
+    }
+    else
+    {
+      for (unsigned int i = 1; i < ImageDimension; ++i)
+      {
+        for (const OffsetValueType step : { -1, 1 })
+        {
+          offset[i] = step;
+          m_NeighborRows.push_back(offset);
+        }
+        offset[i] = 0;
+      }
+    }
+  }
+}
+
+template <unsigned int VImageDimension>
+template <typename TPredicate>
+void
+ScanlineFloodFill<VImageDimension>::Fill(const SeedContainerType & seeds,
+                                         const TPredicate &        predicate,
+                                         TotalProgressReporter *   progress)
+{
+  this->ParallelizeChunks(m_Filled.size(), 4096, [this](SizeValueType, SizeValueType first, SizeValueType last) {
+    for (SizeValueType word = first; word < last; ++word)
+    {
+      m_Filled[word].store(0, std::memory_order_relaxed);
+      m_Rejected[word].store(0, std::memory_order_relaxed);
+    }
+  });
+  m_Runs.clear();
+
+  RunContainerType frontier;
+  for (const IndexType & seed : seeds)
+  {
+    if (m_Region.IsInside(seed))
+    {
+      const SizeValueType bit = this->ComputeBit(seed);
+      if (Claim(m_Filled, bit))
+      {
+        this->GrowRun(seed, bit, predicate, frontier);
+      }
+    }
+  }
+
+  const SizeValueType           maximumNumberOfChunks = m_MultiThreader ? m_MultiThreader->GetNumberOfWorkUnits() : 1;
+  std::vector<RunContainerType> chunkRuns(maximumNumberOfChunks);
+  while (!frontier.empty())
+  {
+    const SizeValueType numberOfChunks =
+      this->ParallelizeChunks(frontier.size(), 16, [&](SizeValueType chunk, SizeValueType first, SizeValueType last) {
+        for (SizeValueType i = first; i < last; ++i)
+        {
+          this->ScanNeighborRows(frontier[i], predicate, chunkRuns[chunk]);
+        }
+      });
+
+    SizeValueType numberOfPixels = 0;
+    for (const Run & run : frontier)
+    {
+      numberOfPixels += run.m_Length;
+    }
+    m_Runs.insert(m_Runs.end(), frontier.cbegin(), frontier.cend());
+    frontier.clear();
+    for (SizeValueType chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+      frontier.insert(frontier.end(), chunkRuns[chunk].cbegin(), chunkRuns[chunk].cend());
+      chunkRuns[chunk].clear();
+    }
+    if (progress)
+    {
+      progress->Completed(numberOfPixels); // potential exception thrown here
+    }
+  }
+
+  // Work units that race along a row may leave it in several runs: merge
+  // them, so that the runs do not depend on the scheduling
+  std::sort(m_Runs.begin(), m_Runs.end(), [](const Run & a, const Run & b) {
+    for (unsigned int i = ImageDimension; i-- > 0;)
+    {
+      if (a.m_Index[i] != b.m_Index[i])
+      {
+        return a.m_Index[i] < b.m_Index[i];
+      }
+    }
+    return false;
+  });
+  SizeValueType numberOfRuns = 0;
+  for (const Run & run : m_Runs)
+  {
+    if (numberOfRuns > 0)
+    {
+      Run &     previous = m_Runs[numberOfRuns - 1];
+      IndexType end = previous.m_Index;
+      end[0] += static_cast<IndexValueType>(previous.m_Length);
+      if (end == run.m_Index)
+      {
+        previous.m_Length += run.m_Length;
+        continue;
+      }
+    }
+    m_Runs[numberOfRuns++] = run;
+  }
+  m_Runs.resize(numberOfRuns);
+}
+
+template <unsigned int VImageDimension>
+SizeValueType
+ScanlineFloodFill<VImageDimension>::GetNumberOfFilledPixels() const
+{
+  SizeValueType numberOfPixels = 0;
+  for (const Run & run : m_Runs)
+  {
+    numberOfPixels += run.m_Length;
+  }
+  return numberOfPixels;
+}
+
+template <unsigned int VImageDimension>
+template <typename TImage>
+void
+ScanlineFloodFill<VImageDimension>::Paint(TImage * image, const typename TImage::PixelType & value) const
+{
+  typename TImage::PixelType * buffer = image->GetBufferPointer();
+  this->ParallelizeChunks(m_Runs.size(), 256, [&](SizeValueType, SizeValueType first, SizeValueType last) {
+    for (SizeValueType i = first; i < last; ++i)
+    {
+      std::fill_n(buffer + image->ComputeOffset(m_Runs[i].m_Index), m_Runs[i].m_Length, value);
+    }
+  });
+}
+
+template <unsigned int VImageDimension>
+SizeValueType
+ScanlineFloodFill<VImageDimension>::ComputeBit(const IndexType & index) const
+{
+  OffsetValueType bit = 0;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    bit += (index[i] - m_Region.GetIndex(i)) * m_Strides[i];
+  }
+  return static_cast<SizeValueType>(bit);
+}
+
+template <unsigned int VImageDimension>
+template <typename TPredicate>
+bool
+ScanlineFloodFill<VImageDimension>::IsFillable(const IndexType &  index,
+                                               const SizeValueType bit,
+                                               const TPredicate &  predicate)
+{
+  if (IsSet(m_Filled, bit) || IsSet(m_Rejected, bit))
+  {
+    return false;
+  }
+  if (predicate(index))
+  {
+    return true;
+  }
+  Claim(m_Rejected, bit);
+  return false;
+}
+
+template <unsigned int VImageDimension>
+template <typename TPredicate>
+IndexValueType
+ScanlineFloodFill<VImageDimension>::GrowRun(IndexType           index,
+                                            const SizeValueType bit,
+                                            const TPredicate &  predicate,
+                                            RunContainerType &  runs)
+{
+  const IndexValueType x = index[0];
+
+  IndexValueType first = x;
+  SizeValueType  firstBit = bit;
+  index[0] = first - 1;
+  while (first > m_RowFirst && this->IsFillable(index, firstBit - 1, predicate) && Claim(m_Filled, firstBit - 1))
+  {
+    --first;
+    --firstBit;
+    --index[0];
+  }
+
+  IndexValueType last = x;
+  SizeValueType  lastBit = bit;
+  index[0] = last + 1;
+  while (last < m_RowLast && this->IsFillable(index, lastBit + 1, predicate) && Claim(m_Filled, lastBit + 1))
+  {
+    ++last;
+    ++lastBit;
+    ++index[0];
+  }
+
+  index[0] = first;
+  runs.push_back({ index, static_cast<SizeValueType>(last - first + 1) });
+  return last;
+}
+
+template <unsigned int VImageDimension>
+template <typename TPredicate>
+void
+ScanlineFloodFill<VImageDimension>::ScanNeighborRows(const Run &        run,
+                                                     const TPredicate & predicate,
+                                                     RunContainerType & runs)
+{
+  // With full connectivity, the pixels diagonal to the ends of the run are
+  // neighbors as well
+  IndexValueType first = run.m_Index[0];
+  IndexValueType last = first + static_cast<IndexValueType>(run.m_Length) - 1;
+  if (m_FullyConnected)
+  {
+    first = std::max(first - 1, m_RowFirst);
+    last = std::min(last + 1, m_RowLast);
+  }
+
+  for (const OffsetType & neighborRow : m_NeighborRows)
+  {
+    IndexType index = run.m_Index + neighborRow;
+    index[0] = first;
+    if (!m_Region.IsInside(index))
+    {
+      continue;
+    }
+    SizeValueType bit = this->ComputeBit(index);
+    for (IndexValueType x = first; x <= last; ++x, ++bit)
+    {
+      index[0] = x;
+      if (this->IsFillable(index, bit, predicate) && Claim(m_Filled, bit))
+      {
+        const IndexValueType runLast = this->GrowRun(index, bit, predicate, runs);
+        bit += static_cast<SizeValueType>(runLast - x);
+        x = runLast;
+      }
+    }
+  }
+}
+
+template <unsigned int VImageDimension>
+template <typename TFunction>
+SizeValueType
+ScanlineFloodFill<VImageDimension>::ParallelizeChunks(const SizeValueType count,
+                                                      const SizeValueType minimumChunkSize,
+                                                      const TFunction &   f) const
+{
+  SizeValueType numberOfChunks = 1;
+  if (m_MultiThreader)
+  {
+    numberOfChunks = std::min(static_cast<SizeValueType>(m_MultiThreader->GetNumberOfWorkUnits()),
+                              std::max(count / minimumChunkSize, SizeValueType{ 1 }));
+  }
+  if (numberOfChunks == 1)
+  {
+    f(0, 0, count);
+  }
+  else
+  {
+    m_MultiThreader->ParallelizeArray(
+      0,
+      numberOfChunks,
+      [&](SizeValueType chunk) { f(chunk, count * chunk / numberOfChunks, count * (chunk + 1) / numberOfChunks); },
+      nullptr);
+  }
+  return numberOfChunks;
+}
+} // end namespace itk
+
+#endif
@@ -0,0 +1,97 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConfidenceConnectedImageFilter.h"
+#include "itkConnectedThresholdImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkTestBenchmarkWorkUnits.h"
+#include "itkTimeProbe.h"
+#include <random>
+
+
+// Time the connected threshold and confidence connected filters on a noisy
+// 3D image, whose region spreads over most of the image, for a growing
+// number of work units, up to the number of threads of the machine by
+// default. This is not part of the tests that run by default; run it with
+//   ctest -C Benchmark -R itkRegionGrowingBenchmark
+namespace
+{
+void
+TimeWorkUnits(itk::ProcessObject * filter, const itk::Testing::BenchmarkWorkUnitsArguments & arguments)
+{
+  std::cout << filter->GetNameOfClass() << ", mean of " << arguments.numberOfRepetitions << " runs" << std::endl;
+  itk::Testing::BenchmarkWorkUnits(arguments, [filter](unsigned int numberOfWorkUnits) {
+    filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    filter->Modified();
+    itk::TimeProbe timeProbe;
+    timeProbe.Start();
+    filter->Update();
+    timeProbe.Stop();
+    return timeProbe.GetTotal();
+  });
+}
+} // namespace
+
+
+int
+itkRegionGrowingBenchmark(int argc, char * argv[])
+{
+  itk::Testing::BenchmarkWorkUnitsArguments arguments;
+  if (!itk::Testing::ParseBenchmarkWorkUnitsArguments(argc, argv, 128, 3, arguments))
+  {
+    return EXIT_FAILURE;
+  }
+  const itk::SizeValueType size = arguments.size;
+
+  constexpr unsigned int Dimension = 3;
+  using ImageType = itk::Image<unsigned char, Dimension>;
+  using IndexType = ImageType::IndexType;
+
+  // Noise, of which the pixels below the upper threshold percolate
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate();
+  std::mt19937                       generator(Dimension);
+  std::uniform_int_distribution<int> noise(0, 255);
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<unsigned char>(noise(generator)));
+  }
+  const auto seed = IndexType::Filled(static_cast<itk::IndexValueType>(size / 2));
+  image->SetPixel(seed, 50);
+  std::cout << "Image of " << size << "^3 pixels" << std::endl;
+
+  auto connected = itk::ConnectedThresholdImageFilter<ImageType, ImageType>::New();
+  connected->SetInput(image);
+  connected->AddSeed(seed);
+  connected->SetLower(0);
+  connected->SetUpper(100);
+  connected->SetReplaceValue(255);
+  TimeWorkUnits(connected, arguments);
+
+  auto confidence = itk::ConfidenceConnectedImageFilter<ImageType, ImageType>::New();
+  confidence->SetInput(image);
+  confidence->AddSeed(seed);
+  confidence->SetMultiplier(1.5);
+  confidence->SetNumberOfIterations(2);
+  confidence->SetInitialNeighborhoodRadius(2);
+  confidence->SetReplaceValue(255);
+  TimeWorkUnits(confidence, arguments);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,278 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBinaryThresholdImageFunction.h"
+#include "itkConfidenceConnectedImageFilter.h"
+#include "itkConnectedThresholdImageFilter.h"
+#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkNeighborhoodBinaryThresholdImageFunction.h"
+#include "itkNeighborhoodConnectedImageFilter.h"
+#include "itkShapedFloodFilledImageFunctionConditionalIterator.h"
+#include "itkTestingMacros.h"
+#include <random>
+
+
+// Check that the connected, neighborhood connected and confidence connected
+// filters label the pixels that the flood filled iterators visit, for any
+// number of work units. See itkRegionGrowingBenchmark for the timings.
+namespace
+{
+template <typename TImage>
+itk::SizeValueType
+CountDifferences(const TImage * expected, const TImage * actual)
+{
+  itk::ImageRegionConstIterator<TImage> eit(expected, expected->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<TImage> it(actual, expected->GetLargestPossibleRegion());
+  itk::SizeValueType                    numberOfDifferences = 0;
+  for (; !it.IsAtEnd(); ++it, ++eit)
+  {
+    numberOfDifferences += it.Get() != eit.Get();
+  }
+  return numberOfDifferences;
+}
+
+template <typename TImage, typename TIterator>
+typename TImage::Pointer
+Label(const TImage * image, TIterator && it)
+{
+  auto labels = TImage::New();
+  labels->CopyInformation(image);
+  labels->SetRegions(image->GetLargestPossibleRegion());
+  labels->AllocateInitialized();
+  for (; !it.IsAtEnd(); ++it)
+  {
+    labels->SetPixel(it.GetIndex(), 255);
+  }
+  return labels;
+}
+
+template <typename TFilter>
+bool
+CheckFilter(TFilter * filter, const typename TFilter::OutputImageType * expected, const std::string & name)
+{
+  bool                                       success = true;
+  typename TFilter::OutputImageType::Pointer reference;
+  for (const unsigned int numberOfWorkUnits : { 1, 2, 3, 8 })
+  {
+    filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    filter->Modified();
+    filter->Update();
+
+    if (!expected)
+    {
+      reference = filter->GetOutput();
+      reference->DisconnectPipeline();
+      expected = reference;
+      continue;
+    }
+    const itk::SizeValueType numberOfDifferences = CountDifferences(expected, filter->GetOutput());
+    if (numberOfDifferences != 0)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << name << ": " << numberOfDifferences << " pixels differ with " << numberOfWorkUnits
+                << " work units." << std::endl;
+      success = false;
+    }
+  }
+  return success;
+}
+
+template <unsigned int VDimension>
+bool
+CheckWorkUnits(const itk::SizeValueType size)
+{
+  using ImageType = itk::Image<unsigned char, VDimension>;
+  using IndexType = typename ImageType::IndexType;
+
+  // Noise, so that the regions have many holes and branches
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate();
+  std::mt19937                       generator(VDimension);
+  std::uniform_int_distribution<int> noise(0, 255);
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<unsigned char>(noise(generator)));
+  }
+
+  // A seed outside of the image is ignored, a seed listed twice is labeled
+  // once
+  std::vector<IndexType> seeds;
+  seeds.push_back(IndexType::Filled(static_cast<itk::IndexValueType>(size / 2)));
+  seeds.push_back(IndexType::Filled(1));
+  seeds.push_back(IndexType::Filled(static_cast<itk::IndexValueType>(size)));
+  seeds.push_back(IndexType::Filled(1));
+  for (const IndexType & seed : seeds)
+  {
+    if (image->GetLargestPossibleRegion().IsInside(seed))
+    {
+      image->SetPixel(seed, 100);
+    }
+  }
+
+  bool success = true;
+
+  // Connected threshold, with both connectivities
+  const unsigned char lower = 0;
+  const unsigned char upper = VDimension == 2 ? 160 : 100;
+  using ThresholdFunctionType = itk::BinaryThresholdImageFunction<ImageType, double>;
+  auto thresholdFunction = ThresholdFunctionType::New();
+  thresholdFunction->SetInputImage(image);
+  thresholdFunction->ThresholdBetween(lower, upper);
+  for (const bool fullyConnected : { false, true })
+  {
+    typename ImageType::Pointer expected;
+    if (fullyConnected)
+    {
+      itk::ShapedFloodFilledImageFunctionConditionalConstIterator<ImageType, ThresholdFunctionType> it(
+        image, thresholdFunction, seeds);
+      it.FullyConnectedOn();
+      it.GoToBegin();
+      expected = Label(image.GetPointer(), it);
+    }
+    else
+    {
+      itk::FloodFilledImageFunctionConditionalConstIterator<ImageType, ThresholdFunctionType> it(
+        image, thresholdFunction, seeds);
+      it.GoToBegin();
+      expected = Label(image.GetPointer(), it);
+    }
+
+    auto filter = itk::ConnectedThresholdImageFilter<ImageType, ImageType>::New();
+    filter->SetInput(image);
+    for (const IndexType & seed : seeds)
+    {
+      filter->AddSeed(seed);
+    }
+    filter->SetLower(lower);
+    filter->SetUpper(upper);
+    filter->SetReplaceValue(255);
+    filter->SetConnectivity(fullyConnected ? itk::ConnectedThresholdImageFilterEnums::Connectivity::FullConnectivity
+                                           : itk::ConnectedThresholdImageFilterEnums::Connectivity::FaceConnectivity);
+    success = CheckFilter(filter.GetPointer(),
+                          expected.GetPointer(),
+                          std::to_string(VDimension) + "D ConnectedThreshold, FullyConnected " +
+                            std::to_string(fullyConnected)) &&
+              success;
+  }
+
+  // Neighborhood connected: the seeds are labeled even when their
+  // neighborhood is not within the thresholds
+  {
+    using NeighborhoodFunctionType = itk::NeighborhoodBinaryThresholdImageFunction<ImageType>;
+    const unsigned char neighborhoodUpper = 250;
+    auto                neighborhoodFunction = NeighborhoodFunctionType::New();
+    neighborhoodFunction->SetInputImage(image);
+    neighborhoodFunction->ThresholdBetween(lower, neighborhoodUpper);
+    neighborhoodFunction->SetRadius(ImageType::SizeType::Filled(1));
+    const auto expected = Label(
+      image.GetPointer(),
+      itk::FloodFilledImageFunctionConditionalConstIterator<ImageType, NeighborhoodFunctionType>(
+        image, neighborhoodFunction, seeds));
+
+    auto filter = itk::NeighborhoodConnectedImageFilter<ImageType, ImageType>::New();
+    filter->SetInput(image);
+    for (const IndexType & seed : seeds)
+    {
+      filter->AddSeed(seed);
+    }
+    filter->SetLower(lower);
+    filter->SetUpper(neighborhoodUpper);
+    filter->SetRadius(ImageType::SizeType::Filled(1));
+    filter->SetReplaceValue(255);
+    success =
+      CheckFilter(filter.GetPointer(), expected.GetPointer(), std::to_string(VDimension) + "D NeighborhoodConnected") &&
+      success;
+  }
+
+  // Confidence connected, against a single work unit. The statistics of
+  // each iteration are those that the flood filled iterator walking the
+  // segmentation of the previous iteration gathers.
+  {
+    auto filter = itk::ConfidenceConnectedImageFilter<ImageType, ImageType>::New();
+    filter->SetInput(image);
+    for (const IndexType & seed : seeds)
+    {
+      filter->AddSeed(seed);
+    }
+    filter->SetMultiplier(VDimension == 2 ? 1.6 : 1.5);
+    filter->SetInitialNeighborhoodRadius(2);
+    filter->SetReplaceValue(255);
+    for (const unsigned int numberOfIterations : { 1, 2, 3 })
+    {
+      filter->SetNumberOfIterations(numberOfIterations - 1);
+      filter->Update();
+      const typename ImageType::Pointer segmentation = filter->GetOutput();
+      segmentation->DisconnectPipeline();
+
+      using SegmentationFunctionType = itk::BinaryThresholdImageFunction<ImageType, double>;
+      auto segmentationFunction = SegmentationFunctionType::New();
+      segmentationFunction->SetInputImage(segmentation);
+      segmentationFunction->ThresholdBetween(255, 255);
+      double             sum = 0.0;
+      double             sumOfSquares = 0.0;
+      itk::SizeValueType numberOfSamples = 0;
+      itk::FloodFilledImageFunctionConditionalConstIterator<ImageType, SegmentationFunctionType> it(
+        image, segmentationFunction, seeds);
+      for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+      {
+        const auto value = static_cast<double>(it.Get());
+        sum += value;
+        sumOfSquares += value * value;
+        ++numberOfSamples;
+      }
+      const double mean = sum / static_cast<double>(numberOfSamples);
+      const double variance = (sumOfSquares - (sum * sum / static_cast<double>(numberOfSamples))) /
+                              (static_cast<double>(numberOfSamples) - 1.0);
+
+      filter->SetNumberOfIterations(numberOfIterations);
+      filter->Update();
+      if (!itk::Math::FloatAlmostEqual(filter->GetMean(), mean) ||
+          !itk::Math::FloatAlmostEqual(filter->GetVariance(), variance))
+      {
+        std::cerr << "Test failed!" << std::endl;
+        std::cerr << VDimension << "D ConfidenceConnected, iteration " << numberOfIterations << ": mean "
+                  << filter->GetMean() << " and variance " << filter->GetVariance() << " instead of " << mean
+                  << " and " << variance << std::endl;
+        success = false;
+      }
+    }
+    success =
+      CheckFilter(filter.GetPointer(), nullptr, std::to_string(VDimension) + "D ConfidenceConnected") && success;
+  }
+
+  return success;
+}
+} // namespace
+
+
+int
+itkRegionGrowingWorkUnitsTest(int, char *[])
+{
+  bool success = CheckWorkUnits<2>(300);
+  success = CheckWorkUnits<3>(48) && success;
+
+  if (!success)
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -19,7 +19,7 @@
 #define itkSLICImageFilter_h
 
 #include "itkImageToImageFilter.h"
-#include <mutex>
+#include <vector>
 
 namespace itk
 {
@@ -49,6 +49,13 @@ namespace itk
  * superpixel cluster. Every pixel in the output is labeled, and the
  * starting label id is zero.
  *
+ * The pixels are assigned to the clusters a line at a time, and the
+ * distances of the pixels of images of scalars and of VectorImages
+ * are computed directly from their buffer, with the usual small numbers
+ * of components known at compile time. The clusters are then updated
+ * from sums that each work unit accumulates over its part of the image,
+ * and that are reduced concurrently, cluster by cluster.
+ *
  * This code was contributed in the Insight Journal paper:
  * "Scalable Simple Linear Iterative Clustering (SSLIC) Using a
  * Generic and Parallel Approach" by Lowekamp B. C., Chen D. T., Yaniv
@@ -177,8 +184,10 @@ protected:
   void
   ThreadedUpdateDistanceAndLabel(const OutputImageRegionType & outputRegionForThread);
 
+  /** Accumulate the pixels of a part of the image into the sums of
+   * their clusters, in the accumulator of the given index. */
   void
-  ThreadedUpdateClusters(const OutputImageRegionType & updateRegionForThread);
+  ThreadedUpdateClusters(const OutputImageRegionType & updateRegionForThread, SizeValueType accumulatorIndex);
 
   void
   ThreadedPerturbClusters(SizeValueType clusterIndex);
@@ -218,17 +227,47 @@ private:
                          OutputPixelType          outputLabel,
                          std::vector<IndexType> & indexStack);
 
-  struct UpdateCluster
+  /** Assign the pixels of the region to their nearest cluster, where
+   * pixelDistance(cluster, pixel) is the distance between the values of
+   * a cluster and of the pixel at an offset in the input buffer. */
+  template <typename TPixelDistance>
+  void
+  UpdateDistanceAndLabel(const OutputImageRegionType & outputRegionForThread, const TPixelDistance & pixelDistance);
+
+  /** Distance between the values of a cluster and of a pixel given as an
+   * array of components. VNumberOfComponents is the number of components
+   * when it is known at compile time, zero otherwise. */
+  template <unsigned int VNumberOfComponents, typename TComponent>
+  static DistanceType
+  ComponentDistance(const ClusterComponentType * cluster,
+                    const TComponent *           pixel,
+                    const unsigned int           numberOfComponents)
   {
-    size_t                           count;
-    vnl_vector<ClusterComponentType> cluster;
+    const unsigned int n = VNumberOfComponents > 0 ? VNumberOfComponents : numberOfComponents;
+    DistanceType       d1 = 0.0;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+      const DistanceType d = (cluster[i] - pixel[i]);
+      d1 += d * d;
+    }
+    return d1;
+  }
+
+  /** Sums of the values and indices of the pixels of each cluster, and
+   * their numbers, over a part of the image. Only the clusters from
+   * m_FirstCluster to the last label found in the part are held: as the
+   * clusters are seeded in the order of the image, those of a part are
+   * mostly the ones whose search windows overlap it. */
+  struct ClusterAccumulator
+  {
+    size_t                            m_FirstCluster{};
+    std::vector<ClusterComponentType> m_Sums;
+    std::vector<SizeValueType>        m_Counts;
   };
 
-  using UpdateClusterMap = std::map<size_t, UpdateCluster>;
-
   using MarkerImageType = Image<unsigned char, ImageDimension>;
 
-  std::vector<UpdateClusterMap> m_UpdateClusterPerThread{};
+  std::vector<ClusterAccumulator> m_ClusterAccumulators{};
 
   typename DistanceImageType::Pointer m_DistanceImage{};
   typename MarkerImageType::Pointer   m_MarkerImage{};
@@ -237,8 +276,7 @@ private:
 
   bool m_InitializationPerturbation{ true };
 
-  double     m_AverageResidual{};
-  std::mutex m_Mutex{};
+  double m_AverageResidual{};
 };
 } // end namespace itk
 
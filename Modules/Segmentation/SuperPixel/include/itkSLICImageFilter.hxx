@@ -30,11 +30,11 @@
 
 #include "itkVariableLengthVector.h"
 
-#include "itkPlatformMultiThreader.h"
-
 #include "itkMath.h"
 
+#include <algorithm>
 #include <numeric>
+#include <type_traits>
 
 
 namespace itk
@@ -45,9 +45,6 @@ SLICImageFilter<TInputImage, TOutputImage, TDistancePixel>::SLICImageFilter()
   : m_MaximumNumberOfIterations((ImageDimension > 2) ? 5 : 10)
   , m_AverageResidual(NumericTraits<double>::max())
 {
-  this->DynamicMultiThreadingOff();
-  this->SetMultiThreader(PlatformMultiThreader::New());
-
   m_SuperGridSize.Fill(50);
 }
 
@@ -174,7 +171,7 @@ SLICImageFilter<TInputImage, TOutputImage, TDistancePixel>::BeforeThreadedGenera
   }
 
 
-  m_UpdateClusterPerThread.clear();
+  m_ClusterAccumulators.clear();
 
   this->Superclass::BeforeThreadedGenerateData();
 }
@@ -184,6 +181,69 @@ template <typename TInputImage, typename TOutputImage, typename TDistancePixel>
 void
 SLICImageFilter<TInputImage, TOutputImage, TDistancePixel>::ThreadedUpdateDistanceAndLabel(
   const OutputImageRegionType & outputRegionForThread)
+{
+  const InputImageType * inputImage = this->GetInput();
+  const unsigned int     numberOfComponents = inputImage->GetNumberOfComponentsPerPixel();
+
+  if constexpr (std::is_arithmetic_v<typename InputImageType::InternalPixelType>)
+  {
+    // The buffer of an image of scalars or of a VectorImage is an array of
+    // components
+    const typename InputImageType::InternalPixelType * components = inputImage->GetBufferPointer();
+
+    const auto updateDistanceAndLabel = [&](auto numberOfComponentsConstant) {
+      constexpr unsigned int VNumberOfComponents = decltype(numberOfComponentsConstant)::value;
+      this->UpdateDistanceAndLabel(
+        outputRegionForThread,
+        [components, numberOfComponents](const ClusterComponentType * cluster, const SizeValueType pixel) {
+          return ComponentDistance<VNumberOfComponents>(
+            cluster, components + pixel * numberOfComponents, numberOfComponents);
+        });
+    };
+    switch (numberOfComponents)
+    {
+      case 1:
+        updateDistanceAndLabel(std::integral_constant<unsigned int, 1>{});
+        break;
+      case 2:
+        updateDistanceAndLabel(std::integral_constant<unsigned int, 2>{});
+        break;
+      case 3:
+        updateDistanceAndLabel(std::integral_constant<unsigned int, 3>{});
+        break;
+      case 4:
+        updateDistanceAndLabel(std::integral_constant<unsigned int, 4>{});
+        break;
+      default:
+        updateDistanceAndLabel(std::integral_constant<unsigned int, 0>{});
+        break;
+    }
+  }
+  else
+  {
+    const InputPixelType * pixels = inputImage->GetBufferPointer();
+    this->UpdateDistanceAndLabel(
+      outputRegionForThread,
+      [pixels, numberOfComponents](const ClusterComponentType * cluster, const SizeValueType pixel) {
+        const typename NumericTraits<InputPixelType>::MeasurementVectorType & v = pixels[pixel];
+        DistanceType                                                          d1 = 0.0;
+        for (unsigned int i = 0; i < numberOfComponents; ++i)
+        {
+          const DistanceType d = (cluster[i] - v[i]);
+          d1 += d * d;
+        }
+        return d1;
+      });
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage, typename TDistancePixel>
+template <typename TPixelDistance>
+void
+SLICImageFilter<TInputImage, TOutputImage, TDistancePixel>::UpdateDistanceAndLabel(
+  const OutputImageRegionType & outputRegionForThread,
+  const TPixelDistance &        pixelDistance)
 {
   const InputImageType * inputImage = this->GetInput();
   OutputImageType *      outputImage = this->GetOutput();
@@ -196,11 +256,14 @@ SLICImageFilter<TInputImage, TOutputImage, TDistancePixel>::ThreadedUpdateDistan
     searchRadius[i] = m_SuperGridSize[i];
   }
 
+  DistanceType *            distances = m_DistanceImage->GetBufferPointer();
+  OutputPixelType *         labels = outputImage->GetBufferPointer();
+  std::vector<DistanceType> lineDistances;
+
   for (size_t i = 0; i * numberOfClusterComponents < m_Clusters.size(); ++i)
   {
-    ClusterType                         cluster(numberOfClusterComponents, &m_Clusters[i * numberOfClusterComponents]);
+    const ClusterComponentType *        cluster = &m_Clusters[i * numberOfClusterComponents];
     typename InputImageType::RegionType localRegion;
-    typename InputImageType::PointType  pt;
     IndexType                           idx;
 
     for (unsigned int d = 0; d < ImageDimension; ++d)
@@ -216,35 +279,50 @@ SLICImageFilter<TInputImage, TOutputImage, TDistancePixel>::ThreadedUpdateDistan
       continue;
     }
 
+    const SizeValueType ln = localRegion.GetSize(0);
+    lineDistances.resize(ln);
 
-    const size_t ln = localRegion.GetSize(0);
-
-    ImageScanlineConstIterator inputIter(inputImage, localRegion);
-    ImageScanlineIterator      distanceIter(m_DistanceImage, localRegion);
-
-
-    while (!inputIter.IsAtEnd())
+    for (ImageScanlineConstIterator<DistanceImageType> lineIt(m_DistanceImage, localRegion); !lineIt.IsAtEnd();
+         lineIt.NextLine())
     {
-      for (size_t x = 0; x < ln; ++x)
+      const IndexType     lineIndex = lineIt.GetIndex();
+      const SizeValueType inputOffset = inputImage->ComputeOffset(lineIndex);
+      const SizeValueType distanceOffset = m_DistanceImage->ComputeOffset(lineIndex);
+      const SizeValueType labelOffset = outputImage->ComputeOffset(lineIndex);
+
+      // the spatial terms of the dimensions other than the first are the
+      // same along the line
+      DistanceType lineTerms[ImageDimension];
+      for (unsigned int j = 1; j < ImageDimension; ++j)
       {
-        const IndexType & currentIdx = inputIter.ComputeIndex();
+        const DistanceType d = (cluster[numberOfComponents + j] - lineIndex[j]) * m_DistanceScales[j];
+        lineTerms[j] = d * d;
+      }
 
-        pt = ContinuousIndexType(currentIdx);
-        const double distance = this->Distance(cluster, inputIter.Get(), pt);
-        if (distance < distanceIter.Get())
+      // the distances are computed apart from the comparisons, so that this
+      // loop can be vectorized
+      for (SizeValueType x = 0; x < ln; ++x)
+      {
+        const DistanceType d =
+          (cluster[numberOfComponents] - static_cast<double>(lineIndex[0] + static_cast<IndexValueType>(x))) *
+          m_DistanceScales[0];
+        DistanceType d2 = d * d;
+        for (unsigned int j = 1; j < ImageDimension; ++j)
         {
-          distanceIter.Set(distance);
-          outputImage->SetPixel(currentIdx, i);
+          d2 += lineTerms[j];
         }
+        lineDistances[x] = pixelDistance(cluster, inputOffset + x) + d2;
+      }
 
-        ++distanceIter;
-        ++inputIter;
+      for (SizeValueType x = 0; x < ln; ++x)
+      {
+        if (lineDistances[x] < distances[distanceOffset + x])
+        {
+          distances[distanceOffset + x] = lineDistances[x];
+          labels[labelOffset + x] = i;
+        }
       }
-      inputIter.NextLine();
-      distanceIter.NextLine();
     }
-
-    // for neighborhood iterator size S
   }
 }
 
@@ -252,61 +330,84 @@ SLICImageFilter<TInputImage, TOutputImage, TDistancePixel>::ThreadedUpdateDistan
 template <typename TInputImage, typename TOutputImage, typename TDistancePixel>
 void
 SLICImageFilter<TInputImage, TOutputImage, TDistancePixel>::ThreadedUpdateClusters(
-  const OutputImageRegionType & updateRegionForThread)
+  const OutputImageRegionType & updateRegionForThread,
+  SizeValueType                 accumulatorIndex)
 {
-  const InputImageType * inputImage = this->GetInput();
-  OutputImageType *      outputImage = this->GetOutput();
+  const InputImageType *  inputImage = this->GetInput();
+  const OutputImageType * outputImage = this->GetOutput();
 
   const unsigned int numberOfComponents = inputImage->GetNumberOfComponentsPerPixel();
   const unsigned int numberOfClusterComponents = numberOfComponents + ImageDimension;
 
-  UpdateClusterMap clusterMap;
+  const OutputPixelType * labels = outputImage->GetBufferPointer();
+  const SizeValueType     ln = updateRegionForThread.GetSize(0);
 
-  itkDebugMacro("Estimating Centers");
-  // calculate new centers
-  ImageScanlineIterator      itOut(outputImage, updateRegionForThread);
-  ImageScanlineConstIterator itIn(inputImage, updateRegionForThread);
-  while (!itOut.IsAtEnd())
+  // only hold the range of the labels found in this part of the image
+  size_t firstLabel = NumericTraits<size_t>::max();
+  size_t lastLabel = 0;
+  for (ImageScanlineConstIterator<OutputImageType> lineIt(outputImage, updateRegionForThread); !lineIt.IsAtEnd();
+       lineIt.NextLine())
   {
-    const size_t ln = updateRegionForThread.GetSize(0);
-    for (unsigned int x = 0; x < ln; ++x)
+    const OutputPixelType * lineLabels = labels + outputImage->ComputeOffset(lineIt.GetIndex());
+    const auto              minmax = std::minmax_element(lineLabels, lineLabels + ln);
+    firstLabel = std::min(firstLabel, static_cast<size_t>(*minmax.first));
+    lastLabel = std::max(lastLabel, static_cast<size_t>(*minmax.second));
+  }
+
+  itkDebugMacro("Estimating Centers");
+  ClusterAccumulator & accumulator = m_ClusterAccumulators[accumulatorIndex];
+  const size_t         numberOfClusters = firstLabel <= lastLabel ? lastLabel - firstLabel + 1 : 0;
+  accumulator.m_FirstCluster = firstLabel;
+  accumulator.m_Sums.assign(numberOfClusters * numberOfClusterComponents, 0.0);
+  accumulator.m_Counts.assign(numberOfClusters, 0);
+
+  // calculate the sums of the new centers, a line at a time
+  const auto accumulate = [&](const auto & addValue) {
+    for (ImageScanlineConstIterator<OutputImageType> lineIt(outputImage, updateRegionForThread); !lineIt.IsAtEnd();
+         lineIt.NextLine())
     {
-      const IndexType &                         idx = itOut.ComputeIndex();
-      const InputPixelType &                    v = itIn.Get();
-      const typename OutputImageType::PixelType l = itOut.Get();
-
-      const std::pair<typename UpdateClusterMap::iterator, bool> r =
-        clusterMap.insert(std::make_pair(l, UpdateCluster()));
-      vnl_vector<ClusterComponentType> & cluster = r.first->second.cluster;
-      if (r.second)
+      const IndexType     lineIndex = lineIt.GetIndex();
+      const SizeValueType inputOffset = inputImage->ComputeOffset(lineIndex);
+      const SizeValueType labelOffset = outputImage->ComputeOffset(lineIndex);
+      for (SizeValueType x = 0; x < ln; ++x)
       {
-        cluster.set_size(numberOfClusterComponents);
-        cluster.fill(0.0);
-        r.first->second.count = 0;
+        const size_t           label = labels[labelOffset + x] - firstLabel;
+        ClusterComponentType * cluster = &accumulator.m_Sums[label * numberOfClusterComponents];
+        ++accumulator.m_Counts[label];
+
+        addValue(cluster, inputOffset + x);
+
+        cluster[numberOfComponents] += lineIndex[0] + static_cast<IndexValueType>(x);
+        for (unsigned int i = 1; i < ImageDimension; ++i)
+        {
+          cluster[numberOfComponents + i] += lineIndex[i];
+        }
       }
-      ++r.first->second.count;
+    }
+  };
 
-      const typename NumericTraits<InputPixelType>::MeasurementVectorType & mv = v;
+  if constexpr (std::is_arithmetic_v<typename InputImageType::InternalPixelType>)
+  {
+    const typename InputImageType::InternalPixelType * components = inputImage->GetBufferPointer();
+    accumulate([components, numberOfComponents](ClusterComponentType * cluster, const SizeValueType pixel) {
+      const typename InputImageType::InternalPixelType * v = components + pixel * numberOfComponents;
       for (unsigned int i = 0; i < numberOfComponents; ++i)
       {
-        cluster[i] += mv[i];
+        cluster[i] += v[i];
       }
-
-      for (unsigned int i = 0; i < ImageDimension; ++i)
+    });
+  }
+  else
+  {
+    const InputPixelType * pixels = inputImage->GetBufferPointer();
+    accumulate([pixels, numberOfComponents](ClusterComponentType * cluster, const SizeValueType pixel) {
+      const typename NumericTraits<InputPixelType>::MeasurementVectorType & mv = pixels[pixel];
+      for (unsigned int i = 0; i < numberOfComponents; ++i)
       {
-        cluster[numberOfComponents + i] += idx[i];
+        cluster[i] += mv[i];
       }
-
-      ++itIn;
-      ++itOut;
-    }
-    itIn.NextLine();
-    itOut.NextLine();
+    });
   }
-
-  // TODO improve merge algorithm
-  const std::lock_guard<std::mutex> lockGuard(m_Mutex);
-  m_UpdateClusterPerThread.push_back(clusterMap);
 }
 
 
@@ -601,7 +702,6 @@ SLICImageFilter<TInputImage, TOutputImage, TDistancePixel>::GenerateData()
     itkDebugMacro("Iteration :" << loopCnt);
 
     m_DistanceImage->FillBuffer(NumericTraits<typename DistanceImageType::PixelType>::max());
-    m_UpdateClusterPerThread.clear();
 
     this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
       outputImage->GetRequestedRegion(),
@@ -610,44 +710,54 @@ SLICImageFilter<TInputImage, TOutputImage, TDistancePixel>::GenerateData()
       },
       this);
 
-
-    this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
-      outputImage->GetRequestedRegion(),
-      [this](const OutputImageRegionType & outputRegionForThread) {
-        this->ThreadedUpdateClusters(outputRegionForThread);
+    // each part of the image is accumulated by a work unit of its own
+    const OutputImageRegionType     requestedRegion = outputImage->GetRequestedRegion();
+    const ImageRegionSplitterBase * splitter = this->GetImageRegionSplitter();
+    const unsigned int numberOfSplits = splitter->GetNumberOfSplits(requestedRegion, this->GetNumberOfWorkUnits());
+    m_ClusterAccumulators.resize(numberOfSplits);
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfSplits,
+      [this, splitter, numberOfSplits, &requestedRegion](SizeValueType split) {
+        OutputImageRegionType updateRegionForThread = requestedRegion;
+        splitter->GetSplit(split, numberOfSplits, updateRegionForThread);
+        this->ThreadedUpdateClusters(updateRegionForThread, split);
       },
       this);
 
-    // prepare to update clusters
+    // reduce the accumulators into the m_Clusters array, a cluster at a time
     swap(m_Clusters, m_OldClusters);
-    std::fill(m_Clusters.begin(), m_Clusters.end(), 0.0);
-    std::vector<size_t> clusterCount(m_Clusters.size() / numberOfClusterComponents, 0);
-
-    // reduce the produce cluster maps per-thread into m_Cluster array
-    for (unsigned int i = 0; i < m_UpdateClusterPerThread.size(); ++i)
-    {
-      UpdateClusterMap & clusterMap = m_UpdateClusterPerThread[i];
-      for (auto clusterIter = clusterMap.begin(); clusterIter != clusterMap.end(); ++clusterIter)
-      {
-        const size_t clusterIdx = clusterIter->first;
-        clusterCount[clusterIdx] += clusterIter->second.count;
-
-        ClusterType cluster(numberOfClusterComponents, &m_Clusters[clusterIdx * numberOfClusterComponents]);
-        cluster += clusterIter->second.cluster;
-      }
-    }
+    std::vector<double> residuals(numberOfClusters);
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfClusters,
+      [this, numberOfClusterComponents, &residuals](SizeValueType i) {
+        ClusterType cluster(numberOfClusterComponents, &m_Clusters[i * numberOfClusterComponents]);
+        cluster.fill(0.0);
+        size_t clusterCount = 0;
+        for (const ClusterAccumulator & accumulator : m_ClusterAccumulators)
+        {
+          if (i < accumulator.m_FirstCluster || i - accumulator.m_FirstCluster >= accumulator.m_Counts.size())
+          {
+            continue;
+          }
+          const size_t k = i - accumulator.m_FirstCluster;
+          clusterCount += accumulator.m_Counts[k];
+          for (unsigned int j = 0; j < numberOfClusterComponents; ++j)
+          {
+            cluster[j] += accumulator.m_Sums[k * numberOfClusterComponents + j];
+          }
+        }
 
-    // average, l1
-    double l1Residual = 0.0;
-    for (size_t i = 0; i * numberOfClusterComponents < m_Clusters.size(); ++i)
-    {
+        // average, l1
+        cluster /= clusterCount;
 
-      ClusterType cluster(numberOfClusterComponents, &m_Clusters[i * numberOfClusterComponents]);
-      cluster /= clusterCount[i];
+        const ClusterType oldCluster(numberOfClusterComponents, &m_OldClusters[i * numberOfClusterComponents]);
+        residuals[i] = Distance(cluster, oldCluster);
+      },
+      nullptr);
 
-      const ClusterType oldCluster(numberOfClusterComponents, &m_OldClusters[i * numberOfClusterComponents]);
-      l1Residual += Distance(cluster, oldCluster);
-    }
+    const double l1Residual = std::accumulate(residuals.cbegin(), residuals.cend(), 0.0);
 
     m_AverageResidual = std::sqrt(l1Residual) / m_Clusters.size();
     this->InvokeEvent(IterationEvent());
@@ -689,10 +799,7 @@ SLICImageFilter<TInputImage, TOutputImage, TDistancePixel>::AfterThreadedGenerat
   // cleanup
   std::vector<ClusterComponentType>().swap(m_Clusters);
   std::vector<ClusterComponentType>().swap(m_OldClusters);
-  for (unsigned int i = 0; i < m_UpdateClusterPerThread.size(); ++i)
-  {
-    UpdateClusterMap().swap(m_UpdateClusterPerThread[i]);
-  }
+  std::vector<ClusterAccumulator>().swap(m_ClusterAccumulators);
 }
 
 
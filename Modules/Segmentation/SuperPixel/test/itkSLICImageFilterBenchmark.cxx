@@ -0,0 +1,76 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegionIterator.h"
+#include "itkSLICImageFilter.h"
+#include "itkTestBenchmarkWorkUnits.h"
+#include "itkTimeProbe.h"
+#include "itkVectorImage.h"
+#include <random>
+
+
+// Time the SLIC filter on a noisy 3D color image for a growing number of work
+// units, up to the number of threads of the machine by default. This is not
+// part of the tests that run by default; run it with
+//   ctest -C Benchmark -R itkSLICImageFilterBenchmark
+int
+itkSLICImageFilterBenchmark(int argc, char * argv[])
+{
+  itk::Testing::BenchmarkWorkUnitsArguments arguments;
+  if (!itk::Testing::ParseBenchmarkWorkUnitsArguments(argc, argv, 96, 3, arguments))
+  {
+    return EXIT_FAILURE;
+  }
+  const itk::SizeValueType size = arguments.size;
+
+  constexpr unsigned int Dimension = 3;
+  constexpr unsigned int NumberOfComponents = 3;
+  using ImageType = itk::VectorImage<float, Dimension>;
+  using OutputImageType = itk::Image<unsigned int, Dimension>;
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->SetNumberOfComponentsPerPixel(NumberOfComponents);
+  image->Allocate();
+  std::mt19937                          generator(Dimension);
+  std::uniform_real_distribution<float> noise(0.0f, 255.0f);
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    ImageType::PixelType pixel = it.Get();
+    for (unsigned int c = 0; c < NumberOfComponents; ++c)
+    {
+      pixel[c] = noise(generator);
+    }
+    it.Set(pixel);
+  }
+
+  std::cout << "Image of " << size << "^3 pixels, mean of " << arguments.numberOfRepetitions << " runs" << std::endl;
+  itk::Testing::BenchmarkWorkUnits(arguments, [&image](unsigned int numberOfWorkUnits) {
+    auto filter = itk::SLICImageFilter<ImageType, OutputImageType>::New();
+    filter->SetInput(image);
+    filter->SetSuperGridSize(8);
+    filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    itk::TimeProbe timeProbe;
+    timeProbe.Start();
+    filter->Update();
+    timeProbe.Stop();
+    return timeProbe.GetTotal();
+  });
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSLICImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkTestingMacros.h"
+#include "itkVectorImage.h"
+#include <random>
+
+
+// Check that the labels of the SLIC filter do not depend on the number of
+// work units, nor on whether the pixels are stored in a VectorImage or in an
+// Image of Vectors.
+namespace
+{
+template <typename TImage>
+itk::SizeValueType
+CountDifferences(const TImage * expected, const TImage * actual)
+{
+  itk::ImageRegionConstIterator<TImage> eit(expected, expected->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<TImage> it(actual, expected->GetLargestPossibleRegion());
+  itk::SizeValueType                    numberOfDifferences = 0;
+  for (; !it.IsAtEnd(); ++it, ++eit)
+  {
+    numberOfDifferences += it.Get() != eit.Get();
+  }
+  return numberOfDifferences;
+}
+
+// Blocks of random colors with some noise. The values are integers, so that
+// the sums of the clusters are exact whichever way they are split.
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const itk::SizeValueType size, const unsigned int numberOfComponents)
+{
+  constexpr unsigned int Dimension = TImage::ImageDimension;
+
+  auto image = TImage::New();
+  image->SetRegions(TImage::SizeType::Filled(size));
+  image->SetNumberOfComponentsPerPixel(numberOfComponents);
+  image->Allocate();
+
+  std::mt19937                       generator(Dimension);
+  std::uniform_int_distribution<int> color(0, 200);
+  std::uniform_int_distribution<int> noise(0, 40);
+  std::vector<int>                   blockColors(4096 * numberOfComponents);
+  for (int & blockColor : blockColors)
+  {
+    blockColor = color(generator);
+  }
+
+  for (itk::ImageRegionIterator<TImage> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    const typename TImage::IndexType index = it.GetIndex();
+    size_t                           block = 0;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      block = block * 16 + static_cast<size_t>(index[d] / 11) % 16;
+    }
+    typename TImage::PixelType pixel = it.Get();
+    for (unsigned int c = 0; c < numberOfComponents; ++c)
+    {
+      pixel[c] = static_cast<float>(blockColors[(block % 4096) * numberOfComponents + c] + noise(generator));
+    }
+    it.Set(pixel);
+  }
+  return image;
+}
+
+template <typename TInputImage, typename TOutputImage>
+typename TOutputImage::Pointer
+Segment(const TInputImage * image, const unsigned int gridSize, const unsigned int numberOfWorkUnits)
+{
+  auto filter = itk::SLICImageFilter<TInputImage, TOutputImage>::New();
+  filter->SetInput(image);
+  filter->SetSuperGridSize(gridSize);
+  filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+  filter->Update();
+
+  typename TOutputImage::Pointer labels = filter->GetOutput();
+  labels->DisconnectPipeline();
+  return labels;
+}
+
+template <unsigned int VDimension>
+int
+CheckWorkUnits(const itk::SizeValueType size, const unsigned int gridSize)
+{
+  constexpr unsigned int NumberOfComponents = 3;
+  using VectorImageType = itk::VectorImage<float, VDimension>;
+  using ImageOfVectorsType = itk::Image<itk::Vector<float, NumberOfComponents>, VDimension>;
+  using OutputImageType = itk::Image<unsigned short, VDimension>;
+
+  const typename VectorImageType::Pointer    vectorImage = MakeImage<VectorImageType>(size, NumberOfComponents);
+  const typename ImageOfVectorsType::Pointer imageOfVectors =
+    MakeImage<ImageOfVectorsType>(size, NumberOfComponents);
+
+  const typename OutputImageType::Pointer expected =
+    Segment<VectorImageType, OutputImageType>(vectorImage, gridSize, 1);
+  for (const unsigned int numberOfWorkUnits : { 2, 3, 8 })
+  {
+    const typename OutputImageType::Pointer labels =
+      Segment<VectorImageType, OutputImageType>(vectorImage, gridSize, numberOfWorkUnits);
+    ITK_TEST_EXPECT_EQUAL(CountDifferences(expected.GetPointer(), labels.GetPointer()), 0);
+  }
+
+  // The components of a VectorImage are read from its buffer, the pixels of
+  // an Image of Vectors as measurement vectors
+  for (const unsigned int numberOfWorkUnits : { 1, 3 })
+  {
+    const typename OutputImageType::Pointer labels =
+      Segment<ImageOfVectorsType, OutputImageType>(imageOfVectors, gridSize, numberOfWorkUnits);
+    ITK_TEST_EXPECT_EQUAL(CountDifferences(expected.GetPointer(), labels.GetPointer()), 0);
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkSLICImageFilterWorkUnitsTest(int, char *[])
+{
+  if (CheckWorkUnits<2>(256, 16) != EXIT_SUCCESS || CheckWorkUnits<3>(48, 8) != EXIT_SUCCESS)
+  {
+    std::cerr << "Test failed!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
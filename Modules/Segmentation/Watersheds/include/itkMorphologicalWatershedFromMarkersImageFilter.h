@@ -64,6 +64,16 @@ namespace itk
  * The morphological watershed transform algorithm is described in
  * \cite soille2004c.
  *
+ * When the filter has more than one work unit, the image is flooded
+ * concurrently, one front at a time: the pixels of the hierarchical queue
+ * that a single work unit would process one after the other, before any of
+ * the pixels they add, are processed together. A pixel added by several
+ * pixels of the front is added by the first of them, and the few pixels of
+ * the front whose label depends on a neighbor of the same front are labeled
+ * in the order of the queue, so the output is the same for any number of
+ * work units. The concurrent flooding needs fewer than 2^32 pixels; larger
+ * images are flooded by a single work unit.
+ *
  * This code was contributed in the Insight Journal paper:
  * "The watershed transform in ITK - discussion and new developments"
  * by Beare R., Lehmann G.
@@ -180,11 +190,16 @@ protected:
   void
   EnlargeOutputRequestedRegion(DataObject * itkNotUsed(output)) override;
 
-  /** The filter is single threaded. */
+  /** The filter is single threaded, unless it has several work units. */
   void
   GenerateData() override;
 
 private:
+  /** Flood the image on the work units of the multi-threader, with the same
+   * result as the single threaded flooding. */
+  void
+  FloodConcurrently();
+
   bool m_FullyConnected{ false };
 
   bool m_MarkWatershedLine{ true };
@@ -19,9 +19,11 @@
 #define itkMorphologicalWatershedFromMarkersImageFilter_hxx
 
 #include <algorithm>
+#include <atomic>
 #include <queue>
 #include <list>
 #include "itkProgressReporter.h"
+#include "itkTotalProgressReporter.h"
 #include "itkImageRegionIterator.h"
 #include "itkConstShapedNeighborhoodIterator.h"
 #include "itkConstantBoundaryCondition.h"
@@ -100,17 +102,24 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
   const InputImageType * inputImage = this->GetInput();
   LabelImageType *       outputImage = this->GetOutput();
 
-  // Set up the progress reporter
-  // we can't found the exact number of pixel to process in the 2nd pass, so we
-  // use the maximum number possible.
-  ProgressReporter progress(this, 0, markerImage->GetRequestedRegion().GetNumberOfPixels() * 2);
-
   // mask and marker must have the same size
   if (markerImage->GetRequestedRegion().GetSize() != inputImage->GetRequestedRegion().GetSize())
   {
     itkExceptionStringMacro("Marker and input must have the same size.");
   }
 
+  if (this->GetNumberOfWorkUnits() > 1 &&
+      outputImage->GetRequestedRegion().GetNumberOfPixels() < NumericTraits<uint32_t>::max())
+  {
+    this->FloodConcurrently();
+    return;
+  }
+
+  // Set up the progress reporter
+  // we can't found the exact number of pixel to process in the 2nd pass, so we
+  // use the maximum number possible.
+  ProgressReporter progress(this, 0, markerImage->GetRequestedRegion().GetNumberOfPixels() * 2);
+
   // FAH (in french: File d'Attente Hierarchique)
   using QueueType = std::queue<IndexType>;
   using MapType = std::map<InputImagePixelType, QueueType>;
@@ -419,6 +428,418 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
 }
 
 
+template <typename TInputImage, typename TLabelImage>
+void
+MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::FloodConcurrently()
+{
+  // The hierarchical queue is processed one front at a time: a front is the
+  // part of the queue of a level that the single threaded flooding processes
+  // before any of the pixels that it adds to that queue. The pixels of a front
+  // are processed concurrently, and each pixel that they add to a queue is
+  // claimed by the first pixel of the front, in the order of the queue, that
+  // adds it. The pixels added by the front are then appended to the queues in
+  // that order, so the queues hold the same pixels in the same order as
+  // with a single work unit.
+
+  // the label used to find background in the marker image
+  static const LabelImagePixelType bgLabel{};
+  // the label used to mark the watershed line in the output image
+  static const LabelImagePixelType wsLabel{};
+
+  const LabelImageType * markerImage = this->GetMarkerImage();
+  const InputImageType * inputImage = this->GetInput();
+  LabelImageType *       outputImage = this->GetOutput();
+
+  const LabelImageRegionType region = outputImage->GetBufferedRegion();
+  const SizeValueType        numberOfPixels = region.GetNumberOfPixels();
+  const IndexType            startIndex = region.GetIndex();
+  const auto                 size = region.GetSize();
+
+  const LabelImagePixelType * marker = markerImage->GetBufferPointer();
+  const InputImagePixelType * input = inputImage->GetBufferPointer();
+  LabelImagePixelType *       output = outputImage->GetBufferPointer();
+
+  // the neighbors, in the order of the shaped neighborhood iterators
+  constexpr auto radius = Size<ImageDimension>::Filled(1);
+  using MarkerIteratorType = ConstShapedNeighborhoodIterator<LabelImageType>;
+  using OffsetType = typename MarkerIteratorType::OffsetType;
+  MarkerIteratorType markerIt(radius, markerImage, region);
+  setConnectivity(&markerIt, m_FullyConnected);
+  const auto *                 offsetTable = outputImage->GetOffsetTable();
+  std::vector<OffsetType>      neighborOffsets;
+  std::vector<OffsetValueType> neighborLinearOffsets;
+  for (auto nmIt = markerIt.Begin(); nmIt != markerIt.End(); ++nmIt)
+  {
+    const OffsetType offset = nmIt.GetNeighborhoodOffset();
+    OffsetValueType  linearOffset = 0;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      linearOffset += offset[i] * offsetTable[i];
+    }
+    neighborOffsets.push_back(offset);
+    neighborLinearOffsets.push_back(linearOffset);
+  }
+  const SizeValueType numberOfNeighbors = neighborOffsets.size();
+
+  // call f with the linear offset of each neighbor of the pixel, in order,
+  // skipping the neighbors outside of the image
+  const auto forEachNeighbor = [&](const OffsetValueType pixel, const auto & f) {
+    const IndexType index = outputImage->ComputeIndex(pixel);
+    bool            interior = true;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      interior = interior && index[i] > startIndex[i] &&
+                 index[i] < startIndex[i] + static_cast<OffsetValueType>(size[i]) - 1;
+    }
+    for (SizeValueType k = 0; k < numberOfNeighbors; ++k)
+    {
+      if (interior || region.IsInside(index + neighborOffsets[k]))
+      {
+        f(pixel + neighborLinearOffsets[k]);
+      }
+    }
+  };
+
+  // The key of the first pixel that claims each pixel, as long as it is not
+  // added to a queue; also the position of each pixel in its front, while the
+  // front is processed.
+  using KeyType = uint32_t;
+  constexpr KeyType                 unclaimed = NumericTraits<KeyType>::max();
+  std::vector<std::atomic<KeyType>> claims(numberOfPixels);
+  const auto                        claim = [&claims](const OffsetValueType pixel, const KeyType key) {
+    KeyType current = claims[pixel].load(std::memory_order_relaxed);
+    while (key < current && !claims[pixel].compare_exchange_weak(current, key, std::memory_order_relaxed))
+    {
+    }
+  };
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  const SizeValueType maximumNumberOfBlocks = this->GetNumberOfWorkUnits();
+  // small fronts are not worth splitting
+  constexpr SizeValueType minimumBlockSize = 1024;
+  const auto              getNumberOfBlocks = [maximumNumberOfBlocks](const SizeValueType count) {
+    return std::max(SizeValueType{ 1 }, std::min(maximumNumberOfBlocks, count / minimumBlockSize));
+  };
+  // call f(block, first, last) for each block of [0, count)
+  const auto parallelizeBlocks = [multiThreader](const SizeValueType count,
+                                                 const SizeValueType numberOfBlocks,
+                                                 const auto &        f) {
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [&](SizeValueType block) { f(block, count * block / numberOfBlocks, count * (block + 1) / numberOfBlocks); },
+      nullptr);
+  };
+
+  // FAH (in french: File d'Attente Hierarchique)
+  using QueueType = std::vector<OffsetValueType>;
+  using MapType = std::map<InputImagePixelType, QueueType>;
+  using PushesType = std::vector<std::pair<InputImagePixelType, OffsetValueType>>;
+  MapType                 fah;
+  std::vector<QueueType>  blockFronts(maximumNumberOfBlocks);
+  std::vector<PushesType> blockPushes(maximumNumberOfBlocks);
+  const auto              pushToFah = [&fah, &blockPushes](const SizeValueType numberOfBlocks) {
+    auto it = fah.end();
+    for (SizeValueType block = 0; block < numberOfBlocks; ++block)
+    {
+      for (const auto & push : blockPushes[block])
+      {
+        if (it == fah.end() || it->first != push.first)
+        {
+          it = fah.try_emplace(push.first).first;
+        }
+        it->second.push_back(push.second);
+      }
+      blockPushes[block].clear();
+    }
+  };
+
+  TotalProgressReporter progress(this, numberOfPixels * 2);
+
+  // the pixels that have been added to a queue, for Meyer's algorithm
+  std::vector<unsigned char> status;
+
+  // first stage: copy the markers to the output image and initialize the
+  // FAH, in raster order
+  SizeValueType numberOfBlocks = getNumberOfBlocks(numberOfPixels);
+  if (m_MarkWatershedLine)
+  {
+    status.resize(numberOfPixels);
+    parallelizeBlocks(numberOfPixels, numberOfBlocks, [&](SizeValueType, SizeValueType first, SizeValueType last) {
+      std::fill(claims.begin() + first, claims.begin() + last, unclaimed);
+    });
+    // the background pixels next to a marker are added by the first marker
+    // pixel, in raster order
+    parallelizeBlocks(numberOfPixels, numberOfBlocks, [&](SizeValueType, SizeValueType first, SizeValueType last) {
+      for (SizeValueType pixel = first; pixel < last; ++pixel)
+      {
+        const LabelImagePixelType markerPixel = marker[pixel];
+        if (markerPixel != bgLabel)
+        {
+          status[pixel] = true;
+          output[pixel] = markerPixel;
+          forEachNeighbor(pixel, [&](const OffsetValueType neighbor) {
+            if (marker[neighbor] == bgLabel)
+            {
+              claim(neighbor, static_cast<KeyType>(pixel));
+            }
+          });
+        }
+        else
+        {
+          // Some pixels may be never processed so, by default, non marked
+          // pixels must be marked as watershed
+          output[pixel] = wsLabel;
+        }
+      }
+    });
+    parallelizeBlocks(
+      numberOfPixels, numberOfBlocks, [&](SizeValueType block, SizeValueType first, SizeValueType last) {
+        for (SizeValueType pixel = first; pixel < last; ++pixel)
+        {
+          if (marker[pixel] != bgLabel)
+          {
+            forEachNeighbor(pixel, [&](const OffsetValueType neighbor) {
+              if (marker[neighbor] == bgLabel && claims[neighbor].load(std::memory_order_relaxed) == pixel)
+              {
+                blockPushes[block].emplace_back(input[neighbor], neighbor);
+              }
+            });
+          }
+        }
+        for (const auto & push : blockPushes[block])
+        {
+          status[push.second] = true;
+        }
+      });
+  }
+  else
+  {
+    // the marker pixels next to the background
+    parallelizeBlocks(
+      numberOfPixels, numberOfBlocks, [&](SizeValueType block, SizeValueType first, SizeValueType last) {
+        std::fill(claims.begin() + first, claims.begin() + last, unclaimed);
+        for (SizeValueType pixel = first; pixel < last; ++pixel)
+        {
+          const LabelImagePixelType markerPixel = marker[pixel];
+          if (markerPixel != bgLabel)
+          {
+            output[pixel] = markerPixel;
+            bool haveBgNeighbor = false;
+            forEachNeighbor(pixel, [&](const OffsetValueType neighbor) {
+              haveBgNeighbor = haveBgNeighbor || marker[neighbor] == bgLabel;
+            });
+            if (haveBgNeighbor)
+            {
+              blockPushes[block].emplace_back(input[pixel], pixel);
+            }
+          }
+          else
+          {
+            output[pixel] = wsLabel;
+          }
+        }
+      });
+  }
+  pushToFah(numberOfBlocks);
+  progress.Completed(numberOfPixels);
+
+  // flooding
+  QueueType                        front;
+  std::vector<LabelImagePixelType> frontLabels;
+  std::vector<QueueType>           blockConflicts(maximumNumberOfBlocks);
+  while (!fah.empty())
+  {
+    // store the current vars
+    const InputImagePixelType currentValue = fah.begin()->first;
+    front = std::move(fah.begin()->second);
+    // and remove them from the fah
+    fah.erase(fah.begin());
+
+    while (!front.empty())
+    {
+      const SizeValueType frontSize = front.size();
+      numberOfBlocks = getNumberOfBlocks(frontSize);
+
+      // add the neighbors claimed by a pixel of the front to the current
+      // queue or to the FAH, in the order of the front
+      const auto collect = [&](const SizeValueType block, const SizeValueType position, const auto & isAvailable) {
+        forEachNeighbor(front[position], [&](const OffsetValueType neighbor) {
+          if (isAvailable(neighbor) && claims[neighbor].load(std::memory_order_relaxed) == position)
+          {
+            const InputImagePixelType grayVal = input[neighbor];
+            if (grayVal <= currentValue)
+            {
+              blockFronts[block].push_back(neighbor);
+            }
+            else
+            {
+              blockPushes[block].emplace_back(grayVal, neighbor);
+            }
+          }
+        });
+      };
+
+      if (m_MarkWatershedLine)
+      {
+        // Meyer's algorithm: a pixel gets the label of its labeled neighbors,
+        // unless they have different labels. Find the labels from the
+        // neighbors processed before the front, and store the positions
+        frontLabels.resize(frontSize);
+        parallelizeBlocks(frontSize, numberOfBlocks, [&](SizeValueType, SizeValueType first, SizeValueType last) {
+          for (SizeValueType position = first; position < last; ++position)
+          {
+            claims[front[position]].store(static_cast<KeyType>(position), std::memory_order_relaxed);
+            LabelImagePixelType label = wsLabel;
+            bool                collision = false;
+            forEachNeighbor(front[position], [&](const OffsetValueType neighbor) {
+              const LabelImagePixelType o = output[neighbor];
+              if (o != wsLabel)
+              {
+                collision = collision || (label != wsLabel && o != label);
+                label = o;
+              }
+            });
+            // the pixels of the front are all added by a labeled neighbor, so
+            // a pixel without collision has a label
+            frontLabels[position] = collision ? wsLabel : label;
+          }
+        });
+        // A pixel next to a pixel of the front processed before it, with
+        // another label, depends on the label of that pixel
+        const auto positionInFront = [&](const OffsetValueType pixel) {
+          const KeyType position = claims[pixel].load(std::memory_order_relaxed);
+          return position < frontSize && front[position] == pixel ? position : unclaimed;
+        };
+        parallelizeBlocks(frontSize, numberOfBlocks, [&](SizeValueType block, SizeValueType first, SizeValueType last) {
+          for (SizeValueType position = first; position < last; ++position)
+          {
+            const LabelImagePixelType label = frontLabels[position];
+            bool                      conflict = false;
+            if (label != wsLabel)
+            {
+              forEachNeighbor(front[position], [&](const OffsetValueType neighbor) {
+                const KeyType neighborPosition = positionInFront(neighbor);
+                conflict = conflict || (neighborPosition < position && frontLabels[neighborPosition] != wsLabel &&
+                                        frontLabels[neighborPosition] != label);
+              });
+            }
+            if (conflict)
+            {
+              blockConflicts[block].push_back(position);
+            }
+          }
+        });
+        // these pixels are labeled in the order of the front, the others
+        // keep the label of their neighbors
+        for (SizeValueType block = 0; block < numberOfBlocks; ++block)
+        {
+          for (const SizeValueType position : blockConflicts[block])
+          {
+            const LabelImagePixelType label = frontLabels[position];
+            bool                      collision = false;
+            forEachNeighbor(front[position], [&](const OffsetValueType neighbor) {
+              const KeyType neighborPosition = positionInFront(neighbor);
+              collision = collision || (neighborPosition < position && frontLabels[neighborPosition] != wsLabel &&
+                                        frontLabels[neighborPosition] != label);
+            });
+            if (collision)
+            {
+              frontLabels[position] = wsLabel;
+            }
+          }
+          blockConflicts[block].clear();
+        }
+        // set the labels, and propagate to the neighbors
+        parallelizeBlocks(frontSize, numberOfBlocks, [&](SizeValueType, SizeValueType first, SizeValueType last) {
+          for (SizeValueType position = first; position < last; ++position)
+          {
+            const LabelImagePixelType label = frontLabels[position];
+            if (label != wsLabel)
+            {
+              output[front[position]] = label;
+              forEachNeighbor(front[position], [&](const OffsetValueType neighbor) {
+                if (!status[neighbor])
+                {
+                  claim(neighbor, static_cast<KeyType>(position));
+                }
+              });
+            }
+          }
+        });
+        parallelizeBlocks(frontSize, numberOfBlocks, [&](SizeValueType block, SizeValueType first, SizeValueType last) {
+          for (SizeValueType position = first; position < last; ++position)
+          {
+            if (frontLabels[position] != wsLabel)
+            {
+              collect(block, position, [&](const OffsetValueType neighbor) { return !status[neighbor]; });
+            }
+          }
+        });
+        // mark the added pixels as already in the fah
+        parallelizeBlocks(numberOfBlocks, numberOfBlocks, [&](SizeValueType block, SizeValueType, SizeValueType) {
+          for (const OffsetValueType pixel : blockFronts[block])
+          {
+            status[pixel] = true;
+          }
+          for (const auto & push : blockPushes[block])
+          {
+            status[push.second] = true;
+          }
+        });
+      }
+      else
+      {
+        // Beucher's algorithm: the labeled pixels of the front propagate
+        // their label to the unlabeled neighbors
+        parallelizeBlocks(frontSize, numberOfBlocks, [&](SizeValueType, SizeValueType first, SizeValueType last) {
+          for (SizeValueType position = first; position < last; ++position)
+          {
+            forEachNeighbor(front[position], [&](const OffsetValueType neighbor) {
+              if (output[neighbor] == wsLabel)
+              {
+                claim(neighbor, static_cast<KeyType>(position));
+              }
+            });
+          }
+        });
+        parallelizeBlocks(frontSize, numberOfBlocks, [&](SizeValueType block, SizeValueType first, SizeValueType last) {
+          for (SizeValueType position = first; position < last; ++position)
+          {
+            collect(block, position, [&](const OffsetValueType neighbor) { return output[neighbor] == wsLabel; });
+          }
+        });
+        // label the added pixels
+        parallelizeBlocks(numberOfBlocks, numberOfBlocks, [&](SizeValueType block, SizeValueType, SizeValueType) {
+          const auto label = [&](const OffsetValueType pixel) {
+            output[pixel] = output[front[claims[pixel].load(std::memory_order_relaxed)]];
+          };
+          for (const OffsetValueType pixel : blockFronts[block])
+          {
+            label(pixel);
+          }
+          for (const auto & push : blockPushes[block])
+          {
+            label(push.second);
+          }
+        });
+      }
+
+      // the next front is made of the pixels added to the current queue
+      front.clear();
+      for (SizeValueType block = 0; block < numberOfBlocks; ++block)
+      {
+        front.insert(front.end(), blockFronts[block].begin(), blockFronts[block].end());
+        blockFronts[block].clear();
+      }
+      pushToFah(numberOfBlocks);
+      progress.Completed(frontSize);
+    }
+  }
+}
+
+
 template <typename TInputImage, typename TLabelImage>
 void
 MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::PrintSelf(std::ostream & os,
@@ -91,6 +91,8 @@ MorphologicalWatershedImageFilter<TInputImage, TOutputImage>::GenerateData()
   auto label = ConnectedCompType::New();
   label->SetFullyConnected(m_FullyConnected);
   label->SetInput(rmin->GetOutput());
+  // Respect the number of threads of the filter
+  label->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
 
   // the watershed
   using WatershedType = MorphologicalWatershedFromMarkersImageFilter<TInputImage, TOutputImage>;
@@ -99,6 +101,7 @@ MorphologicalWatershedImageFilter<TInputImage, TOutputImage>::GenerateData()
   wshed->SetMarkerImage(label->GetOutput());
   wshed->SetFullyConnected(m_FullyConnected);
   wshed->SetMarkWatershedLine(m_MarkWatershedLine);
+  wshed->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
 
   if (m_Level != InputImagePixelType{})
   {
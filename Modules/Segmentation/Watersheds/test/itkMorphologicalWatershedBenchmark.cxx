@@ -0,0 +1,75 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMorphologicalWatershedImageFilter.h"
+#include "itkTestBenchmarkWorkUnits.h"
+#include "itkTimeProbe.h"
+#include <cmath>
+#include <random>
+
+
+// Time the watershed of a 3D image for a growing number of work units, up to
+// the number of threads of the machine by default. This is not part of the
+// tests that run by default; run it with
+//   ctest -C Benchmark -R itkMorphologicalWatershedBenchmark
+int
+itkMorphologicalWatershedBenchmark(int argc, char * argv[])
+{
+  itk::Testing::BenchmarkWorkUnitsArguments arguments;
+  if (!itk::Testing::ParseBenchmarkWorkUnitsArguments(argc, argv, 128, 3, arguments))
+  {
+    return EXIT_FAILURE;
+  }
+  const itk::SizeValueType size = arguments.size;
+
+  constexpr unsigned int Dimension = 3;
+  using ImageType = itk::Image<unsigned char, Dimension>;
+  using LabelImageType = itk::Image<unsigned int, Dimension>;
+
+  // A wavy relief with noise, quantized to a few levels to get plateaus
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate();
+  std::mt19937                           generator(Dimension);
+  std::uniform_real_distribution<double> noise(0.0, 3.0);
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    double value = 8.0;
+    for (unsigned int i = 0; i < Dimension; ++i)
+    {
+      value += 3.0 * std::sin(it.GetIndex()[i] / (3.0 + 2.0 * i));
+    }
+    it.Set(static_cast<unsigned char>(value + noise(generator)));
+  }
+
+  std::cout << "Image of " << size << "^3 pixels, mean of " << arguments.numberOfRepetitions << " runs" << std::endl;
+  itk::Testing::BenchmarkWorkUnits(arguments, [&image](unsigned int numberOfWorkUnits) {
+    auto filter = itk::MorphologicalWatershedImageFilter<ImageType, LabelImageType>::New();
+    filter->SetInput(image);
+    filter->SetLevel(1);
+    filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+    itk::TimeProbe timeProbe;
+    timeProbe.Start();
+    filter->Update();
+    timeProbe.Stop();
+    return timeProbe.GetTotal();
+  });
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMorphologicalWatershedImageFilter.h"
+#include "itkTestingMacros.h"
+#include <cmath>
+#include <random>
+
+
+// Check that the watershed gives the same labels for any number of work
+// units. See itkMorphologicalWatershedBenchmark for the timings.
+namespace
+{
+template <unsigned int VDimension>
+bool
+CheckWorkUnits(const itk::SizeValueType size)
+{
+  using ImageType = itk::Image<unsigned char, VDimension>;
+  using LabelImageType = itk::Image<unsigned int, VDimension>;
+
+  // A wavy relief with noise, quantized to a few levels to get plateaus
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate();
+  std::mt19937                           generator(VDimension);
+  std::uniform_real_distribution<double> noise(0.0, 3.0);
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    double value = 8.0;
+    for (unsigned int i = 0; i < VDimension; ++i)
+    {
+      value += 3.0 * std::sin(it.GetIndex()[i] / (3.0 + 2.0 * i));
+    }
+    it.Set(static_cast<unsigned char>(value + noise(generator)));
+  }
+
+  bool success = true;
+  for (const bool markWatershedLine : { true, false })
+  {
+    for (const bool fullyConnected : { false, true })
+    {
+      typename LabelImageType::Pointer reference;
+      for (const unsigned int numberOfWorkUnits : { 1, 2, 3, 8 })
+      {
+        auto filter = itk::MorphologicalWatershedImageFilter<ImageType, LabelImageType>::New();
+        filter->SetInput(image);
+        filter->SetLevel(1);
+        filter->SetMarkWatershedLine(markWatershedLine);
+        filter->SetFullyConnected(fullyConnected);
+        filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+        filter->Update();
+
+        if (!reference)
+        {
+          reference = filter->GetOutput();
+          continue;
+        }
+        itk::ImageRegionConstIterator<LabelImageType> rit(reference, reference->GetLargestPossibleRegion());
+        itk::ImageRegionConstIterator<LabelImageType> it(filter->GetOutput(), reference->GetLargestPossibleRegion());
+        itk::SizeValueType                            numberOfDifferences = 0;
+        for (; !it.IsAtEnd(); ++it, ++rit)
+        {
+          numberOfDifferences += it.Get() != rit.Get();
+        }
+        if (numberOfDifferences != 0)
+        {
+          std::cerr << "Test failed!" << std::endl;
+          std::cerr << VDimension << "D, MarkWatershedLine " << markWatershedLine << ", FullyConnected "
+                    << fullyConnected << ": " << numberOfDifferences << " pixels differ with " << numberOfWorkUnits
+                    << " work units from the output with a single work unit." << std::endl;
+          success = false;
+        }
+      }
+    }
+  }
+  return success;
+}
+} // namespace
+
+
+int
+itkMorphologicalWatershedWorkUnitsTest(int, char *[])
+{
+  bool success = CheckWorkUnits<2>(200);
+  success = CheckWorkUnits<3>(64) && success;
+
+  if (!success)
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}